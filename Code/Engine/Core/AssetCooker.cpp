@@ -0,0 +1,658 @@
+#include "AssetCooker.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/MeshOptimizer.h"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Job/JobSystem.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+
+namespace
+{
+    constexpr uint32_t ASSET_COOK_MANIFEST_VERSION = 1;
+    char const* const ASSET_COOK_MANIFEST_HEADER = "IglooCook manifest";
+
+    struct CookFileState
+    {
+        bool m_exists = false;
+        uint64_t m_size = 0;
+        int64_t m_modifiedTime = 0;
+        uint64_t m_hash = 0;
+    };
+
+    struct CookManifestAsset
+    {
+        uint64_t m_settingsKey = 0;
+        std::vector<std::pair<std::string, uint64_t>> m_inputs;    // path, content hash at the last cook
+        std::vector<std::string> m_outputs;
+    };
+
+    struct CookManifest
+    {
+        std::unordered_map<std::string, CookFileState> m_files;
+        std::unordered_map<std::string, CookManifestAsset> m_assets;   // GetManifestAssetKey
+    };
+
+    struct CookAsset
+    {
+        AssetCookType m_type = AssetCookType::COUNT;
+        std::string m_path;
+        std::vector<std::string> m_inputs;
+        uint64_t m_settingsKey = 0;
+        ImageMipSettings m_mipSettings;         // TEXTURE
+        BlockFormat m_format = BlockFormat::NONE;
+        std::vector<std::string> m_outputs;     // filled by the cook
+        bool m_isDirty = true;
+        AssetCookEntry m_entry;
+    };
+
+    std::string NormalizeCookPath(std::string path)
+    {
+        std::replace(path.begin(), path.end(), '\\', '/');
+        return path;
+    }
+
+    std::string GetLowerExtension(std::string const& path)
+    {
+        size_t dot = path.find_last_of('.');
+        size_t slash = path.find_last_of('/');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            return "";
+        std::string extension = path.substr(dot);
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)tolower((unsigned char)c); });
+        return extension;
+    }
+
+    bool IsCookableImage(std::string const& extension)
+    {
+        return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp";
+    }
+
+    std::string GetManifestAssetKey(AssetCookType type, std::string const& path)
+    {
+        return std::string(GetAssetCookTypeName(type)) + ":" + path;
+    }
+
+    uint64_t MixFloat(uint64_t hash, float value)
+    {
+        uint32_t bits = 0;
+        memcpy(&bits, &value, sizeof(bits));
+        return MixHash(hash, bits);
+    }
+
+    uint64_t GetMeshSettingsKey(StaticMeshCookOptions const& options)
+    {
+        uint64_t hash = MixHash(MixHash(0x9E3779B97F4A7C15ull, ASSET_COOK_MANIFEST_VERSION), COOKED_MESH_VERSION);
+        hash = MixHash(hash, options.m_cardTemplates ? 1u : 0u);
+        hash = MixHash(hash, (uint32_t)options.m_sdfResolution);
+        return FinalizeHash(hash);
+    }
+
+    uint64_t GetTextureSettingsKey(ImageMipSettings const& settings, BlockFormat format, TextureCookTarget target)
+    {
+        uint64_t hash = MixHash(MixHash(0x9E3779B97F4A7C15ull, ASSET_COOK_MANIFEST_VERSION), COOKED_MESH_VERSION);
+        hash = MixHash(hash, (uint32_t)target);
+        hash = MixHash(hash, (uint32_t)format);
+        hash = MixHash(hash, (uint32_t)settings.m_filter);
+        hash = MixHash(hash, (settings.m_isSRGB ? 1u : 0u) | (settings.m_isNormalMap ? 2u : 0u) | (settings.m_preserveAlphaCoverage ? 4u : 0u));
+        hash = MixFloat(hash, settings.m_alphaCoverageCutoff);
+        hash = MixFloat(hash, settings.m_kaiserWidth);
+        hash = MixFloat(hash, settings.m_kaiserAlpha);
+        hash = MixFloat(hash, settings.m_kaiserStretch);
+        hash = MixHash(hash, (uint32_t)settings.m_maxLevelCount);
+        return FinalizeHash(hash);
+    }
+
+    CookFileState StatCookFile(std::string const& path)
+    {
+        CookFileState state;
+        std::error_code error;
+        std::filesystem::path filePath(path);
+        if (!std::filesystem::is_regular_file(filePath, error))
+            return state;
+        state.m_size = (uint64_t)std::filesystem::file_size(filePath, error);
+        state.m_modifiedTime = (int64_t)std::filesystem::last_write_time(filePath, error).time_since_epoch().count();
+        state.m_exists = !error;
+        return state;
+    }
+
+    uint64_t GetCookFileSize(std::string const& path)
+    {
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(std::filesystem::path(path), error);
+        return error ? 0 : (uint64_t)size;
+    }
+
+    // SplitStringOnDelimiter 会把 tab 换成空格，路径里又可能有空格，这里自己切
+    Strings SplitManifestText(std::string const& text, char delimiter)
+    {
+        Strings fields;
+        size_t start = 0;
+        for (size_t end = text.find(delimiter); end != std::string::npos; end = text.find(delimiter, start))
+        {
+            fields.push_back(text.substr(start, end - start));
+            start = end + 1;
+        }
+        fields.push_back(text.substr(start));
+        for (std::string& field : fields)
+        {
+            if (!field.empty() && field.back() == '\r')
+                field.pop_back();
+        }
+        return fields;
+    }
+
+    //-------------------------------------------------------------------------------------------
+    // file <tab> size <tab> mtime <tab> hash <tab> path
+    // asset <tab> settings key <tab> type:path, then in <tab> hash <tab> path / out <tab> path
+    bool LoadCookManifest(std::string const& path, CookManifest& out)
+    {
+        std::string text;
+        if (FileReadToString(text, path) < 0)
+            return false;
+        Strings lines = SplitManifestText(text, '\n');
+        if (lines.empty() || lines[0] != Stringf("%s %u", ASSET_COOK_MANIFEST_HEADER, ASSET_COOK_MANIFEST_VERSION))
+            return false;
+
+        CookManifestAsset* asset = nullptr;
+        for (size_t i = 1; i < lines.size(); i++)
+        {
+            Strings fields = SplitManifestText(lines[i], '\t');
+            if (fields[0] == "file" && fields.size() == 5)
+            {
+                CookFileState& state = out.m_files[fields[4]];
+                state.m_exists = true;
+                state.m_size = strtoull(fields[1].c_str(), nullptr, 10);
+                state.m_modifiedTime = strtoll(fields[2].c_str(), nullptr, 10);
+                state.m_hash = strtoull(fields[3].c_str(), nullptr, 16);
+            }
+            else if (fields[0] == "asset" && fields.size() == 3)
+            {
+                asset = &out.m_assets[fields[2]];
+                asset->m_settingsKey = strtoull(fields[1].c_str(), nullptr, 16);
+            }
+            else if (fields[0] == "in" && fields.size() == 3 && asset)
+            {
+                asset->m_inputs.emplace_back(fields[2], strtoull(fields[1].c_str(), nullptr, 16));
+            }
+            else if (fields[0] == "out" && fields.size() == 2 && asset)
+            {
+                asset->m_outputs.push_back(fields[1]);
+            }
+        }
+        return true;
+    }
+
+    bool SaveCookManifest(std::string const& path, CookManifest const& manifest)
+    {
+        std::vector<std::string> filePaths;
+        for (auto const& file : manifest.m_files)
+        {
+            filePaths.push_back(file.first);
+        }
+        std::vector<std::string> assetKeys;
+        for (auto const& asset : manifest.m_assets)
+        {
+            assetKeys.push_back(asset.first);
+        }
+        std::sort(filePaths.begin(), filePaths.end());
+        std::sort(assetKeys.begin(), assetKeys.end());
+
+        std::string text = Stringf("%s %u\n", ASSET_COOK_MANIFEST_HEADER, ASSET_COOK_MANIFEST_VERSION);
+        for (std::string const& filePath : filePaths)
+        {
+            CookFileState const& state = manifest.m_files.at(filePath);
+            text += Stringf("file\t%llu\t%lld\t%016llx\t", (unsigned long long)state.m_size, (long long)state.m_modifiedTime,
+                (unsigned long long)state.m_hash) + filePath + "\n";
+        }
+        for (std::string const& assetKey : assetKeys)
+        {
+            CookManifestAsset const& asset = manifest.m_assets.at(assetKey);
+            text += Stringf("asset\t%016llx\t", (unsigned long long)asset.m_settingsKey) + assetKey + "\n";
+            for (auto const& input : asset.m_inputs)
+            {
+                text += Stringf("in\t%016llx\t", (unsigned long long)input.second) + input.first + "\n";
+            }
+            for (std::string const& output : asset.m_outputs)
+            {
+                text += "out\t" + output + "\n";
+            }
+        }
+        std::vector<uint8_t> bytes(text.begin(), text.end());
+        return FileWriteFromBuffer(bytes, path) >= 0;
+    }
+
+    //-------------------------------------------------------------------------------------------
+    // 同一张图被多个 mesh 用时按第一个的设置 cook（.mips 只有一份），设置不一样的报出来
+    void AddTextureAsset(std::vector<CookAsset>& assets, std::unordered_map<std::string, size_t>& textureIndices, std::string const& path,
+        ImageMipSettings const& settings, BlockFormat format, TextureCookTarget target, std::string const& usedBy)
+    {
+        uint64_t settingsKey = GetTextureSettingsKey(settings, format, target);
+        auto found = textureIndices.find(path);
+        if (found != textureIndices.end())
+        {
+            if (assets[found->second].m_settingsKey != settingsKey)
+                DebuggerPrintf("[IglooCook] %s: %s loads it with different mip / compression settings, cooking it as first used\n", path.c_str(), usedBy.c_str());
+            return;
+        }
+
+        CookAsset asset;
+        asset.m_type = AssetCookType::TEXTURE;
+        asset.m_path = path;
+        asset.m_inputs.push_back(path);
+        asset.m_settingsKey = settingsKey;
+        asset.m_mipSettings = settings;
+        asset.m_format = format;
+        textureIndices.emplace(path, assets.size());
+        assets.push_back(std::move(asset));
+    }
+
+    void DiscoverCookAssets(AssetCookConfig const& config, std::vector<CookAsset>& outAssets)
+    {
+        std::vector<std::string> xmlFiles;
+        std::vector<std::string> imageFiles;
+        std::error_code error;
+        std::filesystem::recursive_directory_iterator end;
+        for (std::filesystem::recursive_directory_iterator it(config.m_dataRoot, error); !error && it != end; it.increment(error))
+        {
+            if (!it->is_regular_file(error))
+                continue;
+            std::string path = NormalizeCookPath(it->path().generic_string());
+            std::string extension = GetLowerExtension(path);
+            if (extension == ".xml")
+                xmlFiles.push_back(path);
+            else if (IsCookableImage(extension))
+                imageFiles.push_back(path);
+        }
+        std::sort(xmlFiles.begin(), xmlFiles.end());
+        std::sort(imageFiles.begin(), imageFiles.end());
+
+        std::unordered_map<std::string, size_t> textureIndices;
+        for (std::string const& xmlFile : xmlFiles)
+        {
+            XmlDocument document;
+            XmlElement* root = document.LoadFile(xmlFile.c_str()) == XmlResult::XML_SUCCESS ? document.RootElement() : nullptr;
+            std::string objFile = root ? ParseXmlAttribute(*root, "objFile", "") : "";
+            if (objFile.empty())
+            {
+                if (!config.m_checkDefinitions)
+                    continue;
+                CookAsset asset;
+                asset.m_type = AssetCookType::DEFINITION;
+                asset.m_path = xmlFile;
+                asset.m_inputs.push_back(xmlFile);
+                asset.m_settingsKey = ASSET_COOK_MANIFEST_VERSION;
+                outAssets.push_back(std::move(asset));
+                continue;
+            }
+
+            std::string meshPath = xmlFile.substr(0, xmlFile.size() - 4);
+            if (config.m_cookMeshes)
+            {
+                CookAsset asset;
+                asset.m_type = AssetCookType::MESH;
+                asset.m_path = meshPath;
+                asset.m_inputs.push_back(xmlFile);
+                asset.m_inputs.push_back(NormalizeCookPath(objFile));
+                std::string mtlPath = ParseXmlAttribute(*root, "mtllib", "");
+                if (!mtlPath.empty())
+                    asset.m_inputs.push_back(NormalizeCookPath(mtlPath));
+                asset.m_settingsKey = GetMeshSettingsKey(config.m_meshOptions);
+                outAssets.push_back(std::move(asset));
+            }
+
+            if (config.m_cookTextures)
+            {
+                // 和 StaticMeshHandle::Read 一样的设置
+                char const* textureAttributes[3] = { "normalMap", "diffuseMap", "specGlossEmitMap" };
+                BlockFormat normalFormat = ParseBlockFormat(ParseXmlAttribute(*root, "normalMapCompression", ""));
+                BlockFormat colorFormat = ParseBlockFormat(ParseXmlAttribute(*root, "textureCompression", ""));
+                for (int i = 0; i < 3; i++)
+                {
+                    std::string texturePath = NormalizeCookPath(ParseXmlAttribute(*root, textureAttributes[i], ""));
+                    if (!texturePath.empty())
+                        AddTextureAsset(outAssets, textureIndices, texturePath, GetMaterialMipSettings(i), i == 0 ? normalFormat : colorFormat, config.m_textureTarget, xmlFile);
+                }
+            }
+        }
+
+        if (config.m_cookTextures)
+        {
+            for (std::string const& imageFile : imageFiles)
+            {
+                if (textureIndices.find(imageFile) == textureIndices.end())
+                    AddTextureAsset(outAssets, textureIndices, imageFile, ImageMipSettings(), config.m_textureFormat, config.m_textureTarget, "");
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------
+    void CookMeshAsset(AssetCookConfig const& config, CookAsset& asset)
+    {
+        StaticMeshCookOptions options = config.m_meshOptions;
+        options.m_force = config.m_force;
+        StaticMeshCookReport meshReport;
+        if (!StaticMesh::CookOffline(asset.m_path, options, meshReport))
+        {
+            asset.m_entry.m_detail = "could not import (see above)";
+            return;
+        }
+        if (meshReport.m_isCookDisabled)
+        {
+            asset.m_entry.m_result = AssetCookResult::SKIPPED;
+            asset.m_entry.m_detail = "cooked=\"false\"";
+            return;
+        }
+
+        asset.m_entry.m_result = meshReport.m_wasUpToDate ? AssetCookResult::UP_TO_DATE : AssetCookResult::COOKED;
+        asset.m_entry.m_outputBytes = meshReport.m_cookedBytes;
+        asset.m_outputs.push_back(asset.m_path + ".cooked");
+        if (meshReport.m_wasUpToDate)
+        {
+            asset.m_entry.m_detail = Stringf("%u tris, %u cards, cook already up to date", meshReport.m_triangleCount, meshReport.m_cardCount);
+            return;
+        }
+        asset.m_entry.m_detail = Stringf("%u tris: import %.2f ms, %u cards %.2f ms", meshReport.m_triangleCount,
+            meshReport.m_importMilliseconds, meshReport.m_cardCount, meshReport.m_cardMilliseconds);
+        if (meshReport.m_sdfResolution > 0)
+            asset.m_entry.m_detail += Stringf(", SDF %d^3 %.2f ms", meshReport.m_sdfResolution, meshReport.m_sdfMilliseconds);
+    }
+
+    void CookTextureAsset(AssetCookConfig const& config, CookAsset& asset)
+    {
+        uint64_t mipKey = 0;
+        uint64_t blockKey = 0;
+        ImageMipChain mips;
+        CompressedMipChain blocks;
+        bool isUpToDate = LoadCookedTextureMips(asset.m_path, asset.m_mipSettings, asset.m_format, config.m_textureTarget, mipKey, blockKey, mips, blocks);
+        if (!isUpToDate || config.m_force)
+        {
+            std::vector<uint8_t> bytes;
+            Image image;
+            if (FileReadToBuffer(bytes, asset.m_path) <= 0 || !DecodeImageFromMemory(asset.m_path, bytes, config.m_textureTarget, image))
+            {
+                asset.m_entry.m_detail = "could not read or decode the image";
+                return;
+            }
+            mips = ImageMipChain();
+            blocks = CompressedMipChain();
+            BuildTextureMips(image, asset.m_mipSettings, asset.m_format, config.m_textureTarget, mipKey, blockKey, mips, blocks);
+        }
+
+        std::string output = blocks.IsValid() ? GetCompressedMipCookPath(asset.m_path, asset.m_format) : GetImageMipCookPath(asset.m_path);
+        asset.m_outputs.push_back(output);
+        asset.m_entry.m_outputBytes = GetCookFileSize(output);
+        if (asset.m_entry.m_outputBytes == 0)
+        {
+            asset.m_entry.m_detail = "could not write " + output;
+            return;
+        }
+        IntVec2 dimensions = blocks.IsValid() ? blocks.GetDimensions(0) : mips.GetDimensions(0);
+        int levelCount = blocks.IsValid() ? blocks.GetLevelCount() : mips.GetLevelCount();
+        asset.m_entry.m_result = isUpToDate && !config.m_force ? AssetCookResult::UP_TO_DATE : AssetCookResult::COOKED;
+        asset.m_entry.m_detail = Stringf("%dx%d, %d levels, %s%s", dimensions.x, dimensions.y, levelCount,
+            blocks.IsValid() ? GetBlockFormatName(asset.m_format) : "RGBA8", asset.m_mipSettings.m_isNormalMap ? ", normal map" : "");
+    }
+
+    void CheckDefinitionAsset(CookAsset& asset)
+    {
+        XmlDocument document;
+        if (document.LoadFile(asset.m_path.c_str()) != XmlResult::XML_SUCCESS)
+        {
+            asset.m_entry.m_detail = Stringf("line %d: %s", document.ErrorLineNum(), document.ErrorStr());
+            return;
+        }
+        asset.m_entry.m_result = AssetCookResult::COOKED;
+        asset.m_entry.m_detail = document.RootElement() ? Stringf("<%s>", document.RootElement()->Name()) : "empty";
+    }
+
+    void CookOneAsset(AssetCookConfig const& config, CookAsset& asset)
+    {
+        double startTime = GetCurrentTimeSeconds();
+        asset.m_entry.m_result = AssetCookResult::FAILED;
+        switch (asset.m_type)
+        {
+        case AssetCookType::MESH: CookMeshAsset(config, asset); break;
+        case AssetCookType::TEXTURE: CookTextureAsset(config, asset); break;
+        case AssetCookType::DEFINITION: CheckDefinitionAsset(asset); break;
+        default: break;
+        }
+        asset.m_entry.m_milliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+    }
+
+    //-------------------------------------------------------------------------------------------
+    // 除了 manifest、.tmp 和别的 pack，数据目录里的都进 pack
+    void GatherPackFiles(AssetCookConfig const& config, std::string const& manifestPath, std::vector<std::string>& outFiles)
+    {
+        std::string normalizedManifest = NormalizeCookPath(manifestPath);
+        std::error_code error;
+        std::filesystem::recursive_directory_iterator end;
+        for (std::filesystem::recursive_directory_iterator it(config.m_dataRoot, error); !error && it != end; it.increment(error))
+        {
+            if (!it->is_regular_file(error))
+                continue;
+            std::string path = NormalizeCookPath(it->path().generic_string());
+            std::string extension = GetLowerExtension(path);
+            if (path != normalizedManifest && extension != ".tmp" && extension != ".pack")
+                outFiles.push_back(path);
+        }
+        std::sort(outFiles.begin(), outFiles.end());
+    }
+
+    // 设置一样、同一批文件、大小都一样、而且没有比 pack 新的
+    bool IsAssetPackUpToDate(std::string const& packPath, AssetPackBuildSettings const& settings, std::vector<std::string> const& files)
+    {
+        AssetPack pack;
+        if (!pack.Open(packPath) || pack.GetSettingsKey() != GetAssetPackSettingsKey(settings) || pack.GetEntryCount() != (uint32_t)files.size())
+            return false;
+        std::error_code error;
+        std::filesystem::file_time_type packTime = std::filesystem::last_write_time(std::filesystem::path(packPath), error);
+        if (error)
+            return false;
+        for (std::string const& file : files)
+        {
+            AssetPackEntry const* entry = pack.FindEntry(file);
+            std::filesystem::file_time_type fileTime = std::filesystem::last_write_time(std::filesystem::path(file), error);
+            if (!entry || error || fileTime > packTime || entry->m_size != GetCookFileSize(file))
+                return false;
+        }
+        return true;
+    }
+
+    void BuildCookedAssetPack(AssetCookConfig const& config, std::string const& manifestPath, AssetCookReport& report)
+    {
+        double startTime = GetCurrentTimeSeconds();
+        report.m_packPath = config.m_packPath;
+        std::vector<std::string> files;
+        GatherPackFiles(config, manifestPath, files);
+        if (!config.m_force && IsAssetPackUpToDate(config.m_packPath, config.m_packSettings, files))
+            report.m_packResult = AssetCookResult::UP_TO_DATE;
+        else if (BuildAssetPack(config.m_packPath, files, config.m_packSettings, &report.m_pack))
+            report.m_packResult = AssetCookResult::COOKED;
+        else
+            report.m_packResult = AssetCookResult::FAILED;
+        if (report.m_packResult != AssetCookResult::COOKED)
+            report.m_pack.m_entryCount = (uint32_t)files.size();
+        report.m_packMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+    }
+}
+
+char const* GetAssetCookTypeName(AssetCookType type)
+{
+    switch (type)
+    {
+    case AssetCookType::MESH: return "mesh";
+    case AssetCookType::TEXTURE: return "texture";
+    case AssetCookType::DEFINITION: return "definition";
+    default: return "?";
+    }
+}
+
+AssetCookReport CookAssets(AssetCookConfig const& config)
+{
+    AssetCookReport report;
+    double startTime = GetCurrentTimeSeconds();
+    std::string manifestPath = config.m_manifestPath.empty() ? NormalizeCookPath(config.m_dataRoot) + "/IglooCook.manifest" : config.m_manifestPath;
+
+    CookManifest manifest;
+    if (!config.m_force)
+        LoadCookManifest(manifestPath, manifest);
+
+    std::vector<CookAsset> assets;
+    DiscoverCookAssets(config, assets);
+    double scanTime = GetCurrentTimeSeconds();
+    report.m_scanMilliseconds = (scanTime - startTime) * 1000.0;
+
+    // 1. 每个输入文件 stat 一次；size / mtime 和 manifest 一样的沿用记下的 hash
+    std::unordered_map<std::string, CookFileState> files;
+    for (CookAsset const& asset : assets)
+    {
+        for (std::string const& input : asset.m_inputs)
+        {
+            files.emplace(input, CookFileState());
+        }
+    }
+    std::vector<std::pair<std::string const*, CookFileState*>> toHash;
+    for (auto& file : files)
+    {
+        file.second = StatCookFile(file.first);
+        auto known = manifest.m_files.find(file.first);
+        if (file.second.m_exists && known != manifest.m_files.end() && known->second.m_size == file.second.m_size &&
+            known->second.m_modifiedTime == file.second.m_modifiedTime)
+        {
+            file.second.m_hash = known->second.m_hash;
+        }
+        else if (file.second.m_exists)
+        {
+            toHash.emplace_back(&file.first, &file.second);
+        }
+    }
+    ParallelFor((uint32_t)toHash.size(), 4, [&toHash](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            toHash[i].second->m_hash = ComputeCookedSourceKey({ *toHash[i].first }, nullptr, 0);
+        }
+    });
+    report.m_fileCount = (uint32_t)files.size();
+    report.m_hashedFileCount = (uint32_t)toHash.size();
+    double hashTime = GetCurrentTimeSeconds();
+    report.m_hashMilliseconds = (hashTime - scanTime) * 1000.0;
+
+    // 2. 设置、输入内容、输出文件都没变的不用 cook
+    std::vector<CookAsset*> dirty;
+    for (CookAsset& asset : assets)
+    {
+        asset.m_entry.m_type = asset.m_type;
+        asset.m_entry.m_path = asset.m_path;
+        for (std::string const& input : asset.m_inputs)
+        {
+            asset.m_entry.m_inputBytes += files[input].m_size;
+        }
+
+        auto known = manifest.m_assets.find(GetManifestAssetKey(asset.m_type, asset.m_path));
+        bool isClean = known != manifest.m_assets.end() && known->second.m_settingsKey == asset.m_settingsKey &&
+            known->second.m_inputs.size() == asset.m_inputs.size();
+        for (size_t i = 0; isClean && i < asset.m_inputs.size(); i++)
+        {
+            CookFileState const& state = files[asset.m_inputs[i]];
+            isClean = state.m_exists && known->second.m_inputs[i].first == asset.m_inputs[i] && known->second.m_inputs[i].second == state.m_hash;
+        }
+        for (size_t i = 0; isClean && i < known->second.m_outputs.size(); i++)
+        {
+            isClean = StatCookFile(known->second.m_outputs[i]).m_exists;
+        }
+
+        asset.m_isDirty = !isClean;
+        if (isClean)
+        {
+            asset.m_outputs = known->second.m_outputs;
+            asset.m_entry.m_result = AssetCookResult::UP_TO_DATE;
+            for (std::string const& output : asset.m_outputs)
+            {
+                asset.m_entry.m_outputBytes += GetCookFileSize(output);
+            }
+        }
+        else
+        {
+            dirty.push_back(&asset);
+        }
+    }
+
+    // 3. 大的先开始，最后不会只剩一个大 mesh 在跑；mesh 自己的 SDF 也是 ParallelFor，嵌套没问题
+    std::stable_sort(dirty.begin(), dirty.end(), [](CookAsset const* a, CookAsset const* b) { return a->m_entry.m_inputBytes > b->m_entry.m_inputBytes; });
+    ParallelFor((uint32_t)dirty.size(), 1, [&dirty, &config](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            CookOneAsset(config, *dirty[i]);
+        }
+    });
+    report.m_cookMilliseconds = (GetCurrentTimeSeconds() - hashTime) * 1000.0;
+
+    // 4. 失败的不记，下次再试；跳过的也不记，只是读一下 xml
+    CookManifest updated;
+    for (auto const& file : files)
+    {
+        if (file.second.m_exists)
+            updated.m_files.emplace(file.first, file.second);
+    }
+    for (CookAsset& asset : assets)
+    {
+        report.m_countByResult[(int)asset.m_entry.m_result]++;
+        if (asset.m_entry.m_result == AssetCookResult::COOKED || asset.m_entry.m_result == AssetCookResult::UP_TO_DATE)
+        {
+            CookManifestAsset& entry = updated.m_assets[GetManifestAssetKey(asset.m_type, asset.m_path)];
+            entry.m_settingsKey = asset.m_settingsKey;
+            for (std::string const& input : asset.m_inputs)
+            {
+                entry.m_inputs.emplace_back(input, files[input].m_hash);
+            }
+            entry.m_outputs = asset.m_outputs;
+        }
+        report.m_assets.push_back(std::move(asset.m_entry));
+    }
+    if (!SaveCookManifest(manifestPath, updated))
+        DebuggerPrintf("[IglooCook] Could not write the manifest to %s\n", manifestPath.c_str());
+    if (!config.m_packPath.empty())
+        BuildCookedAssetPack(config, manifestPath, report);
+
+    std::stable_sort(report.m_assets.begin(), report.m_assets.end(), [](AssetCookEntry const& a, AssetCookEntry const& b) { return a.m_milliseconds > b.m_milliseconds; });
+    report.m_totalMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+    return report;
+}
+
+void PrintAssetCookReport(AssetCookReport const& report, bool verbose)
+{
+    char const* resultNames[4] = { "up to date", "cooked", "skipped", "FAILED" };
+    for (AssetCookEntry const& entry : report.m_assets)
+    {
+        if (!verbose && entry.m_result != AssetCookResult::COOKED && entry.m_result != AssetCookResult::FAILED)
+            continue;
+        DebuggerPrintf("[IglooCook] %9.2f ms  %-10s %-10s %s  (%.1f KB -> %.1f KB) %s\n", entry.m_milliseconds, GetAssetCookTypeName(entry.m_type),
+            resultNames[(int)entry.m_result], entry.m_path.c_str(), (double)entry.m_inputBytes / 1024.0, (double)entry.m_outputBytes / 1024.0,
+            entry.m_detail.c_str());
+    }
+    DebuggerPrintf("[IglooCook] %zu assets: %u cooked, %u up to date, %u skipped, %u failed; %u files, %u hashed; scan %.2f, hash %.2f, cook %.2f = %.2f ms\n",
+        report.m_assets.size(), report.GetCount(AssetCookResult::COOKED), report.GetCount(AssetCookResult::UP_TO_DATE),
+        report.GetCount(AssetCookResult::SKIPPED), report.GetCount(AssetCookResult::FAILED), report.m_fileCount, report.m_hashedFileCount,
+        report.m_scanMilliseconds, report.m_hashMilliseconds, report.m_cookMilliseconds, report.m_totalMilliseconds);
+
+    if (report.m_packResult == AssetCookResult::COOKED)
+    {
+        AssetPackBuildReport const& pack = report.m_pack;
+        DebuggerPrintf("[IglooCook] pack %s: %u files (%u compressed), %.1f KB -> %.1f KB, %.2f ms\n", report.m_packPath.c_str(),
+            pack.m_entryCount, pack.m_compressedCount, (double)pack.m_inputBytes / 1024.0, (double)pack.m_packBytes / 1024.0, report.m_packMilliseconds);
+    }
+    else if (report.m_packResult != AssetCookResult::SKIPPED)
+    {
+        DebuggerPrintf("[IglooCook] pack %s: %s, %u files, %.2f ms\n", report.m_packPath.c_str(),
+            report.m_packResult == AssetCookResult::UP_TO_DATE ? "up to date" : "FAILED", report.m_pack.m_entryCount, report.m_packMilliseconds);
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "Engine/Core/AssetPack.h"
+#include "Engine/Core/BlockCompression.h"
+#include "Engine/Core/StaticMesh.h"
+#include "Engine/Core/TextureCook.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//==============================================================================
+// AssetCooker - 离线把数据目录整个 cook 一遍（IglooCook），运行时第一次用就不用再算
+//==============================================================================
+// Walks the data root and finds:
+//   MESH        an xml with objFile: StaticMesh::CookOffline (geometry, bounds, BVH, card
+//               templates, SDF) into <xml>.cooked. Inputs: the xml, objFile, mtllib
+//   TEXTURE     every normalMap / diffuseMap / specGlossEmitMap of a mesh, with the settings
+//               the mesh would load it with (GetMaterialMipSettings, *Compression); any other
+//               image with default settings and m_textureFormat. Mips + blocks into .mips
+//   DEFINITION  any other xml: parsed, so a broken definition fails the cook, not the game
+// Bitmap fonts (and anything else loaded through Renderer::CreateOrGetTextureFromFile) are
+// cooked as plain images but still decoded from the png at runtime: that path reads no cook.
+// The output is the same cook the runtime writes on first use, for the backend m_textureTarget.
+//
+// Change tracking (manifest, a text file): per asset the settings key and the content hash of
+// every input at its last successful cook. A file is only re-hashed when its size or mtime
+// changed; an asset is cooked again when a hash or the settings key differs or an output is
+// gone. The cooks themselves are keyed on content too, so a lost manifest costs hashing, not
+// cooking. Dirty assets cook in parallel on the job system, largest inputs first.
+//
+// With m_packPath set, every file under the data root (sources too: the runtime keys its cooks
+// on them) then goes into one AssetPack for the VFS to mount. The pack is rebuilt only when a
+// file was added, removed, resized or touched after it was written.
+//==============================================================================
+
+enum class AssetCookType : uint8_t
+{
+    MESH,
+    TEXTURE,
+    DEFINITION,
+    COUNT
+};
+
+enum class AssetCookResult : uint8_t
+{
+    UP_TO_DATE,
+    COOKED,
+    SKIPPED,                                    // cooked="false"
+    FAILED
+};
+
+struct AssetCookConfig
+{
+    std::string m_dataRoot = "Data";           // paths in the data are relative to its parent (the Run directory)
+    std::string m_manifestPath;                 // empty = <dataRoot>/IglooCook.manifest
+    TextureCookTarget m_textureTarget = GetNativeTextureCookTarget();
+    BlockFormat m_textureFormat = BlockFormat::NONE;    // images no mesh uses
+    bool m_force = false;                       // ignore the manifest and every cook
+    bool m_cookMeshes = true;
+    bool m_cookTextures = true;
+    bool m_checkDefinitions = true;
+    StaticMeshCookOptions m_meshOptions;        // m_force is taken from m_force
+    std::string m_packPath;                     // empty = no pack
+    AssetPackBuildSettings m_packSettings;
+};
+
+struct AssetCookEntry
+{
+    AssetCookType m_type = AssetCookType::COUNT;
+    AssetCookResult m_result = AssetCookResult::FAILED;
+    std::string m_path;                         // mesh: the xml without extension
+    std::string m_detail;
+    double m_milliseconds = 0.0;
+    uint64_t m_inputBytes = 0;
+    uint64_t m_outputBytes = 0;
+};
+
+struct AssetCookReport
+{
+    std::vector<AssetCookEntry> m_assets;       // slowest first
+    uint32_t m_countByResult[4] = {};           // AssetCookResult
+    uint32_t m_fileCount = 0;                   // distinct inputs
+    uint32_t m_hashedFileCount = 0;             // size / mtime changed (or no manifest)
+    double m_scanMilliseconds = 0.0;
+    double m_hashMilliseconds = 0.0;
+    double m_cookMilliseconds = 0.0;
+    double m_totalMilliseconds = 0.0;
+    AssetCookResult m_packResult = AssetCookResult::SKIPPED;    // SKIPPED = no m_packPath
+    AssetPackBuildReport m_pack;                // when COOKED
+    std::string m_packPath;
+    double m_packMilliseconds = 0.0;
+
+    uint32_t GetCount(AssetCookResult result) const { return m_countByResult[(int)result]; }
+};
+
+AssetCookReport CookAssets(AssetCookConfig const& config);
+// one line per cooked / failed asset (all of them if verbose) and the totals
+void PrintAssetCookReport(AssetCookReport const& report, bool verbose = false);
+char const* GetAssetCookTypeName(AssetCookType type);
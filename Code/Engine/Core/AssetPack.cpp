@@ -0,0 +1,396 @@
+#include "AssetPack.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/LZCompression.h"
+#include "Engine/Core/MeshOptimizer.h"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Job/JobSystem.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <unordered_set>
+
+namespace
+{
+    char ToLowerPathChar(char c)
+    {
+        return (char)tolower((unsigned char)c);
+    }
+
+    bool IsSameAssetPackPath(char const* a, size_t aLength, std::string const& b)
+    {
+        if (aLength != b.size())
+            return false;
+        for (size_t i = 0; i < aLength; i++)
+        {
+            if (ToLowerPathChar(a[i]) != ToLowerPathChar(b[i]))
+                return false;
+        }
+        return true;
+    }
+
+    uint64_t AlignAssetPackOffset(uint64_t offset, uint64_t alignment)
+    {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    // 只有不压缩、至少一页的 entry 会被原地用，值得对齐到页
+    uint64_t GetAssetPackEntryAlignment(AssetPackEntry const& entry)
+    {
+        bool isInPlace = entry.m_compression == (uint32_t)AssetPackCompression::NONE && entry.m_size >= ASSET_PACK_PAGE_ALIGNMENT;
+        return isInPlace ? ASSET_PACK_PAGE_ALIGNMENT : ASSET_PACK_ALIGNMENT;
+    }
+
+    struct PendingPackEntry
+    {
+        std::string m_file;
+        std::string m_path;                 // normalized
+        uint64_t m_hash = 0;
+        bool m_isRead = false;
+        AssetPackCompression m_compression = AssetPackCompression::NONE;
+        uint64_t m_size = 0;
+        std::vector<uint8_t> m_storedBytes;
+    };
+}
+
+std::string NormalizeAssetPackPath(std::string const& path)
+{
+    std::vector<std::string> segments;
+    size_t start = 0;
+    while (start <= path.size())
+    {
+        size_t end = path.find_first_of("/\\", start);
+        if (end == std::string::npos)
+            end = path.size();
+        std::string segment = path.substr(start, end - start);
+        if (segment == "..")
+        {
+            if (!segments.empty() && segments.back() != "..")
+                segments.pop_back();
+            else
+                segments.push_back(segment);
+        }
+        else if (!segment.empty() && segment != ".")
+        {
+            segments.push_back(segment);
+        }
+        start = end + 1;
+    }
+
+    std::string normalized = !path.empty() && (path[0] == '/' || path[0] == '\\') ? "/" : "";
+    for (std::string const& segment : segments)
+    {
+        if (!normalized.empty() && normalized.back() != '/')
+            normalized += '/';
+        normalized += segment;
+    }
+    return normalized;
+}
+
+uint64_t HashAssetPackPath(std::string const& normalizedPath)
+{
+    // FNV-1a，大小写不敏感
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (char c : normalizedPath)
+    {
+        hash ^= (uint8_t)ToLowerPathChar(c);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+//-----------------------------------------------------------------------------------------------
+uint64_t GetAssetPackSettingsKey(AssetPackBuildSettings const& settings)
+{
+    uint32_t minSavingsBits = 0;
+    memcpy(&minSavingsBits, &settings.m_minSavings, sizeof(minSavingsBits));
+    uint64_t hash = MixHash(MixHash(0x9E3779B97F4A7C15ull, ASSET_PACK_VERSION), settings.m_compress ? 1u : 0u);
+    return FinalizeHash(MixHash(hash, minSavingsBits));
+}
+
+bool BuildAssetPack(std::string const& packPath, std::vector<std::string> const& files, AssetPackBuildSettings const& settings, AssetPackBuildReport* outReport)
+{
+    double startTime = GetCurrentTimeSeconds();
+    AssetPackBuildReport report;
+
+    std::vector<PendingPackEntry> pending;
+    std::unordered_set<std::string> seenPaths;
+    for (std::string const& file : files)
+    {
+        PendingPackEntry entry;
+        entry.m_file = file;
+        entry.m_path = NormalizeAssetPackPath(file);
+        std::string lowerPath = entry.m_path;
+        std::transform(lowerPath.begin(), lowerPath.end(), lowerPath.begin(), ToLowerPathChar);
+        if (entry.m_path.empty() || !seenPaths.insert(lowerPath).second)
+            continue;
+        entry.m_hash = HashAssetPackPath(entry.m_path);
+        pending.push_back(std::move(entry));
+    }
+    std::sort(pending.begin(), pending.end(), [](PendingPackEntry const& a, PendingPackEntry const& b)
+    {
+        return a.m_hash != b.m_hash ? a.m_hash < b.m_hash : a.m_path < b.m_path;
+    });
+
+    // 读和压缩都是各做各的
+    ParallelFor((uint32_t)pending.size(), 1, [&pending, &settings](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            PendingPackEntry& entry = pending[i];
+            std::vector<uint8_t> bytes;
+            entry.m_isRead = FileReadToBufferFromDisk(bytes, entry.m_file) >= 0;
+            entry.m_size = bytes.size();
+
+            std::vector<uint8_t> compressed;
+            uint64_t maxCompressedSize = entry.m_size - (uint64_t)((double)entry.m_size * (double)settings.m_minSavings);
+            if (settings.m_compress && CompressLZ(bytes.data(), bytes.size(), compressed) && compressed.size() <= maxCompressedSize)
+            {
+                entry.m_compression = AssetPackCompression::LZ;
+                entry.m_storedBytes = std::move(compressed);
+            }
+            else
+            {
+                entry.m_storedBytes = std::move(bytes);
+            }
+        }
+    });
+
+    AssetPackHeader header;
+    header.m_entryCount = (uint32_t)pending.size();
+    header.m_settingsKey = GetAssetPackSettingsKey(settings);
+    std::vector<AssetPackEntry> entries(pending.size());
+    std::string pathTable;
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        PendingPackEntry const& source = pending[i];
+        if (!source.m_isRead)
+        {
+            DebuggerPrintf("[AssetPack] %s: could not read %s\n", packPath.c_str(), source.m_file.c_str());
+            return false;
+        }
+        AssetPackEntry& entry = entries[i];
+        entry.m_pathHash = source.m_hash;
+        entry.m_storedSize = source.m_storedBytes.size();
+        entry.m_size = source.m_size;
+        entry.m_pathOffset = (uint32_t)pathTable.size();
+        entry.m_pathLength = (uint32_t)source.m_path.size();
+        entry.m_compression = (uint32_t)source.m_compression;
+        pathTable += source.m_path;
+
+        report.m_inputBytes += entry.m_size;
+        report.m_storedBytes += entry.m_storedSize;
+        report.m_compressedCount += source.m_compression == AssetPackCompression::LZ ? 1 : 0;
+    }
+    header.m_pathTableSize = (uint32_t)pathTable.size();
+
+    uint64_t pathTableOffset = sizeof(AssetPackHeader) + entries.size() * sizeof(AssetPackEntry);
+    std::vector<size_t> payloadOrder(pending.size());
+    for (size_t i = 0; i < payloadOrder.size(); i++)
+    {
+        payloadOrder[i] = i;
+    }
+    std::sort(payloadOrder.begin(), payloadOrder.end(), [&pending](size_t a, size_t b) { return pending[a].m_path < pending[b].m_path; });
+
+    uint64_t offset = pathTableOffset + pathTable.size();
+    for (size_t i : payloadOrder)
+    {
+        AssetPackEntry& entry = entries[i];
+        entry.m_offset = AlignAssetPackOffset(offset, GetAssetPackEntryAlignment(entry));
+        offset = entry.m_offset + entry.m_storedSize;
+    }
+    offset = AlignAssetPackOffset(offset, ASSET_PACK_ALIGNMENT);
+    header.m_fileSize = offset;
+
+    std::vector<uint8_t> buffer((size_t)offset, 0);
+    memcpy(buffer.data(), &header, sizeof(header));
+    if (!entries.empty())
+        memcpy(buffer.data() + sizeof(header), entries.data(), entries.size() * sizeof(AssetPackEntry));
+    if (!pathTable.empty())
+        memcpy(buffer.data() + pathTableOffset, pathTable.data(), pathTable.size());
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        if (!pending[i].m_storedBytes.empty())
+            memcpy(buffer.data() + entries[i].m_offset, pending[i].m_storedBytes.data(), pending[i].m_storedBytes.size());
+    }
+
+    std::string tempPath = packPath + ".tmp";
+    if (FileWriteFromBuffer(buffer, tempPath) != (int)buffer.size())
+    {
+        remove(tempPath.c_str());
+        return false;
+    }
+    remove(packPath.c_str());
+    if (rename(tempPath.c_str(), packPath.c_str()) != 0)
+        return false;
+
+    report.m_entryCount = header.m_entryCount;
+    report.m_packBytes = offset;
+    report.m_milliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+    if (outReport)
+        *outReport = report;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool AssetPack::Open(std::string const& packPath)
+{
+    Close();
+    if (!m_file.OpenOnDisk(packPath))
+        return false;
+
+    uint8_t const* data = m_file.GetData();
+    size_t size = m_file.GetSize();
+    AssetPackHeader const* header = (AssetPackHeader const*)data;
+    if (size < sizeof(AssetPackHeader) || header->m_magic != ASSET_PACK_MAGIC || header->m_version != ASSET_PACK_VERSION ||
+        header->m_fileSize != (uint64_t)size ||
+        sizeof(AssetPackHeader) + (uint64_t)header->m_entryCount * sizeof(AssetPackEntry) + header->m_pathTableSize > size)
+    {
+        Close();
+        return false;
+    }
+
+    // 越界的 entry 当成坏包，整个不用
+    AssetPackEntry const* entries = (AssetPackEntry const*)(data + sizeof(AssetPackHeader));
+    for (uint32_t i = 0; i < header->m_entryCount; i++)
+    {
+        AssetPackEntry const& entry = entries[i];
+        bool isStoredSizeValid = entry.m_compression == (uint32_t)AssetPackCompression::LZ ||
+            (entry.m_compression == (uint32_t)AssetPackCompression::NONE && entry.m_storedSize == entry.m_size);
+        if (entry.m_offset % GetAssetPackEntryAlignment(entry) != 0 || entry.m_offset > size || entry.m_storedSize > size - entry.m_offset ||
+            !isStoredSizeValid || (uint64_t)entry.m_pathOffset + entry.m_pathLength > header->m_pathTableSize ||
+            (i > 0 && entries[i - 1].m_pathHash > entry.m_pathHash))
+        {
+            Close();
+            return false;
+        }
+    }
+    m_path = packPath;
+    m_entries = entries;
+    m_entryCount = header->m_entryCount;
+    m_pathTable = (char const*)(entries + header->m_entryCount);
+    m_settingsKey = header->m_settingsKey;
+    return true;
+}
+
+void AssetPack::Close()
+{
+    m_file.Close();
+    m_path.clear();
+    m_entries = nullptr;
+    m_entryCount = 0;
+    m_pathTable = nullptr;
+    m_settingsKey = 0;
+}
+
+std::string AssetPack::GetEntryPath(AssetPackEntry const& entry) const
+{
+    return std::string(m_pathTable + entry.m_pathOffset, entry.m_pathLength);
+}
+
+AssetPackEntry const* AssetPack::FindEntry(std::string const& path) const
+{
+    if (m_entryCount == 0)
+        return nullptr;
+    std::string normalized = NormalizeAssetPackPath(path);
+    uint64_t hash = HashAssetPackPath(normalized);
+    AssetPackEntry const* end = m_entries + m_entryCount;
+    AssetPackEntry const* entry = std::lower_bound(m_entries, end, hash, [](AssetPackEntry const& e, uint64_t h) { return e.m_pathHash < h; });
+    for (; entry != end && entry->m_pathHash == hash; ++entry)
+    {
+        if (IsSameAssetPackPath(m_pathTable + entry->m_pathOffset, entry->m_pathLength, normalized))
+            return entry;
+    }
+    return nullptr;
+}
+
+uint8_t const* AssetPack::GetEntryData(AssetPackEntry const& entry) const
+{
+    if (entry.m_compression != (uint32_t)AssetPackCompression::NONE)
+        return nullptr;
+    return m_file.GetData() + entry.m_offset;
+}
+
+bool AssetPack::ReadEntry(AssetPackEntry const& entry, std::vector<uint8_t>& outBytes) const
+{
+    outBytes.resize((size_t)entry.m_size);
+    if (ReadEntry(entry, outBytes.data()))
+        return true;
+    outBytes.clear();
+    return false;
+}
+
+bool AssetPack::ReadEntry(AssetPackEntry const& entry, uint8_t* outBytes) const
+{
+    uint8_t const* stored = m_file.GetData() + entry.m_offset;
+    if (entry.m_compression == (uint32_t)AssetPackCompression::LZ)
+        return DecompressLZ(stored, (size_t)entry.m_storedSize, outBytes, (size_t)entry.m_size);
+    if (entry.m_size > 0)
+        memcpy(outBytes, stored, (size_t)entry.m_size);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+AssetPackBenchmarkReport BenchmarkAssetPack(std::string const& packPath, uint32_t runCount)
+{
+    AssetPackBenchmarkReport report;
+    std::vector<std::string> paths;
+    {
+        AssetPack pack;
+        if (!pack.Open(packPath))
+        {
+            DebuggerPrintf("[AssetPack] %s: not a valid pack, nothing to benchmark\n", packPath.c_str());
+            return report;
+        }
+        for (uint32_t i = 0; i < pack.GetEntryCount(); i++)
+        {
+            paths.push_back(pack.GetEntryPath(pack.GetEntry(i)));
+            report.m_bytes += pack.GetEntry(i).m_size;
+        }
+    }
+    report.m_runCount = runCount;
+    report.m_fileCount = (uint32_t)paths.size();
+
+    std::vector<uint8_t> buffer;
+    for (uint32_t run = 0; run < runCount; run++)
+    {
+        double looseStart = GetCurrentTimeSeconds();
+        for (std::string const& path : paths)
+        {
+            FileReadToBufferFromDisk(buffer, path);
+        }
+        double packedStart = GetCurrentTimeSeconds();
+        report.m_avgLooseMilliseconds += (packedStart - looseStart) * 1000.0;
+
+        AssetPack pack;
+        pack.Open(packPath);
+        double readStart = GetCurrentTimeSeconds();
+        report.m_avgPackOpenMilliseconds += (readStart - packedStart) * 1000.0;
+        for (std::string const& path : paths)
+        {
+            AssetPackEntry const* entry = pack.FindEntry(path);
+            if (!entry)
+                continue;
+            double entryStart = GetCurrentTimeSeconds();
+            pack.ReadEntry(*entry, buffer);
+            if (entry->m_compression == (uint32_t)AssetPackCompression::LZ)
+                report.m_avgDecompressMilliseconds += (GetCurrentTimeSeconds() - entryStart) * 1000.0;
+        }
+        report.m_avgPackedMilliseconds += (GetCurrentTimeSeconds() - packedStart) * 1000.0;
+    }
+    if (runCount > 0)
+    {
+        report.m_avgLooseMilliseconds /= (double)runCount;
+        report.m_avgPackedMilliseconds /= (double)runCount;
+        report.m_avgPackOpenMilliseconds /= (double)runCount;
+        report.m_avgDecompressMilliseconds /= (double)runCount;
+    }
+
+    DebuggerPrintf("[AssetPack] %s x%u: %u files, %.1f KB: loose %.2f ms, packed %.2f ms (open %.2f ms, decompress %.2f ms), x%.2f\n",
+        packPath.c_str(), runCount, report.m_fileCount, (double)report.m_bytes / 1024.0, report.m_avgLooseMilliseconds,
+        report.m_avgPackedMilliseconds, report.m_avgPackOpenMilliseconds, report.m_avgDecompressMilliseconds, report.GetSpeedup());
+    return report;
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include "Engine/Core/MappedFile.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//==============================================================================
+// AssetPack - 把 Data 目录打成一个文件：一次 mmap 代替上千次 open / seek
+//==============================================================================
+// Layout (native endianness, everything POD):
+//   AssetPackHeader
+//   AssetPackEntry[entryCount], sorted by (pathHash, path)
+//   path table: every normalized path back to back, no terminators
+//   entry payloads in path order (a directory loads from one stretch of the file): uncompressed
+//   ones of at least a page on an ASSET_PACK_PAGE_ALIGNMENT boundary, the rest on
+//   ASSET_PACK_ALIGNMENT, so small files don't each cost a page
+//
+// Paths are stored normalized (NormalizeAssetPackPath: '/' separators, "." and ".." resolved)
+// and looked up by binary search on a case-insensitive hash, so "data\\Models\\X.png" finds
+// Data/Models/x.png just like the loose file does on Windows.
+// An entry is LZ compressed (LZCompression, LZ4 block) only when that saves at least
+// AssetPackBuildSettings::m_minSavings; PNG / JPG and most BCn data stay NONE and are used in
+// place from the mapping, page aligned like a loose file's own mapping.
+// Packs are built by IglooCook (AssetCookConfig::m_packPath) and mounted through the VFS
+// (VirtualFileSystem.h).
+//==============================================================================
+
+static constexpr uint32_t ASSET_PACK_MAGIC = 0x4B415049;    // "IPAK"
+static constexpr uint32_t ASSET_PACK_VERSION = 1;
+static constexpr uint64_t ASSET_PACK_ALIGNMENT = 64;            // = COOKED_MESH_SECTION_ALIGNMENT
+static constexpr uint64_t ASSET_PACK_PAGE_ALIGNMENT = 4096;
+
+enum class AssetPackCompression : uint32_t
+{
+    NONE,
+    LZ
+};
+
+struct AssetPackHeader
+{
+    uint32_t m_magic = ASSET_PACK_MAGIC;
+    uint32_t m_version = ASSET_PACK_VERSION;
+    uint32_t m_entryCount = 0;
+    uint32_t m_pathTableSize = 0;
+    uint64_t m_fileSize = 0;
+    uint64_t m_settingsKey = 0;          // GetAssetPackSettingsKey of the build, a change rebuilds the pack
+};
+
+struct AssetPackEntry
+{
+    uint64_t m_pathHash = 0;             // HashAssetPackPath
+    uint64_t m_offset = 0;               // from the start of the pack
+    uint64_t m_storedSize = 0;
+    uint64_t m_size = 0;                 // after decompression
+    uint32_t m_pathOffset = 0;           // into the path table
+    uint32_t m_pathLength = 0;
+    uint32_t m_compression = 0;          // AssetPackCompression
+    uint32_t m_reserved = 0;
+};
+
+std::string NormalizeAssetPackPath(std::string const& path);
+uint64_t HashAssetPackPath(std::string const& normalizedPath);
+
+//-----------------------------------------------------------------------------------------------
+struct AssetPackBuildSettings
+{
+    bool m_compress = true;
+    float m_minSavings = 0.125f;         // keep an entry uncompressed unless LZ makes it this much smaller
+};
+
+uint64_t GetAssetPackSettingsKey(AssetPackBuildSettings const& settings);
+
+struct AssetPackBuildReport
+{
+    uint32_t m_entryCount = 0;
+    uint32_t m_compressedCount = 0;
+    uint64_t m_inputBytes = 0;
+    uint64_t m_storedBytes = 0;          // payloads, without padding
+    uint64_t m_packBytes = 0;
+    double m_milliseconds = 0.0;
+};
+
+// files are the paths the game opens (relative to the Run directory) and are read from disk, never
+// from a mounted pack. Reads and compression run on the job system; written to a temp file and
+// renamed like the cooks. False if a file can't be read or the pack can't be written
+bool BuildAssetPack(std::string const& packPath, std::vector<std::string> const& files, AssetPackBuildSettings const& settings = AssetPackBuildSettings(),
+    AssetPackBuildReport* outReport = nullptr);
+
+//-----------------------------------------------------------------------------------------------
+class AssetPack
+{
+public:
+    // maps the pack (from disk) and validates the header, index and path table
+    bool Open(std::string const& packPath);
+    void Close();
+    bool IsOpen() const { return m_file.IsOpen(); }
+    std::string const& GetPath() const { return m_path; }
+    size_t GetFileSize() const { return m_file.GetSize(); }
+    uint64_t GetSettingsKey() const { return m_settingsKey; }
+
+    uint32_t GetEntryCount() const { return m_entryCount; }
+    AssetPackEntry const& GetEntry(uint32_t index) const { return m_entries[index]; }
+    std::string GetEntryPath(AssetPackEntry const& entry) const;
+
+    // path as the game spells it; nullptr if the pack does not have it
+    AssetPackEntry const* FindEntry(std::string const& path) const;
+
+    // the payload in place, valid while the pack stays open; nullptr for compressed entries
+    uint8_t const* GetEntryData(AssetPackEntry const& entry) const;
+
+    // copies or decompresses into outBytes
+    bool ReadEntry(AssetPackEntry const& entry, std::vector<uint8_t>& outBytes) const;
+    bool ReadEntry(AssetPackEntry const& entry, uint8_t* outBytes) const;    // entry.m_size bytes
+
+private:
+    std::string m_path;
+    MappedFile m_file;
+    AssetPackEntry const* m_entries = nullptr;
+    uint32_t m_entryCount = 0;
+    char const* m_pathTable = nullptr;
+    uint64_t m_settingsKey = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+// 冷启动对比：同一批文件逐个从磁盘读 vs 从 pack 读（含解压）
+struct AssetPackBenchmarkReport
+{
+    uint32_t m_runCount = 0;
+    uint32_t m_fileCount = 0;
+    uint64_t m_bytes = 0;
+    double m_avgLooseMilliseconds = 0.0;  // FileReadToBufferFromDisk on every entry
+    double m_avgPackedMilliseconds = 0.0; // open the pack + ReadEntry on every entry
+    double m_avgPackOpenMilliseconds = 0.0;
+    double m_avgDecompressMilliseconds = 0.0;
+
+    double GetSpeedup() const { return m_avgPackedMilliseconds > 0.0 ? m_avgLooseMilliseconds / m_avgPackedMilliseconds : 0.0; }
+};
+
+// Alternates loose and packed passes; after the first run both sides come from the OS file cache,
+// so this measures per-file open / read overhead. A truly cold number needs the cache purged
+// between runs (reboot, or RAMMap "Empty Standby List" on Windows) and runCount 1
+AssetPackBenchmarkReport BenchmarkAssetPack(std::string const& packPath, uint32_t runCount = 5);
@@ -0,0 +1,670 @@
+#include "AssetStreamer.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/TextureCook.h"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Job/JobSystem.h"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+    Texture* UploadImage(Renderer* renderer, Image const& image)
+    {
+        Texture* texture = renderer->CreateTextureFromImage(image);
+#ifdef ENGINE_DX12_RENDERER
+        renderer->GetSubRenderer()->PushBackNewTextureManually(texture);
+#endif
+        return texture;
+    }
+
+    uint64_t GetImageBytes(Image const& image)
+    {
+        IntVec2 dimensions = image.GetDimensions();
+        return (uint64_t)dimensions.x * (uint64_t)dimensions.y * sizeof(Rgba8);
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+class AssetStreamJob : public Job
+{
+public:
+    AssetStreamJob(AssetStreamer* streamer, AssetHandle* handle, AssetLoadState stage)
+        : Job(stage == AssetLoadState::READING ? JOB_TYPE_IO : JOB_TYPE_WORKER)
+        , m_streamer(streamer)
+        , m_handle(handle)
+        , m_stage(stage)
+    {
+    }
+
+    void Execute() override
+    {
+        switch (m_stage)
+        {
+        case AssetLoadState::READING:    m_handle->m_stageSucceeded = m_handle->Read(); break;
+        case AssetLoadState::DECODING:   m_handle->m_stageSucceeded = m_handle->Decode(); break;
+        case AssetLoadState::FINALIZING: m_handle->Finalize(); m_handle->m_stageSucceeded = true; break;
+        default: break;
+        }
+    }
+
+    void OnComplete() override
+    {
+        m_streamer->OnStageComplete(m_handle, m_stage);
+    }
+
+private:
+    AssetStreamer* m_streamer = nullptr;
+    AssetHandle* m_handle = nullptr;
+    AssetLoadState m_stage = AssetLoadState::READING;
+};
+
+//-----------------------------------------------------------------------------------------------
+// texture residency: the finer levels come back from the cook, never from the source image
+class TextureMipStreamJob : public Job
+{
+public:
+    TextureMipStreamJob(AssetStreamer* streamer, TextureHandle* handle, int toMip)
+        : Job(JOB_TYPE_IO)
+        , m_streamer(streamer)
+    {
+        m_streamIn.m_handle = handle;
+        m_streamIn.m_toMip = toMip;
+    }
+
+    void Execute() override
+    {
+        TextureHandle const* handle = m_streamIn.m_handle;
+        uint64_t mipKey = 0;
+        uint64_t blockKey = 0;
+        // 只读 toMip 往后的 level，已经常驻的那些不用再从 cook 里拷一遍
+        m_streamIn.m_succeeded = LoadCookedTextureMips(handle->m_path, handle->m_mipSettings, handle->m_blockFormat,
+            GetNativeTextureCookTarget(), mipKey, blockKey, m_streamIn.m_mips, m_streamIn.m_blocks, m_streamIn.m_toMip);
+        int levelCount = m_streamIn.m_blocks.IsValid() ? m_streamIn.m_blocks.GetLevelCount() : m_streamIn.m_mips.GetLevelCount();
+        m_streamIn.m_succeeded = m_streamIn.m_succeeded && m_streamIn.m_toMip < levelCount;
+    }
+
+    void OnComplete() override
+    {
+        m_streamer->OnTextureMipsRead(std::move(m_streamIn));
+    }
+
+private:
+    AssetStreamer* m_streamer = nullptr;
+    TextureMipStreamIn m_streamIn;
+};
+
+uint64_t TextureMipStreamIn::GetUploadBytes() const
+{
+    if (m_blocks.IsValid())
+        return m_blocks.GetTotalBytes() - m_blocks.m_levels[m_toMip].m_firstByte;
+    if (m_mips.IsValid())
+        return m_mips.GetTotalBytes() - m_mips.m_levels[m_toMip].m_firstTexel * sizeof(Rgba8);
+    return 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool StaticMeshHandle::Read()
+{
+    m_isFromCooked = StaticMesh::LoadCookedGeometry(m_path, m_geometry);
+
+    XmlDocument meshDefDoc;
+    if (LoadXmlFile(meshDefDoc, m_path + ".xml") != XmlResult::XML_SUCCESS)
+        return false;
+    XmlElement* meshElement = meshDefDoc.RootElement();
+    m_sourceFilePath = ParseXmlAttribute(*meshElement, "objFile", "");
+
+    // 读不到的贴图留空，ctor 会照旧同步读（并照旧报错）；.mips 命中的连源文件都不用读
+    char const* textureAttributes[3] = { "normalMap", "diffuseMap", "specGlossEmitMap" };
+    ImageMipChain* mips[3] = { &m_geometry.m_normalMips, &m_geometry.m_diffuseMips, &m_geometry.m_specularMips };
+    CompressedMipChain* blocks[3] = { &m_geometry.m_normalBlocks, &m_geometry.m_diffuseBlocks, &m_geometry.m_specularBlocks };
+    // BC5 法线只存 xy，shader 要自己重建 z，所以法线单独一个属性
+    BlockFormat normalFormat = ParseBlockFormat(ParseXmlAttribute(*meshElement, "normalMapCompression", ""));
+    BlockFormat colorFormat = ParseBlockFormat(ParseXmlAttribute(*meshElement, "textureCompression", ""));
+    for (int i = 0; i < 3; i++)
+    {
+        m_texturePaths[i] = ParseXmlAttribute(*meshElement, textureAttributes[i], "");
+        m_textureFormats[i] = i == 0 ? normalFormat : colorFormat;
+        if (m_texturePaths[i].empty() || LoadCookedTextureMips(m_texturePaths[i], GetMaterialMipSettings(i), m_textureFormats[i],
+            GetNativeTextureCookTarget(), m_textureMipKeys[i], m_textureBlockKeys[i], *mips[i], *blocks[i]))
+            continue;
+        if (FileReadToBuffer(m_textureBytes[i], m_texturePaths[i]) <= 0)
+            m_textureBytes[i].clear();
+    }
+    return true;
+}
+
+bool StaticMeshHandle::Decode()
+{
+    if (!m_isFromCooked && !StaticMesh::ImportGeometryFromSource(m_path, m_geometry))
+        return false;
+    // cook 里没有贴图，.glb 的材质贴图也在这里解，别留给主线程的 ctor
+    if (m_isFromCooked && EndsWith(m_sourceFilePath, ".glb"))
+        StaticMesh::DecodeGLBImages(m_sourceFilePath, m_geometry);
+
+    Image* images[3] = { &m_geometry.m_normalImage, &m_geometry.m_diffuseImage, &m_geometry.m_specularImage };
+    ImageMipChain* mips[3] = { &m_geometry.m_normalMips, &m_geometry.m_diffuseMips, &m_geometry.m_specularMips };
+    CompressedMipChain* blocks[3] = { &m_geometry.m_normalBlocks, &m_geometry.m_diffuseBlocks, &m_geometry.m_specularBlocks };
+    for (int i = 0; i < 3; i++)
+    {
+        if (!mips[i]->IsValid() && !blocks[i]->IsValid() && DecodeImageFromMemory(m_texturePaths[i], m_textureBytes[i], GetNativeTextureCookTarget(), *images[i]))
+        {
+            // chain 的第 0 级就是原图，Image 不用再留着
+            BuildTextureMips(*images[i], GetMaterialMipSettings(i), m_textureFormats[i], GetNativeTextureCookTarget(), m_textureMipKeys[i], m_textureBlockKeys[i], *mips[i], *blocks[i]);
+            *images[i] = Image();
+        }
+        std::vector<uint8_t>().swap(m_textureBytes[i]);
+    }
+    return true;
+}
+
+void StaticMeshHandle::Upload(Renderer* renderer)
+{
+    // 从 cook 的 mip chain 传上去的材质贴图交给 residency 管，磁盘上一定有它的 cook
+    ImageMipChain const* mips[3] = { &m_geometry.m_normalMips, &m_geometry.m_diffuseMips, &m_geometry.m_specularMips };
+    CompressedMipChain const* blocks[3] = { &m_geometry.m_normalBlocks, &m_geometry.m_diffuseBlocks, &m_geometry.m_specularBlocks };
+    bool isFromMipCook[3] = {};
+    BlockFormat uploadedFormats[3] = {};
+    for (int i = 0; i < 3; i++)
+    {
+        isFromMipCook[i] = blocks[i]->IsValid() || mips[i]->IsValid();
+        uploadedFormats[i] = blocks[i]->IsValid() ? blocks[i]->m_format : BlockFormat::NONE;
+    }
+
+    m_mesh = new StaticMesh(renderer, m_path, false, &m_geometry);
+    m_geometry = StaticMeshGeometry();
+
+    if (!m_streamer)
+        return;
+    Texture* textures[3] = { m_mesh->m_normalTexture, m_mesh->m_diffuseTexture, m_mesh->m_specularTexture };
+    for (int i = 0; i < 3; i++)
+    {
+        if (isFromMipCook[i] && textures[i])
+            m_materialTextures[i] = m_streamer->AdoptTexture(m_texturePaths[i], textures[i], GetMaterialMipSettings(i), uploadedFormats[i]);
+    }
+    m_streamer->m_meshHandles[m_mesh] = this;
+}
+
+void StaticMeshHandle::Finalize()
+{
+    m_mesh->GenerateCardTemplates();
+}
+
+uint64_t StaticMeshHandle::GetUploadBytes() const
+{
+    return m_geometry.m_verts.size() * sizeof(Vertex_PCUTBN) + m_geometry.m_indices.size() * sizeof(unsigned int) +
+        GetImageBytes(m_geometry.m_normalImage) + GetImageBytes(m_geometry.m_diffuseImage) + GetImageBytes(m_geometry.m_specularImage) +
+        m_geometry.m_normalMips.GetTotalBytes() + m_geometry.m_diffuseMips.GetTotalBytes() + m_geometry.m_specularMips.GetTotalBytes() +
+        m_geometry.m_normalBlocks.GetTotalBytes() + m_geometry.m_diffuseBlocks.GetTotalBytes() + m_geometry.m_specularBlocks.GetTotalBytes() +
+        GetImageBytes(m_geometry.m_glbAlbedoImage) + GetImageBytes(m_geometry.m_glbNormalImage) + GetImageBytes(m_geometry.m_glbOcclusionImage);
+}
+
+//-----------------------------------------------------------------------------------------------
+bool TextureHandle::Read()
+{
+    if (LoadCookedTextureMips(m_path, m_mipSettings, m_blockFormat, GetNativeTextureCookTarget(), m_mipCookKey, m_blockCookKey, m_mipChain, m_blocks))
+        return true;
+    return FileReadToBuffer(m_fileBytes, m_path) > 0;
+}
+
+bool TextureHandle::Decode()
+{
+    if (m_mipChain.IsValid() || m_blocks.IsValid())
+        return true;
+
+    Image image;
+    bool isDecoded = DecodeImageFromMemory(m_path, m_fileBytes, GetNativeTextureCookTarget(), image);
+    std::vector<uint8_t>().swap(m_fileBytes);
+    if (isDecoded)
+        BuildTextureMips(image, m_mipSettings, m_blockFormat, GetNativeTextureCookTarget(), m_mipCookKey, m_blockCookKey, m_mipChain, m_blocks);
+    return isDecoded;
+}
+
+void TextureHandle::Upload(Renderer* renderer)
+{
+    // 有 residency 的先只传 mip tail，细的 level 按屏幕上的大小再流进来
+    int residentMip = 0;
+    if (m_residency)
+    {
+        IntVec2 dimensions = m_blocks.IsValid() ? m_blocks.GetDimensions(0) : m_mipChain.GetDimensions(0);
+        int levelCount = m_blocks.IsValid() ? m_blocks.GetLevelCount() : m_mipChain.GetLevelCount();
+        BlockFormat format = m_blocks.IsValid() ? m_blocks.m_format : BlockFormat::NONE;
+        m_residencyId = m_residency->Register(m_path, dimensions, levelCount, format, levelCount - 1);
+        residentMip = m_residency->GetTailMip(m_residencyId);
+    }
+    m_texture = m_blocks.IsValid() ? renderer->CreateTextureFromCompressedMipChain(m_blocks, residentMip) : renderer->CreateTextureFromMipChain(m_mipChain, residentMip);
+#ifdef ENGINE_DX12_RENDERER
+    renderer->GetSubRenderer()->PushBackNewTextureManually(m_texture);
+#endif
+    m_mipChain = ImageMipChain();
+    m_blocks = CompressedMipChain();
+}
+
+uint64_t TextureHandle::GetUploadBytes() const
+{
+    return m_mipChain.GetTotalBytes() + m_blocks.GetTotalBytes();
+}
+
+//-----------------------------------------------------------------------------------------------
+AssetStreamer::AssetStreamer(AssetStreamerConfig const& config)
+    : m_config(config)
+    , m_textureResidency(config.m_textureResidency)
+{
+}
+
+AssetStreamer::~AssetStreamer()
+{
+    // job 还拿着 handle，等它们跑完（JobSystem 已经 Shutdown 的话 job 已经被删了，不用等）
+    m_queued.clear();
+    while (g_theJobSystem && !g_theJobSystem->IsQuitting() && (m_inFlightCount > (int)m_uploadQueue.size() || m_mipStreamsInFlight > 0))
+    {
+        PumpCompletedJobs();
+        std::this_thread::yield();
+    }
+
+    for (auto& [name, handle] : m_meshes)
+    {
+        if (handle->m_ownsMesh)
+            delete handle->m_mesh;
+        handle->m_mesh = nullptr;
+    }
+    delete m_placeholderMesh;
+    m_placeholderMesh = nullptr;
+}
+
+StaticMeshHandle* AssetStreamer::RequestMesh(std::string const& name, std::string const& xmlPathNoExtensions, bool enableCardTemplates)
+{
+    auto found = m_meshes.find(name);
+    if (found != m_meshes.end())
+        return found->second.get();
+
+    std::unique_ptr<StaticMeshHandle> handle = std::make_unique<StaticMeshHandle>();
+    handle->m_path = xmlPathNoExtensions;
+    handle->m_placeholder = GetOrCreatePlaceholderMesh();
+    handle->m_enableCardTemplates = enableCardTemplates;
+    handle->m_streamer = this;
+    handle->m_requestTime = GetCurrentTimeSeconds();
+
+    StaticMeshHandle* result = handle.get();
+    m_meshes.emplace(name, std::move(handle));
+    m_queued.push_back(result);
+    StartQueuedLoads();
+    return result;
+}
+
+StaticMeshHandle* AssetStreamer::FindMesh(std::string const& name) const
+{
+    auto found = m_meshes.find(name);
+    return found != m_meshes.end() ? found->second.get() : nullptr;
+}
+
+StaticMeshHandle* AssetStreamer::AdoptMesh(std::string const& name, StaticMesh* mesh)
+{
+    auto found = m_meshes.find(name);
+    if (found != m_meshes.end())
+        return found->second.get();
+
+    std::unique_ptr<StaticMeshHandle> handle = std::make_unique<StaticMeshHandle>();
+    handle->m_path = mesh->m_filePath;
+    handle->m_mesh = mesh;
+    handle->m_placeholder = mesh;
+    handle->m_ownsMesh = false;
+    handle->m_state = AssetLoadState::READY;
+
+    StaticMeshHandle* result = handle.get();
+    m_meshes.emplace(name, std::move(handle));
+    return result;
+}
+
+TextureHandle* AssetStreamer::RequestTexture(std::string const& imageFilePath, ImageMipSettings const& mipSettings, BlockFormat format)
+{
+    auto found = m_textures.find(imageFilePath);
+    if (found != m_textures.end())
+        return found->second.get();
+
+    std::unique_ptr<TextureHandle> handle = std::make_unique<TextureHandle>();
+    handle->m_path = imageFilePath;
+    handle->m_mipSettings = mipSettings;
+    handle->m_blockFormat = format;
+    handle->m_placeholder = GetOrCreatePlaceholderTexture();
+    if (m_config.m_enableTextureResidency && UsesMipCook(mipSettings))
+        handle->m_residency = &m_textureResidency;
+    handle->m_requestTime = GetCurrentTimeSeconds();
+
+    TextureHandle* result = handle.get();
+    m_textures.emplace(imageFilePath, std::move(handle));
+    m_queued.push_back(result);
+    StartQueuedLoads();
+    return result;
+}
+
+TextureHandle* AssetStreamer::AdoptTexture(std::string const& imageFilePath, Texture* texture, ImageMipSettings const& mipSettings, BlockFormat format)
+{
+    auto found = m_textures.find(imageFilePath);
+    if (found != m_textures.end())
+        return found->second.get();
+
+    std::unique_ptr<TextureHandle> handle = std::make_unique<TextureHandle>();
+    handle->m_path = imageFilePath;
+    handle->m_texture = texture;
+    handle->m_placeholder = texture;
+    handle->m_mipSettings = mipSettings;
+    handle->m_blockFormat = format;
+    handle->m_state = AssetLoadState::READY;
+    if (m_config.m_enableTextureResidency && UsesMipCook(mipSettings))
+    {
+        handle->m_residency = &m_textureResidency;
+        handle->m_residencyId = m_textureResidency.Register(imageFilePath, texture->GetDimensions(), texture->GetMipLevelCount(),
+            format, texture->GetResidentMip());
+    }
+
+    TextureHandle* result = handle.get();
+    m_textures.emplace(imageFilePath, std::move(handle));
+    return result;
+}
+
+void AssetStreamer::Update()
+{
+    PumpCompletedJobs();
+    StartQueuedLoads();
+    UpdateTextureResidency();
+
+    // 每帧上传有上限；第一个总是传，大资源不会永远卡在队列里
+    double uploadStart = GetCurrentTimeSeconds();
+    uint32_t uploads = 0;
+    uint64_t uploadBytes = 0;
+    while (!m_uploadQueue.empty())
+    {
+        AssetHandle* handle = m_uploadQueue.front();
+        uint64_t handleBytes = handle->GetUploadBytes();
+        if (uploads > 0 && (uploads >= (uint32_t)m_config.m_maxUploadsPerFrame || uploadBytes + handleBytes > m_config.m_maxUploadBytesPerFrame))
+            break;
+
+        m_uploadQueue.pop_front();
+        Upload(handle);
+        uploads++;
+        uploadBytes += handleBytes;
+    }
+    // 流进来的 mip 和新资源共用同一份预算，排在新资源后面
+    while (!m_mipUploadQueue.empty())
+    {
+        uint64_t streamInBytes = m_mipUploadQueue.front().GetUploadBytes();
+        if (uploads > 0 && (uploads >= (uint32_t)m_config.m_maxUploadsPerFrame || uploadBytes + streamInBytes > m_config.m_maxUploadBytesPerFrame))
+            break;
+
+        UploadTextureMips(m_mipUploadQueue.front());
+        m_mipUploadQueue.pop_front();
+        uploads++;
+        uploadBytes += streamInBytes;
+    }
+
+    m_lastUpdateStats.m_uploadsLastUpdate = uploads;
+    m_lastUpdateStats.m_uploadBytesLastUpdate = uploadBytes;
+    m_lastUpdateStats.m_uploadMillisecondsLastUpdate = (GetCurrentTimeSeconds() - uploadStart) * 1000.0;
+
+    // 上传腾出了 slot
+    StartQueuedLoads();
+}
+
+void AssetStreamer::Finish(AssetHandle* handle)
+{
+    if (!handle)
+        return;
+
+    while (!handle->IsDone())
+    {
+        PumpCompletedJobs();
+
+        // 还在排队的直接开始，不占 slot 上限
+        auto queued = std::find(m_queued.begin(), m_queued.end(), handle);
+        if (queued != m_queued.end())
+        {
+            m_queued.erase(queued);
+            m_inFlightCount++;
+            Dispatch(handle, AssetLoadState::READING);
+        }
+
+        auto waiting = std::find(m_uploadQueue.begin(), m_uploadQueue.end(), handle);
+        if (waiting != m_uploadQueue.end())
+        {
+            m_uploadQueue.erase(waiting);
+            Upload(handle);
+        }
+
+        if (!handle->IsDone())
+            std::this_thread::yield();
+    }
+}
+
+void AssetStreamer::FinishAll()
+{
+    while (!IsIdle())
+    {
+        PumpCompletedJobs();
+        StartQueuedLoads();
+        while (!m_uploadQueue.empty())
+        {
+            AssetHandle* handle = m_uploadQueue.front();
+            m_uploadQueue.pop_front();
+            Upload(handle);
+        }
+        if (!IsIdle())
+            std::this_thread::yield();
+    }
+}
+
+AssetStreamerStats AssetStreamer::GetStats() const
+{
+    AssetStreamerStats stats = m_lastUpdateStats;
+    stats.m_queued = (uint32_t)m_queued.size();
+    stats.m_inFlight = (uint32_t)m_inFlightCount;
+    stats.m_waitingForUpload = (uint32_t)m_uploadQueue.size();
+    stats.m_ready = 0;
+    stats.m_failed = 0;
+    for (auto const& [name, handle] : m_meshes)
+    {
+        stats.m_ready += handle->IsReady() ? 1 : 0;
+        stats.m_failed += handle->IsFailed() ? 1 : 0;
+    }
+    for (auto const& [path, handle] : m_textures)
+    {
+        stats.m_ready += handle->IsReady() ? 1 : 0;
+        stats.m_failed += handle->IsFailed() ? 1 : 0;
+    }
+    return stats;
+}
+
+void AssetStreamer::NoteTextureUse(TextureHandle* handle, float screenTexels)
+{
+    if (handle && handle->m_residencyId != INVALID_TEXTURE_PATH_ID)
+        m_textureResidency.NoteUse(handle->m_residencyId, screenTexels);
+}
+
+void AssetStreamer::NoteMeshUse(StaticMesh const* mesh, float screenPixels)
+{
+    auto found = m_meshHandles.find(mesh);
+    if (found == m_meshHandles.end())
+        return;
+    for (TextureHandle* texture : found->second->m_materialTextures)
+        NoteTextureUse(texture, screenPixels);
+}
+
+void AssetStreamer::UpdateTextureResidency()
+{
+    if (!m_config.m_enableTextureResidency)
+        return;
+
+    // drop 排在前面，当场生效；stream-in 去 IO 线程读 cook
+    std::vector<TextureResidencyRequest> requests;
+    m_textureResidency.Update(requests);
+    for (TextureResidencyRequest const& request : requests)
+    {
+        TextureHandle* handle = m_textures.at(m_textureResidency.GetPath(request.m_id)).get();
+        if (request.m_type == TextureResidencyRequestType::DROP)
+        {
+            m_config.m_renderer->DropTextureMips(handle->m_texture, request.m_toMip);
+            continue;
+        }
+
+        m_mipStreamsInFlight++;
+        TextureMipStreamJob* job = new TextureMipStreamJob(this, handle, request.m_toMip);
+        if (!g_theJobSystem || g_theJobSystem->IsQuitting() || g_theJobSystem->GetNumIOThreads() == 0)
+        {
+            job->Execute();
+            job->OnComplete();
+            delete job;
+            continue;
+        }
+        job->m_owner = this;
+        g_theJobSystem->AddPendingJob(job);
+    }
+}
+
+void AssetStreamer::OnTextureMipsRead(TextureMipStreamIn&& streamIn)
+{
+    m_mipStreamsInFlight--;
+    m_mipUploadQueue.push_back(std::move(streamIn));
+}
+
+void AssetStreamer::UploadTextureMips(TextureMipStreamIn& streamIn)
+{
+    TextureHandle* handle = streamIn.m_handle;
+    if (!streamIn.m_succeeded)
+    {
+        // cook 没了或者变了：停在现在的 level，不再交给 residency 管
+        DebuggerPrintf("[AssetStreamer] Failed to stream mip %d of %s, keeping mip %d\n",
+            streamIn.m_toMip, handle->m_path.c_str(), handle->m_texture->GetResidentMip());
+        m_textureResidency.Unregister(handle->m_residencyId);
+        handle->m_residencyId = INVALID_TEXTURE_PATH_ID;
+        return;
+    }
+
+    if (streamIn.m_blocks.IsValid())
+        m_config.m_renderer->UpdateTextureMips(handle->m_texture, streamIn.m_blocks, streamIn.m_toMip);
+    else
+        m_config.m_renderer->UpdateTextureMips(handle->m_texture, streamIn.m_mips, streamIn.m_toMip);
+    m_textureResidency.OnStreamedIn(handle->m_residencyId, streamIn.m_toMip);
+}
+
+void AssetStreamer::StartQueuedLoads()
+{
+    while (!m_queued.empty() && m_inFlightCount < m_config.m_maxLoadsInFlight)
+    {
+        AssetHandle* handle = m_queued.front();
+        m_queued.pop_front();
+        m_inFlightCount++;
+        Dispatch(handle, AssetLoadState::READING);
+    }
+}
+
+void AssetStreamer::Dispatch(AssetHandle* handle, AssetLoadState stage)
+{
+    handle->m_state = stage;
+    handle->m_stageSucceeded = false;
+
+    AssetStreamJob* job = new AssetStreamJob(this, handle, stage);
+    int threadCount = 0;
+    if (g_theJobSystem && !g_theJobSystem->IsQuitting())
+        threadCount = (job->m_jobType == JOB_TYPE_IO) ? g_theJobSystem->GetNumIOThreads() : g_theJobSystem->GetNumWorkerThreads();
+
+    if (threadCount == 0)
+    {
+        job->Execute();
+        job->OnComplete();
+        delete job;
+        return;
+    }
+    job->m_owner = this;
+    g_theJobSystem->AddPendingJob(job);
+}
+
+void AssetStreamer::OnStageComplete(AssetHandle* handle, AssetLoadState stage)
+{
+    if (!handle->m_stageSucceeded)
+    {
+        MarkDone(handle, false);
+        return;
+    }
+
+    switch (stage)
+    {
+    case AssetLoadState::READING:
+        Dispatch(handle, AssetLoadState::DECODING);
+        break;
+    case AssetLoadState::DECODING:
+        handle->m_state = AssetLoadState::UPLOADING;
+        m_uploadQueue.push_back(handle);
+        break;
+    case AssetLoadState::FINALIZING:
+        MarkDone(handle, true);
+        break;
+    default:
+        break;
+    }
+}
+
+void AssetStreamer::Upload(AssetHandle* handle)
+{
+    handle->Upload(m_config.m_renderer);
+    if (handle->HasFinalize())
+    {
+        Dispatch(handle, AssetLoadState::FINALIZING);
+        return;
+    }
+    MarkDone(handle, true);
+}
+
+void AssetStreamer::MarkDone(AssetHandle* handle, bool succeeded)
+{
+    handle->m_loadMilliseconds = (GetCurrentTimeSeconds() - handle->m_requestTime) * 1000.0;
+    handle->m_state = succeeded ? AssetLoadState::READY : AssetLoadState::FAILED;
+    m_inFlightCount--;
+
+    if (!succeeded)
+    {
+        DebuggerPrintf("[AssetStreamer] Failed to load %s, keeping the placeholder\n", handle->m_path.c_str());
+    }
+}
+
+void AssetStreamer::PumpCompletedJobs()
+{
+    if (!g_theJobSystem)
+        return;
+
+    // 只取自己派出去的 job，游戏自己的留给它的 RetrieveCompletedJobs()
+    std::vector<Job*> completedJobs = g_theJobSystem->RetrieveCompletedJobs(this);
+    for (Job* job : completedJobs)
+    {
+        job->OnComplete();
+        delete job;
+    }
+}
+
+StaticMesh* AssetStreamer::GetOrCreatePlaceholderMesh()
+{
+    if (!m_placeholderMesh && m_config.m_renderer)
+    {
+        StaticMeshGeometry cube;
+        AddVertsForIndexAABB3D(cube.m_verts, cube.m_indices, AABB3(Vec3(-0.5f, -0.5f, -0.5f), Vec3(0.5f, 0.5f, 0.5f)), Rgba8::GREY);
+        cube.m_isLoaded = true;
+        m_placeholderMesh = new StaticMesh(m_config.m_renderer, "AssetStreamer/PlaceholderCube", cube);
+    }
+    return m_placeholderMesh;
+}
+
+Texture* AssetStreamer::GetOrCreatePlaceholderTexture()
+{
+    if (!m_placeholderTexture && m_config.m_renderer)
+    {
+        Image white(IntVec2(1, 1), Rgba8::WHITE);
+        white.SetName("AssetStreamer/PlaceholderTexture");
+        m_placeholderTexture = UploadImage(m_config.m_renderer, white);
+    }
+    return m_placeholderTexture;
+}
@@ -0,0 +1,272 @@
+#pragma once
+#include "Engine/Core/BlockCompression.h"
+#include "Engine/Core/Image.hpp"
+#include "Engine/Core/ImageMipChain.h"
+#include "Engine/Core/StaticMesh.h"
+#include "Engine/Core/TextureResidency.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class AssetStreamer;
+class Renderer;
+class Texture;
+class TextureHandle;
+class TextureMipStreamJob;
+
+//==============================================================================
+// AssetStreamer - mesh / texture 异步加载：IO job 读文件，worker job 解码，主线程只上传
+//==============================================================================
+// Per request:
+//   QUEUED      waiting for a slot (AssetStreamerConfig::m_maxLoadsInFlight)
+//   READING     JOB_TYPE_IO: cooked BCn blocks (<image>.bc7.mips etc.) or mip chain
+//               (<image>.mips) or else file bytes (texture), xml + cook key + cook, material
+//               textures the same way (mesh)
+//   DECODING    JOB_TYPE_WORKER: stb decode + BuildImageMipChain (+ CompressImageMipChain) +
+//               .mips write when the cook was missing (texture and material textures),
+//               OBJ/GLB import + optimize + cook
+//               when the cook was missing, .glb images (mesh)
+//   UPLOADING   waiting in the upload queue; Update uploads at most m_maxUploadsPerFrame /
+//               m_maxUploadBytesPerFrame per frame (always at least one)
+//   FINALIZING  JOB_TYPE_WORKER: card templates (mesh only, already in the cook usually)
+//   READY / FAILED
+//
+// Handles stay valid for the streamer's lifetime; Get() returns the placeholder until the
+// asset is READY (and forever if it FAILED). Without a job system, or without threads of
+// the needed type, a stage runs inline on the calling thread.
+//
+// Jobs the streamer dispatches carry it as their Job::m_owner; Update retrieves only those
+// (JobSystem::RetrieveCompletedJobs(owner)), runs OnComplete() on the main thread and deletes
+// them. Other completed jobs stay in the JobSystem for whoever submitted them.
+//
+// With m_enableTextureResidency, textures that have a .mips cook are uploaded from their mip
+// tail only and handed to a TextureResidencyManager, and so are the cooked material textures
+// of the meshes it loads (AdoptTexture, fully resident at first). NoteTextureUse / NoteMeshUse
+// report how large they are on screen (Scene does it for every mesh it draws); Update applies
+// the manager's drops right away and streams the finer levels back in from the cook
+// (JOB_TYPE_IO, only the levels that are missing), uploading them under the same per-frame
+// budget as new assets.
+//==============================================================================
+
+enum class AssetLoadState : uint8_t
+{
+    QUEUED,
+    READING,
+    DECODING,
+    UPLOADING,
+    FINALIZING,
+    READY,
+    FAILED
+};
+
+class AssetHandle
+{
+    friend class AssetStreamer;
+    friend class AssetStreamJob;
+
+public:
+    virtual ~AssetHandle() = default;
+
+    AssetLoadState GetState() const { return m_state.load(); }
+    bool IsReady() const { return GetState() == AssetLoadState::READY; }
+    bool IsFailed() const { return GetState() == AssetLoadState::FAILED; }
+    bool IsDone() const { return IsReady() || IsFailed(); }
+    std::string const& GetPath() const { return m_path; }
+    double GetLoadMilliseconds() const { return m_loadMilliseconds; }   // request -> READY / FAILED
+
+protected:
+    // stages, see the table above. Read / Decode / Finalize run on job threads, Upload on the main thread
+    virtual bool Read() = 0;
+    virtual bool Decode() = 0;
+    virtual void Upload(Renderer* renderer) = 0;
+    virtual bool HasFinalize() const { return false; }
+    virtual void Finalize() {}
+    virtual uint64_t GetUploadBytes() const = 0;
+
+protected:
+    std::string m_path;
+    std::atomic<AssetLoadState> m_state{ AssetLoadState::QUEUED };
+    bool m_stageSucceeded = false;
+    double m_requestTime = 0.0;
+    double m_loadMilliseconds = 0.0;
+};
+
+class StaticMeshHandle : public AssetHandle
+{
+    friend class AssetStreamer;
+
+public:
+    StaticMesh* Get() const { return IsReady() ? m_mesh : m_placeholder; }
+    StaticMesh* GetLoadedMesh() const { return IsReady() ? m_mesh : nullptr; }
+    bool WasLoadedFromCook() const { return m_isFromCooked; }
+
+protected:
+    bool Read() override;
+    bool Decode() override;
+    void Upload(Renderer* renderer) override;
+    bool HasFinalize() const override { return m_enableCardTemplates; }
+    void Finalize() override;
+    uint64_t GetUploadBytes() const override;
+
+protected:
+    StaticMesh* m_mesh = nullptr;
+    StaticMesh* m_placeholder = nullptr;
+    bool m_ownsMesh = true;                 // false for AdoptMesh
+    bool m_enableCardTemplates = false;
+    bool m_isFromCooked = false;
+    StaticMeshGeometry m_geometry;          // Read / Decode -> Upload, then released
+    std::string m_sourceFilePath;           // objFile
+    std::string m_texturePaths[3];          // normalMap, diffuseMap, specGlossEmitMap
+    std::vector<uint8_t> m_textureBytes[3];
+    BlockFormat m_textureFormats[3] = {};   // normalMapCompression, textureCompression x2
+    uint64_t m_textureMipKeys[3] = {};
+    uint64_t m_textureBlockKeys[3] = {};
+    AssetStreamer* m_streamer = nullptr;
+    TextureHandle* m_materialTextures[3] = {};  // AdoptTexture'd at upload, for NoteMeshUse
+};
+
+class TextureHandle : public AssetHandle
+{
+    friend class AssetStreamer;
+    friend class TextureMipStreamJob;
+
+public:
+    Texture* Get() const { return IsReady() ? m_texture : m_placeholder; }
+    Texture* GetLoadedTexture() const { return IsReady() ? m_texture : nullptr; }
+    TexturePathId GetResidencyId() const { return m_residencyId; }    // INVALID_TEXTURE_PATH_ID unless managed
+
+protected:
+    bool Read() override;
+    bool Decode() override;
+    void Upload(Renderer* renderer) override;
+    uint64_t GetUploadBytes() const override;
+
+protected:
+    Texture* m_texture = nullptr;           // owned by the renderer, like every other texture
+    Texture* m_placeholder = nullptr;
+    std::vector<uint8_t> m_fileBytes;
+    ImageMipSettings m_mipSettings;
+    BlockFormat m_blockFormat = BlockFormat::NONE;
+    uint64_t m_mipCookKey = 0;
+    uint64_t m_blockCookKey = 0;
+    ImageMipChain m_mipChain;
+    CompressedMipChain m_blocks;            // instead of m_mipChain when m_blockFormat could be used
+    TextureResidencyManager* m_residency = nullptr;     // set when the texture will be managed
+    TexturePathId m_residencyId = INVALID_TEXTURE_PATH_ID;
+};
+
+// a texture residency stream-in: read from the cook on an IO thread, then waiting for the upload budget
+struct TextureMipStreamIn
+{
+    TextureHandle* m_handle = nullptr;
+    int m_toMip = 0;
+    bool m_succeeded = false;
+    ImageMipChain m_mips;
+    CompressedMipChain m_blocks;
+
+    uint64_t GetUploadBytes() const;
+};
+
+struct AssetStreamerConfig
+{
+    Renderer* m_renderer = nullptr;
+    int m_maxLoadsInFlight = 4;                          // READING .. FINALIZING; the rest wait in QUEUED
+    int m_maxUploadsPerFrame = 2;
+    uint64_t m_maxUploadBytesPerFrame = 16ull * 1024 * 1024;
+    bool m_enableTextureResidency = true;               // RequestTexture with a mip cook, cooked mesh material textures
+    TextureResidencyConfig m_textureResidency;
+};
+
+struct AssetStreamerStats
+{
+    uint32_t m_queued = 0;
+    uint32_t m_inFlight = 0;
+    uint32_t m_waitingForUpload = 0;
+    uint32_t m_ready = 0;
+    uint32_t m_failed = 0;
+    uint32_t m_uploadsLastUpdate = 0;
+    uint64_t m_uploadBytesLastUpdate = 0;
+    double m_uploadMillisecondsLastUpdate = 0.0;
+};
+
+class AssetStreamer
+{
+    friend class AssetStreamJob;
+    friend class StaticMeshHandle;
+    friend class TextureMipStreamJob;
+
+public:
+    explicit AssetStreamer(AssetStreamerConfig const& config);
+    ~AssetStreamer();   // waits for jobs still in flight, deletes the meshes it loaded
+
+    AssetStreamer(AssetStreamer const&) = delete;
+    AssetStreamer& operator=(AssetStreamer const&) = delete;
+
+    // same name -> same handle (the path of a second request is ignored, like MeshManager)
+    StaticMeshHandle* RequestMesh(std::string const& name, std::string const& xmlPathNoExtensions, bool enableCardTemplates = true);
+    StaticMeshHandle* FindMesh(std::string const& name) const;
+    // a mesh that was already loaded synchronously: READY handle, the caller keeps ownership
+    StaticMeshHandle* AdoptMesh(std::string const& name, StaticMesh* mesh);
+    // same path -> same handle (the settings of a second request are ignored). m_maxLevelCount = 1
+    // uploads the top level only and skips the .mips cook. format != NONE uploads BCn blocks
+    // (RGBA8 if the image is not a multiple of 4)
+    TextureHandle* RequestTexture(std::string const& imageFilePath, ImageMipSettings const& mipSettings = ImageMipSettings(),
+        BlockFormat format = BlockFormat::NONE);
+    // a texture uploaded elsewhere, fully resident, from the cook LoadCookedTextureMips finds for
+    // these settings (format = what was uploaded): READY handle, managed like a requested one.
+    // A path that already has a handle keeps it
+    TextureHandle* AdoptTexture(std::string const& imageFilePath, Texture* texture, ImageMipSettings const& mipSettings, BlockFormat format);
+
+    // main thread, once per frame
+    void Update();
+
+    // blocks until the handle is READY / FAILED, uploading without the per-frame budget (loading screens, sync callers)
+    void Finish(AssetHandle* handle);
+    void FinishAll();
+    bool IsIdle() const { return m_queued.empty() && m_inFlightCount == 0; }
+
+    AssetStreamerStats GetStats() const;
+
+    // texture residency: the texture covers about screenTexels texels across on screen this frame.
+    // Call before Update; ignored for textures that are not managed
+    void NoteTextureUse(TextureHandle* handle, float screenTexels);
+    // every material texture of a mesh this streamer loaded; screenPixels is how far the mesh
+    // spans on screen (its UVs taken to cover each texture once)
+    void NoteMeshUse(StaticMesh const* mesh, float screenPixels);
+    TextureResidencyManager const& GetTextureResidency() const { return m_textureResidency; }
+    void SetTextureBudgetBytes(uint64_t budgetBytes) { m_textureResidency.SetBudgetBytes(budgetBytes); }
+
+private:
+    void StartQueuedLoads();
+    void Dispatch(AssetHandle* handle, AssetLoadState stage);
+    void OnStageComplete(AssetHandle* handle, AssetLoadState stage);
+    void Upload(AssetHandle* handle);
+    void MarkDone(AssetHandle* handle, bool succeeded);
+    void PumpCompletedJobs();
+    void UpdateTextureResidency();
+    void OnTextureMipsRead(TextureMipStreamIn&& streamIn);
+    void UploadTextureMips(TextureMipStreamIn& streamIn);
+    StaticMesh* GetOrCreatePlaceholderMesh();
+    Texture* GetOrCreatePlaceholderTexture();
+
+private:
+    AssetStreamerConfig m_config;
+    std::unordered_map<std::string, std::unique_ptr<StaticMeshHandle>> m_meshes;   // name -> handle
+    std::unordered_map<std::string, std::unique_ptr<TextureHandle>> m_textures;    // path -> handle
+    std::unordered_map<StaticMesh const*, StaticMeshHandle*> m_meshHandles;         // uploaded meshes, for NoteMeshUse
+    std::deque<AssetHandle*> m_queued;
+    std::deque<AssetHandle*> m_uploadQueue;
+    int m_inFlightCount = 0;
+    StaticMesh* m_placeholderMesh = nullptr;
+    Texture* m_placeholderTexture = nullptr;
+    AssetStreamerStats m_lastUpdateStats;
+
+    TextureResidencyManager m_textureResidency;         // paths are the keys of m_textures
+    std::deque<TextureMipStreamIn> m_mipUploadQueue;
+    int m_mipStreamsInFlight = 0;                       // reading
+};
@@ -0,0 +1,995 @@
+#include "BlockCompression.h"
+
+#include "Engine/Core/CookedMesh.h"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Job/JobSystem.h"
+
+#ifdef ENGINE_ENABLE_SSE
+#include <xmmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr uint32_t BLOCKS_PER_BATCH = 4096;
+    constexpr int BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // SoA，一个 block 16 个 texel，0..255 的 float
+    struct BlockTexels
+    {
+        alignas(16) float m_r[16];
+        alignas(16) float m_g[16];
+        alignas(16) float m_b[16];
+        alignas(16) float m_a[16];
+    };
+
+    void FetchBlock(Rgba8 const* texels, IntVec2 const& dimensions, int blockX, int blockY, bool flipVertically, BlockTexels& out)
+    {
+        for (int y = 0; y < 4; y++)
+        {
+            int sourceY = std::min(blockY * 4 + y, dimensions.y - 1);
+            if (flipVertically)
+                sourceY = dimensions.y - 1 - sourceY;
+            Rgba8 const* row = texels + (size_t)sourceY * dimensions.x;
+            for (int x = 0; x < 4; x++)
+            {
+                Rgba8 texel = row[std::min(blockX * 4 + x, dimensions.x - 1)];
+                out.m_r[y * 4 + x] = (float)texel.r;
+                out.m_g[y * 4 + x] = (float)texel.g;
+                out.m_b[y * 4 + x] = (float)texel.b;
+                out.m_a[y * 4 + x] = (float)texel.a;
+            }
+        }
+    }
+
+#ifdef ENGINE_ENABLE_SSE
+    inline float HorizontalSum(__m128 v)
+    {
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, v);
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+#endif
+
+    struct BlockBitWriter
+    {
+        uint8_t* m_bytes = nullptr;
+        uint32_t m_bit = 0;
+
+        void Write(uint32_t value, uint32_t bitCount)
+        {
+            for (uint32_t i = 0; i < bitCount; i++, m_bit++)
+            {
+                if ((value >> i) & 1)
+                    m_bytes[m_bit >> 3] |= (uint8_t)(1 << (m_bit & 7));
+            }
+        }
+    };
+
+    struct BlockBitReader
+    {
+        uint8_t const* m_bytes = nullptr;
+        uint32_t m_bit = 0;
+
+        uint32_t Read(uint32_t bitCount)
+        {
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < bitCount; i++, m_bit++)
+            {
+                value |= (uint32_t)((m_bytes[m_bit >> 3] >> (m_bit & 7)) & 1) << i;
+            }
+            return value;
+        }
+    };
+
+    // principal axis of the block's colors (power iteration on the covariance); zero for a flat block
+    template <int CHANNELS>
+    void ComputePrincipalAxis(float const* const* channels, float* outMean, float* outAxis)
+    {
+        for (int c = 0; c < CHANNELS; c++)
+        {
+            float sum = 0.f;
+            for (int i = 0; i < 16; i++)
+                sum += channels[c][i];
+            outMean[c] = sum / 16.f;
+        }
+        float covariance[CHANNELS][CHANNELS] = {};
+        for (int i = 0; i < 16; i++)
+        {
+            for (int c0 = 0; c0 < CHANNELS; c0++)
+            {
+                for (int c1 = c0; c1 < CHANNELS; c1++)
+                    covariance[c0][c1] += (channels[c0][i] - outMean[c0]) * (channels[c1][i] - outMean[c1]);
+            }
+        }
+        int largest = 0;
+        for (int c0 = 0; c0 < CHANNELS; c0++)
+        {
+            for (int c1 = 0; c1 < c0; c1++)
+                covariance[c0][c1] = covariance[c1][c0];
+            if (covariance[c0][c0] > covariance[largest][largest])
+                largest = c0;
+        }
+
+        float axis[CHANNELS];
+        for (int c = 0; c < CHANNELS; c++)
+            axis[c] = covariance[largest][c];
+        for (int iteration = 0; iteration < 6; iteration++)
+        {
+            float next[CHANNELS] = {};
+            float length = 0.f;
+            for (int c0 = 0; c0 < CHANNELS; c0++)
+            {
+                for (int c1 = 0; c1 < CHANNELS; c1++)
+                    next[c0] += covariance[c0][c1] * axis[c1];
+                length += next[c0] * next[c0];
+            }
+            length = sqrtf(length);
+            float invLength = length > 1e-6f ? 1.f / length : 0.f;
+            for (int c = 0; c < CHANNELS; c++)
+                axis[c] = next[c] * invLength;
+        }
+        for (int c = 0; c < CHANNELS; c++)
+            outAxis[c] = axis[c];
+    }
+
+    //-------------------------------------------------------------------------------------------
+    // BC1 color block (also the color half of BC3)
+    inline int QuantizeChannel(float value, int maxValue)
+    {
+        return std::min(maxValue, std::max(0, (int)(value * (float)maxValue / 255.f + 0.5f)));
+    }
+
+    inline uint16_t PackColor565(int const* q)
+    {
+        return (uint16_t)((q[0] << 11) | (q[1] << 5) | q[2]);
+    }
+
+    inline void ExpandColor565(uint16_t color, int* outRgb)
+    {
+        int r5 = (color >> 11) & 31;
+        int g6 = (color >> 5) & 63;
+        int b5 = color & 31;
+        outRgb[0] = (r5 << 3) | (r5 >> 2);
+        outRgb[1] = (g6 << 2) | (g6 >> 4);
+        outRgb[2] = (b5 << 3) | (b5 >> 2);
+    }
+
+    // same integer rounding as DecodeColorBlock
+    int BuildColorPalette(uint16_t c0, uint16_t c1, bool fourColorOnly, int palette[4][3])
+    {
+        ExpandColor565(c0, palette[0]);
+        ExpandColor565(c1, palette[1]);
+        bool isFourColor = fourColorOnly || c0 > c1;
+        for (int c = 0; c < 3; c++)
+        {
+            if (isFourColor)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            else
+            {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+        // 3-color 模式的第 4 项是透明黑，不用
+        return isFourColor ? 4 : 3;
+    }
+
+    // SSE: 4 texels per step against every palette entry. The scalar fallback keeps the
+    // per-lane error sums, so both give the same bytes
+    float FindNearestColors(BlockTexels const& block, int const palette[4][3], int paletteCount, uint8_t* outIndices)
+    {
+#ifdef ENGINE_ENABLE_SSE
+        __m128 total = _mm_setzero_ps();
+        for (int i = 0; i < 16; i += 4)
+        {
+            __m128 r = _mm_load_ps(block.m_r + i);
+            __m128 g = _mm_load_ps(block.m_g + i);
+            __m128 b = _mm_load_ps(block.m_b + i);
+            __m128 best = _mm_set1_ps(FLT_MAX);
+            __m128 bestIndex = _mm_setzero_ps();
+            for (int p = 0; p < paletteCount; p++)
+            {
+                __m128 dr = _mm_sub_ps(r, _mm_set1_ps((float)palette[p][0]));
+                __m128 dg = _mm_sub_ps(g, _mm_set1_ps((float)palette[p][1]));
+                __m128 db = _mm_sub_ps(b, _mm_set1_ps((float)palette[p][2]));
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+                __m128 isCloser = _mm_cmplt_ps(distance, best);
+                best = _mm_min_ps(distance, best);
+                bestIndex = _mm_or_ps(_mm_and_ps(isCloser, _mm_set1_ps((float)p)), _mm_andnot_ps(isCloser, bestIndex));
+            }
+            total = _mm_add_ps(total, best);
+            alignas(16) float indices[4];
+            _mm_store_ps(indices, bestIndex);
+            for (int lane = 0; lane < 4; lane++)
+                outIndices[i + lane] = (uint8_t)indices[lane];
+        }
+        return HorizontalSum(total);
+#else
+        float laneTotals[4] = {};
+        for (int i = 0; i < 16; i++)
+        {
+            float best = FLT_MAX;
+            int bestIndex = 0;
+            for (int p = 0; p < paletteCount; p++)
+            {
+                float dr = block.m_r[i] - (float)palette[p][0];
+                float dg = block.m_g[i] - (float)palette[p][1];
+                float db = block.m_b[i] - (float)palette[p][2];
+                float distance = (dr * dr + dg * dg) + db * db;
+                if (distance < best)
+                {
+                    best = distance;
+                    bestIndex = p;
+                }
+            }
+            laneTotals[i & 3] += best;
+            outIndices[i] = (uint8_t)bestIndex;
+        }
+        return laneTotals[0] + laneTotals[1] + laneTotals[2] + laneTotals[3];
+#endif
+    }
+
+    struct ColorCandidate
+    {
+        int m_q[6] = {};                    // r5 g6 b5 of both endpoints, before ordering
+        uint16_t m_c0 = 0;
+        uint16_t m_c1 = 0;
+        uint8_t m_indices[16] = {};
+        float m_error = FLT_MAX;
+    };
+
+    void EvaluateColorCandidate(BlockTexels const& block, bool fourColorOnly, ColorCandidate& candidate)
+    {
+        candidate.m_c0 = PackColor565(candidate.m_q);
+        candidate.m_c1 = PackColor565(candidate.m_q + 3);
+        // BC1 的 4-color 模式要 c0 > c1
+        if (!fourColorOnly && candidate.m_c0 < candidate.m_c1)
+            std::swap(candidate.m_c0, candidate.m_c1);
+        int palette[4][3];
+        int paletteCount = BuildColorPalette(candidate.m_c0, candidate.m_c1, fourColorOnly, palette);
+        candidate.m_error = FindNearestColors(block, palette, paletteCount, candidate.m_indices);
+    }
+
+    void QuantizeColorEndpoints(float const* e0, float const* e1, int* outQ)
+    {
+        outQ[0] = QuantizeChannel(e0[0], 31); outQ[1] = QuantizeChannel(e0[1], 63); outQ[2] = QuantizeChannel(e0[2], 31);
+        outQ[3] = QuantizeChannel(e1[0], 31); outQ[4] = QuantizeChannel(e1[1], 63); outQ[5] = QuantizeChannel(e1[2], 31);
+    }
+
+    // endpoints that minimize the squared error for the candidate's indices; false if singular
+    bool RefineColorEndpoints(BlockTexels const& block, bool fourColorOnly, ColorCandidate const& candidate, int* outQ)
+    {
+        bool isFourColor = fourColorOnly || candidate.m_c0 > candidate.m_c1;
+        float const fourColorWeights[4] = { 1.f, 0.f, 2.f / 3.f, 1.f / 3.f };
+        float const threeColorWeights[4] = { 1.f, 0.f, 0.5f, 0.f };
+        float const* weights = isFourColor ? fourColorWeights : threeColorWeights;
+
+        float aa = 0.f, ab = 0.f, bb = 0.f;
+        float ax[3] = {}, bx[3] = {};
+        float const* channels[3] = { block.m_r, block.m_g, block.m_b };
+        for (int i = 0; i < 16; i++)
+        {
+            float a = weights[candidate.m_indices[i]];
+            float b = 1.f - a;
+            aa += a * a; ab += a * b; bb += b * b;
+            for (int c = 0; c < 3; c++)
+            {
+                ax[c] += a * channels[c][i];
+                bx[c] += b * channels[c][i];
+            }
+        }
+        float determinant = aa * bb - ab * ab;
+        if (fabsf(determinant) < 1e-6f)
+            return false;
+        float e0[3], e1[3];
+        for (int c = 0; c < 3; c++)
+        {
+            e0[c] = (bb * ax[c] - ab * bx[c]) / determinant;
+            e1[c] = (aa * bx[c] - ab * ax[c]) / determinant;
+        }
+        QuantizeColorEndpoints(e0, e1, outQ);
+        return true;
+    }
+
+    void EncodeColorBlock(BlockTexels const& block, bool fourColorOnly, bool endpointSearch, uint8_t* out)
+    {
+        float const* channels[3] = { block.m_r, block.m_g, block.m_b };
+        float mean[3], axis[3];
+        ComputePrincipalAxis<3>(channels, mean, axis);
+        float minT = FLT_MAX, maxT = -FLT_MAX;
+        for (int i = 0; i < 16; i++)
+        {
+            float t = (block.m_r[i] - mean[0]) * axis[0] + (block.m_g[i] - mean[1]) * axis[1] + (block.m_b[i] - mean[2]) * axis[2];
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+        float e0[3], e1[3];
+        for (int c = 0; c < 3; c++)
+        {
+            e0[c] = mean[c] + axis[c] * maxT;
+            e1[c] = mean[c] + axis[c] * minT;
+        }
+
+        ColorCandidate best;
+        QuantizeColorEndpoints(e0, e1, best.m_q);
+        EvaluateColorCandidate(block, fourColorOnly, best);
+
+        for (int iteration = 0; iteration < 2 && best.m_error > 0.f; iteration++)
+        {
+            ColorCandidate refined;
+            if (!RefineColorEndpoints(block, fourColorOnly, best, refined.m_q))
+                break;
+            EvaluateColorCandidate(block, fourColorOnly, refined);
+            if (refined.m_error >= best.m_error)
+                break;
+            best = refined;
+        }
+
+        // 每个 565 分量 +-1，变好就留下
+        if (endpointSearch)
+        {
+            int const maxValues[6] = { 31, 63, 31, 31, 63, 31 };
+            for (int component = 0; component < 6 && best.m_error > 0.f; component++)
+            {
+                for (int delta = -1; delta <= 1; delta += 2)
+                {
+                    ColorCandidate trial = best;
+                    trial.m_q[component] += delta;
+                    if (trial.m_q[component] < 0 || trial.m_q[component] > maxValues[component])
+                        continue;
+                    EvaluateColorCandidate(block, fourColorOnly, trial);
+                    if (trial.m_error < best.m_error)
+                        best = trial;
+                }
+            }
+        }
+
+        out[0] = (uint8_t)(best.m_c0 & 0xFF);
+        out[1] = (uint8_t)(best.m_c0 >> 8);
+        out[2] = (uint8_t)(best.m_c1 & 0xFF);
+        out[3] = (uint8_t)(best.m_c1 >> 8);
+        uint32_t indexBits = 0;
+        for (int i = 0; i < 16; i++)
+            indexBits |= (uint32_t)best.m_indices[i] << (i * 2);
+        memcpy(out + 4, &indexBits, 4);
+    }
+
+    void DecodeColorBlock(uint8_t const* block, bool fourColorOnly, Rgba8* outTexels)
+    {
+        uint16_t c0 = (uint16_t)(block[0] | (block[1] << 8));
+        uint16_t c1 = (uint16_t)(block[2] | (block[3] << 8));
+        int palette[4][3];
+        int paletteCount = BuildColorPalette(c0, c1, fourColorOnly, palette);
+        uint32_t indexBits;
+        memcpy(&indexBits, block + 4, 4);
+        for (int i = 0; i < 16; i++)
+        {
+            int index = (indexBits >> (i * 2)) & 3;
+            unsigned char alpha = (paletteCount == 3 && index == 3) ? 0 : 255;
+            outTexels[i] = Rgba8((unsigned char)palette[index][0], (unsigned char)palette[index][1], (unsigned char)palette[index][2], alpha);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------
+    // BC4 single channel block (BC3 alpha, BC5 r / g)
+    void BuildBC4Palette(int a0, int a1, int palette[8])
+    {
+        palette[0] = a0;
+        palette[1] = a1;
+        if (a0 > a1)
+        {
+            for (int i = 1; i <= 6; i++)
+                palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+        }
+        else
+        {
+            for (int i = 1; i <= 4; i++)
+                palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+    }
+
+    void EncodeBC4Block(float const* values, uint8_t* out)
+    {
+        float minValue = 255.f, maxValue = 0.f;
+        for (int i = 0; i < 16; i++)
+        {
+            minValue = std::min(minValue, values[i]);
+            maxValue = std::max(maxValue, values[i]);
+        }
+        int a0 = (int)(maxValue + 0.5f);
+        int a1 = (int)(minValue + 0.5f);
+        out[0] = (uint8_t)a0;
+        out[1] = (uint8_t)a1;
+        memset(out + 2, 0, 6);
+        if (a0 == a1)
+            return;
+
+        int palette[8];
+        BuildBC4Palette(a0, a1, palette);
+        uint64_t indexBits = 0;
+#ifdef ENGINE_ENABLE_SSE
+        for (int i = 0; i < 16; i += 4)
+        {
+            __m128 v = _mm_loadu_ps(values + i);
+            __m128 best = _mm_set1_ps(FLT_MAX);
+            __m128 bestIndex = _mm_setzero_ps();
+            for (int p = 0; p < 8; p++)
+            {
+                __m128 d = _mm_sub_ps(v, _mm_set1_ps((float)palette[p]));
+                d = _mm_mul_ps(d, d);
+                __m128 isCloser = _mm_cmplt_ps(d, best);
+                best = _mm_min_ps(d, best);
+                bestIndex = _mm_or_ps(_mm_and_ps(isCloser, _mm_set1_ps((float)p)), _mm_andnot_ps(isCloser, bestIndex));
+            }
+            alignas(16) float indices[4];
+            _mm_store_ps(indices, bestIndex);
+            for (int lane = 0; lane < 4; lane++)
+                indexBits |= (uint64_t)indices[lane] << ((i + lane) * 3);
+        }
+#else
+        for (int i = 0; i < 16; i++)
+        {
+            float best = FLT_MAX;
+            int bestIndex = 0;
+            for (int p = 0; p < 8; p++)
+            {
+                float d = values[i] - (float)palette[p];
+                d = d * d;
+                if (d < best)
+                {
+                    best = d;
+                    bestIndex = p;
+                }
+            }
+            indexBits |= (uint64_t)bestIndex << (i * 3);
+        }
+#endif
+        for (int b = 0; b < 6; b++)
+            out[2 + b] = (uint8_t)(indexBits >> (b * 8));
+    }
+
+    void DecodeBC4Block(uint8_t const* block, uint8_t* outValues)
+    {
+        int palette[8];
+        BuildBC4Palette(block[0], block[1], palette);
+        uint64_t indexBits = 0;
+        for (int b = 0; b < 6; b++)
+            indexBits |= (uint64_t)block[2 + b] << (b * 8);
+        for (int i = 0; i < 16; i++)
+            outValues[i] = (uint8_t)palette[(indexBits >> (i * 3)) & 7];
+    }
+
+    //-------------------------------------------------------------------------------------------
+    // BC7 mode 6
+    struct BC7Candidate
+    {
+        int m_q[2][4] = {};                 // 7-bit endpoints
+        int m_p[2] = {};                    // p-bits
+        uint8_t m_indices[16] = {};
+        float m_error = FLT_MAX;
+    };
+
+    // 7 bits + p-bit per endpoint; the p-bit shared by all four channels, picked per endpoint
+    void QuantizeBC7Endpoint(float const* endpoint, int* outQ, int& outP)
+    {
+        float bestError = FLT_MAX;
+        for (int p = 0; p < 2; p++)
+        {
+            int q[4];
+            float error = 0.f;
+            for (int c = 0; c < 4; c++)
+            {
+                q[c] = std::min(127, std::max(0, (int)((endpoint[c] - (float)p) * 0.5f + 0.5f)));
+                float d = (float)((q[c] << 1) | p) - endpoint[c];
+                error += d * d;
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                outP = p;
+                memcpy(outQ, q, sizeof(q));
+            }
+        }
+    }
+
+    void EvaluateBC7Candidate(BlockTexels const& block, BC7Candidate& candidate)
+    {
+        int e[2][4];
+        for (int s = 0; s < 2; s++)
+        {
+            for (int c = 0; c < 4; c++)
+                e[s][c] = (candidate.m_q[s][c] << 1) | candidate.m_p[s];
+        }
+        float palette[16][4];
+        for (int i = 0; i < 16; i++)
+        {
+            for (int c = 0; c < 4; c++)
+                palette[i][c] = (float)(((64 - BC7_WEIGHTS4[i]) * e[0][c] + BC7_WEIGHTS4[i] * e[1][c] + 32) >> 6);
+        }
+
+#ifdef ENGINE_ENABLE_SSE
+        __m128 total = _mm_setzero_ps();
+        for (int i = 0; i < 16; i += 4)
+        {
+            __m128 r = _mm_load_ps(block.m_r + i);
+            __m128 g = _mm_load_ps(block.m_g + i);
+            __m128 b = _mm_load_ps(block.m_b + i);
+            __m128 a = _mm_load_ps(block.m_a + i);
+            __m128 best = _mm_set1_ps(FLT_MAX);
+            __m128 bestIndex = _mm_setzero_ps();
+            for (int p = 0; p < 16; p++)
+            {
+                __m128 dr = _mm_sub_ps(r, _mm_set1_ps(palette[p][0]));
+                __m128 dg = _mm_sub_ps(g, _mm_set1_ps(palette[p][1]));
+                __m128 db = _mm_sub_ps(b, _mm_set1_ps(palette[p][2]));
+                __m128 da = _mm_sub_ps(a, _mm_set1_ps(palette[p][3]));
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_add_ps(_mm_mul_ps(db, db), _mm_mul_ps(da, da)));
+                __m128 isCloser = _mm_cmplt_ps(distance, best);
+                best = _mm_min_ps(distance, best);
+                bestIndex = _mm_or_ps(_mm_and_ps(isCloser, _mm_set1_ps((float)p)), _mm_andnot_ps(isCloser, bestIndex));
+            }
+            total = _mm_add_ps(total, best);
+            alignas(16) float indices[4];
+            _mm_store_ps(indices, bestIndex);
+            for (int lane = 0; lane < 4; lane++)
+                candidate.m_indices[i + lane] = (uint8_t)indices[lane];
+        }
+        candidate.m_error = HorizontalSum(total);
+#else
+        float laneTotals[4] = {};
+        for (int i = 0; i < 16; i++)
+        {
+            float best = FLT_MAX;
+            int bestIndex = 0;
+            for (int p = 0; p < 16; p++)
+            {
+                float dr = block.m_r[i] - palette[p][0];
+                float dg = block.m_g[i] - palette[p][1];
+                float db = block.m_b[i] - palette[p][2];
+                float da = block.m_a[i] - palette[p][3];
+                float distance = (dr * dr + dg * dg) + (db * db + da * da);
+                if (distance < best)
+                {
+                    best = distance;
+                    bestIndex = p;
+                }
+            }
+            laneTotals[i & 3] += best;
+            candidate.m_indices[i] = (uint8_t)bestIndex;
+        }
+        candidate.m_error = laneTotals[0] + laneTotals[1] + laneTotals[2] + laneTotals[3];
+#endif
+    }
+
+    void EncodeBC7Mode6Block(BlockTexels const& block, uint8_t* out)
+    {
+        float const* channels[4] = { block.m_r, block.m_g, block.m_b, block.m_a };
+        float mean[4], axis[4];
+        ComputePrincipalAxis<4>(channels, mean, axis);
+        float minT = FLT_MAX, maxT = -FLT_MAX;
+        for (int i = 0; i < 16; i++)
+        {
+            float t = 0.f;
+            for (int c = 0; c < 4; c++)
+                t += (channels[c][i] - mean[c]) * axis[c];
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+        float e0[4], e1[4];
+        for (int c = 0; c < 4; c++)
+        {
+            e0[c] = std::min(255.f, std::max(0.f, mean[c] + axis[c] * minT));
+            e1[c] = std::min(255.f, std::max(0.f, mean[c] + axis[c] * maxT));
+        }
+
+        BC7Candidate best;
+        QuantizeBC7Endpoint(e0, best.m_q[0], best.m_p[0]);
+        QuantizeBC7Endpoint(e1, best.m_q[1], best.m_p[1]);
+        EvaluateBC7Candidate(block, best);
+
+        // least squares 一次
+        if (best.m_error > 0.f)
+        {
+            float aa = 0.f, ab = 0.f, bb = 0.f;
+            float ax[4] = {}, bx[4] = {};
+            for (int i = 0; i < 16; i++)
+            {
+                float b = (float)BC7_WEIGHTS4[best.m_indices[i]] / 64.f;
+                float a = 1.f - b;
+                aa += a * a; ab += a * b; bb += b * b;
+                for (int c = 0; c < 4; c++)
+                {
+                    ax[c] += a * channels[c][i];
+                    bx[c] += b * channels[c][i];
+                }
+            }
+            float determinant = aa * bb - ab * ab;
+            if (fabsf(determinant) > 1e-6f)
+            {
+                for (int c = 0; c < 4; c++)
+                {
+                    e0[c] = std::min(255.f, std::max(0.f, (bb * ax[c] - ab * bx[c]) / determinant));
+                    e1[c] = std::min(255.f, std::max(0.f, (aa * bx[c] - ab * ax[c]) / determinant));
+                }
+                BC7Candidate refined;
+                QuantizeBC7Endpoint(e0, refined.m_q[0], refined.m_p[0]);
+                QuantizeBC7Endpoint(e1, refined.m_q[1], refined.m_p[1]);
+                EvaluateBC7Candidate(block, refined);
+                if (refined.m_error < best.m_error)
+                    best = refined;
+            }
+        }
+
+        // anchor（texel 0）的 index 最高位必须是 0，不是就交换端点
+        if (best.m_indices[0] & 8)
+        {
+            std::swap(best.m_q[0], best.m_q[1]);
+            std::swap(best.m_p[0], best.m_p[1]);
+            for (int i = 0; i < 16; i++)
+                best.m_indices[i] = (uint8_t)(15 - best.m_indices[i]);
+        }
+
+        memset(out, 0, 16);
+        BlockBitWriter writer;
+        writer.m_bytes = out;
+        writer.Write(1 << 6, 7);
+        for (int c = 0; c < 4; c++)
+        {
+            writer.Write((uint32_t)best.m_q[0][c], 7);
+            writer.Write((uint32_t)best.m_q[1][c], 7);
+        }
+        writer.Write((uint32_t)best.m_p[0], 1);
+        writer.Write((uint32_t)best.m_p[1], 1);
+        writer.Write(best.m_indices[0], 3);
+        for (int i = 1; i < 16; i++)
+            writer.Write(best.m_indices[i], 4);
+    }
+
+    void DecodeBC7Block(uint8_t const* block, Rgba8* outTexels)
+    {
+        if ((block[0] & 0x7F) != 0x40)
+        {
+            for (int i = 0; i < 16; i++)
+                outTexels[i] = Rgba8::MAGENTA;
+            return;
+        }
+
+        BlockBitReader reader;
+        reader.m_bytes = block;
+        reader.Read(7);
+        int q[2][4];
+        for (int c = 0; c < 4; c++)
+        {
+            q[0][c] = (int)reader.Read(7);
+            q[1][c] = (int)reader.Read(7);
+        }
+        int p0 = (int)reader.Read(1);
+        int p1 = (int)reader.Read(1);
+        int e[2][4];
+        for (int c = 0; c < 4; c++)
+        {
+            e[0][c] = (q[0][c] << 1) | p0;
+            e[1][c] = (q[1][c] << 1) | p1;
+        }
+        for (int i = 0; i < 16; i++)
+        {
+            int weight = BC7_WEIGHTS4[reader.Read(i == 0 ? 3 : 4)];
+            int value[4];
+            for (int c = 0; c < 4; c++)
+                value[c] = ((64 - weight) * e[0][c] + weight * e[1][c] + 32) >> 6;
+            outTexels[i] = Rgba8((unsigned char)value[0], (unsigned char)value[1], (unsigned char)value[2], (unsigned char)value[3]);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------
+    void EncodeBlock(BlockTexels const& block, BlockFormat format, bool endpointSearch, uint8_t* out)
+    {
+        switch (format)
+        {
+        case BlockFormat::BC1:
+            EncodeColorBlock(block, false, endpointSearch, out);
+            break;
+        case BlockFormat::BC3:
+            EncodeBC4Block(block.m_a, out);
+            EncodeColorBlock(block, true, endpointSearch, out + 8);
+            break;
+        case BlockFormat::BC4:
+            EncodeBC4Block(block.m_r, out);
+            break;
+        case BlockFormat::BC5:
+            EncodeBC4Block(block.m_r, out);
+            EncodeBC4Block(block.m_g, out + 8);
+            break;
+        case BlockFormat::BC7:
+            EncodeBC7Mode6Block(block, out);
+            break;
+        default:
+            break;
+        }
+    }
+
+    void DecodeBlock(uint8_t const* block, BlockFormat format, Rgba8* outTexels)
+    {
+        uint8_t values[16];
+        uint8_t secondValues[16];
+        switch (format)
+        {
+        case BlockFormat::BC1:
+            DecodeColorBlock(block, false, outTexels);
+            break;
+        case BlockFormat::BC3:
+            DecodeColorBlock(block + 8, true, outTexels);
+            DecodeBC4Block(block, values);
+            for (int i = 0; i < 16; i++)
+                outTexels[i].a = values[i];
+            break;
+        case BlockFormat::BC4:
+            DecodeBC4Block(block, values);
+            for (int i = 0; i < 16; i++)
+                outTexels[i] = Rgba8(values[i], values[i], values[i], 255);
+            break;
+        case BlockFormat::BC5:
+            DecodeBC4Block(block, values);
+            DecodeBC4Block(block + 8, secondValues);
+            for (int i = 0; i < 16; i++)
+                outTexels[i] = Rgba8(values[i], secondValues[i], 0, 255);
+            break;
+        case BlockFormat::BC7:
+            DecodeBC7Block(block, outTexels);
+            break;
+        default:
+            break;
+        }
+    }
+
+    int GetBlockCount(int size)
+    {
+        return (size + 3) / 4;
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+BlockFormat ParseBlockFormat(std::string const& text)
+{
+    for (uint32_t format = (uint32_t)BlockFormat::BC1; format <= (uint32_t)BlockFormat::BC7; format++)
+    {
+        char const* name = GetBlockFormatName((BlockFormat)format);
+        if (text.size() == strlen(name) && std::equal(text.begin(), text.end(), name, [](char a, char b) { return tolower(a) == tolower(b); }))
+            return (BlockFormat)format;
+    }
+    return BlockFormat::NONE;
+}
+
+char const* GetBlockFormatName(BlockFormat format)
+{
+    switch (format)
+    {
+    case BlockFormat::BC1: return "BC1";
+    case BlockFormat::BC3: return "BC3";
+    case BlockFormat::BC4: return "BC4";
+    case BlockFormat::BC5: return "BC5";
+    case BlockFormat::BC7: return "BC7";
+    default: return "RGBA8";
+    }
+}
+
+uint32_t GetBlockBytes(BlockFormat format)
+{
+    switch (format)
+    {
+    case BlockFormat::BC1:
+    case BlockFormat::BC4:
+        return 8;
+    case BlockFormat::BC3:
+    case BlockFormat::BC5:
+    case BlockFormat::BC7:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+uint32_t GetBlockRowPitch(BlockFormat format, int width)
+{
+    return (uint32_t)GetBlockCount(width) * GetBlockBytes(format);
+}
+
+uint64_t GetCompressedLevelBytes(BlockFormat format, IntVec2 const& dimensions)
+{
+    return (uint64_t)GetBlockCount(dimensions.x) * (uint64_t)GetBlockCount(dimensions.y) * GetBlockBytes(format);
+}
+
+void EncodeBlocks(Rgba8 const* texels, IntVec2 const& dimensions, BlockFormat format, std::vector<uint8_t>& out, BlockCompressionSettings const& settings)
+{
+    uint32_t blockBytes = GetBlockBytes(format);
+    int blocksWide = GetBlockCount(dimensions.x);
+    int blocksHigh = GetBlockCount(dimensions.y);
+    out.assign((size_t)blocksWide * blocksHigh * blockBytes, 0);
+    if (blockBytes == 0 || blocksWide == 0 || blocksHigh == 0)
+        return;
+
+    uint32_t rowsPerBatch = std::max(1u, BLOCKS_PER_BATCH / (uint32_t)blocksWide);
+    ParallelFor((uint32_t)blocksHigh, rowsPerBatch, [&](uint32_t beginRow, uint32_t endRow)
+    {
+        BlockTexels block;
+        for (uint32_t by = beginRow; by < endRow; by++)
+        {
+            for (int bx = 0; bx < blocksWide; bx++)
+            {
+                FetchBlock(texels, dimensions, bx, (int)by, settings.m_flipVertically, block);
+                EncodeBlock(block, format, settings.m_endpointSearch, &out[((size_t)by * blocksWide + bx) * blockBytes]);
+            }
+        }
+    });
+}
+
+void DecodeBlocks(uint8_t const* blocks, IntVec2 const& dimensions, BlockFormat format, std::vector<Rgba8>& out, bool flipVertically)
+{
+    uint32_t blockBytes = GetBlockBytes(format);
+    int blocksWide = GetBlockCount(dimensions.x);
+    int blocksHigh = GetBlockCount(dimensions.y);
+    out.assign((size_t)dimensions.x * dimensions.y, Rgba8());
+    if (blockBytes == 0)
+        return;
+
+    ParallelFor((uint32_t)blocksHigh, std::max(1u, BLOCKS_PER_BATCH / (uint32_t)std::max(1, blocksWide)), [&](uint32_t beginRow, uint32_t endRow)
+    {
+        Rgba8 decoded[16];
+        for (uint32_t by = beginRow; by < endRow; by++)
+        {
+            for (int bx = 0; bx < blocksWide; bx++)
+            {
+                DecodeBlock(blocks + ((size_t)by * blocksWide + bx) * blockBytes, format, decoded);
+                for (int y = 0; y < 4; y++)
+                {
+                    int texelY = (int)by * 4 + y;
+                    if (texelY >= dimensions.y)
+                        break;
+                    int outY = flipVertically ? dimensions.y - 1 - texelY : texelY;
+                    for (int x = 0; x < 4 && bx * 4 + x < dimensions.x; x++)
+                        out[(size_t)outY * dimensions.x + bx * 4 + x] = decoded[y * 4 + x];
+                }
+            }
+        }
+    });
+}
+
+float ComputeBlockPSNR(Rgba8 const* original, Rgba8 const* decoded, uint64_t texelCount, BlockFormat format)
+{
+    int channelCount = 4;
+    if (format == BlockFormat::BC1)
+        channelCount = 3;
+    else if (format == BlockFormat::BC4)
+        channelCount = 1;
+    else if (format == BlockFormat::BC5)
+        channelCount = 2;
+
+    double squaredError = 0.0;
+    for (uint64_t i = 0; i < texelCount; i++)
+    {
+        unsigned char const* a = &original[i].r;
+        unsigned char const* b = &decoded[i].r;
+        for (int c = 0; c < channelCount; c++)
+        {
+            double d = (double)a[c] - (double)b[c];
+            squaredError += d * d;
+        }
+    }
+    if (texelCount == 0 || squaredError <= 0.0)
+        return 99.f;
+    double meanSquaredError = squaredError / ((double)texelCount * channelCount);
+    return (float)(10.0 * log10(255.0 * 255.0 / meanSquaredError));
+}
+
+bool CompressImageMipChain(ImageMipChain const& chain, BlockFormat format, CompressedMipChain& out, BlockCompressionSettings const& settings, BlockCompressionStats* outStats)
+{
+    double startTime = GetCurrentTimeSeconds();
+    BlockCompressionStats stats;
+    out = CompressedMipChain();
+    if (!chain.IsValid() || format == BlockFormat::NONE || chain.GetDimensions(0).x % 4 != 0 || chain.GetDimensions(0).y % 4 != 0)
+    {
+        if (outStats)
+            *outStats = stats;
+        return false;
+    }
+
+    out.m_name = chain.m_name;
+    out.m_format = format;
+    std::vector<uint8_t> levelBytes;
+    for (int level = 0; level < chain.GetLevelCount(); level++)
+    {
+        IntVec2 dimensions = chain.GetDimensions(level);
+        EncodeBlocks(chain.GetLevelTexels(level), dimensions, format, levelBytes, settings);
+
+        CompressedMipLevel compressedLevel;
+        compressedLevel.m_dimensions = dimensions;
+        compressedLevel.m_firstByte = out.m_bytes.size();
+        compressedLevel.m_byteCount = levelBytes.size();
+        out.m_levels.push_back(compressedLevel);
+        out.m_bytes.insert(out.m_bytes.end(), levelBytes.begin(), levelBytes.end());
+        stats.m_blockCount += levelBytes.size() / GetBlockBytes(format);
+    }
+    stats.m_uncompressedBytes = chain.GetTotalBytes();
+    stats.m_compressedBytes = out.GetTotalBytes();
+    stats.m_encodeMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+
+    if (settings.m_measurePSNR)
+    {
+        std::vector<Rgba8> decoded;
+        IntVec2 dimensions = chain.GetDimensions(0);
+        DecodeBlocks(out.GetLevelBytes(0), dimensions, format, decoded, settings.m_flipVertically);
+        stats.m_topLevelPSNR = ComputeBlockPSNR(chain.GetLevelTexels(0), decoded.data(), decoded.size(), format);
+    }
+    if (outStats)
+        *outStats = stats;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+std::string GetCompressedMipCookPath(std::string const& imageFilePath, BlockFormat format)
+{
+    std::string name = GetBlockFormatName(format);
+    std::transform(name.begin(), name.end(), name.begin(), [](char c) { return (char)tolower(c); });
+    return imageFilePath + "." + name + ".mips";
+}
+
+uint64_t SaveCookedCompressedMipChain(std::string const& path, uint64_t cookKey, CompressedMipChain const& chain)
+{
+    CookedMeshWriter writer;
+    writer.AddSingle(CookedMeshSection::BLOCK_MIP_FORMAT, (uint32_t)chain.m_format);
+    writer.AddSection(CookedMeshSection::BLOCK_MIP_LEVELS, chain.m_levels);
+    writer.AddSection(CookedMeshSection::BLOCK_MIP_DATA, chain.m_bytes);
+    return writer.Save(path, cookKey);
+}
+
+bool LoadCookedCompressedMipChain(std::string const& path, uint64_t cookKey, CompressedMipChain& out, int firstLevel)
+{
+    CookedMeshFile file;
+    if (!file.Open(path, cookKey))
+        return false;
+
+    uint64_t count = 0;
+    uint32_t const* format = file.GetSection<uint32_t>(CookedMeshSection::BLOCK_MIP_FORMAT, count);
+    if (!format || count != 1 || GetBlockBytes((BlockFormat)*format) == 0)
+        return false;
+
+    CompressedMipChain chain;
+    chain.m_format = (BlockFormat)*format;
+    uint64_t byteCount = 0;
+    uint8_t const* bytes = file.GetSection<uint8_t>(CookedMeshSection::BLOCK_MIP_DATA, byteCount);
+    if (!file.CopySection(CookedMeshSection::BLOCK_MIP_LEVELS, chain.m_levels) || !bytes || chain.m_levels.empty() ||
+        firstLevel < 0 || firstLevel >= chain.GetLevelCount())
+        return false;
+
+    // 每级的字节数和位置都要对得上，不然当坏文件
+    uint64_t expectedFirstByte = 0;
+    for (CompressedMipLevel const& level : chain.m_levels)
+    {
+        if (level.m_firstByte != expectedFirstByte || level.m_byteCount != GetCompressedLevelBytes(chain.m_format, level.m_dimensions))
+            return false;
+        expectedFirstByte += level.m_byteCount;
+    }
+    if (expectedFirstByte != byteCount)
+        return false;
+
+    // 只拷要的 level，前面的页根本不会被读进来
+    uint64_t baseByte = chain.m_levels[firstLevel].m_firstByte;
+    chain.m_bytes.assign(bytes + baseByte, bytes + byteCount);
+    for (int level = 0; level < chain.GetLevelCount(); level++)
+        chain.m_levels[level].m_firstByte = level < firstLevel ? 0 : chain.m_levels[level].m_firstByte - baseByte;
+    chain.m_firstLoadedLevel = firstLevel;
+    chain.m_name = out.m_name;
+    out = std::move(chain);
+    return true;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include "Engine/Core/ImageMipChain.h"
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Math/IntVec2.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//==============================================================================
+// BlockCompression - CPU BCn encoder / decoder for cooked textures (4x4 blocks)
+//==============================================================================
+//   BC1   rgb, 8 bytes      PCA endpoints -> least-squares refine -> +-1 greedy search on
+//                           the 565 endpoints; every candidate is scored with SSE (4 texels
+//                           x 4 palette entries per step). Alpha is dropped
+//   BC3   rgba, 16 bytes    BC4-style alpha block + BC1 color block (always 4-color mode)
+//   BC4   r, 8 bytes        min / max endpoints, 8-value mode
+//   BC5   rg, 16 bytes      two BC4 blocks (tangent-space normal maps; z is reconstructed)
+//   BC7   rgba, 16 bytes    fast preset: mode 6 only (one subset, 7.7.7.7 + p-bit endpoints,
+//                           4-bit indices), PCA endpoints + one least-squares refine
+//
+// Encoding runs ParallelFor over rows of blocks. The decoder covers everything the encoder
+// writes (BC7: mode 6 only, other modes decode as magenta) and is what PSNR is measured with.
+// D3D wants the top level of a BC texture to be a multiple of 4 in both directions;
+// CompressImageMipChain refuses anything else and the caller keeps the RGBA8 chain.
+//==============================================================================
+
+enum class BlockFormat : uint32_t
+{
+    NONE,           // RGBA8, uncompressed
+    BC1,
+    BC3,
+    BC4,
+    BC5,
+    BC7
+};
+
+struct BlockCompressionSettings
+{
+    bool m_flipVertically = false;          // encode bottom row first (DX12 flips RGBA8 at upload, blocks can't be)
+    bool m_endpointSearch = true;           // BC1 / BC3: +-1 search after the refine
+    bool m_measurePSNR = false;             // decode the top level again and compare
+};
+
+struct BlockCompressionStats
+{
+    uint64_t m_blockCount = 0;
+    uint64_t m_uncompressedBytes = 0;
+    uint64_t m_compressedBytes = 0;
+    float m_topLevelPSNR = 0.f;             // dB over the format's channels, only with m_measurePSNR
+    double m_encodeMilliseconds = 0.0;
+};
+
+struct CompressedMipLevel
+{
+    IntVec2 m_dimensions;
+    uint64_t m_firstByte = 0;               // into CompressedMipChain::m_bytes
+    uint64_t m_byteCount = 0;
+};
+
+struct CompressedMipChain
+{
+    std::string m_name;
+    BlockFormat m_format = BlockFormat::NONE;
+    std::vector<CompressedMipLevel> m_levels;
+    std::vector<uint8_t> m_bytes;
+    int m_firstLoadedLevel = 0;             // levels before it have dimensions but no bytes (partial cook read)
+
+    bool IsValid() const { return m_format != BlockFormat::NONE && !m_levels.empty(); }
+    int GetLevelCount() const { return (int)m_levels.size(); }
+    IntVec2 GetDimensions(int level = 0) const { return m_levels[level].m_dimensions; }
+    uint8_t const* GetLevelBytes(int level) const { return m_bytes.data() + m_levels[level].m_firstByte; }
+    uint64_t GetTotalBytes() const { return m_bytes.size(); }
+};
+
+// "bc1" / "bc3" / "bc4" / "bc5" / "bc7", anything else is NONE
+BlockFormat ParseBlockFormat(std::string const& text);
+char const* GetBlockFormatName(BlockFormat format);
+uint32_t GetBlockBytes(BlockFormat format);
+uint32_t GetBlockRowPitch(BlockFormat format, int width);
+uint64_t GetCompressedLevelBytes(BlockFormat format, IntVec2 const& dimensions);
+
+// out gets ceil(w / 4) * ceil(h / 4) blocks; texels past the edge repeat the last row / column
+void EncodeBlocks(Rgba8 const* texels, IntVec2 const& dimensions, BlockFormat format, std::vector<uint8_t>& out, BlockCompressionSettings const& settings = BlockCompressionSettings());
+// the inverse, including the flip; channels a format doesn't store decode as BC1 alpha = 255, BC4 g = b = r, BC5 b = 0
+void DecodeBlocks(uint8_t const* blocks, IntVec2 const& dimensions, BlockFormat format, std::vector<Rgba8>& out, bool flipVertically = false);
+// over the channels the format stores (BC1: rgb, BC4: r, BC5: rg, BC3 / BC7: rgba); 99 dB when identical
+float ComputeBlockPSNR(Rgba8 const* original, Rgba8 const* decoded, uint64_t texelCount, BlockFormat format);
+
+// false (out left empty) if the top level is not a multiple of 4
+bool CompressImageMipChain(ImageMipChain const& chain, BlockFormat format, CompressedMipChain& out,
+    BlockCompressionSettings const& settings = BlockCompressionSettings(), BlockCompressionStats* outStats = nullptr);
+
+// <image>.bc7.mips etc., next to the RGBA8 .mips so both can be cooked at once
+std::string GetCompressedMipCookPath(std::string const& imageFilePath, BlockFormat format);
+uint64_t SaveCookedCompressedMipChain(std::string const& path, uint64_t cookKey, CompressedMipChain const& chain);
+// firstLevel > 0 copies only levels firstLevel.. out of the mapping (texture residency stream-in)
+bool LoadCookedCompressedMipChain(std::string const& path, uint64_t cookKey, CompressedMipChain& out, int firstLevel = 0);
@@ -0,0 +1,24 @@
+#pragma once
+#include "Engine/Core/BlockCompression.h"
+
+#include <dxgiformat.h>
+
+//==============================================================================
+// BlockFormat -> DXGI_FORMAT, shared by DX11Renderer and DX12Renderer
+//==============================================================================
+// Kept out of BlockCompression.h so the cook (and Linux builds) never see DXGI.
+// NONE has no block format: RGBA8 chains are created through the Image paths.
+//==============================================================================
+
+inline DXGI_FORMAT GetBlockDXGIFormat(BlockFormat format)
+{
+    switch (format)
+    {
+    case BlockFormat::BC1: return DXGI_FORMAT_BC1_UNORM;
+    case BlockFormat::BC3: return DXGI_FORMAT_BC3_UNORM;
+    case BlockFormat::BC4: return DXGI_FORMAT_BC4_UNORM;
+    case BlockFormat::BC5: return DXGI_FORMAT_BC5_UNORM;
+    case BlockFormat::BC7: return DXGI_FORMAT_BC7_UNORM;
+    default: return DXGI_FORMAT_UNKNOWN;
+    }
+}
@@ -1,6 +1,8 @@
 #include "Clock.hpp"
 #include "Engine/Core/Time.hpp"
 
+#include <algorithm>
+
 Clock* s_theSystemClock = new Clock();
 
 Clock::Clock()
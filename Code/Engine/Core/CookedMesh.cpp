@@ -0,0 +1,160 @@
+#include "CookedMesh.h"
+
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/MeshOptimizer.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    uint64_t HashCookedBytes(uint64_t hash, uint8_t const* bytes, size_t size)
+    {
+        // 8 字节一步，源文件可能上百 MB
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t word;
+            memcpy(&word, bytes + i, sizeof(word));
+            hash = MixHash(MixHash(hash, (uint32_t)word), (uint32_t)(word >> 32));
+        }
+        uint64_t tail = 0;
+        memcpy(&tail, bytes + i, size - i);
+        hash = MixHash(MixHash(hash, (uint32_t)tail), (uint32_t)(tail >> 32));
+        return MixHash(hash, (uint32_t)size);
+    }
+
+    uint64_t AlignCookedOffset(uint64_t offset)
+    {
+        return (offset + COOKED_MESH_SECTION_ALIGNMENT - 1) & ~(COOKED_MESH_SECTION_ALIGNMENT - 1);
+    }
+}
+
+uint64_t ComputeCookedSourceKey(std::vector<std::string> const& sourceFiles, void const* settings, size_t settingsSize)
+{
+    uint64_t hash = MixHash(0x9E3779B97F4A7C15ull, COOKED_MESH_VERSION);
+    for (std::string const& sourceFile : sourceFiles)
+    {
+        MappedFile file;
+        if (file.Open(sourceFile))
+            hash = HashCookedBytes(hash, file.GetData(), file.GetSize());
+        else
+            hash = MixHash(hash, 0xFFFFFFFFu);
+    }
+    if (settings && settingsSize > 0)
+        hash = HashCookedBytes(hash, (uint8_t const*)settings, settingsSize);
+    return FinalizeHash(hash);
+}
+
+//-----------------------------------------------------------------------------------------------
+void CookedMeshWriter::AddSection(CookedMeshSection type, void const* data, uint32_t elementSize, uint64_t count)
+{
+    PendingSection section;
+    section.m_entry.m_type = (uint32_t)type;
+    section.m_entry.m_elementSize = elementSize;
+    section.m_entry.m_count = data ? count : 0;
+    if (data && count > 0)
+    {
+        uint8_t const* bytes = (uint8_t const*)data;
+        section.m_bytes.assign(bytes, bytes + (size_t)(elementSize * count));
+    }
+    m_sections.push_back(std::move(section));
+}
+
+uint64_t CookedMeshWriter::Save(std::string const& path, uint64_t sourceKey) const
+{
+    CookedMeshHeader header;
+    header.m_sourceKey = sourceKey;
+    header.m_sectionCount = (uint32_t)m_sections.size();
+
+    std::vector<CookedMeshSectionEntry> entries;
+    entries.reserve(m_sections.size());
+    uint64_t offset = AlignCookedOffset(sizeof(CookedMeshHeader) + m_sections.size() * sizeof(CookedMeshSectionEntry));
+    for (PendingSection const& section : m_sections)
+    {
+        CookedMeshSectionEntry entry = section.m_entry;
+        entry.m_offset = offset;
+        entries.push_back(entry);
+        offset = AlignCookedOffset(offset + section.m_bytes.size());
+    }
+    header.m_fileSize = offset;
+
+    std::vector<uint8_t> buffer((size_t)offset, 0);
+    memcpy(buffer.data(), &header, sizeof(header));
+    if (!entries.empty())
+        memcpy(buffer.data() + sizeof(header), entries.data(), entries.size() * sizeof(CookedMeshSectionEntry));
+    for (size_t s = 0; s < m_sections.size(); s++)
+    {
+        if (!m_sections[s].m_bytes.empty())
+            memcpy(buffer.data() + entries[s].m_offset, m_sections[s].m_bytes.data(), m_sections[s].m_bytes.size());
+    }
+
+    std::string tempPath = path + ".tmp";
+    if (FileWriteFromBuffer(buffer, tempPath) != (int)buffer.size())
+    {
+        remove(tempPath.c_str());
+        return 0;
+    }
+    remove(path.c_str());
+    if (rename(tempPath.c_str(), path.c_str()) != 0)
+        return 0;
+    return offset;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool CookedMeshFile::Open(std::string const& path, uint64_t expectedSourceKey)
+{
+    Close();
+    if (!m_file.Open(path))
+        return false;
+
+    uint8_t const* data = m_file.GetData();
+    size_t size = m_file.GetSize();
+    CookedMeshHeader const* header = (CookedMeshHeader const*)data;
+    if (size < sizeof(CookedMeshHeader) || header->m_magic != COOKED_MESH_MAGIC || header->m_version != COOKED_MESH_VERSION ||
+        header->m_sourceKey != expectedSourceKey || header->m_fileSize != (uint64_t)size ||
+        sizeof(CookedMeshHeader) + (uint64_t)header->m_sectionCount * sizeof(CookedMeshSectionEntry) > size)
+    {
+        Close();
+        return false;
+    }
+
+    // 截断 / 越界的 section 表当成过期
+    CookedMeshSectionEntry const* sections = (CookedMeshSectionEntry const*)(data + sizeof(CookedMeshHeader));
+    for (uint32_t s = 0; s < header->m_sectionCount; s++)
+    {
+        CookedMeshSectionEntry const& entry = sections[s];
+        if (entry.m_offset % COOKED_MESH_SECTION_ALIGNMENT != 0 || entry.m_offset > size ||
+            (entry.m_elementSize > 0 && entry.m_count > (size - entry.m_offset) / entry.m_elementSize))
+        {
+            Close();
+            return false;
+        }
+    }
+    m_sections = sections;
+    m_sectionCount = header->m_sectionCount;
+    return true;
+}
+
+void CookedMeshFile::Close()
+{
+    m_file.Close();
+    m_sections = nullptr;
+    m_sectionCount = 0;
+}
+
+void const* CookedMeshFile::GetSectionBytes(CookedMeshSection type, uint32_t elementSize, uint64_t& outCount) const
+{
+    outCount = 0;
+    for (uint32_t s = 0; s < m_sectionCount; s++)
+    {
+        CookedMeshSectionEntry const& entry = m_sections[s];
+        if (entry.m_type != (uint32_t)type)
+            continue;
+        if (entry.m_elementSize != elementSize)
+            return nullptr;
+        outCount = entry.m_count;
+        return m_file.GetData() + entry.m_offset;
+    }
+    return nullptr;
+}
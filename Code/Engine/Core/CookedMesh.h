@@ -0,0 +1,153 @@
+#pragma once
+#include "Engine/Core/MappedFile.h"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Sphere.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//==============================================================================
+// CookedMesh - 版本化的二进制 mesh 容器，mmap 之后原地使用，不用再解析
+//==============================================================================
+// Layout (native endianness, everything POD):
+//   CookedMeshHeader
+//   CookedMeshSectionEntry[sectionCount]
+//   section payloads, each starting on a COOKED_MESH_SECTION_ALIGNMENT boundary
+//
+// A section is a plain array: elementSize is checked against sizeof(T) on read, so a
+// struct layout change reads as a stale file rather than garbage. Section element types
+// have no padding, so a cook is byte-deterministic; structs that do (card templates) are
+// serialized field by field into a uint8_t section. The header stores the
+// source key (ComputeCookedSourceKey: contents of every source file + import settings +
+// version); a different key means the cook is stale and the caller re-imports and
+// re-cooks. Unknown section types are ignored, missing ones just read as empty.
+// Cooked texture mip chains (ImageMipChain, CompressedMipChain) use the same container with
+// their own sections.
+//==============================================================================
+
+static constexpr uint32_t COOKED_MESH_MAGIC = 0x4B4F4F43;   // "COOK"
+static constexpr uint32_t COOKED_MESH_VERSION = 3;     // 2: CARDS replaces the raw card struct sections; 3: meshlets are opt-in
+static constexpr uint64_t COOKED_MESH_SECTION_ALIGNMENT = 64;
+
+enum class CookedMeshSection : uint32_t
+{
+    VERTICES,               // Vertex_PCUTBN
+    INDICES,                // uint32_t
+    BOUNDS,                 // CookedMeshBounds (one)
+    OPTIMIZATION_REPORT,    // MeshOptimizationReport (one, only if the mesh was optimized)
+    MESHLETS,               // Meshlet
+    MESHLET_VERTICES,       // uint32_t
+    MESHLET_TRIANGLES,      // uint8_t
+    BVH_NODES,              // GPUBVHNode, flattened BVH at scale 1
+    BVH_TRIANGLES,          // uint32_t
+    CARDS,                  // uint8_t, SerializeSurfaceCards (only once cards were generated)
+    SDF_VOLUMES,            // CookedMeshSDFVolume (optional)
+    SDF_DISTANCES,          // float, all volumes back to back
+    MIP_LEVELS,             // ImageMipLevel (cooked textures, .mips)
+    MIP_TEXELS,             // Rgba8, every level back to back
+    BLOCK_MIP_FORMAT,       // uint32_t BlockFormat (one, block-compressed .mips)
+    BLOCK_MIP_LEVELS,       // CompressedMipLevel
+    BLOCK_MIP_DATA,         // uint8_t, BCn blocks of every level back to back
+    COUNT
+};
+
+struct CookedMeshHeader
+{
+    uint32_t m_magic = COOKED_MESH_MAGIC;
+    uint32_t m_version = COOKED_MESH_VERSION;
+    uint64_t m_sourceKey = 0;
+    uint64_t m_fileSize = 0;
+    uint32_t m_sectionCount = 0;
+    uint32_t m_reserved = 0;
+};
+
+struct CookedMeshSectionEntry
+{
+    uint32_t m_type = 0;
+    uint32_t m_elementSize = 0;
+    uint64_t m_offset = 0;               // from the start of the file
+    uint64_t m_count = 0;
+};
+
+// StaticMesh bounds, all computed once at cook time
+struct CookedMeshBounds
+{
+    AABB3 m_localBounds;                 // GetAABB3Bounds
+    AABB3 m_transformedBounds;           // GetTransformedAABB3Bounds
+    AABB3 m_transformedBoundsWithoutAxisTransform;
+    Sphere m_boundsSphere;               // GetBoundsSphere
+    Sphere m_transformedBoundsSphere;    // GetTransformedBoundsSphere
+};
+
+// SDF brick volume: resolution^3 distances at SDF_DISTANCES[m_firstDistance]
+struct CookedMeshSDFVolume
+{
+    AABB3 m_bounds;
+    float m_scale = 1.f;
+    int m_resolution = 0;
+    uint64_t m_firstDistance = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+// hash of every file's bytes (a missing file hashes as empty) + settings + COOKED_MESH_VERSION
+uint64_t ComputeCookedSourceKey(std::vector<std::string> const& sourceFiles, void const* settings, size_t settingsSize);
+
+class CookedMeshWriter
+{
+public:
+    // data is copied, it does not have to outlive the writer
+    void AddSection(CookedMeshSection type, void const* data, uint32_t elementSize, uint64_t count);
+
+    template <typename T>
+    void AddSection(CookedMeshSection type, std::vector<T> const& data) { AddSection(type, data.data(), (uint32_t)sizeof(T), data.size()); }
+
+    template <typename T>
+    void AddSingle(CookedMeshSection type, T const& value) { AddSection(type, &value, (uint32_t)sizeof(T), 1); }
+
+    // writes to a temp file first and renames it, so a crash never leaves a half-written cook behind.
+    // returns the file size, 0 on failure
+    uint64_t Save(std::string const& path, uint64_t sourceKey) const;
+
+private:
+    struct PendingSection
+    {
+        CookedMeshSectionEntry m_entry;
+        std::vector<uint8_t> m_bytes;
+    };
+    std::vector<PendingSection> m_sections;
+};
+
+class CookedMeshFile
+{
+public:
+    // maps the file and validates header, key and the section table
+    bool Open(std::string const& path, uint64_t expectedSourceKey);
+    void Close();
+    bool IsOpen() const { return m_file.IsOpen(); }
+    size_t GetFileSize() const { return m_file.GetSize(); }
+
+    // points into the mapping (valid while the file stays open); nullptr + 0 if missing or the element size differs
+    template <typename T>
+    T const* GetSection(CookedMeshSection type, uint64_t& outCount) const
+    {
+        return (T const*)GetSectionBytes(type, (uint32_t)sizeof(T), outCount);
+    }
+
+    template <typename T>
+    bool CopySection(CookedMeshSection type, std::vector<T>& out) const
+    {
+        uint64_t count = 0;
+        T const* data = GetSection<T>(type, count);
+        out.assign(data, data + count);
+        return data != nullptr;
+    }
+
+private:
+    void const* GetSectionBytes(CookedMeshSection type, uint32_t elementSize, uint64_t& outCount) const;
+
+private:
+    MappedFile m_file;
+    CookedMeshSectionEntry const* m_sections = nullptr;
+    uint32_t m_sectionCount = 0;
+};
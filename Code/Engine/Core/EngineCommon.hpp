@@ -10,6 +10,11 @@
 
 #define UNUSED(x) (void)(x);
 
+// SSE intrinsics (TangentSpace, BlockCompression); every SIMD loop has a scalar fallback
+#if (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)) && !defined(ENGINE_DISABLE_SSE)
+#define ENGINE_ENABLE_SSE
+#endif
+
 extern NamedStrings g_gameConfigBlackboard;
 extern EventSystem* g_theEventSystem;
 extern DevConsole* g_theDevConsole;
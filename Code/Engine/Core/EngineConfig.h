@@ -17,4 +17,5 @@ struct GIConfig
 	uint32_t m_giTileSize = 256;
 	bool m_enableTemporal = true;
 	bool m_enableMultipleTypes = false;
+	uint32_t m_probeReadbackInterval = 8;	// frames between radiance probe readbacks for the CPU lighting queries, 0 = never
 };
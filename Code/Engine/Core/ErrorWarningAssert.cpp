@@ -4,22 +4,34 @@
 
 //-----------------------------------------------------------------------------------------------
 #ifdef _WIN32
-#define PLATFORM_WINDOWS
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 #endif
 
 //-----------------------------------------------------------------------------------------------
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include <stdarg.h>
 #include <iostream>
 
+#if !defined( _WIN32 )
+// 没有 Win32 的平台（Linux 上的 IglooCook）：不弹对话框，不接调试器，只打印
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#define vsnprintf_s( buffer, bufferSize, count, format, args ) vsnprintf( buffer, bufferSize, format, args )
+#define IsDebuggerPresent() 0
+#define TRUE 1
+#define ShowCursor( show )
+#define __debugbreak() abort()
+#endif
+
 
 //-----------------------------------------------------------------------------------------------
 bool IsDebuggerAvailable()
 {
-#if defined( PLATFORM_WINDOWS )
+#if defined( _WIN32 )
 	typedef BOOL (CALLBACK IsDebuggerPresentFunc)();
 
 	// Get a handle to KERNEL32.DLL
@@ -52,7 +64,7 @@ void DebuggerPrintf( char const* messageFormat, ... )
 	va_end( variableArgumentList );
 	messageLiteral[ MESSAGE_MAX_LENGTH - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
-#if defined( PLATFORM_WINDOWS )
+#if defined( _WIN32 )
 	if( IsDebuggerAvailable() )
 	{
 		OutputDebugStringA( messageLiteral );
@@ -66,7 +78,7 @@ void DebuggerPrintf( char const* messageFormat, ... )
 //-----------------------------------------------------------------------------------------------
 // Converts a SeverityLevel to a Windows MessageBox icon type (MB_etc)
 //
-#if defined( PLATFORM_WINDOWS )
+#if defined( _WIN32 )
 UINT GetWindowsMessageBoxIconFlagForSeverityLevel( MsgSeverityLevel severity )
 {
 	switch( severity )
@@ -107,13 +119,17 @@ char const* FindStartOfFileNameWithinFilePath( char const* filePath )
 //-----------------------------------------------------------------------------------------------
 void SystemDialogue_Okay( std::string const& messageTitle, std::string const& messageText, MsgSeverityLevel severity )
 {
-	#if defined( PLATFORM_WINDOWS )
+	#if defined( _WIN32 )
 	{
 		ShowCursor( TRUE );
 		UINT dialogueIconTypeFlag = GetWindowsMessageBoxIconFlagForSeverityLevel( severity );
 		MessageBoxA( NULL, messageText.c_str(), messageTitle.c_str(), MB_OK | dialogueIconTypeFlag | MB_TOPMOST );
 		ShowCursor( FALSE );
 	}
+	#else
+	UNUSED( messageTitle )
+	UNUSED( messageText )
+	UNUSED( severity )
 	#endif
 }
 
@@ -125,7 +141,7 @@ bool SystemDialogue_OkayCancel( std::string const& messageTitle, std::string con
 {
 	bool isAnswerOkay = true;
 
-	#if defined( PLATFORM_WINDOWS )
+	#if defined( _WIN32 )
 	{
 		ShowCursor( TRUE );
 		UINT dialogueIconTypeFlag = GetWindowsMessageBoxIconFlagForSeverityLevel( severity );
@@ -133,6 +149,10 @@ bool SystemDialogue_OkayCancel( std::string const& messageTitle, std::string con
 		isAnswerOkay = (buttonClicked == IDOK);
 		ShowCursor( FALSE );
 	}
+	#else
+	UNUSED( messageTitle )
+	UNUSED( messageText )
+	UNUSED( severity )
 	#endif
 
 	return isAnswerOkay;
@@ -146,7 +166,7 @@ bool SystemDialogue_YesNo( std::string const& messageTitle, std::string const& m
 {
 	bool isAnswerYes = true;
 
-	#if defined( PLATFORM_WINDOWS )
+	#if defined( _WIN32 )
 	{
 		ShowCursor( TRUE );
 		UINT dialogueIconTypeFlag = GetWindowsMessageBoxIconFlagForSeverityLevel( severity );
@@ -154,6 +174,10 @@ bool SystemDialogue_YesNo( std::string const& messageTitle, std::string const& m
 		isAnswerYes = (buttonClicked == IDYES);
 		ShowCursor( FALSE );
 	}
+	#else
+	UNUSED( messageTitle )
+	UNUSED( messageText )
+	UNUSED( severity )
 	#endif
 
 	return isAnswerYes;
@@ -167,7 +191,7 @@ int SystemDialogue_YesNoCancel( std::string const& messageTitle, std::string con
 {
 	int answerCode = 1;
 
-	#if defined( PLATFORM_WINDOWS )
+	#if defined( _WIN32 )
 	{
 		ShowCursor( TRUE );
 		UINT dialogueIconTypeFlag = GetWindowsMessageBoxIconFlagForSeverityLevel( severity );
@@ -175,6 +199,10 @@ int SystemDialogue_YesNoCancel( std::string const& messageTitle, std::string con
 		answerCode = (buttonClicked == IDYES ? 1 : (buttonClicked == IDNO ? 0 : -1) );
 		ShowCursor( FALSE );
 	}
+	#else
+	UNUSED( messageTitle )
+	UNUSED( messageText )
+	UNUSED( severity )
 	#endif
 
 	return answerCode;
@@ -182,7 +210,7 @@ int SystemDialogue_YesNoCancel( std::string const& messageTitle, std::string con
 
 
 //-----------------------------------------------------------------------------------------------
-__declspec( noreturn ) void FatalError( char const* filePath, char const* functionName, int lineNum, std::string const& reasonForError, char const* conditionText )
+[[noreturn]] void FatalError( char const* filePath, char const* functionName, int lineNum, std::string const& reasonForError, char const* conditionText )
 {
 	std::string errorMessage = reasonForError;
 	if( reasonForError.empty() )
@@ -1,13 +1,33 @@
 ﻿#include "FileUtils.hpp"
+#include "VirtualFileSystem.h"
 
 #include <vector>
 #include <string>
 #include <stdio.h>
 
+#ifndef _WIN32
+#include <cerrno>
+// fopen_s 只有 MSVC 有（IglooCook 要在 Linux 上跑）
+static int fopen_s(FILE** outFile, char const* fileName, char const* mode)
+{
+	*outFile = fopen(fileName, mode);
+	return *outFile ? 0 : errno;
+}
+#endif
+
 int FileReadToBuffer(std::vector<uint8_t>& outBuffer, const std::string& fileName)
+{
+	if (ReadMountedFile(fileName, outBuffer))
+	{
+		return static_cast<int>(outBuffer.size());
+	}
+	return FileReadToBufferFromDisk(outBuffer, fileName);
+}
+
+int FileReadToBufferFromDisk(std::vector<uint8_t>& outBuffer, const std::string& fileName)
 {
 	FILE* file = nullptr;
-	errno_t err = fopen_s(&file, fileName.c_str(), "rb");
+	int err = fopen_s(&file, fileName.c_str(), "rb");
 	if (err != 0 || file == nullptr)
 	{
 		return -1;
@@ -43,3 +63,23 @@ int FileReadToString(std::string& outString, const std::string& fileName)
 
 	return size;
 }
+
+int FileWriteFromBuffer(const std::vector<uint8_t>& buffer, const std::string& fileName)
+{
+	FILE* file = nullptr;
+	int err = fopen_s(&file, fileName.c_str(), "wb");
+	if (err != 0 || file == nullptr)
+	{
+		return -1;
+	}
+
+	size_t bytesWritten = fwrite(buffer.data(), 1, buffer.size(), file);
+	fclose(file);
+
+	if (bytesWritten != buffer.size())
+	{
+		return -1;
+	}
+
+	return static_cast<int>(bytesWritten);
+}
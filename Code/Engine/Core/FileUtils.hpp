@@ -3,5 +3,8 @@
 #include <string>
 
 
+// 先找挂上的 asset pack（VirtualFileSystem.h），没有再读散文件
 int FileReadToBuffer(std::vector<uint8_t>& outBuffer, const std::string& fileName);
-int FileReadToString(std::string& outString, const std::string& fileName);
\ No newline at end of file
+int FileReadToBufferFromDisk(std::vector<uint8_t>& outBuffer, const std::string& fileName);
+int FileReadToString(std::string& outString, const std::string& fileName);
+int FileWriteFromBuffer(const std::vector<uint8_t>& buffer, const std::string& fileName);
\ No newline at end of file
@@ -0,0 +1,350 @@
+#include "GLBImporter.h"
+
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StaticMeshUtils.h"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Job/JobSystem.h"
+#include "ThirdParty/cgltf/cgltf.h"
+#include "ThirdParty/stb/stb_image.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    // 和 cgltf_default_file_read 一样用 memory_options 的 alloc，释放走默认的 release
+    cgltf_result ReadGLTFFile(cgltf_memory_options const* memoryOptions, cgltf_file_options const* fileOptions, char const* path, cgltf_size* size, void** data)
+    {
+        (void)fileOptions;
+        std::vector<uint8_t> bytes;
+        if (FileReadToBuffer(bytes, path) < 0)
+            return cgltf_result_file_not_found;
+
+        void* copy = memoryOptions->alloc_func ? memoryOptions->alloc_func(memoryOptions->user_data, bytes.size()) : malloc(bytes.size());
+        if (!copy)
+            return cgltf_result_out_of_memory;
+        memcpy(copy, bytes.data(), bytes.size());
+        if (size)
+            *size = bytes.size();
+        *data = copy;
+        return cgltf_result_success;
+    }
+
+    struct GLBPrimitiveRange
+    {
+        cgltf_primitive const* m_primitive = nullptr;
+        cgltf_accessor const* m_positions = nullptr;
+        cgltf_accessor const* m_normals = nullptr;
+        cgltf_accessor const* m_uvs = nullptr;
+        GLBSubMesh m_subMesh;
+    };
+
+    uint32_t GetListIndexCount(cgltf_primitive_type type, uint32_t count)
+    {
+        switch (type)
+        {
+        case cgltf_primitive_type_triangles:      return count - count % 3;
+        case cgltf_primitive_type_triangle_strip:
+        case cgltf_primitive_type_triangle_fan:   return count >= 3 ? (count - 2) * 3 : 0;
+        default:                                  return 0;
+        }
+    }
+
+    // strip / fan 的第 i 个三角形；strip 奇数个翻转绕序
+    void GetListTriangle(cgltf_primitive_type type, uint32_t triangle, uint32_t outCorners[3])
+    {
+        if (type == cgltf_primitive_type_triangle_strip)
+        {
+            bool isOdd = (triangle & 1) != 0;
+            outCorners[0] = triangle + (isOdd ? 1 : 0);
+            outCorners[1] = triangle + (isOdd ? 0 : 1);
+            outCorners[2] = triangle + 2;
+        }
+        else if (type == cgltf_primitive_type_triangle_fan)
+        {
+            outCorners[0] = 0;
+            outCorners[1] = triangle + 1;
+            outCorners[2] = triangle + 2;
+        }
+        else
+        {
+            outCorners[0] = triangle * 3;
+            outCorners[1] = triangle * 3 + 1;
+            outCorners[2] = triangle * 3 + 2;
+        }
+    }
+
+    void ReadPrimitive(GLBPrimitiveRange const& range, bool flipUV, Vertex_PCUTBN* outVerts, unsigned int* outIndices)
+    {
+        for (uint32_t v = 0; v < range.m_subMesh.m_vertexCount; v++)
+        {
+            Vertex_PCUTBN vertex = {};
+            float pos[3] = {};
+            cgltf_accessor_read_float(range.m_positions, v, pos, 3);
+            vertex.m_position = Vec3(pos[0], pos[1], pos[2]);
+            if (range.m_normals)
+            {
+                float norm[3] = {};
+                cgltf_accessor_read_float(range.m_normals, v, norm, 3);
+                vertex.m_normal = Vec3(norm[0], norm[1], norm[2]);
+            }
+            if (range.m_uvs)
+            {
+                float uv[2] = {};
+                cgltf_accessor_read_float(range.m_uvs, v, uv, 2);
+                vertex.m_uvTexCoords = flipUV ? Vec2(uv[0], 1.f - uv[1]) : Vec2(uv[0], uv[1]);
+            }
+            vertex.m_color = Rgba8::WHITE;
+            vertex.m_tangent = Vec3();
+            vertex.m_bitangent = Vec3();
+            outVerts[v] = vertex;
+        }
+
+        cgltf_primitive const& primitive = *range.m_primitive;
+        uint32_t baseVertex = range.m_subMesh.m_firstVertex;
+        uint32_t triangleCount = range.m_subMesh.m_indexCount / 3;
+        for (uint32_t t = 0; t < triangleCount; t++)
+        {
+            uint32_t corners[3];
+            GetListTriangle(primitive.type, t, corners);
+            for (int c = 0; c < 3; c++)
+            {
+                uint32_t local = primitive.indices ? (uint32_t)cgltf_accessor_read_index(primitive.indices, corners[c]) : corners[c];
+                outIndices[t * 3 + c] = baseVertex + local;
+            }
+        }
+    }
+
+    cgltf_texture const* GetChannelTexture(cgltf_material const& material, GLBChannel channel)
+    {
+        switch (channel)
+        {
+        case GLBChannel::Albedo:
+            return material.has_pbr_metallic_roughness ? material.pbr_metallic_roughness.base_color_texture.texture : nullptr;
+        case GLBChannel::Normal:
+            return material.normal_texture.texture;
+        case GLBChannel::AO:
+            return material.occlusion_texture.texture;
+        case GLBChannel::Metallic:
+        case GLBChannel::Roughness:
+            return material.has_pbr_metallic_roughness ? material.pbr_metallic_roughness.metallic_roughness_texture.texture : nullptr;
+        default:
+            return nullptr;
+        }
+    }
+
+    // 和 LoadImageDueToGLTFData 一样解成 RGBA8，不翻转（线程局部设置，不受 DX11 全局 flip 影响）
+    bool DecodeGLBImage(cgltf_image const& image, std::string const& filePath, Image& outImage)
+    {
+        std::vector<uint8_t> fileBytes;
+        uint8_t const* bytes = nullptr;
+        size_t size = 0;
+        std::string name;
+        if (image.buffer_view)
+        {
+            bytes = cgltf_buffer_view_data(image.buffer_view);
+            size = image.buffer_view->size;
+            name = filePath + "#" + (image.name ? image.name : "image");
+        }
+        else if (image.uri && strncmp(image.uri, "data:", 5) != 0)
+        {
+            size_t lastSlash = filePath.find_last_of("/\\");
+            std::string directory = (lastSlash != std::string::npos) ? filePath.substr(0, lastSlash) : ".";
+            name = directory + "/" + image.uri;
+            if (FileReadToBuffer(fileBytes, name) <= 0)
+                return false;
+            bytes = fileBytes.data();
+            size = fileBytes.size();
+        }
+        if (!bytes || size == 0)
+            return false;
+
+        stbi_set_flip_vertically_on_load_thread(0);
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        unsigned char* pixels = stbi_load_from_memory(bytes, (int)size, &width, &height, &channels, 4);
+        if (!pixels)
+            return false;
+
+        outImage = Image(pixels, width, height, 4);
+        outImage.SetName(name);
+        stbi_image_free(pixels);
+        return true;
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+void SetGLTFFileCallbacks(cgltf_options& options)
+{
+    options.file.read = &ReadGLTFFile;
+    options.file.release = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+Image const* GLBImportResult::GetChannelImage(GLBChannel channel) const
+{
+    int imageIndex = m_channelImages[(int)channel];
+    return imageIndex >= 0 ? &m_images[imageIndex] : nullptr;
+}
+
+Image GLBImportResult::TakeChannelImage(GLBChannel channel)
+{
+    int imageIndex = m_channelImages[(int)channel];
+    if (imageIndex < 0)
+        return Image();
+
+    m_channelImages[(int)channel] = -1;
+    bool isShared = std::find(std::begin(m_channelImages), std::end(m_channelImages), imageIndex) != std::end(m_channelImages);
+    return isShared ? m_images[imageIndex] : std::move(m_images[imageIndex]);
+}
+
+//-----------------------------------------------------------------------------------------------
+bool ImportGLBFile(std::string const& filePath, GLBImportResult& out, GLBImportSettings const& settings)
+{
+    out = GLBImportResult();
+    GLBImportStats& stats = out.m_stats;
+    double startTime = GetCurrentTimeSeconds();
+
+    // 1. read
+    std::vector<uint8_t> fileBytes;
+    if (FileReadToBuffer(fileBytes, filePath) <= 0)
+        return false;
+    stats.m_fileBytes = fileBytes.size();
+    double parseStart = GetCurrentTimeSeconds();
+    stats.m_readMilliseconds = (parseStart - startTime) * 1000.0;
+
+    // 2. parse。GLB 的 BIN chunk 直接指向 fileBytes，cgltf_free 之前 fileBytes 不能释放
+    cgltf_options options = {};
+    SetGLTFFileCallbacks(options);
+    cgltf_data* data = nullptr;
+    if (cgltf_parse(&options, fileBytes.data(), fileBytes.size(), &data) != cgltf_result_success)
+        return false;
+    if (cgltf_load_buffers(&options, data, filePath.c_str()) != cgltf_result_success)
+    {
+        cgltf_free(data);
+        return false;
+    }
+    double geometryStart = GetCurrentTimeSeconds();
+    stats.m_parseMilliseconds = (geometryStart - parseStart) * 1000.0;
+    stats.m_meshCount = (uint32_t)data->meshes_count;
+
+    // 3. geometry：先数出每个 primitive 的范围，再各写各的
+    std::vector<GLBPrimitiveRange> ranges;
+    cgltf_material const* material = nullptr;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    for (cgltf_size m = 0; m < data->meshes_count; m++)
+    {
+        cgltf_mesh const& mesh = data->meshes[m];
+        for (cgltf_size p = 0; p < mesh.primitives_count; p++)
+        {
+            cgltf_primitive const& primitive = mesh.primitives[p];
+            GLBPrimitiveRange range;
+            range.m_primitive = &primitive;
+            for (cgltf_size a = 0; a < primitive.attributes_count; a++)
+            {
+                cgltf_attribute const& attribute = primitive.attributes[a];
+                if (attribute.type == cgltf_attribute_type_position)
+                    range.m_positions = attribute.data;
+                else if (attribute.type == cgltf_attribute_type_normal)
+                    range.m_normals = attribute.data;
+                else if (attribute.type == cgltf_attribute_type_texcoord && attribute.index == 0)
+                    range.m_uvs = attribute.data;
+            }
+
+            uint32_t cornerCount = range.m_positions ? (uint32_t)(primitive.indices ? primitive.indices->count : range.m_positions->count) : 0;
+            uint32_t listIndexCount = GetListIndexCount(primitive.type, cornerCount);
+            if (listIndexCount == 0)
+            {
+                stats.m_skippedPrimitiveCount++;
+                continue;
+            }
+
+            if (!material && primitive.material)
+                material = primitive.material;
+
+            range.m_subMesh.m_firstVertex = vertexCount;
+            range.m_subMesh.m_vertexCount = (uint32_t)range.m_positions->count;
+            range.m_subMesh.m_firstIndex = indexCount;
+            range.m_subMesh.m_indexCount = listIndexCount;
+            range.m_subMesh.m_meshIndex = (uint32_t)m;
+            range.m_subMesh.m_primitiveIndex = (uint32_t)p;
+            range.m_subMesh.m_materialIndex = primitive.material ? (int)(primitive.material - data->materials) : -1;
+            vertexCount += range.m_subMesh.m_vertexCount;
+            indexCount += listIndexCount;
+            ranges.push_back(range);
+        }
+    }
+    stats.m_primitiveCount = (uint32_t)ranges.size();
+    if (!material && data->materials_count > 0)
+        material = &data->materials[0];
+
+    if (settings.m_loadGeometry)
+    {
+        out.m_verts.resize(vertexCount);
+        out.m_indices.resize(indexCount);
+        out.m_subMeshes.reserve(ranges.size());
+        for (GLBPrimitiveRange const& range : ranges)
+        {
+            out.m_subMeshes.push_back(range.m_subMesh);
+        }
+        ParallelFor((uint32_t)ranges.size(), 1, [&ranges, &out, &settings](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t r = begin; r < end; r++)
+            {
+                GLBSubMesh const& subMesh = ranges[r].m_subMesh;
+                ReadPrimitive(ranges[r], settings.m_flipUV, out.m_verts.data() + subMesh.m_firstVertex, out.m_indices.data() + subMesh.m_firstIndex);
+            }
+        });
+    }
+    double tangentStart = GetCurrentTimeSeconds();
+    stats.m_geometryMilliseconds = (tangentStart - geometryStart) * 1000.0;
+
+    // 4. tangents
+    if (settings.m_loadGeometry)
+        ComputeTangentsBitangentsIndexed(out.m_verts, out.m_indices);
+    double imageStart = GetCurrentTimeSeconds();
+    stats.m_tangentMilliseconds = (imageStart - tangentStart) * 1000.0;
+
+    // 5. images：每张不同的图解一次
+    if (settings.m_decodeImages && material)
+    {
+        std::vector<cgltf_image const*> images;
+        for (int channel = 0; channel < (int)GLBChannel::Count; channel++)
+        {
+            cgltf_texture const* texture = GetChannelTexture(*material, (GLBChannel)channel);
+            if (!texture || !texture->image)
+                continue;
+            auto found = std::find(images.begin(), images.end(), texture->image);
+            out.m_channelImages[channel] = (int)(found - images.begin());
+            if (found == images.end())
+                images.push_back(texture->image);
+        }
+
+        out.m_images.resize(images.size());
+        std::vector<uint8_t> isDecoded(images.size(), 0);
+        ParallelFor((uint32_t)images.size(), 1, [&images, &out, &isDecoded, &filePath](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                isDecoded[i] = DecodeGLBImage(*images[i], filePath, out.m_images[i]) ? 1 : 0;
+            }
+        });
+
+        for (int channel = 0; channel < (int)GLBChannel::Count; channel++)
+        {
+            int imageIndex = out.m_channelImages[channel];
+            if (imageIndex >= 0 && !isDecoded[imageIndex])
+                out.m_channelImages[channel] = -1;
+        }
+        stats.m_imageCount = (uint32_t)std::count(isDecoded.begin(), isDecoded.end(), (uint8_t)1);
+    }
+    double endTime = GetCurrentTimeSeconds();
+    stats.m_imageMilliseconds = (endTime - imageStart) * 1000.0;
+    stats.m_totalMilliseconds = (endTime - startTime) * 1000.0;
+
+    cgltf_free(data);
+    return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "Engine/Core/Image.hpp"
+#include "Engine/Core/StaticMesh.h"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct cgltf_options;
+
+//==============================================================================
+// GLBImporter - .glb / .gltf 只解析一次：几何和材质贴图都从同一份 cgltf_data 里取
+//==============================================================================
+// ImportGLBFile:
+//   1. read       the file into one buffer (GLB BIN chunk is used in place, not copied)
+//   2. parse      cgltf_parse + cgltf_load_buffers (external .bin / data: URIs)
+//   3. geometry   every primitive of every mesh -> one vertex / index stream. Counts are
+//                 prefix-summed first, then ParallelFor over primitives writes its own
+//                 range. Strips / fans are turned into lists, primitives without indices
+//                 get sequential ones; points / lines are skipped
+//   4. tangents   ComputeTangentsBitangentsIndexed over the whole stream
+//   5. images     the textures referenced by the mesh's material (base color, normal,
+//                 occlusion, metallic-roughness), each distinct image decoded once,
+//                 ParallelFor over images. ORM files where occlusion and
+//                 metallic-roughness share one image decode it once
+//
+// Node transforms are not applied (same as the old loader). StaticMesh has one material,
+// so the images come from the first material any primitive uses.
+//==============================================================================
+
+struct GLBSubMesh
+{
+    uint32_t m_firstIndex = 0;
+    uint32_t m_indexCount = 0;
+    uint32_t m_firstVertex = 0;
+    uint32_t m_vertexCount = 0;
+    uint32_t m_meshIndex = 0;
+    uint32_t m_primitiveIndex = 0;
+    int m_materialIndex = -1;                   // into the file's materials, -1 = none
+};
+
+struct GLBImportSettings
+{
+    bool m_flipUV = false;
+    bool m_loadGeometry = true;
+    bool m_decodeImages = true;
+};
+
+struct GLBImportStats
+{
+    uint64_t m_fileBytes = 0;
+    uint32_t m_meshCount = 0;
+    uint32_t m_primitiveCount = 0;              // imported
+    uint32_t m_skippedPrimitiveCount = 0;       // points / lines / no positions
+    uint32_t m_imageCount = 0;                  // distinct images decoded
+    double m_readMilliseconds = 0.0;
+    double m_parseMilliseconds = 0.0;
+    double m_geometryMilliseconds = 0.0;
+    double m_tangentMilliseconds = 0.0;
+    double m_imageMilliseconds = 0.0;
+    double m_totalMilliseconds = 0.0;
+};
+
+struct GLBImportResult
+{
+    std::vector<Vertex_PCUTBN> m_verts;
+    std::vector<unsigned int> m_indices;
+    std::vector<GLBSubMesh> m_subMeshes;        // file order; indices are absolute into m_verts
+    std::vector<Image> m_images;                // distinct decoded images
+    int m_channelImages[(int)GLBChannel::Count] = { -1, -1, -1, -1, -1 };  // GLBChannel -> m_images, -1 = none
+    GLBImportStats m_stats;
+
+    Image const* GetChannelImage(GLBChannel channel) const;
+    // moves the image out; a channel sharing it with another one (ORM) gets a copy
+    Image TakeChannelImage(GLBChannel channel);
+};
+
+// cgltf reads files (.gltf, external .bin) through FileReadToBuffer, so they come from a mounted
+// asset pack like everything else
+void SetGLTFFileCallbacks(cgltf_options& options);
+
+// false if the file cannot be read / parsed; a file without triangles still succeeds (empty stream)
+bool ImportGLBFile(std::string const& filePath, GLBImportResult& out, GLBImportSettings const& settings = GLBImportSettings());
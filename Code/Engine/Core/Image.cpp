@@ -1,6 +1,7 @@
 ﻿#define STB_IMAGE_IMPLEMENTATION // Exactly one .CPP (this Image.cpp) should #define this before #including stb_image.h
 #include "ThirdParty/stb/stb_image.h"
 #include "EngineCommon.hpp"
+#include "FileUtils.hpp"
 #include "Image.hpp"
 
 Image::Image()
@@ -13,8 +14,12 @@ Image::Image(char const* imageFilePath)
 	//std::string fullPath = "Data/" + m_imageFilePath;
 	std::string fullPath = m_imageFilePath;
 
-	int width, height, channels;
-	unsigned char* imageData = stbi_load(fullPath.c_str(), &width, &height, &channels, 4); // 加载图像为 RGBA
+	// 经 FileReadToBuffer 读，挂了 asset pack 就从 pack 里取
+	std::vector<uint8_t> fileBytes;
+	FileReadToBuffer(fileBytes, fullPath);
+
+	int width = 0, height = 0, channels = 0;
+	unsigned char* imageData = fileBytes.empty() ? nullptr : stbi_load_from_memory(fileBytes.data(), (int)fileBytes.size(), &width, &height, &channels, 4); // 加载图像为 RGBA
 	if (channels != 3 && channels != 4)
 	{
 		ERROR_AND_DIE("Dies");
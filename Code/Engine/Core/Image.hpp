@@ -17,6 +17,10 @@ public:
 	Image(IntVec2 size, Rgba8 color);
 	Image(unsigned char* pixelData, int width, int height, int channels);
 	~Image();
+	Image(Image const&) = default;
+	Image(Image&&) = default;
+	Image& operator=(Image const&) = default;
+	Image& operator=(Image&&) = default;
 
 	std::string const& GetImageFilePath() const;
 	IntVec2 GetDimensions() const;
@@ -0,0 +1,475 @@
+#include "ImageMipChain.h"
+
+#include "Engine/Core/CookedMesh.h"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Job/JobSystem.h"
+
+#include <xmmintrin.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // 改了滤波 / 编码的算法要加这个，旧的 .mips 就当过期
+    constexpr uint32_t IMAGE_MIP_ALGORITHM_VERSION = 1;
+    constexpr int SRGB_ENCODE_LUT_SIZE = 16384;
+
+    struct SRGBTables
+    {
+        float m_decode[256];
+        uint8_t m_encode[SRGB_ENCODE_LUT_SIZE];
+
+        SRGBTables()
+        {
+            for (int i = 0; i < 256; i++)
+            {
+                float c = (float)i / 255.f;
+                m_decode[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (int i = 0; i < SRGB_ENCODE_LUT_SIZE; i++)
+            {
+                float linear = (float)i / (float)(SRGB_ENCODE_LUT_SIZE - 1);
+                float c = linear <= 0.0031308f ? linear * 12.92f : 1.055f * powf(linear, 1.f / 2.4f) - 0.055f;
+                m_encode[i] = (uint8_t)std::min(255.f, std::max(0.f, c * 255.f + 0.5f));
+            }
+        }
+    };
+
+    SRGBTables const& GetSRGBTables()
+    {
+        static SRGBTables s_tables;
+        return s_tables;
+    }
+
+    enum class MipEncoding
+    {
+        LINEAR,
+        SRGB,
+        NORMAL
+    };
+
+    MipEncoding GetMipEncoding(ImageMipSettings const& settings)
+    {
+        if (settings.m_isNormalMap)
+            return MipEncoding::NORMAL;
+        return settings.m_isSRGB ? MipEncoding::SRGB : MipEncoding::LINEAR;
+    }
+
+    //-------------------------------------------------------------------------------------------
+    // one axis of the separable filter: every output texel reads m_tapCount source texels
+    // starting at m_first, padded with zero weights
+    struct MipAxisTaps
+    {
+        int m_tapCount = 0;
+        std::vector<int> m_first;
+        std::vector<float> m_weights;        // [output * m_tapCount + tap]
+    };
+
+    float BesselI0(float x)
+    {
+        float sum = 1.f;
+        float term = 1.f;
+        float halfX = x * 0.5f;
+        for (int k = 1; k < 32; k++)
+        {
+            term *= (halfX / (float)k) * (halfX / (float)k);
+            sum += term;
+            if (term < sum * 1e-7f)
+                break;
+        }
+        return sum;
+    }
+
+    float EvaluateKaiser(float x, ImageMipSettings const& settings)
+    {
+        float t = x / settings.m_kaiserWidth;
+        if (fabsf(t) >= 1.f)
+            return 0.f;
+        float sincX = x * settings.m_kaiserStretch * 3.14159265f;
+        float sinc = fabsf(sincX) < 1e-4f ? 1.f : sinf(sincX) / sincX;
+        return sinc * BesselI0(settings.m_kaiserAlpha * sqrtf(1.f - t * t)) / BesselI0(settings.m_kaiserAlpha);
+    }
+
+    MipAxisTaps BuildMipAxisTaps(int srcSize, int dstSize, ImageMipSettings const& settings)
+    {
+        MipAxisTaps taps;
+        float scale = (float)srcSize / (float)dstSize;
+        bool isBox = settings.m_filter == MipFilter::BOX || srcSize == dstSize;
+        float radius = isBox ? scale * 0.5f : settings.m_kaiserWidth * scale;
+        taps.m_tapCount = (int)ceilf(radius * 2.f) + 2;
+        taps.m_first.resize(dstSize);
+        taps.m_weights.assign((size_t)dstSize * taps.m_tapCount, 0.f);
+
+        std::vector<float> weights;
+        for (int x = 0; x < dstSize; x++)
+        {
+            float center = ((float)x + 0.5f) * scale;
+            int first = (int)floorf(center - radius);
+            int last = (int)ceilf(center + radius) - 1;
+            weights.assign((size_t)(last - first + 1), 0.f);
+            for (int s = first; s <= last; s++)
+            {
+                float w;
+                if (isBox)
+                {
+                    // 源 texel 和目标 footprint 的重叠长度，奇数尺寸也是准确的面积权重
+                    float lo = center - radius;
+                    float hi = center + radius;
+                    w = std::max(0.f, std::min(hi, (float)(s + 1)) - std::max(lo, (float)s));
+                }
+                else
+                {
+                    w = EvaluateKaiser(((float)s + 0.5f - center) / scale, settings);
+                }
+                weights[s - first] = w;
+            }
+
+            // 边缘 clamp：越界的 texel 的权重并到边上那个
+            int clampedFirst = std::max(0, first);
+            int clampedLast = std::min(srcSize - 1, last);
+            float* outWeights = &taps.m_weights[(size_t)x * taps.m_tapCount];
+            float sum = 0.f;
+            for (int s = first; s <= last; s++)
+            {
+                int clamped = std::min(std::max(s, clampedFirst), clampedLast);
+                outWeights[clamped - clampedFirst] += weights[s - first];
+                sum += weights[s - first];
+            }
+            float invSum = fabsf(sum) > 1e-8f ? 1.f / sum : 0.f;
+            for (int t = 0; t <= clampedLast - clampedFirst; t++)
+            {
+                outWeights[t] *= invSum;
+            }
+            taps.m_first[x] = clampedFirst;
+        }
+        return taps;
+    }
+
+    //-------------------------------------------------------------------------------------------
+    void DecodeMipRow(Rgba8 const* src, int width, MipEncoding encoding, float* outRow)
+    {
+        __m128 inv255 = _mm_set1_ps(1.f / 255.f);
+        if (encoding == MipEncoding::SRGB)
+        {
+            float const* decode = GetSRGBTables().m_decode;
+            for (int x = 0; x < width; x++)
+            {
+                _mm_storeu_ps(outRow + x * 4, _mm_setr_ps(decode[src[x].r], decode[src[x].g], decode[src[x].b], (float)src[x].a / 255.f));
+            }
+            return;
+        }
+
+        __m128 scale = encoding == MipEncoding::NORMAL ? _mm_setr_ps(2.f / 255.f, 2.f / 255.f, 2.f / 255.f, 1.f / 255.f) : inv255;
+        __m128 bias = encoding == MipEncoding::NORMAL ? _mm_setr_ps(-1.f, -1.f, -1.f, 0.f) : _mm_setzero_ps();
+        for (int x = 0; x < width; x++)
+        {
+            __m128 texel = _mm_setr_ps((float)src[x].r, (float)src[x].g, (float)src[x].b, (float)src[x].a);
+            _mm_storeu_ps(outRow + x * 4, _mm_add_ps(_mm_mul_ps(texel, scale), bias));
+        }
+    }
+
+    Rgba8 EncodeMipTexel(__m128 value, MipEncoding encoding)
+    {
+        alignas(16) float v[4];
+        if (encoding == MipEncoding::NORMAL)
+        {
+            _mm_store_ps(v, value);
+            float length = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+            // 方向互相抵消的区域给一个朝外的法线
+            if (length > 1e-6f)
+                value = _mm_mul_ps(value, _mm_setr_ps(1.f / length, 1.f / length, 1.f / length, 1.f));
+            else
+                value = _mm_setr_ps(0.f, 0.f, 1.f, v[3]);
+            value = _mm_add_ps(_mm_mul_ps(value, _mm_setr_ps(0.5f, 0.5f, 0.5f, 1.f)), _mm_setr_ps(0.5f, 0.5f, 0.5f, 0.f));
+        }
+
+        value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.f));
+        _mm_store_ps(v, value);
+        if (encoding == MipEncoding::SRGB)
+        {
+            uint8_t const* encode = GetSRGBTables().m_encode;
+            float lutScale = (float)(SRGB_ENCODE_LUT_SIZE - 1);
+            return Rgba8(encode[(int)(v[0] * lutScale + 0.5f)], encode[(int)(v[1] * lutScale + 0.5f)],
+                encode[(int)(v[2] * lutScale + 0.5f)], (unsigned char)(v[3] * 255.f + 0.5f));
+        }
+        return Rgba8((unsigned char)(v[0] * 255.f + 0.5f), (unsigned char)(v[1] * 255.f + 0.5f),
+            (unsigned char)(v[2] * 255.f + 0.5f), (unsigned char)(v[3] * 255.f + 0.5f));
+    }
+
+    // dst level = filtered src level; bands of MIP_ROWS_PER_BAND output rows in parallel
+    void FilterMipLevel(Rgba8 const* src, IntVec2 srcSize, Rgba8* dst, IntVec2 dstSize, ImageMipSettings const& settings)
+    {
+        MipAxisTaps horizontal = BuildMipAxisTaps(srcSize.x, dstSize.x, settings);
+        MipAxisTaps vertical = BuildMipAxisTaps(srcSize.y, dstSize.y, settings);
+        MipEncoding encoding = GetMipEncoding(settings);
+
+        uint32_t bandCount = (uint32_t)((dstSize.y + MIP_ROWS_PER_BAND - 1) / MIP_ROWS_PER_BAND);
+        ParallelFor(bandCount, 1, [&](uint32_t beginBand, uint32_t endBand)
+        {
+            std::vector<float> decodedRow((size_t)srcSize.x * 4);
+            std::vector<float> filteredRows;
+            for (uint32_t band = beginBand; band < endBand; band++)
+            {
+                int firstRow = (int)band * MIP_ROWS_PER_BAND;
+                int endRow = std::min(dstSize.y, firstRow + MIP_ROWS_PER_BAND);
+                int firstSourceRow = vertical.m_first[firstRow];
+                int endSourceRow = std::min(srcSize.y, vertical.m_first[endRow - 1] + vertical.m_tapCount);
+
+                // 1 + 2a. 这个 band 用到的源行：解码 + 横向滤波
+                filteredRows.resize((size_t)(endSourceRow - firstSourceRow) * dstSize.x * 4);
+                for (int sy = firstSourceRow; sy < endSourceRow; sy++)
+                {
+                    DecodeMipRow(src + (size_t)sy * srcSize.x, srcSize.x, encoding, decodedRow.data());
+                    float* outRow = &filteredRows[(size_t)(sy - firstSourceRow) * dstSize.x * 4];
+                    for (int x = 0; x < dstSize.x; x++)
+                    {
+                        float const* weights = &horizontal.m_weights[(size_t)x * horizontal.m_tapCount];
+                        int first = horizontal.m_first[x];
+                        int tapCount = std::min(horizontal.m_tapCount, srcSize.x - first);
+                        __m128 sum = _mm_setzero_ps();
+                        for (int t = 0; t < tapCount; t++)
+                        {
+                            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[t]), _mm_loadu_ps(&decodedRow[(size_t)(first + t) * 4])));
+                        }
+                        _mm_storeu_ps(outRow + x * 4, sum);
+                    }
+                }
+
+                // 2b + 3. 纵向滤波 + 编码
+                for (int y = firstRow; y < endRow; y++)
+                {
+                    float const* weights = &vertical.m_weights[(size_t)y * vertical.m_tapCount];
+                    int first = vertical.m_first[y];
+                    int tapCount = std::min(vertical.m_tapCount, srcSize.y - first);
+                    Rgba8* outRow = dst + (size_t)y * dstSize.x;
+                    for (int x = 0; x < dstSize.x; x++)
+                    {
+                        __m128 sum = _mm_setzero_ps();
+                        for (int t = 0; t < tapCount; t++)
+                        {
+                            float const* texel = &filteredRows[((size_t)(first + t - firstSourceRow) * dstSize.x + x) * 4];
+                            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[t]), _mm_loadu_ps(texel)));
+                        }
+                        outRow[x] = EncodeMipTexel(sum, encoding);
+                    }
+                }
+            }
+        });
+    }
+
+    //-------------------------------------------------------------------------------------------
+    float ComputeAlphaCoverage(uint32_t const* histogram, uint64_t texelCount, float scale, float cutoff)
+    {
+        uint64_t covered = 0;
+        for (int a = 1; a < 256; a++)
+        {
+            if (std::min(255.f, (float)a * scale + 0.5f) > cutoff * 255.f + 0.5f)
+                covered += histogram[a];
+        }
+        return texelCount > 0 ? (float)covered / (float)texelCount : 0.f;
+    }
+
+    // 二分找 alpha 的缩放，让超过 cutoff 的比例回到 targetCoverage；返回缩放后的覆盖率
+    float PreserveAlphaCoverage(Rgba8* texels, uint64_t texelCount, float cutoff, float targetCoverage)
+    {
+        uint32_t histogram[256] = {};
+        for (uint64_t i = 0; i < texelCount; i++)
+        {
+            histogram[texels[i].a]++;
+        }
+
+        float lo = 0.f;
+        float hi = 256.f;
+        for (int iteration = 0; iteration < 20; iteration++)
+        {
+            float mid = (lo + hi) * 0.5f;
+            if (ComputeAlphaCoverage(histogram, texelCount, mid, cutoff) < targetCoverage)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        // lo 和 hi 夹住目标，取覆盖率更接近的那个
+        float loError = fabsf(ComputeAlphaCoverage(histogram, texelCount, lo, cutoff) - targetCoverage);
+        float hiError = fabsf(ComputeAlphaCoverage(histogram, texelCount, hi, cutoff) - targetCoverage);
+        float scale = loError < hiError ? lo : hi;
+
+        uint8_t remap[256];
+        for (int a = 0; a < 256; a++)
+        {
+            remap[a] = (uint8_t)std::min(255.f, (float)a * scale + 0.5f);
+        }
+        for (uint64_t i = 0; i < texelCount; i++)
+        {
+            texels[i].a = remap[texels[i].a];
+        }
+        return ComputeAlphaCoverage(histogram, texelCount, scale, cutoff);
+    }
+
+    // POD, no padding: hashed byte for byte by ComputeCookedSourceKey
+    struct ImageMipCookSettings
+    {
+        uint32_t m_version = IMAGE_MIP_ALGORITHM_VERSION;
+        uint32_t m_texelSize = (uint32_t)sizeof(Rgba8);
+        uint32_t m_levelSize = (uint32_t)sizeof(ImageMipLevel);
+        uint32_t m_filter = 0;
+        uint32_t m_isSRGB = 0;
+        uint32_t m_isNormalMap = 0;
+        uint32_t m_preserveAlphaCoverage = 0;
+        float m_alphaCoverageCutoff = 0.f;
+        float m_kaiserWidth = 0.f;
+        float m_kaiserAlpha = 0.f;
+        float m_kaiserStretch = 0.f;
+        int m_maxLevelCount = 0;
+        uint32_t m_extraKey = 0;
+    };
+}
+
+//-----------------------------------------------------------------------------------------------
+Image ImageMipChain::GetLevelImage(int level) const
+{
+    IntVec2 dimensions = GetDimensions(level);
+    Image image((unsigned char*)GetLevelTexels(level), dimensions.x, dimensions.y, 4);
+    image.SetName(m_name);
+    return image;
+}
+
+int GetFullMipLevelCount(IntVec2 const& dimensions)
+{
+    int largest = std::max(dimensions.x, dimensions.y);
+    int levelCount = 1;
+    while (largest > 1)
+    {
+        largest >>= 1;
+        levelCount++;
+    }
+    return levelCount;
+}
+
+void BuildImageMipChain(Image const& image, ImageMipChain& out, ImageMipSettings const& settings, ImageMipStats* outStats)
+{
+    double startTime = GetCurrentTimeSeconds();
+    ImageMipStats stats;
+    out = ImageMipChain();
+    out.m_name = image.GetImageFilePath();
+
+    IntVec2 size = image.GetDimensions();
+    if (size.x <= 0 || size.y <= 0)
+    {
+        if (outStats)
+            *outStats = stats;
+        return;
+    }
+
+    int levelCount = GetFullMipLevelCount(size);
+    if (settings.m_maxLevelCount > 0)
+        levelCount = std::min(levelCount, settings.m_maxLevelCount);
+    uint64_t texelCount = 0;
+    for (int level = 0; level < levelCount; level++)
+    {
+        ImageMipLevel mipLevel;
+        mipLevel.m_dimensions = size;
+        mipLevel.m_firstTexel = texelCount;
+        out.m_levels.push_back(mipLevel);
+        texelCount += (uint64_t)size.x * (uint64_t)size.y;
+        size = IntVec2(std::max(1, size.x >> 1), std::max(1, size.y >> 1));
+    }
+    out.m_texels.resize((size_t)texelCount);
+
+    Rgba8 const* top = (Rgba8 const*)image.GetRawData();
+    uint64_t topTexelCount = (uint64_t)out.m_levels[0].m_dimensions.x * (uint64_t)out.m_levels[0].m_dimensions.y;
+    std::copy(top, top + topTexelCount, out.m_texels.begin());
+
+    uint32_t topHistogram[256] = {};
+    if (settings.m_preserveAlphaCoverage)
+    {
+        for (uint64_t i = 0; i < topTexelCount; i++)
+        {
+            topHistogram[top[i].a]++;
+        }
+        stats.m_topAlphaCoverage = ComputeAlphaCoverage(topHistogram, topTexelCount, 1.f, settings.m_alphaCoverageCutoff);
+    }
+
+    for (int level = 1; level < levelCount; level++)
+    {
+        ImageMipLevel const& srcLevel = out.m_levels[level - 1];
+        ImageMipLevel const& dstLevel = out.m_levels[level];
+        Rgba8* dst = out.m_texels.data() + dstLevel.m_firstTexel;
+        FilterMipLevel(out.m_texels.data() + srcLevel.m_firstTexel, srcLevel.m_dimensions, dst, dstLevel.m_dimensions, settings);
+
+        if (settings.m_preserveAlphaCoverage)
+        {
+            uint64_t levelTexelCount = (uint64_t)dstLevel.m_dimensions.x * (uint64_t)dstLevel.m_dimensions.y;
+            float coverage = PreserveAlphaCoverage(dst, levelTexelCount, settings.m_alphaCoverageCutoff, stats.m_topAlphaCoverage);
+            // 几个 texel 的 level 本来就凑不出目标比例，不算进误差
+            if (levelTexelCount >= 64)
+                stats.m_maxAlphaCoverageError = std::max(stats.m_maxAlphaCoverageError, fabsf(coverage - stats.m_topAlphaCoverage));
+        }
+    }
+
+    stats.m_levelCount = (uint32_t)levelCount;
+    stats.m_texelCount = texelCount;
+    stats.m_buildMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+    if (outStats)
+        *outStats = stats;
+}
+
+//-----------------------------------------------------------------------------------------------
+uint64_t ComputeImageMipCookKey(std::string const& imageFilePath, ImageMipSettings const& settings, uint32_t extraKey)
+{
+    ImageMipCookSettings cookSettings;
+    cookSettings.m_filter = (uint32_t)settings.m_filter;
+    cookSettings.m_isSRGB = settings.m_isSRGB ? 1 : 0;
+    cookSettings.m_isNormalMap = settings.m_isNormalMap ? 1 : 0;
+    cookSettings.m_preserveAlphaCoverage = settings.m_preserveAlphaCoverage ? 1 : 0;
+    cookSettings.m_alphaCoverageCutoff = settings.m_alphaCoverageCutoff;
+    cookSettings.m_kaiserWidth = settings.m_kaiserWidth;
+    cookSettings.m_kaiserAlpha = settings.m_kaiserAlpha;
+    cookSettings.m_kaiserStretch = settings.m_kaiserStretch;
+    cookSettings.m_maxLevelCount = settings.m_maxLevelCount;
+    cookSettings.m_extraKey = extraKey;
+    return ComputeCookedSourceKey({ imageFilePath }, &cookSettings, sizeof(cookSettings));
+}
+
+std::string GetImageMipCookPath(std::string const& imageFilePath)
+{
+    return imageFilePath + ".mips";
+}
+
+uint64_t SaveCookedImageMipChain(std::string const& path, uint64_t cookKey, ImageMipChain const& chain)
+{
+    CookedMeshWriter writer;
+    writer.AddSection(CookedMeshSection::MIP_LEVELS, chain.m_levels);
+    writer.AddSection(CookedMeshSection::MIP_TEXELS, chain.m_texels);
+    return writer.Save(path, cookKey);
+}
+
+bool LoadCookedImageMipChain(std::string const& path, uint64_t cookKey, ImageMipChain& out, int firstLevel)
+{
+    CookedMeshFile file;
+    if (!file.Open(path, cookKey))
+        return false;
+
+    ImageMipChain chain;
+    uint64_t texelCount = 0;
+    Rgba8 const* texels = file.GetSection<Rgba8>(CookedMeshSection::MIP_TEXELS, texelCount);
+    if (!file.CopySection(CookedMeshSection::MIP_LEVELS, chain.m_levels) || !texels || chain.m_levels.empty() ||
+        firstLevel < 0 || firstLevel >= chain.GetLevelCount())
+        return false;
+
+    // level 表和 texel 数对不上的当成坏文件
+    ImageMipLevel const& last = chain.m_levels.back();
+    if (last.m_firstTexel + (uint64_t)last.m_dimensions.x * (uint64_t)last.m_dimensions.y != texelCount)
+        return false;
+
+    // 只拷要的 level，前面的页根本不会被读进来
+    uint64_t baseTexel = chain.m_levels[firstLevel].m_firstTexel;
+    chain.m_texels.assign(texels + baseTexel, texels + texelCount);
+    for (int level = 0; level < chain.GetLevelCount(); level++)
+        chain.m_levels[level].m_firstTexel = level < firstLevel ? 0 : chain.m_levels[level].m_firstTexel - baseTexel;
+    chain.m_firstLoadedLevel = firstLevel;
+    chain.m_name = out.m_name;
+    out = std::move(chain);
+    return true;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "Engine/Core/Image.hpp"
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Math/IntVec2.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//==============================================================================
+// ImageMipChain - CPU 生成 RGBA8 mip chain，上传时一次给齐所有 level
+//==============================================================================
+// BuildImageMipChain, level by level (each level from the one above it):
+//   1. decode     source rows -> linear float RGBA (sRGB through a LUT, normal maps to [-1, 1])
+//   2. filter     separable: horizontal pass per source row, vertical pass per output row,
+//                 one SSE register per texel. Box = exact area weights (odd sizes included),
+//                 Kaiser = Kaiser-windowed sinc, weights may go negative and are clamped
+//   3. encode     linear -> sRGB through a LUT, normal maps renormalized
+//   4. coverage   optional: alpha scaled so the fraction of texels above the cutoff matches
+//                 level 0 (alpha-tested foliage / fences don't thin out with distance)
+// Steps 1-3 run ParallelFor over bands of MIP_ROWS_PER_BAND output rows.
+//
+// The chain is plain data: m_texels holds every level back to back, top level first. Cooked
+// chains live in the CookedMesh container (MIP_LEVELS / MIP_TEXELS) next to the image.
+//==============================================================================
+
+static constexpr int MIP_ROWS_PER_BAND = 16;
+
+enum class MipFilter : uint32_t
+{
+    BOX,
+    KAISER
+};
+
+struct ImageMipSettings
+{
+    MipFilter m_filter = MipFilter::BOX;
+    bool m_isSRGB = true;                       // filter in linear space; off for data textures
+    bool m_isNormalMap = false;                 // rgb = xyz * 0.5 + 0.5, renormalized per level (implies linear)
+    bool m_preserveAlphaCoverage = false;
+    float m_alphaCoverageCutoff = 0.5f;         // alpha test reference
+    float m_kaiserWidth = 3.f;                  // filter radius, in texels of the smaller level
+    float m_kaiserAlpha = 4.f;
+    float m_kaiserStretch = 1.f;
+    int m_maxLevelCount = 0;                    // 0 = down to 1x1
+};
+
+struct ImageMipLevel
+{
+    IntVec2 m_dimensions;
+    uint64_t m_firstTexel = 0;                  // into ImageMipChain::m_texels
+};
+
+struct ImageMipStats
+{
+    uint32_t m_levelCount = 0;
+    uint64_t m_texelCount = 0;                  // all levels
+    float m_topAlphaCoverage = 0.f;             // only with m_preserveAlphaCoverage
+    float m_maxAlphaCoverageError = 0.f;        // over levels of at least 64 texels
+    double m_buildMilliseconds = 0.0;
+};
+
+struct ImageMipChain
+{
+    std::string m_name;
+    std::vector<ImageMipLevel> m_levels;
+    std::vector<Rgba8> m_texels;
+    int m_firstLoadedLevel = 0;                 // levels before it have dimensions but no texels (partial cook read)
+
+    bool IsValid() const { return !m_levels.empty(); }
+    int GetLevelCount() const { return (int)m_levels.size(); }
+    IntVec2 GetDimensions(int level = 0) const { return m_levels[level].m_dimensions; }
+    Rgba8 const* GetLevelTexels(int level) const { return m_texels.data() + m_levels[level].m_firstTexel; }
+    uint64_t GetTotalBytes() const { return m_texels.size() * sizeof(Rgba8); }
+    Image GetLevelImage(int level) const;
+};
+
+// floor(log2(max(x, y))) + 1
+int GetFullMipLevelCount(IntVec2 const& dimensions);
+
+void BuildImageMipChain(Image const& image, ImageMipChain& out, ImageMipSettings const& settings = ImageMipSettings(), ImageMipStats* outStats = nullptr);
+
+// key over the source image file + settings (+ extraKey, e.g. the backend's V flip)
+uint64_t ComputeImageMipCookKey(std::string const& imageFilePath, ImageMipSettings const& settings, uint32_t extraKey = 0);
+std::string GetImageMipCookPath(std::string const& imageFilePath);
+uint64_t SaveCookedImageMipChain(std::string const& path, uint64_t cookKey, ImageMipChain const& chain);
+// firstLevel > 0 copies only levels firstLevel.. out of the mapping (texture residency stream-in)
+bool LoadCookedImageMipChain(std::string const& path, uint64_t cookKey, ImageMipChain& out, int firstLevel = 0);
@@ -0,0 +1,178 @@
+#include "LZCompression.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr size_t LZ_MIN_MATCH = 4;
+    constexpr size_t LZ_LAST_LITERALS = 5;       // 块的最后 5 个字节一定是 literal
+    constexpr size_t LZ_MATCH_START_LIMIT = 12;  // 最后 12 个字节里不开始新的 match
+    constexpr size_t LZ_MAX_OFFSET = 65535;
+    constexpr uint32_t LZ_HASH_BITS = 16;
+
+    uint32_t ReadLZSequence(uint8_t const* bytes)
+    {
+        uint32_t sequence;
+        memcpy(&sequence, bytes, sizeof(sequence));
+        return sequence;
+    }
+
+    uint32_t HashLZSequence(uint32_t sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+    }
+
+    void WriteLZLength(std::vector<uint8_t>& out, size_t length)
+    {
+        for (; length >= 255; length -= 255)
+        {
+            out.push_back(255);
+        }
+        out.push_back((uint8_t)length);
+    }
+
+    // matchLength 0 = the last sequence, literals only
+    void WriteLZSequence(std::vector<uint8_t>& out, uint8_t const* literals, size_t literalCount, size_t matchLength, size_t offset)
+    {
+        size_t matchCode = matchLength > 0 ? matchLength - LZ_MIN_MATCH : 0;
+        out.push_back((uint8_t)((std::min(literalCount, (size_t)15) << 4) | std::min(matchCode, (size_t)15)));
+        if (literalCount >= 15)
+            WriteLZLength(out, literalCount - 15);
+        out.insert(out.end(), literals, literals + literalCount);
+        if (matchLength == 0)
+            return;
+
+        out.push_back((uint8_t)(offset & 0xFF));
+        out.push_back((uint8_t)(offset >> 8));
+        if (matchCode >= 15)
+            WriteLZLength(out, matchCode - 15);
+    }
+
+    bool ReadLZLength(uint8_t const*& in, uint8_t const* inEnd, size_t& length)
+    {
+        uint8_t value = 0;
+        do
+        {
+            if (in == inEnd)
+                return false;
+            value = *in++;
+            length += value;
+        } while (value == 255);
+        return true;
+    }
+}
+
+size_t GetLZCompressBound(size_t srcSize)
+{
+    return srcSize + srcSize / 255 + 16;
+}
+
+bool CompressLZ(uint8_t const* src, size_t srcSize, std::vector<uint8_t>& outCompressed)
+{
+    outCompressed.clear();
+    if (!src || srcSize == 0)
+        return false;
+    outCompressed.reserve(GetLZCompressBound(srcSize));
+
+    size_t anchor = 0;
+    if (srcSize > LZ_MATCH_START_LIMIT)
+    {
+        // 表里没填的槽是 0，靠比较 4 个字节排除
+        std::vector<uint32_t> table((size_t)1 << LZ_HASH_BITS, 0);
+        size_t const startLimit = srcSize - LZ_MATCH_START_LIMIT;
+        size_t const matchLimit = srcSize - LZ_LAST_LITERALS;
+        size_t pos = 0;
+        while (pos < startLimit)
+        {
+            uint32_t sequence = ReadLZSequence(src + pos);
+            uint32_t& slot = table[HashLZSequence(sequence)];
+            size_t candidate = slot;
+            slot = (uint32_t)pos;
+            if (candidate >= pos || pos - candidate > LZ_MAX_OFFSET || ReadLZSequence(src + candidate) != sequence)
+            {
+                // 不好压的数据越往后跳得越快
+                pos += 1 + ((pos - anchor) >> 6);
+                continue;
+            }
+
+            while (pos > anchor && candidate > 0 && src[pos - 1] == src[candidate - 1])
+            {
+                pos--;
+                candidate--;
+            }
+            size_t length = LZ_MIN_MATCH;
+            while (pos + length < matchLimit && src[pos + length] == src[candidate + length])
+            {
+                length++;
+            }
+            WriteLZSequence(outCompressed, src + anchor, pos - anchor, length, pos - candidate);
+            pos += length;
+            anchor = pos;
+            if (pos - 2 < startLimit)
+                table[HashLZSequence(ReadLZSequence(src + pos - 2))] = (uint32_t)(pos - 2);
+        }
+    }
+    WriteLZSequence(outCompressed, src + anchor, srcSize - anchor, 0, 0);
+    return true;
+}
+
+bool DecompressLZ(uint8_t const* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+{
+    uint8_t const* in = src;
+    uint8_t const* inEnd = src + srcSize;
+    uint8_t* out = dst;
+    uint8_t* outEnd = dst + dstSize;
+    while (in < inEnd)
+    {
+        uint8_t token = *in++;
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !ReadLZLength(in, inEnd, literalCount))
+            return false;
+        if (literalCount > (size_t)(inEnd - in) || literalCount > (size_t)(outEnd - out))
+            return false;
+        // 短 literal 直接拷 16 字节，多出来的会被后面覆盖
+        if (literalCount <= 16 && inEnd - in >= 16 && outEnd - out >= 16)
+            memcpy(out, in, 16);
+        else
+            memcpy(out, in, literalCount);
+        in += literalCount;
+        out += literalCount;
+        if (in == inEnd)
+            break;
+
+        if (inEnd - in < 2)
+            return false;
+        size_t offset = (size_t)in[0] | ((size_t)in[1] << 8);
+        in += 2;
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !ReadLZLength(in, inEnd, matchLength))
+            return false;
+        matchLength += LZ_MIN_MATCH;
+        if (offset == 0 || offset > (size_t)(out - dst) || matchLength > (size_t)(outEnd - out))
+            return false;
+
+        // offset >= 8 时 8 字节一拷，源永远在已经写好的部分；更小的 offset 是重复前面一段（RLE），逐字节拷
+        uint8_t const* match = out - offset;
+        if (offset >= 8 && (size_t)(outEnd - out) >= matchLength + 8)
+        {
+            for (size_t i = 0; i < matchLength; i += 8)
+            {
+                memcpy(out + i, match + i, 8);
+            }
+        }
+        else if (offset >= matchLength)
+        {
+            memcpy(out, match, matchLength);
+        }
+        else
+        {
+            for (size_t i = 0; i < matchLength; i++)
+            {
+                out[i] = match[i];
+            }
+        }
+        out += matchLength;
+    }
+    return out == outEnd;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//==============================================================================
+// LZCompression - LZ4 block 格式的压缩 / 解压，给 AssetPack 用（解压要快，压缩离线做）
+//==============================================================================
+// The output is a plain LZ4 block (no frame, no checksum), so lz4 tools can read it:
+//   token (literal length << 4 | match length - 4), literals, 16-bit offset, extra length bytes
+// Greedy matcher over a 64K-entry hash table of 4-byte sequences; decoding is bounds checked
+// and never writes past dstSize, so a corrupt pack fails the read instead of the process.
+//==============================================================================
+
+// worst case for incompressible input
+size_t GetLZCompressBound(size_t srcSize);
+
+// false for an empty src; otherwise outCompressed holds the whole block
+bool CompressLZ(uint8_t const* src, size_t srcSize, std::vector<uint8_t>& outCompressed);
+
+// dstSize must be the exact decompressed size (stored by the caller)
+bool DecompressLZ(uint8_t const* src, size_t srcSize, uint8_t* dst, size_t dstSize);
@@ -0,0 +1,134 @@
+#include "Engine/Core/MappedFile.h"
+#include "Engine/Core/VirtualFileSystem.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(std::string const& fileName)
+{
+    Close();
+    std::shared_ptr<AssetPack const> pack;
+    AssetPackEntry const* entry = FindMountedFile(fileName, pack);
+    if (!entry)
+        return OpenOnDisk(fileName);
+    if (entry->m_size == 0)
+        return false;
+
+    m_data = pack->GetEntryData(*entry);
+    if (!m_data)
+    {
+        // 包坏了就退回散文件
+        if (!pack->ReadEntry(*entry, m_unpackedBytes))
+            return OpenOnDisk(fileName);
+        m_data = m_unpackedBytes.data();
+    }
+    m_size = (size_t)entry->m_size;
+    m_pack = std::move(pack);
+    return true;
+}
+
+#ifdef _WIN32
+bool MappedFile::OpenOnDisk(std::string const& fileName)
+{
+    Close();
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+    m_data = (uint8_t const*)view;
+    m_size = (size_t)fileSize.QuadPart;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data && m_mappingHandle)
+        UnmapViewOfFile(m_data);
+    if (m_mappingHandle)
+        CloseHandle((HANDLE)m_mappingHandle);
+    if (m_fileHandle)
+        CloseHandle((HANDLE)m_fileHandle);
+    m_data = nullptr;
+    m_size = 0;
+    m_fileHandle = nullptr;
+    m_mappingHandle = nullptr;
+    m_pack.reset();
+    m_unpackedBytes = std::vector<uint8_t>();
+}
+#else
+bool MappedFile::OpenOnDisk(std::string const& fileName)
+{
+    Close();
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED)
+    {
+        close(fd);
+        return false;
+    }
+
+    m_fileHandle = (void*)(intptr_t)(fd + 1);
+    m_data = (uint8_t const*)view;
+    m_size = (size_t)fileStat.st_size;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data && m_fileHandle)
+        munmap((void*)m_data, m_size);
+    if (m_fileHandle)
+        close((int)(intptr_t)m_fileHandle - 1);
+    m_data = nullptr;
+    m_size = 0;
+    m_fileHandle = nullptr;
+    m_pack.reset();
+    m_unpackedBytes = std::vector<uint8_t>();
+}
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class AssetPack;
+
+//-----------------------------------------------------------------------------------------------
+// Read-only memory mapping of a whole file, so cooked data can be used in place without a
+// read + parse. Open() fails on a missing or empty file; callers then take their slow path.
+// Open() looks in the mounted asset packs first (VirtualFileSystem.h): an uncompressed entry
+// points straight into the pack's mapping, a compressed one is decompressed into the MappedFile.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile const& copy) = delete;
+    MappedFile& operator=(MappedFile const& copy) = delete;
+
+    bool Open(std::string const& fileName);
+    bool OpenOnDisk(std::string const& fileName);     // skips the mounted packs
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    uint8_t const* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    uint8_t const* m_data = nullptr;
+    size_t m_size = 0;
+    void* m_fileHandle = nullptr;        // HANDLE on Windows, fd + 1 elsewhere
+    void* m_mappingHandle = nullptr;
+    std::shared_ptr<AssetPack const> m_pack;    // keeps a packed entry's mapping alive
+    std::vector<uint8_t> m_unpackedBytes;       // compressed entry
+};
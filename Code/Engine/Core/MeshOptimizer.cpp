@@ -0,0 +1,500 @@
+#include "MeshOptimizer.h"
+
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace
+{
+    //-------------------------------------------------------------------------------------------
+    // Weld
+    static constexpr int VERTEX_KEY_WORDS = 15;
+
+    void GetVertexKey(Vertex_PCUTBN const& v, uint32_t* key)
+    {
+        key[0] = CanonicalFloatBits(v.m_position.x);
+        key[1] = CanonicalFloatBits(v.m_position.y);
+        key[2] = CanonicalFloatBits(v.m_position.z);
+        key[3] = (uint32_t)v.m_color.r | ((uint32_t)v.m_color.g << 8) | ((uint32_t)v.m_color.b << 16) | ((uint32_t)v.m_color.a << 24);
+        key[4] = CanonicalFloatBits(v.m_uvTexCoords.x);
+        key[5] = CanonicalFloatBits(v.m_uvTexCoords.y);
+        key[6] = CanonicalFloatBits(v.m_tangent.x);
+        key[7] = CanonicalFloatBits(v.m_tangent.y);
+        key[8] = CanonicalFloatBits(v.m_tangent.z);
+        key[9] = CanonicalFloatBits(v.m_bitangent.x);
+        key[10] = CanonicalFloatBits(v.m_bitangent.y);
+        key[11] = CanonicalFloatBits(v.m_bitangent.z);
+        key[12] = CanonicalFloatBits(v.m_normal.x);
+        key[13] = CanonicalFloatBits(v.m_normal.y);
+        key[14] = CanonicalFloatBits(v.m_normal.z);
+    }
+
+    //-------------------------------------------------------------------------------------------
+    // Forsyth vertex cache scoring
+    static constexpr int FORSYTH_CACHE_SIZE = 32;
+    static constexpr int FORSYTH_MAX_VALENCE = 32;
+
+    struct ForsythTables
+    {
+        float m_cacheScore[FORSYTH_CACHE_SIZE + 3] = {};
+        float m_valenceScore[FORSYTH_MAX_VALENCE + 1] = {};
+
+        ForsythTables()
+        {
+            for (int i = 0; i < FORSYTH_CACHE_SIZE + 3; i++)
+            {
+                if (i < 3)
+                    m_cacheScore[i] = 0.75f;       // 刚用过的三个不偏向任何一个，避免来回跳
+                else if (i < FORSYTH_CACHE_SIZE)
+                    m_cacheScore[i] = powf(1.f - (float)(i - 3) / (float)(FORSYTH_CACHE_SIZE - 3), 1.5f);
+                else
+                    m_cacheScore[i] = 0.f;
+            }
+            for (int i = 1; i <= FORSYTH_MAX_VALENCE; i++)
+            {
+                m_valenceScore[i] = 2.f / sqrtf((float)i);
+            }
+        }
+
+        float GetVertexScore(int cachePosition, uint32_t liveTriangles) const
+        {
+            if (liveTriangles == 0)
+                return -1.f;
+            float score = (cachePosition >= 0) ? m_cacheScore[cachePosition] : 0.f;
+            score += (liveTriangles <= FORSYTH_MAX_VALENCE) ? m_valenceScore[liveTriangles] : 2.f / sqrtf((float)liveTriangles);
+            return score;
+        }
+    };
+
+    //-------------------------------------------------------------------------------------------
+    // FIFO 模拟：timestamp - cachedAt < cacheSize 就算命中
+    struct FifoCache
+    {
+        std::vector<uint32_t> m_cachedAt;
+        uint32_t m_timestamp;
+        uint32_t m_cacheSize;
+
+        FifoCache(uint32_t vertexCount, uint32_t cacheSize)
+            : m_cachedAt(vertexCount, 0)
+            , m_timestamp(cacheSize + 1)
+            , m_cacheSize(cacheSize)
+        {
+        }
+
+        void Reset() { m_timestamp += m_cacheSize + 1; }
+
+        bool Touch(unsigned int vertex)
+        {
+            if (m_timestamp - m_cachedAt[vertex] > m_cacheSize)
+            {
+                m_cachedAt[vertex] = m_timestamp++;
+                return false;
+            }
+            return true;
+        }
+
+        uint32_t TouchTriangle(unsigned int const* tri)
+        {
+            uint32_t misses = 0;
+            for (int k = 0; k < 3; k++)
+            {
+                if (!Touch(tri[k]))
+                    misses++;
+            }
+            return misses;
+        }
+    };
+}
+
+//-----------------------------------------------------------------------------------------------
+uint32_t WeldVertices(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices)
+{
+    size_t vertexCount = verts.size();
+    if (vertexCount == 0)
+        return 0;
+
+    size_t tableSize = 1;
+    while (tableSize < vertexCount * 2)
+        tableSize <<= 1;
+    std::vector<uint32_t> table(tableSize, UINT32_MAX);
+    std::vector<uint32_t> keys(vertexCount * VERTEX_KEY_WORDS);
+    std::vector<unsigned int> remap(vertexCount);
+    std::vector<Vertex_PCUTBN> welded;
+    welded.reserve(vertexCount);
+
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        uint32_t* key = &keys[v * VERTEX_KEY_WORDS];
+        GetVertexKey(verts[v], key);
+
+        uint64_t hash = 0x9E3779B97F4A7C15ull;
+        for (int w = 0; w < VERTEX_KEY_WORDS; w++)
+        {
+            hash = MixHash(hash, key[w]);
+        }
+        size_t slot = (size_t)FinalizeHash(hash) & (tableSize - 1);
+
+        // linear probing；表里存的是 welded 之后的下标
+        for (;;)
+        {
+            uint32_t entry = table[slot];
+            if (entry == UINT32_MAX)
+            {
+                table[slot] = (uint32_t)welded.size();
+                remap[v] = (unsigned int)welded.size();
+                if (welded.size() != v)
+                    memcpy(&keys[welded.size() * VERTEX_KEY_WORDS], key, sizeof(uint32_t) * VERTEX_KEY_WORDS);
+                welded.push_back(verts[v]);
+                break;
+            }
+            if (memcmp(&keys[(size_t)entry * VERTEX_KEY_WORDS], key, sizeof(uint32_t) * VERTEX_KEY_WORDS) == 0)
+            {
+                remap[v] = entry;
+                break;
+            }
+            slot = (slot + 1) & (tableSize - 1);
+        }
+    }
+
+    for (unsigned int& index : indices)
+    {
+        index = remap[index];
+    }
+
+    uint32_t removed = (uint32_t)(vertexCount - welded.size());
+    verts.swap(welded);
+    return removed;
+}
+
+//-----------------------------------------------------------------------------------------------
+void OptimizeVertexCache(std::vector<unsigned int>& indices, uint32_t vertexCount)
+{
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0)
+        return;
+
+    static ForsythTables const s_tables;
+
+    // vertex -> live triangles
+    std::vector<uint32_t> liveCount(vertexCount, 0);
+    for (unsigned int index : indices)
+    {
+        liveCount[index]++;
+    }
+    std::vector<uint32_t> adjacencyStart(vertexCount + 1, 0);
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        adjacencyStart[v + 1] = adjacencyStart[v] + liveCount[v];
+    }
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+        for (size_t t = 0; t < triangleCount; t++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                adjacency[fill[indices[t * 3 + k]]++] = (uint32_t)t;
+            }
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        vertexScore[v] = s_tables.GetVertexScore(-1, liveCount[v]);
+    }
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+    }
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    unsigned int cache[FORSYTH_CACHE_SIZE + 3];
+    int cacheCount = 0;
+    size_t nextUnemitted = 0;
+
+    int64_t bestTriangle = 0;
+    for (size_t t = 1; t < triangleCount; t++)
+    {
+        if (triangleScore[t] > triangleScore[(size_t)bestTriangle])
+            bestTriangle = (int64_t)t;
+    }
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+    {
+        if (bestTriangle < 0)
+        {
+            // cache 里没有剩余的三角形了：按原顺序找下一个，开一个新的 strip
+            while (emitted[nextUnemitted])
+                nextUnemitted++;
+            bestTriangle = (int64_t)nextUnemitted;
+        }
+
+        size_t tri = (size_t)bestTriangle;
+        unsigned int const* triVerts = &indices[tri * 3];
+        output.push_back(triVerts[0]);
+        output.push_back(triVerts[1]);
+        output.push_back(triVerts[2]);
+        emitted[tri] = 1;
+
+        // 从三个顶点的 live 列表里拿掉这个三角形
+        for (int k = 0; k < 3; k++)
+        {
+            unsigned int v = triVerts[k];
+            uint32_t* begin = &adjacency[adjacencyStart[v]];
+            uint32_t count = liveCount[v];
+            for (uint32_t i = 0; i < count; i++)
+            {
+                if (begin[i] == tri)
+                {
+                    begin[i] = begin[count - 1];
+                    break;
+                }
+            }
+            liveCount[v]--;
+        }
+
+        // LRU：新三角形的顶点放最前面
+        unsigned int newCache[FORSYTH_CACHE_SIZE + 3];
+        int newCount = 0;
+        for (int k = 0; k < 3; k++)
+        {
+            newCache[newCount++] = triVerts[k];
+        }
+        for (int i = 0; i < cacheCount; i++)
+        {
+            unsigned int v = cache[i];
+            if (v != triVerts[0] && v != triVerts[1] && v != triVerts[2])
+                newCache[newCount++] = v;
+        }
+
+        for (int i = 0; i < newCount; i++)
+        {
+            unsigned int v = newCache[i];
+            cachePosition[v] = (i < FORSYTH_CACHE_SIZE) ? i : -1;
+            vertexScore[v] = s_tables.GetVertexScore(cachePosition[v], liveCount[v]);
+        }
+
+        bestTriangle = -1;
+        float bestScore = -1.f;
+        for (int i = 0; i < newCount; i++)
+        {
+            unsigned int v = newCache[i];
+            uint32_t const* begin = &adjacency[adjacencyStart[v]];
+            for (uint32_t a = 0; a < liveCount[v]; a++)
+            {
+                uint32_t t = begin[a];
+                float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+                triangleScore[t] = score;
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    bestTriangle = (int64_t)t;
+                }
+            }
+        }
+
+        cacheCount = (newCount < FORSYTH_CACHE_SIZE) ? newCount : FORSYTH_CACHE_SIZE;
+        memcpy(cache, newCache, sizeof(unsigned int) * (size_t)cacheCount);
+    }
+
+    indices.swap(output);
+}
+
+//-----------------------------------------------------------------------------------------------
+uint32_t OptimizeOverdraw(std::vector<unsigned int>& indices, std::vector<Vertex_PCUTBN> const& verts, float threshold)
+{
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return 0;
+
+    uint32_t vertexCount = (uint32_t)verts.size();
+
+    // hard boundaries：三个顶点全 miss 的地方 cache 本来就断了
+    std::vector<size_t> hardClusters;
+    {
+        FifoCache cache(vertexCount, MESH_OPT_ANALYZE_CACHE_SIZE);
+        for (size_t t = 0; t < triangleCount; t++)
+        {
+            if (cache.TouchTriangle(&indices[t * 3]) == 3 || t == 0)
+                hardClusters.push_back(t);
+        }
+    }
+    hardClusters.push_back(triangleCount);
+
+    // soft boundaries：在 hard cluster 内部，局部 ACMR 已经不比整段差太多就切
+    std::vector<size_t> clusters;
+    FifoCache cache(vertexCount, MESH_OPT_ANALYZE_CACHE_SIZE);
+    for (size_t c = 0; c + 1 < hardClusters.size(); c++)
+    {
+        size_t start = hardClusters[c];
+        size_t end = hardClusters[c + 1];
+
+        cache.Reset();
+        uint32_t clusterMisses = 0;
+        for (size_t t = start; t < end; t++)
+        {
+            clusterMisses += cache.TouchTriangle(&indices[t * 3]);
+        }
+        float clusterAcmr = (float)clusterMisses / (float)(end - start);
+
+        clusters.push_back(start);
+        cache.Reset();
+        uint32_t misses = 0;
+        size_t runStart = start;
+        for (size_t t = start; t < end; t++)
+        {
+            misses += cache.TouchTriangle(&indices[t * 3]);
+            size_t runLength = t + 1 - runStart;
+            if (t + 1 < end && runLength >= 8 && (float)misses <= threshold * clusterAcmr * (float)runLength)
+            {
+                clusters.push_back(t + 1);
+                runStart = t + 1;
+                misses = 0;
+                cache.Reset();
+            }
+        }
+    }
+    size_t clusterCount = clusters.size();
+    clusters.push_back(triangleCount);
+
+    // cluster 的面积加权中心 / 法线
+    struct ClusterSortKey
+    {
+        float m_key;
+        size_t m_cluster;
+    };
+    std::vector<Vec3> centroids(clusterCount);
+    std::vector<Vec3> normals(clusterCount);
+    Vec3 meshCentroid;
+    float meshArea = 0.f;
+    for (size_t c = 0; c < clusterCount; c++)
+    {
+        Vec3 centroid;
+        Vec3 normal;
+        float area = 0.f;
+        for (size_t t = clusters[c]; t < clusters[c + 1]; t++)
+        {
+            Vec3 const& a = verts[indices[t * 3]].m_position;
+            Vec3 const& b = verts[indices[t * 3 + 1]].m_position;
+            Vec3 const& d = verts[indices[t * 3 + 2]].m_position;
+            Vec3 cross = CrossProduct3D(b - a, d - a);
+            float triArea = cross.GetLength();
+            centroid += (a + b + d) * (triArea / 3.f);
+            normal += cross;
+            area += triArea;
+        }
+        meshCentroid += centroid;
+        meshArea += area;
+        centroids[c] = (area > 0.f) ? centroid / area : verts[indices[clusters[c] * 3]].m_position;
+        normals[c] = normal;
+    }
+    if (meshArea > 0.f)
+        meshCentroid /= meshArea;
+
+    std::vector<ClusterSortKey> keys(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++)
+    {
+        float normalLength = normals[c].GetLength();
+        keys[c].m_key = (normalLength > 0.f) ? DotProduct3D(centroids[c] - meshCentroid, normals[c] / normalLength) : 0.f;
+        keys[c].m_cluster = c;
+    }
+    // 朝外的先画，挡住后面朝内的
+    std::stable_sort(keys.begin(), keys.end(), [](ClusterSortKey const& a, ClusterSortKey const& b)
+    {
+        return a.m_key > b.m_key;
+    });
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    for (ClusterSortKey const& key : keys)
+    {
+        size_t c = key.m_cluster;
+        output.insert(output.end(), indices.begin() + (ptrdiff_t)(clusters[c] * 3), indices.begin() + (ptrdiff_t)(clusters[c + 1] * 3));
+    }
+    indices.swap(output);
+    return (uint32_t)clusterCount;
+}
+
+//-----------------------------------------------------------------------------------------------
+void OptimizeVertexFetch(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices)
+{
+    std::vector<unsigned int> remap(verts.size(), UINT32_MAX);
+    std::vector<Vertex_PCUTBN> reordered;
+    reordered.reserve(verts.size());
+
+    for (unsigned int& index : indices)
+    {
+        if (remap[index] == UINT32_MAX)
+        {
+            remap[index] = (unsigned int)reordered.size();
+            reordered.push_back(verts[index]);
+        }
+        index = remap[index];
+    }
+    // 没被引用的顶点直接丢掉
+    verts.swap(reordered);
+}
+
+//-----------------------------------------------------------------------------------------------
+VertexCacheStats AnalyzeVertexCache(std::vector<unsigned int> const& indices, uint32_t vertexCount, uint32_t cacheSize)
+{
+    VertexCacheStats stats;
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0)
+        return stats;
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<uint8_t> used(vertexCount, 0);
+    uint32_t misses = 0;
+    uint32_t uniqueVerts = 0;
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        misses += cache.TouchTriangle(&indices[t * 3]);
+        for (int k = 0; k < 3; k++)
+        {
+            unsigned int v = indices[t * 3 + k];
+            if (!used[v])
+            {
+                used[v] = 1;
+                uniqueVerts++;
+            }
+        }
+    }
+
+    stats.m_acmr = (float)misses / (float)triangleCount;
+    stats.m_atvr = (float)misses / (float)uniqueVerts;
+    return stats;
+}
+
+MeshOptimizationReport OptimizeMesh(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices, MeshOptimizationConfig const& config)
+{
+    double startTime = GetCurrentTimeSeconds();
+
+    MeshOptimizationReport report;
+    report.m_triangleCount = (uint32_t)(indices.size() / 3);
+    report.m_vertexCountBefore = (uint32_t)verts.size();
+    report.m_before = AnalyzeVertexCache(indices, (uint32_t)verts.size());
+
+    if (config.m_weldVertices)
+        WeldVertices(verts, indices);
+    if (config.m_optimizeVertexCache)
+        OptimizeVertexCache(indices, (uint32_t)verts.size());
+    if (config.m_optimizeVertexCache && config.m_optimizeOverdraw)
+        report.m_overdrawClusterCount = OptimizeOverdraw(indices, verts, config.m_overdrawThreshold);
+    if (config.m_optimizeVertexFetch)
+        OptimizeVertexFetch(verts, indices);
+
+    report.m_vertexCountAfter = (uint32_t)verts.size();
+    report.m_after = AnalyzeVertexCache(indices, (uint32_t)verts.size());
+    report.m_milliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+    return report;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+//==============================================================================
+// MeshOptimizer - import 之后的 index / vertex 重排
+//==============================================================================
+// 1. WeldVertices: merge bit-identical verts (-0 == 0) through an open-addressing hash
+// 2. OptimizeVertexCache: Forsyth's linear-speed reordering for the post-transform cache
+// 3. OptimizeOverdraw: split the cache-ordered list into clusters (hard boundaries at
+//    cache flushes, soft ones while the cluster ACMR stays within the threshold) and
+//    draw outward-facing clusters first (Sander et al., "Fast Triangle Reordering")
+// 4. OptimizeVertexFetch: renumber verts in first-use order so the vertex stream is
+//    read linearly
+// None of it changes what is drawn: the triangle set and winding stay the same.
+//==============================================================================
+
+static constexpr uint32_t MESH_OPT_ANALYZE_CACHE_SIZE = 16;  // FIFO, roughly what current GPUs behave like
+
+struct MeshOptimizationConfig
+{
+    bool m_weldVertices = true;
+    bool m_optimizeVertexCache = true;
+    bool m_optimizeOverdraw = true;
+    bool m_optimizeVertexFetch = true;
+    float m_overdrawThreshold = 1.05f;   // allowed ACMR growth for the overdraw pass
+};
+
+struct VertexCacheStats
+{
+    float m_acmr = 0.f;                  // transformed verts per triangle (0.5 best, 3 worst)
+    float m_atvr = 0.f;                  // transformed verts per unique vertex (1 best)
+};
+
+struct MeshOptimizationReport
+{
+    uint32_t m_triangleCount = 0;
+    uint32_t m_vertexCountBefore = 0;
+    uint32_t m_vertexCountAfter = 0;
+    VertexCacheStats m_before;
+    VertexCacheStats m_after;            // of the final order: StaticMesh re-measures after BuildMeshlets
+    uint32_t m_overdrawClusterCount = 0;
+    double m_milliseconds = 0.0;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Hashing (also used by the OBJ importer's VertexKey)
+inline uint32_t CanonicalFloatBits(float value)
+{
+    if (value == 0.f)
+        return 0;                        // -0 和 0 相等，hash 也要一样
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline uint64_t MixHash(uint64_t hash, uint32_t value)
+{
+    hash ^= value;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+inline uint64_t FinalizeHash(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+//-----------------------------------------------------------------------------------------------
+// returns the number of verts removed
+uint32_t WeldVertices(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices);
+
+void OptimizeVertexCache(std::vector<unsigned int>& indices, uint32_t vertexCount);
+
+// indices must already be cache-optimized; returns the cluster count
+uint32_t OptimizeOverdraw(std::vector<unsigned int>& indices, std::vector<Vertex_PCUTBN> const& verts, float threshold);
+
+void OptimizeVertexFetch(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices);
+
+VertexCacheStats AnalyzeVertexCache(std::vector<unsigned int> const& indices, uint32_t vertexCount, uint32_t cacheSize = MESH_OPT_ANALYZE_CACHE_SIZE);
+
+MeshOptimizationReport OptimizeMesh(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices, MeshOptimizationConfig const& config = MeshOptimizationConfig());
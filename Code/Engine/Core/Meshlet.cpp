@@ -0,0 +1,323 @@
+#include "Meshlet.h"
+
+#include "Engine/Core/MeshOptimizer.h"
+#include "Engine/Math/Frustum.h"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <cfloat>
+#include <cmath>
+#include <unordered_map>
+
+namespace
+{
+    // 按位置焊接后的 id：flat shading 的面不共享顶点，但共享位置，邻接要按位置算
+    void BuildPositionIds(std::vector<Vertex_PCUTBN> const& verts, std::vector<uint32_t>& positionIds, uint32_t& positionCount)
+    {
+        struct PositionKey
+        {
+            uint32_t m_bits[3];
+            bool operator==(PositionKey const& other) const
+            {
+                return m_bits[0] == other.m_bits[0] && m_bits[1] == other.m_bits[1] && m_bits[2] == other.m_bits[2];
+            }
+        };
+        struct PositionKeyHasher
+        {
+            size_t operator()(PositionKey const& key) const
+            {
+                uint64_t hash = 0x9E3779B97F4A7C15ull;
+                hash = MixHash(hash, key.m_bits[0]);
+                hash = MixHash(hash, key.m_bits[1]);
+                hash = MixHash(hash, key.m_bits[2]);
+                return (size_t)FinalizeHash(hash);
+            }
+        };
+
+        std::unordered_map<PositionKey, uint32_t, PositionKeyHasher> ids;
+        ids.reserve(verts.size());
+        positionIds.resize(verts.size());
+        positionCount = 0;
+        for (size_t v = 0; v < verts.size(); v++)
+        {
+            Vec3 const& p = verts[v].m_position;
+            PositionKey key = { { CanonicalFloatBits(p.x), CanonicalFloatBits(p.y), CanonicalFloatBits(p.z) } };
+            auto inserted = ids.emplace(key, positionCount);
+            if (inserted.second)
+                positionCount++;
+            positionIds[v] = inserted.first->second;
+        }
+    }
+
+    uint32_t CountNewVertices(std::vector<int> const& localSlot, unsigned int const* tri)
+    {
+        uint32_t count = (localSlot[tri[0]] < 0) ? 1 : 0;
+        if (tri[1] != tri[0] && localSlot[tri[1]] < 0)
+            count++;
+        if (tri[2] != tri[0] && tri[2] != tri[1] && localSlot[tri[2]] < 0)
+            count++;
+        return count;
+    }
+
+    Vec3 GetTriangleCentroid(std::vector<Vertex_PCUTBN> const& verts, unsigned int const* tri)
+    {
+        return (verts[tri[0]].m_position + verts[tri[1]].m_position + verts[tri[2]].m_position) / 3.f;
+    }
+
+    void ComputeMeshletBounds(std::vector<Vertex_PCUTBN> const& verts, MeshletData const& data, unsigned int const* meshletIndices, Meshlet& meshlet)
+    {
+        Vec3 mins = Vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+        Vec3 maxs = Vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (uint32_t i = 0; i < meshlet.m_vertexCount; i++)
+        {
+            Vec3 const& p = verts[data.m_vertices[meshlet.m_vertexOffset + i]].m_position;
+            mins = Vec3(MinF(mins.x, p.x), MinF(mins.y, p.y), MinF(mins.z, p.z));
+            maxs = Vec3(MaxF(maxs.x, p.x), MaxF(maxs.y, p.y), MaxF(maxs.z, p.z));
+        }
+        meshlet.m_center = (mins + maxs) * 0.5f;
+        float radiusSq = 0.f;
+        for (uint32_t i = 0; i < meshlet.m_vertexCount; i++)
+        {
+            Vec3 const& p = verts[data.m_vertices[meshlet.m_vertexOffset + i]].m_position;
+            radiusSq = MaxF(radiusSq, (p - meshlet.m_center).GetLengthSquared());
+        }
+        meshlet.m_radius = sqrtf(radiusSq);
+
+        // normal cone：几何法线（CCW 为正面），不用顶点法线
+        std::vector<Vec3> normals;
+        normals.reserve(meshlet.m_triangleCount);
+        Vec3 axis;
+        for (uint32_t t = 0; t < meshlet.m_triangleCount; t++)
+        {
+            unsigned int const* tri = meshletIndices + t * 3;
+            Vec3 const& a = verts[tri[0]].m_position;
+            Vec3 normal = CrossProduct3D(verts[tri[1]].m_position - a, verts[tri[2]].m_position - a);
+            float length = normal.GetLength();
+            if (length <= 0.f)
+                continue;
+            normal /= length;
+            normals.push_back(normal);
+            axis += normal;
+        }
+
+        meshlet.m_coneAxis = Vec3();
+        meshlet.m_coneCutoff = 1.f;
+        float axisLength = axis.GetLength();
+        if (normals.empty() || axisLength <= 0.f)
+            return;
+        axis /= axisLength;
+
+        float minDot = 1.f;
+        for (Vec3 const& normal : normals)
+        {
+            minDot = MinF(minDot, DotProduct3D(normal, axis));
+        }
+        // 法线散得太开（接近半球）就不值得测了
+        if (minDot <= 0.1f)
+            return;
+
+        meshlet.m_coneAxis = axis;
+        meshlet.m_coneCutoff = sqrtf(1.f - minDot * minDot);
+    }
+}
+
+void BuildMeshlets(std::vector<Vertex_PCUTBN> const& verts, std::vector<unsigned int>& indices, MeshletData& out, uint32_t maxVertices, uint32_t maxTriangles)
+{
+    out = MeshletData();
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return;
+
+    maxVertices = (maxVertices > 255) ? 255 : maxVertices;   // local indices are uint8
+
+    std::vector<uint32_t> positionIds;
+    uint32_t positionCount = 0;
+    BuildPositionIds(verts, positionIds, positionCount);
+
+    // position -> triangles
+    std::vector<uint32_t> adjacencyStart(positionCount + 1, 0);
+    for (unsigned int index : indices)
+    {
+        adjacencyStart[positionIds[index] + 1]++;
+    }
+    for (uint32_t p = 0; p < positionCount; p++)
+    {
+        adjacencyStart[p + 1] += adjacencyStart[p];
+    }
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+        for (size_t t = 0; t < triangleCount; t++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                adjacency[fill[positionIds[indices[t * 3 + k]]]++] = (uint32_t)t;
+            }
+        }
+    }
+
+    std::vector<uint8_t> used(triangleCount, 0);
+    std::vector<int> localSlot(verts.size(), -1);
+    std::vector<unsigned int> reordered;
+    reordered.reserve(indices.size());
+    std::vector<unsigned int> localCorners;
+    out.m_localIndices.reserve(indices.size());
+    size_t cursor = 0;
+    size_t emitted = 0;
+
+    while (emitted < triangleCount)
+    {
+        Meshlet meshlet;
+        meshlet.m_vertexOffset = (uint32_t)out.m_vertices.size();
+        meshlet.m_triangleOffset = (uint32_t)(reordered.size() / 3);
+        Vec3 positionSum;
+
+        while (used[cursor])
+            cursor++;
+        int64_t current = (int64_t)cursor;
+
+        while (current >= 0)
+        {
+            unsigned int const* tri = &indices[(size_t)current * 3];
+            for (int k = 0; k < 3; k++)
+            {
+                unsigned int v = tri[k];
+                if (localSlot[v] < 0)
+                {
+                    localSlot[v] = (int)meshlet.m_vertexCount++;
+                    out.m_vertices.push_back(v);
+                    positionSum += verts[v].m_position;
+                }
+                out.m_localIndices.push_back((uint8_t)localSlot[v]);
+                reordered.push_back(v);
+            }
+            used[(size_t)current] = 1;
+            meshlet.m_triangleCount++;
+            emitted++;
+            if (meshlet.m_triangleCount >= maxTriangles)
+                break;
+
+            // 下一个：新增顶点最少的相邻三角形，其次离 meshlet 中心最近
+            Vec3 center = positionSum / (float)meshlet.m_vertexCount;
+            int64_t best = -1;
+            uint32_t bestNewVerts = 4;
+            float bestDistanceSq = FLT_MAX;
+            for (uint32_t i = 0; i < meshlet.m_vertexCount; i++)
+            {
+                uint32_t position = positionIds[out.m_vertices[meshlet.m_vertexOffset + i]];
+                for (uint32_t a = adjacencyStart[position]; a < adjacencyStart[position + 1]; a++)
+                {
+                    uint32_t t = adjacency[a];
+                    if (used[t])
+                        continue;
+                    unsigned int const* candidate = &indices[(size_t)t * 3];
+                    uint32_t newVerts = CountNewVertices(localSlot, candidate);
+                    if (meshlet.m_vertexCount + newVerts > maxVertices || newVerts > bestNewVerts)
+                        continue;
+                    float distanceSq = (GetTriangleCentroid(verts, candidate) - center).GetLengthSquared();
+                    if (newVerts < bestNewVerts || distanceSq < bestDistanceSq)
+                    {
+                        best = (int64_t)t;
+                        bestNewVerts = newVerts;
+                        bestDistanceSq = distanceSq;
+                    }
+                }
+            }
+
+            // 这块连通区域用完了：接着拿原顺序里的下一个（优化过的顺序本身就比较连贯）
+            if (best < 0)
+            {
+                while (cursor < triangleCount && used[cursor])
+                    cursor++;
+                if (cursor < triangleCount)
+                {
+                    if (meshlet.m_vertexCount + CountNewVertices(localSlot, &indices[cursor * 3]) <= maxVertices)
+                        best = (int64_t)cursor;
+                }
+            }
+            current = best;
+        }
+
+        for (uint32_t i = 0; i < meshlet.m_vertexCount; i++)
+        {
+            localSlot[out.m_vertices[meshlet.m_vertexOffset + i]] = -1;
+        }
+
+        // 贪心生长打乱了 OptimizeMesh 排好的顺序：meshlet 内部再按 vertex cache 排一次。
+        // 用 local id 排（< 256 个顶点），代价只跟 meshlet 大小有关
+        size_t firstCorner = (size_t)meshlet.m_triangleOffset * 3;
+        size_t cornerCount = (size_t)meshlet.m_triangleCount * 3;
+        localCorners.assign(out.m_localIndices.begin() + firstCorner, out.m_localIndices.begin() + firstCorner + cornerCount);
+        OptimizeVertexCache(localCorners, meshlet.m_vertexCount);
+        for (size_t c = 0; c < cornerCount; c++)
+        {
+            out.m_localIndices[firstCorner + c] = (uint8_t)localCorners[c];
+            reordered[firstCorner + c] = out.m_vertices[meshlet.m_vertexOffset + localCorners[c]];
+        }
+        ComputeMeshletBounds(verts, out, &reordered[(size_t)meshlet.m_triangleOffset * 3], meshlet);
+        out.m_meshlets.push_back(meshlet);
+
+        if (cursor >= triangleCount)
+            cursor = 0;
+    }
+
+    indices.swap(reordered);
+}
+
+//-----------------------------------------------------------------------------------------------
+void CullMeshlets(MeshletData const& meshlets, Mat44 const& modelToWorld, Frustum const& worldFrustum, Vec3 const& cameraWorldPosition,
+    std::vector<MeshletIndexRange>& outRanges, MeshletCullStats& stats)
+{
+    outRanges.clear();
+
+    Vec3 i = modelToWorld.GetIBasis3D();
+    Vec3 j = modelToWorld.GetJBasis3D();
+    Vec3 k = modelToWorld.GetKBasis3D();
+    float scaleI = i.GetLength();
+    float scaleJ = j.GetLength();
+    float scaleK = k.GetLength();
+    float maxScale = MaxF(MaxF(scaleI, scaleJ), scaleK);
+    // 非均匀缩放会把法线锥拉歪，镜像会翻转正反面：这两种情况只做 frustum
+    bool coneTestValid = fabsf(scaleI - scaleJ) <= 1e-3f * maxScale && fabsf(scaleI - scaleK) <= 1e-3f * maxScale
+        && DotProduct3D(CrossProduct3D(i, j), k) > 0.f;
+
+    for (Meshlet const& meshlet : meshlets.m_meshlets)
+    {
+        stats.m_meshletsTested++;
+        stats.m_trianglesTotal += meshlet.m_triangleCount;
+
+        Vec3 center = modelToWorld.TransformPosition3D(meshlet.m_center);
+        float radius = meshlet.m_radius * maxScale;
+        if (worldFrustum.DetectContainmentWithSphere(center, radius) == ContainmentType::OUTSIDE)
+        {
+            stats.m_frustumCulled++;
+            continue;
+        }
+
+        if (coneTestValid && meshlet.m_coneCutoff < 1.f)
+        {
+            Vec3 axis = modelToWorld.TransformVectorQuantity3D(meshlet.m_coneAxis) / scaleI;
+            Vec3 toCenter = center - cameraWorldPosition;
+            if (DotProduct3D(toCenter, axis) >= meshlet.m_coneCutoff * toCenter.GetLength() + radius)
+            {
+                stats.m_backfaceCulled++;
+                continue;
+            }
+        }
+
+        stats.m_trianglesVisible += meshlet.m_triangleCount;
+        uint32_t firstIndex = meshlet.m_triangleOffset * 3;
+        uint32_t indexCount = meshlet.m_triangleCount * 3;
+        if (!outRanges.empty() && outRanges.back().m_firstIndex + outRanges.back().m_indexCount == firstIndex)
+        {
+            outRanges.back().m_indexCount += indexCount;
+        }
+        else
+        {
+            MeshletIndexRange range;
+            range.m_firstIndex = firstIndex;
+            range.m_indexCount = indexCount;
+            outRanges.push_back(range);
+        }
+    }
+    stats.m_rangeCount += (uint32_t)outRanges.size();
+}
@@ -0,0 +1,520 @@
+#include "OBJParser.h"
+
+#include "Engine/Core/Time.hpp"
+#include "Engine/Job/JobSystem.h"
+
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+    enum OBJCornerFlags : uint8_t
+    {
+        OBJ_CORNER_RELATIVE_POSITION = 1 << 0,   // index is relative to the chunk, add its base
+        OBJ_CORNER_RELATIVE_UV = 1 << 1,
+        OBJ_CORNER_RELATIVE_NORMAL = 1 << 2,
+        OBJ_CORNER_HAS_UV = 1 << 3,
+        OBJ_CORNER_HAS_NORMAL = 1 << 4,
+    };
+
+    struct OBJCorner
+    {
+        int32_t m_position = 0;
+        int32_t m_uv = 0;
+        int32_t m_normal = 0;
+        uint8_t m_flags = 0;
+    };
+
+    struct OBJColorEvent
+    {
+        uint32_t m_firstCorner = 0;
+        Rgba8 m_color;
+    };
+
+    struct OBJChunk
+    {
+        char const* m_begin = nullptr;
+        char const* m_end = nullptr;
+
+        std::vector<Vec3> m_positions;
+        std::vector<Vec2> m_uvs;
+        std::vector<Vec3> m_normals;
+        std::vector<OBJCorner> m_corners;            // 3 per triangle
+        std::vector<OBJColorEvent> m_colorEvents;
+        uint32_t m_faceCount = 0;
+        uint32_t m_polygonCount = 0;
+        bool m_hasFaceIndexing = false;
+
+        uint32_t m_positionBase = 0;
+        uint32_t m_uvBase = 0;
+        uint32_t m_normalBase = 0;
+    };
+
+    inline bool IsOBJSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    inline char const* SkipOBJSpaces(char const* p, char const* end)
+    {
+        while (p < end && IsOBJSpace(*p))
+            p++;
+        return p;
+    }
+
+    inline std::string_view ReadOBJToken(char const*& p, char const* end)
+    {
+        p = SkipOBJSpaces(p, end);
+        char const* start = p;
+        while (p < end && !IsOBJSpace(*p))
+            p++;
+        return std::string_view(start, (size_t)(p - start));
+    }
+
+    inline bool ParseOBJFloat(char const*& p, char const* end, float& out)
+    {
+        p = SkipOBJSpaces(p, end);
+        if (p < end && *p == '+')
+            p++;
+        std::from_chars_result result = std::from_chars(p, end, out);
+        if (result.ec != std::errc())
+            return false;
+        p = result.ptr;
+        return true;
+    }
+
+    inline bool ParseOBJInt(char const*& p, char const* end, int32_t& out)
+    {
+        if (p < end && *p == '+')
+            p++;
+        std::from_chars_result result = std::from_chars(p, end, out);
+        if (result.ec != std::errc())
+            return false;
+        p = result.ptr;
+        return true;
+    }
+
+    // raw OBJ index (1-based, or negative = relative to the current count) -> 0-based index + relative flag
+    inline bool ResolveOBJIndex(int32_t raw, uint32_t localCount, int32_t& outIndex, bool& outRelative)
+    {
+        if (raw > 0)
+        {
+            outIndex = raw - 1;
+            outRelative = false;
+            return true;
+        }
+        if (raw < 0)
+        {
+            outIndex = (int32_t)localCount + raw;
+            outRelative = true;
+            return true;
+        }
+        return false;
+    }
+
+    // "v", "v/t", "v//n", "v/t/n"
+    bool ParseOBJCorner(std::string_view token, OBJChunk const& chunk, OBJCorner& out, bool& outHasSlash)
+    {
+        char const* p = token.data();
+        char const* end = p + token.size();
+        out = OBJCorner();
+
+        int32_t raw = 0;
+        bool isRelative = false;
+        if (!ParseOBJInt(p, end, raw) || !ResolveOBJIndex(raw, (uint32_t)chunk.m_positions.size(), out.m_position, isRelative))
+            return false;
+        if (isRelative)
+            out.m_flags |= OBJ_CORNER_RELATIVE_POSITION;
+        if (p >= end || *p != '/')
+            return true;
+
+        outHasSlash = true;
+        p++;
+        if (p < end && *p != '/' && ParseOBJInt(p, end, raw) && ResolveOBJIndex(raw, (uint32_t)chunk.m_uvs.size(), out.m_uv, isRelative))
+        {
+            out.m_flags |= OBJ_CORNER_HAS_UV;
+            if (isRelative)
+                out.m_flags |= OBJ_CORNER_RELATIVE_UV;
+        }
+        if (p >= end || *p != '/')
+            return true;
+
+        p++;
+        if (ParseOBJInt(p, end, raw) && ResolveOBJIndex(raw, (uint32_t)chunk.m_normals.size(), out.m_normal, isRelative))
+        {
+            out.m_flags |= OBJ_CORNER_HAS_NORMAL;
+            if (isRelative)
+                out.m_flags |= OBJ_CORNER_RELATIVE_NORMAL;
+        }
+        return true;
+    }
+
+    void ParseOBJChunk(OBJChunk& chunk, std::map<std::string, Rgba8> const& kdMap, bool flipUV)
+    {
+        std::vector<OBJCorner> polygon;
+        char const* p = chunk.m_begin;
+        char const* end = chunk.m_end;
+        while (p < end)
+        {
+            char const* lineEnd = (char const*)memchr(p, '\n', (size_t)(end - p));
+            if (!lineEnd)
+                lineEnd = end;
+            char const* cursor = p;
+            p = lineEnd + 1;
+
+            std::string_view keyword = ReadOBJToken(cursor, lineEnd);
+            if (keyword.empty() || keyword[0] == '#')
+                continue;
+
+            if (keyword == "v")
+            {
+                Vec3 position;
+                if (ParseOBJFloat(cursor, lineEnd, position.x) && ParseOBJFloat(cursor, lineEnd, position.y) && ParseOBJFloat(cursor, lineEnd, position.z))
+                    chunk.m_positions.push_back(position);
+            }
+            else if (keyword == "vt")
+            {
+                Vec2 uv;
+                if (ParseOBJFloat(cursor, lineEnd, uv.x) && ParseOBJFloat(cursor, lineEnd, uv.y))
+                {
+                    if (flipUV)
+                        uv.y = 1.f - uv.y;
+                    chunk.m_uvs.push_back(uv);
+                }
+            }
+            else if (keyword == "vn")
+            {
+                Vec3 normal;
+                if (ParseOBJFloat(cursor, lineEnd, normal.x) && ParseOBJFloat(cursor, lineEnd, normal.y) && ParseOBJFloat(cursor, lineEnd, normal.z))
+                    chunk.m_normals.push_back(normal.GetNormalized());
+            }
+            else if (keyword == "usemtl")
+            {
+                std::string_view name = ReadOBJToken(cursor, lineEnd);
+                if (!name.empty())
+                {
+                    // 只在切材质时建一次 string，find 在各 chunk 上只读
+                    auto it = kdMap.find(std::string(name));
+                    OBJColorEvent event;
+                    event.m_firstCorner = (uint32_t)chunk.m_corners.size();
+                    event.m_color = (it != kdMap.end()) ? it->second : Rgba8::WHITE;
+                    chunk.m_colorEvents.push_back(event);
+                }
+            }
+            else if (keyword == "f")
+            {
+                polygon.clear();
+                bool hasSlash = false;
+                bool isValid = true;
+                for (std::string_view token = ReadOBJToken(cursor, lineEnd); !token.empty(); token = ReadOBJToken(cursor, lineEnd))
+                {
+                    OBJCorner corner;
+                    if (!ParseOBJCorner(token, chunk, corner, hasSlash))
+                    {
+                        isValid = false;
+                        break;
+                    }
+                    polygon.push_back(corner);
+                }
+                if (!isValid || polygon.size() < 3)
+                    continue;
+
+                chunk.m_faceCount++;
+                chunk.m_hasFaceIndexing |= hasSlash;
+                if (polygon.size() > 3)
+                    chunk.m_polygonCount++;
+                // 凸多边形按 fan 拆：(0, i, i + 1)，保持原来的绕序
+                for (size_t i = 1; i + 1 < polygon.size(); i++)
+                {
+                    chunk.m_corners.push_back(polygon[0]);
+                    chunk.m_corners.push_back(polygon[i]);
+                    chunk.m_corners.push_back(polygon[i + 1]);
+                }
+            }
+        }
+    }
+
+    // (v, vt, vn, color) -> vertex; open addressing, grows at 50% load
+    class OBJCornerTable
+    {
+    public:
+        explicit OBJCornerTable(size_t expectedCount)
+        {
+            size_t size = 64;
+            while (size < expectedCount * 2)
+                size *= 2;
+            m_keys.resize(size);
+            m_values.assign(size, EMPTY);
+        }
+
+        uint32_t& FindOrInsert(int32_t position, int32_t uv, int32_t normal, uint32_t color)
+        {
+            if ((m_count + 1) * 2 > m_keys.size())
+                Grow();
+            Key key{ position, uv, normal, color };
+            size_t mask = m_keys.size() - 1;
+            size_t slot = Hash(key) & mask;
+            while (m_values[slot] != EMPTY)
+            {
+                Key const& other = m_keys[slot];
+                if (other.m_position == position && other.m_uv == uv && other.m_normal == normal && other.m_color == color)
+                    return m_values[slot];
+                slot = (slot + 1) & mask;
+            }
+            m_keys[slot] = key;
+            m_count++;
+            return m_values[slot];      // EMPTY: caller fills it in
+        }
+
+    public:
+        static constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+
+    private:
+        struct Key
+        {
+            int32_t m_position;
+            int32_t m_uv;
+            int32_t m_normal;
+            uint32_t m_color;
+        };
+
+        static size_t Hash(Key const& key)
+        {
+            uint64_t h = MixHash(MixHash(MixHash(0x9E3779B97F4A7C15ull, (uint32_t)key.m_position), (uint32_t)key.m_uv), (uint32_t)key.m_normal);
+            return (size_t)FinalizeHash(MixHash(h, key.m_color));
+        }
+
+        void Grow()
+        {
+            std::vector<Key> oldKeys;
+            std::vector<uint32_t> oldValues;
+            oldKeys.swap(m_keys);
+            oldValues.swap(m_values);
+            m_keys.resize(oldKeys.size() * 2);
+            m_values.assign(oldKeys.size() * 2, EMPTY);
+            m_count = 0;
+            for (size_t i = 0; i < oldKeys.size(); i++)
+            {
+                if (oldValues[i] != EMPTY)
+                {
+                    Key const& key = oldKeys[i];
+                    FindOrInsert(key.m_position, key.m_uv, key.m_normal, key.m_color) = oldValues[i];
+                }
+            }
+        }
+
+    private:
+        std::vector<Key> m_keys;
+        std::vector<uint32_t> m_values;
+        size_t m_count = 0;
+    };
+
+    inline uint32_t PackOBJColor(Rgba8 const& color)
+    {
+        return (uint32_t)color.r | ((uint32_t)color.g << 8) | ((uint32_t)color.b << 16) | ((uint32_t)color.a << 24);
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+bool ParseOBJBuffer(char const* data, size_t size, std::map<std::string, Rgba8> const& kdMap, bool flipUV,
+    std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices, OBJParseStats& stats)
+{
+    stats = OBJParseStats();
+    stats.m_fileBytes = size;
+    verts.clear();
+    indices.clear();
+    if (!data || size == 0)
+        return false;
+
+    // 1. 切 chunk：目标边界往后挪到下一个 '\n' 之后，每个 chunk 都是整行
+    double parseStart = GetCurrentTimeSeconds();
+    size_t maxChunks = 1;
+    if (g_theJobSystem && g_theJobSystem->GetNumWorkerThreads() > 0)
+        maxChunks = (size_t)g_theJobSystem->GetNumWorkerThreads() * 4;
+    size_t chunkCount = size / OBJ_MIN_CHUNK_BYTES;
+    if (chunkCount < 1)
+        chunkCount = 1;
+    if (chunkCount > maxChunks)
+        chunkCount = maxChunks;
+
+    std::vector<OBJChunk> chunks;
+    chunks.reserve(chunkCount);
+    char const* fileEnd = data + size;
+    char const* chunkBegin = data;
+    for (size_t c = 0; c < chunkCount && chunkBegin < fileEnd; c++)
+    {
+        char const* chunkEnd = (c + 1 == chunkCount) ? fileEnd : data + (size * (c + 1)) / chunkCount;
+        if (chunkEnd < chunkBegin)
+            chunkEnd = chunkBegin;
+        if (chunkEnd < fileEnd)
+        {
+            char const* newline = (char const*)memchr(chunkEnd, '\n', (size_t)(fileEnd - chunkEnd));
+            chunkEnd = newline ? newline + 1 : fileEnd;
+        }
+        OBJChunk chunk;
+        chunk.m_begin = chunkBegin;
+        chunk.m_end = chunkEnd;
+        chunks.push_back(std::move(chunk));
+        chunkBegin = chunkEnd;
+    }
+    stats.m_chunkCount = (uint32_t)chunks.size();
+
+    // 2. 各 chunk 独立解析
+    ParallelFor((uint32_t)chunks.size(), 1, [&chunks, &kdMap, flipUV](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t c = begin; c < end; c++)
+        {
+            ParseOBJChunk(chunks[c], kdMap, flipUV);
+        }
+    });
+    stats.m_parseMilliseconds = (GetCurrentTimeSeconds() - parseStart) * 1000.0;
+
+    // 3. merge：前缀和 -> 拷属性 -> 按文件顺序出三角形
+    double mergeStart = GetCurrentTimeSeconds();
+    uint32_t cornerCount = 0;
+    for (OBJChunk& chunk : chunks)
+    {
+        chunk.m_positionBase = stats.m_positionCount;
+        chunk.m_uvBase = stats.m_uvCount;
+        chunk.m_normalBase = stats.m_normalCount;
+        stats.m_positionCount += (uint32_t)chunk.m_positions.size();
+        stats.m_uvCount += (uint32_t)chunk.m_uvs.size();
+        stats.m_normalCount += (uint32_t)chunk.m_normals.size();
+        stats.m_faceCount += chunk.m_faceCount;
+        stats.m_polygonCount += chunk.m_polygonCount;
+        stats.m_hasFaceIndexing |= chunk.m_hasFaceIndexing;
+        cornerCount += (uint32_t)chunk.m_corners.size();
+    }
+
+    std::vector<Vec3> positions(stats.m_positionCount);
+    std::vector<Vec2> uvs(stats.m_uvCount);
+    std::vector<Vec3> normals(stats.m_normalCount);
+    ParallelFor((uint32_t)chunks.size(), 1, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t c = begin; c < end; c++)
+        {
+            OBJChunk const& chunk = chunks[c];
+            std::copy(chunk.m_positions.begin(), chunk.m_positions.end(), positions.begin() + chunk.m_positionBase);
+            std::copy(chunk.m_uvs.begin(), chunk.m_uvs.end(), uvs.begin() + chunk.m_uvBase);
+            std::copy(chunk.m_normals.begin(), chunk.m_normals.end(), normals.begin() + chunk.m_normalBase);
+        }
+    });
+
+    int32_t positionCount = (int32_t)positions.size();
+    int32_t uvCount = (int32_t)uvs.size();
+    int32_t normalCount = (int32_t)normals.size();
+    indices.reserve(cornerCount);
+
+    // 没有 v/t/n 的文件：每个 corner 一个顶点（后面按三角形算法线）；有的话按值焊接
+    bool isWelded = stats.m_hasFaceIndexing;
+    OBJCornerTable cornerTable(isWelded ? stats.m_positionCount : 0);
+    std::unordered_map<VertexKey, unsigned int, VertexKeyHasher> vertexMap;
+    if (isWelded)
+        vertexMap.reserve(stats.m_positionCount);
+    else
+        verts.reserve(cornerCount);
+
+    Rgba8 currentColor = Rgba8::WHITE;
+    for (OBJChunk const& chunk : chunks)
+    {
+        size_t eventIndex = 0;
+        for (uint32_t t = 0; t + 2 < (uint32_t)chunk.m_corners.size(); t += 3)
+        {
+            while (eventIndex < chunk.m_colorEvents.size() && chunk.m_colorEvents[eventIndex].m_firstCorner <= t)
+            {
+                currentColor = chunk.m_colorEvents[eventIndex].m_color;
+                eventIndex++;
+            }
+
+            int32_t resolved[3][3];
+            bool isValid = true;
+            for (int k = 0; k < 3; k++)
+            {
+                OBJCorner const& corner = chunk.m_corners[t + k];
+                int32_t position = corner.m_position + ((corner.m_flags & OBJ_CORNER_RELATIVE_POSITION) ? (int32_t)chunk.m_positionBase : 0);
+                int32_t uv = -1;
+                int32_t normal = -1;
+                if (corner.m_flags & OBJ_CORNER_HAS_UV)
+                {
+                    uv = corner.m_uv + ((corner.m_flags & OBJ_CORNER_RELATIVE_UV) ? (int32_t)chunk.m_uvBase : 0);
+                    stats.m_hasUV = true;
+                    if (uv < 0 || uv >= uvCount)
+                        uv = -1;
+                }
+                if (corner.m_flags & OBJ_CORNER_HAS_NORMAL)
+                {
+                    normal = corner.m_normal + ((corner.m_flags & OBJ_CORNER_RELATIVE_NORMAL) ? (int32_t)chunk.m_normalBase : 0);
+                    stats.m_hasNormal = true;
+                    if (normal < 0 || normal >= normalCount)
+                        normal = -1;
+                }
+                if (position < 0 || position >= positionCount)
+                    isValid = false;
+                resolved[k][0] = position;
+                resolved[k][1] = uv;
+                resolved[k][2] = normal;
+            }
+            if (!isValid)
+            {
+                stats.m_skippedTriangles++;
+                continue;
+            }
+            stats.m_triangleCount++;
+
+            for (int k = 0; k < 3; k++)
+            {
+                Vec3 const& position = positions[resolved[k][0]];
+                if (!isWelded)
+                {
+                    Vertex_PCUTBN vert;
+                    vert.m_position = position;
+                    vert.m_color = currentColor;
+                    vert.m_uvTexCoords = Vec2(0.f, 0.f);
+                    vert.m_normal = Vec3();
+                    vert.m_tangent = Vec3(1.f, 0.f, 0.f);
+                    vert.m_bitangent = Vec3(0.f, 1.f, 0.f);
+                    indices.push_back((unsigned int)verts.size());
+                    verts.push_back(vert);
+                    continue;
+                }
+
+                uint32_t& cornerVertex = cornerTable.FindOrInsert(resolved[k][0], resolved[k][1], resolved[k][2], PackOBJColor(currentColor));
+                if (cornerVertex == OBJCornerTable::EMPTY)
+                {
+                    Vec2 uv = resolved[k][1] >= 0 ? uvs[resolved[k][1]] : Vec2(0.5f, 0.5f);
+                    Vec3 normal = resolved[k][2] >= 0 ? normals[resolved[k][2]] : Vec3(0.f, 0.f, 1.f);
+                    VertexKey key{ position, uv, normal, currentColor };
+                    auto it = vertexMap.find(key);
+                    if (it != vertexMap.end())
+                    {
+                        cornerVertex = it->second;
+                    }
+                    else
+                    {
+                        Vertex_PCUTBN vert;
+                        vert.m_position = position;
+                        vert.m_uvTexCoords = uv;
+                        vert.m_normal = normal.GetLengthSquared() > 0.f ? normal.GetNormalized() : Vec3(0.f, 0.f, 1.f);
+                        vert.m_color = currentColor;
+                        vert.m_tangent = Vec3(1.f, 0.f, 0.f);
+                        vert.m_bitangent = Vec3(0.f, 1.f, 0.f);
+
+                        cornerVertex = (uint32_t)verts.size();
+                        vertexMap[key] = cornerVertex;
+                        verts.push_back(vert);
+                    }
+                }
+                indices.push_back(cornerVertex);
+            }
+        }
+        // chunk 末尾的 usemtl 也要带到下一个 chunk
+        for (; eventIndex < chunk.m_colorEvents.size(); eventIndex++)
+        {
+            currentColor = chunk.m_colorEvents[eventIndex].m_color;
+        }
+    }
+    stats.m_mergeMilliseconds = (GetCurrentTimeSeconds() - mergeStart) * 1000.0;
+    return true;
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "Engine/Core/MeshOptimizer.h"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+//==============================================================================
+// OBJParser - 一次读进 buffer，按行对齐切 chunk 在 worker 上并行解析
+//==============================================================================
+// The file is one buffer; every token is a string_view into it and numbers go through
+// std::from_chars (no per-line / per-token std::string, no stof / stoi).
+//
+// ParseOBJBuffer:
+//   1. split      the buffer into line-aligned chunks (OBJ_MIN_CHUNK_BYTES at least)
+//   2. parse      ParallelFor over chunks. Each chunk keeps its own v / vt / vn arrays,
+//                 fans polygons (> 3 corners) into triangles and stores their corners.
+//                 Positive indices are already global; negative (relative) ones are
+//                 stored relative to the chunk and get the chunk's base added in 3.
+//                 usemtl is recorded as (first corner, Kd color) per chunk
+//   3. merge      prefix-sum the per-chunk counts, copy the attribute arrays into place
+//                 (ParallelFor), then walk the triangles in file order to build the
+//                 vertex/index buffers
+//
+// Output: with any "v/t/n" face the verts are welded by value (pos, uv, normal, color);
+// without one every corner gets its own vertex. Welding first looks the corner up by its (v, vt, vn, color) indices, so the float hash only
+// runs once per distinct corner. There is no separate pass looking for '/' any more.
+//==============================================================================
+
+static constexpr size_t OBJ_MIN_CHUNK_BYTES = 256 * 1024;
+
+struct VertexKey
+{
+    Vec3 m_pos;
+    Vec2 m_uv;
+    Vec3 m_normal;
+    Rgba8 m_color;
+
+    bool operator==(const VertexKey& anotherVk) const
+    {
+        return m_pos == anotherVk.m_pos && m_uv == anotherVk.m_uv && m_normal == anotherVk.m_normal
+        && anotherVk.m_color == m_color;
+    }
+};
+
+struct VertexKeyHasher
+{
+    // 每个分量按 bit 混进 64 位 hash（-0 和 0 同 hash，和 operator== 一致）
+    size_t operator()(const VertexKey& k) const
+    {
+        uint64_t h = 0x9E3779B97F4A7C15ull;
+        h = MixHash(h, CanonicalFloatBits(k.m_pos.x));
+        h = MixHash(h, CanonicalFloatBits(k.m_pos.y));
+        h = MixHash(h, CanonicalFloatBits(k.m_pos.z));
+        h = MixHash(h, CanonicalFloatBits(k.m_uv.x));
+        h = MixHash(h, CanonicalFloatBits(k.m_uv.y));
+        h = MixHash(h, CanonicalFloatBits(k.m_normal.x));
+        h = MixHash(h, CanonicalFloatBits(k.m_normal.y));
+        h = MixHash(h, CanonicalFloatBits(k.m_normal.z));
+
+        uint32_t c = (uint32_t)k.m_color.r
+        | ((uint32_t)k.m_color.g << 8 )
+        | ((uint32_t)k.m_color.b << 16)
+        | ((uint32_t)k.m_color.a << 24);
+        h = MixHash(h, c);
+
+        return (size_t)FinalizeHash(h);
+    }
+};
+
+struct OBJParseStats
+{
+    uint64_t m_fileBytes = 0;
+    uint32_t m_chunkCount = 0;
+    uint32_t m_positionCount = 0;
+    uint32_t m_uvCount = 0;
+    uint32_t m_normalCount = 0;
+    uint32_t m_faceCount = 0;
+    uint32_t m_polygonCount = 0;         // faces with more than 3 corners (fanned)
+    uint32_t m_triangleCount = 0;
+    uint32_t m_skippedTriangles = 0;     // corner pointing past the v list
+    bool m_hasFaceIndexing = false;      // some face uses v/t/n
+    bool m_hasUV = false;
+    bool m_hasNormal = false;
+
+    double m_parseMilliseconds = 0.0;
+    double m_mergeMilliseconds = 0.0;
+};
+
+// kdMap: usemtl name -> Kd color (LoadOBJMaterial). verts only get P, C, UV, N here;
+// missing UVs / normals / tangents are up to the caller (same as the legacy loader)
+bool ParseOBJBuffer(char const* data, size_t size, std::map<std::string, Rgba8> const& kdMap, bool flipUV,
+    std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices, OBJParseStats& stats);
@@ -2,20 +2,323 @@
 
 #include <ThirdParty/cgltf/cgltf.h>
 
+#include "Engine/Core/GLBImporter.h"
 #include "Engine/Core/StaticMeshUtils.h"
+#include "Engine/Core/VertexQuantization.h"
 #include "Engine/Core/XmlUtils.hpp"
 #include "Engine/Renderer/IndexBuffer.hpp"
 #include "Engine/Renderer/Shader.hpp"
 #include "Engine/Renderer/VertexBuffer.hpp"
+#ifdef ENGINE_DX12_RENDERER
 #include "Engine/Renderer/DX12Renderer.hpp"
+#else
+#include "Engine/Renderer/Renderer.hpp"
+#endif
 #include "Engine/Core/Image.hpp"
 #include "Engine/Renderer/Cache/SurfaceCard.h"
+#include "Engine/Job/JobSystem.h"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Scene/SDF/SDFBaker.h"
+
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+    // xml 里的 x / y / z、unitsPerMeter、translation；ctor 和 cook（bounds / BVH）共用
+    void ParseStaticMeshTransform(XmlElement const& meshElement, Mat44& outTransform, Mat44& outTransformWithoutAxisTransform, float& outUnitsPerMeter)
+    {
+        std::string x = ParseXmlAttribute(meshElement, "x", "");
+        std::string y = ParseXmlAttribute(meshElement, "y", "");
+        std::string z = ParseXmlAttribute(meshElement, "z", "");
+        Vec3 I = Vec3(1, 0, 0);
+        Vec3 J = Vec3(0, 1, 0);
+        Vec3 K = Vec3(0, 0, 1);
+        bool hasI = false, hasJ = false, hasK = false;
+
+        if (!x.empty())
+        {
+            if (x == "left") { I = Vec3(0, +1, 0); hasI = true; }
+            else if (x == "right") { I = Vec3(0, -1, 0); hasI = true; }
+            else if (x == "up") { I = Vec3(0, 0, +1); hasI = true; }
+            else if (x == "down") { I = Vec3(0, 0, -1); hasI = true; }
+            else if (x == "forward") { I = Vec3(+1, 0, 0); hasI = true; }
+            else if (x == "back") { I = Vec3(-1, 0, 0); hasI = true; }
+        }
+
+        if (!y.empty())
+        {
+            if (y == "left") { J = Vec3(0, +1, 0); hasJ = true; }
+            else if (y == "right") { J = Vec3(0, -1, 0); hasJ = true; }
+            else if (y == "up") { J = Vec3(0, 0, +1); hasJ = true; }
+            else if (y == "down") { J = Vec3(0, 0, -1); hasJ = true; }
+            else if (y == "forward") { J = Vec3(+1, 0, 0); hasJ = true; }
+            else if (y == "back") { J = Vec3(-1, 0, 0); hasJ = true; }
+        }
+
+        if (!z.empty())
+        {
+            if (z == "left") { K = Vec3(0, +1, 0); hasK = true; }
+            else if (z == "right") { K = Vec3(0, -1, 0); hasK = true; }
+            else if (z == "up") { K = Vec3(0, 0, +1); hasK = true; }
+            else if (z == "down") { K = Vec3(0, 0, -1); hasK = true; }
+            else if (z == "forward") { K = Vec3(+1, 0, 0); hasK = true; }
+            else if (z == "back") { K = Vec3(-1, 0, 0); hasK = true; }
+        }
+
+        int count = (int)hasI + (int)hasJ + (int)hasK;
+        if (count == 1)
+        {
+            if (hasI)
+            {
+                Vec3 temp = (std::fabs(I.z) < 0.9f) ? Vec3(0, 0, 1) : Vec3(0, 1, 0);
+                J = CrossProduct3D(temp, I);
+                K = CrossProduct3D(I, J);
+            }
+            else if (hasJ)
+            {
+                Vec3 temp = (std::fabs(J.z) < 0.9f) ? Vec3(0, 0, 1) : Vec3(1, 0, 0);
+                K = CrossProduct3D(J, temp);
+                I = CrossProduct3D(J, K);
+            }
+            else
+            {
+                Vec3 temp = (std::fabs(K.y) < 0.9f) ? Vec3(0, 1, 0) : Vec3(1, 0, 0);
+                I = CrossProduct3D(K, temp);
+                J = CrossProduct3D(K, I);
+            }
+        }
+        else if (count == 2)
+        {
+            if (!hasK) { K = CrossProduct3D(I, J); }
+            else if (!hasJ) { J = CrossProduct3D(K, I); }
+            else if (!hasI) { I = CrossProduct3D(J, K); }
+        }
+        Mat44 M;
+        M.SetIJK3D(I, J, K);
+        M.Orthonormalize_IFwd_JLeft_KUp();
+        outTransform = M;
+
+        outUnitsPerMeter = ParseXmlAttribute(meshElement, "unitsPerMeter", 1.f);
+        Mat44 mat;
+        mat = mat.MakeUniformScale3D(1/outUnitsPerMeter);
+        outTransformWithoutAxisTransform = mat;
+        outTransform.Append(mat);
+
+        Vec3 translation = ParseXmlAttribute(meshElement, "translation", Vec3(0.f, 0.f, 0.f));
+        Mat44 translate;
+        translate.SetTranslation3D(translation);
+        outTransform.Append(translate);
+        outTransformWithoutAxisTransform.Append(translate);
+    }
+
+    // 与原来每次现算的 Get*Bounds* 结果一致（包括 AABB3 默认值也参与 StretchToIncludePoint）
+    CookedMeshBounds ComputeStaticMeshBounds(std::vector<Vertex_PCUTBN> const& verts, Mat44 const& transform,
+        Mat44 const& transformWithoutAxisTransform, float modelRelativeScale)
+    {
+        CookedMeshBounds bounds;
+        if (verts.empty())
+            return bounds;
+
+        Vec3 mn = Vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+        Vec3 mx = Vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        Vec3 center = Vec3();
+        Vec3 transformedCenter = Vec3();
+        for (Vertex_PCUTBN const& vert : verts)
+        {
+            Vec3 p = vert.m_position;
+            mn.x = MinF(mn.x, p.x);
+            mn.y = MinF(mn.y, p.y);
+            mn.z = MinF(mn.z, p.z);
+            mx.x = MaxF(mx.x, p.x);
+            mx.y = MaxF(mx.y, p.y);
+            mx.z = MaxF(mx.z, p.z);
+            center += p;
+
+            Vec3 transformed = transform.TransformPosition3D(p);
+            bounds.m_transformedBounds.StretchToIncludePoint(transformed);
+            bounds.m_transformedBoundsWithoutAxisTransform.StretchToIncludePoint(transformWithoutAxisTransform.TransformPosition3D(p));
+            transformedCenter += transformed;
+        }
+        bounds.m_localBounds.m_mins = mn;
+        bounds.m_localBounds.m_maxs = mx;
+        center /= static_cast<float>(verts.size());
+        transformedCenter /= static_cast<float>(verts.size());
+
+        float r2 = 0.f;
+        float transformedR2 = 0.f;
+        for (Vertex_PCUTBN const& vert : verts)
+        {
+            r2 = MaxF(r2, (vert.m_position - center).GetLengthSquared());
+            transformedR2 = MaxF(transformedR2, (transform.TransformPosition3D(vert.m_position) - transformedCenter).GetLengthSquared());
+        }
+        bounds.m_boundsSphere.m_center = center;
+        bounds.m_boundsSphere.m_radius = sqrtf(r2) * modelRelativeScale;
+        bounds.m_transformedBoundsSphere.m_center = transformedCenter;
+        bounds.m_transformedBoundsSphere.m_radius = sqrtf(transformedR2);
+        return bounds;
+    }
 
-StaticMesh::StaticMesh(Renderer* renderer, std::string const& xmlPathNoExtensions, bool enableCardTemplates)
+    // GetTransformedVertices 的空间（card / SDF 都在这里算）：法线只取方向，不重新归一化
+    std::vector<Vertex_PCUTBN> TransformStaticMeshVertices(std::vector<Vertex_PCUTBN> const& verts, Mat44 const& transform)
+    {
+        std::vector<Vertex_PCUTBN> transformed = verts;
+        for (Vertex_PCUTBN& vert : transformed)
+        {
+            vert.m_position = transform.TransformPosition3D(vert.m_position);
+            vert.m_normal = transform.TransformVectorQuantity3D(vert.m_normal);
+            vert.m_tangent = transform.TransformVectorQuantity3D(vert.m_tangent);
+            vert.m_bitangent = transform.TransformVectorQuantity3D(vert.m_bitangent);
+        }
+        return transformed;
+    }
+
+    // 改了 import / 优化 / BVH / card 的算法要加 COOKED_MESH_VERSION；这里只管会改变结果的布局和配置
+    struct StaticMeshCookSettings
+    {
+        uint32_t m_vertexSize = (uint32_t)sizeof(Vertex_PCUTBN);
+        uint32_t m_meshletSize = (uint32_t)sizeof(Meshlet);
+        uint32_t m_bvhNodeSize = (uint32_t)sizeof(GPUBVHNode);
+        uint32_t m_cardTemplateSize = (uint32_t)sizeof(SurfaceCardTemplate);
+        uint64_t m_cardConfigKey = ComputeSurfaceCardCacheKey({}, {}, CardGenerationConfig());
+    };
+
+    uint64_t WriteCookedStaticMesh(std::string const& path, uint64_t cookKey, std::vector<Vertex_PCUTBN> const& verts,
+        std::vector<unsigned int> const& indices, CookedMeshBounds const& bounds, MeshOptimizationReport const* optimizationReport,
+        MeshletData const& meshlets, std::vector<GPUBVHNode> const& bvhNodes, std::vector<uint32_t> const& bvhTriangles,
+        std::vector<SurfaceCardTemplate> const& cardTemplates, SurfaceCardGenerationReport const& cardReport,
+        std::vector<CookedMeshSDFVolume> const& sdfVolumes, std::vector<float> const& sdfDistances)
+    {
+        CookedMeshWriter writer;
+        writer.AddSection(CookedMeshSection::VERTICES, verts);
+        writer.AddSection(CookedMeshSection::INDICES, indices);
+        writer.AddSingle(CookedMeshSection::BOUNDS, bounds);
+        if (optimizationReport)
+        {
+            // 耗时每次都不一样，不进 cook（cook 结果要按字节确定）
+            MeshOptimizationReport cookedReport = *optimizationReport;
+            cookedReport.m_milliseconds = 0.0;
+            writer.AddSingle(CookedMeshSection::OPTIMIZATION_REPORT, cookedReport);
+        }
+        writer.AddSection(CookedMeshSection::MESHLETS, meshlets.m_meshlets);
+        writer.AddSection(CookedMeshSection::MESHLET_VERTICES, meshlets.m_vertices);
+        writer.AddSection(CookedMeshSection::MESHLET_TRIANGLES, meshlets.m_localIndices);
+        writer.AddSection(CookedMeshSection::BVH_NODES, bvhNodes);
+        writer.AddSection(CookedMeshSection::BVH_TRIANGLES, bvhTriangles);
+        if (!cardTemplates.empty())
+        {
+            std::vector<uint8_t> cardBytes;
+            SerializeSurfaceCards(cardTemplates, cardReport, cardBytes);
+            writer.AddSection(CookedMeshSection::CARDS, cardBytes);
+        }
+        if (!sdfVolumes.empty())
+        {
+            writer.AddSection(CookedMeshSection::SDF_VOLUMES, sdfVolumes);
+            writer.AddSection(CookedMeshSection::SDF_DISTANCES, sdfDistances);
+        }
+        return writer.Save(path, cookKey);
+    }
+
+    // 异步加载时 geometry 里已经有解码好的 blocks / mip chain / Image，这里只上传；否则照旧同步读文件
+    Texture* CreateMaterialTexture(Renderer* renderer, std::string const& path, Image const& decoded, ImageMipChain const& mips, CompressedMipChain const& blocks)
+    {
+        if (!blocks.IsValid() && !mips.IsValid() && (decoded.GetDimensions().x <= 0 || decoded.GetDimensions().y <= 0))
+            return renderer->CreateTextureFromFile(path.c_str());
+
+        Texture* texture = nullptr;
+        if (blocks.IsValid())
+            texture = renderer->CreateTextureFromCompressedMipChain(blocks);
+        else
+            texture = mips.IsValid() ? renderer->CreateTextureFromMipChain(mips) : renderer->CreateTextureFromImage(decoded);
+#ifdef ENGINE_DX12_RENDERER
+        renderer->GetSubRenderer()->PushBackNewTextureManually(texture);
+#endif
+        return texture;
+    }
+
+    void TakeGLBImages(GLBImportResult& glb, StaticMeshGeometry& out)
+    {
+        out.m_glbAlbedoImage = glb.TakeChannelImage(GLBChannel::Albedo);
+        out.m_glbNormalImage = glb.TakeChannelImage(GLBChannel::Normal);
+        out.m_glbOcclusionImage = glb.TakeChannelImage(GLBChannel::AO);
+        out.m_hasGLBImages = true;
+    }
+
+    void PrintGLBImportStats(std::string const& filePath, GLBImportStats const& stats)
+    {
+        DebuggerPrintf("[StaticMesh] %s: GLB %u meshes, %u primitives (%u skipped), %u images, %.1f KB: read %.2f, parse %.2f, geometry %.2f, tangents %.2f, images %.2f = %.2f ms\n",
+            filePath.c_str(), stats.m_meshCount, stats.m_primitiveCount, stats.m_skippedPrimitiveCount, stats.m_imageCount,
+            (double)stats.m_fileBytes / 1024.0, stats.m_readMilliseconds, stats.m_parseMilliseconds, stats.m_geometryMilliseconds,
+            stats.m_tangentMilliseconds, stats.m_imageMilliseconds, stats.m_totalMilliseconds);
+    }
+
+    bool LoadCookedStaticMesh(std::string const& path, uint64_t cookKey, StaticMeshGeometry& out)
+    {
+        CookedMeshFile file;
+        if (!file.Open(path, cookKey))
+            return false;
+
+        uint64_t count = 0;
+        CookedMeshBounds const* bounds = file.GetSection<CookedMeshBounds>(CookedMeshSection::BOUNDS, count);
+        if (!bounds || count != 1 || !file.CopySection(CookedMeshSection::VERTICES, out.m_verts) ||
+            !file.CopySection(CookedMeshSection::INDICES, out.m_indices))
+        {
+            return false;
+        }
+        out.m_bounds = *bounds;
+        out.m_hasBounds = true;
+
+        MeshOptimizationReport const* optimizationReport = file.GetSection<MeshOptimizationReport>(CookedMeshSection::OPTIMIZATION_REPORT, count);
+        out.m_isOptimized = optimizationReport && count == 1;
+        if (out.m_isOptimized)
+            out.m_optimizationReport = *optimizationReport;
+
+        file.CopySection(CookedMeshSection::MESHLETS, out.m_meshlets.m_meshlets);
+        file.CopySection(CookedMeshSection::MESHLET_VERTICES, out.m_meshlets.m_vertices);
+        file.CopySection(CookedMeshSection::MESHLET_TRIANGLES, out.m_meshlets.m_localIndices);
+        file.CopySection(CookedMeshSection::BVH_NODES, out.m_bvhNodes);
+        file.CopySection(CookedMeshSection::BVH_TRIANGLES, out.m_bvhTriangles);
+
+        uint8_t const* cardBytes = file.GetSection<uint8_t>(CookedMeshSection::CARDS, count);
+        SurfaceCardGenerationResult cards;
+        if (cardBytes && DeserializeSurfaceCards(cardBytes, (size_t)count, cards))
+        {
+            out.m_cardTemplates = std::move(cards.m_templates);
+            out.m_cardReport = cards.m_report;
+        }
+        else
+        {
+            out.m_cardTemplates.clear();
+        }
+
+        // 每个 volume 的距离都要在 SDF_DISTANCES 里，不然整个不要
+        if (file.CopySection(CookedMeshSection::SDF_VOLUMES, out.m_sdfVolumes) && file.CopySection(CookedMeshSection::SDF_DISTANCES, out.m_sdfDistances))
+        {
+            for (CookedMeshSDFVolume const& volume : out.m_sdfVolumes)
+            {
+                uint64_t voxelCount = (uint64_t)volume.m_resolution * volume.m_resolution * volume.m_resolution;
+                if (volume.m_resolution <= 0 || volume.m_firstDistance + voxelCount > out.m_sdfDistances.size())
+                {
+                    out.m_sdfVolumes.clear();
+                    break;
+                }
+            }
+        }
+        if (out.m_sdfVolumes.empty())
+            out.m_sdfDistances.clear();
+
+        out.m_cookedBytes = file.GetFileSize();
+        out.m_isFromCooked = true;
+        out.m_isLoaded = true;
+        return true;
+    }
+}
+
+StaticMesh::StaticMesh(Renderer* renderer, std::string const& xmlPathNoExtensions, bool enableCardTemplates, StaticMeshGeometry* importedGeometry)
     //:m_renderer(renderer)
 {
     XmlDocument meshDefDoc; 
-    XmlResult meshLoadResult = meshDefDoc.LoadFile((xmlPathNoExtensions+".xml").c_str());
+    XmlResult meshLoadResult = LoadXmlFile(meshDefDoc, xmlPathNoExtensions + ".xml");
     if (meshLoadResult != XmlResult::XML_SUCCESS)
     {
         ERROR_AND_DIE(Stringf("Cannot load this static mesh!"))
@@ -24,148 +327,101 @@ StaticMesh::StaticMesh(Renderer* renderer, std::string const& xmlPathNoExtension
     XmlElement* meshElement = meshDefDoc.RootElement();
     
     m_filePath = ParseXmlAttribute(*meshElement, "objFile", "");
-    bool flipUV = ParseXmlAttribute(*meshElement, "flipUV", false);
     if (m_filePath.empty())
         ERROR_AND_DIE("Failed to read mesh path!")
 
-    std::string mtlPath = ParseXmlAttribute(*meshElement, "mtllib", "");
-    
-    bool isLoaded = LoadStaticMeshFile(m_verts, m_indices, m_filePath, flipUV, mtlPath);
-    if (!isLoaded)
+    StaticMeshGeometry localGeometry;
+    if (!importedGeometry)
+    {
+        ImportGeometry(xmlPathNoExtensions, localGeometry);
+        importedGeometry = &localGeometry;
+    }
+    if (!importedGeometry->m_isLoaded)
         ERROR_AND_DIE("Failed to load the mesh!")
 
-    m_vertexBuffer = renderer->CreateVertexBuffer((unsigned int)m_verts.size() * sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN));
-    m_indexBuffer = renderer->CreateIndexBuffer((unsigned int)m_indices.size() * sizeof(unsigned int), sizeof(unsigned int));
-    renderer->CopyCPUToGPU(m_verts.data(), (unsigned int)(m_verts.size() * sizeof(Vertex_PCUTBN)), m_vertexBuffer);
-    renderer->CopyCPUToGPU(m_indices.data(), (unsigned int)(m_indices.size() * sizeof(unsigned int)), m_indexBuffer);
+    m_verts.swap(importedGeometry->m_verts);
+    m_indices.swap(importedGeometry->m_indices);
+    if (importedGeometry->m_isOptimized)
+    {
+        m_optimizationReport = importedGeometry->m_optimizationReport;
+        DebuggerPrintf("[StaticMesh] %s: optimized %u tris, verts %u -> %u, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, %u overdraw clusters, %.2f ms\n",
+            m_filePath.c_str(), m_optimizationReport.m_triangleCount,
+            m_optimizationReport.m_vertexCountBefore, m_optimizationReport.m_vertexCountAfter,
+            m_optimizationReport.m_before.m_acmr, m_optimizationReport.m_after.m_acmr,
+            m_optimizationReport.m_before.m_atvr, m_optimizationReport.m_after.m_atvr,
+            m_optimizationReport.m_overdrawClusterCount, m_optimizationReport.m_milliseconds);
+    }
+    m_isOptimized = importedGeometry->m_isOptimized;
+    m_meshlets = std::move(importedGeometry->m_meshlets);
+    if (!m_meshlets.IsEmpty())
+    {
+        DebuggerPrintf("[StaticMesh] %s: %zu meshlets (avg %.1f tris)\n", m_filePath.c_str(), m_meshlets.m_meshlets.size(),
+            (float)(m_indices.size() / 3) / (float)m_meshlets.m_meshlets.size());
+    }
+
+    m_cookedPath = importedGeometry->m_cookedPath;
+    m_cookKey = importedGeometry->m_cookKey;
+    m_bounds = importedGeometry->m_bounds;
+    m_cookedBVHNodes.swap(importedGeometry->m_bvhNodes);
+    m_cookedBVHTriangles.swap(importedGeometry->m_bvhTriangles);
+    m_cardTemplates.swap(importedGeometry->m_cardTemplates);   // m_hasCardTemplates 仍由 GenerateCardTemplates 打开
+    m_cardReport = importedGeometry->m_cardReport;
+    m_cookedSDFVolumes.swap(importedGeometry->m_sdfVolumes);
+    m_cookedSDFDistances.swap(importedGeometry->m_sdfDistances);
+    m_loadReport.m_loadedFromCooked = importedGeometry->m_isFromCooked;
+    m_loadReport.m_importMilliseconds = importedGeometry->m_importMilliseconds;
+    m_loadReport.m_keyMilliseconds = importedGeometry->m_keyMilliseconds;
+    m_loadReport.m_cookMilliseconds = importedGeometry->m_cookMilliseconds;
+    m_loadReport.m_cookedBytes = importedGeometry->m_cookedBytes;
+    if (!m_cookedPath.empty())
+    {
+        DebuggerPrintf("[StaticMesh] %s: %s in %.2f ms (key %.2f ms, cook %.2f ms), %s %.1f KB\n", m_filePath.c_str(),
+            m_loadReport.m_loadedFromCooked ? "loaded from cook" : "imported from source", m_loadReport.m_importMilliseconds,
+            m_loadReport.m_keyMilliseconds, m_loadReport.m_cookMilliseconds, m_cookedPath.c_str(), (double)m_loadReport.m_cookedBytes / 1024.0);
+    }
+
+    // packVertices="true": GPU 上放 24B 的 Vertex_PCUTBNPacked，shader 要用 VERTEX_PCUTBN_PACKED 的 layout
+    bool packVertices = ParseXmlAttribute(*meshElement, "packVertices", false);
+    UploadGeometry(renderer, packVertices);
     
     std::string normalTexture = ParseXmlAttribute(*meshElement, "normalMap", "");
     std::string diffuseTexture = ParseXmlAttribute(*meshElement, "diffuseMap", "");
     std::string specularTexture = ParseXmlAttribute(*meshElement, "specGlossEmitMap", "");
     std::string shader = ParseXmlAttribute(*meshElement, "shader", "");
     if (!normalTexture.empty())
-        m_normalTexture = renderer->CreateTextureFromFile(normalTexture.c_str());
+        m_normalTexture = CreateMaterialTexture(renderer, normalTexture, importedGeometry->m_normalImage, importedGeometry->m_normalMips, importedGeometry->m_normalBlocks);
     if (!diffuseTexture.empty())
-        m_diffuseTexture = renderer->CreateTextureFromFile(diffuseTexture.c_str());
+        m_diffuseTexture = CreateMaterialTexture(renderer, diffuseTexture, importedGeometry->m_diffuseImage, importedGeometry->m_diffuseMips, importedGeometry->m_diffuseBlocks);
     if (!specularTexture.empty())
-        m_specularTexture = renderer->CreateTextureFromFile(specularTexture.c_str());
+        m_specularTexture = CreateMaterialTexture(renderer, specularTexture, importedGeometry->m_specularImage, importedGeometry->m_specularMips, importedGeometry->m_specularBlocks);
     if (!shader.empty())
-        m_shader = renderer->CreateOrGetShader(shader.c_str(), VertexType::VERTEX_PCUTBN);
+        m_shader = renderer->CreateOrGetShader(shader.c_str(), m_usesPackedVertices ? VertexType::VERTEX_PCUTBN_PACKED : VertexType::VERTEX_PCUTBN);
 
+    // 从源文件导入时贴图已经和几何一起解好了；cook 命中时这里再解析一次，只取贴图
     if (EndsWith(m_filePath, ".glb"))
     {
-        Image* diffuseI = LoadImageDueToGLTFData(LoadGLTFDataFromFile(m_filePath), GLBChannel::Albedo, m_filePath);
-        if (diffuseI)
-        {
-            diffuseI->SetName(xmlPathNoExtensions + "_diffuse");
-            m_diffuseTexture = renderer->CreateTextureFromImage(*diffuseI);
-#ifdef ENGINE_DX12_RENDERER
-			renderer->GetSubRenderer()->PushBackNewTextureManually(m_diffuseTexture);
-#endif
-        }
-        Image* normalI = LoadImageDueToGLTFData(LoadGLTFDataFromFile(m_filePath), GLBChannel::Normal, m_filePath);
-        if (normalI)
-        {
-            diffuseI->SetName(xmlPathNoExtensions + "_normal");
-            m_normalTexture = renderer->CreateTextureFromImage(*normalI);
-#ifdef ENGINE_DX12_RENDERER
-			renderer->GetSubRenderer()->PushBackNewTextureManually(m_normalTexture);
-#endif
-        }
-        Image* specI = LoadImageDueToGLTFData(LoadGLTFDataFromFile(m_filePath), GLBChannel::AO, m_filePath);
-        if (specI)
+        if (!importedGeometry->m_hasGLBImages)
+            DecodeGLBImages(m_filePath, *importedGeometry);
+
+        Image* glbImages[3] = { &importedGeometry->m_glbAlbedoImage, &importedGeometry->m_glbNormalImage, &importedGeometry->m_glbOcclusionImage };
+        Texture** glbTextures[3] = { &m_diffuseTexture, &m_normalTexture, &m_specularTexture };
+        char const* glbSuffixes[3] = { "_diffuse", "_normal", "_ao" };
+        for (int i = 0; i < 3; i++)
         {
-            diffuseI->SetName(xmlPathNoExtensions + "_ao");
-            m_specularTexture = renderer->CreateTextureFromImage(*specI);
+            if (glbImages[i]->GetDimensions().x <= 0 || glbImages[i]->GetDimensions().y <= 0)
+                continue;
+            glbImages[i]->SetName(xmlPathNoExtensions + glbSuffixes[i]);
+            *glbTextures[i] = renderer->CreateTextureFromImage(*glbImages[i]);
 #ifdef ENGINE_DX12_RENDERER
-			renderer->GetSubRenderer()->PushBackNewTextureManually(m_specularTexture);
+			renderer->GetSubRenderer()->PushBackNewTextureManually(*glbTextures[i]);
 #endif
         }
     }
     
-    std::string x = ParseXmlAttribute(*meshElement, "x", "");
-    std::string y = ParseXmlAttribute(*meshElement, "y", "");
-    std::string z = ParseXmlAttribute(*meshElement, "z", "");
-	Vec3 I = Vec3(1, 0, 0);  
-	Vec3 J = Vec3(0, 1, 0);  
-	Vec3 K = Vec3(0, 0, 1);  
-	bool hasI = false, hasJ = false, hasK = false;
-
-	if (!x.empty()) 
-    {
-		if (x == "left") { I = Vec3(0, +1, 0); hasI = true; }
-		else if (x == "right") { I = Vec3(0, -1, 0); hasI = true; }
-		else if (x == "up") { I = Vec3(0, 0, +1); hasI = true; }
-		else if (x == "down") { I = Vec3(0, 0, -1); hasI = true; }
-		else if (x == "forward") { I = Vec3(+1, 0, 0); hasI = true; }
-		else if (x == "back") { I = Vec3(-1, 0, 0); hasI = true; }
-	}
-
-	if (!y.empty()) 
-    {
-		if (y == "left") { J = Vec3(0, +1, 0); hasJ = true; }
-		else if (y == "right") { J = Vec3(0, -1, 0); hasJ = true; }
-		else if (y == "up") { J = Vec3(0, 0, +1); hasJ = true; }
-		else if (y == "down") { J = Vec3(0, 0, -1); hasJ = true; }
-		else if (y == "forward") { J = Vec3(+1, 0, 0); hasJ = true; }
-		else if (y == "back") { J = Vec3(-1, 0, 0); hasJ = true; }
-	}
-
-	if (!z.empty()) 
-    {
-		if (z == "left") { K = Vec3(0, +1, 0); hasK = true; }
-		else if (z == "right") { K = Vec3(0, -1, 0); hasK = true; }
-		else if (z == "up") { K = Vec3(0, 0, +1); hasK = true; }
-		else if (z == "down") { K = Vec3(0, 0, -1); hasK = true; }
-		else if (z == "forward") { K = Vec3(+1, 0, 0); hasK = true; }
-		else if (z == "back") { K = Vec3(-1, 0, 0); hasK = true; }
-	}
-
-	int count = (int)hasI + (int)hasJ + (int)hasK;
-	if (count == 1) 
-    {
-		if (hasI) 
-        {
-			Vec3 temp = (std::fabs(I.z) < 0.9f) ? Vec3(0, 0, 1) : Vec3(0, 1, 0);
-			J = CrossProduct3D(temp, I);       
-			K = CrossProduct3D(I, J);
-		}
-		else if (hasJ) 
-        {
-			Vec3 temp = (std::fabs(J.z) < 0.9f) ? Vec3(0, 0, 1) : Vec3(1, 0, 0);
-			K = CrossProduct3D(J, temp);
-			I = CrossProduct3D(J, K);       
-		}
-		else 
-        { 
-			Vec3 temp = (std::fabs(K.y) < 0.9f) ? Vec3(0, 1, 0) : Vec3(1, 0, 0);
-			I = CrossProduct3D(K, temp);
-			J = CrossProduct3D(K, I);      
-		}
-	}
-	else if (count == 2) 
-    {
-		if (!hasK) { K = CrossProduct3D(I, J); }
-		else if (!hasJ) { J = CrossProduct3D(K, I); }
-		else if (!hasI) { I = CrossProduct3D(J, K); }
-	}
-	Mat44 M;
-	M.SetIJK3D(I, J, K);
-	M.Orthonormalize_IFwd_JLeft_KUp();
-	m_transform = M;
-
-    m_unitsPerMeter = ParseXmlAttribute(*meshElement, "unitsPerMeter", 1.f);
+    ParseStaticMeshTransform(*meshElement, m_transform, m_transformWithoutAxisTransform, m_unitsPerMeter);
     m_modelRelativeScale = 1.f / m_unitsPerMeter;
-    Mat44 mat;
-    mat = mat.MakeUniformScale3D(1/m_unitsPerMeter);
-	m_transformWithoutAxisTransform = mat;
-    m_transform.Append(mat);
-	
-    Vec3 translation = ParseXmlAttribute(*meshElement, "translation", Vec3(0.f, 0.f, 0.f));
-    Mat44 translate;
-    translate.SetTranslation3D(translation);
-    m_transform.Append(translate);
-	m_transformWithoutAxisTransform.Append(translate);
+    if (!importedGeometry->m_hasBounds)
+        m_bounds = ComputeStaticMeshBounds(m_verts, m_transform, m_transformWithoutAxisTransform, m_modelRelativeScale);
 
     //ApplyTransformToVertices();
 
@@ -175,6 +431,20 @@ StaticMesh::StaticMesh(Renderer* renderer, std::string const& xmlPathNoExtension
 	}
 }
 
+StaticMesh::StaticMesh(Renderer* renderer, std::string const& name, StaticMeshGeometry& geometry)
+    : m_filePath(name)
+    , m_unitsPerMeter(1.f)
+    , m_modelRelativeScale(1.f)
+{
+    m_verts.swap(geometry.m_verts);
+    m_indices.swap(geometry.m_indices);
+    m_isOptimized = geometry.m_isOptimized;
+    m_optimizationReport = geometry.m_optimizationReport;
+    m_meshlets = std::move(geometry.m_meshlets);
+    UploadGeometry(renderer, false);
+    m_bounds = ComputeStaticMeshBounds(m_verts, m_transform, m_transformWithoutAxisTransform, m_modelRelativeScale);
+}
+
 StaticMesh::~StaticMesh()
 {
     delete m_vertexBuffer;
@@ -183,138 +453,448 @@ StaticMesh::~StaticMesh()
     m_indexBuffer = nullptr;
 }
 
-void StaticMesh::GenerateCardTemplates()
+bool StaticMesh::ImportGeometry(std::string const& xmlPathNoExtensions, StaticMeshGeometry& out, bool forceRecook)
 {
-	if (m_hasCardTemplates)
-		return;
+    if (LoadCookedGeometry(xmlPathNoExtensions, out, forceRecook))
+        return true;
+    return ImportGeometryFromSource(xmlPathNoExtensions, out);
+}
 
-	AABB3 bounds = GetAABB3Bounds();
-	Vec3 size = bounds.m_maxs - bounds.m_mins;
+bool StaticMesh::LoadCookedGeometry(std::string const& xmlPathNoExtensions, StaticMeshGeometry& out, bool skipCook)
+{
+    double startTime = GetCurrentTimeSeconds();
+    out = StaticMeshGeometry();
 
-	for (int dir = 0; dir < 6; dir++)
-	{
-		SurfaceCardTemplate templ;
-		templ.m_direction = (uint8_t)dir;
+    XmlDocument meshDefDoc;
+    if (LoadXmlFile(meshDefDoc, xmlPathNoExtensions + ".xml") != XmlResult::XML_SUCCESS)
+        return false;
+    XmlElement* meshElement = meshDefDoc.RootElement();
 
-		switch (dir)
-		{
-		case 0: case 1:  // ±X
-			templ.m_localSize = Vec2(size.y, size.z);
-			break;
-		case 2: case 3:  // ±Y
-			templ.m_localSize = Vec2(size.x, size.z);
-			break;
-		case 4: case 5:  // ±Z
-			templ.m_localSize = Vec2(size.x, size.y);
-			break;
-		}
+    std::string filePath = ParseXmlAttribute(*meshElement, "objFile", "");
+    std::string mtlPath = ParseXmlAttribute(*meshElement, "mtllib", "");
+    // cooked="false" 每次都从源文件导入，不读也不写 <xml>.cooked
+    if (filePath.empty() || !ParseXmlAttribute(*meshElement, "cooked", true))
+        return false;
+
+    double keyStart = GetCurrentTimeSeconds();
+    std::vector<std::string> sourceFiles = { xmlPathNoExtensions + ".xml", filePath };
+    if (!mtlPath.empty())
+        sourceFiles.push_back(mtlPath);
+    StaticMeshCookSettings settings;
+    out.m_cookedPath = xmlPathNoExtensions + ".cooked";
+    out.m_cookKey = ComputeCookedSourceKey(sourceFiles, &settings, sizeof(settings));
+    out.m_keyMilliseconds = (GetCurrentTimeSeconds() - keyStart) * 1000.0;
+
+    bool isLoaded = !skipCook && LoadCookedStaticMesh(out.m_cookedPath, out.m_cookKey, out);
+    out.m_importMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+    return isLoaded;
+}
 
-		float maxDim = max(templ.m_localSize.x, templ.m_localSize.y);
-		int resolution;
-
-		if (maxDim < 1.0f)
-			resolution = 32;        
-		else if (maxDim < 3.0f)
-			resolution = 64;        
-		else if (maxDim < 8.0f)
-			resolution = 128;       
-		else if (maxDim < 16.0f)
-			resolution = 256;       
-		else
-			resolution = 512;       
+bool StaticMesh::ImportGeometryFromSource(std::string const& xmlPathNoExtensions, StaticMeshGeometry& out)
+{
+    double startTime = GetCurrentTimeSeconds();
+
+    // 只留 LoadCookedGeometry 给的 cook path / key（可能读了一半的 cook 不要）
+    StaticMeshGeometry cookInfo;
+    cookInfo.m_cookedPath.swap(out.m_cookedPath);
+    cookInfo.m_cookKey = out.m_cookKey;
+    cookInfo.m_keyMilliseconds = out.m_keyMilliseconds;
+    cookInfo.m_importMilliseconds = out.m_importMilliseconds;
+    out = std::move(cookInfo);
+
+    XmlDocument meshDefDoc;
+    if (LoadXmlFile(meshDefDoc, xmlPathNoExtensions + ".xml") != XmlResult::XML_SUCCESS)
+        return false;
+    XmlElement* meshElement = meshDefDoc.RootElement();
 
-		templ.m_recommendedResolution = IntVec2(resolution, resolution);
+    std::string filePath = ParseXmlAttribute(*meshElement, "objFile", "");
+    bool flipUV = ParseXmlAttribute(*meshElement, "flipUV", false);
+    std::string mtlPath = ParseXmlAttribute(*meshElement, "mtllib", "");
+    if (filePath.empty())
+        return false;
+    bool useCook = !out.m_cookedPath.empty();
 
-		m_cardTemplates.push_back(templ);
-	}
+    if (EndsWith(filePath, ".glb"))
+    {
+        // 几何和材质贴图一次解析拿到，ctor 不用再读一遍文件
+        GLBImportSettings glbSettings;
+        glbSettings.m_flipUV = flipUV;
+        GLBImportResult glb;
+        out.m_isLoaded = ImportGLBFile(filePath, glb, glbSettings);
+        if (out.m_isLoaded)
+        {
+            out.m_verts.swap(glb.m_verts);
+            out.m_indices.swap(glb.m_indices);
+            TakeGLBImages(glb, out);
+            PrintGLBImportStats(filePath, glb.m_stats);
+        }
+    }
+    else
+    {
+        out.m_isLoaded = LoadStaticMeshFile(out.m_verts, out.m_indices, filePath, flipUV, mtlPath);
+    }
+    if (!out.m_isLoaded)
+        return false;
+
+    // optimize="false" 保留文件里的顺序（调试 / 对比用）
+    if (ParseXmlAttribute(*meshElement, "optimize", true))
+    {
+        out.m_optimizationReport = OptimizeMesh(out.m_verts, out.m_indices);
+        out.m_isOptimized = true;
+    }
+    // meshlets="true" 才切 meshlet：会改 index 顺序（ACMR 变差），只有走 DrawVisibleMeshlets 的 mesh 才值得
+    if (ParseXmlAttribute(*meshElement, "meshlets", false))
+    {
+        BuildMeshlets(out.m_verts, out.m_indices, out.m_meshlets);
+        // 报告的是最终（meshlet）顺序，不是 OptimizeMesh 刚排完的
+        if (out.m_isOptimized)
+            out.m_optimizationReport.m_after = AnalyzeVertexCache(out.m_indices, (uint32_t)out.m_verts.size());
+    }
 
-	m_hasCardTemplates = true;
+    if (useCook)
+    {
+        double cookStart = GetCurrentTimeSeconds();
+        Mat44 transform;
+        Mat44 transformWithoutAxisTransform;
+        float unitsPerMeter = 1.f;
+        ParseStaticMeshTransform(*meshElement, transform, transformWithoutAxisTransform, unitsPerMeter);
+        out.m_bounds = ComputeStaticMeshBounds(out.m_verts, transform, transformWithoutAxisTransform, 1.f / unitsPerMeter);
+        out.m_hasBounds = true;
+
+        // BuildBVH(1) 的空间：GetTransformedVertices，只有位置参与划分
+        std::vector<Vertex_PCUTBN> transformed = out.m_verts;
+        for (Vertex_PCUTBN& vert : transformed)
+        {
+            vert.m_position = transform.TransformPosition3D(vert.m_position);
+        }
+        BVH bvh;
+        bvh.Build(transformed, out.m_indices);
+        if (!bvh.IsEmpty())
+            bvh.FlattenForGPU(out.m_bvhNodes, out.m_bvhTriangles);
+
+        out.m_cookedBytes = WriteCookedStaticMesh(out.m_cookedPath, out.m_cookKey, out.m_verts, out.m_indices, out.m_bounds,
+            out.m_isOptimized ? &out.m_optimizationReport : nullptr, out.m_meshlets, out.m_bvhNodes, out.m_bvhTriangles,
+            out.m_cardTemplates, out.m_cardReport, out.m_sdfVolumes, out.m_sdfDistances);
+        if (out.m_cookedBytes == 0)
+        {
+            DebuggerPrintf("[StaticMesh] Could not write cooked mesh to %s\n", out.m_cookedPath.c_str());
+        }
+        out.m_cookMilliseconds = (GetCurrentTimeSeconds() - cookStart) * 1000.0;
+    }
+    out.m_importMilliseconds += (GetCurrentTimeSeconds() - startTime) * 1000.0;
+    return true;
 }
 
-SurfaceCardTemplate* StaticMesh::GetCardTemplate(uint8_t direction)
+bool StaticMesh::DecodeGLBImages(std::string const& glbFilePath, StaticMeshGeometry& out)
 {
-	if (!m_hasCardTemplates || direction >= m_cardTemplates.size())
-		return nullptr;
-	return &m_cardTemplates[direction];
+    GLBImportSettings glbSettings;
+    glbSettings.m_loadGeometry = false;
+    GLBImportResult glb;
+    if (!ImportGLBFile(glbFilePath, glb, glbSettings))
+        return false;
+    TakeGLBImages(glb, out);
+    PrintGLBImportStats(glbFilePath, glb.m_stats);
+    return true;
 }
 
-const SurfaceCardTemplate* StaticMesh::GetCardTemplate(uint8_t direction) const
+void StaticMesh::ImportGeometryForMeshes(std::vector<std::string> const& xmlPathsNoExtensions, std::vector<StaticMeshGeometry>& out)
 {
-	if (!m_hasCardTemplates || direction >= m_cardTemplates.size())
-		return nullptr;
-	return &m_cardTemplates[direction];
+    out.clear();
+    out.resize(xmlPathsNoExtensions.size());
+    ParallelFor((uint32_t)xmlPathsNoExtensions.size(), 1, [&xmlPathsNoExtensions, &out](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            ImportGeometry(xmlPathsNoExtensions[i], out[i]);
+        }
+    });
 }
 
-Sphere StaticMesh::GetBoundsSphere() const
+bool StaticMesh::CookOffline(std::string const& xmlPathNoExtensions, StaticMeshCookOptions const& options, StaticMeshCookReport& outReport)
 {
-    Sphere bs;
-    if (m_verts.empty())
-        return bs;
+    outReport = StaticMeshCookReport();
+    double startTime = GetCurrentTimeSeconds();
 
-    Vec3 c = Vec3();
-    for (const auto& v : m_verts) c += v.m_position;
-    c /= static_cast<float>(m_verts.size());
+    XmlDocument meshDefDoc;
+    if (LoadXmlFile(meshDefDoc, xmlPathNoExtensions + ".xml") != XmlResult::XML_SUCCESS)
+        return false;
+    XmlElement* meshElement = meshDefDoc.RootElement();
+    if (!ParseXmlAttribute(*meshElement, "cooked", true))
+    {
+        outReport.m_isCookDisabled = true;
+        return true;
+    }
 
-    float r2 = 0.f;
-    for (const auto& v : m_verts)
+    StaticMeshGeometry geometry;
+    bool hasCook = LoadCookedGeometry(xmlPathNoExtensions, geometry, options.m_force);
+    if (geometry.m_cookedPath.empty())
+        return false;
+
+    // 和 GenerateCardTemplates 一样：AABB card 不进 cook，只有按几何放的才要
+    CardGenerationConfig cardConfig;
+    bool wantsCards = options.m_cardTemplates && cardConfig.m_useGeometryAwarePlacement;
+    bool needsCards = wantsCards && geometry.m_cardTemplates.empty();
+    bool needsSDF = options.m_sdfResolution > 1;
+    for (CookedMeshSDFVolume const& volume : geometry.m_sdfVolumes)
     {
-        r2 = MaxF(r2, (v.m_position - c).GetLengthSquared());
+        if (volume.m_scale == 1.f && volume.m_resolution == options.m_sdfResolution)
+            needsSDF = false;
     }
+    outReport.m_sdfResolution = options.m_sdfResolution > 1 ? options.m_sdfResolution : 0;
 
-    bs.m_center = c;
-    bs.m_radius = sqrtf(r2) * m_modelRelativeScale;
+    if (hasCook && !needsCards && !needsSDF)
+    {
+        outReport.m_wasUpToDate = true;
+        outReport.m_triangleCount = (uint32_t)(geometry.m_indices.size() / 3);
+        outReport.m_cardCount = (uint32_t)geometry.m_cardTemplates.size();
+        outReport.m_cookedBytes = geometry.m_cookedBytes;
+        outReport.m_importMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+        return true;
+    }
+    if (!hasCook && !ImportGeometryFromSource(xmlPathNoExtensions, geometry))
+        return false;
+    outReport.m_triangleCount = (uint32_t)(geometry.m_indices.size() / 3);
+    outReport.m_importMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+
+    Mat44 transform;
+    Mat44 transformWithoutAxisTransform;
+    float unitsPerMeter = 1.f;
+    ParseStaticMeshTransform(*meshElement, transform, transformWithoutAxisTransform, unitsPerMeter);
+    std::vector<Vertex_PCUTBN> transformed = TransformStaticMeshVertices(geometry.m_verts, transform);
+
+    if (needsCards && !geometry.m_indices.empty())
+    {
+        double cardStart = GetCurrentTimeSeconds();
+        SurfaceCardGenerationResult result = GenerateSurfaceCards(transformed, geometry.m_indices, cardConfig);
+        geometry.m_cardTemplates = result.m_templates;
+        geometry.m_cardReport = result.m_report;
+        outReport.m_cardMilliseconds = (GetCurrentTimeSeconds() - cardStart) * 1000.0;
+    }
+    outReport.m_cardCount = (uint32_t)geometry.m_cardTemplates.size();
+
+    if (needsSDF)
+    {
+        // Scene 的 GPU 版：GetScaledAndTransformedVertices(1) 在 GetScaledBounds(1) 里
+        double sdfStart = GetCurrentTimeSeconds();
+        CookedMeshSDFVolume volume;
+        volume.m_bounds = geometry.m_bounds.m_transformedBounds;
+        volume.m_scale = 1.f;
+        volume.m_resolution = options.m_sdfResolution;
+        volume.m_firstDistance = 0;
+        geometry.m_sdfVolumes.clear();
+        if (BakeMeshSDF(transformed, geometry.m_indices, volume.m_bounds, volume.m_resolution, geometry.m_sdfDistances))
+            geometry.m_sdfVolumes.push_back(volume);
+        else
+            DebuggerPrintf("[StaticMesh] %s: no triangles to bake an SDF from\n", xmlPathNoExtensions.c_str());
+        outReport.m_sdfMilliseconds = (GetCurrentTimeSeconds() - sdfStart) * 1000.0;
+    }
 
-    return bs;
+    outReport.m_cookedBytes = WriteCookedStaticMesh(geometry.m_cookedPath, geometry.m_cookKey, geometry.m_verts, geometry.m_indices, geometry.m_bounds,
+        geometry.m_isOptimized ? &geometry.m_optimizationReport : nullptr, geometry.m_meshlets, geometry.m_bvhNodes, geometry.m_bvhTriangles,
+        geometry.m_cardTemplates, geometry.m_cardReport, geometry.m_sdfVolumes, geometry.m_sdfDistances);
+    if (outReport.m_cookedBytes == 0)
+    {
+        DebuggerPrintf("[StaticMesh] Could not write cooked mesh to %s\n", geometry.m_cookedPath.c_str());
+        return false;
+    }
+    return true;
 }
 
-Sphere StaticMesh::GetTransformedBoundsSphere() const
+void StaticMesh::SaveCooked()
 {
-	Sphere bs;
+    if (m_cookedPath.empty())
+        return;
 
-	if (m_verts.empty())
-		return bs;
+    uint64_t cookedBytes = WriteCookedStaticMesh(m_cookedPath, m_cookKey, m_verts, m_indices, m_bounds,
+        m_isOptimized ? &m_optimizationReport : nullptr, m_meshlets, m_cookedBVHNodes, m_cookedBVHTriangles,
+        m_cardTemplates, m_cardReport, m_cookedSDFVolumes, m_cookedSDFDistances);
+    if (cookedBytes == 0)
+    {
+        DebuggerPrintf("[StaticMesh] Could not write cooked mesh to %s\n", m_cookedPath.c_str());
+        return;
+    }
+    m_loadReport.m_cookedBytes = cookedBytes;
+}
 
-	std::vector<Vertex_PCUTBN> transformed = GetTransformedVertices();
+void StaticMesh::UploadGeometry(Renderer* renderer, bool packVertices)
+{
+    std::vector<uint16_t> indices16;
+    m_uses16BitIndices = NarrowIndicesTo16(m_indices, indices16);
+    if (m_uses16BitIndices)
+    {
+        m_indexBuffer = renderer->CreateIndexBuffer((unsigned int)(indices16.size() * sizeof(uint16_t)), sizeof(uint16_t));
+        renderer->CopyCPUToGPU(indices16.data(), (unsigned int)(indices16.size() * sizeof(uint16_t)), m_indexBuffer);
+    }
+    else
+    {
+        m_indexBuffer = renderer->CreateIndexBuffer((unsigned int)m_indices.size() * sizeof(unsigned int), sizeof(unsigned int));
+        renderer->CopyCPUToGPU(m_indices.data(), (unsigned int)(m_indices.size() * sizeof(unsigned int)), m_indexBuffer);
+    }
+
+    if (packVertices)
+    {
+        PackedMeshData packed;
+        PackStaticMeshVertices(m_verts, m_indices, packed);
+        m_quantization = packed.m_quantization;
+        m_quantizationReport = packed.m_report;
+
+        VertexQuantizationReport const& report = m_quantizationReport;
+        DebuggerPrintf("[StaticMesh] %s: packed %u verts, pos err max %.5f (step %.5f), N/T/B err max %.3f/%.3f/%.3f deg, uv err max %.5f, %zu -> %zu bytes (x%.2f)%s\n",
+            m_filePath.c_str(), report.m_vertexCount, report.m_maxPositionError, m_quantization.GetPositionStep(),
+            report.m_maxNormalErrorDegrees, report.m_maxTangentErrorDegrees, report.m_maxBitangentErrorDegrees,
+            report.m_maxUVError, report.GetOriginalBytes(), report.GetPackedBytes(), report.GetCompressionRatio(),
+            m_uses16BitIndices ? " [16-bit indices]" : "");
+
+#ifdef ENGINE_DX12_RENDERER
+        // card capture / deferred PSO 只认 Vertex_PCUTBN，DX12 下先只出报告
+        DebuggerPrintf("[StaticMesh] %s: packed vertex stream is not wired into the DX12 pipelines, uploading Vertex_PCUTBN\n", m_filePath.c_str());
+#else
+        m_vertexBuffer = renderer->CreateVertexBuffer((unsigned int)(packed.m_verts.size() * sizeof(Vertex_PCUTBNPacked)), sizeof(Vertex_PCUTBNPacked));
+        renderer->CopyCPUToGPU(packed.m_verts.data(), (unsigned int)(packed.m_verts.size() * sizeof(Vertex_PCUTBNPacked)), m_vertexBuffer);
+        m_usesPackedVertices = true;
+        return;
+#endif
+    }
+
+    m_vertexBuffer = renderer->CreateVertexBuffer((unsigned int)m_verts.size() * sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN));
+    renderer->CopyCPUToGPU(m_verts.data(), (unsigned int)(m_verts.size() * sizeof(Vertex_PCUTBN)), m_vertexBuffer);
+}
 
-	Vec3 center = Vec3();
-	for (const auto& v : transformed)
+Mat44 StaticMesh::GetVertexDequantizationTransform() const
+{
+    if (!m_usesPackedVertices)
+        return Mat44();
+    return m_quantization.GetDequantizationTransform();
+}
+
+uint32_t StaticMesh::GetMaterialID() const
+{
+    void const* parts[4] = { m_shader, m_diffuseTexture, m_normalTexture, m_specularTexture };
+    uint64_t hash = 0x9E3779B97F4A7C15ull;
+    for (void const* part : parts)
+    {
+        uint64_t bits = (uint64_t)(uintptr_t)part;
+        hash = MixHash(hash, (uint32_t)bits);
+        hash = MixHash(hash, (uint32_t)(bits >> 32));
+    }
+    return (uint32_t)FinalizeHash(hash);
+}
+
+MeshletCullStats StaticMesh::DrawVisibleMeshlets(Renderer* renderer, Mat44 const& modelToWorld, Frustum const& worldFrustum, Vec3 const& cameraWorldPosition) const
+{
+    MeshletCullStats stats;
+    if (m_meshlets.IsEmpty())
+    {
+        renderer->DrawIndexBuffer(m_vertexBuffer, m_indexBuffer, (unsigned int)m_indices.size());
+        stats.m_trianglesTotal = stats.m_trianglesVisible = (uint32_t)(m_indices.size() / 3);
+        stats.m_rangeCount = 1;
+        return stats;
+    }
+
+    std::vector<MeshletIndexRange> ranges;
+    CullMeshlets(m_meshlets, modelToWorld, worldFrustum, cameraWorldPosition, ranges, stats);
+    for (MeshletIndexRange const& range : ranges)
+    {
+        renderer->DrawIndexBuffer(m_vertexBuffer, m_indexBuffer, range.m_indexCount, PRIMITIVE_TRIANGLES, range.m_firstIndex);
+    }
+    return stats;
+}
+
+void StaticMesh::GenerateCardTemplates()
+{
+	if (m_hasCardTemplates)
+		return;
+
+	CardGenerationConfig config;
+	if (!config.m_useGeometryAwarePlacement || m_indices.empty())
 	{
-		center += v.m_position;
+		GenerateAABBCardTemplates(GetAABB3Bounds(), config, m_cardTemplates);
+		m_hasCardTemplates = true;
+		return;
 	}
-	center /= static_cast<float>(transformed.size());
 
-	float maxRadiusSq = 0.f;
-	for (const auto& v : transformed)
+	// 从 cook 里读出来的 card（card 配置在 cook key 里，不会过期）
+	if (!m_cardTemplates.empty())
 	{
-		maxRadiusSq = MaxF(maxRadiusSq, (v.m_position - center).GetLengthSquared());
+		m_hasCardTemplates = true;
 	}
+	else
+	{
+		// 与 MeshObject::GetLocalBounds 同一个空间
+		std::vector<Vertex_PCUTBN> transformed = GetTransformedVertices();
+		SurfaceCardGenerationResult result;
+		if (!m_cookedPath.empty())
+		{
+			// card 跟着 mesh 写进 <xml>.cooked，不再单独写 .cards
+			result = GenerateSurfaceCards(transformed, m_indices, config);
+		}
+		else
+		{
+			uint64_t cacheKey = ComputeSurfaceCardCacheKey(transformed, m_indices, config);
+			std::string cachePath = m_filePath + ".cards";
+			if (!LoadCookedSurfaceCards(cachePath, cacheKey, result))
+			{
+				result = GenerateSurfaceCards(transformed, m_indices, config);
+				if (!SaveCookedSurfaceCards(cachePath, cacheKey, result))
+				{
+					DebuggerPrintf("[StaticMesh] Could not write cooked cards to %s\n", cachePath.c_str());
+				}
+			}
+		}
 
-	bs.m_center = center;
-	bs.m_radius = sqrtf(maxRadiusSq);
+		m_cardTemplates = result.m_templates;
+		m_cardReport = result.m_report;
+		m_hasCardTemplates = true;
+		SaveCooked();
+	}
 
-	return bs;
+	DebuggerPrintf("[StaticMesh] %s: %u cards (%u dropped) from %u tris, texel efficiency %.2f (AABB %.2f), texels %u (AABB %u)%s\n",
+		m_filePath.c_str(), m_cardReport.m_cardCount, m_cardReport.m_droppedCardCount, m_cardReport.m_triangleCount,
+		m_cardReport.m_texelEfficiency, m_cardReport.m_aabbTexelEfficiency,
+		m_cardReport.m_texelCount, m_cardReport.m_aabbTexelCount,
+		m_cardReport.m_loadedFromCache ? " [cached]" : "");
 }
 
-AABB3 StaticMesh::GetAABB3Bounds() const
+void StaticMesh::GenerateCardTemplatesForMeshes(std::vector<StaticMesh*> const& meshes)
 {
-    AABB3 box;
-    Vec3 mn = Vec3(FLT_MAX, FLT_MAX, FLT_MAX);
-    Vec3 mx = Vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
-    for (Vertex_PCUTBN vert : m_verts)
-    {
-        Vec3 p = vert.m_position;
-		mn.x = MinF(mn.x, p.x); 
-        mn.y = MinF(mn.y, p.y); 
-        mn.z = MinF(mn.z, p.z);
+	// 每个 mesh 只写自己的成员和自己的缓存文件，可以直接并行
+	ParallelFor((uint32_t)meshes.size(), 1, [&meshes](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; i++)
+		{
+			if (meshes[i])
+				meshes[i]->GenerateCardTemplates();
+		}
+	});
+}
 
-		mx.x = MaxF(mx.x, p.x); 
-        mx.y = MaxF(mx.y, p.y); 
-        mx.z = MaxF(mx.z, p.z);
+SurfaceCardTemplate* StaticMesh::GetCardTemplate(uint8_t direction)
+{
+	if (!m_hasCardTemplates || direction >= m_cardTemplates.size())
+		return nullptr;
+	return &m_cardTemplates[direction];
+}
 
-		box.m_mins = mn; 
-        box.m_maxs = mx;
-    }
-    return box;
+const SurfaceCardTemplate* StaticMesh::GetCardTemplate(uint8_t direction) const
+{
+	if (!m_hasCardTemplates || direction >= m_cardTemplates.size())
+		return nullptr;
+	return &m_cardTemplates[direction];
+}
+
+Sphere StaticMesh::GetBoundsSphere() const
+{
+    return m_bounds.m_boundsSphere;
+}
+
+Sphere StaticMesh::GetTransformedBoundsSphere() const
+{
+	return m_bounds.m_transformedBoundsSphere;
+}
+
+AABB3 StaticMesh::GetAABB3Bounds() const
+{
+    return m_bounds.m_localBounds;
 }
 
 void StaticMesh::ApplyTransformToVertices()
@@ -344,6 +924,8 @@ void StaticMesh::ApplyTransformToVertices()
 	}
 
 	m_transform = Mat44();
+	m_bounds = ComputeStaticMeshBounds(m_verts, m_transform, m_transformWithoutAxisTransform, m_modelRelativeScale);
+	m_cookedPath.clear();    // cook 里存的是未变换的顶点
 
 	DebuggerPrintf("[StaticMesh] Transform applied and reset to identity\n");
 }
@@ -365,36 +947,12 @@ AABB3 StaticMesh::GetScaledBounds(float scale) const //Transformed 版本
 
 AABB3 StaticMesh::GetTransformedAABB3Bounds() const
 {
-	AABB3 box;
-
-	if (m_verts.empty())
-		return box;
-
-	std::vector<Vertex_PCUTBN> transformed = GetTransformedVertices();
-
-	for (const auto& vert : transformed)
-	{
-		box.StretchToIncludePoint(vert.m_position);
-	}
-
-	return box;
+	return m_bounds.m_transformedBounds;
 }
 
 AABB3 StaticMesh::GetTransformedAABB3BoundsWithoutAxisTransform() const
 {
-	AABB3 box;
-
-	if (m_verts.empty())
-		return box;
-
-	std::vector<Vertex_PCUTBN> transformed = GetTransformedVerticesWithoutAxisTransform();
-
-	for (const auto& vert : transformed)
-	{
-		box.StretchToIncludePoint(vert.m_position);
-	}
-
-	return box;
+	return m_bounds.m_transformedBoundsWithoutAxisTransform;
 }
 
 void StaticMesh::BuildBVH(float scale)
@@ -413,6 +971,26 @@ void StaticMesh::BuildBVH(float scale)
 		return;
 	}
 
+	if (!m_cookedBVHNodes.empty())
+	{
+		// 划分只看相对位置，均匀缩放后树不变（centroid 相同的三角形顺序可能不同，仍是合法 BVH）：
+		// cook 里 scale 1 的节点把 bounds 乘上 scale 就行
+		std::vector<GPUBVHNode> nodes = m_cookedBVHNodes;
+		for (GPUBVHNode& node : nodes)
+		{
+			Vec3 a = node.m_boundsMin * scale;
+			Vec3 b = node.m_boundsMax * scale;
+			node.m_boundsMin = Vec3(MinF(a.x, b.x), MinF(a.y, b.y), MinF(a.z, b.z));
+			node.m_boundsMax = Vec3(MaxF(a.x, b.x), MaxF(a.y, b.y), MaxF(a.z, b.z));
+		}
+		BVH bvh;
+		bvh.SetFlattened(std::move(nodes), m_cookedBVHTriangles);
+		m_bvhsByScale.emplace(quantized, std::move(bvh));
+
+		DebuggerPrintf("[StaticMesh] BVH for scale=%.1f from the cooked nodes (%zu)\n", quantized, m_cookedBVHNodes.size());
+		return;
+	}
+
 	DebuggerPrintf("[StaticMesh] Building BVH for scale=%.1f with %zu verts, %zu indices\n",
 		quantized, m_verts.size(), m_indices.size());
 
@@ -469,6 +1047,21 @@ bool StaticMesh::HasSDF(float scale) const
 	return GetSDF(scale) != nullptr;
 }
 
+float const* StaticMesh::GetCookedSDFDistances(float scale, int& outResolution) const
+{
+	float quantized = QuantizeScale(scale);
+	for (CookedMeshSDFVolume const& volume : m_cookedSDFVolumes)
+	{
+		if (QuantizeScale(volume.m_scale) == quantized && volume.m_resolution > 1)
+		{
+			outResolution = volume.m_resolution;
+			return m_cookedSDFDistances.data() + volume.m_firstDistance;
+		}
+	}
+	outResolution = 0;
+	return nullptr;
+}
+
 std::vector<Vertex_PCUTBN> StaticMesh::GetScaledAndTransformedVertices(float scale) const
 {
 	std::vector<Vertex_PCUTBN> transformed = GetTransformedVertices();
@@ -487,25 +1080,8 @@ std::vector<Vertex_PCUTBN> StaticMesh::GetScaledAndTransformedVertices(float sca
 
 std::vector<Vertex_PCUTBN> StaticMesh::GetTransformedVertices() const
 {
-	std::vector<Vertex_PCUTBN> transformed = m_verts;
-
-	for (auto& vert : transformed)
-	{
-		// 应用完整的mesh transform（轴变换 + scale + translation）
-		vert.m_position = m_transform.TransformPosition3D(vert.m_position);
-
-		// 法线只应用旋转（不受scale和translation影响）
-		vert.m_normal = m_transform.TransformVectorQuantity3D(vert.m_normal);
-		vert.m_normal.GetNormalized();
-
-		vert.m_tangent = m_transform.TransformVectorQuantity3D(vert.m_tangent);
-		vert.m_tangent.GetNormalized();
-
-		vert.m_bitangent = m_transform.TransformVectorQuantity3D(vert.m_bitangent);
-		vert.m_bitangent.GetNormalized();
-	}
-
-	return transformed;
+	// 应用完整的mesh transform（轴变换 + scale + translation），CookOffline 用同一份
+	return TransformStaticMeshVertices(m_verts, m_transform);
 }
 
 std::vector<Vertex_PCUTBN> StaticMesh::GetTransformedVerticesWithoutAxisTransform() const
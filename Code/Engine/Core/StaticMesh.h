@@ -3,12 +3,20 @@
 #include <vector>
 
 #include "Vertex_PCUTBN.hpp"
+#include "VertexQuantization.h"
+#include "CookedMesh.h"
+#include "MeshOptimizer.h"
+#include "Meshlet.h"
+#include "Image.hpp"
+#include "BlockCompression.h"
 #include "Engine/Math/Sphere.h"
 #include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/Cache/SurfaceCardGenerator.h"
 #include "Engine/Scene/BVH.h"
 
 struct SurfaceCardTemplate;
 class SDFTexture3D;
+class Renderer;
 
 enum class StaticMeshType
 {
@@ -27,13 +35,111 @@ enum class GLBChannel
     Count
 };
 
+// CPU 侧的 import 结果（读文件 + 优化），可以在 job 线程上做；GPU 资源回到主线程再建
+struct StaticMeshGeometry
+{
+    std::vector<Vertex_PCUTBN> m_verts;
+    std::vector<unsigned int> m_indices;
+    MeshOptimizationReport m_optimizationReport;
+    MeshletData m_meshlets;             // m_indices are in meshlet order when this is not empty
+    bool m_isOptimized = false;
+    bool m_isLoaded = false;
+
+    // cooked container (<xml>.cooked)；cooked="false" 时全部留空，StaticMesh 自己算
+    std::string m_cookedPath;
+    uint64_t m_cookKey = 0;
+    bool m_isFromCooked = false;
+    bool m_hasBounds = false;
+    CookedMeshBounds m_bounds;
+    std::vector<GPUBVHNode> m_bvhNodes;         // scale 1
+    std::vector<uint32_t> m_bvhTriangles;
+    std::vector<SurfaceCardTemplate> m_cardTemplates;   // only once GenerateCardTemplates saved them into the cook
+    SurfaceCardGenerationReport m_cardReport;
+    std::vector<CookedMeshSDFVolume> m_sdfVolumes;      // only if an offline cook (CookOffline) baked them
+    std::vector<float> m_sdfDistances;
+    double m_importMilliseconds = 0.0;
+    double m_keyMilliseconds = 0.0;
+    double m_cookMilliseconds = 0.0;            // cold import only: bounds + BVH + write
+    uint64_t m_cookedBytes = 0;
+
+    // normalMap / diffuseMap / specGlossEmitMap decoded off the main thread (AssetStreamer);
+    // the constructor only uploads them. Empty (0x0) -> the constructor reads the file itself
+    Image m_normalImage;
+    Image m_diffuseImage;
+    Image m_specularImage;
+    // their mip chains, built on the worker too (or read from <texture>.mips); when a chain is
+    // there the constructor uploads it instead of the image
+    ImageMipChain m_normalMips;
+    ImageMipChain m_diffuseMips;
+    ImageMipChain m_specularMips;
+    // or their BCn blocks (normalMapCompression / textureCompression in the mesh xml)
+    CompressedMipChain m_normalBlocks;
+    CompressedMipChain m_diffuseBlocks;
+    CompressedMipChain m_specularBlocks;
+
+    // .glb 材质里的贴图（GLBImporter），和几何同一次解析；cook 命中时由 DecodeGLBImages 单独解
+    bool m_hasGLBImages = false;
+    Image m_glbAlbedoImage;
+    Image m_glbNormalImage;
+    Image m_glbOcclusionImage;
+};
+
+struct StaticMeshLoadReport
+{
+    bool m_loadedFromCooked = false;
+    double m_importMilliseconds = 0.0;          // whole ImportGeometry
+    double m_keyMilliseconds = 0.0;             // hashing xml + source files for the cook key
+    double m_cookMilliseconds = 0.0;
+    uint64_t m_cookedBytes = 0;
+};
+
+// what Scene bakes on the GPU when a mesh has no cooked SDF, and the cook's default
+constexpr int MESH_SDF_RESOLUTION = 64;
+
+// CookOffline (IglooCook): everything the runtime would otherwise work out on first use
+struct StaticMeshCookOptions
+{
+    bool m_force = false;                       // ignore an up-to-date cook
+    bool m_cardTemplates = true;                // what GenerateCardTemplates would generate
+    int m_sdfResolution = MESH_SDF_RESOLUTION;  // scale 1; 0 = no SDF
+};
+
+struct StaticMeshCookReport
+{
+    bool m_isCookDisabled = false;              // cooked="false", nothing to do
+    bool m_wasUpToDate = false;
+    uint32_t m_triangleCount = 0;
+    uint32_t m_cardCount = 0;
+    int m_sdfResolution = 0;
+    double m_importMilliseconds = 0.0;          // import from source + bounds + BVH + first write
+    double m_cardMilliseconds = 0.0;
+    double m_sdfMilliseconds = 0.0;
+    uint64_t m_cookedBytes = 0;
+};
+
 class StaticMesh
 {
 public:
-    StaticMesh(Renderer* renderer, std::string const& xmlPathNoExtensions, bool enableCardTemplates = false);
+    StaticMesh(Renderer* renderer, std::string const& xmlPathNoExtensions, bool enableCardTemplates = false, StaticMeshGeometry* importedGeometry = nullptr);
+    // 程序生成的 mesh（placeholder 等）：没有 xml，identity transform，没有贴图 / shader
+    StaticMesh(Renderer* renderer, std::string const& name, StaticMeshGeometry& geometry);
     ~StaticMesh();
 
+    // forceRecook: ignore an up-to-date cook, import from source and write it again
+    static bool ImportGeometry(std::string const& xmlPathNoExtensions, StaticMeshGeometry& out, bool forceRecook = false);
+    // ImportGeometry in two steps so IO and CPU work can run on different threads:
+    // LoadCookedGeometry only reads (xml, cook key, the cook itself) and returns false if there is no usable cook;
+    // ImportGeometryFromSource then parses / optimizes and writes the cook using the key it left in out
+    static bool LoadCookedGeometry(std::string const& xmlPathNoExtensions, StaticMeshGeometry& out, bool skipCook = false);
+    static bool ImportGeometryFromSource(std::string const& xmlPathNoExtensions, StaticMeshGeometry& out);
+    // .glb only: parses the file once more for its material images (the cook has no images)
+    static bool DecodeGLBImages(std::string const& glbFilePath, StaticMeshGeometry& out);
+    static void ImportGeometryForMeshes(std::vector<std::string> const& xmlPathsNoExtensions, std::vector<StaticMeshGeometry>& out); // parallel over meshes
+    // no renderer: import (or reuse the cook), add card templates and the SDF, write <xml>.cooked
+    static bool CookOffline(std::string const& xmlPathNoExtensions, StaticMeshCookOptions const& options, StaticMeshCookReport& outReport);
+
     void GenerateCardTemplates();
+    static void GenerateCardTemplatesForMeshes(std::vector<StaticMesh*> const& meshes); // parallel over meshes
     SurfaceCardTemplate* GetCardTemplate(uint8_t direction);
     const SurfaceCardTemplate* GetCardTemplate(uint8_t direction) const;
 
@@ -51,12 +157,26 @@ public:
 	SDFTexture3D* GetSDF(float scale) const;
 	void SetSDF(float scale, SDFTexture3D* sdf);
 	bool HasSDF(float scale) const;
+	// outResolution^3 distances baked offline for this scale (whatever --sdf the cook used),
+	// nullptr if the cook has none
+	float const* GetCookedSDFDistances(float scale, int& outResolution) const;
 
     std::vector<Vertex_PCUTBN> GetScaledAndTransformedVertices(float scale) const;
     std::vector<Vertex_PCUTBN> GetTransformedVertices() const;
     std::vector<Vertex_PCUTBN> GetTransformedVerticesWithoutAxisTransform() const;
 
+    // packed mesh: prepend to the model matrix (identity otherwise)
+    Mat44 GetVertexDequantizationTransform() const;
+
+    // same shader + textures -> same id (instancing sorts by it)
+    uint32_t GetMaterialID() const;
+
+    // one DrawIndexBuffer per run of visible meshlets; modelToWorld maps m_verts (not the packed stream) to world
+    MeshletCullStats DrawVisibleMeshlets(Renderer* renderer, Mat44 const& modelToWorld, Frustum const& worldFrustum, Vec3 const& cameraWorldPosition) const;
+
 private:
+    void UploadGeometry(Renderer* renderer, bool packVertices);
+    void SaveCooked();
     void ApplyTransformToVertices();
     static float QuantizeScale(float scale);
 
@@ -81,8 +201,26 @@ public:
 
     VertexBuffer* m_vertexBuffer = nullptr;
     IndexBuffer* m_indexBuffer = nullptr;
+    MeshOptimizationReport m_optimizationReport;
+    MeshletData m_meshlets;
+    bool m_uses16BitIndices = false;
+    bool m_usesPackedVertices = false;  // m_vertexBuffer holds Vertex_PCUTBNPacked; m_verts stays full precision
+    VertexQuantization m_quantization;
+    VertexQuantizationReport m_quantizationReport;
 	std::vector<SurfaceCardTemplate> m_cardTemplates;
 	bool m_hasCardTemplates = false;
+	SurfaceCardGenerationReport m_cardReport;
+
+    // bounds 在构造时（或 cook 里）算一次，Get*Bounds* 不再每次变换全部顶点
+    CookedMeshBounds m_bounds;
+    bool m_isOptimized = false;
+    std::string m_cookedPath;
+    uint64_t m_cookKey = 0;
+    std::vector<GPUBVHNode> m_cookedBVHNodes;       // scale 1; BuildBVH(scale) 只缩放 bounds
+    std::vector<uint32_t> m_cookedBVHTriangles;
+    std::vector<CookedMeshSDFVolume> m_cookedSDFVolumes;    // SaveCooked 要原样写回去
+    std::vector<float> m_cookedSDFDistances;
+    StaticMeshLoadReport m_loadReport;
 
     std::unordered_map<float, BVH> m_bvhsByScale;
 	bool m_bvhBuilt = false;
@@ -7,6 +7,8 @@
 #include "StringUtils.hpp"
 #include "EngineCommon.hpp"
 #include "Image.hpp"
+#include "GLBImporter.h"
+#include "TangentSpace.h"
 #include "ThirdParty/stb/stb_image.h"
 
 #define CGLTF_IMPLEMENTATION
@@ -26,173 +28,8 @@ bool LoadStaticMeshFile(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned
     return false;
 }
 
-bool LoadOBJMeshFile(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices, std::string const& filePath, bool flipUV, std::string const& mtlPath)
+static void FinishOBJMesh(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices, bool hasUV, bool hasNormal, bool flipUV)
 {
-    //UNUSED(flipUV)
-    std::string readObj;
-    FileReadToString(readObj, filePath);
-    Strings lines = SplitStringOnDelimiter(readObj, '\n');
-
-    std::map<std::string, Rgba8> kdMap;
-    if (mtlPath != "")
-    {
-        LoadOBJMaterial(mtlPath, kdMap);
-    }
-
-    std::vector<Vec3> positions;
-    std::vector<Vec3> normals;
-    std::vector<Vec2> texCoords;
-    Rgba8 currentColor = Rgba8::WHITE;
-
-    bool hasUV = false;
-    bool hasNormal = false;
-
-    bool hasFaceIndexing = false; 
-    
-    for (const std::string& line : lines)
-    {
-        Strings tokens = SplitStringOnDelimiter(line, ' ', true);
-        if (tokens.empty()) continue;
-
-        if (tokens[0] == "f" && tokens.size() >= 4)
-        {
-            for (int j = 1; j < (int)tokens.size(); ++j)
-            {
-                if (tokens[j].find('/') != std::string::npos)
-                {
-                    hasFaceIndexing = true;
-                    break;
-                }
-            }
-            if (hasFaceIndexing) break;
-        }
-    }
-
-    verts.clear();
-    indices.clear();
-
-    if (hasFaceIndexing)
-    {
-        std::unordered_map<VertexKey, unsigned int, VertexKeyHasher> vertexMap;
-
-        for (std::string& line : lines)
-        {
-            Strings tokens = SplitStringOnDelimiter(line, ' ', true);
-            
-            if (tokens.empty()) continue;
-
-            if (tokens[0] == "v")
-            {
-                //EraseEmptyStrings(tokens);
-                if (tokens.size() < 4) continue;
-                positions.emplace_back(Vec3(std::stof(tokens[1]), std::stof(tokens[2]), std::stof(tokens[3])));
-            }
-            else if (tokens[0] == "vt")
-            {
-                if (tokens.size() < 3) continue;
-                float u = std::stof(tokens[1]);
-                float v = std::stof(tokens[2]);
-                if (flipUV) v = 1.f - v;      
-                texCoords.emplace_back(Vec2(u, v));
-                //texCoords.emplace_back(Vec2(std::stof(tokens[1]), std::stof(tokens[2])));
-            }
-            else if (tokens[0] == "vn")
-            {
-                if (tokens.size() < 4) continue;
-                normals.emplace_back(Vec3(std::stof(tokens[1]), std::stof(tokens[2]), std::stof(tokens[3])).GetNormalized());
-            }
-            else if (tokens[0] == "usemtl")
-            {
-                if (tokens.size() >= 2)
-                {
-                    auto it = kdMap.find(tokens[1]);
-                    currentColor = (it != kdMap.end())? it->second : Rgba8::WHITE;
-                }
-            }
-            else if (tokens[0] == "f")
-            {
-                for (int j = 1; j <= 3; ++j)
-                {
-                    Strings parts = SplitStringOnDelimiter(tokens[j], '/');
-                    int vi = std::stoi(parts[0]) - 1;
-                    int ti = (parts.size() > 1 && !parts[1].empty()) ? std::stoi(parts[1]) - 1 : -1;
-                    int ni = (parts.size() > 2 && !parts[2].empty()) ? std::stoi(parts[2]) - 1 : -1;
-
-                    Vec3 pos = positions[vi];
-                    Vec2 uv = (ti >= 0 && ti < (int)texCoords.size()) ? texCoords[ti] : Vec2(0.5f, 0.5f);
-                    Vec3 norm = (ni >= 0 && ni < (int)normals.size()) ? normals[ni] : Vec3(0.f,0.f,1.f);
-
-                    if (ti >= 0) hasUV = true;
-                    if (ni >= 0) hasNormal = true;
-
-                    VertexKey key{ pos, uv, norm, currentColor};
-                    auto it = vertexMap.find(key);
-                    if (it != vertexMap.end())
-                    {
-                        indices.push_back(it->second);
-                    }
-                    else
-                    {
-                        Vertex_PCUTBN vert;
-                        vert.m_position = pos;
-                        vert.m_uvTexCoords = uv;
-                        vert.m_normal = norm.GetLengthSquared() > 0.f ? norm.GetNormalized() : Vec3(0.f, 0.f, 1.f);;
-                        vert.m_color = currentColor;
-                        vert.m_tangent = Vec3(1.f, 0, 0);
-                        vert.m_bitangent = Vec3(0, 1.f, 0);
-
-                        unsigned int newIndex = (unsigned int)verts.size();
-                        verts.push_back(vert);
-                        vertexMap[key] = newIndex;
-                        indices.push_back(newIndex);
-                    }
-                }
-            }
-        }
-    }
-    else
-    {
-        for (std::string& line : lines)
-        {
-            Strings tokens = SplitStringOnDelimiter(line, ' ', true);
-            if (tokens.empty()) continue;
-
-            if (tokens[0] == "v")
-            {
-                if (tokens.size() < 4) continue;
-                positions.emplace_back(Vec3(std::stof(tokens[1]), std::stof(tokens[2]), std::stof(tokens[3])));
-            }
-            else if (tokens[0] == "usemtl") 
-            {
-                if (tokens.size() >= 2)
-                {
-                    auto it = kdMap.find(tokens[1]);
-                    currentColor = (it != kdMap.end()) ? it->second : Rgba8::WHITE;
-                }
-            }
-            else if (tokens[0] == "f")
-            {
-                if (tokens.size() < 4) continue;
-
-                for (int j = 1; j <= 3; ++j)
-                {
-                    int vi = std::stoi(tokens[j]) - 1;
-                    if (vi < 0 || vi >= (int)positions.size()) continue;
-
-                    Vertex_PCUTBN vert;
-                    vert.m_position = positions[vi];
-                    vert.m_color = currentColor;
-                    vert.m_uvTexCoords = Vec2(0.f, 0.f);
-                    vert.m_normal = Vec3();
-                    vert.m_tangent = Vec3(1, 0, 0);
-                    vert.m_bitangent = Vec3(0, 1, 0);
-
-                    verts.push_back(vert);
-                    indices.push_back((unsigned int)(verts.size() - 1));
-                }
-            }
-        }
-    }
     if (hasUV && !hasNormal)
     {
         ComputeMissingNormals(verts);
@@ -214,6 +51,33 @@ bool LoadOBJMeshFile(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int
     {
         ComputeTangentsBitangentsIndexed(verts, indices);
     }
+}
+
+bool LoadOBJMeshFile(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices, std::string const& filePath, bool flipUV, std::string const& mtlPath)
+{
+    OBJParseStats stats;
+    return LoadOBJMeshFile(verts, indices, filePath, stats, flipUV, mtlPath);
+}
+
+bool LoadOBJMeshFile(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices, std::string const& filePath, OBJParseStats& stats, bool flipUV, std::string const& mtlPath)
+{
+    std::vector<uint8_t> buffer;
+    if (FileReadToBuffer(buffer, filePath) <= 0)
+    {
+        verts.clear();
+        indices.clear();
+        return false;
+    }
+
+    std::map<std::string, Rgba8> kdMap;
+    if (mtlPath != "")
+    {
+        LoadOBJMaterial(mtlPath, kdMap);
+    }
+
+    if (!ParseOBJBuffer((char const*)buffer.data(), buffer.size(), kdMap, flipUV, verts, indices, stats))
+        return false;
+    FinishOBJMesh(verts, indices, stats.m_hasUV, stats.m_hasNormal, flipUV);
     return true;
 }
 
@@ -415,160 +279,33 @@ void ComputeMissingUVsNormalsTangentsBitangents(std::vector<Vertex_PCUTBN>& vert
 //T和B反映了UV轴方向对应了空间中哪条向量
 void ComputeTangentsBitangentsIndexed(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices)
 {
-    for (Vertex_PCUTBN& v : verts)
-    {
-        v.m_tangent = Vec3();
-        v.m_bitangent = Vec3();
-    }
-    for (size_t i = 0; i + 2 < indices.size(); i += 3)
-    {
-        unsigned int i0 = indices[i];
-        unsigned int i1 = indices[i + 1];
-        unsigned int i2 = indices[i + 2];
-
-        Vertex_PCUTBN& v0 = verts[i0];
-        Vertex_PCUTBN& v1 = verts[i1];
-        Vertex_PCUTBN& v2 = verts[i2];
-
-        const Vec3& p0 = v0.m_position;
-        const Vec3& p1 = v1.m_position;
-        const Vec3& p2 = v2.m_position;
-
-        const Vec2& uv0 = v0.m_uvTexCoords;
-        const Vec2& uv1 = v1.m_uvTexCoords;
-        const Vec2& uv2 = v2.m_uvTexCoords;
-
-        Vec3 edge1 = p1 - p0;
-        Vec3 edge2 = p2 - p0;
-        Vec2 deltaUV1 = uv1 - uv0;
-        Vec2 deltaUV2 = uv2 - uv0;
-
-        float f = (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-        if (fabs(f) < 1e-6f)
-            continue; 
-
-        float invF = 1.0f / f;
-
-        Vec3 tangent = (edge1 * deltaUV2.y - edge2 * deltaUV1.y) * invF;
-        Vec3 bitangent = (edge2 * deltaUV1.x - edge1 * deltaUV2.x) * invF;
-
-        // 累加到三个顶点
-        v0.m_tangent += tangent;
-        v1.m_tangent += tangent;
-        v2.m_tangent += tangent;
-
-        v0.m_bitangent += bitangent;
-        v1.m_bitangent += bitangent;
-        v2.m_bitangent += bitangent;
-    }
-
-    for (Vertex_PCUTBN& v : verts)
-    {
-        v.m_tangent = v.m_tangent.GetNormalized();
-        v.m_bitangent = v.m_bitangent.GetNormalized();
-    }
+    GenerateTangentFrames(verts, indices);
 }
 
 bool LoadGLBMeshFile(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices, std::string const& path, bool flipUV)
 {
-    cgltf_options options = {};
-    cgltf_data* data = nullptr;
-    cgltf_result result = cgltf_parse_file(&options, path.c_str(), &data);
-    if (result != cgltf_result_success)
-        return false;
-    
-    result = cgltf_load_buffers(&options, data, path.c_str());
-    if (result != cgltf_result_success)
-    {
-        cgltf_free(data);
+    GLBImportSettings settings;
+    settings.m_flipUV = flipUV;
+    settings.m_decodeImages = false;
+    GLBImportResult result;
+    if (!ImportGLBFile(path, result, settings))
         return false;
-    }
-    
-    for (cgltf_size i = 0; i < data->meshes_count; ++i)
+
+    // 追加，和原来一样
+    unsigned int baseVertex = (unsigned int)verts.size();
+    verts.insert(verts.end(), result.m_verts.begin(), result.m_verts.end());
+    indices.reserve(indices.size() + result.m_indices.size());
+    for (unsigned int index : result.m_indices)
     {
-        const cgltf_mesh& mesh = data->meshes[i];
-        for (cgltf_size j = 0; j < mesh.primitives_count; ++j)
-        {
-            const cgltf_primitive& prim = mesh.primitives[j];
-            
-            const cgltf_accessor* pos_accessor = nullptr;
-            const cgltf_accessor* norm_accessor = nullptr;
-            const cgltf_accessor* uv_accessor = nullptr;
-            
-            for (cgltf_size k = 0; k < prim.attributes_count; ++k)
-            {
-                switch (prim.attributes[k].type)
-                {
-                case cgltf_attribute_type_position:
-                    pos_accessor = prim.attributes[k].data;
-                    break;
-                case cgltf_attribute_type_normal:
-                    norm_accessor = prim.attributes[k].data;
-                    break;
-                case cgltf_attribute_type_texcoord:
-                    uv_accessor = prim.attributes[k].data;
-                    break;
-                default: break;
-                }
-            }
-            
-            if (!pos_accessor || !prim.indices) continue;
-            
-            cgltf_size vertex_count = pos_accessor->count;
-            size_t base_vertex_index = verts.size();
-            
-            for (cgltf_size v = 0; v < vertex_count; ++v)
-            {
-                Vertex_PCUTBN vertex = {};
-                
-                float pos[3] = {};
-                cgltf_accessor_read_float(pos_accessor, v, pos, 3);
-                vertex.m_position = Vec3(pos[0], pos[1], pos[2]);
-                if (norm_accessor)
-                {
-                    float norm[3] = {};
-                    cgltf_accessor_read_float(norm_accessor, v, norm, 3);
-                    vertex.m_normal = Vec3(norm[0], norm[1], norm[2]);
-                }
-                if (uv_accessor)
-                {
-                    float uv[2] = {};
-                    cgltf_accessor_read_float(uv_accessor, v, uv, 2);
-                    if (flipUV == true)
-                    {
-                        vertex.m_uvTexCoords = Vec2(uv[0], 1.f - uv[1]);
-                    }
-                    else
-                    {
-                        vertex.m_uvTexCoords = Vec2(uv[0], uv[1]);
-                    }
-                }
-                
-                vertex.m_color = Rgba8::WHITE;
-                vertex.m_tangent = Vec3();
-                vertex.m_bitangent = Vec3();
-                
-                verts.push_back(vertex);
-            }
-            
-            // now, read the index
-            cgltf_size index_count = prim.indices->count;
-            for (cgltf_size idx = 0; idx < index_count; ++idx)
-            {
-                cgltf_uint vertex_index = (cgltf_uint)cgltf_accessor_read_index(prim.indices, idx);
-                indices.push_back((unsigned int)(base_vertex_index + vertex_index));
-            }
-        }
+        indices.push_back(baseVertex + index);
     }
-    
-    ComputeTangentsBitangentsIndexed(verts, indices);
-    cgltf_free(data);
     return true;
 }
 
 cgltf_data* LoadGLTFDataFromFile(const std::string& path)
 {
     cgltf_options options = {};
+    SetGLTFFileCallbacks(options);
     cgltf_data* data = nullptr;
     cgltf_result result = cgltf_parse_file(&options, path.c_str(), &data);
     if (result != cgltf_result_success) return nullptr;
@@ -653,5 +390,3 @@ Image* LoadImageDueToGLTFData(cgltf_data* in_data, GLBChannel channelType /*= GL
     cgltf_free(in_data);
     return img;
 }
-
-
@@ -3,6 +3,11 @@
 #include <queue>
 #include <algorithm>
 
+#ifndef _WIN32
+#include <cstdio>
+#define vsnprintf_s( buffer, bufferSize, count, format, args ) vsnprintf( buffer, bufferSize, format, args )
+#endif
+
 //-----------------------------------------------------------------------------------------------
 constexpr int STRINGF_STACK_LOCAL_TEMP_LENGTH = 2048;
 
@@ -0,0 +1,452 @@
+#include "TangentSpace.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Job/JobSystem.h"
+#include "Engine/Math/MathUtils.hpp"
+
+#ifdef ENGINE_ENABLE_SSE
+#include <xmmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+    constexpr uint32_t TANGENT_VERTEX_BATCH = 64 * 1024;
+
+    struct TangentStreams
+    {
+        std::vector<float> m_px, m_py, m_pz;
+        std::vector<float> m_u, m_v;
+        std::vector<float> m_nx, m_ny, m_nz;
+    };
+
+    struct TangentAccumulator
+    {
+        float m_t[3];
+        float m_b[3];
+    };
+
+    struct TangentRange
+    {
+        uint32_t m_firstTriangle = 0;
+        uint32_t m_triangleCount = 0;
+        uint32_t m_spanBegin = 0;            // vertices [m_spanBegin, m_spanEnd) are what this range touches
+        uint32_t m_spanEnd = 0;
+        uint32_t m_degenerateCount = 0;
+        std::vector<TangentAccumulator> m_accumulators;
+    };
+
+    void GatherTangentStreams(std::vector<Vertex_PCUTBN> const& verts, TangentStreams& streams)
+    {
+        size_t count = verts.size();
+        streams.m_px.resize(count); streams.m_py.resize(count); streams.m_pz.resize(count);
+        streams.m_u.resize(count); streams.m_v.resize(count);
+        streams.m_nx.resize(count); streams.m_ny.resize(count); streams.m_nz.resize(count);
+        ParallelFor((uint32_t)count, TANGENT_VERTEX_BATCH, [&verts, &streams](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                Vertex_PCUTBN const& vert = verts[i];
+                streams.m_px[i] = vert.m_position.x; streams.m_py[i] = vert.m_position.y; streams.m_pz[i] = vert.m_position.z;
+                streams.m_u[i] = vert.m_uvTexCoords.x; streams.m_v[i] = vert.m_uvTexCoords.y;
+                streams.m_nx[i] = vert.m_normal.x; streams.m_ny[i] = vert.m_normal.y; streams.m_nz[i] = vert.m_normal.z;
+            }
+        });
+    }
+
+    //-------------------------------------------------------------------------------------------
+    // scalar: the reference, the < 4 triangle tail of a range and every triangle without
+    // ENGINE_ENABLE_SSE. Same operations in the same order as the SSE path, only the angle
+    // differs (std::acos when exactAngle)
+    struct Float3
+    {
+        float x, y, z;
+    };
+
+    inline Float3 Sub3(Float3 a, Float3 b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    inline float Dot3(Float3 a, Float3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    // MikkTSpace: project onto the normal plane, normalize unless (nearly) zero
+    inline Float3 ProjectAndNormalize(Float3 v, Float3 n)
+    {
+        float d = Dot3(n, v);
+        v = { v.x - n.x * d, v.y - n.y * d, v.z - n.z * d };
+        float length = sqrtf(Dot3(v, v));
+        float scale = length > FLT_MIN ? 1.f / length : 1.f;
+        return { v.x * scale, v.y * scale, v.z * scale };
+    }
+
+    // Abramowitz & Stegun 4.4.45，误差 < 7e-5 rad；只当权重用
+    inline float FastAcos(float c)
+    {
+        float x = fabsf(c);
+        float r = sqrtf(1.f - x) * (((-0.0187293f * x + 0.0742610f) * x - 0.2121144f) * x + 1.5707288f);
+        return c < 0.f ? 3.14159265f - r : r;
+    }
+
+    bool AccumulateTriangleScalar(TangentStreams const& s, unsigned int const* tri, TangentAccumulator* accumulators, uint32_t spanBegin, bool exactAngle)
+    {
+        Float3 p[3];
+        Float3 n[3];
+        float u[3];
+        float v[3];
+        for (int c = 0; c < 3; c++)
+        {
+            unsigned int i = tri[c];
+            p[c] = { s.m_px[i], s.m_py[i], s.m_pz[i] };
+            n[c] = { s.m_nx[i], s.m_ny[i], s.m_nz[i] };
+            u[c] = s.m_u[i];
+            v[c] = s.m_v[i];
+        }
+
+        // InitTriInfo：面的 tangent / bitangent，按 UV 朝向带符号归一化
+        Float3 d1 = Sub3(p[1], p[0]);
+        Float3 d2 = Sub3(p[2], p[0]);
+        float t21x = u[1] - u[0];
+        float t21y = v[1] - v[0];
+        float t31x = u[2] - u[0];
+        float t31y = v[2] - v[0];
+        float area = t21x * t31y - t21y * t31x;
+        if (!(fabsf(area) > FLT_MIN))
+            return false;
+
+        float sign = area > 0.f ? 1.f : -1.f;
+        Float3 os = { t31y * d1.x - t21y * d2.x, t31y * d1.y - t21y * d2.y, t31y * d1.z - t21y * d2.z };
+        Float3 ot = { t21x * d2.x - t31x * d1.x, t21x * d2.y - t31x * d1.y, t21x * d2.z - t31x * d1.z };
+        float lengthOs = sqrtf(Dot3(os, os));
+        float lengthOt = sqrtf(Dot3(ot, ot));
+        float scaleOs = lengthOs > FLT_MIN ? sign / lengthOs : 1.f;
+        float scaleOt = lengthOt > FLT_MIN ? sign / lengthOt : 1.f;
+        os = { os.x * scaleOs, os.y * scaleOs, os.z * scaleOs };
+        ot = { ot.x * scaleOt, ot.y * scaleOt, ot.z * scaleOt };
+
+        // GenerateTSpaces：每个角投影到自己的法线平面，按角度加权
+        for (int c = 0; c < 3; c++)
+        {
+            int prev = (c + 2) % 3;
+            int next = (c + 1) % 3;
+            Float3 cornerOs = ProjectAndNormalize(os, n[c]);
+            Float3 cornerOt = ProjectAndNormalize(ot, n[c]);
+            Float3 e1 = ProjectAndNormalize(Sub3(p[prev], p[c]), n[c]);
+            Float3 e2 = ProjectAndNormalize(Sub3(p[next], p[c]), n[c]);
+            float cosine = std::min(std::max(Dot3(e1, e2), -1.f), 1.f);
+            float angle = exactAngle ? acosf(cosine) : FastAcos(cosine);
+
+            TangentAccumulator& accumulator = accumulators[tri[c] - spanBegin];
+            accumulator.m_t[0] += cornerOs.x * angle; accumulator.m_t[1] += cornerOs.y * angle; accumulator.m_t[2] += cornerOs.z * angle;
+            accumulator.m_b[0] += cornerOt.x * angle; accumulator.m_b[1] += cornerOt.y * angle; accumulator.m_b[2] += cornerOt.z * angle;
+        }
+        return true;
+    }
+
+#ifdef ENGINE_ENABLE_SSE
+    //-------------------------------------------------------------------------------------------
+    // SSE: 一次 4 个三角形，每个 lane 一个
+    struct Float3x4
+    {
+        __m128 x, y, z;
+    };
+
+    inline Float3x4 Sub3x4(Float3x4 const& a, Float3x4 const& b) { return { _mm_sub_ps(a.x, b.x), _mm_sub_ps(a.y, b.y), _mm_sub_ps(a.z, b.z) }; }
+    inline __m128 Dot3x4(Float3x4 const& a, Float3x4 const& b)
+    {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)), _mm_mul_ps(a.z, b.z));
+    }
+    inline Float3x4 Scale3x4(Float3x4 const& a, __m128 s) { return { _mm_mul_ps(a.x, s), _mm_mul_ps(a.y, s), _mm_mul_ps(a.z, s) }; }
+
+    inline __m128 Select(__m128 mask, __m128 ifTrue, __m128 ifFalse)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+    }
+
+    inline Float3x4 ProjectAndNormalize4(Float3x4 v, Float3x4 const& n)
+    {
+        __m128 d = Dot3x4(n, v);
+        v = Sub3x4(v, Scale3x4(n, d));
+        __m128 length = _mm_sqrt_ps(Dot3x4(v, v));
+        __m128 one = _mm_set1_ps(1.f);
+        return Scale3x4(v, Select(_mm_cmpgt_ps(length, _mm_set1_ps(FLT_MIN)), _mm_div_ps(one, length), one));
+    }
+
+    inline __m128 FastAcos4(__m128 c)
+    {
+        __m128 x = _mm_andnot_ps(_mm_set1_ps(-0.f), c);
+        __m128 poly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-0.0187293f), x), _mm_set1_ps(0.0742610f));
+        poly = _mm_sub_ps(_mm_mul_ps(poly, x), _mm_set1_ps(0.2121144f));
+        poly = _mm_add_ps(_mm_mul_ps(poly, x), _mm_set1_ps(1.5707288f));
+        __m128 r = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.f), x)), poly);
+        return Select(_mm_cmplt_ps(c, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(3.14159265f), r), r);
+    }
+
+    inline Float3x4 Gather3(std::vector<float> const& xs, std::vector<float> const& ys, std::vector<float> const& zs, unsigned int const* i)
+    {
+        return { _mm_setr_ps(xs[i[0]], xs[i[1]], xs[i[2]], xs[i[3]]),
+                 _mm_setr_ps(ys[i[0]], ys[i[1]], ys[i[2]], ys[i[3]]),
+                 _mm_setr_ps(zs[i[0]], zs[i[1]], zs[i[2]], zs[i[3]]) };
+    }
+
+    inline __m128 Gather1(std::vector<float> const& values, unsigned int const* i)
+    {
+        return _mm_setr_ps(values[i[0]], values[i[1]], values[i[2]], values[i[3]]);
+    }
+
+    // returns how many of the 4 triangles were degenerate
+    uint32_t AccumulateTriangles4(TangentStreams const& s, unsigned int const* tris, TangentAccumulator* accumulators, uint32_t spanBegin)
+    {
+        // corner-major index lanes: corners[c][lane]
+        alignas(16) unsigned int corners[3][4];
+        for (int lane = 0; lane < 4; lane++)
+        {
+            corners[0][lane] = tris[lane * 3];
+            corners[1][lane] = tris[lane * 3 + 1];
+            corners[2][lane] = tris[lane * 3 + 2];
+        }
+
+        Float3x4 p[3];
+        Float3x4 n[3];
+        __m128 u[3];
+        __m128 v[3];
+        for (int c = 0; c < 3; c++)
+        {
+            p[c] = Gather3(s.m_px, s.m_py, s.m_pz, corners[c]);
+            n[c] = Gather3(s.m_nx, s.m_ny, s.m_nz, corners[c]);
+            u[c] = Gather1(s.m_u, corners[c]);
+            v[c] = Gather1(s.m_v, corners[c]);
+        }
+
+        Float3x4 d1 = Sub3x4(p[1], p[0]);
+        Float3x4 d2 = Sub3x4(p[2], p[0]);
+        __m128 t21x = _mm_sub_ps(u[1], u[0]);
+        __m128 t21y = _mm_sub_ps(v[1], v[0]);
+        __m128 t31x = _mm_sub_ps(u[2], u[0]);
+        __m128 t31y = _mm_sub_ps(v[2], v[0]);
+        __m128 area = _mm_sub_ps(_mm_mul_ps(t21x, t31y), _mm_mul_ps(t21y, t31x));
+        __m128 isValid = _mm_cmpgt_ps(_mm_andnot_ps(_mm_set1_ps(-0.f), area), _mm_set1_ps(FLT_MIN));
+        int validBits = _mm_movemask_ps(isValid);
+        if (validBits == 0)
+            return 4;
+
+        __m128 sign = Select(_mm_cmpgt_ps(area, _mm_setzero_ps()), _mm_set1_ps(1.f), _mm_set1_ps(-1.f));
+        Float3x4 os = Sub3x4(Scale3x4(d1, t31y), Scale3x4(d2, t21y));
+        Float3x4 ot = Sub3x4(Scale3x4(d2, t21x), Scale3x4(d1, t31x));
+        __m128 lengthOs = _mm_sqrt_ps(Dot3x4(os, os));
+        __m128 lengthOt = _mm_sqrt_ps(Dot3x4(ot, ot));
+        __m128 one = _mm_set1_ps(1.f);
+        __m128 minLength = _mm_set1_ps(FLT_MIN);
+        os = Scale3x4(os, Select(_mm_cmpgt_ps(lengthOs, minLength), _mm_div_ps(sign, lengthOs), one));
+        ot = Scale3x4(ot, Select(_mm_cmpgt_ps(lengthOt, minLength), _mm_div_ps(sign, lengthOt), one));
+
+        alignas(16) float contributions[3][6][4];
+        for (int c = 0; c < 3; c++)
+        {
+            int prev = (c + 2) % 3;
+            int next = (c + 1) % 3;
+            Float3x4 cornerOs = ProjectAndNormalize4(os, n[c]);
+            Float3x4 cornerOt = ProjectAndNormalize4(ot, n[c]);
+            Float3x4 e1 = ProjectAndNormalize4(Sub3x4(p[prev], p[c]), n[c]);
+            Float3x4 e2 = ProjectAndNormalize4(Sub3x4(p[next], p[c]), n[c]);
+            __m128 cosine = _mm_min_ps(_mm_max_ps(Dot3x4(e1, e2), _mm_set1_ps(-1.f)), one);
+            __m128 angle = _mm_and_ps(FastAcos4(cosine), isValid);
+
+            _mm_store_ps(contributions[c][0], _mm_mul_ps(cornerOs.x, angle));
+            _mm_store_ps(contributions[c][1], _mm_mul_ps(cornerOs.y, angle));
+            _mm_store_ps(contributions[c][2], _mm_mul_ps(cornerOs.z, angle));
+            _mm_store_ps(contributions[c][3], _mm_mul_ps(cornerOt.x, angle));
+            _mm_store_ps(contributions[c][4], _mm_mul_ps(cornerOt.y, angle));
+            _mm_store_ps(contributions[c][5], _mm_mul_ps(cornerOt.z, angle));
+        }
+
+        // scatter 是标量的：同一个顶点可能出现在多个 lane 里
+        uint32_t degenerateCount = 0;
+        for (int lane = 0; lane < 4; lane++)
+        {
+            if ((validBits & (1 << lane)) == 0)
+            {
+                degenerateCount++;
+                continue;
+            }
+            for (int c = 0; c < 3; c++)
+            {
+                TangentAccumulator& accumulator = accumulators[corners[c][lane] - spanBegin];
+                accumulator.m_t[0] += contributions[c][0][lane];
+                accumulator.m_t[1] += contributions[c][1][lane];
+                accumulator.m_t[2] += contributions[c][2][lane];
+                accumulator.m_b[0] += contributions[c][3][lane];
+                accumulator.m_b[1] += contributions[c][4][lane];
+                accumulator.m_b[2] += contributions[c][5][lane];
+            }
+        }
+        return degenerateCount;
+    }
+#endif
+
+    //-------------------------------------------------------------------------------------------
+    void ResolveTangentFrame(Vertex_PCUTBN& vert, Vec3 const& tangentSum, Vec3 const& bitangentSum)
+    {
+        Vec3 n = vert.m_normal;
+        float normalLength = n.GetLength();
+        if (normalLength <= FLT_MIN)
+        {
+            vert.m_tangent = tangentSum.GetNormalized();
+            vert.m_bitangent = bitangentSum.GetNormalized();
+            return;
+        }
+        n /= normalLength;
+
+        Vec3 t = tangentSum - n * DotProduct3D(n, tangentSum);
+        float tangentLength = t.GetLength();
+        if (tangentLength > FLT_MIN)
+        {
+            t /= tangentLength;
+        }
+        else
+        {
+            t = (fabsf(n.y) < 0.99f ? CrossProduct3D(n, Vec3(0.f, 1.f, 0.f)) : CrossProduct3D(n, Vec3(1.f, 0.f, 0.f))).GetNormalized();
+        }
+
+        Vec3 b = CrossProduct3D(n, t);
+        vert.m_tangent = t;
+        vert.m_bitangent = DotProduct3D(b, bitangentSum) < 0.f ? -b : b;
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+void GenerateTangentFrames(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int> const& indices, TangentFrameStats* outStats)
+{
+    TangentFrameStats stats;
+    double startTime = GetCurrentTimeSeconds();
+    stats.m_vertexCount = (uint32_t)verts.size();
+    stats.m_triangleCount = (uint32_t)(indices.size() / 3);
+    if (verts.empty())
+    {
+        if (outStats)
+            *outStats = stats;
+        return;
+    }
+
+    // 1. gather
+    TangentStreams streams;
+    GatherTangentStreams(verts, streams);
+    double accumulateStart = GetCurrentTimeSeconds();
+    stats.m_gatherMilliseconds = (accumulateStart - startTime) * 1000.0;
+
+    // 2. ranges
+    uint32_t triangleCount = stats.m_triangleCount;
+    uint32_t maxRangeCount = g_theJobSystem ? (uint32_t)(g_theJobSystem->GetNumWorkerThreads() + 1) * 2 : 1;
+    uint32_t rangeCount = std::max(1u, std::min(maxRangeCount, triangleCount / TANGENT_MIN_TRIANGLES_PER_RANGE));
+    std::vector<TangentRange> ranges(rangeCount);
+    uint32_t trianglesPerRange = (triangleCount + rangeCount - 1) / rangeCount;
+    for (uint32_t r = 0; r < rangeCount; r++)
+    {
+        ranges[r].m_firstTriangle = std::min(r * trianglesPerRange, triangleCount);
+        ranges[r].m_triangleCount = std::min(trianglesPerRange, triangleCount - ranges[r].m_firstTriangle);
+    }
+    if (rangeCount > 1)
+    {
+        ParallelFor(rangeCount, 1, [&ranges, &indices](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t r = begin; r < end; r++)
+            {
+                auto first = indices.begin() + (size_t)ranges[r].m_firstTriangle * 3;
+                auto minMax = std::minmax_element(first, first + (size_t)ranges[r].m_triangleCount * 3);
+                ranges[r].m_spanBegin = ranges[r].m_triangleCount > 0 ? *minMax.first : 0;
+                ranges[r].m_spanEnd = ranges[r].m_triangleCount > 0 ? *minMax.second + 1 : 0;
+            }
+        });
+
+        uint64_t spanSum = 0;
+        for (TangentRange const& range : ranges)
+        {
+            spanSum += range.m_spanEnd - range.m_spanBegin;
+        }
+        // 顶点很分散：每个 range 都要整块累加器，不如一个 range
+        if ((float)spanSum > TANGENT_MAX_SPAN_RATIO * (float)verts.size())
+        {
+            rangeCount = 1;
+            ranges.resize(1);
+            ranges[0].m_firstTriangle = 0;
+            ranges[0].m_triangleCount = triangleCount;
+        }
+    }
+    if (rangeCount == 1)
+    {
+        ranges[0].m_spanBegin = 0;
+        ranges[0].m_spanEnd = (uint32_t)verts.size();
+    }
+    stats.m_rangeCount = rangeCount;
+
+    // 3. accumulate
+    ParallelFor(rangeCount, 1, [&ranges, &indices, &streams](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t r = begin; r < end; r++)
+        {
+            TangentRange& range = ranges[r];
+            range.m_accumulators.assign(range.m_spanEnd - range.m_spanBegin, TangentAccumulator{});
+            unsigned int const* tris = indices.data() + (size_t)range.m_firstTriangle * 3;
+            uint32_t t = 0;
+#ifdef ENGINE_ENABLE_SSE
+            for (; t + 4 <= range.m_triangleCount; t += 4)
+            {
+                range.m_degenerateCount += AccumulateTriangles4(streams, tris + t * 3, range.m_accumulators.data(), range.m_spanBegin);
+            }
+#endif
+            for (; t < range.m_triangleCount; t++)
+            {
+                if (!AccumulateTriangleScalar(streams, tris + t * 3, range.m_accumulators.data(), range.m_spanBegin, false))
+                    range.m_degenerateCount++;
+            }
+        }
+    });
+    double resolveStart = GetCurrentTimeSeconds();
+    stats.m_accumulateMilliseconds = (resolveStart - accumulateStart) * 1000.0;
+
+    // 4. resolve
+    ParallelFor((uint32_t)verts.size(), TANGENT_VERTEX_BATCH, [&ranges, &verts](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            Vec3 tangentSum;
+            Vec3 bitangentSum;
+            for (TangentRange const& range : ranges)
+            {
+                if (i < range.m_spanBegin || i >= range.m_spanEnd)
+                    continue;
+                TangentAccumulator const& accumulator = range.m_accumulators[i - range.m_spanBegin];
+                tangentSum += Vec3(accumulator.m_t[0], accumulator.m_t[1], accumulator.m_t[2]);
+                bitangentSum += Vec3(accumulator.m_b[0], accumulator.m_b[1], accumulator.m_b[2]);
+            }
+            ResolveTangentFrame(verts[i], tangentSum, bitangentSum);
+        }
+    });
+
+    for (TangentRange const& range : ranges)
+    {
+        stats.m_degenerateTriangleCount += range.m_degenerateCount;
+    }
+    double endTime = GetCurrentTimeSeconds();
+    stats.m_resolveMilliseconds = (endTime - resolveStart) * 1000.0;
+    stats.m_totalMilliseconds = (endTime - startTime) * 1000.0;
+    if (outStats)
+        *outStats = stats;
+}
+
+void GenerateTangentFramesReference(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int> const& indices)
+{
+    TangentStreams streams;
+    GatherTangentStreams(verts, streams);
+    std::vector<TangentAccumulator> accumulators(verts.size(), TangentAccumulator{});
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        AccumulateTriangleScalar(streams, indices.data() + i, accumulators.data(), 0, true);
+    }
+    for (size_t i = 0; i < verts.size(); i++)
+    {
+        TangentAccumulator const& accumulator = accumulators[i];
+        ResolveTangentFrame(verts[i], Vec3(accumulator.m_t[0], accumulator.m_t[1], accumulator.m_t[2]),
+            Vec3(accumulator.m_b[0], accumulator.m_b[1], accumulator.m_b[2]));
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+
+#include <cstdint>
+#include <vector>
+
+//==============================================================================
+// TangentSpace - 大 mesh 的 tangent frame：SoA + SSE，按 index 区间分给 worker
+//==============================================================================
+// GenerateTangentFrames:
+//   1. gather      Vertex_PCUTBN (AoS) -> SoA position / uv / normal streams (ParallelFor)
+//   2. ranges      the index buffer is split into triangle ranges, each with its own
+//                  accumulator over the vertex span it touches. File-ordered and
+//                  fetch-optimized meshes touch narrow spans; if the spans add up to more
+//                  than TANGENT_MAX_SPAN_RATIO x the vertex count the mesh runs as one range
+//   3. accumulate  ParallelFor over ranges, 4 triangles per SSE iteration (one at a time
+//                  without ENGINE_ENABLE_SSE, same result). MikkTSpace
+//                  weighting: per corner the face's normalized tangent / bitangent projected
+//                  onto that corner's normal plane, weighted by the corner's interior angle
+//                  between its two projected edges (polynomial acos, < 7e-5 rad)
+//   4. resolve     ParallelFor over vertices: sum the ranges covering the vertex, normalize,
+//                  bitangent = sign * cross(N, T), sign from the accumulated bitangent
+//
+// Matches MikkTSpace for welded vertices. Vertices are never split, so a vertex on a UV
+// mirror seam gets one averaged frame where MikkTSpace would split it. A vertex without a
+// normal keeps the old result (normalized T and B sums); one that no triangle with usable
+// UVs touches gets an arbitrary frame around its normal.
+//
+// Cost, one thread (IglooBench tangents, 1M-triangle grid): 119 ms, against 64 ms for the
+// removed per-triangle sum and 300 ms for the scalar reference; the ranges spread over workers.
+// The removed sum was neither angle-weighted nor orthogonal: on Rock.obj 9% of its tangents
+// were more than 1 deg off MikkTSpace (worst 90 deg), which the baked normal maps assume.
+// Meshes are cooked with their frames, so this is import / cook time, not load time.
+//==============================================================================
+
+static constexpr uint32_t TANGENT_MIN_TRIANGLES_PER_RANGE = 16 * 1024;
+static constexpr float TANGENT_MAX_SPAN_RATIO = 4.f;
+
+struct TangentFrameStats
+{
+    uint32_t m_triangleCount = 0;
+    uint32_t m_vertexCount = 0;
+    uint32_t m_rangeCount = 0;
+    uint32_t m_degenerateTriangleCount = 0;     // zero UV area, no contribution
+    double m_gatherMilliseconds = 0.0;
+    double m_accumulateMilliseconds = 0.0;
+    double m_resolveMilliseconds = 0.0;
+    double m_totalMilliseconds = 0.0;
+};
+
+// writes m_tangent / m_bitangent of every vertex; positions, uvs and normals are only read
+void GenerateTangentFrames(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int> const& indices, TangentFrameStats* outStats = nullptr);
+// same frame, scalar and single-threaded with std::acos: what the SIMD path is checked against
+void GenerateTangentFramesReference(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int> const& indices);
@@ -0,0 +1,132 @@
+#include "TextureCook.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/EngineBuildPreferences.hpp"
+#include "ThirdParty/stb/stb_image.h"
+
+namespace
+{
+    // DX11 解码时翻了 V，cook 出来的 mip chain 不能和别的 backend 共用
+    uint32_t GetMipCookOrientationKey(TextureCookTarget target)
+    {
+        return target == TextureCookTarget::DX11 ? 1u : 0u;
+    }
+
+    // DX12 上传 RGBA8 时逐行翻转，block 翻不了，只能编码时就翻好
+    bool FlipsBlocksAtCook(TextureCookTarget target)
+    {
+        return target == TextureCookTarget::DX12;
+    }
+}
+
+TextureCookTarget GetNativeTextureCookTarget()
+{
+#if defined(ENGINE_DX11_RENDERER)
+    return TextureCookTarget::DX11;
+#elif defined(ENGINE_DX12_RENDERER)
+    return TextureCookTarget::DX12;
+#else
+    return TextureCookTarget::HEADLESS;
+#endif
+}
+
+bool ParseTextureCookTarget(std::string const& text, TextureCookTarget& out)
+{
+    if (text == "dx11")
+        out = TextureCookTarget::DX11;
+    else if (text == "dx12")
+        out = TextureCookTarget::DX12;
+    else if (text == "headless")
+        out = TextureCookTarget::HEADLESS;
+    else
+        return false;
+    return true;
+}
+
+char const* GetTextureCookTargetName(TextureCookTarget target)
+{
+    switch (target)
+    {
+    case TextureCookTarget::DX11: return "dx11";
+    case TextureCookTarget::DX12: return "dx12";
+    default: return "headless";
+    }
+}
+
+bool UsesMipCook(ImageMipSettings const& settings)
+{
+    return settings.m_maxLevelCount != 1;
+}
+
+ImageMipSettings GetMaterialMipSettings(int slot)
+{
+    ImageMipSettings settings;
+    settings.m_isNormalMap = slot == 0;
+    settings.m_isSRGB = slot == 1;
+    return settings;
+}
+
+// 和 Image(char const*) 一样解成 RGBA8。DX11 的 CreateTextureFromFile 在解码时翻转 V，
+// CreateTextureFromImage 不翻，这里跟着它翻；DX12 的 CreateTextureFromImage 自己翻
+bool DecodeImageFromMemory(std::string const& name, std::vector<uint8_t> const& bytes, TextureCookTarget target, Image& outImage)
+{
+    if (bytes.empty())
+        return false;
+
+    stbi_set_flip_vertically_on_load_thread(target == TextureCookTarget::DX11 ? 1 : 0);
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    unsigned char* pixels = stbi_load_from_memory(bytes.data(), (int)bytes.size(), &width, &height, &channels, 4);
+    if (!pixels)
+        return false;
+
+    outImage = Image(pixels, width, height, 4);
+    outImage.SetName(name);
+    stbi_image_free(pixels);
+    return true;
+}
+
+bool LoadCookedTextureMips(std::string const& path, ImageMipSettings const& settings, BlockFormat format, TextureCookTarget target,
+    uint64_t& outMipKey, uint64_t& outBlockKey, ImageMipChain& outMips, CompressedMipChain& outBlocks, int firstLevel)
+{
+    outMipKey = 0;
+    outBlockKey = 0;
+    if (!UsesMipCook(settings))
+        return false;
+    if (format != BlockFormat::NONE)
+    {
+        uint32_t blockKey = GetMipCookOrientationKey(target) | (FlipsBlocksAtCook(target) ? 2u : 0u) | ((uint32_t)format << 8);
+        outBlockKey = ComputeImageMipCookKey(path, settings, blockKey);
+        outBlocks.m_name = path;
+        if (LoadCookedCompressedMipChain(GetCompressedMipCookPath(path, format), outBlockKey, outBlocks, firstLevel))
+            return true;
+    }
+    // 尺寸不是 4 的倍数的贴图没法压缩，cook 的是 RGBA8
+    outMipKey = ComputeImageMipCookKey(path, settings, GetMipCookOrientationKey(target));
+    outMips.m_name = path;
+    return LoadCookedImageMipChain(GetImageMipCookPath(path), outMipKey, outMips, firstLevel);
+}
+
+void BuildTextureMips(Image const& image, ImageMipSettings const& settings, BlockFormat format, TextureCookTarget target,
+    uint64_t mipKey, uint64_t blockKey, ImageMipChain& outMips, CompressedMipChain& outBlocks)
+{
+    std::string const& path = image.GetImageFilePath();
+    BuildImageMipChain(image, outMips, settings);
+    if (format != BlockFormat::NONE && outMips.IsValid())
+    {
+        BlockCompressionSettings blockSettings;
+        blockSettings.m_flipVertically = FlipsBlocksAtCook(target);
+        if (CompressImageMipChain(outMips, format, outBlocks, blockSettings))
+        {
+            outMips = ImageMipChain();
+            if (UsesMipCook(settings))
+                SaveCookedCompressedMipChain(GetCompressedMipCookPath(path, format), blockKey, outBlocks);
+            return;
+        }
+        DebuggerPrintf("[TextureCook] %s: %dx%d is not a multiple of 4, kept as RGBA8 instead of %s\n",
+            path.c_str(), outMips.GetDimensions(0).x, outMips.GetDimensions(0).y, GetBlockFormatName(format));
+    }
+    if (UsesMipCook(settings) && outMips.IsValid())
+        SaveCookedImageMipChain(GetImageMipCookPath(path), mipKey, outMips);
+}
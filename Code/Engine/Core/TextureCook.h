@@ -0,0 +1,52 @@
+#pragma once
+#include "Engine/Core/BlockCompression.h"
+#include "Engine/Core/Image.hpp"
+#include "Engine/Core/ImageMipChain.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//==============================================================================
+// TextureCook - 贴图 cook 的规则：解码方向、cook key、.mips / .bcN.mips 的读写
+//==============================================================================
+// Shared by AssetStreamer (cook on first use, for the backend it runs on) and AssetCooker
+// (cook offline, for whichever backend the data is for). The backends disagree on V:
+//   DX11      stb flips V at decode (like DX11 CreateTextureFromFile)
+//   DX12      not flipped at decode; RGBA8 rows are flipped at upload, BCn blocks can't be,
+//             so they are encoded flipped
+//   HEADLESS  nothing flipped (null renderer)
+// The orientation is part of the cook key, so a cook made for one backend reads as stale on
+// another instead of upside down.
+//==============================================================================
+
+enum class TextureCookTarget : uint8_t
+{
+    DX11,
+    DX12,
+    HEADLESS
+};
+
+// the backend this build renders with
+TextureCookTarget GetNativeTextureCookTarget();
+// "dx11" / "dx12" / "headless"
+bool ParseTextureCookTarget(std::string const& text, TextureCookTarget& out);
+char const* GetTextureCookTargetName(TextureCookTarget target);
+
+// m_maxLevelCount = 1 uploads the top level only and skips the .mips cook
+bool UsesMipCook(ImageMipSettings const& settings);
+// mesh material slots: normalMap / diffuseMap / specGlossEmitMap
+ImageMipSettings GetMaterialMipSettings(int slot);
+
+// RGBA8, oriented for target
+bool DecodeImageFromMemory(std::string const& name, std::vector<uint8_t> const& bytes, TextureCookTarget target, Image& outImage);
+
+// the cooked blocks (format != NONE) or else the cooked RGBA8 chain, if up to date. The keys are
+// what a fresh cook gets saved under (BuildTextureMips). firstLevel > 0 reads levels firstLevel..
+// only (m_firstLoadedLevel)
+bool LoadCookedTextureMips(std::string const& path, ImageMipSettings const& settings, BlockFormat format, TextureCookTarget target,
+    uint64_t& outMipKey, uint64_t& outBlockKey, ImageMipChain& outMips, CompressedMipChain& outBlocks, int firstLevel = 0);
+// filter the decoded image, compress it if asked to (RGBA8 if it is not a multiple of 4), and
+// write the cook. Exactly one of outMips / outBlocks is valid afterwards
+void BuildTextureMips(Image const& image, ImageMipSettings const& settings, BlockFormat format, TextureCookTarget target,
+    uint64_t mipKey, uint64_t blockKey, ImageMipChain& outMips, CompressedMipChain& outBlocks);
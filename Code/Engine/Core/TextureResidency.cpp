@@ -0,0 +1,337 @@
+#include "TextureResidency.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Renderer/Texture.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    IntVec2 GetLevelDimensions(IntVec2 const& dimensions, int level)
+    {
+        return IntVec2(std::max(1, dimensions.x >> level), std::max(1, dimensions.y >> level));
+    }
+
+    uint64_t GetLevelBytes(IntVec2 const& dimensions, BlockFormat format)
+    {
+        if (format == BlockFormat::NONE)
+            return (uint64_t)dimensions.x * (uint64_t)dimensions.y * 4;
+        return GetCompressedLevelBytes(format, dimensions);
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+TexturePathId TexturePathTable::Intern(std::string const& path)
+{
+    auto inserted = m_ids.emplace(path, (TexturePathId)m_paths.size());
+    if (inserted.second)
+        m_paths.push_back(&inserted.first->first);
+    return inserted.first->second;
+}
+
+TexturePathId TexturePathTable::Find(std::string const& path) const
+{
+    auto found = m_ids.find(path);
+    return found != m_ids.end() ? found->second : INVALID_TEXTURE_PATH_ID;
+}
+
+//-----------------------------------------------------------------------------------------------
+void TextureLookupTable::Add(Texture* texture)
+{
+    TexturePathId id = m_paths.Intern(texture->GetImageFilePath());
+    if (id >= m_textures.size())
+        m_textures.resize(id + 1, nullptr);
+    if (!m_textures[id])
+        m_textures[id] = texture;
+}
+
+void TextureLookupTable::Remove(Texture* texture, std::vector<Texture*> const& loadedTextures)
+{
+    TexturePathId id = m_paths.Find(texture->GetImageFilePath());
+    if (id == INVALID_TEXTURE_PATH_ID || m_textures[id] != texture)
+        return;
+
+    m_textures[id] = nullptr;
+    for (Texture* other : loadedTextures)
+    {
+        if (other && other != texture && other->GetImageFilePath() == texture->GetImageFilePath())
+        {
+            m_textures[id] = other;
+            break;
+        }
+    }
+}
+
+Texture* TextureLookupTable::Find(char const* path) const
+{
+    TexturePathId id = m_paths.Find(path);
+    return id != INVALID_TEXTURE_PATH_ID ? m_textures[id] : nullptr;
+}
+
+void TextureLookupTable::Clear()
+{
+    // id 留着，路径还会再来
+    std::fill(m_textures.begin(), m_textures.end(), nullptr);
+}
+
+//-----------------------------------------------------------------------------------------------
+TextureResidencyManager::TextureResidencyManager(TextureResidencyConfig const& config)
+    : m_config(config)
+{
+}
+
+TexturePathId TextureResidencyManager::Register(std::string const& path, IntVec2 const& dimensions, int levelCount, BlockFormat format, int residentMip)
+{
+    GUARANTEE_OR_DIE(dimensions.x > 0 && dimensions.y > 0 && levelCount > 0, Stringf("TextureResidencyManager::Register \"%s\" - empty texture", path.c_str()));
+
+    TexturePathId id = m_paths.Intern(path);
+    if (id >= m_textures.size())
+        m_textures.resize(id + 1);
+    if (m_textures[id].m_isRegistered)
+        Unregister(id);
+
+    TextureRecord& texture = m_textures[id];
+    texture = TextureRecord();
+    texture.m_dimensions = dimensions;
+    texture.m_levelCount = levelCount;
+    texture.m_tailMip = levelCount - 1;
+    int lastBlockAlignedMip = levelCount - 1;
+    texture.m_bytesFromMip.assign(levelCount + 1, 0);
+    for (int level = levelCount - 1; level >= 0; level--)
+    {
+        IntVec2 levelDimensions = GetLevelDimensions(dimensions, level);
+        texture.m_bytesFromMip[level] = texture.m_bytesFromMip[level + 1] + GetLevelBytes(levelDimensions, format);
+        if (std::max(levelDimensions.x, levelDimensions.y) <= m_config.m_tailSize)
+            texture.m_tailMip = level;
+        if (levelDimensions.x % 4 != 0 || levelDimensions.y % 4 != 0)
+            lastBlockAlignedMip = level - 1;
+    }
+    // BC 贴图的顶层必须是 4 的倍数，tail 不能比这更粗
+    if (format != BlockFormat::NONE)
+        texture.m_tailMip = std::max(std::min(texture.m_tailMip, lastBlockAlignedMip), 0);
+    texture.m_residentMip = std::min(std::max(residentMip, 0), texture.m_tailMip);
+    texture.m_wantedMip = texture.m_tailMip;
+    texture.m_isRegistered = true;
+
+    m_stats.m_textureCount++;
+    m_stats.m_residentBytes += texture.m_bytesFromMip[texture.m_residentMip];
+    m_stats.m_fullBytes += texture.m_bytesFromMip[0];
+    return id;
+}
+
+void TextureResidencyManager::Unregister(TexturePathId id)
+{
+    if (!IsRegistered(id))
+        return;
+
+    TextureRecord& texture = m_textures[id];
+    m_stats.m_textureCount--;
+    m_stats.m_residentBytes -= texture.m_bytesFromMip[texture.m_residentMip];
+    m_stats.m_fullBytes -= texture.m_bytesFromMip[0];
+    if (texture.m_pendingMip >= 0)
+        m_stats.m_pendingBytes -= texture.m_bytesFromMip[texture.m_pendingMip] - texture.m_bytesFromMip[texture.m_residentMip];
+    texture.m_isRegistered = false;
+    texture.m_pendingMip = -1;
+
+    // 本帧用过的话 Update 里跳过
+}
+
+void TextureResidencyManager::NoteUse(TexturePathId id, float screenTexels)
+{
+    if (!IsRegistered(id))
+        return;
+
+    TextureRecord& texture = m_textures[id];
+    if (texture.m_lastUsedFrame != m_frameIndex)
+    {
+        texture.m_lastUsedFrame = m_frameIndex;
+        texture.m_screenTexels = screenTexels;
+        m_usedThisFrame.push_back(id);
+    }
+    else
+    {
+        texture.m_screenTexels = std::max(texture.m_screenTexels, screenTexels);
+    }
+}
+
+void TextureResidencyManager::Update(std::vector<TextureResidencyRequest>& outRequests)
+{
+    outRequests.clear();
+    m_stats.m_streamInsLastUpdate = 0;
+    m_stats.m_dropsLastUpdate = 0;
+    m_stats.m_deniedLastUpdate = 0;
+    m_stats.m_starvedLastFrame = 0;
+
+    // 最粗的、宽度仍不小于屏幕上需要的那一级
+    std::vector<TexturePathId> candidates;
+    uint32_t usedCount = 0;
+    for (TexturePathId id : m_usedThisFrame)
+    {
+        TextureRecord& texture = m_textures[id];
+        if (!texture.m_isRegistered || texture.m_lastUsedFrame != m_frameIndex)
+            continue;
+        usedCount++;
+
+        float largest = (float)std::max(texture.m_dimensions.x, texture.m_dimensions.y);
+        int wanted = texture.m_tailMip;
+        if (texture.m_screenTexels > 0.f)
+            wanted = texture.m_screenTexels >= largest ? 0 : (int)floorf(log2f(largest / texture.m_screenTexels));
+        texture.m_wantedMip = std::min(std::max(wanted, 0), texture.m_tailMip);
+
+        if (texture.m_residentMip > texture.m_wantedMip)
+            m_stats.m_starvedLastFrame++;
+        if (texture.m_pendingMip < 0 && texture.m_residentMip > texture.m_wantedMip)
+            candidates.push_back(id);
+    }
+    m_stats.m_usedLastFrame = usedCount;
+
+    // 预算可能被调小了
+    MakeRoom(0, INVALID_TEXTURE_PATH_ID, outRequests);
+
+    std::sort(candidates.begin(), candidates.end(), [this](TexturePathId a, TexturePathId b)
+    {
+        TextureRecord const& ta = m_textures[a];
+        TextureRecord const& tb = m_textures[b];
+        int deficitA = ta.m_residentMip - ta.m_wantedMip;
+        int deficitB = tb.m_residentMip - tb.m_wantedMip;
+        if (deficitA != deficitB)
+            return deficitA > deficitB;
+        return ta.m_screenTexels > tb.m_screenTexels;
+    });
+
+    std::vector<TextureResidencyRequest> streamIns;
+    for (TexturePathId id : candidates)
+    {
+        if (streamIns.size() >= m_config.m_maxStreamInsPerUpdate)
+            break;
+
+        TextureRecord& texture = m_textures[id];
+        int fromMip = texture.m_residentMip;
+        int toMip = texture.m_wantedMip;
+        MakeRoom(texture.m_bytesFromMip[toMip] - texture.m_bytesFromMip[fromMip], id, outRequests);
+        uint64_t committedBytes = m_stats.m_residentBytes + m_stats.m_pendingBytes;
+        while (toMip < fromMip && committedBytes + texture.m_bytesFromMip[toMip] - texture.m_bytesFromMip[fromMip] > m_config.m_budgetBytes)
+            toMip++;
+        if (toMip == fromMip)
+        {
+            m_stats.m_deniedLastUpdate++;
+            continue;
+        }
+
+        texture.m_pendingMip = toMip;
+        m_stats.m_pendingBytes += texture.m_bytesFromMip[toMip] - texture.m_bytesFromMip[fromMip];
+        streamIns.push_back({ id, TextureResidencyRequestType::STREAM_IN, fromMip, toMip });
+    }
+    m_stats.m_streamInsLastUpdate = (uint32_t)streamIns.size();
+    outRequests.insert(outRequests.end(), streamIns.begin(), streamIns.end());
+
+    m_stats.m_budgetBytes = m_config.m_budgetBytes;
+    m_usedThisFrame.clear();
+    m_frameIndex++;
+}
+
+bool TextureResidencyManager::MakeRoom(uint64_t bytesNeeded, TexturePathId requester, std::vector<TextureResidencyRequest>& outRequests)
+{
+    auto fits = [&]() { return m_stats.m_residentBytes + m_stats.m_pendingBytes + bytesNeeded <= m_config.m_budgetBytes; };
+    if (fits())
+        return true;
+
+    auto byLeastRecentlyUsed = [this](TexturePathId a, TexturePathId b) { return m_textures[a].m_lastUsedFrame < m_textures[b].m_lastUsedFrame; };
+
+    // a. 比需要的更细的 level，谁都用不上
+    std::vector<TexturePathId> victims;
+    for (TexturePathId id = 0; id < (TexturePathId)m_textures.size(); id++)
+    {
+        TextureRecord const& texture = m_textures[id];
+        if (texture.m_isRegistered && id != requester && texture.m_pendingMip < 0 && texture.m_residentMip < texture.m_wantedMip)
+            victims.push_back(id);
+    }
+    std::sort(victims.begin(), victims.end(), byLeastRecentlyUsed);
+    for (TexturePathId id : victims)
+    {
+        Drop(id, m_textures[id].m_wantedMip, outRequests);
+        if (fits())
+            return true;
+    }
+
+    // b. 本帧没用到的，最久没用的先丢，丢到够为止
+    victims.clear();
+    for (TexturePathId id = 0; id < (TexturePathId)m_textures.size(); id++)
+    {
+        TextureRecord const& texture = m_textures[id];
+        if (texture.m_isRegistered && id != requester && texture.m_pendingMip < 0 && texture.m_lastUsedFrame < m_frameIndex &&
+            texture.m_residentMip < texture.m_tailMip)
+            victims.push_back(id);
+    }
+    std::sort(victims.begin(), victims.end(), byLeastRecentlyUsed);
+    for (TexturePathId id : victims)
+    {
+        TextureRecord const& texture = m_textures[id];
+        uint64_t overBytes = m_stats.m_residentBytes + m_stats.m_pendingBytes + bytesNeeded - m_config.m_budgetBytes;
+        int toMip = texture.m_residentMip + 1;
+        while (toMip < texture.m_tailMip && texture.m_bytesFromMip[texture.m_residentMip] - texture.m_bytesFromMip[toMip] < overBytes)
+            toMip++;
+        Drop(id, toMip, outRequests);
+        if (fits())
+            return true;
+    }
+    return false;
+}
+
+void TextureResidencyManager::Drop(TexturePathId id, int toMip, std::vector<TextureResidencyRequest>& outRequests)
+{
+    TextureRecord& texture = m_textures[id];
+    m_stats.m_residentBytes -= texture.m_bytesFromMip[texture.m_residentMip] - texture.m_bytesFromMip[toMip];
+    outRequests.push_back({ id, TextureResidencyRequestType::DROP, texture.m_residentMip, toMip });
+    texture.m_residentMip = toMip;
+    m_stats.m_dropsLastUpdate++;
+}
+
+void TextureResidencyManager::OnStreamedIn(TexturePathId id, int residentMip)
+{
+    if (!IsRegistered(id) || m_textures[id].m_pendingMip < 0)
+        return;
+
+    TextureRecord& texture = m_textures[id];
+    m_stats.m_pendingBytes -= texture.m_bytesFromMip[texture.m_pendingMip] - texture.m_bytesFromMip[texture.m_residentMip];
+    m_stats.m_residentBytes -= texture.m_bytesFromMip[texture.m_residentMip];
+    texture.m_residentMip = std::min(std::max(residentMip, texture.m_pendingMip), texture.m_residentMip);
+    m_stats.m_residentBytes += texture.m_bytesFromMip[texture.m_residentMip];
+    texture.m_pendingMip = -1;
+}
+
+uint64_t TextureResidencyManager::GetBytesFromMip(TexturePathId id, int mip) const
+{
+    return m_textures[id].m_bytesFromMip[std::min(std::max(mip, 0), m_textures[id].m_levelCount)];
+}
+
+TextureResidencyInfo TextureResidencyManager::GetInfo(TexturePathId id) const
+{
+    TextureResidencyInfo info;
+    if (!IsRegistered(id))
+        return info;
+
+    TextureRecord const& texture = m_textures[id];
+    info.m_id = id;
+    info.m_dimensions = texture.m_dimensions;
+    info.m_levelCount = texture.m_levelCount;
+    info.m_residentMip = texture.m_residentMip;
+    info.m_pendingMip = texture.m_pendingMip;
+    info.m_wantedMip = texture.m_wantedMip;
+    info.m_tailMip = texture.m_tailMip;
+    info.m_residentBytes = texture.m_bytesFromMip[texture.m_residentMip];
+    info.m_fullBytes = texture.m_bytesFromMip[0];
+    info.m_lastUsedFrame = texture.m_lastUsedFrame;
+    return info;
+}
+
+void TextureResidencyManager::GetAllInfo(std::vector<TextureResidencyInfo>& out) const
+{
+    out.clear();
+    for (TexturePathId id = 0; id < (TexturePathId)m_textures.size(); id++)
+    {
+        if (m_textures[id].m_isRegistered)
+            out.push_back(GetInfo(id));
+    }
+}
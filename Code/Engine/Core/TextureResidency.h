@@ -0,0 +1,170 @@
+#pragma once
+#include "Engine/Core/BlockCompression.h"
+#include "Engine/Math/IntVec2.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Texture;
+
+//==============================================================================
+// TextureResidency - 贴图显存预算：按屏幕上需要的分辨率决定常驻哪些 mip，超预算按 LRU 丢
+//==============================================================================
+// TextureResidencyManager is pure policy: it never touches a renderer, so it runs headless
+// (the IglooBench residency bench replays an access trace through it). Per frame:
+//   1. NoteUse        the caller reports how many texels across the texture covers on screen;
+//                     the wanted mip is the coarsest one still at least that wide
+//   2. Update         stream-in requests for textures used this frame whose resident (or
+//                     already pending) mip is coarser than wanted, most starved first.
+//                     Room is made by dropping levels, cheapest loss first:
+//                       a. levels finer than a texture's wanted mip, least recently used first
+//                       b. textures not used this frame, down to the mip tail, LRU
+//                     A stream-in that still doesn't fit is shortened to the finest level that
+//                     does. Drops count as applied when Update returns; stream-ins count
+//                     against the budget while pending, until OnStreamedIn
+// The mip tail (levels no larger than m_tailSize) is always resident.
+//
+// Paths are interned once (TexturePathTable); everything after that is indexed by id.
+//==============================================================================
+
+using TexturePathId = uint32_t;
+static constexpr TexturePathId INVALID_TEXTURE_PATH_ID = 0xFFFFFFFFu;
+
+// path -> dense id, ids are never reused
+class TexturePathTable
+{
+public:
+    TexturePathId Intern(std::string const& path);
+    TexturePathId Find(std::string const& path) const;
+    std::string const& GetPath(TexturePathId id) const { return *m_paths[id]; }
+    uint32_t GetCount() const { return (uint32_t)m_paths.size(); }
+
+private:
+    std::unordered_map<std::string, TexturePathId> m_ids;
+    std::vector<std::string const*> m_paths;    // keys of m_ids, node addresses are stable
+};
+
+// the backends' GetTextureForFileName: interned path -> texture. The first texture added under
+// a path wins, like the linear search this replaced
+class TextureLookupTable
+{
+public:
+    void Add(Texture* texture);
+    // another loaded texture with the same path (if any) takes its place
+    void Remove(Texture* texture, std::vector<Texture*> const& loadedTextures);
+    Texture* Find(char const* path) const;
+    void Clear();
+
+private:
+    TexturePathTable m_paths;
+    std::vector<Texture*> m_textures;           // by id
+};
+
+//-----------------------------------------------------------------------------------------------
+struct TextureResidencyConfig
+{
+    uint64_t m_budgetBytes = 256ull * 1024 * 1024;
+    int m_tailSize = 64;                        // levels this size and smaller never drop
+    uint32_t m_maxStreamInsPerUpdate = 8;
+};
+
+enum class TextureResidencyRequestType : uint8_t
+{
+    STREAM_IN,
+    DROP
+};
+
+struct TextureResidencyRequest
+{
+    TexturePathId m_id = INVALID_TEXTURE_PATH_ID;
+    TextureResidencyRequestType m_type = TextureResidencyRequestType::STREAM_IN;
+    int m_fromMip = 0;                          // currently resident
+    int m_toMip = 0;                            // finest level resident afterwards
+};
+
+struct TextureResidencyInfo
+{
+    TexturePathId m_id = INVALID_TEXTURE_PATH_ID;
+    IntVec2 m_dimensions;                       // level 0
+    int m_levelCount = 0;
+    int m_residentMip = 0;
+    int m_pendingMip = -1;                      // stream-in target, -1 if none
+    int m_wantedMip = 0;                        // as of the last frame it was used
+    int m_tailMip = 0;
+    uint64_t m_residentBytes = 0;
+    uint64_t m_fullBytes = 0;
+    uint64_t m_lastUsedFrame = 0;
+};
+
+struct TextureResidencyStats
+{
+    uint32_t m_textureCount = 0;
+    uint64_t m_budgetBytes = 0;
+    uint64_t m_residentBytes = 0;
+    uint64_t m_pendingBytes = 0;                // stream-ins not landed yet
+    uint64_t m_fullBytes = 0;                   // everything at mip 0
+    uint32_t m_usedLastFrame = 0;
+    uint32_t m_starvedLastFrame = 0;            // used, resident coarser than wanted
+    uint32_t m_streamInsLastUpdate = 0;
+    uint32_t m_dropsLastUpdate = 0;
+    uint32_t m_deniedLastUpdate = 0;            // stream-ins with no room at all
+};
+
+class TextureResidencyManager
+{
+public:
+    explicit TextureResidencyManager(TextureResidencyConfig const& config = TextureResidencyConfig());
+
+    // format NONE = RGBA8. residentMip is what the caller uploaded (clamped to the tail)
+    TexturePathId Register(std::string const& path, IntVec2 const& dimensions, int levelCount, BlockFormat format, int residentMip);
+    void Unregister(TexturePathId id);
+    TexturePathId Find(std::string const& path) const { return m_paths.Find(path); }
+    std::string const& GetPath(TexturePathId id) const { return m_paths.GetPath(id); }
+    bool IsRegistered(TexturePathId id) const { return id < m_textures.size() && m_textures[id].m_isRegistered; }
+
+    // the texture covers about screenTexels texels across on screen this frame (max per frame)
+    void NoteUse(TexturePathId id, float screenTexels);
+    // once per frame, after the frame's NoteUse calls. Drops come first in outRequests and must
+    // be applied before the stream-ins are started
+    void Update(std::vector<TextureResidencyRequest>& outRequests);
+    // the stream-in landed (residentMip may be coarser than requested if the caller gave up)
+    void OnStreamedIn(TexturePathId id, int residentMip);
+
+    int GetTailMip(TexturePathId id) const { return m_textures[id].m_tailMip; }
+    // bytes of levels mip..end
+    uint64_t GetBytesFromMip(TexturePathId id, int mip) const;
+    TextureResidencyInfo GetInfo(TexturePathId id) const;
+    void GetAllInfo(std::vector<TextureResidencyInfo>& out) const;
+    TextureResidencyStats const& GetStats() const { return m_stats; }
+    TextureResidencyConfig const& GetConfig() const { return m_config; }
+    void SetBudgetBytes(uint64_t budgetBytes) { m_config.m_budgetBytes = budgetBytes; }
+    uint64_t GetFrameIndex() const { return m_frameIndex; }
+
+private:
+    struct TextureRecord
+    {
+        IntVec2 m_dimensions;
+        int m_levelCount = 0;
+        int m_tailMip = 0;
+        int m_residentMip = 0;
+        int m_pendingMip = -1;
+        int m_wantedMip = 0;
+        float m_screenTexels = 0.f;             // this frame
+        uint64_t m_lastUsedFrame = 0;
+        bool m_isRegistered = false;
+        std::vector<uint64_t> m_bytesFromMip;   // [m] = bytes of levels m..end, [levelCount] = 0
+    };
+
+    bool MakeRoom(uint64_t bytesNeeded, TexturePathId requester, std::vector<TextureResidencyRequest>& outRequests);
+    void Drop(TexturePathId id, int toMip, std::vector<TextureResidencyRequest>& outRequests);
+
+private:
+    TextureResidencyConfig m_config;
+    TexturePathTable m_paths;
+    std::vector<TextureRecord> m_textures;      // by id
+    std::vector<TexturePathId> m_usedThisFrame;
+    uint64_t m_frameIndex = 1;
+    TextureResidencyStats m_stats;
+};
@@ -4,10 +4,15 @@
 
 //-----------------------------------------------------------------------------------------------
 #include "Engine/Core/Time.hpp"
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
+#else
+#include <chrono>
+#endif
 
 
+#ifdef _WIN32
 //-----------------------------------------------------------------------------------------------
 double InitializeTime( LARGE_INTEGER& out_initialTime )
 {
@@ -32,3 +37,12 @@ double GetCurrentTimeSeconds()
 }
 
 
+#else
+//-----------------------------------------------------------------------------------------------
+double GetCurrentTimeSeconds()
+{
+	static std::chrono::steady_clock::time_point const initialTime = std::chrono::steady_clock::now();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - initialTime;
+	return elapsed.count();
+}
+#endif
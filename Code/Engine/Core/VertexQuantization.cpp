@@ -0,0 +1,393 @@
+#include "VertexQuantization.h"
+
+#include "Engine/Math/MathUtils.hpp"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <emmintrin.h>
+
+Mat44 VertexQuantization::GetDequantizationTransform() const
+{
+    return Mat44(Vec3(m_positionScale, 0.f, 0.f), Vec3(0.f, m_positionScale, 0.f), Vec3(0.f, 0.f, m_positionScale), m_positionMin);
+}
+
+VertexQuantization ComputeVertexQuantization(Vertex_PCUTBN const* verts, size_t count)
+{
+    VertexQuantization quantization;
+    if (count == 0)
+        return quantization;
+
+    Vec3 mn = Vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+    Vec3 mx = Vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (size_t i = 0; i < count; i++)
+    {
+        Vec3 const& p = verts[i].m_position;
+        mn.x = MinF(mn.x, p.x);
+        mn.y = MinF(mn.y, p.y);
+        mn.z = MinF(mn.z, p.z);
+        mx.x = MaxF(mx.x, p.x);
+        mx.y = MaxF(mx.y, p.y);
+        mx.z = MaxF(mx.z, p.z);
+    }
+
+    quantization.m_positionMin = mn;
+    quantization.m_positionScale = MaxF(MaxF(mx.x - mn.x, mx.y - mn.y), mx.z - mn.z);
+    return quantization;
+}
+
+//-----------------------------------------------------------------------------------------------
+uint16_t FloatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t absBits = bits & 0x7FFFFFFFu;
+
+    if (absBits >= 0x7F800000u)          // inf / nan
+        return (uint16_t)(sign | 0x7C00u | (absBits > 0x7F800000u ? 0x0200u : 0u));
+    if (absBits >= 0x477FF000u)          // rounds past 65504
+        return (uint16_t)(sign | 0x7C00u);
+
+    if (absBits < 0x38800000u)           // half subnormal
+    {
+        if (absBits <= 0x33000000u)
+            return (uint16_t)sign;
+        uint32_t mantissa = (absBits & 0x007FFFFFu) | 0x00800000u;
+        uint32_t shift = 126u - (absBits >> 23);
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        uint32_t halfway = 1u << (shift - 1u);
+        if (remainder > halfway || (remainder == halfway && (half & 1u)))
+            half++;
+        return (uint16_t)(sign | half);
+    }
+
+    // 重新偏置指数，round to nearest even；进位可以直接溢到指数位
+    uint32_t half = (absBits - 0x38000000u) >> 13;
+    uint32_t remainder = absBits & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+        half++;
+    return (uint16_t)(sign | half);
+}
+
+float HalfToFloat(uint16_t half)
+{
+    uint32_t sign = ((uint32_t)half & 0x8000u) << 16;
+    uint32_t exponent = ((uint32_t)half >> 10) & 0x1Fu;
+    uint32_t mantissa = (uint32_t)half & 0x3FFu;
+
+    uint32_t bits;
+    if (exponent == 0)
+    {
+        float value = (float)mantissa * 5.9604645e-8f;  // 2^-24
+        return sign ? -value : value;
+    }
+    if (exponent == 31)
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    else
+        bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+//-----------------------------------------------------------------------------------------------
+namespace
+{
+    // x >= 0 ? 1 : -1（和 HLSL 解码里的 >= 0 一致）
+    inline __m128 SignNotZero(__m128 v)
+    {
+        __m128 signBits = _mm_and_ps(v, _mm_set1_ps(-0.f));
+        return _mm_or_ps(signBits, _mm_set1_ps(1.f));
+    }
+
+    inline __m128 Abs(__m128 v)
+    {
+        return _mm_andnot_ps(_mm_set1_ps(-0.f), v);
+    }
+
+    inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    // 4 个单位向量 -> octahedral SNORM16
+    void OctEncode4(__m128 x, __m128 y, __m128 z, __m128i& outX, __m128i& outY)
+    {
+        __m128 l1 = _mm_add_ps(_mm_add_ps(Abs(x), Abs(y)), Abs(z));
+        l1 = _mm_max_ps(l1, _mm_set1_ps(1e-20f));
+        __m128 invL1 = _mm_div_ps(_mm_set1_ps(1.f), l1);
+        x = _mm_mul_ps(x, invL1);
+        y = _mm_mul_ps(y, invL1);
+        z = _mm_mul_ps(z, invL1);
+
+        __m128 one = _mm_set1_ps(1.f);
+        __m128 lowerHemisphere = _mm_cmplt_ps(z, _mm_setzero_ps());
+        __m128 foldedX = _mm_mul_ps(_mm_sub_ps(one, Abs(y)), SignNotZero(x));
+        __m128 foldedY = _mm_mul_ps(_mm_sub_ps(one, Abs(x)), SignNotZero(y));
+        x = Select(lowerHemisphere, foldedX, x);
+        y = Select(lowerHemisphere, foldedY, y);
+
+        __m128 snormScale = _mm_set1_ps(32767.f);
+        __m128 minusOne = _mm_set1_ps(-1.f);
+        outX = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(x, minusOne), one), snormScale));
+        outY = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(y, minusOne), one), snormScale));
+    }
+
+    void OctDecode4(__m128i encodedX, __m128i encodedY, __m128& x, __m128& y, __m128& z)
+    {
+        __m128 invScale = _mm_set1_ps(1.f / 32767.f);
+        __m128 minusOne = _mm_set1_ps(-1.f);
+        x = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(encodedX), invScale), minusOne);
+        y = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(encodedY), invScale), minusOne);
+        z = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(1.f), Abs(x)), Abs(y));
+
+        __m128 t = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), z), _mm_setzero_ps());
+        x = _mm_sub_ps(x, _mm_mul_ps(t, SignNotZero(x)));
+        y = _mm_sub_ps(y, _mm_mul_ps(t, SignNotZero(y)));
+
+        __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+        __m128 invLength = _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(lengthSq));
+        x = _mm_mul_ps(x, invLength);
+        y = _mm_mul_ps(y, invLength);
+        z = _mm_mul_ps(z, invLength);
+    }
+
+    struct alignas(16) Lanes
+    {
+        float m_f[4];
+        int32_t m_i[4];
+    };
+
+    // 一次 4 个；尾巴由调用方补齐到 4 个再传进来
+    void EncodeBlock4(Vertex_PCUTBN const* in, VertexQuantization const& quantization, Vertex_PCUTBNPacked* out, size_t outCount)
+    {
+        __m128 px = _mm_set_ps(in[3].m_position.x, in[2].m_position.x, in[1].m_position.x, in[0].m_position.x);
+        __m128 py = _mm_set_ps(in[3].m_position.y, in[2].m_position.y, in[1].m_position.y, in[0].m_position.y);
+        __m128 pz = _mm_set_ps(in[3].m_position.z, in[2].m_position.z, in[1].m_position.z, in[0].m_position.z);
+        __m128 nx = _mm_set_ps(in[3].m_normal.x, in[2].m_normal.x, in[1].m_normal.x, in[0].m_normal.x);
+        __m128 ny = _mm_set_ps(in[3].m_normal.y, in[2].m_normal.y, in[1].m_normal.y, in[0].m_normal.y);
+        __m128 nz = _mm_set_ps(in[3].m_normal.z, in[2].m_normal.z, in[1].m_normal.z, in[0].m_normal.z);
+        __m128 tx = _mm_set_ps(in[3].m_tangent.x, in[2].m_tangent.x, in[1].m_tangent.x, in[0].m_tangent.x);
+        __m128 ty = _mm_set_ps(in[3].m_tangent.y, in[2].m_tangent.y, in[1].m_tangent.y, in[0].m_tangent.y);
+        __m128 tz = _mm_set_ps(in[3].m_tangent.z, in[2].m_tangent.z, in[1].m_tangent.z, in[0].m_tangent.z);
+        __m128 bx = _mm_set_ps(in[3].m_bitangent.x, in[2].m_bitangent.x, in[1].m_bitangent.x, in[0].m_bitangent.x);
+        __m128 by = _mm_set_ps(in[3].m_bitangent.y, in[2].m_bitangent.y, in[1].m_bitangent.y, in[0].m_bitangent.y);
+        __m128 bz = _mm_set_ps(in[3].m_bitangent.z, in[2].m_bitangent.z, in[1].m_bitangent.z, in[0].m_bitangent.z);
+
+        // position -> [0, 65535]
+        float invScale = quantization.m_positionScale > 0.f ? 65535.f / quantization.m_positionScale : 0.f;
+        __m128 scale = _mm_set1_ps(invScale);
+        __m128 zero = _mm_setzero_ps();
+        __m128 maxValue = _mm_set1_ps(65535.f);
+        __m128i qx = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(px, _mm_set1_ps(quantization.m_positionMin.x)), scale), zero), maxValue));
+        __m128i qy = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(py, _mm_set1_ps(quantization.m_positionMin.y)), scale), zero), maxValue));
+        __m128i qz = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(pz, _mm_set1_ps(quantization.m_positionMin.z)), scale), zero), maxValue));
+
+        // bitangent 只留 sign：dot(cross(N, T), B) < 0 -> 0
+        __m128 cx = _mm_sub_ps(_mm_mul_ps(ny, tz), _mm_mul_ps(nz, ty));
+        __m128 cy = _mm_sub_ps(_mm_mul_ps(nz, tx), _mm_mul_ps(nx, tz));
+        __m128 cz = _mm_sub_ps(_mm_mul_ps(nx, ty), _mm_mul_ps(ny, tx));
+        __m128 handedness = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, bx), _mm_mul_ps(cy, by)), _mm_mul_ps(cz, bz));
+        Lanes sign;
+        _mm_store_ps(sign.m_f, _mm_cmplt_ps(handedness, zero));
+
+        __m128i onx, ony, otx, oty;
+        OctEncode4(nx, ny, nz, onx, ony);
+        OctEncode4(tx, ty, tz, otx, oty);
+
+        Lanes lx, ly, lz, lnx, lny, ltx, lty;
+        _mm_store_si128((__m128i*)lx.m_i, qx);
+        _mm_store_si128((__m128i*)ly.m_i, qy);
+        _mm_store_si128((__m128i*)lz.m_i, qz);
+        _mm_store_si128((__m128i*)lnx.m_i, onx);
+        _mm_store_si128((__m128i*)lny.m_i, ony);
+        _mm_store_si128((__m128i*)ltx.m_i, otx);
+        _mm_store_si128((__m128i*)lty.m_i, oty);
+
+        for (size_t i = 0; i < outCount; i++)
+        {
+            Vertex_PCUTBNPacked& packed = out[i];
+            uint32_t negativeHandedness;
+            memcpy(&negativeHandedness, &sign.m_f[i], sizeof(negativeHandedness));
+            packed.m_position[0] = (uint16_t)lx.m_i[i];
+            packed.m_position[1] = (uint16_t)ly.m_i[i];
+            packed.m_position[2] = (uint16_t)lz.m_i[i];
+            packed.m_position[3] = negativeHandedness ? 0 : 65535;
+            packed.m_color = in[i].m_color;
+            packed.m_uvTexCoords[0] = FloatToHalf(in[i].m_uvTexCoords.x);
+            packed.m_uvTexCoords[1] = FloatToHalf(in[i].m_uvTexCoords.y);
+            packed.m_normalOct[0] = (int16_t)lnx.m_i[i];
+            packed.m_normalOct[1] = (int16_t)lny.m_i[i];
+            packed.m_tangentOct[0] = (int16_t)ltx.m_i[i];
+            packed.m_tangentOct[1] = (int16_t)lty.m_i[i];
+        }
+    }
+
+    void DecodeBlock4(Vertex_PCUTBNPacked const* in, VertexQuantization const& quantization, Vertex_PCUTBN* out, size_t outCount)
+    {
+        __m128i qx = _mm_set_epi32(in[3].m_position[0], in[2].m_position[0], in[1].m_position[0], in[0].m_position[0]);
+        __m128i qy = _mm_set_epi32(in[3].m_position[1], in[2].m_position[1], in[1].m_position[1], in[0].m_position[1]);
+        __m128i qz = _mm_set_epi32(in[3].m_position[2], in[2].m_position[2], in[1].m_position[2], in[0].m_position[2]);
+        __m128 sign = _mm_set_ps(in[3].m_position[3] ? 1.f : -1.f, in[2].m_position[3] ? 1.f : -1.f, in[1].m_position[3] ? 1.f : -1.f, in[0].m_position[3] ? 1.f : -1.f);
+        __m128i enx = _mm_set_epi32(in[3].m_normalOct[0], in[2].m_normalOct[0], in[1].m_normalOct[0], in[0].m_normalOct[0]);
+        __m128i eny = _mm_set_epi32(in[3].m_normalOct[1], in[2].m_normalOct[1], in[1].m_normalOct[1], in[0].m_normalOct[1]);
+        __m128i etx = _mm_set_epi32(in[3].m_tangentOct[0], in[2].m_tangentOct[0], in[1].m_tangentOct[0], in[0].m_tangentOct[0]);
+        __m128i ety = _mm_set_epi32(in[3].m_tangentOct[1], in[2].m_tangentOct[1], in[1].m_tangentOct[1], in[0].m_tangentOct[1]);
+
+        __m128 step = _mm_set1_ps(quantization.m_positionScale / 65535.f);
+        __m128 px = _mm_add_ps(_mm_set1_ps(quantization.m_positionMin.x), _mm_mul_ps(_mm_cvtepi32_ps(qx), step));
+        __m128 py = _mm_add_ps(_mm_set1_ps(quantization.m_positionMin.y), _mm_mul_ps(_mm_cvtepi32_ps(qy), step));
+        __m128 pz = _mm_add_ps(_mm_set1_ps(quantization.m_positionMin.z), _mm_mul_ps(_mm_cvtepi32_ps(qz), step));
+
+        __m128 nx, ny, nz, tx, ty, tz;
+        OctDecode4(enx, eny, nx, ny, nz);
+        OctDecode4(etx, ety, tx, ty, tz);
+
+        __m128 bx = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(ny, tz), _mm_mul_ps(nz, ty)), sign);
+        __m128 by = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(nz, tx), _mm_mul_ps(nx, tz)), sign);
+        __m128 bz = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(nx, ty), _mm_mul_ps(ny, tx)), sign);
+
+        Lanes lanes[12];
+        __m128 const results[12] = { px, py, pz, nx, ny, nz, tx, ty, tz, bx, by, bz };
+        for (int c = 0; c < 12; c++)
+        {
+            _mm_store_ps(lanes[c].m_f, results[c]);
+        }
+
+        for (size_t i = 0; i < outCount; i++)
+        {
+            Vertex_PCUTBN& v = out[i];
+            v.m_position = Vec3(lanes[0].m_f[i], lanes[1].m_f[i], lanes[2].m_f[i]);
+            v.m_color = in[i].m_color;
+            v.m_uvTexCoords = Vec2(HalfToFloat(in[i].m_uvTexCoords[0]), HalfToFloat(in[i].m_uvTexCoords[1]));
+            v.m_normal = Vec3(lanes[3].m_f[i], lanes[4].m_f[i], lanes[5].m_f[i]);
+            v.m_tangent = Vec3(lanes[6].m_f[i], lanes[7].m_f[i], lanes[8].m_f[i]);
+            v.m_bitangent = Vec3(lanes[9].m_f[i], lanes[10].m_f[i], lanes[11].m_f[i]);
+        }
+    }
+
+    float AngleBetweenDegrees(Vec3 const& a, Vec3 const& b)
+    {
+        float lengthA = a.GetLength();
+        float lengthB = b.GetLength();
+        if (lengthA <= 0.f || lengthB <= 0.f)
+            return 0.f;
+        float cosAngle = DotProduct3D(a, b) / (lengthA * lengthB);
+        cosAngle = MinF(MaxF(cosAngle, -1.f), 1.f);
+        return acosf(cosAngle) * (180.f / 3.14159265f);
+    }
+}
+
+void EncodePackedVertices(Vertex_PCUTBN const* verts, size_t count, VertexQuantization const& quantization, Vertex_PCUTBNPacked* out)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        EncodeBlock4(verts + i, quantization, out + i, 4);
+    }
+    if (i < count)
+    {
+        Vertex_PCUTBN tail[4];
+        for (size_t t = 0; t < count - i; t++)
+        {
+            tail[t] = verts[i + t];
+        }
+        EncodeBlock4(tail, quantization, out + i, count - i);
+    }
+}
+
+void DecodePackedVertices(Vertex_PCUTBNPacked const* verts, size_t count, VertexQuantization const& quantization, Vertex_PCUTBN* out)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        DecodeBlock4(verts + i, quantization, out + i, 4);
+    }
+    if (i < count)
+    {
+        Vertex_PCUTBNPacked tail[4];
+        for (size_t t = 0; t < count - i; t++)
+        {
+            tail[t] = verts[i + t];
+        }
+        DecodeBlock4(tail, quantization, out + i, count - i);
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+bool CanUse16BitIndices(std::vector<unsigned int> const& indices)
+{
+    for (unsigned int index : indices)
+    {
+        if (index > 0xFFFFu)
+            return false;
+    }
+    return true;
+}
+
+bool NarrowIndicesTo16(std::vector<unsigned int> const& indices, std::vector<uint16_t>& out)
+{
+    out.clear();
+    if (!CanUse16BitIndices(indices))
+        return false;
+
+    out.resize(indices.size());
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        out[i] = (uint16_t)indices[i];
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+VertexQuantizationReport MeasureQuantizationError(std::vector<Vertex_PCUTBN> const& original, std::vector<Vertex_PCUTBNPacked> const& packed, VertexQuantization const& quantization)
+{
+    VertexQuantizationReport report;
+    report.m_vertexCount = (uint32_t)original.size();
+    report.m_originalVertexBytes = original.size() * sizeof(Vertex_PCUTBN);
+    report.m_packedVertexBytes = packed.size() * sizeof(Vertex_PCUTBNPacked);
+    if (original.empty() || original.size() != packed.size())
+        return report;
+
+    std::vector<Vertex_PCUTBN> decoded(packed.size());
+    DecodePackedVertices(packed.data(), packed.size(), quantization, decoded.data());
+
+    double positionErrorSum = 0.0;
+    for (size_t i = 0; i < original.size(); i++)
+    {
+        Vertex_PCUTBN const& a = original[i];
+        Vertex_PCUTBN const& b = decoded[i];
+
+        float positionError = (a.m_position - b.m_position).GetLength();
+        positionErrorSum += positionError;
+        report.m_maxPositionError = MaxF(report.m_maxPositionError, positionError);
+
+        report.m_maxNormalErrorDegrees = MaxF(report.m_maxNormalErrorDegrees, AngleBetweenDegrees(a.m_normal, b.m_normal));
+        report.m_maxTangentErrorDegrees = MaxF(report.m_maxTangentErrorDegrees, AngleBetweenDegrees(a.m_tangent, b.m_tangent));
+        report.m_maxBitangentErrorDegrees = MaxF(report.m_maxBitangentErrorDegrees, AngleBetweenDegrees(a.m_bitangent, b.m_bitangent));
+
+        report.m_maxUVError = MaxF(report.m_maxUVError, fabsf(a.m_uvTexCoords.x - b.m_uvTexCoords.x));
+        report.m_maxUVError = MaxF(report.m_maxUVError, fabsf(a.m_uvTexCoords.y - b.m_uvTexCoords.y));
+
+        if (!(a.m_color == b.m_color))
+            report.m_colorMismatches++;
+    }
+    report.m_avgPositionError = (float)(positionErrorSum / (double)original.size());
+    return report;
+}
+
+void PackStaticMeshVertices(std::vector<Vertex_PCUTBN> const& verts, std::vector<unsigned int> const& indices, PackedMeshData& out)
+{
+    out.m_quantization = ComputeVertexQuantization(verts.data(), verts.size());
+    out.m_verts.resize(verts.size());
+    EncodePackedVertices(verts.data(), verts.size(), out.m_quantization, out.m_verts.data());
+    out.m_uses16BitIndices = NarrowIndicesTo16(indices, out.m_indices16);
+
+    out.m_report = MeasureQuantizationError(verts, out.m_verts, out.m_quantization);
+    out.m_report.m_indexCount = (uint32_t)indices.size();
+    out.m_report.m_originalIndexBytes = indices.size() * sizeof(unsigned int);
+    out.m_report.m_packedIndexBytes = indices.size() * (out.m_uses16BitIndices ? sizeof(uint16_t) : sizeof(unsigned int));
+}
@@ -0,0 +1,188 @@
+#pragma once
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/Mat44.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//==============================================================================
+// VertexQuantization - Vertex_PCUTBN 的压缩格式 (60B -> 24B)
+//==============================================================================
+// Vertex_PCUTBNPacked
+//   POSITION  R16G16B16A16_UNORM  xyz relative to the mesh bounds, w = bitangent sign (0 -> -1, 1 -> +1)
+//   COLOR     R8G8B8A8_UNORM      unchanged
+//   TEXCOORD  R16G16_FLOAT        half UVs (tiling UVs up to +-2048 keep ~1/1024 precision)
+//   NORMAL    R16G16_SNORM        octahedral
+//   TANGENT   R16G16_SNORM        octahedral
+//
+// Positions use one uniform scale (the longest bounds axis) so dequantization is a
+// uniform scale + translation: it folds into the model matrix
+// (GetDequantizationTransform()) without skewing normals, and the vertex shader only has
+// to undo the octahedral mapping and rebuild the bitangent:
+//
+//   float3 OctDecode(float2 e)
+//   {
+//       float3 n = float3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+//       float t = saturate(-n.z);
+//       n.xy += (n.xy >= 0.0) ? -t : t;
+//       return normalize(n);
+//   }
+//   bitangent = cross(normal, tangent) * (input.Position.w * 2.0 - 1.0);
+//
+// Index buffers drop to 16 bits whenever every index fits.
+//==============================================================================
+
+enum class VertexAttributeFormat
+{
+    FLOAT2,
+    FLOAT3,
+    UNORM8x4,
+    UNORM16x4,
+    HALF2,
+    SNORM16x2,
+    COUNT
+};
+
+constexpr unsigned int GetVertexAttributeFormatSize(VertexAttributeFormat format)
+{
+    return format == VertexAttributeFormat::FLOAT2 ? 8u :
+           format == VertexAttributeFormat::FLOAT3 ? 12u :
+           format == VertexAttributeFormat::UNORM8x4 ? 4u :
+           format == VertexAttributeFormat::UNORM16x4 ? 8u :
+           format == VertexAttributeFormat::HALF2 ? 4u :
+           format == VertexAttributeFormat::SNORM16x2 ? 4u : 0u;
+}
+
+struct VertexAttributeDesc
+{
+    char const* m_semantic;
+    VertexAttributeFormat m_format;
+    unsigned int m_offset;
+};
+
+//-----------------------------------------------------------------------------------------------
+#pragma pack(push, 1)
+struct Vertex_PCUTBNPacked
+{
+    uint16_t m_position[4] = {};     // xyz UNORM in mesh bounds, w = bitangent sign
+    Rgba8 m_color = Rgba8::WHITE;
+    uint16_t m_uvTexCoords[2] = {};  // half
+    int16_t m_normalOct[2] = {};     // SNORM
+    int16_t m_tangentOct[2] = {};    // SNORM
+};
+#pragma pack(pop)
+
+// 编译期描述 layout；input layout 和 report 都从这里读
+template <typename TVertex>
+struct VertexLayoutTraits;
+
+template <>
+struct VertexLayoutTraits<Vertex_PCUTBN>
+{
+    static constexpr VertexAttributeDesc ATTRIBUTES[] =
+    {
+        { "POSITION",  VertexAttributeFormat::FLOAT3,   offsetof(Vertex_PCUTBN, m_position) },
+        { "COLOR",     VertexAttributeFormat::UNORM8x4, offsetof(Vertex_PCUTBN, m_color) },
+        { "TEXCOORD",  VertexAttributeFormat::FLOAT2,   offsetof(Vertex_PCUTBN, m_uvTexCoords) },
+        { "TANGENT",   VertexAttributeFormat::FLOAT3,   offsetof(Vertex_PCUTBN, m_tangent) },
+        { "BITANGENT", VertexAttributeFormat::FLOAT3,   offsetof(Vertex_PCUTBN, m_bitangent) },
+        { "NORMAL",    VertexAttributeFormat::FLOAT3,   offsetof(Vertex_PCUTBN, m_normal) },
+    };
+    static constexpr unsigned int ATTRIBUTE_COUNT = sizeof(ATTRIBUTES) / sizeof(ATTRIBUTES[0]);
+    static constexpr unsigned int STRIDE = sizeof(Vertex_PCUTBN);
+};
+
+template <>
+struct VertexLayoutTraits<Vertex_PCUTBNPacked>
+{
+    static constexpr VertexAttributeDesc ATTRIBUTES[] =
+    {
+        { "POSITION",  VertexAttributeFormat::UNORM16x4, offsetof(Vertex_PCUTBNPacked, m_position) },
+        { "COLOR",     VertexAttributeFormat::UNORM8x4,  offsetof(Vertex_PCUTBNPacked, m_color) },
+        { "TEXCOORD",  VertexAttributeFormat::HALF2,     offsetof(Vertex_PCUTBNPacked, m_uvTexCoords) },
+        { "NORMAL",    VertexAttributeFormat::SNORM16x2, offsetof(Vertex_PCUTBNPacked, m_normalOct) },
+        { "TANGENT",   VertexAttributeFormat::SNORM16x2, offsetof(Vertex_PCUTBNPacked, m_tangentOct) },
+    };
+    static constexpr unsigned int ATTRIBUTE_COUNT = sizeof(ATTRIBUTES) / sizeof(ATTRIBUTES[0]);
+    static constexpr unsigned int STRIDE = sizeof(Vertex_PCUTBNPacked);
+};
+
+// 属性必须首尾相接、正好铺满 stride（input layout 用 APPEND_ALIGNED_ELEMENT）
+template <typename TVertex>
+constexpr bool IsVertexLayoutTight()
+{
+    unsigned int offset = 0;
+    for (unsigned int i = 0; i < VertexLayoutTraits<TVertex>::ATTRIBUTE_COUNT; i++)
+    {
+        VertexAttributeDesc const& desc = VertexLayoutTraits<TVertex>::ATTRIBUTES[i];
+        if (desc.m_offset != offset)
+            return false;
+        offset += GetVertexAttributeFormatSize(desc.m_format);
+    }
+    return offset == VertexLayoutTraits<TVertex>::STRIDE;
+}
+
+static_assert(sizeof(Vertex_PCUTBNPacked) == 24, "Vertex_PCUTBNPacked must stay 24 bytes");
+static_assert(IsVertexLayoutTight<Vertex_PCUTBN>(), "Vertex_PCUTBN layout descriptor is out of date");
+static_assert(IsVertexLayoutTight<Vertex_PCUTBNPacked>(), "Vertex_PCUTBNPacked layout descriptor is out of date");
+
+//-----------------------------------------------------------------------------------------------
+struct VertexQuantization
+{
+    Vec3 m_positionMin;
+    float m_positionScale = 0.f;     // longest bounds axis; UNORM 1.0 maps to min + scale
+
+    float GetPositionStep() const { return m_positionScale / 65535.f; }
+    Mat44 GetDequantizationTransform() const;   // UNORM position -> mesh space
+};
+
+struct VertexQuantizationReport
+{
+    uint32_t m_vertexCount = 0;
+    uint32_t m_indexCount = 0;
+
+    float m_maxPositionError = 0.f;  // mesh units
+    float m_avgPositionError = 0.f;
+    float m_maxNormalErrorDegrees = 0.f;
+    float m_maxTangentErrorDegrees = 0.f;
+    float m_maxBitangentErrorDegrees = 0.f;   // includes the source TBN not being orthogonal
+    float m_maxUVError = 0.f;
+    uint32_t m_colorMismatches = 0;
+
+    size_t m_originalVertexBytes = 0;
+    size_t m_packedVertexBytes = 0;
+    size_t m_originalIndexBytes = 0;
+    size_t m_packedIndexBytes = 0;
+
+    size_t GetOriginalBytes() const { return m_originalVertexBytes + m_originalIndexBytes; }
+    size_t GetPackedBytes() const { return m_packedVertexBytes + m_packedIndexBytes; }
+    float GetCompressionRatio() const { return GetPackedBytes() ? (float)GetOriginalBytes() / (float)GetPackedBytes() : 0.f; }
+};
+
+struct PackedMeshData
+{
+    VertexQuantization m_quantization;
+    std::vector<Vertex_PCUTBNPacked> m_verts;
+    std::vector<uint16_t> m_indices16;
+    bool m_uses16BitIndices = false;     // false: keep the caller's 32-bit indices
+    VertexQuantizationReport m_report;
+};
+
+//-----------------------------------------------------------------------------------------------
+VertexQuantization ComputeVertexQuantization(Vertex_PCUTBN const* verts, size_t count);
+
+// 4 verts per SSE2 iteration; the tail is padded to a full block
+void EncodePackedVertices(Vertex_PCUTBN const* verts, size_t count, VertexQuantization const& quantization, Vertex_PCUTBNPacked* out);
+void DecodePackedVertices(Vertex_PCUTBNPacked const* verts, size_t count, VertexQuantization const& quantization, Vertex_PCUTBN* out);
+
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t half);
+
+bool CanUse16BitIndices(std::vector<unsigned int> const& indices);
+bool NarrowIndicesTo16(std::vector<unsigned int> const& indices, std::vector<uint16_t>& out);
+
+VertexQuantizationReport MeasureQuantizationError(std::vector<Vertex_PCUTBN> const& original, std::vector<Vertex_PCUTBNPacked> const& packed, VertexQuantization const& quantization);
+
+// Quantize + encode + narrow indices + measure
+void PackStaticMeshVertices(std::vector<Vertex_PCUTBN> const& verts, std::vector<unsigned int> const& indices, PackedMeshData& out);
@@ -7,8 +7,10 @@
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Math/Mat44.hpp"
 #include "Engine/Math/FloatRange.hpp"
+#include "Engine/Core/TangentSpace.h"
 
 #include <math.h> 
+#include <cfloat>
 #include <vector>
 
 const float PIE = 3.14159265358979323846f;
@@ -1025,59 +1027,7 @@ void AddVertsForIndexAABBZWireframe3D(std::vector<Vertex_PCU>& verts, std::vecto
 
 void CalculateTangentAndBiTangent(std::vector<Vertex_PCUTBN>& vertices, const std::vector<unsigned int>& indices)
 {
-	std::vector<Vec3> tempTangents(vertices.size(), Vec3());
-	std::vector<Vec3> tempBitangents(vertices.size(), Vec3());
-
-	for (int i = 0; i < (int)indices.size(); i += 3)
-	{
-		unsigned int i0 = indices[i];
-		unsigned int i1 = indices[i + 1];
-		unsigned int i2 = indices[i + 2];
-
-		Vec3 p0 = vertices[i0].m_position;
-		Vec3 p1 = vertices[i1].m_position;
-		Vec3 p2 = vertices[i2].m_position;
-
-		Vec2 w0 = vertices[i0].m_uvTexCoords;
-		Vec2 w1 = vertices[i1].m_uvTexCoords;
-		Vec2 w2 = vertices[i2].m_uvTexCoords;
-
-		Vec3 e1 = p1 - p0;
-		Vec3 e2 = p2 - p0;
-		float x1 = w1.x - w0.x;
-		float x2 = w2.x - w0.x;
-		float y1 = w1.y - w0.y;
-		float y2 = w2.y - w0.y;
-
-		float denom = (x1 * y2 - x2 * y1);
-		if (denom == 0.f) continue;
-
-		float r = 1.f / denom;
-
-		Vec3 t = (e1 * y2 - e2 * y1) * r;
-		Vec3 b = (e2 * x1 - e1 * x2) * r;
-
-		tempTangents[i0] += t;
-		tempTangents[i1] += t;
-		tempTangents[i2] += t;
-
-		tempBitangents[i0] += b;
-		tempBitangents[i1] += b;
-		tempBitangents[i2] += b;
-	}
-
-	for (int i = 0; i < (int)vertices.size(); ++i)
-	{
-		Vec3 t = tempTangents[i];
-		Vec3 b = tempBitangents[i];
-		Vec3 n = vertices[i].m_normal;
-
-		t = (t - n * DotProduct3D(n, t)).GetNormalized();
-		b = (b - t * DotProduct3D(t, b) - n * DotProduct3D(n, b)).GetNormalized();
-
-		vertices[i].m_tangent = t;
-		vertices[i].m_bitangent = b;
-	}
+	GenerateTangentFrames(vertices, indices);
 }
 
 void AddVertsForRoundedQuad3D(std::vector<Vertex_PCUTBN>& vertexes, const Vec3& topLeft, const Vec3& bottomLeft,
@@ -0,0 +1,77 @@
+#include "VirtualFileSystem.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+
+#include <atomic>
+#include <mutex>
+
+namespace
+{
+    std::mutex s_mountMutex;
+    std::vector<std::shared_ptr<AssetPack const>> s_mountedPacks;     // oldest first
+    std::atomic<uint32_t> s_mountedPackCount{ 0 };                     // 没挂 pack 时不用加锁
+}
+
+bool MountAssetPack(std::string const& packPath)
+{
+    std::shared_ptr<AssetPack> pack = std::make_shared<AssetPack>();
+    if (!pack->Open(packPath))
+    {
+        DebuggerPrintf("[VFS] %s is not a valid asset pack, not mounted\n", packPath.c_str());
+        return false;
+    }
+    DebuggerPrintf("[VFS] Mounted %s: %u files, %.1f MB\n", packPath.c_str(), pack->GetEntryCount(), (double)pack->GetFileSize() / (1024.0 * 1024.0));
+
+    std::lock_guard<std::mutex> lock(s_mountMutex);
+    s_mountedPacks.push_back(std::move(pack));
+    s_mountedPackCount = (uint32_t)s_mountedPacks.size();
+    return true;
+}
+
+void UnmountAllAssetPacks()
+{
+    std::lock_guard<std::mutex> lock(s_mountMutex);
+    s_mountedPacks.clear();
+    s_mountedPackCount = 0;
+}
+
+uint32_t GetMountedAssetPackCount()
+{
+    return s_mountedPackCount;
+}
+
+AssetPackEntry const* FindMountedFile(std::string const& path, std::shared_ptr<AssetPack const>& outPack)
+{
+    outPack.reset();
+    if (s_mountedPackCount == 0)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(s_mountMutex);
+    for (auto pack = s_mountedPacks.rbegin(); pack != s_mountedPacks.rend(); ++pack)
+    {
+        AssetPackEntry const* entry = (*pack)->FindEntry(path);
+        if (entry)
+        {
+            outPack = *pack;
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+bool ReadMountedFile(std::string const& path, std::vector<uint8_t>& outBytes)
+{
+    std::shared_ptr<AssetPack const> pack;
+    AssetPackEntry const* entry = FindMountedFile(path, pack);
+    if (!entry)
+        return false;
+
+    std::vector<uint8_t> bytes;
+    if (!pack->ReadEntry(*entry, bytes))
+    {
+        DebuggerPrintf("[VFS] %s: %s is corrupt in the pack, reading the loose file\n", pack->GetPath().c_str(), path.c_str());
+        return false;
+    }
+    outBytes = std::move(bytes);
+    return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "Engine/Core/AssetPack.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+//==============================================================================
+// VirtualFileSystem - 读文件的统一入口：先找挂上的 pack，没有再读散文件
+//==============================================================================
+// FileReadToBuffer / FileReadToString, MappedFile::Open (cooked meshes and mips, source keys),
+// Image, LoadXmlFile and the glTF loaders all resolve paths here, so the game keeps opening
+// "Data/..." paths and the same code runs on loose files and packs. Mount at startup, before
+// anything loads:
+//     MountAssetPack("Data.pack");
+// Packs mounted later are searched first (a patch pack shadows the base one). Nothing is
+// written through the VFS: cooks and saves still go to loose files, and a loose file only wins
+// when no mounted pack has the path. Mount / unmount and lookups are thread safe; an entry in
+// use (MappedFile) keeps its pack alive after an unmount.
+//==============================================================================
+
+// false if packPath is not a valid pack
+bool MountAssetPack(std::string const& packPath);
+void UnmountAllAssetPacks();
+uint32_t GetMountedAssetPackCount();
+
+// entry of the newest mounted pack with this path, and that pack; nullptr if none has it
+AssetPackEntry const* FindMountedFile(std::string const& path, std::shared_ptr<AssetPack const>& outPack);
+
+// copies / decompresses a packed file; false (outBytes untouched) if no mounted pack has it or
+// the entry is corrupt, and the caller reads the loose file
+bool ReadMountedFile(std::string const& path, std::vector<uint8_t>& outBytes);
@@ -1,5 +1,6 @@
 #include "XmlUtils.hpp"
 #include "Engine/Renderer/SpriteAnimDefinition.hpp"
+#include "Engine/Core/FileUtils.hpp"
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Math/IntVec2.hpp"
@@ -9,6 +10,16 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/FloatRange.hpp"
 
+XmlResult LoadXmlFile(XmlDocument& document, std::string const& filePath)
+{
+	std::vector<uint8_t> fileBytes;
+	if (FileReadToBuffer(fileBytes, filePath) < 0)
+	{
+		return XmlResult::XML_ERROR_FILE_NOT_FOUND;
+	}
+	return document.Parse((char const*)fileBytes.data(), fileBytes.size());
+}
+
 int ParseXmlAttribute(XmlElement const& element, char const* attributeName, int defaultValue)
 {
 	const char* attr = element.Attribute(attributeName);
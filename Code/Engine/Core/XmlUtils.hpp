@@ -24,6 +24,9 @@ typedef tinyxml2::XMLElement XmlElement;
 typedef tinyxml2::XMLAttribute XmlAttribute;
 typedef tinyxml2::XMLError XmlResult;
 
+// XmlDocument::LoadFile 只读散文件；这个走 FileReadToBuffer，挂了 asset pack 也能读
+XmlResult LoadXmlFile(XmlDocument& document, std::string const& filePath);
+
 int ParseXmlAttribute(XmlElement const& element, char const* attributeName, int defaultValue);
 char ParseXmlAttribute(XmlElement const& element, char const* attributeName, char defaultValue);
 bool ParseXmlAttribute(XmlElement const& element, char const* attributeName, bool defaultValue);
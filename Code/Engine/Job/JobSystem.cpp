@@ -1,11 +1,26 @@
 ﻿#include "JobSystem.h"
 #include "Engine/Core/EngineCommon.hpp"
 
+#include <algorithm>
+
 Job::Job(uint32_t jobType)
     : m_jobType(jobType)
 {
 }
 
+RangeJob::RangeJob(JobRangeFunction const* work, uint32_t begin, uint32_t end)
+    : Job(JOB_TYPE_WORKER)
+    , m_work(work)
+    , m_begin(begin)
+    , m_end(end)
+{
+}
+
+void RangeJob::Execute()
+{
+    (*m_work)(m_begin, m_end);
+}
+
 JobWorkerThread::JobWorkerThread(int id, uint32_t type, JobSystem* system)
 : m_threadID(id), m_workerType(type), m_jobSystem(system)
 {
@@ -87,6 +102,8 @@ void JobWorkerThread::ThreadMain()
         {
         }
 
+        // 被等待的 job 一旦标记完成就可能被等待方删除，先记下来
+        bool isAwaited = job->m_isAwaited;
         {
             std::lock_guard<std::mutex> lk(m_jobSystem->m_jobQueueMutex);
             auto it = std::find(m_jobSystem->m_executingJobs.begin(),
@@ -94,10 +111,22 @@ void JobWorkerThread::ThreadMain()
             if (it != m_jobSystem->m_executingJobs.end())
             {
                 m_jobSystem->m_executingJobs.erase(it);
-                m_jobSystem->m_completedJobs.push_back(job);
+                if (job->m_isAwaited)
+                {
+                    job->m_isFinished = true;
+                }
+                else
+                {
+                    m_jobSystem->m_completedJobs.push_back(job);
+                }
             }
         }
 
+        if (isAwaited)
+        {
+            m_jobSystem->m_awaitedJobFinished.notify_all();
+        }
+
         // ✅ 唤醒其他可能在等待的线程（job完成可能解锁依赖）
         m_jobSystem->m_workAvailable.notify_all();
     }
@@ -176,15 +205,25 @@ void JobSystem::AddPendingJob(Job* job)
     std::scoped_lock lock(m_jobQueueMutex);
     m_pendingJobs.push_back(job);
 
-    m_workAvailable.notify_one();
+    // worker 和 IO 线程共用一个 condition variable，notify_one 可能叫醒干不了这个 job 的线程
+    m_workAvailable.notify_all();
 }
 
 std::vector<Job*> JobSystem::RetrieveCompletedJobs()
+{
+    return RetrieveCompletedJobs(nullptr);
+}
+
+std::vector<Job*> JobSystem::RetrieveCompletedJobs(void const* owner)
 {
     std::vector<Job*> result;
     
     std::lock_guard<std::mutex> lock(m_jobQueueMutex);
-    result.swap(m_completedJobs);  // 高效交换，避免复制
+    // 保持完成顺序，别的 owner 的 job 原地留下
+    auto ownedBegin = std::stable_partition(m_completedJobs.begin(), m_completedJobs.end(),
+        [owner](Job* job) { return job->m_owner != owner; });
+    result.assign(ownedBegin, m_completedJobs.end());
+    m_completedJobs.erase(ownedBegin, m_completedJobs.end());
     
     return result;
 }
@@ -193,27 +232,91 @@ Job* JobSystem::RetrieveOneCompletedJob()
 {
     std::lock_guard<std::mutex> lock(m_jobQueueMutex);
     
-    if (m_completedJobs.empty())
+    for (auto it = m_completedJobs.rbegin(); it != m_completedJobs.rend(); ++it)
     {
-        return nullptr;
+        if ((*it)->m_owner == nullptr)
+        {
+            Job* job = *it;
+            m_completedJobs.erase(std::next(it).base());
+            return job;
+        }
     }
+    return nullptr;
+}
+
+void JobSystem::WaitForJobs(std::vector<Job*> const& jobs)
+{
+    std::unique_lock<std::mutex> lock(m_jobQueueMutex);
     
-    Job* job = m_completedJobs.back();
-    m_completedJobs.pop_back();
-    return job;
+    while (true)
+    {
+        bool allFinished = true;
+        for (Job* job : jobs)
+        {
+            if (!job->m_isFinished)
+            {
+                allFinished = false;
+                break;
+            }
+        }
+        if (allFinished)
+            return;
+
+        // 与其空等，不如在当前线程上执行一个自己还没被领走的 job
+        Job* ownJob = nullptr;
+        for (auto it = m_pendingJobs.begin(); it != m_pendingJobs.end(); ++it)
+        {
+            if (std::find(jobs.begin(), jobs.end(), *it) != jobs.end())
+            {
+                ownJob = *it;
+                m_pendingJobs.erase(it);
+                break;
+            }
+        }
+
+        if (ownJob)
+        {
+            lock.unlock();
+            ownJob->Execute();
+            lock.lock();
+            ownJob->m_isFinished = true;
+            continue;
+        }
+
+        m_awaitedJobFinished.wait(lock);
+    }
 }
 
-void JobSystem::PrintDebugInfo()
+void ParallelFor(uint32_t count, uint32_t batchSize, JobRangeFunction const& work)
 {
-	//std::lock_guard<std::mutex> lock(m_jobQueueMutex);
-
-	g_theDevConsole->AddLine(Rgba8::WHITE,
-		Stringf("Threads: %d active", (int)m_workerThreads.size()));
-	g_theDevConsole->AddLine(Rgba8::YELLOW,
-		Stringf("Jobs - Pending: %d, Executing: %d, Completed: %d",
-			(int)m_pendingJobs.size(),
-			(int)m_executingJobs.size(),
-			(int)m_completedJobs.size()));
+    if (count == 0)
+        return;
+    if (batchSize == 0)
+        batchSize = 1;
+
+    if (!g_theJobSystem || g_theJobSystem->GetNumWorkerThreads() == 0 || count <= batchSize)
+    {
+        work(0, count);
+        return;
+    }
+
+    std::vector<Job*> jobs;
+    jobs.reserve((count + batchSize - 1) / batchSize);
+    for (uint32_t begin = 0; begin < count; begin += batchSize)
+    {
+        uint32_t end = (count - begin > batchSize) ? begin + batchSize : count;
+        RangeJob* job = new RangeJob(&work, begin, end);
+        job->m_isAwaited = true;
+        jobs.push_back(job);
+        g_theJobSystem->AddPendingJob(job);
+    }
+
+    g_theJobSystem->WaitForJobs(jobs);
+
+    for (Job* job : jobs)
+    {
+        delete job;
+    }
 }
 
 int JobSystem::GetPendingJobCount() const
@@ -245,6 +348,11 @@ int JobSystem::GetNumWorkerThreads() const
 	return m_numWorkerThreads;
 }
 
+int JobSystem::GetNumIOThreads() const
+{
+	return m_numIOThreads;
+}
+
 void JobSystem::SetQuitting(bool isQuitting)
 {
     m_isQuitting = isQuitting;
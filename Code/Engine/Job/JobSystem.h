@@ -1,6 +1,10 @@
 ﻿#pragma once
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <functional>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 enum JobType: uint32_t
@@ -25,6 +29,26 @@ public:
 
 public:
     uint32_t m_jobType = 0;  
+    bool m_isAwaited = false;   // WaitForJobs 的 job 完成后不进入 completed 列表
+    void const* m_owner = nullptr;  // 非空时只能用 RetrieveCompletedJobs(owner) 取回，别人拿不到
+    bool m_isFinished = false;
+};
+
+// Range Job ---------------------------------
+typedef std::function<void(uint32_t begin, uint32_t end)> JobRangeFunction;
+
+class RangeJob : public Job
+{
+public:
+    RangeJob(JobRangeFunction const* work, uint32_t begin, uint32_t end);
+
+    void Execute() override;
+    void OnComplete() override {}
+
+private:
+    JobRangeFunction const* m_work = nullptr; // owned by the blocking caller (ParallelFor)
+    uint32_t m_begin = 0;
+    uint32_t m_end = 0;
 };
 
 // Worker Thread ---------------------------------
@@ -67,8 +91,10 @@ public:
     void Shutdown();
     
     void AddPendingJob(Job* job);
-    std::vector<Job*> RetrieveCompletedJobs();
-    Job* RetrieveOneCompletedJob();
+    std::vector<Job*> RetrieveCompletedJobs();                  // jobs without an owner only
+    std::vector<Job*> RetrieveCompletedJobs(void const* owner); // completed jobs whose m_owner is owner
+    Job* RetrieveOneCompletedJob();                             // jobs without an owner only
+    void WaitForJobs(std::vector<Job*> const& jobs); // jobs must be added with m_isAwaited; caller keeps ownership
 
     void PrintDebugInfo();
 
@@ -77,6 +103,7 @@ public:
     int GetCompletedJobCount() const;
     int GetPendingAndExecutingJobCount() const;
     int GetNumWorkerThreads() const;
+    int GetNumIOThreads() const;
 
     void SetQuitting(bool isQuitting);
     bool IsQuitting() const;
@@ -92,9 +119,14 @@ private:
     
     mutable std::mutex m_jobQueueMutex;
     std::condition_variable m_workAvailable;
+    std::condition_variable m_awaitedJobFinished;
     
     std::vector<JobWorkerThread*> m_workerThreads;
     std::atomic<bool> m_isQuitting{false};
 };
 
-extern JobSystem* g_theJobSystem;
\ No newline at end of file
+extern JobSystem* g_theJobSystem;
+
+// Splits [0, count) into batches of batchSize and runs them on the worker threads, blocking until done.
+// The calling thread also executes batches, so this works with zero workers (or no job system at all).
+void ParallelFor(uint32_t count, uint32_t batchSize, JobRangeFunction const& work);
\ No newline at end of file
@@ -0,0 +1,17 @@
+﻿#include "JobSystem.h"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+
+// 单独一个文件：JobSystem.cpp 本身不依赖 DevConsole，IglooCook 这种没有 console 的工具也能链接
+void JobSystem::PrintDebugInfo()
+{
+	//std::lock_guard<std::mutex> lock(m_jobQueueMutex);
+
+	g_theDevConsole->AddLine(Rgba8::WHITE,
+		Stringf("Threads: %d active", (int)m_workerThreads.size()));
+	g_theDevConsole->AddLine(Rgba8::YELLOW,
+		Stringf("Jobs - Pending: %d, Executing: %d, Completed: %d",
+			(int)m_pendingJobs.size(),
+			(int)m_executingJobs.size(),
+			(int)m_completedJobs.size()));
+}
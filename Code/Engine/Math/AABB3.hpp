@@ -12,6 +12,7 @@ public:
 	AABB3() {}
 	~AABB3() {}
 	AABB3(AABB3 const& copyFrom); //copy constructor(from another Vec2
+	AABB3& operator=(AABB3 const& copyFrom) = default;
 	explicit AABB3(float minX, float minY, float minZ, float maxX, float maxY, float maxZ);
 	explicit AABB3(Vec3 const& mins, Vec3 const& maxs);
 
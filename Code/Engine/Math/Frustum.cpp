@@ -3,6 +3,8 @@
 #include "MathUtils.hpp"
 #include "Engine/Renderer/Camera.hpp"
 
+#include <cmath>
+
 Frustum::Frustum(Plane3 const& left, Plane3 const& right, Plane3 const& bottom, Plane3 const& top, Plane3 const& nearP, Plane3 const& farP, Camera* const& camera)
 {
 	m_planes[Left] = left;
@@ -1,6 +1,6 @@
 ﻿#include "IntVec3.h"
 
-#include <corecrt_math.h>
+#include <cmath>
 
 const IntVec3 IntVec3::ZERO = IntVec3(0,0,0);
 const IntVec3 IntVec3::NEGATIVEONE = IntVec3(-1, -1, -1);
@@ -10,6 +10,7 @@
 #include "Engine/Math/AABB3.hpp"
 
 #include <math.h>
+#include <cfloat>
 #include <cmath>
 #include <iomanip>
 #include <sstream>
@@ -12,5 +12,6 @@ public:
     ~Sphere();
 
     Sphere(Sphere const& copyFrom);
+    Sphere& operator=(Sphere const& copyFrom) = default;
     explicit Sphere(Vec3 const& center, float radius);
 };
@@ -0,0 +1,396 @@
+﻿#include "SphericalHarmonics.h"
+
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <xmmintrin.h>
+#include <cmath>
+
+constexpr float SH_PI = 3.1415926535897932384626433832795f;
+
+// Basis normalization constants
+constexpr float SH_Y00 = 0.282094792f;  // 1 / (2 sqrt(PI))
+constexpr float SH_Y1 = 0.488602512f;   // sqrt(3 / (4 PI))
+constexpr float SH_Y2_A = 1.092548431f; // sqrt(15 / (4 PI))
+constexpr float SH_Y2_B = 0.315391565f; // sqrt(5 / (16 PI))
+constexpr float SH_Y2_C = 0.546274215f; // sqrt(15 / (16 PI))
+
+// Clamped-cosine lobe convolution per band (Ramamoorthi & Hanrahan): PI, 2PI/3, PI/4
+static float const s_cosineLobe[SH9_COEFFICIENT_COUNT] =
+{
+    SH_PI,
+    2.f * SH_PI / 3.f, 2.f * SH_PI / 3.f, 2.f * SH_PI / 3.f,
+    SH_PI * 0.25f, SH_PI * 0.25f, SH_PI * 0.25f, SH_PI * 0.25f, SH_PI * 0.25f
+};
+
+//-----------------------------------------------------------------------------------------------
+void SH9Color::SetZero()
+{
+    for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+    {
+        _mm_store_ps(m_coeffs[c], _mm_setzero_ps());
+    }
+}
+
+void SH9Color::SetFromChannels(float const* r, float const* g, float const* b)
+{
+    for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+    {
+        m_coeffs[c][0] = r[c];
+        m_coeffs[c][1] = g[c];
+        m_coeffs[c][2] = b[c];
+        m_coeffs[c][3] = 0.f;
+    }
+}
+
+void SH9Color::GetChannels(float* outR, float* outG, float* outB) const
+{
+    for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+    {
+        outR[c] = m_coeffs[c][0];
+        outG[c] = m_coeffs[c][1];
+        outB[c] = m_coeffs[c][2];
+    }
+}
+
+void SH9ColorX4::Pack(SH9Color const* const probes[4])
+{
+    for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+    {
+        for (int channel = 0; channel < 3; channel++)
+        {
+            for (int lane = 0; lane < 4; lane++)
+            {
+                m_coeffs[c][channel][lane] = probes[lane] ? probes[lane]->m_coeffs[c][channel] : 0.f;
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+void EvaluateSH9Basis(Vec3 const& direction, float* outBasis)
+{
+    float x = direction.x;
+    float y = direction.y;
+    float z = direction.z;
+
+    outBasis[0] = SH_Y00;
+    outBasis[1] = SH_Y1 * y;
+    outBasis[2] = SH_Y1 * z;
+    outBasis[3] = SH_Y1 * x;
+    outBasis[4] = SH_Y2_A * x * y;
+    outBasis[5] = SH_Y2_A * y * z;
+    outBasis[6] = SH_Y2_B * (3.f * z * z - 1.f);
+    outBasis[7] = SH_Y2_A * x * z;
+    outBasis[8] = SH_Y2_C * (x * x - y * y);
+}
+
+static inline __m128 LoadRGB(Vec3 const& v)
+{
+    return _mm_set_ps(0.f, v.z, v.y, v.x);
+}
+
+static inline Vec3 StoreRGB(__m128 v)
+{
+    alignas(16) float out[4];
+    _mm_store_ps(out, v);
+    return Vec3(out[0], out[1], out[2]);
+}
+
+//-----------------------------------------------------------------------------------------------
+void AddSH9Sample(SH9Color& sh, Vec3 const& direction, Vec3 const& radiance, float weight)
+{
+    float basis[SH9_COEFFICIENT_COUNT];
+    EvaluateSH9Basis(direction, basis);
+
+    __m128 weightedRadiance = _mm_mul_ps(LoadRGB(radiance), _mm_set1_ps(weight));
+    for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+    {
+        __m128 coeff = _mm_load_ps(sh.m_coeffs[c]);
+        coeff = _mm_add_ps(coeff, _mm_mul_ps(weightedRadiance, _mm_set1_ps(basis[c])));
+        _mm_store_ps(sh.m_coeffs[c], coeff);
+    }
+}
+
+SH9Color ProjectSH9(Vec3 const* directions, Vec3 const* radiance, int sampleCount)
+{
+    SH9Color sh;
+    if (sampleCount <= 0)
+        return sh;
+
+    // Keep the running sums in registers; the Monte Carlo weight is applied once at the end
+    __m128 acc[SH9_COEFFICIENT_COUNT];
+    for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+    {
+        acc[c] = _mm_setzero_ps();
+    }
+
+    float basis[SH9_COEFFICIENT_COUNT];
+    for (int i = 0; i < sampleCount; i++)
+    {
+        EvaluateSH9Basis(directions[i], basis);
+        __m128 rgb = LoadRGB(radiance[i]);
+        for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+        {
+            acc[c] = _mm_add_ps(acc[c], _mm_mul_ps(rgb, _mm_set1_ps(basis[c])));
+        }
+    }
+
+    __m128 weight = _mm_set1_ps(4.f * SH_PI / (float)sampleCount);
+    for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+    {
+        _mm_store_ps(sh.m_coeffs[c], _mm_mul_ps(acc[c], weight));
+    }
+    return sh;
+}
+
+//-----------------------------------------------------------------------------------------------
+void ConvolveSH9CosineLobe(SH9Color& sh)
+{
+    for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+    {
+        _mm_store_ps(sh.m_coeffs[c], _mm_mul_ps(_mm_load_ps(sh.m_coeffs[c]), _mm_set1_ps(s_cosineLobe[c])));
+    }
+}
+
+Vec3 EvaluateSH9(SH9Color const& sh, Vec3 const& direction)
+{
+    float basis[SH9_COEFFICIENT_COUNT];
+    EvaluateSH9Basis(direction, basis);
+
+    __m128 acc = _mm_setzero_ps();
+    for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+    {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_load_ps(sh.m_coeffs[c]), _mm_set1_ps(basis[c])));
+    }
+    return StoreRGB(acc);
+}
+
+Vec3 EvaluateSH9Irradiance(SH9Color const& radianceSH, Vec3 const& normal)
+{
+    float basis[SH9_COEFFICIENT_COUNT];
+    EvaluateSH9Basis(normal, basis);
+
+    __m128 acc = _mm_setzero_ps();
+    for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+    {
+        __m128 scale = _mm_set1_ps(basis[c] * s_cosineLobe[c]);
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_load_ps(radianceSH.m_coeffs[c]), scale));
+    }
+    return StoreRGB(acc);
+}
+
+void EvaluateSH9IrradianceX4(SH9ColorX4 const& radianceSH, Vec3 const* normals, Vec3* outIrradiance)
+{
+    __m128 x = _mm_set_ps(normals[3].x, normals[2].x, normals[1].x, normals[0].x);
+    __m128 y = _mm_set_ps(normals[3].y, normals[2].y, normals[1].y, normals[0].y);
+    __m128 z = _mm_set_ps(normals[3].z, normals[2].z, normals[1].z, normals[0].z);
+
+    // Basis for all four normals at once, with the cosine lobe folded in
+    __m128 basis[SH9_COEFFICIENT_COUNT];
+    basis[0] = _mm_set1_ps(SH_Y00 * s_cosineLobe[0]);
+    __m128 band1 = _mm_set1_ps(SH_Y1 * s_cosineLobe[1]);
+    basis[1] = _mm_mul_ps(band1, y);
+    basis[2] = _mm_mul_ps(band1, z);
+    basis[3] = _mm_mul_ps(band1, x);
+    __m128 band2A = _mm_set1_ps(SH_Y2_A * s_cosineLobe[4]);
+    basis[4] = _mm_mul_ps(band2A, _mm_mul_ps(x, y));
+    basis[5] = _mm_mul_ps(band2A, _mm_mul_ps(y, z));
+    basis[6] = _mm_mul_ps(_mm_set1_ps(SH_Y2_B * s_cosineLobe[6]),
+        _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(3.f), _mm_mul_ps(z, z)), _mm_set1_ps(1.f)));
+    basis[7] = _mm_mul_ps(band2A, _mm_mul_ps(x, z));
+    basis[8] = _mm_mul_ps(_mm_set1_ps(SH_Y2_C * s_cosineLobe[8]), _mm_sub_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+
+    __m128 rgb[3];
+    for (int channel = 0; channel < 3; channel++)
+    {
+        __m128 acc = _mm_setzero_ps();
+        for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+        {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_load_ps(radianceSH.m_coeffs[c][channel]), basis[c]));
+        }
+        rgb[channel] = acc;
+    }
+
+    alignas(16) float r[4];
+    alignas(16) float g[4];
+    alignas(16) float b[4];
+    _mm_store_ps(r, rgb[0]);
+    _mm_store_ps(g, rgb[1]);
+    _mm_store_ps(b, rgb[2]);
+    for (int lane = 0; lane < 4; lane++)
+    {
+        outIrradiance[lane] = Vec3(r[lane], g[lane], b[lane]);
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// Band 2 rotation: sample the band at five fixed directions N_i, rotate those directions and
+// re-project. c' = A^-1 * B * c, where A_im = Y2m(N_i) and B_im = Y2m(R^T N_i).
+struct SH9Band2RotationTable
+{
+    Vec3 m_directions[5];
+    float m_inverseA[5][5];
+
+    SH9Band2RotationTable()
+    {
+        float const k = 0.707106781f;
+        m_directions[0] = Vec3(1.f, 0.f, 0.f);
+        m_directions[1] = Vec3(0.f, 0.f, 1.f);
+        m_directions[2] = Vec3(k, k, 0.f);
+        m_directions[3] = Vec3(k, 0.f, k);
+        m_directions[4] = Vec3(0.f, k, k);
+
+        double a[5][10];
+        for (int i = 0; i < 5; i++)
+        {
+            float basis[SH9_COEFFICIENT_COUNT];
+            EvaluateSH9Basis(m_directions[i], basis);
+            for (int m = 0; m < 5; m++)
+            {
+                a[i][m] = basis[4 + m];
+                a[i][5 + m] = (i == m) ? 1.0 : 0.0;
+            }
+        }
+
+        // Gauss-Jordan with partial pivoting on [A | I]
+        for (int col = 0; col < 5; col++)
+        {
+            int pivot = col;
+            for (int row = col + 1; row < 5; row++)
+            {
+                if (fabs(a[row][col]) > fabs(a[pivot][col]))
+                    pivot = row;
+            }
+            for (int k2 = 0; k2 < 10; k2++)
+            {
+                double temp = a[col][k2];
+                a[col][k2] = a[pivot][k2];
+                a[pivot][k2] = temp;
+            }
+
+            double invPivot = 1.0 / a[col][col];
+            for (int k2 = 0; k2 < 10; k2++)
+            {
+                a[col][k2] *= invPivot;
+            }
+            for (int row = 0; row < 5; row++)
+            {
+                if (row == col)
+                    continue;
+                double factor = a[row][col];
+                for (int k2 = 0; k2 < 10; k2++)
+                {
+                    a[row][k2] -= factor * a[col][k2];
+                }
+            }
+        }
+
+        for (int i = 0; i < 5; i++)
+        {
+            for (int j = 0; j < 5; j++)
+            {
+                m_inverseA[i][j] = (float)a[i][5 + j];
+            }
+        }
+    }
+};
+
+static SH9Band2RotationTable const& GetBand2RotationTable()
+{
+    static SH9Band2RotationTable const s_table;
+    return s_table;
+}
+
+SH9Color RotateSH9(SH9Color const& sh, Mat44 const& rotation)
+{
+    Vec3 i = rotation.GetIBasis3D();
+    Vec3 j = rotation.GetJBasis3D();
+    Vec3 k = rotation.GetKBasis3D();
+
+    SH9Color result;
+    _mm_store_ps(result.m_coeffs[0], _mm_load_ps(sh.m_coeffs[0]));
+
+    // Band 1 is a vector (x, y, z) = (c11, c1-1, c10): v' = R v
+    __m128 vx = _mm_load_ps(sh.m_coeffs[3]);
+    __m128 vy = _mm_load_ps(sh.m_coeffs[1]);
+    __m128 vz = _mm_load_ps(sh.m_coeffs[2]);
+    __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(i.x)), _mm_mul_ps(vy, _mm_set1_ps(j.x))), _mm_mul_ps(vz, _mm_set1_ps(k.x)));
+    __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(i.y)), _mm_mul_ps(vy, _mm_set1_ps(j.y))), _mm_mul_ps(vz, _mm_set1_ps(k.y)));
+    __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(i.z)), _mm_mul_ps(vy, _mm_set1_ps(j.z))), _mm_mul_ps(vz, _mm_set1_ps(k.z)));
+    _mm_store_ps(result.m_coeffs[1], ry);
+    _mm_store_ps(result.m_coeffs[2], rz);
+    _mm_store_ps(result.m_coeffs[3], rx);
+
+    // Band 2
+    SH9Band2RotationTable const& table = GetBand2RotationTable();
+    float b[5][5];
+    for (int n = 0; n < 5; n++)
+    {
+        Vec3 const& dir = table.m_directions[n];
+        Vec3 rotatedDir(DotProduct3D(i, dir), DotProduct3D(j, dir), DotProduct3D(k, dir)); // R^T * N
+        float basis[SH9_COEFFICIENT_COUNT];
+        EvaluateSH9Basis(rotatedDir, basis);
+        for (int m = 0; m < 5; m++)
+        {
+            b[n][m] = basis[4 + m];
+        }
+    }
+
+    for (int row = 0; row < 5; row++)
+    {
+        float rowM[5] = {};
+        for (int n = 0; n < 5; n++)
+        {
+            for (int m = 0; m < 5; m++)
+            {
+                rowM[m] += table.m_inverseA[row][n] * b[n][m];
+            }
+        }
+
+        __m128 acc = _mm_setzero_ps();
+        for (int m = 0; m < 5; m++)
+        {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_load_ps(sh.m_coeffs[4 + m]), _mm_set1_ps(rowM[m])));
+        }
+        _mm_store_ps(result.m_coeffs[4 + row], acc);
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+void BlendSH9(SH9Color const* probes, float const* weights, int count, SH9Color& out)
+{
+    float totalWeight = 0.f;
+    for (int p = 0; p < count; p++)
+    {
+        totalWeight += weights[p];
+    }
+    if (totalWeight <= 0.f)
+    {
+        out.SetZero();
+        return;
+    }
+
+    __m128 acc[SH9_COEFFICIENT_COUNT];
+    for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+    {
+        acc[c] = _mm_setzero_ps();
+    }
+
+    for (int p = 0; p < count; p++)
+    {
+        __m128 w = _mm_set1_ps(weights[p]);
+        for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+        {
+            acc[c] = _mm_add_ps(acc[c], _mm_mul_ps(_mm_load_ps(probes[p].m_coeffs[c]), w));
+        }
+    }
+
+    __m128 invTotal = _mm_set1_ps(1.f / totalWeight);
+    for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+    {
+        _mm_store_ps(out.m_coeffs[c], _mm_mul_ps(acc[c], invTotal));
+    }
+}
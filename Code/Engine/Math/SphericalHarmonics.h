@@ -0,0 +1,51 @@
+﻿#pragma once
+#include "Vec3.hpp"
+
+#include <cstdint>
+
+struct Mat44;
+
+// Order-2 real spherical harmonics (bands 0..2, 9 coefficients), same ordering as
+// RadianceProbeGPU::SH_R/G/B: Y00, Y1-1, Y10, Y11, Y2-2, Y2-1, Y20, Y21, Y22
+constexpr int SH9_COEFFICIENT_COUNT = 9;
+
+// RGB SH, one 16-byte row per coefficient (r, g, b, unused) so every coefficient is a single SSE register
+struct alignas(16) SH9Color
+{
+public:
+    float m_coeffs[SH9_COEFFICIENT_COUNT][4] = {};
+
+public:
+    void SetZero();
+    void SetFromChannels(float const* r, float const* g, float const* b);
+    void GetChannels(float* outR, float* outG, float* outB) const;
+};
+
+// Four probes in SoA layout: lane i of m_coeffs[c][channel] belongs to probe i
+struct alignas(16) SH9ColorX4
+{
+public:
+    float m_coeffs[SH9_COEFFICIENT_COUNT][3][4] = {};
+
+public:
+    void Pack(SH9Color const* const probes[4]); // nullptr lanes are zero
+};
+
+//Basis
+void EvaluateSH9Basis(Vec3 const& direction, float* outBasis); // direction must be normalized
+
+//Projection (radiance samples -> SH)
+void AddSH9Sample(SH9Color& sh, Vec3 const& direction, Vec3 const& radiance, float weight);
+SH9Color ProjectSH9(Vec3 const* directions, Vec3 const* radiance, int sampleCount); // uniform sphere samples, weight 4PI/N
+
+//Convolution & evaluation
+void ConvolveSH9CosineLobe(SH9Color& sh); // radiance SH -> irradiance SH
+Vec3 EvaluateSH9(SH9Color const& sh, Vec3 const& direction);
+Vec3 EvaluateSH9Irradiance(SH9Color const& radianceSH, Vec3 const& normal);
+void EvaluateSH9IrradianceX4(SH9ColorX4 const& radianceSH, Vec3 const* normals, Vec3* outIrradiance); // 4 probes, 4 normals
+
+//Rotation
+SH9Color RotateSH9(SH9Color const& sh, Mat44 const& rotation); // rotates the lighting environment by rotation's IJK basis
+
+//Blending
+void BlendSH9(SH9Color const* probes, float const* weights, int count, SH9Color& out); // weights are normalized internally
@@ -0,0 +1,78 @@
+﻿#include "CardResolutionLOD.h"
+
+#include "Engine/Math/MathUtils.hpp"
+
+#include <cmath>
+
+CardResolutionLOD::CardResolutionLOD(CardLODConfig const& config)
+    : m_config(config)
+{
+}
+
+float CardResolutionLOD::ComputeProjectedSize(CardLODView const& view, Vec3 const& center, Vec2 const& worldSize)
+{
+    float extent = MaxF(worldSize.x, worldSize.y);
+
+    // 用包围球的近端距离，相机贴着大卡片时不会低估
+    float halfDiagonal = 0.5f * sqrtf(worldSize.x * worldSize.x + worldSize.y * worldSize.y);
+    float distance = MaxF(GetDistance3D(view.m_cameraPosition, center) - halfDiagonal, 0.1f);
+
+    return extent * view.m_projectionScale * view.m_screenHeight * 0.5f / distance;
+}
+
+IntVec2 CardResolutionLOD::GetTierResolution(int tier) const
+{
+    tier = GetClampedInt(tier, 0, m_config.m_tierCount - 1);
+    int resolution = (int)m_config.m_tileSize << tier;
+    return IntVec2(resolution, resolution);
+}
+
+int CardResolutionLOD::GetMaxTierForResolution(IntVec2 const& recommendedResolution) const
+{
+    int target = MaxI(recommendedResolution.x, recommendedResolution.y);
+    int tier = 0;
+    while (tier < m_config.m_tierCount - 1 && GetTierResolution(tier).x < target)
+    {
+        tier++;
+    }
+    return tier;
+}
+
+int CardResolutionLOD::GetIdealTier(float projectedPixels, int maxTier) const
+{
+    float desired = projectedPixels * m_config.m_texelsPerScreenPixel;
+    int tier = 0;
+    while (tier < maxTier && (float)GetTierResolution(tier).x < desired)
+    {
+        tier++;
+    }
+    return tier;
+}
+
+int CardResolutionLOD::SelectTier(float projectedPixels, int currentTier, int maxTier, uint32_t framesSinceChange) const
+{
+    if (currentTier < 0 || currentTier == CARD_LOD_TIER_NONE)
+        return GetIdealTier(projectedPixels, maxTier);
+
+    if (currentTier > maxTier)
+        return maxTier;
+
+    int ideal = GetIdealTier(projectedPixels, maxTier);
+    if (ideal == currentTier || framesSinceChange < m_config.m_minFramesBetweenChanges)
+        return currentTier;
+
+    float desired = projectedPixels * m_config.m_texelsPerScreenPixel;
+    if (ideal > currentTier)
+    {
+        // 升档: 必须明显超过当前档位
+        float upperEdge = (float)GetTierResolution(currentTier).x * (1.f + m_config.m_hysteresis);
+        return (desired > upperEdge) ? ideal : currentTier;
+    }
+
+    // 降档: 必须明显低于下一档，落点也按带宽放大，避免刚降完又升回来
+    float lowerEdge = (float)GetTierResolution(currentTier - 1).x * (1.f - m_config.m_hysteresis);
+    if (desired >= lowerEdge)
+        return currentTier;
+
+    return MinI(GetIdealTier(projectedPixels * (1.f + m_config.m_hysteresis), maxTier), currentTier - 1);
+}
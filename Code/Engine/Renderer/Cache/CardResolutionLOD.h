@@ -0,0 +1,57 @@
+﻿#pragma once
+#include <cstdint>
+
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+// ========================================
+// Card 分辨率 LOD
+// ========================================
+// Per-instance card resolution picked from projected screen size instead of mesh size alone.
+// Tier i is (tileSize << i) pixels per side, so every tier maps onto whole atlas tiles.
+// The template's recommended resolution is only an upper bound (no point capturing a
+// 1m crate at 512 even when the camera is touching it).
+// Scene::UpdateCardResolutionLOD skips evicted cards (SurfaceCard::m_evicted), so LOD never
+// undoes an eviction; frame counts are Scene::GetCurrentFrame.
+static constexpr uint8_t CARD_LOD_TIER_NONE = 0xFF;
+
+struct CardLODConfig
+{
+    uint32_t m_tileSize = 64;               // = GIConfig::m_primaryTileSize
+    int m_tierCount = 4;                    // 64, 128, 256, 512
+    float m_texelsPerScreenPixel = 0.5f;    // surface cache is low frequency, half density is plenty
+    float m_hysteresis = 0.25f;             // relative band around each tier boundary
+    uint32_t m_minFramesBetweenChanges = 30;
+    uint32_t m_maxReallocsPerFrame = 32;    // every realloc costs one capture
+};
+
+struct CardLODView
+{
+    Vec3 m_cameraPosition;
+    float m_projectionScale = 1.f;          // 1 / tan(fovY / 2), RenderToClip Jy
+    float m_screenHeight = 1080.f;
+};
+
+class CardResolutionLOD
+{
+public:
+    CardResolutionLOD() = default;
+    explicit CardResolutionLOD(CardLODConfig const& config);
+
+    void SetConfig(CardLODConfig const& config) { m_config = config; }
+    CardLODConfig const& GetConfig() const { return m_config; }
+
+    static float ComputeProjectedSize(CardLODView const& view, Vec3 const& center, Vec2 const& worldSize);
+
+    IntVec2 GetTierResolution(int tier) const;
+    int GetMaxTierForResolution(IntVec2 const& recommendedResolution) const;
+    int GetIdealTier(float projectedPixels, int maxTier) const;
+
+    // Returns the tier to use this frame. Only moves away from currentTier once the
+    // projected size has left the hysteresis band and the card has held its tier long enough.
+    int SelectTier(float projectedPixels, int currentTier, int maxTier, uint32_t framesSinceChange) const;
+
+private:
+    CardLODConfig m_config;
+};
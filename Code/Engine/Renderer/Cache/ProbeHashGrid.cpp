@@ -0,0 +1,298 @@
+﻿#include "ProbeHashGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+void ProbeHashGrid::Initialize(float cellSize, uint32_t maxProbes)
+{
+    m_cellSize = cellSize;
+    m_maxProbes = maxProbes;
+    
+    // 负载因子 <= 0.5
+    uint32_t tableSize = 16;
+    while (tableSize < maxProbes * 2)
+    {
+        tableSize <<= 1;
+    }
+    m_cells.assign(tableSize, ProbeGridCell());
+    m_cellMask = tableSize - 1;
+    
+    m_cellIndices.assign(maxProbes, PROBE_GRID_INVALID);
+    m_probePositions.assign(maxProbes, Vec3(0, 0, 0));
+    m_probeCellSlot.assign(maxProbes, PROBE_GRID_INVALID);
+    m_pendingNext.assign(maxProbes, PROBE_GRID_INVALID);
+    m_probeIsPending.assign(maxProbes, 0);
+    
+    m_probeCount = 0;
+    m_pendingCount = 0;
+    m_occupiedCellCount = 0;
+}
+
+IntVec3 ProbeHashGrid::WorldToCell(const Vec3& worldPos) const
+{
+    return IntVec3(
+        (int)floorf(worldPos.x / m_cellSize),
+        (int)floorf(worldPos.y / m_cellSize),
+        (int)floorf(worldPos.z / m_cellSize)
+    );
+}
+
+uint32_t ProbeHashGrid::HashCell(const IntVec3& cell)
+{
+    // 三个大质数相乘再做一次 murmur 风格的混合，相邻 cell 不会聚集
+    uint32_t h = (uint32_t)cell.x * 73856093u ^ (uint32_t)cell.y * 19349663u ^ (uint32_t)cell.z * 83492791u;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+uint32_t ProbeHashGrid::FindCell(const IntVec3& cell) const
+{
+    if (m_cells.empty())
+        return PROBE_GRID_INVALID;
+    
+    uint32_t slot = HashCell(cell) & m_cellMask;
+    while (m_cells[slot].m_occupied)
+    {
+        if (m_cells[slot].m_cell == cell)
+            return slot;
+        slot = (slot + 1) & m_cellMask;
+    }
+    return PROBE_GRID_INVALID;
+}
+
+uint32_t ProbeHashGrid::FindOrAddCell(const IntVec3& cell)
+{
+    uint32_t slot = HashCell(cell) & m_cellMask;
+    while (m_cells[slot].m_occupied)
+    {
+        if (m_cells[slot].m_cell == cell)
+            return slot;
+        slot = (slot + 1) & m_cellMask;
+    }
+    
+    ProbeGridCell& newCell = m_cells[slot];
+    newCell.m_cell = cell;
+    newCell.m_rangeStart = 0;
+    newCell.m_rangeCount = 0;
+    newCell.m_pendingHead = PROBE_GRID_INVALID;
+    newCell.m_occupied = true;
+    m_occupiedCellCount++;
+    return slot;
+}
+
+void ProbeHashGrid::Insert(uint32_t probeIndex, const Vec3& worldPos)
+{
+    if (probeIndex >= m_maxProbes)
+        return;
+    
+    if (m_probeCellSlot[probeIndex] != PROBE_GRID_INVALID)
+    {
+        Remove(probeIndex);
+    }
+    
+    // 空 cell 只在 Rebuild 时回收，表太满时先压缩一次
+    if ((m_occupiedCellCount + 1) * 4 > (uint32_t)m_cells.size() * 3)
+    {
+        Rebuild();
+    }
+    
+    uint32_t slot = FindOrAddCell(WorldToCell(worldPos));
+    m_probePositions[probeIndex] = worldPos;
+    m_probeCellSlot[probeIndex] = slot;
+    m_probeIsPending[probeIndex] = 1;
+    m_pendingNext[probeIndex] = m_cells[slot].m_pendingHead;
+    m_cells[slot].m_pendingHead = probeIndex;
+    
+    m_probeCount++;
+    m_pendingCount++;
+}
+
+void ProbeHashGrid::Remove(uint32_t probeIndex)
+{
+    if (probeIndex >= m_maxProbes)
+        return;
+    
+    uint32_t slot = m_probeCellSlot[probeIndex];
+    if (slot == PROBE_GRID_INVALID)
+        return;
+    
+    if (m_probeIsPending[probeIndex])
+    {
+        // pending 链表很短，直接线性摘除
+        uint32_t* link = &m_cells[slot].m_pendingHead;
+        while (*link != PROBE_GRID_INVALID && *link != probeIndex)
+        {
+            link = &m_pendingNext[*link];
+        }
+        if (*link == probeIndex)
+        {
+            *link = m_pendingNext[probeIndex];
+        }
+        m_pendingNext[probeIndex] = PROBE_GRID_INVALID;
+        m_probeIsPending[probeIndex] = 0;
+        m_pendingCount--;
+    }
+    
+    // 留在 m_cellIndices 里的旧条目在查询时通过 slot 校验被跳过，Rebuild 时清掉
+    m_probeCellSlot[probeIndex] = PROBE_GRID_INVALID;
+    m_probeCount--;
+}
+
+void ProbeHashGrid::Rebuild()
+{
+    for (ProbeGridCell& cell : m_cells)
+    {
+        cell = ProbeGridCell();
+    }
+    m_occupiedCellCount = 0;
+    
+    // Pass 1: 统计每个 cell 的 probe 数
+    for (uint32_t i = 0; i < m_maxProbes; i++)
+    {
+        if (m_probeCellSlot[i] == PROBE_GRID_INVALID)
+            continue;
+        
+        uint32_t slot = FindOrAddCell(WorldToCell(m_probePositions[i]));
+        m_probeCellSlot[i] = slot;
+        m_cells[slot].m_rangeCount++;
+    }
+    
+    // Pass 2: 前缀和得到每个 cell 的起点
+    uint32_t offset = 0;
+    for (ProbeGridCell& cell : m_cells)
+    {
+        if (!cell.m_occupied)
+            continue;
+        cell.m_rangeStart = offset;
+        offset += cell.m_rangeCount;
+        cell.m_rangeCount = 0;
+    }
+    
+    // Pass 3: 填充索引
+    for (uint32_t i = 0; i < m_maxProbes; i++)
+    {
+        uint32_t slot = m_probeCellSlot[i];
+        if (slot == PROBE_GRID_INVALID)
+            continue;
+        
+        ProbeGridCell& cell = m_cells[slot];
+        m_cellIndices[cell.m_rangeStart + cell.m_rangeCount] = i;
+        cell.m_rangeCount++;
+        m_probeIsPending[i] = 0;
+        m_pendingNext[i] = PROBE_GRID_INVALID;
+    }
+    
+    m_pendingCount = 0;
+}
+
+void ProbeHashGrid::Clear()
+{
+    for (ProbeGridCell& cell : m_cells)
+    {
+        cell = ProbeGridCell();
+    }
+    std::fill(m_probeCellSlot.begin(), m_probeCellSlot.end(), PROBE_GRID_INVALID);
+    std::fill(m_pendingNext.begin(), m_pendingNext.end(), PROBE_GRID_INVALID);
+    std::fill(m_probeIsPending.begin(), m_probeIsPending.end(), (uint8_t)0);
+    
+    m_probeCount = 0;
+    m_pendingCount = 0;
+    m_occupiedCellCount = 0;
+}
+
+template<typename Visitor>
+void ProbeHashGrid::VisitRadius(const Vec3& worldPos, float radius, Visitor&& visitor) const
+{
+    if (m_probeCount == 0)
+        return;
+    
+    float radiusSq = radius * radius;
+    IntVec3 centerCell = WorldToCell(worldPos);
+    int cellRadius = (int)ceilf(radius / m_cellSize);
+    
+    for (int dx = -cellRadius; dx <= cellRadius; dx++)
+    {
+        for (int dy = -cellRadius; dy <= cellRadius; dy++)
+        {
+            for (int dz = -cellRadius; dz <= cellRadius; dz++)
+            {
+                uint32_t slot = FindCell(centerCell + IntVec3(dx, dy, dz));
+                if (slot == PROBE_GRID_INVALID)
+                    continue;
+                
+                const ProbeGridCell& cell = m_cells[slot];
+                for (uint32_t r = 0; r < cell.m_rangeCount; r++)
+                {
+                    uint32_t probeIndex = m_cellIndices[cell.m_rangeStart + r];
+                    if (m_probeCellSlot[probeIndex] != slot || m_probeIsPending[probeIndex])
+                        continue;
+                    
+                    float distSq = (m_probePositions[probeIndex] - worldPos).GetLengthSquared();
+                    if (distSq <= radiusSq && !visitor(probeIndex, distSq))
+                        return;
+                }
+                
+                for (uint32_t probeIndex = cell.m_pendingHead; probeIndex != PROBE_GRID_INVALID; probeIndex = m_pendingNext[probeIndex])
+                {
+                    float distSq = (m_probePositions[probeIndex] - worldPos).GetLengthSquared();
+                    if (distSq <= radiusSq && !visitor(probeIndex, distSq))
+                        return;
+                }
+            }
+        }
+    }
+}
+
+uint32_t ProbeHashGrid::Query(const Vec3& worldPos, float radius, uint32_t* outIndices, uint32_t capacity) const
+{
+    uint32_t count = 0;
+    if (capacity == 0)
+        return 0;
+    
+    VisitRadius(worldPos, radius, [&](uint32_t probeIndex, float)
+    {
+        outIndices[count++] = probeIndex;
+        return count < capacity;
+    });
+    return count;
+}
+
+uint32_t ProbeHashGrid::QueryNearest(const Vec3& worldPos, float radius, ProbeNeighbor* outNeighbors, uint32_t k) const
+{
+    uint32_t count = 0;
+    if (k == 0)
+        return 0;
+    
+    // k 很小，按距离插入排序维护前 k 个
+    VisitRadius(worldPos, radius, [&](uint32_t probeIndex, float distSq)
+    {
+        if (count == k && distSq >= outNeighbors[k - 1].m_distanceSquared)
+            return true;
+        
+        uint32_t pos = (count < k) ? count++ : k - 1;
+        while (pos > 0 && outNeighbors[pos - 1].m_distanceSquared > distSq)
+        {
+            outNeighbors[pos] = outNeighbors[pos - 1];
+            pos--;
+        }
+        outNeighbors[pos].m_probeIndex = probeIndex;
+        outNeighbors[pos].m_distanceSquared = distSq;
+        return true;
+    });
+    return count;
+}
+
+bool ProbeHashGrid::AnyWithin(const Vec3& worldPos, float radius) const
+{
+    bool found = false;
+    VisitRadius(worldPos, radius, [&](uint32_t, float)
+    {
+        found = true;
+        return false;
+    });
+    return found;
+}
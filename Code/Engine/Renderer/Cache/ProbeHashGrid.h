@@ -0,0 +1,69 @@
+﻿#pragma once
+
+#include "Engine/Math/IntVec3.h"
+#include "Engine/Math/Vec3.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// ========== 空间 Hash Grid ==========
+// Flat open-addressed spatial hash. Each occupied cell owns a contiguous range of
+// m_cellIndices (rebuilt by counting sort), plus an intrusive list of probes inserted
+// since the last rebuild. Nothing here allocates after Initialize().
+static constexpr uint32_t PROBE_GRID_INVALID = UINT32_MAX;
+
+struct ProbeGridCell
+{
+    IntVec3 m_cell;
+    uint32_t m_rangeStart = 0;
+    uint32_t m_rangeCount = 0;
+    uint32_t m_pendingHead = PROBE_GRID_INVALID;
+    bool m_occupied = false;
+};
+
+struct ProbeNeighbor
+{
+    uint32_t m_probeIndex;
+    float m_distanceSquared;
+};
+
+struct ProbeHashGrid
+{
+    float m_cellSize = 1.0f;
+    
+    void Initialize(float cellSize, uint32_t maxProbes);
+    IntVec3 WorldToCell(const Vec3& worldPos) const;
+    void Insert(uint32_t probeIndex, const Vec3& worldPos);
+    void Remove(uint32_t probeIndex);
+    void Rebuild();
+    void Clear();
+    
+    // 查询结果写入调用方提供的固定容量缓冲区，返回写入数量
+    uint32_t Query(const Vec3& worldPos, float radius, uint32_t* outIndices, uint32_t capacity) const;
+    uint32_t QueryNearest(const Vec3& worldPos, float radius, ProbeNeighbor* outNeighbors, uint32_t k) const;
+    bool AnyWithin(const Vec3& worldPos, float radius) const;
+    
+    uint32_t GetProbeCount() const { return m_probeCount; }
+    uint32_t GetPendingCount() const { return m_pendingCount; }
+    uint32_t GetOccupiedCellCount() const { return m_occupiedCellCount; }
+
+private:
+    uint32_t FindCell(const IntVec3& cell) const;
+    uint32_t FindOrAddCell(const IntVec3& cell);
+    static uint32_t HashCell(const IntVec3& cell);
+    template<typename Visitor>
+    void VisitRadius(const Vec3& worldPos, float radius, Visitor&& visitor) const;
+
+    std::vector<ProbeGridCell> m_cells;         // power-of-two open-addressed table
+    std::vector<uint32_t> m_cellIndices;        // per-cell ranges, packed
+    std::vector<Vec3> m_probePositions;
+    std::vector<uint32_t> m_probeCellSlot;      // PROBE_GRID_INVALID = not in grid
+    std::vector<uint32_t> m_pendingNext;
+    std::vector<uint8_t> m_probeIsPending;
+    
+    uint32_t m_cellMask = 0;
+    uint32_t m_maxProbes = 0;
+    uint32_t m_probeCount = 0;
+    uint32_t m_pendingCount = 0;
+    uint32_t m_occupiedCellCount = 0;
+};
@@ -5,6 +5,59 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "ThirdParty/d3dx12/d3dx12.h"
 
+static bool IsLowerPriority(const ProbePriorityEntry& a, const ProbePriorityEntry& b)
+{
+    // std::push_heap 维护的是"最大"在堆顶，这里反过来让最低优先级在堆顶
+    return a.m_priority > b.m_priority;
+}
+
+void ProbePriorityHeap::Reserve(uint32_t capacity)
+{
+    m_entries.reserve(capacity);
+}
+
+void ProbePriorityHeap::Reset(uint32_t capacity)
+{
+    m_entries.clear();
+    m_capacity = capacity;
+    if (m_entries.capacity() < capacity)
+    {
+        m_entries.reserve(capacity);
+    }
+}
+
+void ProbePriorityHeap::Offer(uint32_t probeIndex, float priority)
+{
+    if (m_capacity == 0)
+        return;
+    
+    if (m_entries.size() < m_capacity)
+    {
+        m_entries.push_back({ probeIndex, priority });
+        std::push_heap(m_entries.begin(), m_entries.end(), IsLowerPriority);
+        return;
+    }
+    
+    // 堆满: 只有比当前最低优先级更高的才替换堆顶
+    if (priority <= m_entries.front().m_priority)
+        return;
+    
+    std::pop_heap(m_entries.begin(), m_entries.end(), IsLowerPriority);
+    m_entries.back() = { probeIndex, priority };
+    std::push_heap(m_entries.begin(), m_entries.end(), IsLowerPriority);
+}
+
+void ProbePriorityHeap::ExtractDescending(std::vector<uint32_t>& outIndices)
+{
+    // sort_heap 按比较器升序排列，对 IsLowerPriority 来说就是优先级降序
+    std::sort_heap(m_entries.begin(), m_entries.end(), IsLowerPriority);
+    for (const ProbePriorityEntry& entry : m_entries)
+    {
+        outIndices.push_back(entry.m_probeIndex);
+    }
+    m_entries.clear();
+}
+
 void RadianceCache::Initialize(ID3D12Device* device, uint32_t maxProbes, uint32_t raysPerProbe)
 {
     if (m_initialized)
@@ -26,6 +79,7 @@ void RadianceCache::Initialize(ID3D12Device* device, uint32_t maxProbes, uint32_
     }
     
     m_updateList.reserve(256);  // 预留空间
+    m_priorityHeap.Reserve(256);
     
     // 创建 GPU 资源
     CreateProbeBuffers(device);
@@ -201,43 +255,18 @@ void RadianceCache::BuildUpdateQueue(uint32_t maxProbesThisFrame)
 {
     m_updateList.clear();
     
-    // 🔴 这里是简化版：选择最高优先级的 Probes
-    // 实际应该由 RadianceCacheManager 来管理优先级队列
-    
-    struct ProbeWithPriority
-    {
-        uint32_t index;
-        float priority;
-        
-        bool operator<(const ProbeWithPriority& other) const
-        {
-            return priority > other.priority;  // 降序
-        }
-    };
-    
-    std::vector<ProbeWithPriority> priorityQueue;
-    priorityQueue.reserve(m_activeProbeCount);
+    // 优先级由 RadianceCacheManager 每帧写入 m_priority，这里只做 top-K 选择
+    m_priorityHeap.Reset(maxProbesThisFrame);
     
     for (uint32_t i = 0; i < m_maxProbes; i++)
     {
         if (m_probes[i].m_isActive)
         {
-            ProbeWithPriority item;
-            item.index = i;
-            item.priority = m_probes[i].m_priority;
-            priorityQueue.push_back(item);
+            m_priorityHeap.Offer(i, m_probes[i].m_priority);
         }
     }
     
-    // 排序
-    std::sort(priorityQueue.begin(), priorityQueue.end());
-    
-    // 选择前 N 个
-    uint32_t updateCount = MinUint32(maxProbesThisFrame, (uint32_t)priorityQueue.size());
-    for (uint32_t i = 0; i < updateCount; i++)
-    {
-        m_updateList.push_back(priorityQueue[i].index);
-    }
+    m_priorityHeap.ExtractDescending(m_updateList);
     
     m_updateProbeCount = (uint32_t)m_updateList.size();
 }
@@ -339,24 +368,35 @@ ID3D12Resource* RadianceCache::GetUpdateListBuffer() const
     return m_updateListBuffer;
 }
 
-void RadianceCache::ReadbackProbeData(ID3D12GraphicsCommandList* cmdList, std::vector<RadianceProbeGPU>& outProbes)
+void RadianceCache::CopyProbesToReadback(ID3D12GraphicsCommandList* cmdList)
 {
-    // 从 GPU 读回数据（用于调试）
-    // 需要先 Copy 到 Readback Buffer
-    
+    // probe buffer 平时在 COMMON，buffer 可以隐式 promote 成 COPY_SOURCE
     cmdList->CopyResource(m_readbackBuffer, GetCurrentProbeBuffer());
-    
-    // 🔴 注意：这里需要等待 GPU 完成，然后再 Map
-    // 实际使用时需要在下一帧才能读取
-    
-    outProbes.resize(m_maxProbes);
-    
+    m_readbackPending = true;
+}
+
+bool RadianceCache::ReadReadbackProbes(std::vector<RadianceProbeGPU>& outProbes)
+{
+    // 调用方保证录 copy 的那一帧 GPU 已经跑完
+    if (!m_readbackPending)
+        return false;
+    m_readbackPending = false;
+
     void* mappedData = nullptr;
-    HRESULT hr = m_readbackBuffer->Map(0, nullptr, &mappedData);
-    
-    if (SUCCEEDED(hr))
+    D3D12_RANGE readRange = { 0, sizeof(RadianceProbeGPU) * m_maxProbes };
+    HRESULT hr = m_readbackBuffer->Map(0, &readRange, &mappedData);
+    if (FAILED(hr))
+        return false;
+
+    RadianceProbeGPU const* probes = static_cast<RadianceProbeGPU const*>(mappedData);
+    outProbes.clear();
+    for (uint32_t i = 0; i < m_maxProbes; i++)
     {
-        memcpy(outProbes.data(), mappedData, sizeof(RadianceProbeGPU) * m_maxProbes);
-        m_readbackBuffer->Unmap(0, nullptr);
+        if (m_probes[i].m_isActive)
+            outProbes.push_back(probes[i]);
     }
+
+    D3D12_RANGE writtenRange = { 0, 0 };
+    m_readbackBuffer->Unmap(0, &writtenRange);
+    return true;
 }
\ No newline at end of file
@@ -63,6 +63,29 @@ struct RadianceProbe
     {}
 };
 
+// 固定容量的 top-K 小顶堆: 只保留优先级最高的 K 个 probe，
+// 避免每帧对全部 active probe 排序 (O(n log K) 而不是 O(n log n))
+struct ProbePriorityEntry
+{
+    uint32_t m_probeIndex;
+    float m_priority;
+};
+
+class ProbePriorityHeap
+{
+public:
+    void Reserve(uint32_t capacity);
+    void Reset(uint32_t capacity);
+    void Offer(uint32_t probeIndex, float priority);
+    void ExtractDescending(std::vector<uint32_t>& outIndices);
+    
+    uint32_t GetCount() const { return (uint32_t)m_entries.size(); }
+    
+private:
+    std::vector<ProbePriorityEntry> m_entries;
+    uint32_t m_capacity = 0;
+};
+
 class RadianceCache
 {
     friend class DX12Renderer;
@@ -102,8 +125,10 @@ public:
     uint32_t GetRaysPerProbe() const { return m_raysPerProbe; }
     int GetCurrentBufferIndex() const { return m_currentIndex; }
     
-    void ReadbackProbeData(ID3D12GraphicsCommandList* cmdList, 
-                          std::vector<RadianceProbeGPU>& outProbes);
+    // 两步读回：这一帧录 copy，GPU 跑完这一帧（fence）之后再 Read
+    void CopyProbesToReadback(ID3D12GraphicsCommandList* cmdList);
+    bool ReadReadbackProbes(std::vector<RadianceProbeGPU>& outProbes);   // active probes only; false if no copy is pending
+    bool IsReadbackPending() const { return m_readbackPending; }
     
 protected:
     void CreateProbeBuffers(ID3D12Device* device);
@@ -115,11 +140,12 @@ protected:
     // GPU 资源
     ID3D12Resource* m_probeBuffer[RADIANCE_CACHE_BUFFER_COUNT];      // 双缓冲
     ID3D12Resource* m_updateListBuffer;                              // 本帧要更新的 Probe 索引
-    ID3D12Resource* m_readbackBuffer;                                // 用于调试
+    ID3D12Resource* m_readbackBuffer;                                // 喂 CPU 光照查询 (GISystem::SetProbeLighting)
     
     std::vector<RadianceProbe> m_probes;                             // CPU 端 Probe 列表
     std::vector<uint32_t> m_freeIndices;                             // 空闲索引池
     std::vector<uint32_t> m_updateList;                              // 本帧要更新的 Probe 索引
+    ProbePriorityHeap m_priorityHeap;
     
     uint32_t m_maxProbes;
     uint32_t m_activeProbeCount;
@@ -128,4 +154,5 @@ protected:
     
     int m_currentIndex;
     bool m_initialized;
+    bool m_readbackPending = false;
 };
\ No newline at end of file
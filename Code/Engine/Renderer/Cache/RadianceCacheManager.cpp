@@ -6,73 +6,9 @@
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/GI/GBufferData.h"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Math/MathUtils.hpp"
 #ifdef ENGINE_DX12_RENDERER
 
-IntVec3 ProbeHashGrid::WorldToCell(const Vec3& worldPos) const
-{
-    return IntVec3(
-        (int)floorf(worldPos.x / m_cellSize),
-        (int)floorf(worldPos.y / m_cellSize),
-        (int)floorf(worldPos.z / m_cellSize)
-    );
-}
-
-void ProbeHashGrid::Insert(uint32_t probeIndex, const Vec3& worldPos)
-{
-    IntVec3 cell = WorldToCell(worldPos);
-    m_grid[cell].push_back(probeIndex);
-}
-
-void ProbeHashGrid::Remove(uint32_t probeIndex, const Vec3& worldPos)
-{
-    IntVec3 cell = WorldToCell(worldPos);
-    auto it = m_grid.find(cell);
-    if (it != m_grid.end())
-    {
-        auto& probes = it->second;
-        probes.erase(std::remove(probes.begin(), probes.end(), probeIndex), probes.end());
-        
-        if (probes.empty())
-        {
-            m_grid.erase(it);
-        }
-    }
-}
-
-std::vector<uint32_t> ProbeHashGrid::Query(const Vec3& worldPos, float radius) const
-{
-    std::vector<uint32_t> result;
-    
-    IntVec3 centerCell = WorldToCell(worldPos);
-    int cellRadius = (int)ceilf(radius / m_cellSize);
-    
-    for (int dx = -cellRadius; dx <= cellRadius; dx++)
-    {
-        for (int dy = -cellRadius; dy <= cellRadius; dy++)
-        {
-            for (int dz = -cellRadius; dz <= cellRadius; dz++)
-            {
-                IntVec3 cell = centerCell + IntVec3(dx, dy, dz);
-                auto it = m_grid.find(cell);
-                if (it != m_grid.end())
-                {
-                    for (uint32_t probeIndex : it->second)
-                    {
-                        result.push_back(probeIndex);
-                    }
-                }
-            }
-        }
-    }
-    
-    return result;
-}
-
-void ProbeHashGrid::Clear()
-{
-    m_grid.clear();
-}
-
 // ========== RadianceCacheManager 实现 ==========
 
 void RadianceCacheManager::Initialize(RadianceCache* cache, Scene* scene)
@@ -84,9 +20,10 @@ void RadianceCacheManager::Initialize(RadianceCache* cache, Scene* scene)
     m_minProbeSpacing = 2.0f;      // 最小间隔 2 米
     m_maxProbeDistance = 50.0f;    // 最远 50 米
     m_probesPerFrame = 256;        // 每帧更新 256 个
+    m_nearbyQueryRadius = 10.0f;   // FindNearbyProbes 搜索 10 米范围
     
     // 初始化空间 Hash Grid
-    m_spatialGrid.m_cellSize = m_minProbeSpacing * 2.0f;
+    m_spatialGrid.Initialize(m_minProbeSpacing * 2.0f, m_cache->GetMaxProbes());
     
     DebuggerPrintf("[RadianceCacheManager] Initialized\n");
 }
@@ -166,22 +103,20 @@ Vec3 RadianceCacheManager::ReconstructWorldPosition(const Vec2& ndc, float depth
 
 bool RadianceCacheManager::ShouldPlaceProbe(const Vec3& worldPos) const
 {
-    // 检查附近是否已经有 Probe
-    std::vector<uint32_t> nearby = m_spatialGrid.Query(worldPos, m_minProbeSpacing);
-    
-    if (!nearby.empty())
-    {
-        // 已经有很近的 Probe 了，不需要再放置
-        return false;
-    }
-    
-    return true;
+    // 附近已经有很近的 Probe 了，不需要再放置
+    return !m_spatialGrid.AnyWithin(worldPos, m_minProbeSpacing);
 }
 
 void RadianceCacheManager::BuildPriorityQueue(const Camera& camera, uint32_t currentFrame)
 {
     Vec3 cameraPos = camera.GetPosition();
     
+    // 本帧新放置的 probe 合并进紧凑的 cell 区间
+    if (m_spatialGrid.GetPendingCount() > 0)
+    {
+        m_spatialGrid.Rebuild();
+    }
+    
     // 更新所有 active probes 的优先级
     uint32_t maxProbes = m_cache->GetMaxProbes();
     for (uint32_t i = 0; i < maxProbes; i++)
@@ -222,80 +157,52 @@ float RadianceCacheManager::CalculateProbePriority(
 void RadianceCacheManager::RecycleFarProbes(const Vec3& cameraPos, float maxDistance)
 {
     uint32_t maxProbes = m_cache->GetMaxProbes();
-    std::vector<uint32_t> toRecycle;
+    float maxDistanceSq = maxDistance * maxDistance;
+    uint32_t recycledCount = 0;
     
+    // FreeProbe 只把索引压回空闲池，可以边遍历边回收
     for (uint32_t i = 0; i < maxProbes; i++)
     {
         RadianceProbe* probe = m_cache->GetProbe(i);
         if (probe && probe->m_isActive)
         {
-            float distance = (probe->m_worldPosition - cameraPos).GetLength();
-            if (distance > maxDistance)
+            float distanceSq = (probe->m_worldPosition - cameraPos).GetLengthSquared();
+            if (distanceSq > maxDistanceSq)
             {
-                toRecycle.push_back(i);
+                m_spatialGrid.Remove(i);
+                m_cache->FreeProbe(i);
+                recycledCount++;
             }
         }
     }
     
-    // 回收
-    for (uint32_t index : toRecycle)
-    {
-        RadianceProbe* probe = m_cache->GetProbe(index);
-        m_spatialGrid.Remove(index, probe->m_worldPosition);
-        m_cache->FreeProbe(index);
-    }
-    
-    if (!toRecycle.empty())
+    if (recycledCount > 0)
     {
-        DebuggerPrintf("[RadianceCacheManager] Recycled %zu far probes\n", toRecycle.size());
+        DebuggerPrintf("[RadianceCacheManager] Recycled %u far probes\n", recycledCount);
     }
 }
 
-std::vector<uint32_t> RadianceCacheManager::FindNearbyProbes(const Vec3& worldPos, uint32_t maxCount) const
+uint32_t RadianceCacheManager::FindNearbyProbes(const Vec3& worldPos, uint32_t maxCount, uint32_t* outIndices) const
 {
-    // 从 Hash Grid 查询附近的 Probes
-    std::vector<uint32_t> nearby = m_spatialGrid.Query(worldPos, 10.0f);  // 10 米范围内
-    
-    if (nearby.size() <= maxCount)
+    // k 小的放栈上，大的用每线程缓冲区：maxCount 是多少就给多少
+    ProbeNeighbor stackNeighbors[NEARBY_PROBES_ON_STACK];
+    ProbeNeighbor* neighbors = stackNeighbors;
+    if (maxCount > NEARBY_PROBES_ON_STACK)
     {
-        return nearby;
-    }
-    
-    // 按距离排序，取最近的 N 个
-    struct ProbeWithDistance
-    {
-        uint32_t index;
-        float distance;
-        
-        bool operator<(const ProbeWithDistance& other) const
-        {
-            return distance < other.distance;
-        }
-    };
-    
-    std::vector<ProbeWithDistance> sorted;
-    sorted.reserve(nearby.size());
-    
-    for (uint32_t index : nearby)
-    {
-        const RadianceProbe* probe = m_cache->GetProbe(index);
-        if (probe && probe->m_isActive)
-        {
-            float dist = (probe->m_worldPosition - worldPos).GetLength();
-            sorted.push_back({index, dist});
-        }
+        thread_local std::vector<ProbeNeighbor> s_largeNeighbors;
+        if (s_largeNeighbors.size() < maxCount)
+            s_largeNeighbors.resize(maxCount);
+        neighbors = s_largeNeighbors.data();
     }
     
-    std::sort(sorted.begin(), sorted.end());
+    uint32_t count = m_spatialGrid.QueryNearest(worldPos, m_nearbyQueryRadius, neighbors, maxCount);
     
-    std::vector<uint32_t> result;
-    result.reserve(maxCount);
-    for (uint32_t i = 0; i < maxCount && i < sorted.size(); i++)
+    for (uint32_t i = 0; i < count; i++)
     {
-        result.push_back(sorted[i].index);
+        outIndices[i] = neighbors[i].m_probeIndex;
     }
     
-    return result;
+    return count;
 }
 
 #endif
\ No newline at end of file
@@ -1,27 +1,12 @@
 ﻿#pragma once
 
 #include "RadianceCache.h"
-#include "Engine/Math/IntVec3.h"
-#include <unordered_map>
-#include <queue>
+#include "ProbeHashGrid.h"
 
 class Scene;
 class Camera;
 struct GBufferData;
 
-// ========== 空间 Hash Grid ==========
-struct ProbeHashGrid
-{
-    float m_cellSize;
-    std::unordered_map<IntVec3, std::vector<uint32_t>> m_grid;
-    
-    IntVec3 WorldToCell(const Vec3& worldPos) const;
-    void Insert(uint32_t probeIndex, const Vec3& worldPos);
-    void Remove(uint32_t probeIndex, const Vec3& worldPos);
-    std::vector<uint32_t> Query(const Vec3& worldPos, float radius) const;
-    void Clear();
-};
-
 class RadianceCacheManager
 {
 public:
@@ -39,8 +24,12 @@ public:
     
     void RecycleFarProbes(const Vec3& cameraPos, float maxDistance);
     
-    // 查询
-    std::vector<uint32_t> FindNearbyProbes(const Vec3& worldPos, uint32_t maxCount) const;
+    // 查询: m_nearbyQueryRadius 内最近的 maxCount 个 Probe，按距离升序写入 outIndices（容量 >= maxCount），
+    // 返回写入数量 = min(maxCount, 范围内的 probe 数)，不会截断。
+    // maxCount <= NEARBY_PROBES_ON_STACK 时不分配；更大的用每线程的缓冲区（只增长一次），
+    // 但插入排序是 O(范围内 probe 数 * maxCount)，插值用的 k 应该保持很小
+    static constexpr uint32_t NEARBY_PROBES_ON_STACK = 32;
+    uint32_t FindNearbyProbes(const Vec3& worldPos, uint32_t maxCount, uint32_t* outIndices) const;
 
 private:
     float CalculateProbePriority(const RadianceProbe* probe, const Vec3& cameraPos, uint32_t currentFrame) const;
@@ -54,4 +43,5 @@ private:
     float m_minProbeSpacing;
     float m_maxProbeDistance;
     uint32_t m_probesPerFrame;
+    float m_nearbyQueryRadius;
 };
\ No newline at end of file
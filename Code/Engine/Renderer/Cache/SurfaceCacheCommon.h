@@ -1,4 +1,6 @@
 ﻿#pragma once
+#include <cstdint>
+
 #include "Engine/Math/IntVec2.hpp"
 struct SurfaceCard;
 
@@ -2,6 +2,8 @@
 
 #include "Engine/Math/MathUtils.hpp"
 
+#include <cmath>
+
 // ========================================
 // SurfaceCardTemplate 实现
 // 坐标系：+X=东，+Y=北，+Z=上
@@ -9,6 +11,9 @@
 
 Vec3 SurfaceCardTemplate::GetLocalNormal() const //改为朝向模型内部
 {
+	if (m_isOriented)
+		return m_orientedNormal;
+
 	switch (m_direction)
 	{
 	case 0: return Vec3(-1, 0, 0);   // +X (东面)
@@ -23,6 +28,9 @@ Vec3 SurfaceCardTemplate::GetLocalNormal() const //改为朝向模型内部
 
 Vec3 SurfaceCardTemplate::GetLocalAxisX() const
 {
+	if (m_isOriented)
+		return m_orientedAxisX;
+
 	switch (m_direction)
 	{
 	case 0: return Vec3(0, 1, 0);   // +X面: 北方向
@@ -48,6 +56,13 @@ Vec3 SurfaceCardTemplate::GetLocalOrigin(const AABB3& localBounds) const
 	Vec3 center = (localBounds.m_maxs + localBounds.m_mins) * 0.5f;
 	Vec3 size = localBounds.m_maxs - localBounds.m_mins;
 
+	if (m_isOriented)
+	{
+		// 实例 bounds 是绕中心等比缩放的，偏移按同样比例缩放
+		float scale = MaxF(MaxF(size.x, size.y), size.z) / m_referenceExtent;
+		return center + m_orientedCenterOffset * scale;
+	}
+
 	// 沿着法线方向偏移到表面
 	float offset = 0.5f * fabs(DotProduct3D(size, localNormal));
 	
@@ -56,3 +71,16 @@ Vec3 SurfaceCardTemplate::GetLocalOrigin(const AABB3& localBounds) const
     
 	return center - localNormal * offset;
 }
+
+Vec2 SurfaceCardTemplate::GetLocalSize(const AABB3& localBounds) const
+{
+	Vec3 size = localBounds.m_maxs - localBounds.m_mins;
+
+	if (m_isOriented)
+	{
+		float scale = MaxF(MaxF(size.x, size.y), size.z) / m_referenceExtent;
+		return m_localSize * scale;
+	}
+
+	return Vec2(DotProduct3D(size, GetLocalAxisX().GetNormalized()), DotProduct3D(size, GetLocalAxisY().GetNormalized()));
+}
@@ -1,10 +1,12 @@
 ﻿#pragma once
 #include <cstdint>
+#include <cstring>
 
 #include "Engine/Math/Vec3.hpp"
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Math/Mat44.hpp"
 #include "Engine/Math/IntVec2.hpp"
+#include "Engine/Renderer/Cache/CardResolutionLOD.h"
 #include <vector>
 
 class MeshObject;
@@ -27,6 +29,14 @@ struct CardGenerationConfig
     IntVec2 m_minResolution = IntVec2(32, 32);
     IntVec2 m_maxResolution = IntVec2(512, 512);
     bool m_forceAllDirections = false;
+
+    // 几何感知放置（SurfaceCardGenerator），关掉就退回六个 AABB 面
+    bool m_useGeometryAwarePlacement = true;
+    float m_normalMergeAngleDegrees = 25.0f;  // normal clusters closer than this are merged
+    float m_planeMergeDistance = 0.1f;        // coplanar patches: max depth difference (meters)
+    float m_patchMergeGap = 0.25f;            // coplanar patches: max gap between footprints (meters)
+    float m_minCardCoverage = 0.5f;           // below this a card is split in two if that shrinks it
+    int m_maxCardsPerMesh = 16;
 };
 
 // ========================================
@@ -39,6 +49,14 @@ struct SurfaceCardTemplate
     Vec2 m_localSize = Vec2(1.f, 1.f);          // Local space尺寸
     IntVec2 m_recommendedResolution = IntVec2(64, 64); // 推荐分辨率 TODO
     
+    // 几何感知生成的卡片可以是任意朝向；m_direction 仍是最接近的轴向（capture 用）
+    bool m_isOriented = false;
+    Vec3 m_orientedNormal = Vec3(0, 0, -1);     // 与 GetLocalNormal 相同，指向模型内部
+    Vec3 m_orientedAxisX = Vec3(1, 0, 0);
+    Vec3 m_orientedCenterOffset = Vec3(0, 0, 0);// 相对 mesh bounds 中心
+    float m_referenceExtent = 1.f;              // 生成时 bounds 的最大边长，用来换算实例缩放
+    float m_coverage = 1.f;                     // 被几何覆盖的 card 面积比例
+    
     // 用于统计/调试（不用于实际atlas分配）
     uint32_t m_templateID = 0;
 
@@ -47,6 +65,7 @@ struct SurfaceCardTemplate
     Vec3 GetLocalAxisX() const;
     Vec3 GetLocalAxisY() const;
     Vec3 GetLocalOrigin(const AABB3& localBounds) const;
+    Vec2 GetLocalSize(const AABB3& localBounds) const;
 };
 
 // ========================================
@@ -98,7 +117,8 @@ struct SurfaceCard
     // ===== 生命周期 =====
     bool m_resident = false;                     // 是否已分配在atlas中
     bool m_pendingRealloc = false;               // 是否等待重新分配（分辨率切换）
-    uint32_t m_lastTouchedFrame = 0;            // 最后访问帧
+    bool m_evicted = false;                      // 被驱逐出 atlas，分辨率 LOD 不再把它分配回来
+    uint32_t m_lastTouchedFrame = 0;            // 最后访问帧（Scene::GetCurrentFrame）
     float m_priority = 0.0f;                    // 优先级（用于驱逐）
     
     // ===== 关联键（能唯一回到所属实例/模板） =====
@@ -113,6 +133,11 @@ struct SurfaceCard
     IntVec2 m_oldAtlasCoord = IntVec2(-1, -1);
     IntVec2 m_oldTileSpan = IntVec2(0, 0);
     
+    // ===== 分辨率 LOD（见 CardResolutionLOD） =====
+    uint8_t m_resolutionTier = CARD_LOD_TIER_NONE;
+    uint8_t m_maxResolutionTier = 0;             // 模板推荐分辨率对应的档位
+    uint32_t m_lastResolutionChangeFrame = 0;
+    
     // ===== 全局唯一ID（Scene分配，用于索引） =====
     uint32_t m_globalCardID = 0;
     
@@ -0,0 +1,892 @@
+﻿#include "SurfaceCardGenerator.h"
+
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+    struct CardTriangle
+    {
+        Vec3 m_p[3];
+        Vec3 m_normal;      // geometric, flipped to agree with the vertex normals
+        float m_area = 0.f;
+        int m_cluster = -1;
+    };
+
+    struct NormalCluster
+    {
+        Vec3 m_normal;
+        float m_area = 0.f;
+    };
+
+    struct SurfacePatch
+    {
+        int m_cluster = -1;
+        float m_area = 0.f;
+        float m_depth = 0.f;    // area-weighted plane distance along the cluster normal
+        float m_minU = FLT_MAX;
+        float m_maxU = -FLT_MAX;
+        float m_minV = FLT_MAX;
+        float m_maxV = -FLT_MAX;
+    };
+
+    struct FittedCard
+    {
+        SurfaceCardTemplate m_template;
+        float m_coveredArea = 0.f;
+        float m_cardArea = 0.f;
+    };
+
+    int FindRoot(std::vector<int>& parents, int i)
+    {
+        while (parents[i] != i)
+        {
+            parents[i] = parents[parents[i]];
+            i = parents[i];
+        }
+        return i;
+    }
+
+    void Union(std::vector<int>& parents, int a, int b)
+    {
+        a = FindRoot(parents, a);
+        b = FindRoot(parents, b);
+        if (a != b)
+            parents[MaxI(a, b)] = MinI(a, b);
+    }
+
+    void MakeBasisFromNormal(Vec3 const& normal, Vec3& outTangent, Vec3& outBitangent)
+    {
+        Vec3 helper = (fabsf(normal.z) < 0.9f) ? Vec3(0.f, 0.f, 1.f) : Vec3(1.f, 0.f, 0.f);
+        outTangent = CrossProduct3D(helper, normal).GetNormalized();
+        outBitangent = CrossProduct3D(normal, outTangent);
+    }
+
+    // 与 SurfaceCardTemplate::GetLocalNormal 的编号一致: 0=+X 面 (法线指向 -X) ...
+    uint8_t GetDominantDirection(Vec3 const& outwardNormal)
+    {
+        float ax = fabsf(outwardNormal.x);
+        float ay = fabsf(outwardNormal.y);
+        float az = fabsf(outwardNormal.z);
+        if (ax >= ay && ax >= az)
+            return outwardNormal.x >= 0.f ? 0 : 1;
+        if (ay >= az)
+            return outwardNormal.y >= 0.f ? 2 : 3;
+        return outwardNormal.z >= 0.f ? 4 : 5;
+    }
+
+    // 最小面积包围矩形：候选角度取投影后的三角形边方向（按边长投票），外加 0 度
+    float FindBestRectangleAngle(std::vector<CardTriangle> const& triangles, std::vector<int> const& group,
+        Vec3 const& tangent, Vec3 const& bitangent)
+    {
+        constexpr int BIN_COUNT = 90;
+        float binWeights[BIN_COUNT] = {};
+        float binAngles[BIN_COUNT] = {};
+        for (int t : group)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                Vec3 edge = triangles[t].m_p[(k + 1) % 3] - triangles[t].m_p[k];
+                float du = DotProduct3D(edge, tangent);
+                float dv = DotProduct3D(edge, bitangent);
+                float length = sqrtf(du * du + dv * dv);
+                if (length < 1e-6f)
+                    continue;
+
+                float degrees = fmodf(Atan2Degrees(dv, du) + 360.f, 90.f);
+                int bin = MinI((int)degrees, BIN_COUNT - 1);
+                binWeights[bin] += length;
+                binAngles[bin] += degrees * length;
+            }
+        }
+
+        std::vector<float> candidates;
+        candidates.push_back(0.f);
+        for (int pick = 0; pick < 4; pick++)
+        {
+            int best = -1;
+            for (int b = 0; b < BIN_COUNT; b++)
+            {
+                if (binWeights[b] > 0.f && (best < 0 || binWeights[b] > binWeights[best]))
+                    best = b;
+            }
+            if (best < 0)
+                break;
+            candidates.push_back(binAngles[best] / binWeights[best]);
+            binWeights[best] = 0.f;
+        }
+
+        float bestAngle = 0.f;
+        float bestArea = FLT_MAX;
+        for (float degrees : candidates)
+        {
+            Vec3 axisX = tangent * CosDegrees(degrees) + bitangent * SinDegrees(degrees);
+            Vec3 axisY = tangent * -SinDegrees(degrees) + bitangent * CosDegrees(degrees);
+            float minU = FLT_MAX, maxU = -FLT_MAX;
+            float minV = FLT_MAX, maxV = -FLT_MAX;
+            for (int t : group)
+            {
+                for (int k = 0; k < 3; k++)
+                {
+                    float u = DotProduct3D(triangles[t].m_p[k], axisX);
+                    float v = DotProduct3D(triangles[t].m_p[k], axisY);
+                    minU = MinF(minU, u);
+                    maxU = MaxF(maxU, u);
+                    minV = MinF(minV, v);
+                    maxV = MaxF(maxV, v);
+                }
+            }
+
+            float area = (maxU - minU) * (maxV - minV);
+            if (area < bestArea - 1e-6f)
+            {
+                bestArea = area;
+                bestAngle = degrees;
+            }
+        }
+        return bestAngle;
+    }
+
+    bool FitCard(std::vector<CardTriangle> const& triangles, std::vector<int> const& group, Vec3 const& boundsCenter,
+        float extent, CardGenerationConfig const& config, FittedCard& outCard)
+    {
+        Vec3 normalSum;
+        for (int t : group)
+            normalSum += triangles[t].m_normal * triangles[t].m_area;
+        if (normalSum.GetLengthSquared() < 1e-12f)
+            return false;
+        Vec3 outward = normalSum.GetNormalized();
+
+        Vec3 tangent;
+        Vec3 bitangent;
+        MakeBasisFromNormal(outward, tangent, bitangent);
+        float angle = FindBestRectangleAngle(triangles, group, tangent, bitangent);
+
+        SurfaceCardTemplate templ;
+        templ.m_isOriented = true;
+        templ.m_orientedNormal = -outward;
+        templ.m_orientedAxisX = (tangent * CosDegrees(angle) + bitangent * SinDegrees(angle)).GetNormalized();
+        Vec3 axisX = templ.m_orientedAxisX;
+        Vec3 axisY = templ.GetLocalAxisY();
+
+        float minU = FLT_MAX, maxU = -FLT_MAX;
+        float minV = FLT_MAX, maxV = -FLT_MAX;
+        float maxDepth = -FLT_MAX;
+        float covered = 0.f;
+        for (int t : group)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                Vec3 const& p = triangles[t].m_p[k];
+                float u = DotProduct3D(p, axisX);
+                float v = DotProduct3D(p, axisY);
+                minU = MinF(minU, u);
+                maxU = MaxF(maxU, u);
+                minV = MinF(minV, v);
+                maxV = MaxF(maxV, v);
+                maxDepth = MaxF(maxDepth, DotProduct3D(p, outward));
+            }
+            covered += triangles[t].m_area * MaxF(DotProduct3D(triangles[t].m_normal, outward), 0.f);
+        }
+
+        // 卡片放在 patch 最外侧，和 AABB 面一样从外往里 capture
+        float const minCardSize = 0.01f;
+        templ.m_localSize = Vec2(MaxF(maxU - minU, minCardSize), MaxF(maxV - minV, minCardSize));
+        Vec3 center = axisX * ((minU + maxU) * 0.5f) + axisY * ((minV + maxV) * 0.5f) + outward * maxDepth;
+        templ.m_orientedCenterOffset = center - boundsCenter;
+        templ.m_referenceExtent = extent;
+        templ.m_direction = GetDominantDirection(outward);
+
+        outCard.m_cardArea = templ.m_localSize.x * templ.m_localSize.y;
+        outCard.m_coveredArea = covered;
+        templ.m_coverage = GetClamped(covered / outCard.m_cardArea, 0.f, 1.f);
+
+        int resolution = GetCardResolutionForSize(MaxF(templ.m_localSize.x, templ.m_localSize.y), config);
+        templ.m_recommendedResolution = IntVec2(resolution, resolution);
+
+        outCard.m_template = templ;
+        return true;
+    }
+
+    // 覆盖率太低（L 形、U 形的共面面片）就在卡片平面内做 2-means 切开，子卡总面积明显更小才采用
+    void FitCardsRecursive(std::vector<CardTriangle> const& triangles, std::vector<int> const& group, Vec3 const& boundsCenter,
+        float extent, CardGenerationConfig const& config, int depth, std::vector<FittedCard>& outCards)
+    {
+        constexpr int MAX_SPLIT_DEPTH = 4;
+
+        FittedCard card;
+        if (!FitCard(triangles, group, boundsCenter, extent, config, card))
+            return;
+
+        if (depth >= MAX_SPLIT_DEPTH || group.size() < 2 || card.m_template.m_coverage >= config.m_minCardCoverage)
+        {
+            outCards.push_back(card);
+            return;
+        }
+
+        Vec3 axisX = card.m_template.GetLocalAxisX();
+        Vec3 axisY = card.m_template.GetLocalAxisY();
+        Vec3 splitAxis = (card.m_template.m_localSize.x >= card.m_template.m_localSize.y) ? axisX : axisY;
+
+        std::vector<Vec2> centroids(group.size());
+        float minS = FLT_MAX;
+        float maxS = -FLT_MAX;
+        int minIndex = 0;
+        int maxIndex = 0;
+        for (size_t i = 0; i < group.size(); i++)
+        {
+            CardTriangle const& tri = triangles[group[i]];
+            Vec3 centroid = (tri.m_p[0] + tri.m_p[1] + tri.m_p[2]) / 3.f;
+            centroids[i] = Vec2(DotProduct3D(centroid, axisX), DotProduct3D(centroid, axisY));
+            float s = DotProduct3D(centroid, splitAxis);
+            if (s < minS) { minS = s; minIndex = (int)i; }
+            if (s > maxS) { maxS = s; maxIndex = (int)i; }
+        }
+
+        Vec2 seeds[2] = { centroids[minIndex], centroids[maxIndex] };
+        std::vector<uint8_t> side(group.size(), 0);
+        for (int iteration = 0; iteration < 6; iteration++)
+        {
+            Vec2 sums[2] = { Vec2(0.f, 0.f), Vec2(0.f, 0.f) };
+            float weights[2] = { 0.f, 0.f };
+            for (size_t i = 0; i < group.size(); i++)
+            {
+                float d0 = (centroids[i] - seeds[0]).GetLengthSquared();
+                float d1 = (centroids[i] - seeds[1]).GetLengthSquared();
+                side[i] = (d1 < d0) ? 1 : 0;
+                float w = triangles[group[i]].m_area;
+                sums[side[i]] += centroids[i] * w;
+                weights[side[i]] += w;
+            }
+            if (weights[0] <= 0.f || weights[1] <= 0.f)
+                break;
+            seeds[0] = sums[0] / weights[0];
+            seeds[1] = sums[1] / weights[1];
+        }
+
+        std::vector<int> halves[2];
+        for (size_t i = 0; i < group.size(); i++)
+        {
+            halves[side[i]].push_back(group[i]);
+        }
+        if (halves[0].empty() || halves[1].empty())
+        {
+            outCards.push_back(card);
+            return;
+        }
+
+        std::vector<FittedCard> children;
+        FitCardsRecursive(triangles, halves[0], boundsCenter, extent, config, depth + 1, children);
+        FitCardsRecursive(triangles, halves[1], boundsCenter, extent, config, depth + 1, children);
+
+        float childArea = 0.f;
+        for (FittedCard const& child : children)
+            childArea += child.m_cardArea;
+
+        if (childArea < card.m_cardArea * 0.8f)
+            outCards.insert(outCards.end(), children.begin(), children.end());
+        else
+            outCards.push_back(card);
+    }
+
+    uint64_t HashBytes(uint64_t hash, void const* data, size_t size)
+    {
+        uint8_t const* bytes = (uint8_t const*)data;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    // 只写标量字段：整个 struct memcpy 会把 padding（未初始化）也写进去，cook 结果就不按字节确定了
+    template <typename T>
+    void AppendValue(std::vector<uint8_t>& buffer, T value)
+    {
+        size_t offset = buffer.size();
+        buffer.resize(offset + sizeof(T));
+        memcpy(buffer.data() + offset, &value, sizeof(T));
+    }
+
+    void AppendVec2(std::vector<uint8_t>& buffer, Vec2 const& value)
+    {
+        AppendValue(buffer, value.x);
+        AppendValue(buffer, value.y);
+    }
+
+    void AppendVec3(std::vector<uint8_t>& buffer, Vec3 const& value)
+    {
+        AppendValue(buffer, value.x);
+        AppendValue(buffer, value.y);
+        AppendValue(buffer, value.z);
+    }
+
+    struct ByteReader
+    {
+        uint8_t const* m_bytes = nullptr;
+        size_t m_size = 0;
+        size_t m_offset = 0;
+        bool m_failed = false;
+
+        template <typename T>
+        T Read()
+        {
+            T value = T();
+            if (m_failed || m_offset + sizeof(T) > m_size)
+            {
+                m_failed = true;
+                return value;
+            }
+            memcpy(&value, m_bytes + m_offset, sizeof(T));
+            m_offset += sizeof(T);
+            return value;
+        }
+
+        Vec2 ReadVec2()
+        {
+            float x = Read<float>();
+            float y = Read<float>();
+            return Vec2(x, y);
+        }
+
+        Vec3 ReadVec3()
+        {
+            float x = Read<float>();
+            float y = Read<float>();
+            float z = Read<float>();
+            return Vec3(x, y, z);
+        }
+    };
+
+    constexpr uint32_t COOKED_CARDS_MAGIC = 0x44524143; // "CARD"
+    constexpr uint32_t COOKED_CARDS_VERSION = 2;        // 2: field by field (SerializeSurfaceCards)
+}
+
+//-----------------------------------------------------------------------------------------------
+int GetCardResolutionForSize(float maxDimension, CardGenerationConfig const& config)
+{
+    int resolution;
+    if (maxDimension < 1.0f)
+        resolution = 32;
+    else if (maxDimension < 3.0f)
+        resolution = 64;
+    else if (maxDimension < 8.0f)
+        resolution = 128;
+    else if (maxDimension < 16.0f)
+        resolution = 256;
+    else
+        resolution = 512;
+
+    return GetClampedInt(resolution, config.m_minResolution.x, config.m_maxResolution.x);
+}
+
+void GenerateAABBCardTemplates(AABB3 const& bounds, CardGenerationConfig const& config, std::vector<SurfaceCardTemplate>& outTemplates)
+{
+    Vec3 size = bounds.m_maxs - bounds.m_mins;
+
+    for (int dir = 0; dir < 6; dir++)
+    {
+        SurfaceCardTemplate templ;
+        templ.m_direction = (uint8_t)dir;
+        templ.m_templateID = (uint32_t)outTemplates.size();
+
+        switch (dir)
+        {
+        case 0: case 1:  // ±X
+            templ.m_localSize = Vec2(size.y, size.z);
+            break;
+        case 2: case 3:  // ±Y
+            templ.m_localSize = Vec2(size.x, size.z);
+            break;
+        case 4: case 5:  // ±Z
+            templ.m_localSize = Vec2(size.x, size.y);
+            break;
+        }
+
+        int resolution = GetCardResolutionForSize(MaxF(templ.m_localSize.x, templ.m_localSize.y), config);
+        templ.m_recommendedResolution = IntVec2(resolution, resolution);
+
+        outTemplates.push_back(templ);
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+SurfaceCardGenerationResult GenerateSurfaceCards(std::vector<Vertex_PCUTBN> const& verts, std::vector<unsigned int> const& indices,
+    CardGenerationConfig const& config)
+{
+    double startTime = GetCurrentTimeSeconds();
+    SurfaceCardGenerationResult result;
+    SurfaceCardGenerationReport& report = result.m_report;
+
+    if (verts.empty() || indices.size() < 3)
+        return result;
+
+    Vec3 boundsMin(FLT_MAX, FLT_MAX, FLT_MAX);
+    Vec3 boundsMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (Vertex_PCUTBN const& vert : verts)
+    {
+        Vec3 const& p = vert.m_position;
+        boundsMin = Vec3(MinF(boundsMin.x, p.x), MinF(boundsMin.y, p.y), MinF(boundsMin.z, p.z));
+        boundsMax = Vec3(MaxF(boundsMax.x, p.x), MaxF(boundsMax.y, p.y), MaxF(boundsMax.z, p.z));
+    }
+    Vec3 boundsSize = boundsMax - boundsMin;
+    Vec3 boundsCenter = (boundsMin + boundsMax) * 0.5f;
+    float extent = MaxF(MaxF(boundsSize.x, boundsSize.y), MaxF(boundsSize.z, 1e-4f));
+
+    // ===== 1. 三角形 =====
+    std::vector<CardTriangle> triangles;
+    triangles.reserve(indices.size() / 3);
+    std::vector<uint32_t> triangleVertex; // first index of every kept triangle, for connectivity
+    triangleVertex.reserve(indices.size() / 3);
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        Vertex_PCUTBN const& v0 = verts[indices[i]];
+        Vertex_PCUTBN const& v1 = verts[indices[i + 1]];
+        Vertex_PCUTBN const& v2 = verts[indices[i + 2]];
+
+        Vec3 cross = CrossProduct3D(v1.m_position - v0.m_position, v2.m_position - v0.m_position);
+        float crossLength = cross.GetLength();
+        if (crossLength < 1e-10f)
+            continue;
+
+        CardTriangle tri;
+        tri.m_p[0] = v0.m_position;
+        tri.m_p[1] = v1.m_position;
+        tri.m_p[2] = v2.m_position;
+        tri.m_area = 0.5f * crossLength;
+        tri.m_normal = cross / crossLength;
+
+        // 绕序不可靠，以顶点法线为准决定朝外方向
+        Vec3 vertexNormal = v0.m_normal + v1.m_normal + v2.m_normal;
+        if (DotProduct3D(tri.m_normal, vertexNormal) < 0.f)
+            tri.m_normal = -tri.m_normal;
+
+        report.m_surfaceArea += tri.m_area;
+        triangles.push_back(tri);
+        triangleVertex.push_back((uint32_t)i);
+    }
+    report.m_triangleCount = (uint32_t)triangles.size();
+    if (triangles.empty())
+        return result;
+
+    // ===== 2. 按法线聚类：26 个方向做种子，做几轮面积加权 k-means，再合并相近的簇 =====
+    std::vector<NormalCluster> clusters;
+    for (int x = -1; x <= 1; x++)
+    {
+        for (int y = -1; y <= 1; y++)
+        {
+            for (int z = -1; z <= 1; z++)
+            {
+                if (x == 0 && y == 0 && z == 0)
+                    continue;
+                NormalCluster cluster;
+                cluster.m_normal = Vec3((float)x, (float)y, (float)z).GetNormalized();
+                clusters.push_back(cluster);
+            }
+        }
+    }
+
+    for (int iteration = 0; iteration < 3; iteration++)
+    {
+        for (CardTriangle& tri : triangles)
+        {
+            float bestDot = -FLT_MAX;
+            for (int c = 0; c < (int)clusters.size(); c++)
+            {
+                float d = DotProduct3D(tri.m_normal, clusters[c].m_normal);
+                if (d > bestDot)
+                {
+                    bestDot = d;
+                    tri.m_cluster = c;
+                }
+            }
+        }
+
+        std::vector<Vec3> sums(clusters.size(), Vec3());
+        std::vector<float> areas(clusters.size(), 0.f);
+        for (CardTriangle const& tri : triangles)
+        {
+            sums[tri.m_cluster] += tri.m_normal * tri.m_area;
+            areas[tri.m_cluster] += tri.m_area;
+        }
+
+        std::vector<NormalCluster> updated;
+        for (size_t c = 0; c < clusters.size(); c++)
+        {
+            if (areas[c] <= 0.f || sums[c].GetLengthSquared() < 1e-12f)
+                continue;
+            NormalCluster cluster;
+            cluster.m_normal = sums[c].GetNormalized();
+            cluster.m_area = areas[c];
+            updated.push_back(cluster);
+        }
+        clusters.swap(updated);
+    }
+
+    // 最后一次分配到收敛后的簇
+    for (CardTriangle& tri : triangles)
+    {
+        float bestDot = -FLT_MAX;
+        for (int c = 0; c < (int)clusters.size(); c++)
+        {
+            float d = DotProduct3D(tri.m_normal, clusters[c].m_normal);
+            if (d > bestDot)
+            {
+                bestDot = d;
+                tri.m_cluster = c;
+            }
+        }
+    }
+
+    float mergeCos = CosDegrees(config.m_normalMergeAngleDegrees);
+    std::vector<int> clusterParents(clusters.size());
+    for (int c = 0; c < (int)clusters.size(); c++)
+        clusterParents[c] = c;
+
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (int a = 0; a < (int)clusters.size() && !merged; a++)
+        {
+            if (FindRoot(clusterParents, a) != a)
+                continue;
+            for (int b = a + 1; b < (int)clusters.size(); b++)
+            {
+                if (FindRoot(clusterParents, b) != b)
+                    continue;
+                if (DotProduct3D(clusters[a].m_normal, clusters[b].m_normal) < mergeCos)
+                    continue;
+
+                Vec3 sum = clusters[a].m_normal * clusters[a].m_area + clusters[b].m_normal * clusters[b].m_area;
+                clusters[a].m_normal = sum.GetNormalized();
+                clusters[a].m_area += clusters[b].m_area;
+                clusterParents[b] = a;
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    for (CardTriangle& tri : triangles)
+    {
+        tri.m_cluster = FindRoot(clusterParents, tri.m_cluster);
+    }
+    for (int c = 0; c < (int)clusters.size(); c++)
+    {
+        if (FindRoot(clusterParents, c) == c)
+            report.m_normalClusterCount++;
+    }
+
+    // ===== 3. 同一法线簇内按共享顶点（量化位置）切成连通的 patch =====
+    int triangleCount = (int)triangles.size();
+    std::vector<int> triangleParents(triangleCount);
+    for (int t = 0; t < triangleCount; t++)
+        triangleParents[t] = t;
+
+    float quantum = MaxF(extent * 1e-4f, 1e-6f);
+    std::unordered_map<uint64_t, int> vertexOwners;
+    vertexOwners.reserve(triangles.size() * 3);
+    for (int t = 0; t < triangleCount; t++)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            Vec3 const& p = triangles[t].m_p[k];
+            uint64_t key = 0xCBF29CE484222325ull;
+            int64_t q[4] = { (int64_t)floorf((p.x - boundsMin.x) / quantum), (int64_t)floorf((p.y - boundsMin.y) / quantum),
+                             (int64_t)floorf((p.z - boundsMin.z) / quantum), (int64_t)triangles[t].m_cluster };
+            key = HashBytes(key, q, sizeof(q));
+
+            auto it = vertexOwners.find(key);
+            if (it == vertexOwners.end())
+                vertexOwners.emplace(key, t);
+            else
+                Union(triangleParents, it->second, t);
+        }
+    }
+
+    std::vector<Vec3> clusterTangents(clusters.size());
+    std::vector<Vec3> clusterBitangents(clusters.size());
+    for (size_t c = 0; c < clusters.size(); c++)
+    {
+        MakeBasisFromNormal(clusters[c].m_normal, clusterTangents[c], clusterBitangents[c]);
+    }
+
+    std::vector<int> patchOfRoot(triangleCount, -1);
+    std::vector<int> trianglePatch(triangleCount);
+    std::vector<SurfacePatch> patches;
+    for (int t = 0; t < triangleCount; t++)
+    {
+        int root = FindRoot(triangleParents, t);
+        if (patchOfRoot[root] < 0)
+        {
+            patchOfRoot[root] = (int)patches.size();
+            SurfacePatch patch;
+            patch.m_cluster = triangles[t].m_cluster;
+            patches.push_back(patch);
+        }
+        trianglePatch[t] = patchOfRoot[root];
+
+        SurfacePatch& patch = patches[trianglePatch[t]];
+        CardTriangle const& tri = triangles[t];
+        Vec3 const& n = clusters[patch.m_cluster].m_normal;
+        Vec3 centroid = (tri.m_p[0] + tri.m_p[1] + tri.m_p[2]) / 3.f;
+        patch.m_area += tri.m_area;
+        patch.m_depth += DotProduct3D(centroid, n) * tri.m_area;
+        for (int k = 0; k < 3; k++)
+        {
+            float u = DotProduct3D(tri.m_p[k], clusterTangents[patch.m_cluster]);
+            float v = DotProduct3D(tri.m_p[k], clusterBitangents[patch.m_cluster]);
+            patch.m_minU = MinF(patch.m_minU, u);
+            patch.m_maxU = MaxF(patch.m_maxU, u);
+            patch.m_minV = MinF(patch.m_minV, v);
+            patch.m_maxV = MaxF(patch.m_maxV, v);
+        }
+    }
+    for (SurfacePatch& patch : patches)
+    {
+        patch.m_depth /= MaxF(patch.m_area, 1e-12f);
+    }
+    report.m_patchCount = (uint32_t)patches.size();
+
+    // ===== 4. 共面且相邻的 patch 合并（窗洞两侧的墙、被切开的地板） =====
+    int patchCount = (int)patches.size();
+    std::vector<int> patchParents(patchCount);
+    for (int p = 0; p < patchCount; p++)
+        patchParents[p] = p;
+
+    std::vector<int> order(patchCount);
+    for (int p = 0; p < patchCount; p++)
+        order[p] = p;
+    std::sort(order.begin(), order.end(), [&patches](int a, int b)
+    {
+        if (patches[a].m_cluster != patches[b].m_cluster)
+            return patches[a].m_cluster < patches[b].m_cluster;
+        return patches[a].m_depth < patches[b].m_depth;
+    });
+
+    // 按深度排序后只需要向后看深度差在容差内的 patch
+    for (int i = 0; i < patchCount; i++)
+    {
+        SurfacePatch const& a = patches[order[i]];
+        for (int j = i + 1; j < patchCount; j++)
+        {
+            SurfacePatch const& b = patches[order[j]];
+            if (b.m_cluster != a.m_cluster || b.m_depth - a.m_depth > config.m_planeMergeDistance)
+                break;
+
+            float gapU = MaxF(a.m_minU - b.m_maxU, b.m_minU - a.m_maxU);
+            float gapV = MaxF(a.m_minV - b.m_maxV, b.m_minV - a.m_maxV);
+            if (gapU <= config.m_patchMergeGap && gapV <= config.m_patchMergeGap)
+            {
+                Union(patchParents, order[i], order[j]);
+            }
+        }
+    }
+
+    // ===== 5. 每组 patch 拟合一张有朝向的 card =====
+    std::vector<std::vector<int>> groups;
+    std::vector<int> groupOfRoot(patchCount, -1);
+    for (int t = 0; t < triangleCount; t++)
+    {
+        int root = FindRoot(patchParents, trianglePatch[t]);
+        if (groupOfRoot[root] < 0)
+        {
+            groupOfRoot[root] = (int)groups.size();
+            groups.emplace_back();
+        }
+        groups[groupOfRoot[root]].push_back(t);
+    }
+
+    std::vector<FittedCard> cards;
+    for (std::vector<int> const& group : groups)
+    {
+        FitCardsRecursive(triangles, group, boundsCenter, extent, config, 0, cards);
+    }
+
+    // ===== 6. 丢掉太小的，超过上限的只留覆盖面积最大的 =====
+    std::sort(cards.begin(), cards.end(), [](FittedCard const& a, FittedCard const& b)
+    {
+        return a.m_coveredArea > b.m_coveredArea;
+    });
+
+    for (FittedCard const& card : cards)
+    {
+        if (card.m_coveredArea < config.m_minSurfaceArea || (int)result.m_templates.size() >= config.m_maxCardsPerMesh)
+        {
+            report.m_droppedCardCount++;
+            continue;
+        }
+
+        SurfaceCardTemplate templ = card.m_template;
+        templ.m_templateID = (uint32_t)result.m_templates.size();
+        result.m_templates.push_back(templ);
+
+        report.m_coveredArea += card.m_coveredArea;
+        report.m_cardArea += card.m_cardArea;
+        report.m_texelCount += (uint32_t)(templ.m_recommendedResolution.x * templ.m_recommendedResolution.y);
+    }
+    report.m_cardCount = (uint32_t)result.m_templates.size();
+    report.m_texelEfficiency = (report.m_cardArea > 0.f) ? MinF(report.m_coveredArea / report.m_cardArea, 1.f) : 0.f;
+
+    // ===== 7. 对照：六个 AABB 面 =====
+    std::vector<SurfaceCardTemplate> aabbTemplates;
+    GenerateAABBCardTemplates(AABB3(boundsMin, boundsMax), config, aabbTemplates);
+    float aabbCovered = 0.f;
+    for (CardTriangle const& tri : triangles)
+    {
+        aabbCovered += tri.m_area * MaxF(MaxF(fabsf(tri.m_normal.x), fabsf(tri.m_normal.y)), fabsf(tri.m_normal.z));
+    }
+    for (SurfaceCardTemplate const& templ : aabbTemplates)
+    {
+        report.m_aabbCardArea += templ.m_localSize.x * templ.m_localSize.y;
+        report.m_aabbTexelCount += (uint32_t)(templ.m_recommendedResolution.x * templ.m_recommendedResolution.y);
+    }
+    report.m_aabbTexelEfficiency = (report.m_aabbCardArea > 0.f) ? MinF(aabbCovered / report.m_aabbCardArea, 1.f) : 0.f;
+
+    report.m_generationSeconds = GetCurrentTimeSeconds() - startTime;
+    return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+uint64_t ComputeSurfaceCardCacheKey(std::vector<Vertex_PCUTBN> const& verts, std::vector<unsigned int> const& indices,
+    CardGenerationConfig const& config)
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+    hash = HashBytes(hash, &COOKED_CARDS_VERSION, sizeof(COOKED_CARDS_VERSION));
+    for (Vertex_PCUTBN const& vert : verts)
+    {
+        hash = HashBytes(hash, &vert.m_position, sizeof(Vec3));
+        hash = HashBytes(hash, &vert.m_normal, sizeof(Vec3));
+    }
+    hash = HashBytes(hash, indices.data(), indices.size() * sizeof(unsigned int));
+
+    float const configFloats[] = { config.m_minSurfaceArea, config.m_normalMergeAngleDegrees,
+                                   config.m_planeMergeDistance, config.m_patchMergeGap, config.m_minCardCoverage };
+    int const configInts[] = { config.m_minResolution.x, config.m_maxResolution.x, config.m_maxCardsPerMesh };
+    hash = HashBytes(hash, configFloats, sizeof(configFloats));
+    hash = HashBytes(hash, configInts, sizeof(configInts));
+    return hash;
+}
+
+void SerializeSurfaceCards(std::vector<SurfaceCardTemplate> const& templates, SurfaceCardGenerationReport const& report, std::vector<uint8_t>& outBytes)
+{
+    AppendValue(outBytes, report.m_triangleCount);
+    AppendValue(outBytes, report.m_normalClusterCount);
+    AppendValue(outBytes, report.m_patchCount);
+    AppendValue(outBytes, report.m_cardCount);
+    AppendValue(outBytes, report.m_droppedCardCount);
+    AppendValue(outBytes, report.m_surfaceArea);
+    AppendValue(outBytes, report.m_coveredArea);
+    AppendValue(outBytes, report.m_cardArea);
+    AppendValue(outBytes, report.m_texelEfficiency);
+    AppendValue(outBytes, report.m_aabbCardArea);
+    AppendValue(outBytes, report.m_aabbTexelEfficiency);
+    AppendValue(outBytes, report.m_texelCount);
+    AppendValue(outBytes, report.m_aabbTexelCount);
+    // m_loadedFromCache / m_generationSeconds 是这次运行的状态，不落盘
+
+    AppendValue(outBytes, (uint32_t)templates.size());
+    for (SurfaceCardTemplate const& templ : templates)
+    {
+        AppendValue(outBytes, templ.m_direction);
+        AppendVec2(outBytes, templ.m_localSize);
+        AppendValue(outBytes, templ.m_recommendedResolution.x);
+        AppendValue(outBytes, templ.m_recommendedResolution.y);
+        AppendValue(outBytes, (uint8_t)(templ.m_isOriented ? 1 : 0));
+        AppendVec3(outBytes, templ.m_orientedNormal);
+        AppendVec3(outBytes, templ.m_orientedAxisX);
+        AppendVec3(outBytes, templ.m_orientedCenterOffset);
+        AppendValue(outBytes, templ.m_referenceExtent);
+        AppendValue(outBytes, templ.m_coverage);
+        AppendValue(outBytes, templ.m_templateID);
+    }
+}
+
+bool DeserializeSurfaceCards(uint8_t const* bytes, size_t size, SurfaceCardGenerationResult& outResult)
+{
+    ByteReader reader;
+    reader.m_bytes = bytes;
+    reader.m_size = size;
+
+    SurfaceCardGenerationResult result;
+    SurfaceCardGenerationReport& report = result.m_report;
+    report.m_triangleCount = reader.Read<uint32_t>();
+    report.m_normalClusterCount = reader.Read<uint32_t>();
+    report.m_patchCount = reader.Read<uint32_t>();
+    report.m_cardCount = reader.Read<uint32_t>();
+    report.m_droppedCardCount = reader.Read<uint32_t>();
+    report.m_surfaceArea = reader.Read<float>();
+    report.m_coveredArea = reader.Read<float>();
+    report.m_cardArea = reader.Read<float>();
+    report.m_texelEfficiency = reader.Read<float>();
+    report.m_aabbCardArea = reader.Read<float>();
+    report.m_aabbTexelEfficiency = reader.Read<float>();
+    report.m_texelCount = reader.Read<uint32_t>();
+    report.m_aabbTexelCount = reader.Read<uint32_t>();
+    report.m_loadedFromCache = true;
+    report.m_generationSeconds = 0.0;
+
+    uint32_t templateCount = reader.Read<uint32_t>();
+    if (reader.m_failed || templateCount > (size - reader.m_offset))
+        return false;
+    result.m_templates.resize(templateCount);
+    for (SurfaceCardTemplate& templ : result.m_templates)
+    {
+        templ.m_direction = reader.Read<uint8_t>();
+        templ.m_localSize = reader.ReadVec2();
+        templ.m_recommendedResolution.x = reader.Read<int>();
+        templ.m_recommendedResolution.y = reader.Read<int>();
+        templ.m_isOriented = reader.Read<uint8_t>() != 0;
+        templ.m_orientedNormal = reader.ReadVec3();
+        templ.m_orientedAxisX = reader.ReadVec3();
+        templ.m_orientedCenterOffset = reader.ReadVec3();
+        templ.m_referenceExtent = reader.Read<float>();
+        templ.m_coverage = reader.Read<float>();
+        templ.m_templateID = reader.Read<uint32_t>();
+    }
+    if (reader.m_failed || reader.m_offset != size)
+        return false;
+
+    outResult = std::move(result);
+    return true;
+}
+
+bool LoadCookedSurfaceCards(std::string const& cachePath, uint64_t cacheKey, SurfaceCardGenerationResult& outResult)
+{
+    std::vector<uint8_t> buffer;
+    if (FileReadToBuffer(buffer, cachePath) <= 0)
+        return false;
+
+    ByteReader reader;
+    reader.m_bytes = buffer.data();
+    reader.m_size = buffer.size();
+    uint32_t magic = reader.Read<uint32_t>();
+    uint32_t version = reader.Read<uint32_t>();
+    uint64_t storedKey = reader.Read<uint64_t>();
+    // 布局变了要加 COOKED_CARDS_VERSION，旧文件视为过期
+    if (reader.m_failed || magic != COOKED_CARDS_MAGIC || version != COOKED_CARDS_VERSION || storedKey != cacheKey)
+        return false;
+
+    return DeserializeSurfaceCards(buffer.data() + reader.m_offset, buffer.size() - reader.m_offset, outResult);
+}
+
+bool SaveCookedSurfaceCards(std::string const& cachePath, uint64_t cacheKey, SurfaceCardGenerationResult const& result)
+{
+    std::vector<uint8_t> buffer;
+    AppendValue(buffer, COOKED_CARDS_MAGIC);
+    AppendValue(buffer, COOKED_CARDS_VERSION);
+    AppendValue(buffer, cacheKey);
+    SerializeSurfaceCards(result.m_templates, result.m_report, buffer);
+
+    return FileWriteFromBuffer(buffer, cachePath) == (int)buffer.size();
+}
@@ -0,0 +1,64 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Renderer/Cache/SurfaceCard.h"
+
+// ========================================
+// SurfaceCardGenerator - 几何感知的 card 放置
+// ========================================
+// Instead of six AABB faces, triangles are clustered by normal, split into connected
+// surface patches, coplanar neighbours are merged again, and every patch gets an oriented
+// card fitted to its projected footprint. L-shaped or hollow meshes stop paying for
+// card texels that only see empty space.
+
+struct SurfaceCardGenerationReport
+{
+    uint32_t m_triangleCount = 0;
+    uint32_t m_normalClusterCount = 0;
+    uint32_t m_patchCount = 0;
+    uint32_t m_cardCount = 0;
+    uint32_t m_droppedCardCount = 0;     // below CardGenerationConfig::m_minSurfaceArea or over the card limit
+
+    float m_surfaceArea = 0.f;           // total triangle area
+    float m_coveredArea = 0.f;           // triangle area projected onto the kept cards
+    float m_cardArea = 0.f;              // sum of kept card rectangles
+    float m_texelEfficiency = 0.f;       // m_coveredArea / m_cardArea
+
+    float m_aabbCardArea = 0.f;          // six AABB faces, for comparison
+    float m_aabbTexelEfficiency = 0.f;
+    uint32_t m_texelCount = 0;
+    uint32_t m_aabbTexelCount = 0;
+
+    bool m_loadedFromCache = false;
+    double m_generationSeconds = 0.0;
+};
+
+struct SurfaceCardGenerationResult
+{
+    std::vector<SurfaceCardTemplate> m_templates;
+    SurfaceCardGenerationReport m_report;
+};
+
+int GetCardResolutionForSize(float maxDimension, CardGenerationConfig const& config);
+
+// Six axis-aligned cards sized to the bounds (the original placement)
+void GenerateAABBCardTemplates(AABB3 const& bounds, CardGenerationConfig const& config, std::vector<SurfaceCardTemplate>& outTemplates);
+
+// verts must be in the same space as the bounds MeshObject uses (StaticMesh::GetTransformedVertices)
+SurfaceCardGenerationResult GenerateSurfaceCards(std::vector<Vertex_PCUTBN> const& verts, std::vector<unsigned int> const& indices,
+    CardGenerationConfig const& config);
+
+// Cooked card data: templates are cached next to the source mesh and keyed by a hash of
+// the geometry and the generation config, so a changed mesh or config regenerates them
+uint64_t ComputeSurfaceCardCacheKey(std::vector<Vertex_PCUTBN> const& verts, std::vector<unsigned int> const& indices,
+    CardGenerationConfig const& config);
+bool LoadCookedSurfaceCards(std::string const& cachePath, uint64_t cacheKey, SurfaceCardGenerationResult& outResult);
+bool SaveCookedSurfaceCards(std::string const& cachePath, uint64_t cacheKey, SurfaceCardGenerationResult const& result);
+
+// Report + templates written field by field (no struct padding, so a cook is byte-deterministic);
+// also the CookedMeshSection::CARDS payload. Appends to outBytes; false on a short / corrupt buffer
+void SerializeSurfaceCards(std::vector<SurfaceCardTemplate> const& templates, SurfaceCardGenerationReport const& report, std::vector<uint8_t>& outBytes);
+bool DeserializeSurfaceCards(uint8_t const* bytes, size_t size, SurfaceCardGenerationResult& outResult);
@@ -2,6 +2,7 @@
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 
+#ifndef ENGINE_NULL_RENDERER
 //Add dx11
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -16,6 +17,7 @@
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "d3dcompiler.lib")
+#endif
 
 ConstantBuffer::ConstantBuffer(ID3D11Device* device, size_t size)
 	:m_size(size)
@@ -61,10 +63,19 @@ void ConstantBuffer::ResetOffset()
 }
 #endif
 
+#ifdef ENGINE_NULL_RENDERER
+ConstantBuffer::ConstantBuffer(size_t size)
+	:m_size(size)
+{
+}
+#endif
+
 ConstantBuffer::~ConstantBuffer()
 {
+#ifndef ENGINE_NULL_RENDERER
 	if(m_buffer)
 		m_buffer->Release();
+#endif
 
 #ifdef ENGINE_DX12_RENDERER
 	delete m_constantBufferView;
@@ -75,6 +86,7 @@ ConstantBuffer::~ConstantBuffer()
 
 void ConstantBuffer::Create()
 {
+#ifndef ENGINE_NULL_RENDERER
 	D3D11_BUFFER_DESC bufferDesc = {};
 	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
 	bufferDesc.ByteWidth = (UINT)m_size;
@@ -87,4 +99,5 @@ void ConstantBuffer::Create()
 		DebuggerPrintf("CreateBuffer failed with HRESULT: 0x%08X\n", hr);
 		ERROR_AND_DIE("Could not create constant buffer.");
 	}
+#endif
 }
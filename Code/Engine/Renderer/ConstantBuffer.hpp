@@ -1,7 +1,9 @@
 #pragma once
-#include <d3d12.h>
-
+#include "Game/EngineBuildPreferences.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#ifndef ENGINE_NULL_RENDERER
+#include <d3d12.h>
+#endif
 
 struct ID3D11Device;
 struct ID3D11Buffer;
@@ -14,6 +16,7 @@ class ConstantBuffer
 	friend class Renderer;
 	friend class DX11Renderer;
 	friend class DX12Renderer;
+	friend class NullRenderer;
 
 public:
 	ConstantBuffer(ID3D11Device* device, size_t size);
@@ -25,6 +28,9 @@ public:
 	size_t GetFrameOffset(int frame);
 	void ResetOffset();
 #endif
+#ifdef ENGINE_NULL_RENDERER
+	ConstantBuffer(size_t size);
+#endif
 	
 	ConstantBuffer(const ConstantBuffer& copy) = delete;
 	virtual ~ConstantBuffer();
@@ -25,6 +25,9 @@
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Core/Vertex_PCU.hpp"
 #include "Engine/Core/Image.hpp"
+#include "Engine/Core/ImageMipChain.h"
+#include "Engine/Core/BlockCompression.h"
+#include "Engine/Core/BlockCompressionDXGI.h"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/Mat44.hpp"
 #include "Engine/Window/Window.hpp"
@@ -99,6 +102,7 @@ void DX11Renderer::Startup()
 	//Create vertex buffer big enough
 	m_immediateVBO = CreateVertexBuffer(sizeof(Vertex_PCU), sizeof(Vertex_PCU));
 	m_immediateVBOForVertex_PCUTBN = CreateVertexBuffer(sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN));
+	m_instanceVBO = CreateVertexBuffer(sizeof(InstanceData), sizeof(InstanceData));
 	m_immediateIBO = CreateIndexBuffer(sizeof(unsigned int), sizeof(unsigned int));
 
 	//Create a constant buffer large enough to fit the structure contents.
@@ -164,6 +168,7 @@ void DX11Renderer::ShutDown()
 		texture = nullptr;
 	}
 	m_loadedTextures.clear();
+	m_textureLookup.Clear();
 
 	m_defaultTexture = nullptr;
 
@@ -179,6 +184,9 @@ void DX11Renderer::ShutDown()
 	delete m_immediateVBOForVertex_PCUTBN;
 	m_immediateVBOForVertex_PCUTBN = nullptr;
 
+	delete m_instanceVBO;
+	m_instanceVBO = nullptr;
+
 	delete m_immediateIBO;
 	m_immediateIBO = nullptr;
 
@@ -619,9 +627,148 @@ Texture* DX11Renderer::CreateTextureFromImage(const Image& image, bool usingMipm
     }
 
     m_loadedTextures.push_back(newTexture);
+    m_textureLookup.Add(newTexture);
+    return newTexture;
+}
+
+Texture* DX11Renderer::CreateTextureFromMipChain(ImageMipChain const& mipChain, int residentMip)
+{
+    GUARANTEE_OR_DIE(mipChain.IsValid(), Stringf("CreateTextureFromMipChain failed for \"%s\" - empty mip chain", mipChain.m_name.c_str()));
+
+	Texture* newTexture = new Texture();
+    newTexture->m_name = mipChain.m_name;
+    newTexture->m_dimensions = mipChain.GetDimensions(0);
+    newTexture->m_mipLevelCount = mipChain.GetLevelCount();
+    UpdateTextureMips(newTexture, mipChain, residentMip);
+
+    m_loadedTextures.push_back(newTexture);
+    m_textureLookup.Add(newTexture);
     return newTexture;
 }
 
+Texture* DX11Renderer::CreateTextureFromCompressedMipChain(CompressedMipChain const& mipChain, int residentMip)
+{
+    GUARANTEE_OR_DIE(mipChain.IsValid(), Stringf("CreateTextureFromCompressedMipChain failed for \"%s\" - empty mip chain", mipChain.m_name.c_str()));
+
+    Texture* newTexture = new Texture();
+    newTexture->m_name = mipChain.m_name;
+    newTexture->m_dimensions = mipChain.GetDimensions(0);
+    newTexture->m_mipLevelCount = mipChain.GetLevelCount();
+    UpdateTextureMips(newTexture, mipChain, residentMip);
+
+    m_loadedTextures.push_back(newTexture);
+    m_textureLookup.Add(newTexture);
+    return newTexture;
+}
+
+void DX11Renderer::UpdateTextureMips(Texture* texture, ImageMipChain const& mipChain, int residentMip)
+{
+    GUARANTEE_OR_DIE(residentMip >= 0 && residentMip < mipChain.GetLevelCount(), Stringf("UpdateTextureMips failed for \"%s\" - no level %d", texture->m_name.c_str(), residentMip));
+
+    // 每个 level 一个 subresource，CPU 已经滤好，不再 GenerateMips
+    std::vector<D3D11_SUBRESOURCE_DATA> levelData(mipChain.GetLevelCount() - residentMip);
+    for (int level = residentMip; level < mipChain.GetLevelCount(); level++)
+    {
+        levelData[level - residentMip].pSysMem = mipChain.GetLevelTexels(level);
+        levelData[level - residentMip].SysMemPitch = 4 * mipChain.GetDimensions(level).x;
+        levelData[level - residentMip].SysMemSlicePitch = 0;
+    }
+    CreateTextureLevels(texture, DXGI_FORMAT_R8G8B8A8_UNORM, mipChain.GetDimensions(residentMip), levelData);
+    texture->m_residentMip = residentMip;
+}
+
+void DX11Renderer::UpdateTextureMips(Texture* texture, CompressedMipChain const& mipChain, int residentMip)
+{
+    GUARANTEE_OR_DIE(residentMip >= 0 && residentMip < mipChain.GetLevelCount(), Stringf("UpdateTextureMips failed for \"%s\" - no level %d", texture->m_name.c_str(), residentMip));
+
+    // pitch 按 block 行算
+    std::vector<D3D11_SUBRESOURCE_DATA> levelData(mipChain.GetLevelCount() - residentMip);
+    for (int level = residentMip; level < mipChain.GetLevelCount(); level++)
+    {
+        levelData[level - residentMip].pSysMem = mipChain.GetLevelBytes(level);
+        levelData[level - residentMip].SysMemPitch = GetBlockRowPitch(mipChain.m_format, mipChain.GetDimensions(level).x);
+        levelData[level - residentMip].SysMemSlicePitch = 0;
+    }
+    CreateTextureLevels(texture, GetBlockDXGIFormat(mipChain.m_format), mipChain.GetDimensions(residentMip), levelData);
+    texture->m_residentMip = residentMip;
+}
+
+void DX11Renderer::DropTextureMips(Texture* texture, int residentMip)
+{
+    int dropCount = residentMip - texture->m_residentMip;
+    if (texture->m_texture == nullptr || dropCount <= 0)
+        return;
+
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    texture->m_texture->GetDesc(&textureDesc);
+    if (dropCount >= (int)textureDesc.MipLevels)
+        return;
+
+    // 留下的 level 在显存里直接拷，不用回头读文件
+    textureDesc.Width = std::max(1u, textureDesc.Width >> dropCount);
+    textureDesc.Height = std::max(1u, textureDesc.Height >> dropCount);
+    textureDesc.MipLevels -= dropCount;
+    textureDesc.Usage = D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    textureDesc.MiscFlags = 0;
+
+    ID3D11Texture2D* newTexture = nullptr;
+    HRESULT hr = m_device->CreateTexture2D(&textureDesc, nullptr, &newTexture);
+    if (!SUCCEEDED(hr))
+    {
+        ERROR_AND_DIE(Stringf("DropTextureMips failed for \"%s\".", texture->m_name.c_str()));
+    }
+    for (UINT level = 0; level < textureDesc.MipLevels; level++)
+    {
+        m_deviceContext->CopySubresourceRegion(newTexture, level, 0, 0, 0, texture->m_texture, level + dropCount, nullptr);
+    }
+
+    ID3D11ShaderResourceView* newView = nullptr;
+    hr = m_device->CreateShaderResourceView(newTexture, NULL, &newView);
+    if (!SUCCEEDED(hr))
+    {
+        ERROR_AND_DIE(Stringf("CreateShaderResourceView failed for \"%s\".", texture->m_name.c_str()));
+    }
+    DX_SAFE_RELEASE(texture->m_texture);
+    DX_SAFE_RELEASE(texture->m_shaderResourceView);
+    texture->m_texture = newTexture;
+    texture->m_shaderResourceView = newView;
+    texture->m_residentMip = residentMip;
+}
+
+void DX11Renderer::CreateTextureLevels(Texture* texture, DXGI_FORMAT format, IntVec2 const& dimensions, std::vector<D3D11_SUBRESOURCE_DATA> const& levelData)
+{
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width = dimensions.x;
+    textureDesc.Height = dimensions.y;
+    textureDesc.MipLevels = (UINT)levelData.size();
+    textureDesc.ArraySize = 1;
+    textureDesc.Format = format;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.Usage = D3D11_USAGE_IMMUTABLE;
+    textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    textureDesc.MiscFlags = 0;
+
+    ID3D11Texture2D* newTexture = nullptr;
+    HRESULT hr = m_device->CreateTexture2D(&textureDesc, levelData.data(), &newTexture);
+    if (!SUCCEEDED(hr))
+    {
+        ERROR_AND_DIE(Stringf("CreateTexture2D failed for \"%s\" (%dx%d, %d levels).", texture->m_name.c_str(), dimensions.x, dimensions.y, (int)levelData.size()));
+    }
+    ID3D11ShaderResourceView* newView = nullptr;
+    hr = m_device->CreateShaderResourceView(newTexture, NULL, &newView);
+    if (!SUCCEEDED(hr))
+    {
+        ERROR_AND_DIE(Stringf("CreateShaderResourceView failed for \"%s\".", texture->m_name.c_str()));
+    }
+
+    // 流送时替换旧资源，Texture* 不变
+    DX_SAFE_RELEASE(texture->m_texture);
+    DX_SAFE_RELEASE(texture->m_shaderResourceView);
+    texture->m_texture = newTexture;
+    texture->m_shaderResourceView = newView;
+}
+
 Texture* DX11Renderer::CreateOrGetTextureFromFile(char const* imageFilePath, bool usingMipmaps)
 {
 	// See if we already have this texture previously loaded
@@ -642,9 +789,12 @@ Texture* DX11Renderer::CreateTextureFromFile(char const* imageFilePath, bool usi
 	int bytesPerTexel = 0; // This will be filled in for us to indicate how many color components the image had (e.g. 3=RGB=24bit, 4=RGBA=32bit)
 	int numComponentsRequested = 0; // don't care; we support 3 (24-bit RGB) or 4 (32-bit RGBA)
 
-	// Load (and decompress) the image RGB(A) bytes from a file on disk into a memory buffer (array of bytes)
+	// Load (and decompress) the image RGB(A) bytes from a file on disk (or a mounted asset pack) into a memory buffer (array of bytes)
+	std::vector<uint8_t> fileBytes;
+	FileReadToBuffer(fileBytes, imageFilePath);
 	stbi_set_flip_vertically_on_load(1); // We prefer uvTexCoords has origin (0,0) at BOTTOM LEFT
-	unsigned char* texelData = stbi_load(imageFilePath, &dimensions.x, &dimensions.y, &bytesPerTexel, numComponentsRequested);
+	unsigned char* texelData = fileBytes.empty() ? nullptr :
+		stbi_load_from_memory(fileBytes.data(), (int)fileBytes.size(), &dimensions.x, &dimensions.y, &bytesPerTexel, numComponentsRequested);
 
 	// Check if the load was successful
 	GUARANTEE_OR_DIE(texelData, Stringf("Failed to load image \"%s\"", imageFilePath));
@@ -659,14 +809,7 @@ Texture* DX11Renderer::CreateTextureFromFile(char const* imageFilePath, bool usi
 
 Texture* DX11Renderer::GetTextureForFileName(const char* imageFilePath)
 {
-	for (int i = 0; i < m_loadedTextures.size(); i++)
-	{
-		if (m_loadedTextures[i]->GetImageFilePath() == imageFilePath)
-		{
-			return m_loadedTextures[i];
-		}
-	}
-	return nullptr;
+	return m_textureLookup.Find(imageFilePath);
 }
 
 //------------------------------------------------------------------------------------------------
@@ -853,6 +996,57 @@ Shader* DX11Renderer::CreateShader(char const* shaderName, char const* shaderSou
 			ERROR_AND_DIE("Fail to create a inputlayout for VERTEX_PCUTBN");
 		}
 	}
+	if (vertexType == VertexType::VERTEX_PCUTBN_PACKED)
+	{
+		// 和 VertexLayoutTraits<Vertex_PCUTBNPacked> 一一对应；shader 自己解 octahedral
+		D3D11_INPUT_ELEMENT_DESC inputElementDesc[] =
+		{
+			{"POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+			{"COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+			{"TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+			{"NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+			{"TANGENT", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+		};
+		UINT numElements = ARRAYSIZE(inputElementDesc);
+		hr = m_device->CreateInputLayout(
+			inputElementDesc, numElements,
+			shaderByteCodeForVertex.data(),
+			shaderByteCodeForVertex.size(),
+			&inputLayout
+		);
+		if (FAILED(hr))
+		{
+			ERROR_AND_DIE("Fail to create a inputlayout for VERTEX_PCUTBN_PACKED");
+		}
+	}
+	if (vertexType == VertexType::VERTEX_PCUTBN_INSTANCED)
+	{
+		// slot 0 per-vertex Vertex_PCUTBN, slot 1 per-instance InstanceData
+		D3D11_INPUT_ELEMENT_DESC inputElementDesc[] =
+		{
+			{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+			{"COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+			{"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+			{"TANGENT", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+			{"BITANGENT", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+			{"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+			{"INSTANCE_TRANSFORM", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+			{"INSTANCE_TRANSFORM", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+			{"INSTANCE_TRANSFORM", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+			{"INSTANCE_COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+		};
+		UINT numElements = ARRAYSIZE(inputElementDesc);
+		hr = m_device->CreateInputLayout(
+			inputElementDesc, numElements,
+			shaderByteCodeForVertex.data(),
+			shaderByteCodeForVertex.size(),
+			&inputLayout
+		);
+		if (FAILED(hr))
+		{
+			ERROR_AND_DIE("Fail to create a inputlayout for VERTEX_PCUTBN_INSTANCED");
+		}
+	}
 
 	Shader* newShader = new Shader(usedShaderConfig);
 	newShader->m_vertexShader = vertexShader;
@@ -1065,11 +1259,12 @@ IndexBuffer* DX11Renderer::CreateIndexBuffer(const unsigned int size, unsigned i
 
 void DX11Renderer::BindIndexBuffer(IndexBuffer* ibo)
 {
-	m_deviceContext->IASetIndexBuffer(ibo->m_buffer, DXGI_FORMAT_R32_UINT, 0);
+	DXGI_FORMAT format = (ibo->m_stride == sizeof(uint16_t)) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+	m_deviceContext->IASetIndexBuffer(ibo->m_buffer, format, 0);
 	m_deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 }
 
-void DX11Renderer::DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, PrimitiveTopology topology)
+void DX11Renderer::DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, PrimitiveTopology topology, unsigned int startIndex)
 {
 	BindVertexBuffer(vbo);
 	BindIndexBuffer(ibo);
@@ -1094,11 +1289,35 @@ void DX11Renderer::DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, unsigned
 		break;
 	}
 	
-	m_deviceContext->DrawIndexed(indexCount, 0, 0);
+	m_deviceContext->DrawIndexed(indexCount, startIndex, 0);
 
 	//m_deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 }
 
+void DX11Renderer::UploadInstanceData(const InstanceData* instances, unsigned int instanceCount)
+{
+	if (instanceCount == 0)
+		return;
+	//WRITE_DISCARD：前面已经提交的 instanced draw 仍然读旧的内容
+	CopyCPUToGPU(instances, instanceCount * (unsigned int)sizeof(InstanceData), m_instanceVBO);
+}
+
+void DX11Renderer::DrawIndexBufferInstanced(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, unsigned int firstInstance, unsigned int instanceCount, unsigned int startIndex)
+{
+	GUARANTEE_OR_DIE((firstInstance + instanceCount) * sizeof(InstanceData) <= m_instanceVBO->m_size, "Instanced draw reads past the uploaded InstanceData");
+
+	BindVertexBuffer(vbo);
+	BindIndexBuffer(ibo);
+	UINT startOffset = 0;
+	m_deviceContext->IASetVertexBuffers(1, 1, &m_instanceVBO->m_buffer, &m_instanceVBO->m_stride, &startOffset);
+	SetBlendModeIfChanged();
+	SetRasterizerModeIfChanged();
+	SetDepthModeIfChanged();
+	SetSamplerModeIfChanged();
+
+	m_deviceContext->DrawIndexedInstanced(indexCount, instanceCount, startIndex, 0, firstInstance);
+}
+
 void DX11Renderer::CopyCPUToGPU(const void* data, unsigned int size, IndexBuffer*& ibo)
 {
 	if (ibo->m_size < size)
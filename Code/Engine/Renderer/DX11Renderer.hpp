@@ -7,6 +7,7 @@
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Core/Vertex_PCU.hpp"
 #include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Core/TextureResidency.h"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/IntVec2.hpp"
 #include <vector>
@@ -81,6 +82,11 @@ public:
 	
 	Image* CreateImageFromFile(char const* imageFilePath);
 	Texture* CreateTextureFromImage(const Image& image, bool usingMipmaps = false);
+	Texture* CreateTextureFromMipChain(ImageMipChain const& mipChain, int residentMip = 0);
+	Texture* CreateTextureFromCompressedMipChain(CompressedMipChain const& mipChain, int residentMip = 0);
+	void UpdateTextureMips(Texture* texture, ImageMipChain const& mipChain, int residentMip);
+	void UpdateTextureMips(Texture* texture, CompressedMipChain const& mipChain, int residentMip);
+	void DropTextureMips(Texture* texture, int residentMip);
 	Texture* CreateOrGetTextureFromFile(char const* imageFilePath, bool usingMipmaps = false);
 	Texture* CreateTextureFromData(char const* name, IntVec2 dimensions, int bytesPerTexel, uint8_t* texelData, bool usingMipmaps = false);
 	Texture* CreateTextureFromFile(char const* imageFilePath, bool usingMipmaps = false);
@@ -107,7 +113,9 @@ public:
 
 	IndexBuffer* CreateIndexBuffer(const unsigned int size, unsigned int stride);
 	void BindIndexBuffer(IndexBuffer* ibo);
-	void DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, PrimitiveTopology topology = PRIMITIVE_TRIANGLES);
+	void DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, PrimitiveTopology topology = PRIMITIVE_TRIANGLES, unsigned int startIndex = 0);
+	void UploadInstanceData(const InstanceData* instances, unsigned int instanceCount);
+	void DrawIndexBufferInstanced(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, unsigned int firstInstance, unsigned int instanceCount, unsigned int startIndex = 0);
 	void CopyCPUToGPU(const void* data, unsigned int size, IndexBuffer*& ibo);
 
 	ConstantBuffer* CreateConstantBuffer(const unsigned int size);
@@ -157,12 +165,15 @@ protected:
 	RendererConfig m_config;
 
 private:
+	void CreateTextureLevels(Texture* texture, DXGI_FORMAT format, IntVec2 const& dimensions, std::vector<D3D11_SUBRESOURCE_DATA> const& levelData);
+
 	void* m_windowHandle = nullptr;
 
 	void* m_apiRenderingContext = nullptr;
 
 
 	std::vector<Texture*> m_loadedTextures;
+	TextureLookupTable m_textureLookup;		// GetTextureForFileName
 
 	std::vector<BitmapFont*> m_loadedFonts;
 
@@ -179,6 +190,7 @@ private:
 	//Vertex Buffer variable
 	VertexBuffer* m_immediateVBO = nullptr;
 	VertexBuffer* m_immediateVBOForVertex_PCUTBN = nullptr;
+	VertexBuffer* m_instanceVBO = nullptr;	//InstanceData, IA slot 1
 
 	//Index Buffer variable
 	IndexBuffer* m_immediateIBO = nullptr;
@@ -12,6 +12,7 @@
 #include "IndexBuffer.hpp"
 #include "Shader.hpp"
 #include "VertexBuffer.hpp"
+#include "FrameUploadAllocator.h"
 #include "SDFTexture3D.h"
 #include "Cache/RadianceCacheManager.h"
 #include "Cache/SurfaceCard.h"
@@ -22,6 +23,9 @@
 #include "Engine/Renderer/GI/DefaultGBufferShader.h"
 #include "Engine/Core/DebugRenderSystem.hpp"
 #include "Engine/Core/Image.hpp"
+#include "Engine/Core/ImageMipChain.h"
+#include "Engine/Core/BlockCompression.h"
+#include "Engine/Core/BlockCompressionDXGI.h"
 #include "Engine/Core/FileUtils.hpp"
 #include "Engine/Scene/Scene.h"
 #include "Engine/Scene/Object/Mesh/MeshObject.h"
@@ -283,20 +287,24 @@ void DX12Renderer::Startup()
 	m_commandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
 
 	m_loadedTextures.clear();
+	m_textureLookup.Clear();
 	Image* whiteImage = new Image(IntVec2(4, 4), Rgba8::WHITE);
 	m_defaultTexture = CreateTextureFromImage(*whiteImage);
 	m_defaultTexture->m_name = "Default";
 	m_loadedTextures.push_back(m_defaultTexture);
+	m_textureLookup.Add(m_defaultTexture);
 	
 	Image* image1 = new Image(IntVec2(2, 2), Rgba8(127, 127, 255));
 	m_defaultNormalTexture = CreateTextureFromImage(*image1);
 	m_defaultNormalTexture->m_name = "DefaultNormal";
 	m_loadedTextures.push_back(m_defaultNormalTexture);
+	m_textureLookup.Add(m_defaultNormalTexture);
 
 	Image* image2 = new Image(IntVec2(2, 2), Rgba8(127, 127, 0));
 	m_defaultSpecTexture = CreateTextureFromImage(*image2);
 	m_defaultSpecTexture->m_name = "DefaultSpec";
 	m_loadedTextures.push_back(m_defaultSpecTexture);
+	m_textureLookup.Add(m_defaultSpecTexture);
 
 	// Create the pipeline state, which includes compiling and loading shaders.
 	m_defaultShader = CreateShader("Default", m_shaderSource);
@@ -327,6 +335,40 @@ void DX12Renderer::Startup()
 		m_frameVertexBuffersForTBN[i] = new VertexBuffer(m_device, VERTEX_RING_BUFFER_SIZE, sizeof(Vertex_PCUTBN));
 		m_frameIndexBuffers[i] = new IndexBuffer(m_device, VERTEX_RING_BUFFER_SIZE, sizeof(Vertex_PCU));
 	}
+	//Upload pages: persistently mapped upload heap, reclaimed when the frame that used them retires
+	{
+		FrameUploadAllocatorConfig uploadConfig;
+		uploadConfig.m_pageSize = 4 * 1024 * 1024;
+		uploadConfig.m_createPage = [this](FrameUploadPage& page) -> bool
+		{
+			CD3DX12_HEAP_PROPERTIES props(D3D12_HEAP_TYPE_UPLOAD);
+			CD3DX12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(page.m_size);
+			ID3D12Resource* resource = nullptr;
+			HRESULT pageHr = m_device->CreateCommittedResource(&props, D3D12_HEAP_FLAG_NONE, &desc,
+				D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&resource));
+			if (FAILED(pageHr))
+				return false;
+
+			CD3DX12_RANGE readRange(0, 0);
+			pageHr = resource->Map(0, &readRange, reinterpret_cast<void**>(&page.m_cpuBase));
+			if (FAILED(pageHr))
+			{
+				resource->Release();
+				return false;
+			}
+			resource->SetName(L"FrameUploadPage");
+			page.m_gpuBase = resource->GetGPUVirtualAddress();
+			page.m_resource = resource;
+			return true;
+		};
+		uploadConfig.m_destroyPage = [](FrameUploadPage& page)
+		{
+			ID3D12Resource* resource = (ID3D12Resource*)page.m_resource;
+			resource->Unmap(0, nullptr);
+			DX_SAFE_RELEASE(resource);
+		};
+		m_uploadAllocator = new FrameUploadAllocator(uploadConfig);
+	}
 	// Wait for the command list to execute; we are reusing the same command 
 	// list in our main loop but for now, we just want to wait for setup to 
 	// complete before continuing.
@@ -368,6 +410,12 @@ void DX12Renderer::BeginFrame()
 	m_frameVertexBuffers[m_frameIndex]->ResetRing();
 	m_frameVertexBuffersForTBN[m_frameIndex]->ResetRing();
 	m_frameIndexBuffers[m_frameIndex]->ResetRing();
+	// EndFrame 会等到上一帧 GPU 完成，所以已提交的 fence 都已完成
+	m_uploadAllocator->BeginFrame(m_uploadFrameFence);
+	m_instanceBufferView = {};
+	m_textureDescriptors.ProcessDeferredFrees(m_uploadFrameFence);
+	m_sdfDescriptors.ProcessDeferredFrees(m_uploadFrameFence);
+	m_transientDescriptors.BeginFrame(m_frameIndex);
 
 	m_currentDrawIndex = 0;
 	
@@ -417,6 +465,7 @@ void DX12Renderer::EndFrame()
 
 	ID3D12CommandList* listsToExecute[] = { m_commandList };
 	m_commandQueue->ExecuteCommandLists(1, listsToExecute);
+	m_uploadAllocator->EndFrame(++m_uploadFrameFence);
 
 	const UINT currentFrameIndex = m_frameIndex;
 	const UINT64 currentFenceValue = m_fenceValue[currentFrameIndex];
@@ -465,6 +514,10 @@ void DX12Renderer::EndFrame()
 
 	m_hasBackBufferCleared = false;
 
+	// 上面已经等到这一帧的 fence，EndGBufferPass 录的 readback 可以 Map 了
+	if (m_giSystem && m_radianceCache.ReadReadbackProbes(m_probeReadback))
+		m_giSystem->SetProbeLighting(m_probeReadback);
+
 	if (m_giSystem)
 		m_giSystem->EndFrame();
 }
@@ -481,6 +534,37 @@ void DX12Renderer::ShutDown()
 		WaitForPreviousFrame();
 	}
 
+	// 高水位，用来把 128MB 的 ring 预留缩到实际需要
+	size_t peakVertexBytes = 0;
+	size_t peakTBNBytes = 0;
+	size_t peakIndexBytes = 0;
+	for (int n = 0; n < FRAME_BUFFER_COUNT; n++)
+	{
+		if (m_frameVertexBuffers[n]->GetPeakRingUsage() > peakVertexBytes)
+			peakVertexBytes = m_frameVertexBuffers[n]->GetPeakRingUsage();
+		if (m_frameVertexBuffersForTBN[n]->GetPeakRingUsage() > peakTBNBytes)
+			peakTBNBytes = m_frameVertexBuffersForTBN[n]->GetPeakRingUsage();
+		if (m_frameIndexBuffers[n]->GetPeakRingUsage() > peakIndexBytes)
+			peakIndexBytes = m_frameIndexBuffers[n]->GetPeakRingUsage();
+	}
+	FrameUploadStats uploadStats = m_uploadAllocator->GetStats();
+	DebuggerPrintf("[DX12Renderer] ring peak: vertex %.2f MB, vertexTBN %.2f MB, index %.2f MB (reserved %.0f MB each)\n",
+		(double)peakVertexBytes / (1024.0 * 1024.0), (double)peakTBNBytes / (1024.0 * 1024.0),
+		(double)peakIndexBytes / (1024.0 * 1024.0), (double)VERTEX_RING_BUFFER_SIZE / (1024.0 * 1024.0));
+	DebuggerPrintf("[DX12Renderer] upload pages: peak frame %.2f MB, peak pages %u, created %u, overflow %u, dedicated %u\n",
+		(double)uploadStats.m_peakFrameBytes / (1024.0 * 1024.0), uploadStats.m_peakPagesInUse,
+		uploadStats.m_pagesCreated, uploadStats.m_overflowPages, uploadStats.m_dedicatedPages);
+	delete m_uploadAllocator;
+	m_uploadAllocator = nullptr;
+
+	DescriptorAllocatorStats textureDescStats = m_textureDescriptors.GetStats();
+	DescriptorAllocatorStats sdfDescStats = m_sdfDescriptors.GetStats();
+	DebuggerPrintf("[DX12Renderer] descriptors: textures %d/%d (peak %d, %d free ranges), SDF %d/%d (peak %d), transient peak %d/%d per frame, failed %u\n",
+		textureDescStats.m_allocated, textureDescStats.m_capacity, textureDescStats.m_peakAllocated, textureDescStats.m_freeRangeCount,
+		sdfDescStats.m_allocated, sdfDescStats.m_capacity, sdfDescStats.m_peakAllocated,
+		m_transientDescriptors.GetPeakFrameUsage(), m_transientDescriptors.GetCountPerFrame(),
+		textureDescStats.m_failedAllocations + sdfDescStats.m_failedAllocations + m_transientDescriptors.GetFailedAllocations());
+
 	for (int scIdx = 0; scIdx < SURFACE_CACHE_TYPE_COUNT; scIdx++)
 	{
 		m_surfaceCaches[scIdx].Shutdown();
@@ -498,6 +582,7 @@ void DX12Renderer::ShutDown()
 		tex = nullptr;
 	}
 	m_loadedTextures.clear();
+	m_textureLookup.Clear();
 	for (Shader* shader : m_loadedShaders)
 	{
 		delete shader;
@@ -1037,6 +1122,32 @@ void DX12Renderer::DrawIndexedVertexBuffer(VertexBuffer* vbo, IndexBuffer* ibo,
 	m_currentDrawIndex ++;
 }
 
+void DX12Renderer::UploadInstanceData(const InstanceData* instances, unsigned int instanceCount)
+{
+	if (instanceCount == 0)
+		return;
+	// upload page 按 fence 回收，本帧的 draw 读完之前不会被覆盖
+	unsigned int size = instanceCount * (unsigned int)sizeof(InstanceData);
+	FrameUploadAllocation allocation = m_uploadAllocator->Upload(instances, size, 16);
+	GUARANTEE_OR_DIE(allocation.IsValid(), "Failed to allocate upload memory for InstanceData");
+
+	m_instanceBufferView.BufferLocation = allocation.m_gpuAddress;
+	m_instanceBufferView.StrideInBytes = sizeof(InstanceData);
+	m_instanceBufferView.SizeInBytes = size;
+}
+
+void DX12Renderer::DrawIndexBufferInstanced(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, unsigned int firstInstance, unsigned int instanceCount, unsigned int startIndex)
+{
+	GUARANTEE_OR_DIE((firstInstance + instanceCount) * sizeof(InstanceData) <= m_instanceBufferView.SizeInBytes, "Instanced draw reads past this frame's InstanceData");
+
+	SetGraphicsStatesIfChanged();
+	BindVertexBuffer(vbo);
+	BindIndexBuffer(ibo);
+	m_commandList->IASetVertexBuffers(1, 1, &m_instanceBufferView);
+	m_commandList->DrawIndexedInstanced(indexCount, instanceCount, startIndex, 0, firstInstance);
+	m_currentDrawIndex ++;
+}
+
 Shader* DX12Renderer::CreateShader(char const* shaderName, VertexType type)
 {
 	Shader* test = GetShaderByName(shaderName);
@@ -1088,6 +1199,27 @@ Shader* DX12Renderer::CreateShader(char const* shaderName, char const* shaderSou
 		{ "BITANGENT", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 		{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
 	};
+	static D3D12_INPUT_ELEMENT_DESC inputElementDescsForPCUTBNInstanced[] =
+	{
+		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT , D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT , D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "TANGENT", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "BITANGENT", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "INSTANCE_TRANSFORM", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{ "INSTANCE_TRANSFORM", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{ "INSTANCE_TRANSFORM", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{ "INSTANCE_COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 1, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 }
+	};
+	static D3D12_INPUT_ELEMENT_DESC inputElementDescsForPCUTBNPacked[] =
+	{
+		{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT , D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT , D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "TANGENT", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+	};
 
 	shader->m_dx12VertexShader = vertexShader;
 	shader->m_dx12PixelShader = pixelShader;
@@ -1102,6 +1234,16 @@ Shader* DX12Renderer::CreateShader(char const* shaderName, char const* shaderSou
 		shader->m_inputLayoutForVertex->pInputElementDescs = inputElementDescsForPCUTBN;
 		shader->m_inputLayoutForVertex->NumElements = _countof(inputElementDescsForPCUTBN);
 	}
+	else if (type == VertexType::VERTEX_PCUTBN_PACKED)
+	{
+		shader->m_inputLayoutForVertex->pInputElementDescs = inputElementDescsForPCUTBNPacked;
+		shader->m_inputLayoutForVertex->NumElements = _countof(inputElementDescsForPCUTBNPacked);
+	}
+	else if (type == VertexType::VERTEX_PCUTBN_INSTANCED)
+	{
+		shader->m_inputLayoutForVertex->pInputElementDescs = inputElementDescsForPCUTBNInstanced;
+		shader->m_inputLayoutForVertex->NumElements = _countof(inputElementDescsForPCUTBNInstanced);
+	}
 
 	shader->m_shaderIndex = (int)m_loadedShaders.size();
 
@@ -1212,7 +1354,7 @@ void DX12Renderer::CopyCPUToGPU(void const* data, unsigned int size, VertexBuffe
 	vbo->m_dx12VertexBuffer->Unmap(0, nullptr);
 
 	vbo->m_vertexBufferView.BufferLocation = vbo->m_dx12VertexBuffer->GetGPUVirtualAddress();
-	vbo->m_vertexBufferView.StrideInBytes = sizeof(Vertex_PCUTBN);
+	vbo->m_vertexBufferView.StrideInBytes = vbo->m_stride;
 	vbo->m_vertexBufferView.SizeInBytes = (UINT)size;
 }
 
@@ -1225,7 +1367,7 @@ void DX12Renderer::CopyCPUToGPU(const void* data, unsigned int size, IndexBuffer
 	ibo->m_dx12IndexBuffer->Unmap(0, nullptr);
 
 	ibo->m_indexBufferView.BufferLocation = ibo->m_dx12IndexBuffer->GetGPUVirtualAddress();
-	ibo->m_indexBufferView.Format = DXGI_FORMAT_R32_UINT;
+	ibo->m_indexBufferView.Format = (ibo->m_stride == sizeof(uint16_t)) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
 	ibo->m_indexBufferView.SizeInBytes = (UINT)size;
 }
 
@@ -1293,14 +1435,7 @@ BitmapFont* DX12Renderer::CreateOrGetBitmapFont(char const* bitmapFontFilePathWi
 
 Texture* DX12Renderer::GetTextureByFileName(char const* imageFilePath)
 {
-	for (int i = 0; i < m_loadedTextures.size(); i++)
-	{
-		if (m_loadedTextures[i] && m_loadedTextures[i]->GetImageFilePath() == imageFilePath)
-		{
-			return m_loadedTextures[i];
-		}
-	}
-	return nullptr;
+	return m_textureLookup.Find(imageFilePath);
 }
 
 Image* DX12Renderer::CreateImageFromFile(char const* filePath)
@@ -1313,9 +1448,13 @@ Texture* DX12Renderer::CreateTextureFromImage(Image const& image)
 	Texture* newTexture = new Texture();
 	newTexture->m_dimensions = image.GetDimensions();
 	
-	newTexture->m_textureDescIndex = (int)m_loadedTextures.size();
-
-	GUARANTEE_OR_DIE(newTexture->m_textureDescIndex < 200, Stringf("Cannot create more than %d textures!", 200));
+	// 不再用 m_loadedTextures.size()：DestroyTexture 之后 size 会变小，会和还活着的贴图撞下标
+	DescriptorRange descriptor = m_textureDescriptors.Allocate(1);
+	if (!descriptor.IsValid())
+	{
+		ERROR_AND_DIE(Stringf("Cannot create more than %d live textures!", MAX_TEXTURE_COUNT));
+	}
+	newTexture->m_textureDescIndex = descriptor.m_index;
 
 	IntVec2 dims = image.GetDimensions();
 	int rowPitch = dims.x * 4; // 4 bytes per pixel (RGBA8)
@@ -1399,9 +1538,227 @@ Texture* DX12Renderer::CreateTextureFromImage(Image const& image)
 	return newTexture;
 }
 
+Texture* DX12Renderer::CreateTextureFromMipChain(ImageMipChain const& mipChain, int residentMip)
+{
+	GUARANTEE_OR_DIE(mipChain.IsValid(), Stringf("CreateTextureFromMipChain failed for \"%s\" - empty mip chain", mipChain.m_name.c_str()));
+
+	Texture* newTexture = new Texture();
+	newTexture->m_name = mipChain.m_name;
+	newTexture->m_dimensions = mipChain.GetDimensions(0);
+	newTexture->m_mipLevelCount = mipChain.GetLevelCount();
+	UpdateTextureMips(newTexture, mipChain, residentMip);
+	return newTexture;
+}
+
+Texture* DX12Renderer::CreateTextureFromCompressedMipChain(CompressedMipChain const& mipChain, int residentMip)
+{
+	GUARANTEE_OR_DIE(mipChain.IsValid(), Stringf("CreateTextureFromCompressedMipChain failed for \"%s\" - empty mip chain", mipChain.m_name.c_str()));
+
+	Texture* newTexture = new Texture();
+	newTexture->m_name = mipChain.m_name;
+	newTexture->m_dimensions = mipChain.GetDimensions(0);
+	newTexture->m_mipLevelCount = mipChain.GetLevelCount();
+	UpdateTextureMips(newTexture, mipChain, residentMip);
+	return newTexture;
+}
+
+void DX12Renderer::UpdateTextureMips(Texture* texture, ImageMipChain const& mipChain, int residentMip)
+{
+	GUARANTEE_OR_DIE(residentMip >= 0 && residentMip < mipChain.GetLevelCount(), Stringf("UpdateTextureMips failed for \"%s\" - no level %d", texture->m_name.c_str(), residentMip));
+
+	// 和 CreateTextureFromImage 一样每个 level 上下翻转
+	UINT levelCount = (UINT)(mipChain.GetLevelCount() - residentMip);
+	uint64_t firstTexel = mipChain.m_levels[residentMip].m_firstTexel;
+	std::vector<unsigned char> flippedData((mipChain.m_texels.size() - firstTexel) * 4);
+	std::vector<D3D12_SUBRESOURCE_DATA> levelData(levelCount);
+	for (UINT level = 0; level < levelCount; ++level)
+	{
+		IntVec2 dims = mipChain.GetDimensions(residentMip + level);
+		int rowPitch = dims.x * 4;
+		unsigned char const* src = reinterpret_cast<unsigned char const*>(mipChain.GetLevelTexels(residentMip + level));
+		unsigned char* dst = &flippedData[(mipChain.m_levels[residentMip + level].m_firstTexel - firstTexel) * 4];
+		for (int y = 0; y < dims.y; ++y)
+		{
+			memcpy(&dst[y * rowPitch], &src[(dims.y - 1 - y) * rowPitch], rowPitch);
+		}
+		levelData[level].pData = dst;
+		levelData[level].RowPitch = rowPitch;
+		levelData[level].SlicePitch = (LONG_PTR)rowPitch * dims.y;
+	}
+	CreateTextureLevels(texture, DXGI_FORMAT_R8G8B8A8_UNORM, mipChain.GetDimensions(residentMip), levelData);
+	texture->m_residentMip = residentMip;
+}
+
+void DX12Renderer::UpdateTextureMips(Texture* texture, CompressedMipChain const& mipChain, int residentMip)
+{
+	GUARANTEE_OR_DIE(residentMip >= 0 && residentMip < mipChain.GetLevelCount(), Stringf("UpdateTextureMips failed for \"%s\" - no level %d", texture->m_name.c_str(), residentMip));
+
+	// block 没法逐行翻转，cook 时已经按 DX12 的方向编码（BlockCompressionSettings::m_flipVertically）
+	UINT levelCount = (UINT)(mipChain.GetLevelCount() - residentMip);
+	std::vector<D3D12_SUBRESOURCE_DATA> levelData(levelCount);
+	for (UINT level = 0; level < levelCount; ++level)
+	{
+		IntVec2 dims = mipChain.GetDimensions(residentMip + level);
+		UINT rowPitch = GetBlockRowPitch(mipChain.m_format, dims.x);
+		levelData[level].pData = mipChain.GetLevelBytes(residentMip + level);
+		levelData[level].RowPitch = rowPitch;
+		levelData[level].SlicePitch = (LONG_PTR)rowPitch * ((dims.y + 3) / 4);
+	}
+	CreateTextureLevels(texture, GetBlockDXGIFormat(mipChain.m_format), mipChain.GetDimensions(residentMip), levelData);
+	texture->m_residentMip = residentMip;
+}
+
+void DX12Renderer::DropTextureMips(Texture* texture, int residentMip)
+{
+	int dropCount = residentMip - texture->m_residentMip;
+	if (texture->m_dx12Texture == nullptr || dropCount <= 0)
+		return;
+
+	D3D12_RESOURCE_DESC resourceDescription = texture->m_dx12Texture->GetDesc();
+	if (dropCount >= (int)resourceDescription.MipLevels)
+		return;
+
+	// 留下的 level 在显存里直接拷，不用回头读文件
+	resourceDescription.Width = std::max<UINT64>(1, resourceDescription.Width >> dropCount);
+	resourceDescription.Height = std::max<UINT>(1, resourceDescription.Height >> dropCount);
+	resourceDescription.MipLevels = (UINT16)(resourceDescription.MipLevels - dropCount);
+
+	ID3D12Resource* newResource = nullptr;
+	D3D12_HEAP_PROPERTIES properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+	HRESULT hr = m_device->CreateCommittedResource(&properties, D3D12_HEAP_FLAG_NONE, &resourceDescription,
+		D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&newResource));
+	GUARANTEE_OR_DIE(SUCCEEDED(hr) && newResource != nullptr, Stringf("DropTextureMips failed for \"%s\".", texture->m_name.c_str()));
+
+	CD3DX12_RESOURCE_BARRIER toCopySource = CD3DX12_RESOURCE_BARRIER::Transition(texture->m_dx12Texture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_SOURCE);
+	m_commandList->ResourceBarrier(1, &toCopySource);
+	for (UINT level = 0; level < resourceDescription.MipLevels; ++level)
+	{
+		CD3DX12_TEXTURE_COPY_LOCATION destination(newResource, level);
+		CD3DX12_TEXTURE_COPY_LOCATION source(texture->m_dx12Texture, level + dropCount);
+		m_commandList->CopyTextureRegion(&destination, 0, 0, 0, &source, nullptr);
+	}
+	CD3DX12_RESOURCE_BARRIER toShaderResource = CD3DX12_RESOURCE_BARRIER::Transition(newResource, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	m_commandList->ResourceBarrier(1, &toShaderResource);
+
+	RetireTextureResources(texture);
+	texture->m_dx12Texture = newResource;
+	std::wstring texName = L"Texture_" + std::to_wstring(texture->m_textureDescIndex);
+	texture->m_dx12Texture->SetName(texName.c_str());
+	CreateTextureView(texture, resourceDescription.Format, resourceDescription.MipLevels);
+	texture->m_residentMip = residentMip;
+}
+
+void DX12Renderer::CreateTextureLevels(Texture* texture, DXGI_FORMAT format, IntVec2 const& dimensions, std::vector<D3D12_SUBRESOURCE_DATA> const& levelData)
+{
+	// 流送时替换旧资源，Texture* 不变；旧的资源和 descriptor 等本帧结束再放
+	RetireTextureResources(texture);
+	UINT levelCount = (UINT)levelData.size();
+
+	D3D12_RESOURCE_DESC resourceDescription = {};
+	resourceDescription.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	resourceDescription.Alignment = 0;
+	resourceDescription.Width = dimensions.x;
+	resourceDescription.Height = dimensions.y;
+	resourceDescription.DepthOrArraySize = 1;
+	resourceDescription.MipLevels = (UINT16)levelCount;
+	resourceDescription.Format = format;
+	resourceDescription.SampleDesc.Count = 1;
+	resourceDescription.SampleDesc.Quality = 0;
+	resourceDescription.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+	resourceDescription.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	D3D12_HEAP_PROPERTIES properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+	HRESULT hr = m_device->CreateCommittedResource(&properties, D3D12_HEAP_FLAG_NONE, &resourceDescription,
+		D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&texture->m_dx12Texture));
+	GUARANTEE_OR_DIE(SUCCEEDED(hr) && texture->m_dx12Texture != nullptr, "Cannot create mip chain texture committed resource!");
+
+	UINT64 textureUploadBufferSize;
+	m_device->GetCopyableFootprints(&resourceDescription, 0, levelCount, 0, nullptr, nullptr, nullptr, &textureUploadBufferSize);
+
+	properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	D3D12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(textureUploadBufferSize);
+	hr = m_device->CreateCommittedResource(&properties, D3D12_HEAP_FLAG_NONE, &resourceDesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&texture->m_textureBufferUploadHeap));
+	GUARANTEE_OR_DIE(SUCCEEDED(hr), "Cannot create mip chain texture upload heap!");
+
+	UpdateSubresources(m_commandList, texture->m_dx12Texture, texture->m_textureBufferUploadHeap, 0, 0, levelCount, const_cast<D3D12_SUBRESOURCE_DATA*>(levelData.data()));
+
+	CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(texture->m_dx12Texture, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	m_commandList->ResourceBarrier(1, &barrier);
+
+	CreateTextureView(texture, format, levelCount);
+	std::wstring texName = L"Texture_" + std::to_wstring(texture->m_textureDescIndex);
+	texture->m_dx12Texture->SetName(texName.c_str());
+	std::wstring upName = L"TextureUpload_" + std::to_wstring(texture->m_textureDescIndex);
+	texture->m_textureBufferUploadHeap->SetName(upName.c_str());
+}
+
+void DX12Renderer::CreateTextureView(Texture* texture, DXGI_FORMAT format, UINT levelCount)
+{
+	DescriptorRange descriptor = m_textureDescriptors.Allocate(1);
+	if (!descriptor.IsValid())
+	{
+		ERROR_AND_DIE(Stringf("Cannot create more than %d live textures!", MAX_TEXTURE_COUNT));
+	}
+	texture->m_textureDescIndex = descriptor.m_index;
+
+	CD3DX12_CPU_DESCRIPTOR_HANDLE descriptorHandle(m_cbvSrvDescHeap->GetCPUDescriptorHandleForHeapStart(),
+	                                               NUM_CONSTANT_BUFFERS +
+	                                               texture->m_textureDescIndex, m_scuDescriptorSize);
+
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.Format = format;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MipLevels = levelCount;
+	m_device->CreateShaderResourceView(texture->m_dx12Texture, &srvDesc, descriptorHandle);
+}
+
+void DX12Renderer::RetireTextureResources(Texture* texture)
+{
+	// 本帧的 command list 可能还引用它：资源走 temp 列表，descriptor 等本帧的 fence
+	if (texture->m_dx12Texture)
+		m_currentFrameTempResources.push_back(texture->m_dx12Texture);
+	if (texture->m_textureBufferUploadHeap)
+		m_currentFrameTempResources.push_back(texture->m_textureBufferUploadHeap);
+	texture->m_dx12Texture = nullptr;
+	texture->m_textureBufferUploadHeap = nullptr;
+
+	if (texture->m_textureDescIndex >= 0)
+	{
+		DescriptorRange descriptor;
+		descriptor.m_index = texture->m_textureDescIndex;
+		descriptor.m_count = 1;
+		m_textureDescriptors.FreeDeferred(descriptor, m_uploadFrameFence + 1);
+		texture->m_textureDescIndex = -1;
+	}
+}
+
 void DX12Renderer::PushBackNewTextureManually(Texture* const tex)
 {
 	m_loadedTextures.push_back(tex);
+	m_textureLookup.Add(tex);
+}
+
+void DX12Renderer::DestroyTexture(Texture* texture)
+{
+	if (texture == nullptr || texture == m_defaultTexture || texture == m_defaultNormalTexture || texture == m_defaultSpecTexture)
+		return;
+
+	for (int i = 0; i < (int)m_loadedTextures.size(); i++)
+	{
+		if (m_loadedTextures[i] == texture)
+		{
+			m_loadedTextures.erase(m_loadedTextures.begin() + i);
+			break;
+		}
+	}
+	m_textureLookup.Remove(texture, m_loadedTextures);
+	if (m_currentTexture == texture)
+		m_currentTexture = nullptr;
+
+	RetireTextureResources(texture);
+	delete texture;
 }
 
 void DX12Renderer::BindTexture(const Texture* texture, int slot)
@@ -1948,6 +2305,14 @@ void DX12Renderer::EndGBufferPass()
 		m_surfaceCaches[i].SwapBuffers();
 	}
 
+	// CPU 光照查询用的 probe：这里录 copy，EndFrame 等 GPU 跑完再读
+	uint32_t readbackInterval = m_giSystem ? m_giSystem->m_config.m_probeReadbackInterval : 0;
+	if (readbackInterval > 0 && m_radianceCache.m_initialized && ++m_framesSinceProbeReadback >= readbackInterval)
+	{
+		m_radianceCache.CopyProbesToReadback(m_commandList);
+		m_framesSinceProbeReadback = 0;
+	}
+
 	m_radianceCache.SwapBuffers();  //TODO 暂时还只有一层
 }
 
@@ -2209,14 +2574,15 @@ SDFTexture3D* DX12Renderer::GenerateSDFOnGPU(const std::vector<Vertex_PCUTBN>& v
 	m_currentFrameTempResources.push_back(bvhNodeBuffer);
 	m_currentFrameTempResources.push_back(bvhTriBuffer);
     
-    if (m_nextSDFDescriptorIndex >= SDF_TEXTURE_SRV_BASE + MAX_SDF_TEXTURE_COUNT)
+    DescriptorRange sdfDescriptor = m_sdfDescriptors.Allocate(1);
+    if (!sdfDescriptor.IsValid())
     {
         DebuggerPrintf("[DX12] SDF descriptor pool exhausted!\n");
         delete sdf;
         return nullptr;
     }
     
-    sdf->m_srvHeapIndex = m_nextSDFDescriptorIndex++;
+    sdf->m_srvHeapIndex = sdfDescriptor.m_index;
     
     CD3DX12_CPU_DESCRIPTOR_HANDLE finalSrvHandle(
         m_cbvSrvDescHeap->GetCPUDescriptorHandleForHeapStart(),
@@ -2238,6 +2604,105 @@ SDFTexture3D* DX12Renderer::GenerateSDFOnGPU(const std::vector<Vertex_PCUTBN>& v
     return sdf;
 }
 
+SDFTexture3D* DX12Renderer::CreateSDFTextureFromData(const float* distances, int resolution)
+{
+	DescriptorRange sdfDescriptor = m_sdfDescriptors.Allocate(1);
+	if (!sdfDescriptor.IsValid())
+	{
+		DebuggerPrintf("[DX12] SDF descriptor pool exhausted!\n");
+		return nullptr;
+	}
+
+	SDFTexture3D* sdf = new SDFTexture3D(resolution);
+	sdf->m_srvHeapIndex = sdfDescriptor.m_index;
+
+	D3D12_RESOURCE_DESC texDesc = {};
+	texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE3D;
+	texDesc.Width = resolution;
+	texDesc.Height = resolution;
+	texDesc.DepthOrArraySize = (UINT16)resolution;
+	texDesc.MipLevels = 1;
+	texDesc.Format = DXGI_FORMAT_R32_FLOAT;
+	texDesc.SampleDesc.Count = 1;
+	texDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+	texDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	CD3DX12_HEAP_PROPERTIES defaultProps(D3D12_HEAP_TYPE_DEFAULT);
+	HRESULT hr = m_device->CreateCommittedResource(&defaultProps, D3D12_HEAP_FLAG_NONE, &texDesc,
+		D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&sdf->m_sdfTexture3D));
+	GUARANTEE_OR_DIE(SUCCEEDED(hr), "Create SDF Texture3D failed");
+	sdf->m_sdfTexture3D->SetName(L"SDFTexture3D_Cooked");
+
+	UINT64 uploadSize = 0;
+	m_device->GetCopyableFootprints(&texDesc, 0, 1, 0, nullptr, nullptr, nullptr, &uploadSize);
+	CD3DX12_HEAP_PROPERTIES uploadProps(D3D12_HEAP_TYPE_UPLOAD);
+	D3D12_RESOURCE_DESC uploadDesc = CD3DX12_RESOURCE_DESC::Buffer(uploadSize);
+	ID3D12Resource* uploadBuffer = nullptr;
+	hr = m_device->CreateCommittedResource(&uploadProps, D3D12_HEAP_FLAG_NONE, &uploadDesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadBuffer));
+	GUARANTEE_OR_DIE(SUCCEEDED(hr), "Create SDF upload buffer failed");
+	uploadBuffer->SetName(L"SDFTexture3D_CookedUpload");
+
+	D3D12_SUBRESOURCE_DATA sdfData = {};
+	sdfData.pData = distances;
+	sdfData.RowPitch = (LONG_PTR)resolution * sizeof(float);
+	sdfData.SlicePitch = sdfData.RowPitch * resolution;
+	UpdateSubresources(m_commandList, sdf->m_sdfTexture3D, uploadBuffer, 0, 0, 1, &sdfData);
+
+	auto toSRV = CD3DX12_RESOURCE_BARRIER::Transition(
+		sdf->m_sdfTexture3D,
+		D3D12_RESOURCE_STATE_COPY_DEST,
+		D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
+	);
+	m_commandList->ResourceBarrier(1, &toSRV);
+	m_currentFrameTempResources.push_back(uploadBuffer);
+
+	CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle(
+		m_cbvSrvDescHeap->GetCPUDescriptorHandleForHeapStart(),
+		sdf->m_srvHeapIndex,
+		m_scuDescriptorSize
+	);
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+	srvDesc.Format = DXGI_FORMAT_R32_FLOAT;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE3D;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.Texture3D.MipLevels = 1;
+	srvDesc.Texture3D.MostDetailedMip = 0;
+	m_device->CreateShaderResourceView(sdf->m_sdfTexture3D, &srvDesc, srvHandle);
+
+	m_loadedSDFs.push_back(sdf);
+	DebuggerPrintf("[DX12] Cooked SDF uploaded (resolution=%d), SRV index: %d\n", resolution, sdf->m_srvHeapIndex);
+	return sdf;
+}
+
+void DX12Renderer::DestroySDFTexture(SDFTexture3D* sdf)
+{
+	if (sdf == nullptr)
+		return;
+
+	for (int i = 0; i < (int)m_loadedSDFs.size(); i++)
+	{
+		if (m_loadedSDFs[i] == sdf)
+		{
+			m_loadedSDFs.erase(m_loadedSDFs.begin() + i);
+			break;
+		}
+	}
+
+	// m_tempBuffers 在生成那一帧已经进了 temp 列表，这里不能再 release 一次
+	sdf->m_tempBuffers.clear();
+	if (sdf->m_sdfTexture3D)
+		m_currentFrameTempResources.push_back(sdf->m_sdfTexture3D);
+	sdf->m_sdfTexture3D = nullptr;
+
+	DescriptorRange descriptor;
+	descriptor.m_index = sdf->m_srvHeapIndex;
+	descriptor.m_count = 1;
+	m_sdfDescriptors.FreeDeferred(descriptor, m_uploadFrameFence + 1);
+
+	delete sdf;
+}
+
 ID3D12Resource* DX12Renderer::CreateStructuredBuffer(SDFTexture3D* sdfOwner, const void* data, size_t numElements, size_t elementSize,
 	const wchar_t* debugName)
 {
@@ -2313,6 +2778,16 @@ D3D12_GPU_DESCRIPTOR_HANDLE DX12Renderer::GetSRVHandle(uint32_t index)
 	);
 }
 
+DescriptorRange DX12Renderer::AllocateTransientDescriptors(int count)
+{
+	DescriptorRange range = m_transientDescriptors.Allocate(count);
+	if (!range.IsValid())
+	{
+		DebuggerPrintf("[DX12] transient descriptors exhausted (%d per frame)!\n", MAX_TRANSIENT_DESCRIPTORS_PER_FRAME);
+	}
+	return range;
+}
+
 void DX12Renderer::CreateGraphicsRootSignature()
 {
 	HRESULT hr;
@@ -2927,7 +3402,7 @@ void DX12Renderer::CaptureDirtySurfaceCards(uint32_t maxCardsPerFrame)
 		CaptureSingleCard(obj, card, instance, templ);
                 
 		card->m_pendingUpdate = false;
-		card->m_lastTouchedFrame = m_frameIndex;
+		card->m_lastTouchedFrame = m_giSystem->m_scene->GetCurrentFrame();   // 跟 Scene 的 LOD / 驱逐用同一个帧号
 		instance->m_isDirty = false;
 
 		if (card->m_pendingRealloc)
@@ -3993,50 +4468,23 @@ void DX12Renderer::BindRadianceCacheForGraphics(RadianceCache* cache)
 	// 			   probeBufferAddress);
 }
 
-void DX12Renderer::UploadBufferData(ID3D12Resource* dstBuffer, const void* srcData, uint32_t dataSize) //TODO
+void DX12Renderer::UploadBufferData(ID3D12Resource* dstBuffer, const void* srcData, uint32_t dataSize)
 {
 	if (!dstBuffer || !srcData || dataSize == 0)
 		return;
-    
-	// 创建 Upload Heap
-	D3D12_HEAP_PROPERTIES uploadHeapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-	D3D12_RESOURCE_DESC uploadBufferDesc = CD3DX12_RESOURCE_DESC::Buffer(dataSize);
-    
-	ID3D12Resource* uploadBuffer = nullptr;
-	HRESULT hr = m_device->CreateCommittedResource(
-		&uploadHeapProps,
-		D3D12_HEAP_FLAG_NONE,
-		&uploadBufferDesc,
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(&uploadBuffer)
-	);
-    
-	if (FAILED(hr))
-	{
-		ERROR_AND_DIE("[DX12Renderer] Failed to create upload buffer!");
-	}
-    
-	// Map and copy
-	void* mappedData = nullptr;
-	hr = uploadBuffer->Map(0, nullptr, &mappedData);
-	if (SUCCEEDED(hr))
-	{
-		memcpy(mappedData, srcData, dataSize);
-		uploadBuffer->Unmap(0, nullptr);
-	}
-    
+
+	// 从当前帧的 upload 页里切一段，页在本帧 fence 完成后回收
+	FrameUploadAllocation staging = m_uploadAllocator->Upload(srcData, dataSize, 16);
+	GUARANTEE_OR_DIE(staging.IsValid(), "[DX12Renderer] Failed to allocate upload staging!");
+
 	// Transition dst to COPY_DEST
 	TransitionResource(dstBuffer, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
-    
+
 	// Copy
-	m_commandList->CopyResource(dstBuffer, uploadBuffer);
-    
+	m_commandList->CopyBufferRegion(dstBuffer, 0, (ID3D12Resource*)staging.m_resource, staging.m_offset, dataSize);
+
 	// Transition back to SRV
 	TransitionResource(dstBuffer, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    
-	// 暂时保存，在帧结束后释放
-	m_currentFrameTempResources.push_back(uploadBuffer);
 }
 
 void DX12Renderer::CreateCardBVHBuffers(const std::vector<GPUCardBVHNode>& nodes,
@@ -4251,6 +4699,7 @@ Texture* DX12Renderer::CreateTextureFromFile(char const* filePath)
 	newTexture->m_name = filePath;
 	
 	m_loadedTextures.push_back(newTexture);
+	m_textureLookup.Add(newTexture);
 	
 	return newTexture;
 }
@@ -14,6 +14,8 @@ using Microsoft::WRL::ComPtr;
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/RenderCommon.h"
+#include "Engine/Renderer/DescriptorAllocator.h"
+#include "Engine/Core/TextureResidency.h"
 
 #ifdef ENGINE_DX12_RENDERER
 
@@ -73,6 +75,7 @@ struct ID3D12Fence;
 
 class BVH;
 class SDFTexture3D;
+class FrameUploadAllocator;
 
 class DX12Renderer
 {
@@ -108,7 +111,15 @@ public:
 	Texture* CreateOrGetTextureFromFile(char const* imageFilePath);
 	Texture* CreateTextureFromFile(char const* imageFilePath);
 	Texture* CreateTextureFromImage(Image const& image);
+	Texture* CreateTextureFromMipChain(ImageMipChain const& mipChain, int residentMip = 0);
+	Texture* CreateTextureFromCompressedMipChain(CompressedMipChain const& mipChain, int residentMip = 0);
+	// texture residency: re-create the texture from residentMip down, or drop the finer levels
+	// with a GPU copy. The Texture* stays valid, the old resource is released after this frame
+	void UpdateTextureMips(Texture* texture, ImageMipChain const& mipChain, int residentMip);
+	void UpdateTextureMips(Texture* texture, CompressedMipChain const& mipChain, int residentMip);
+	void DropTextureMips(Texture* texture, int residentMip);
 	void PushBackNewTextureManually(Texture* const tex);
+	void DestroyTexture(Texture* texture);	// resource + descriptor are released once the GPU is done with this frame
 	//Texture* CreateTextureFromData(char const* name, IntVec2 dimensions, int bytesPerTexel, uint8_t* texelData);
 	Texture* GetTextureByFileName(char const* imageFilePath);
 	Image* CreateImageFromFile(char const* imageFilePath);
@@ -144,6 +155,8 @@ public:
 	void DrawVertexIndexArray(const std::vector<Vertex_PCU>& verts, const std::vector<unsigned int>& indices);
 	void DrawVertexIndexArray(const std::vector<Vertex_PCUTBN>& verts, const std::vector<unsigned int>& indices);
 	void DrawIndexedVertexBuffer( VertexBuffer* vbo, IndexBuffer* ibo, int indexCount, int indexOffset = 0 );
+	void UploadInstanceData(const InstanceData* instances, unsigned int instanceCount);
+	void DrawIndexBufferInstanced(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, unsigned int firstInstance, unsigned int instanceCount, unsigned int startIndex = 0);
 
 	// States
 	void SetBlendMode(BlendMode blendMode);
@@ -178,6 +191,8 @@ public:
 	   const BVH& bvh,
 	   const AABB3& bounds,
 	   int resolution);
+	// offline 烘好的距离（StaticMesh::GetCookedSDFDistances），直接上传，不跑 compute
+	SDFTexture3D* CreateSDFTextureFromData(const float* distances, int resolution);
 	ID3D12Resource* CreateStructuredBuffer(
 		SDFTexture3D* sdfOwner,
 		const void* data,
@@ -185,7 +200,11 @@ public:
 		size_t elementSize,
 		const wchar_t* debugName);
 	
+	void DestroySDFTexture(SDFTexture3D* sdf);
+	
 	D3D12_GPU_DESCRIPTOR_HANDLE GetSRVHandle(uint32_t index);
+	// 本帧有效的临时 descriptor table；失败返回 invalid range
+	DescriptorRange AllocateTransientDescriptors(int count);
 
 	//Compute Pass
 	//void CreateSurfaceCacheComputePSO();
@@ -270,6 +289,10 @@ private:
 	void	ImGuiShutDown();
 
 	size_t GetConstantBufferSize(int cbSlot);
+
+	void CreateTextureLevels(Texture* texture, DXGI_FORMAT format, IntVec2 const& dimensions, std::vector<D3D12_SUBRESOURCE_DATA> const& levelData);
+	void CreateTextureView(Texture* texture, DXGI_FORMAT format, UINT levelCount);
+	void RetireTextureResources(Texture* texture);
 	
 protected:
 	RendererConfig m_config;
@@ -330,6 +353,7 @@ protected:
 	std::array<IndexBuffer*, FRAME_BUFFER_COUNT> m_frameIndexBuffers;
 	
 	std::vector<Texture*> m_loadedTextures;
+	TextureLookupTable m_textureLookup;		// GetTextureByFileName
 	std::vector<BitmapFont*> m_loadedFonts;
 	Texture* m_defaultTexture = nullptr; //default diffuse map
 	Texture* m_defaultNormalTexture = nullptr; //default normal map
@@ -374,7 +398,6 @@ protected:
 	ID3D12PipelineState* m_sdfGenerationPSO = nullptr;
 	ID3D12RootSignature* m_sdfGenerationRootSignature = nullptr;
 	std::vector<SDFTexture3D*> m_loadedSDFs; 
-	int m_nextSDFDescriptorIndex = SDF_TEXTURE_SRV_BASE;
 
 	//Compute surface cache
 	//ID3D12PipelineState* m_surfaceCacheExtractPSO = nullptr;
@@ -389,6 +412,8 @@ protected:
 	//Radiance Cache
 	ID3D12PipelineState* m_radianceCacheUpdatePSO = nullptr;
 	RadianceCache m_radianceCache;
+	std::vector<RadianceProbeGPU> m_probeReadback;		// GISystem::SetProbeLighting 的输入，复用
+	uint32_t m_framesSinceProbeReadback = 0;
 	ID3D12Resource* m_cardBVHNodeBuffer = nullptr;
 	ID3D12Resource* m_cardBVHIndexBuffer = nullptr;
 	uint32_t m_cardBVHNodeCount = 0;
@@ -396,6 +421,17 @@ protected:
 
 	std::vector<ID3D12Resource*> m_currentFrameTempResources;
 	std::vector<ID3D12Resource*> m_previousFrameTempResources;
+
+	// Staging for UploadBufferData: pages retire on m_uploadFrameFence instead of one committed resource per upload
+	FrameUploadAllocator* m_uploadAllocator = nullptr;
+	uint64_t m_uploadFrameFence = 0;
+	D3D12_VERTEX_BUFFER_VIEW m_instanceBufferView = {};	// this frame's InstanceData (upload pages), IA slot 1
+
+	// Descriptor heap: texture indices are relative to TEXTURE_SRV_START (shader g_textures[id]), SDF indices are absolute.
+	// Frees wait on m_uploadFrameFence like the upload pages
+	DescriptorRangeAllocator m_textureDescriptors = DescriptorRangeAllocator(0, MAX_TEXTURE_COUNT);
+	DescriptorRangeAllocator m_sdfDescriptors = DescriptorRangeAllocator(SDF_TEXTURE_SRV_BASE, MAX_SDF_TEXTURE_COUNT);
+	DescriptorLinearAllocator m_transientDescriptors = DescriptorLinearAllocator(TRANSIENT_DESCRIPTOR_BASE, MAX_TRANSIENT_DESCRIPTORS_PER_FRAME, FRAME_BUFFER_COUNT);
 };
 #endif
 
@@ -0,0 +1,200 @@
+#include "DescriptorAllocator.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include <iterator>
+
+DescriptorRangeAllocator::DescriptorRangeAllocator(int baseIndex, int capacity)
+{
+    Initialize(baseIndex, capacity);
+}
+
+void DescriptorRangeAllocator::Initialize(int baseIndex, int capacity)
+{
+    GUARANTEE_OR_DIE(capacity > 0, "DescriptorRangeAllocator: capacity must be > 0");
+
+    m_baseIndex = baseIndex;
+    m_capacity = capacity;
+    m_freeByOffset.clear();
+    m_freeBySize.clear();
+    m_pendingFrees.clear();
+    m_allocated = 0;
+    m_peakAllocated = 0;
+    m_allocationCount = 0;
+    m_failedAllocations = 0;
+
+    InsertFreeRange(0, capacity);
+}
+
+void DescriptorRangeAllocator::InsertFreeRange(int offset, int count)
+{
+    m_freeByOffset.insert(std::make_pair(offset, count));
+    m_freeBySize.insert(std::make_pair(count, offset));
+}
+
+void DescriptorRangeAllocator::RemoveFreeRange(int offset, int count)
+{
+    m_freeByOffset.erase(std::make_pair(offset, count));
+    m_freeBySize.erase(std::make_pair(count, offset));
+}
+
+DescriptorRange DescriptorRangeAllocator::Allocate(int count)
+{
+    DescriptorRange range;
+    if (count <= 0)
+        return range;
+
+    // best fit；同样大小取最低的下标
+    auto it = m_freeBySize.lower_bound(std::make_pair(count, -1));
+    if (it == m_freeBySize.end())
+    {
+        m_failedAllocations++;
+        return range;
+    }
+
+    int freeCount = it->first;
+    int freeOffset = it->second;
+    RemoveFreeRange(freeOffset, freeCount);
+    if (freeCount > count)
+    {
+        InsertFreeRange(freeOffset + count, freeCount - count);
+    }
+
+    range.m_index = m_baseIndex + freeOffset;
+    range.m_count = count;
+
+    m_allocated += count;
+    if (m_allocated > m_peakAllocated)
+        m_peakAllocated = m_allocated;
+    m_allocationCount++;
+    return range;
+}
+
+void DescriptorRangeAllocator::FreeImmediate(DescriptorRange const& range)
+{
+    if (!range.IsValid())
+        return;
+
+    int offset = range.m_index - m_baseIndex;
+    int count = range.m_count;
+    GUARANTEE_OR_DIE(offset >= 0 && offset + count <= m_capacity, "DescriptorRangeAllocator: freeing a range it does not own");
+
+    // 和左右相邻的空闲段合并
+    auto next = m_freeByOffset.lower_bound(std::make_pair(offset, 0));
+    GUARANTEE_OR_DIE(next == m_freeByOffset.end() || next->first >= offset + count, "DescriptorRangeAllocator: double free");
+    if (next != m_freeByOffset.begin())
+    {
+        auto prev = std::prev(next);
+        GUARANTEE_OR_DIE(prev->first + prev->second <= offset, "DescriptorRangeAllocator: double free");
+        if (prev->first + prev->second == offset)
+        {
+            offset = prev->first;
+            count += prev->second;
+            RemoveFreeRange(prev->first, prev->second);
+        }
+    }
+    next = m_freeByOffset.lower_bound(std::make_pair(offset + count, 0));
+    if (next != m_freeByOffset.end() && next->first == offset + count)
+    {
+        count += next->second;
+        RemoveFreeRange(next->first, next->second);
+    }
+    InsertFreeRange(offset, count);
+
+    m_allocated -= range.m_count;
+}
+
+void DescriptorRangeAllocator::FreeDeferred(DescriptorRange const& range, uint64_t fenceValue)
+{
+    if (!range.IsValid())
+        return;
+
+    PendingFree pending;
+    pending.m_range = range;
+    pending.m_fenceValue = fenceValue;
+    m_pendingFrees.push_back(pending);
+}
+
+void DescriptorRangeAllocator::ProcessDeferredFrees(uint64_t completedFenceValue)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < m_pendingFrees.size(); i++)
+    {
+        if (m_pendingFrees[i].m_fenceValue <= completedFenceValue)
+        {
+            FreeImmediate(m_pendingFrees[i].m_range);
+        }
+        else
+        {
+            m_pendingFrees[kept++] = m_pendingFrees[i];
+        }
+    }
+    m_pendingFrees.resize(kept);
+}
+
+DescriptorAllocatorStats DescriptorRangeAllocator::GetStats() const
+{
+    DescriptorAllocatorStats stats;
+    stats.m_capacity = m_capacity;
+    stats.m_allocated = m_allocated;
+    stats.m_peakAllocated = m_peakAllocated;
+    stats.m_freeRangeCount = (int)m_freeByOffset.size();
+    stats.m_largestFreeRange = m_freeBySize.empty() ? 0 : m_freeBySize.rbegin()->first;
+    stats.m_allocationCount = m_allocationCount;
+    stats.m_failedAllocations = m_failedAllocations;
+
+    for (PendingFree const& pending : m_pendingFrees)
+    {
+        stats.m_pendingFree += pending.m_range.m_count;
+    }
+
+    int totalFree = m_capacity - m_allocated;
+    if (totalFree > 0)
+    {
+        stats.m_fragmentation = 1.f - (float)stats.m_largestFreeRange / (float)totalFree;
+    }
+    return stats;
+}
+
+//-----------------------------------------------------------------------------------------------
+DescriptorLinearAllocator::DescriptorLinearAllocator(int baseIndex, int countPerFrame, int frameCount)
+{
+    Initialize(baseIndex, countPerFrame, frameCount);
+}
+
+void DescriptorLinearAllocator::Initialize(int baseIndex, int countPerFrame, int frameCount)
+{
+    m_baseIndex = baseIndex;
+    m_countPerFrame = countPerFrame;
+    m_frameCount = frameCount;
+    m_frameIndex = 0;
+    m_offset = 0;
+    m_peakUsage = 0;
+    m_failedAllocations = 0;
+}
+
+void DescriptorLinearAllocator::BeginFrame(int frameIndex)
+{
+    // 同一个 frameIndex 的上一轮已经被 swap chain 的 fence 等过了
+    GUARANTEE_OR_DIE(frameIndex >= 0 && frameIndex < m_frameCount, "DescriptorLinearAllocator: bad frame index");
+    m_frameIndex = frameIndex;
+    m_offset = 0;
+}
+
+DescriptorRange DescriptorLinearAllocator::Allocate(int count)
+{
+    DescriptorRange range;
+    if (count <= 0 || m_offset + count > m_countPerFrame)
+    {
+        m_failedAllocations++;
+        return range;
+    }
+
+    range.m_index = m_baseIndex + m_frameIndex * m_countPerFrame + m_offset;
+    range.m_count = count;
+    m_offset += count;
+    if (m_offset > m_peakUsage)
+        m_peakUsage = m_offset;
+    return range;
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdint>
+#include <set>
+#include <vector>
+
+//==============================================================================
+// DescriptorAllocator - descriptor heap 的下标分配（不碰 device）
+//==============================================================================
+// DescriptorRangeAllocator: persistent ranges inside [base, base + capacity).
+//   Best-fit free list with coalescing (ties go to the lowest index, so a heap that
+//   never frees hands out the same indices as the old "next index++" counters).
+//   Free() is deferred: the range goes on a queue keyed by the frame fence and only
+//   returns to the free list once that fence has completed, so a descriptor table the
+//   GPU is still reading is never overwritten.
+//
+// DescriptorLinearAllocator: transient per-frame ranges. The region is split into one
+//   partition per frame in flight; BeginFrame(frameIndex) rewinds that frame's partition.
+//
+// Both work on plain indices; DX12Renderer turns them into CPU/GPU handles.
+//==============================================================================
+
+static constexpr int INVALID_DESCRIPTOR_INDEX = -1;
+
+struct DescriptorRange
+{
+    int m_index = INVALID_DESCRIPTOR_INDEX;     // absolute heap index of the first descriptor
+    int m_count = 0;
+
+    bool IsValid() const { return m_index != INVALID_DESCRIPTOR_INDEX; }
+};
+
+struct DescriptorAllocatorStats
+{
+    int m_capacity = 0;
+    int m_allocated = 0;                 // live + waiting on a fence
+    int m_peakAllocated = 0;
+    int m_pendingFree = 0;               // descriptors on the deferred-free queue
+    int m_freeRangeCount = 0;
+    int m_largestFreeRange = 0;
+    float m_fragmentation = 0.f;         // 1 - largest free range / total free
+    uint32_t m_allocationCount = 0;
+    uint32_t m_failedAllocations = 0;
+};
+
+class DescriptorRangeAllocator
+{
+public:
+    DescriptorRangeAllocator() = default;
+    DescriptorRangeAllocator(int baseIndex, int capacity);
+
+    void Initialize(int baseIndex, int capacity);
+
+    DescriptorRange Allocate(int count = 1);
+    void FreeImmediate(DescriptorRange const& range);   // caller guarantees the GPU is done with it
+    void FreeDeferred(DescriptorRange const& range, uint64_t fenceValue);
+    void ProcessDeferredFrees(uint64_t completedFenceValue);
+
+    bool Contains(int index) const { return index >= m_baseIndex && index < m_baseIndex + m_capacity; }
+    int GetBaseIndex() const { return m_baseIndex; }
+    int GetCapacity() const { return m_capacity; }
+    DescriptorAllocatorStats GetStats() const;
+
+private:
+    void InsertFreeRange(int offset, int count);
+    void RemoveFreeRange(int offset, int count);
+
+private:
+    struct PendingFree
+    {
+        DescriptorRange m_range;
+        uint64_t m_fenceValue = 0;
+    };
+
+    int m_baseIndex = 0;
+    int m_capacity = 0;
+
+    std::set<std::pair<int, int>> m_freeByOffset;   // (offset, count)
+    std::set<std::pair<int, int>> m_freeBySize;     // (count, offset)
+    std::vector<PendingFree> m_pendingFrees;
+
+    int m_allocated = 0;
+    int m_peakAllocated = 0;
+    uint32_t m_allocationCount = 0;
+    uint32_t m_failedAllocations = 0;
+};
+
+class DescriptorLinearAllocator
+{
+public:
+    DescriptorLinearAllocator() = default;
+    DescriptorLinearAllocator(int baseIndex, int countPerFrame, int frameCount);
+
+    void Initialize(int baseIndex, int countPerFrame, int frameCount);
+
+    void BeginFrame(int frameIndex);
+    DescriptorRange Allocate(int count);
+
+    int GetCurrentFrameUsage() const { return m_offset; }
+    int GetPeakFrameUsage() const { return m_peakUsage; }
+    int GetCountPerFrame() const { return m_countPerFrame; }
+    uint32_t GetFailedAllocations() const { return m_failedAllocations; }
+
+private:
+    int m_baseIndex = 0;
+    int m_countPerFrame = 0;
+    int m_frameCount = 0;
+    int m_frameIndex = 0;
+    int m_offset = 0;
+    int m_peakUsage = 0;
+    uint32_t m_failedAllocations = 0;
+};
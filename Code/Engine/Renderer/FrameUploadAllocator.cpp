@@ -0,0 +1,266 @@
+#include "FrameUploadAllocator.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    uint64_t AlignUp64(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    void AtomicMax(std::atomic<uint64_t>& target, uint64_t value)
+    {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+}
+
+FrameUploadAllocator::FrameUploadAllocator(FrameUploadAllocatorConfig const& config)
+    : m_config(config)
+{
+    GUARANTEE_OR_DIE(m_config.m_pageSize > 0, "FrameUploadAllocator: page size must be > 0");
+    GUARANTEE_OR_DIE((m_config.m_defaultAlignment & (m_config.m_defaultAlignment - 1)) == 0,
+        "FrameUploadAllocator: alignment must be a power of two");
+}
+
+FrameUploadAllocator::~FrameUploadAllocator()
+{
+    ReleaseAll();
+}
+
+//-----------------------------------------------------------------------------------------------
+bool FrameUploadAllocator::TryAllocateFromPage(FrameUploadPage* page, uint64_t size, uint64_t alignment, FrameUploadAllocation& outAllocation)
+{
+    uint64_t oldOffset = page->m_offset.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        uint64_t alignedOffset = AlignUp64(oldOffset, alignment);
+        uint64_t newOffset = alignedOffset + size;
+        if (newOffset > page->m_size)
+            return false;
+
+        if (page->m_offset.compare_exchange_weak(oldOffset, newOffset, std::memory_order_relaxed))
+        {
+            outAllocation.m_cpuAddress = page->m_cpuBase + alignedOffset;
+            outAllocation.m_gpuAddress = page->m_gpuBase ? page->m_gpuBase + alignedOffset : 0;
+            outAllocation.m_resource = page->m_resource;
+            outAllocation.m_offset = alignedOffset;
+            outAllocation.m_size = size;
+
+            m_frameBytes.fetch_add(newOffset - oldOffset, std::memory_order_relaxed);
+            return true;
+        }
+    }
+}
+
+FrameUploadAllocation FrameUploadAllocator::Allocate(uint64_t size, uint64_t alignment)
+{
+    FrameUploadAllocation allocation;
+    if (size == 0)
+        return allocation;
+
+    if (alignment == 0)
+        alignment = m_config.m_defaultAlignment;
+    GUARANTEE_OR_DIE((alignment & (alignment - 1)) == 0, "FrameUploadAllocator: alignment must be a power of two");
+
+    m_frameAllocations.fetch_add(1, std::memory_order_relaxed);
+    AtomicMax(m_largestAllocation, size);
+
+    // 快路径：当前页上一次 CAS
+    FrameUploadPage* page = m_currentPage.load(std::memory_order_acquire);
+    if (page && TryAllocateFromPage(page, size, alignment, allocation))
+        return allocation;
+
+    std::lock_guard<std::mutex> lock(m_pageMutex);
+
+    // 等锁期间别的线程可能已经换了页
+    FrameUploadPage* current = m_currentPage.load(std::memory_order_acquire);
+    if (current && current != page && TryAllocateFromPage(current, size, alignment, allocation))
+        return allocation;
+
+    if (size + alignment > m_config.m_pageSize)
+    {
+        // 超过一页的请求单独给一页，不替换当前页
+        FrameUploadPage* dedicated = AcquirePage(size + alignment);
+        dedicated->m_isDedicated = true;
+        m_framePages.push_back(dedicated);
+        m_stats.m_dedicatedPages++;
+        bool fits = TryAllocateFromPage(dedicated, size, alignment, allocation);
+        GUARANTEE_OR_DIE(fits, "FrameUploadAllocator: dedicated page too small");
+        return allocation;
+    }
+
+    if (current)
+    {
+        m_stats.m_overflowPages++;
+    }
+
+    FrameUploadPage* newPage = AcquirePage(m_config.m_pageSize);
+    m_framePages.push_back(newPage);
+    bool fits = TryAllocateFromPage(newPage, size, alignment, allocation);
+    GUARANTEE_OR_DIE(fits, "FrameUploadAllocator: fresh page too small");
+    m_currentPage.store(newPage, std::memory_order_release);
+    return allocation;
+}
+
+FrameUploadAllocation FrameUploadAllocator::Upload(void const* data, uint64_t size, uint64_t alignment)
+{
+    FrameUploadAllocation allocation = Allocate(size, alignment);
+    if (allocation.IsValid() && data)
+    {
+        memcpy(allocation.m_cpuAddress, data, (size_t)size);
+    }
+    return allocation;
+}
+
+//-----------------------------------------------------------------------------------------------
+FrameUploadPage* FrameUploadAllocator::AcquirePage(uint64_t minSize)
+{
+    if (minSize <= m_config.m_pageSize && !m_freePages.empty())
+    {
+        FrameUploadPage* page = m_freePages.back();
+        m_freePages.pop_back();
+        page->m_offset.store(0, std::memory_order_relaxed);
+        return page;
+    }
+
+    FrameUploadPage* page = new FrameUploadPage();
+    page->m_size = (minSize > m_config.m_pageSize) ? AlignUp64(minSize, m_config.m_defaultAlignment) : m_config.m_pageSize;
+
+    if (m_config.m_createPage)
+    {
+        bool created = m_config.m_createPage(*page);
+        GUARANTEE_OR_DIE(created && page->m_cpuBase, "FrameUploadAllocator: failed to create upload page");
+    }
+    else
+    {
+        page->m_cpuBase = new uint8_t[page->m_size];
+    }
+
+    m_stats.m_pagesCreated++;
+    return page;
+}
+
+void FrameUploadAllocator::DestroyPage(FrameUploadPage* page)
+{
+    if (m_config.m_createPage)
+    {
+        if (m_config.m_destroyPage)
+        {
+            m_config.m_destroyPage(*page);
+        }
+    }
+    else
+    {
+        delete[] page->m_cpuBase;
+    }
+
+    delete page;
+    m_stats.m_pagesDestroyed++;
+}
+
+//-----------------------------------------------------------------------------------------------
+void FrameUploadAllocator::BeginFrame(uint64_t completedFenceValue)
+{
+    ReclaimRetiredPages(completedFenceValue);
+
+    m_frameBytes.store(0, std::memory_order_relaxed);
+    m_frameAllocations.store(0, std::memory_order_relaxed);
+}
+
+void FrameUploadAllocator::EndFrame(uint64_t frameFenceValue)
+{
+    std::lock_guard<std::mutex> lock(m_pageMutex);
+
+    m_lastFramePageCount = (uint32_t)m_framePages.size();
+    for (FrameUploadPage* page : m_framePages)
+    {
+        page->m_retireFence = frameFenceValue;
+        m_retiredPages.push_back(page);
+    }
+    m_framePages.clear();
+    m_currentPage.store(nullptr, std::memory_order_release);
+
+    uint64_t frameBytes = m_frameBytes.load(std::memory_order_relaxed);
+    m_stats.m_lastFrameBytes = frameBytes;
+    m_stats.m_peakFrameBytes = std::max(m_stats.m_peakFrameBytes, frameBytes);
+    m_stats.m_peakPagesInUse = std::max(m_stats.m_peakPagesInUse, (uint32_t)m_retiredPages.size());
+}
+
+void FrameUploadAllocator::ReclaimRetiredPages(uint64_t completedFenceValue)
+{
+    std::lock_guard<std::mutex> lock(m_pageMutex);
+
+    // 至少留够上一帧的页数，稳态下不反复创建/销毁；尖峰过后多出来的页会被释放
+    size_t maxFreePages = std::max((size_t)m_config.m_maxFreePages, (size_t)m_lastFramePageCount);
+
+    size_t kept = 0;
+    for (FrameUploadPage* page : m_retiredPages)
+    {
+        if (page->m_retireFence > completedFenceValue)
+        {
+            m_retiredPages[kept++] = page;
+            continue;
+        }
+
+        if (page->m_isDedicated || m_freePages.size() >= maxFreePages)
+        {
+            DestroyPage(page);
+        }
+        else
+        {
+            page->m_offset.store(0, std::memory_order_relaxed);
+            m_freePages.push_back(page);
+        }
+    }
+    m_retiredPages.resize(kept);
+}
+
+void FrameUploadAllocator::ReleaseAll()
+{
+    std::lock_guard<std::mutex> lock(m_pageMutex);
+
+    for (FrameUploadPage* page : m_framePages)
+    {
+        DestroyPage(page);
+    }
+    for (FrameUploadPage* page : m_retiredPages)
+    {
+        DestroyPage(page);
+    }
+    for (FrameUploadPage* page : m_freePages)
+    {
+        DestroyPage(page);
+    }
+    m_framePages.clear();
+    m_retiredPages.clear();
+    m_freePages.clear();
+    m_currentPage.store(nullptr, std::memory_order_release);
+}
+
+FrameUploadStats FrameUploadAllocator::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_pageMutex);
+
+    FrameUploadStats stats = m_stats;
+    stats.m_frameBytes = m_frameBytes.load(std::memory_order_relaxed);
+    stats.m_frameAllocations = m_frameAllocations.load(std::memory_order_relaxed);
+    stats.m_largestAllocation = m_largestAllocation.load(std::memory_order_relaxed);
+    stats.m_pagesInUse = (uint32_t)(m_framePages.size() + m_retiredPages.size());
+    stats.m_peakPagesInUse = std::max(stats.m_peakPagesInUse, stats.m_pagesInUse);
+    stats.m_freePages = (uint32_t)m_freePages.size();
+    return stats;
+}
+
+uint64_t FrameUploadAllocator::GetRecommendedReservation() const
+{
+    FrameUploadStats stats = GetStats();
+    return (uint64_t)stats.m_peakPagesInUse * m_config.m_pageSize;
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+//==============================================================================
+// FrameUploadAllocator - 每帧线性上传分配器（按 fence 回收）
+//==============================================================================
+// Transient per-frame data (constants, immediate vertices, staging for buffer
+// uploads) is bump-allocated from fixed-size pages. Any thread may Allocate():
+// the fast path is one CAS on the current page's offset, only a page switch takes
+// the mutex. A request that does not fit moves to a fresh page (overflow) instead
+// of dying, and anything larger than a page gets a dedicated page.
+//
+// 生命周期：
+//   BeginFrame(completedFence)  回收 fence 已完成的页
+//   Allocate / Upload           任意线程
+//   EndFrame(frameFence)        本帧用过的页挂上 frameFence，GPU 跑完之前不会复用
+// BeginFrame / EndFrame must not overlap with Allocate calls on other threads.
+//
+// The allocator never touches a device: pages come from FrameUploadPageCreateFunction
+// (an upload heap on DX12, plain memory by default), so it runs on the CPU with a
+// simulated fence. Peak usage is tracked to size the fixed ring reservations.
+//==============================================================================
+
+struct FrameUploadPage
+{
+    uint8_t* m_cpuBase = nullptr;
+    uint64_t m_gpuBase = 0;              // 0 for CPU-only pages
+    void* m_resource = nullptr;          // backend handle, e.g. ID3D12Resource*
+    uint64_t m_size = 0;
+
+    std::atomic<uint64_t> m_offset{ 0 };
+    uint64_t m_retireFence = 0;
+    bool m_isDedicated = false;
+};
+
+struct FrameUploadAllocation
+{
+    uint8_t* m_cpuAddress = nullptr;
+    uint64_t m_gpuAddress = 0;
+    void* m_resource = nullptr;
+    uint64_t m_offset = 0;               // byte offset inside m_resource
+    uint64_t m_size = 0;
+
+    bool IsValid() const { return m_cpuAddress != nullptr; }
+};
+
+// Fill m_cpuBase / m_gpuBase / m_resource for a page of page.m_size bytes
+typedef std::function<bool(FrameUploadPage& page)> FrameUploadPageCreateFunction;
+typedef std::function<void(FrameUploadPage& page)> FrameUploadPageDestroyFunction;
+
+struct FrameUploadAllocatorConfig
+{
+    uint64_t m_pageSize = 4 * 1024 * 1024;
+    uint64_t m_defaultAlignment = 256;   // D3D12 CBV placement alignment
+    uint32_t m_maxFreePages = 8;         // or the last frame's page count if larger; extra retired pages are destroyed
+
+    FrameUploadPageCreateFunction m_createPage;     // empty: CPU memory
+    FrameUploadPageDestroyFunction m_destroyPage;
+};
+
+struct FrameUploadStats
+{
+    uint64_t m_frameBytes = 0;           // frame in progress, alignment padding included
+    uint32_t m_frameAllocations = 0;
+    uint64_t m_lastFrameBytes = 0;
+    uint64_t m_peakFrameBytes = 0;       // high-water mark of a single frame
+    uint64_t m_largestAllocation = 0;
+
+    uint32_t m_pagesInUse = 0;           // current frame + waiting on a fence
+    uint32_t m_peakPagesInUse = 0;
+    uint32_t m_freePages = 0;
+    uint32_t m_pagesCreated = 0;
+    uint32_t m_pagesDestroyed = 0;
+    uint32_t m_overflowPages = 0;        // page switches in the middle of a frame
+    uint32_t m_dedicatedPages = 0;       // allocations larger than a page
+};
+
+class FrameUploadAllocator
+{
+public:
+    explicit FrameUploadAllocator(FrameUploadAllocatorConfig const& config = FrameUploadAllocatorConfig());
+    ~FrameUploadAllocator();
+
+    FrameUploadAllocator(FrameUploadAllocator const& copy) = delete;
+    FrameUploadAllocator& operator=(FrameUploadAllocator const& copy) = delete;
+
+    void BeginFrame(uint64_t completedFenceValue);
+    void EndFrame(uint64_t frameFenceValue);
+    void ReclaimRetiredPages(uint64_t completedFenceValue);
+    void ReleaseAll();                   // GPU must be idle
+
+    // alignment 0 = config default; must be a power of two
+    FrameUploadAllocation Allocate(uint64_t size, uint64_t alignment = 0);
+    FrameUploadAllocation Upload(void const* data, uint64_t size, uint64_t alignment = 0);
+
+    FrameUploadStats GetStats() const;
+    uint64_t GetPageSize() const { return m_config.m_pageSize; }
+
+    // 峰值页数 * 页大小，可以直接作为固定 ring 的预留大小参考
+    uint64_t GetRecommendedReservation() const;
+
+private:
+    FrameUploadPage* AcquirePage(uint64_t minSize);
+    void DestroyPage(FrameUploadPage* page);
+    bool TryAllocateFromPage(FrameUploadPage* page, uint64_t size, uint64_t alignment, FrameUploadAllocation& outAllocation);
+
+private:
+    FrameUploadAllocatorConfig m_config;
+
+    std::atomic<FrameUploadPage*> m_currentPage{ nullptr };
+    mutable std::mutex m_pageMutex;
+    std::vector<FrameUploadPage*> m_framePages;      // used by the frame in progress
+    std::vector<FrameUploadPage*> m_retiredPages;    // waiting on m_retireFence
+    std::vector<FrameUploadPage*> m_freePages;
+    uint32_t m_lastFramePageCount = 0;
+
+    std::atomic<uint64_t> m_frameBytes{ 0 };
+    std::atomic<uint32_t> m_frameAllocations{ 0 };
+    std::atomic<uint64_t> m_largestAllocation{ 0 };
+    FrameUploadStats m_stats;
+};
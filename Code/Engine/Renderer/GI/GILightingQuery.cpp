@@ -0,0 +1,284 @@
+﻿#include "GILightingQuery.h"
+
+#include "Engine/Core/Time.hpp"
+#include "Engine/Job/JobSystem.h"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <cmath>
+
+static float GetDistanceToAABB3(AABB3 const& box, Vec3 const& point)
+{
+    float dx = MaxF(MaxF(box.m_mins.x - point.x, 0.f), point.x - box.m_maxs.x);
+    float dy = MaxF(MaxF(box.m_mins.y - point.y, 0.f), point.y - box.m_maxs.y);
+    float dz = MaxF(MaxF(box.m_mins.z - point.z, 0.f), point.z - box.m_maxs.z);
+    return sqrtf(dx * dx + dy * dy + dz * dz);
+}
+
+static void MakeBasisFromNormal(Vec3 const& normal, Vec3& outTangent, Vec3& outBitangent)
+{
+    Vec3 helper = (fabsf(normal.z) < 0.9f) ? Vec3(0.f, 0.f, 1.f) : Vec3(1.f, 0.f, 0.f);
+    outTangent = CrossProduct3D(helper, normal).GetNormalized();
+    outBitangent = CrossProduct3D(normal, outTangent);
+}
+
+//-----------------------------------------------------------------------------------------------
+void GILightingQuerySystem::ClearSDFInstances()
+{
+    m_sdfInstances.clear();
+}
+
+void GILightingQuerySystem::AddSDFInstance(SDFInstance const& instance)
+{
+    if (!instance.m_data || instance.m_resolution == 0)
+        return;
+
+    SDFQueryInstance queryInstance;
+    queryInstance.m_instance = instance;
+
+    // World-space bounds for a cheap lower bound on the distance before touching the volume
+    std::vector<Vec3> corners = instance.m_bounds.GetCorners();
+    Vec3 first = instance.m_worldTransform.TransformPosition3D(corners[0]);
+    queryInstance.m_worldBounds = AABB3(first, first);
+    for (size_t i = 1; i < corners.size(); i++)
+    {
+        queryInstance.m_worldBounds.StretchToIncludePoint(instance.m_worldTransform.TransformPosition3D(corners[i]));
+    }
+
+    m_sdfInstances.push_back(queryInstance);
+}
+
+void GILightingQuerySystem::SetProbes(Vec3 const* positions, SH9Color const* probeSH, uint32_t count)
+{
+    m_probePositions.assign(positions, positions + count);
+    m_probeSH.assign(probeSH, probeSH + count);
+
+    m_probeGrid.Initialize(MaxF(m_config.m_probeSearchRadius * 0.5f, 0.5f), MaxI((int)count, 1));
+    for (uint32_t i = 0; i < count; i++)
+    {
+        m_probeGrid.Insert(i, positions[i]);
+    }
+    m_probeGrid.Rebuild();
+}
+
+//-----------------------------------------------------------------------------------------------
+float GILightingQuerySystem::SampleSDF(Vec3 const& worldPos) const
+{
+    float minDistance = FLT_MAX;
+
+    for (SDFQueryInstance const& queryInstance : m_sdfInstances)
+    {
+        // The surface lives inside the bounds, so the box distance is a safe lower bound
+        if (GetDistanceToAABB3(queryInstance.m_worldBounds, worldPos) >= minDistance)
+            continue;
+
+        SDFInstance const& instance = queryInstance.m_instance;
+        Vec3 localPos = instance.m_inverseTransform.TransformPosition3D(worldPos);
+        float distance = instance.Sample(localPos);
+        if (distance == FLT_MAX)
+        {
+            // Outside the volume: projecting onto a convex box never increases the distance to
+            // anything inside it, so the value at the clamped point is still a lower bound
+            AABB3 const& bounds = instance.m_bounds;
+            Vec3 clamped(GetClamped(localPos.x, bounds.m_mins.x, bounds.m_maxs.x),
+                         GetClamped(localPos.y, bounds.m_mins.y, bounds.m_maxs.y),
+                         GetClamped(localPos.z, bounds.m_mins.z, bounds.m_maxs.z));
+            distance = MaxF(GetDistanceToAABB3(bounds, localPos), instance.Sample(clamped));
+        }
+
+        minDistance = MinF(minDistance, distance);
+    }
+
+    return minDistance;
+}
+
+float GILightingQuerySystem::TraceConeVisibility(Vec3 const& origin, Vec3 const& direction, int sampleBudget, int& outSamplesUsed) const
+{
+    float const minRadius = m_config.m_surfaceBias;
+    float visibility = 1.f;
+    float t = m_config.m_surfaceBias;
+    int samples = 0;
+
+    while (t < m_config.m_maxTraceDistance && samples < sampleBudget)
+    {
+        float distance = SampleSDF(origin + direction * t);
+        samples++;
+
+        float coneRadius = MaxF(t * m_config.m_coneAperture, minRadius);
+        visibility = MinF(visibility, GetClamped(distance / coneRadius, 0.f, 1.f));
+        if (visibility < 0.01f)
+            break;
+
+        // Never step less than half the cone footprint: the cone is blurry at that scale anyway
+        t += MaxF(distance, coneRadius * 0.5f);
+    }
+
+    outSamplesUsed = samples;
+    return visibility;
+}
+
+float GILightingQuerySystem::TraceOcclusion(Vec3 const& worldPos, Vec3 const& normal, int& outSamplesUsed, bool& outBudgetExhausted) const
+{
+    outSamplesUsed = 0;
+    outBudgetExhausted = false;
+    if (m_sdfInstances.empty())
+        return 0.f;
+
+    Vec3 directions[8];
+    float weights[8];
+    int coneCount = 0;
+
+    if (normal.IsNearlyZero())
+    {
+        Vec3 const axes[6] = { Vec3(1.f, 0.f, 0.f), Vec3(-1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f),
+                               Vec3(0.f, -1.f, 0.f), Vec3(0.f, 0.f, 1.f), Vec3(0.f, 0.f, -1.f) };
+        for (int i = 0; i < 6; i++)
+        {
+            directions[coneCount] = axes[i];
+            weights[coneCount] = 1.f;
+            coneCount++;
+        }
+    }
+    else
+    {
+        Vec3 n = normal.GetNormalized();
+        Vec3 tangent;
+        Vec3 bitangent;
+        MakeBasisFromNormal(n, tangent, bitangent);
+
+        directions[coneCount] = n;
+        weights[coneCount] = 1.f;
+        coneCount++;
+
+        // Ring cones are cosine-weighted relative to the normal cone
+        int ringCount = MinI(MaxI(m_config.m_coneCount - 1, 0), 7);
+        float ringCos = CosDegrees(m_config.m_coneRingAngleDegrees);
+        float ringSin = SinDegrees(m_config.m_coneRingAngleDegrees);
+        for (int i = 0; i < ringCount; i++)
+        {
+            float angle = 360.f * (float)i / (float)ringCount;
+            Vec3 around = tangent * CosDegrees(angle) + bitangent * SinDegrees(angle);
+            directions[coneCount] = n * ringCos + around * ringSin;
+            weights[coneCount] = ringCos;
+            coneCount++;
+        }
+    }
+
+    int samplesPerCone = MaxI(1, m_config.m_maxSDFSamplesPerQuery / coneCount);
+    Vec3 origin = normal.IsNearlyZero() ? worldPos : worldPos + normal.GetNormalized() * m_config.m_surfaceBias;
+
+    float visibilitySum = 0.f;
+    float weightSum = 0.f;
+    for (int i = 0; i < coneCount; i++)
+    {
+        int samplesUsed = 0;
+        float visibility = TraceConeVisibility(origin, directions[i], samplesPerCone, samplesUsed);
+        if (samplesUsed >= samplesPerCone && visibility >= 0.01f)
+        {
+            outBudgetExhausted = true;
+        }
+
+        outSamplesUsed += samplesUsed;
+        visibilitySum += visibility * weights[i];
+        weightSum += weights[i];
+    }
+
+    return 1.f - visibilitySum / weightSum;
+}
+
+Vec3 GILightingQuerySystem::BlendProbeIrradiance(Vec3 const& worldPos, Vec3 const& normal, uint8_t& outProbesUsed) const
+{
+    static constexpr int MAX_BLEND_PROBES = 16;
+    outProbesUsed = 0;
+
+    ProbeNeighbor neighbors[MAX_BLEND_PROBES];
+    uint32_t k = (uint32_t)GetClamped((float)m_config.m_maxProbesPerQuery, 1.f, (float)MAX_BLEND_PROBES);
+    uint32_t count = m_probeGrid.QueryNearest(worldPos, m_config.m_probeSearchRadius, neighbors, k);
+    if (count == 0)
+        return m_config.m_fallbackIrradiance;
+
+    bool hasNormal = !normal.IsNearlyZero();
+    Vec3 n = hasNormal ? normal.GetNormalized() : Vec3();
+
+    SH9Color probes[MAX_BLEND_PROBES];
+    float weights[MAX_BLEND_PROBES];
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t probeIndex = neighbors[i].m_probeIndex;
+        float weight = 1.f / (neighbors[i].m_distanceSquared + 0.01f);
+
+        // Probes behind the surface are mostly seeing the other side of the wall
+        if (hasNormal && neighbors[i].m_distanceSquared > 1e-6f)
+        {
+            Vec3 toProbe = (m_probePositions[probeIndex] - worldPos) / sqrtf(neighbors[i].m_distanceSquared);
+            float facing = DotProduct3D(toProbe, n) * 0.5f + 0.5f;
+            weight *= MaxF(0.05f, facing * facing);
+        }
+
+        probes[i] = m_probeSH[probeIndex];
+        weights[i] = weight;
+    }
+
+    SH9Color blended;
+    BlendSH9(probes, weights, (int)count, blended);
+    outProbesUsed = (uint8_t)count;
+
+    if (hasNormal)
+        return EvaluateSH9Irradiance(blended, n);
+
+    // No surface: average irradiance over all directions is the DC term times PI
+    float const dcToIrradiance = 3.1415926535f * 0.282094792f;
+    return Vec3(blended.m_coeffs[0][0], blended.m_coeffs[0][1], blended.m_coeffs[0][2]) * dcToIrradiance;
+}
+
+//-----------------------------------------------------------------------------------------------
+float GILightingQuerySystem::SampleOcclusion(Vec3 const& worldPos) const
+{
+    int samplesUsed = 0;
+    bool budgetExhausted = false;
+    return TraceOcclusion(worldPos, Vec3(), samplesUsed, budgetExhausted);
+}
+
+Vec3 GILightingQuerySystem::SampleIrradiance(Vec3 const& worldPos, Vec3 const& normal) const
+{
+    GILightingQuery query;
+    query.m_worldPos = worldPos;
+    query.m_normal = normal;
+    return Sample(query).m_irradiance;
+}
+
+GILightingResult GILightingQuerySystem::Sample(GILightingQuery const& query) const
+{
+    GILightingResult result;
+
+    int samplesUsed = 0;
+    result.m_occlusion = TraceOcclusion(query.m_worldPos, query.m_normal, samplesUsed, result.m_budgetExhausted);
+    result.m_sdfSamplesUsed = (uint16_t)MinI(samplesUsed, 0xFFFF);
+
+    Vec3 irradiance = BlendProbeIrradiance(query.m_worldPos, query.m_normal, result.m_probesUsed);
+    result.m_irradiance = irradiance * (1.f - result.m_occlusion);
+
+    return result;
+}
+
+void GILightingQuerySystem::SampleBatch(GILightingQuery const* queries, GILightingResult* outResults, uint32_t count)
+{
+    double startTime = GetCurrentTimeSeconds();
+
+    ParallelFor(count, m_config.m_queriesPerJob, [this, queries, outResults](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            outResults[i] = Sample(queries[i]);
+        }
+    });
+
+    m_stats.m_lastBatchQueryCount = count;
+    m_stats.m_lastBatchSDFSamples = 0;
+    m_stats.m_lastBatchBudgetExhausted = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        m_stats.m_lastBatchSDFSamples += outResults[i].m_sdfSamplesUsed;
+        m_stats.m_lastBatchBudgetExhausted += outResults[i].m_budgetExhausted ? 1 : 0;
+    }
+    m_stats.m_lastBatchSeconds = GetCurrentTimeSeconds() - startTime;
+}
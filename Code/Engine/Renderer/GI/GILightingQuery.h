@@ -0,0 +1,101 @@
+﻿#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/SphericalHarmonics.h"
+#include "Engine/Renderer/Cache/ProbeHashGrid.h"
+#include "Engine/Scene/SDF/SDFCommon.h"
+
+// CPU lighting queries for gameplay (AI visibility, audio, dynamic object tinting).
+// Short SDF cone traces give occlusion, nearby radiance probes give irradiance.
+// No GPU dependency: server builds and headless tests get the same answers as the client.
+// In the engine GISystem feeds it: probes from the RadianceCache readback every
+// GIConfig::m_probeReadbackInterval frames, SDFs from the scene's cooked SDF volumes (GPU-generated
+// volumes have no CPU copy, so objects without a cook do not occlude).
+
+struct GILightingQueryConfig
+{
+    int m_coneCount = 5;                    // 1 along the normal + ring of (count-1) cones
+    float m_coneAperture = 0.577f;          // tan(cone half angle), ~30 degrees
+    float m_coneRingAngleDegrees = 55.f;    // tilt of the ring cones away from the normal
+    float m_surfaceBias = 0.05f;
+    float m_maxTraceDistance = 6.f;
+    int m_maxSDFSamplesPerQuery = 64;       // cost budget, split evenly across cones
+
+    float m_probeSearchRadius = 10.f;
+    int m_maxProbesPerQuery = 8;            // clamped to 1..16 (BlendProbeIrradiance blends from a stack buffer)
+    Vec3 m_fallbackIrradiance = Vec3(0.2f, 0.2f, 0.2f); // used when no probe is in range
+
+    uint32_t m_queriesPerJob = 128;
+};
+
+struct GILightingQuery
+{
+    Vec3 m_worldPos;
+    Vec3 m_normal; // zero = no surface, occlusion is traced over the full sphere
+};
+
+struct GILightingResult
+{
+    Vec3 m_irradiance;
+    float m_occlusion = 0.f;        // 0 = open, 1 = fully occluded
+    uint16_t m_sdfSamplesUsed = 0;
+    uint8_t m_probesUsed = 0;
+    bool m_budgetExhausted = false;
+};
+
+struct GILightingQueryStats
+{
+    uint32_t m_lastBatchQueryCount = 0;
+    uint64_t m_lastBatchSDFSamples = 0;
+    uint32_t m_lastBatchBudgetExhausted = 0;
+    double m_lastBatchSeconds = 0.0;
+};
+
+class GILightingQuerySystem
+{
+public:
+    GILightingQuerySystem() = default;
+    ~GILightingQuerySystem() = default;
+
+    void SetConfig(GILightingQueryConfig const& config) { m_config = config; }
+    GILightingQueryConfig const& GetConfig() const { return m_config; }
+
+    // Inputs are snapshots: they must not change while a batch is running
+    void ClearSDFInstances();
+    void AddSDFInstance(SDFInstance const& instance); // instances without CPU data are ignored
+    void SetProbes(Vec3 const* positions, SH9Color const* probeSH, uint32_t count);
+
+    float SampleSDF(Vec3 const& worldPos) const;
+    float SampleOcclusion(Vec3 const& worldPos) const;
+    Vec3 SampleIrradiance(Vec3 const& worldPos, Vec3 const& normal) const;
+    GILightingResult Sample(GILightingQuery const& query) const;
+
+    // Splits the batch over the job system's worker threads and blocks until done
+    void SampleBatch(GILightingQuery const* queries, GILightingResult* outResults, uint32_t count);
+
+    uint32_t GetSDFInstanceCount() const { return (uint32_t)m_sdfInstances.size(); }
+    uint32_t GetProbeCount() const { return (uint32_t)m_probePositions.size(); }
+    GILightingQueryStats const& GetStatistics() const { return m_stats; }
+
+private:
+    struct SDFQueryInstance
+    {
+        SDFInstance m_instance;
+        AABB3 m_worldBounds;
+    };
+
+    float TraceConeVisibility(Vec3 const& origin, Vec3 const& direction, int sampleBudget, int& outSamplesUsed) const;
+    float TraceOcclusion(Vec3 const& worldPos, Vec3 const& normal, int& outSamplesUsed, bool& outBudgetExhausted) const;
+    Vec3 BlendProbeIrradiance(Vec3 const& worldPos, Vec3 const& normal, uint8_t& outProbesUsed) const;
+
+private:
+    GILightingQueryConfig m_config;
+    GILightingQueryStats m_stats;
+
+    std::vector<SDFQueryInstance> m_sdfInstances;
+    std::vector<Vec3> m_probePositions;
+    std::vector<SH9Color> m_probeSH;
+    ProbeHashGrid m_probeGrid;
+};
@@ -15,6 +15,7 @@ extern Window* g_theWindow;
 
 GISystem::GISystem(const GIConfig& config)
 	: m_config(config)
+	, m_scene(nullptr)
 {
 	InitializeAtlasFreeList();
 
@@ -212,7 +213,7 @@ Vec3 GISystem::ReconstructWorldPosCPU(Vec2 screenPos, float depth, float screenW
 
 SurfaceCacheConstants GISystem::PrepareBasicCacheConstants(SurfaceCacheType type, size_t batchStart)
 {
-#ifdef ENGINE_DX11_RENDERER
+#if defined(ENGINE_DX11_RENDERER) || defined(ENGINE_NULL_RENDERER)
 	UNUSED(type)
 	UNUSED(batchStart)
 	SurfaceCacheConstants constants = {};
@@ -381,6 +382,54 @@ void GISystem::UpdateStatistics()
 	m_globalStats.m_memoryUsageMB = memoryMB;
 }
 
+Vec3 GISystem::SampleIrradiance(const Vec3& worldPos, const Vec3& normal)
+{
+	return m_lightingQuery.SampleIrradiance(worldPos, normal);
+}
+
+float GISystem::SampleOcclusion(const Vec3& worldPos)
+{
+	return m_lightingQuery.SampleOcclusion(worldPos);
+}
+
+void GISystem::SampleLightingBatch(const GILightingQuery* queries, GILightingResult* outResults, uint32_t count)
+{
+	m_lightingQuery.SampleBatch(queries, outResults, count);
+}
+
+void GISystem::UpdateLightingQueryInputs()
+{
+	m_lightingQuery.ClearSDFInstances();
+	if (!m_scene)
+		return;
+
+	// GPU 生成的 SDF 没有 CPU 副本 (m_data == nullptr)，会被直接跳过
+	for (auto& pair : m_scene->m_sdfInstances)
+	{
+		m_lightingQuery.AddSDFInstance(pair.second);
+	}
+}
+
+void GISystem::SetProbeLighting(const std::vector<RadianceProbeGPU>& probes)
+{
+	std::vector<Vec3> positions;
+	std::vector<SH9Color> probeSH;
+	positions.reserve(probes.size());
+	probeSH.reserve(probes.size());
+
+	for (const RadianceProbeGPU& probe : probes)
+	{
+		if (probe.Validity <= 0.0f)
+			continue;
+
+		positions.push_back(Vec3(probe.WorldPositionX, probe.WorldPositionY, probe.WorldPositionZ));
+		probeSH.emplace_back();
+		probeSH.back().SetFromChannels(probe.SH_R, probe.SH_G, probe.SH_B);
+	}
+
+	m_lightingQuery.SetProbes(positions.data(), probeSH.data(), (uint32_t)positions.size());
+}
+
 void GISystem::InitializeAtlasFreeList()
 {
 	m_tileUsageMap.clear();
@@ -457,7 +506,7 @@ void GISystem::FreeTiles(IntVec2 baseCoord, IntVec2 tileCount)
 
 Vec2 GISystem::WorldToScreen(const Vec3& worldPos)
 {
-#ifdef ENGINE_DX11_RENDERER
+#if defined(ENGINE_DX11_RENDERER) || defined(ENGINE_NULL_RENDERER)
 	UNUSED(worldPos)
 	return Vec2();
 #endif
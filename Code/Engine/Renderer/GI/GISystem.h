@@ -7,6 +7,7 @@
 #include "Engine/Renderer/DX12Renderer.hpp"
 #include "Engine/Renderer/RenderCommon.h"
 #include "Engine/Renderer/DXR/DXRAcceleration.h"
+#include "Engine/Renderer/GI/GILightingQuery.h"
 
 class CardBVH;
 class RadianceCacheManager;
@@ -65,8 +66,13 @@ public:
     void UpdateCardMetadata();
     const std::vector<SurfaceCardMetadata>& GetCurrentSurfaceCardMetadataCPU();
     
+    //CPU lighting queries (gameplay side, no GPU round trip)
     Vec3 SampleIrradiance(const Vec3& worldPos, const Vec3& normal);
     float SampleOcclusion(const Vec3& worldPos);
+    void SampleLightingBatch(const GILightingQuery* queries, GILightingResult* outResults, uint32_t count);
+    void UpdateLightingQueryInputs();   // snapshot scene SDFs with CPU data; Scene::Update calls it when they change
+    void SetProbeLighting(const std::vector<RadianceProbeGPU>& probes); // DX12Renderer::EndFrame, from the RadianceCache readback
+    GILightingQuerySystem& GetLightingQuery() { return m_lightingQuery; }
     
     void UpdateStatistics();
     const SurfaceCacheGlobalStats& GetStatistics() const { return m_globalStats; }
@@ -99,6 +105,8 @@ private:
     std::vector<uint32_t> m_dirtyCards;
     std::vector<SurfaceCardMetadata> m_cardMetadataCPU; 
 
+    GILightingQuerySystem m_lightingQuery;
+
     DXRAcceleration m_dxrAcceleration;
     bool m_dxrSupported = false;
 };
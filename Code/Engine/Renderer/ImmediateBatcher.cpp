@@ -0,0 +1,64 @@
+#include "ImmediateBatcher.h"
+
+#include <algorithm>
+#include <cstring>
+
+ImmediateBatcher::ImmediateBatcher()
+{
+    m_verts.reserve(4096);
+}
+
+bool IsIdentityModelTransform(Mat44 const& modelTransform)
+{
+    static Mat44 const s_identity;
+    return memcmp(modelTransform.m_values, s_identity.m_values, sizeof(s_identity.m_values)) == 0;
+}
+
+bool AreTransformsEqual(Mat44 const& a, Mat44 const& b)
+{
+    return memcmp(a.m_values, b.m_values, sizeof(a.m_values)) == 0;
+}
+
+void ImmediateBatcher::Append(int numVerts, Vertex_PCU const* verts, Mat44 const& modelTransform, Rgba8 const& modelColor)
+{
+    size_t start = m_verts.size();
+    m_verts.resize(start + (size_t)numVerts);
+    Vertex_PCU* dest = m_verts.data() + start;
+
+    bool identityTransform = IsIdentityModelTransform(modelTransform);
+    bool whiteColor = (modelColor == Rgba8::WHITE);
+    if (identityTransform && whiteColor)
+    {
+        std::copy(verts, verts + numVerts, dest);
+    }
+    else
+    {
+        for (int i = 0; i < numVerts; i++)
+        {
+            Vertex_PCU v = verts[i];
+            if (!identityTransform)
+            {
+                v.m_position = modelTransform.TransformPosition3D(v.m_position);
+            }
+            if (!whiteColor)
+            {
+                // 和 shader 里的 input.Color * ModelColor 一致（8bit 上四舍五入）
+                v.m_color.r = (unsigned char)(((int)v.m_color.r * (int)modelColor.r + 127) / 255);
+                v.m_color.g = (unsigned char)(((int)v.m_color.g * (int)modelColor.g + 127) / 255);
+                v.m_color.b = (unsigned char)(((int)v.m_color.b * (int)modelColor.b + 127) / 255);
+                v.m_color.a = (unsigned char)(((int)v.m_color.a * (int)modelColor.a + 127) / 255);
+            }
+            dest[i] = v;
+        }
+        m_frameStats.m_pretransformedVerts += (uint32_t)numVerts;
+    }
+
+    m_frameStats.m_batchedDraws++;
+    m_frameStats.m_batchedVerts += (uint32_t)numVerts;
+}
+
+void ImmediateBatcher::EndFrame()
+{
+    m_lastFrameStats = m_frameStats;
+    m_frameStats = ImmediateBatchStats();
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/Mat44.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class Shader;
+class Texture;
+
+//==============================================================================
+// ImmediateBatcher - DrawVertexArray(Vertex_PCU) 的合批
+//==============================================================================
+// DebugRender / DevConsole / BitmapFont text / UI widgets each hand the Renderer a
+// handful of verts at a time. The Renderer facade appends them here while the bound
+// (shader, texture, blend, depth, sampler, rasterizer) stays the same, and submits the
+// whole stream as one draw when that state changes, before any other draw / pass /
+// constant change, and at EndFrame.
+//
+// The model transform and model color are baked into the verts on the CPU (the default
+// shader only does ModelColor * color and Model * position), so consecutive draws with
+// different SetModelConstants still merge; the batch itself is drawn with identity/white.
+// Big arrays are not worth transforming on the CPU and go straight to the backend.
+//==============================================================================
+
+static constexpr int IMMEDIATE_BATCH_MAX_VERTS = 64 * 1024;
+static constexpr int IMMEDIATE_BATCH_MAX_PRETRANSFORM_VERTS = 4 * 1024;    // bigger draws skip the batch
+
+// What the facade last forwarded to the backend; -1 / !known = unknown (someone went around the facade)
+struct ImmediateBatchState
+{
+    Shader* m_shader = nullptr;
+    Texture const* m_texture = nullptr;
+    bool m_shaderKnown = false;
+    bool m_textureKnown = false;
+    int m_blendMode = -1;
+    int m_depthMode = -1;
+    int m_samplerMode = -1;
+    int m_rasterizerMode = -1;
+
+    // UI widgets call BeginCamera / SetMaterialConstants per widget with the same values
+    bool m_cameraKnown = false;
+    Mat44 m_worldToCamera;
+    Mat44 m_cameraToRender;
+    Mat44 m_renderToClip;
+    Vec3 m_cameraPosition;
+    bool m_materialKnown = false;
+    Texture const* m_material[3] = {};
+};
+
+struct ImmediateBatchStats
+{
+    uint32_t m_requestedDraws = 0;       // DrawVertexArray(Vertex_PCU) calls
+    uint32_t m_batchedDraws = 0;         // of those, appended to a batch
+    uint32_t m_directDraws = 0;          // too big / not a triangle list: submitted as-is
+    uint32_t m_submittedBatches = 0;     // draws the backend actually saw for batched geometry
+    uint32_t m_batchedVerts = 0;
+    uint32_t m_pretransformedVerts = 0;  // model transform/color baked on the CPU
+    uint32_t m_stateChangeFlushes = 0;
+    uint32_t m_overflowFlushes = 0;
+
+    float GetMergeRatio() const { return m_submittedBatches ? (float)m_batchedDraws / (float)m_submittedBatches : 0.f; }
+};
+
+class ImmediateBatcher
+{
+public:
+    ImmediateBatcher();
+
+    bool IsEmpty() const { return m_verts.empty(); }
+    bool CanAppend(int numVerts) const { return (int)m_verts.size() + numVerts <= IMMEDIATE_BATCH_MAX_VERTS; }
+    static bool IsBatchable(int numVerts) { return numVerts > 0 && numVerts <= IMMEDIATE_BATCH_MAX_PRETRANSFORM_VERTS && numVerts % 3 == 0; }
+
+    void Append(int numVerts, Vertex_PCU const* verts, Mat44 const& modelTransform, Rgba8 const& modelColor);
+
+    int GetVertexCount() const { return (int)m_verts.size(); }
+    Vertex_PCU const* GetVerts() const { return m_verts.data(); }
+    void Clear() { m_verts.clear(); }
+
+    void EndFrame();                     // rolls the frame stats over
+    ImmediateBatchStats& GetFrameStats() { return m_frameStats; }
+    ImmediateBatchStats const& GetLastFrameStats() const { return m_lastFrameStats; }
+
+private:
+    std::vector<Vertex_PCU> m_verts;
+    ImmediateBatchStats m_frameStats;
+    ImmediateBatchStats m_lastFrameStats;
+};
+
+bool IsIdentityModelTransform(Mat44 const& modelTransform);
+bool AreTransformsEqual(Mat44 const& a, Mat44 const& b);
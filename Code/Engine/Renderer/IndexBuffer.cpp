@@ -2,6 +2,7 @@
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 
+#ifndef ENGINE_NULL_RENDERER
 //Add dx11
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -16,6 +17,7 @@
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "d3dcompiler.lib")
+#endif
 
 IndexBuffer::IndexBuffer(ID3D11Device* device, unsigned int size, unsigned int stride)
 	: m_device(device)
@@ -81,6 +83,8 @@ unsigned int IndexBuffer::AppendData(const void* data, unsigned int size)
 
 	unsigned int oldOffset = (unsigned int)m_offset / sizeof(unsigned int);
 	m_offset += size;
+	if (m_offset > m_peakOffset)
+		m_peakOffset = m_offset;
 	return oldOffset;
 }
 
@@ -94,9 +98,19 @@ IndexBuffer::IndexBuffer(unsigned int size, unsigned int stride)
 }
 #endif
 
+#ifdef ENGINE_NULL_RENDERER
+IndexBuffer::IndexBuffer(unsigned int size, unsigned int stride)
+	: m_size(size)
+	, m_stride(stride)
+{
+}
+#endif
+
 IndexBuffer::~IndexBuffer()
 {
+#ifndef ENGINE_NULL_RENDERER
 	DX_SAFE_RELEASE(m_buffer);
+#endif
 
 #ifdef ENGINE_DX12_RENDERER
 	DX_SAFE_RELEASE( m_dx12IndexBuffer );
@@ -106,6 +120,7 @@ IndexBuffer::~IndexBuffer()
 
 void IndexBuffer::Create()
 {
+#ifndef ENGINE_NULL_RENDERER
 	//Create INDEX buffer
 	UINT indexBufferSize = m_size;
 	D3D11_BUFFER_DESC bufferDesc = {};
@@ -120,6 +135,7 @@ void IndexBuffer::Create()
 	{
 		ERROR_AND_DIE("Could not create vertex buffer.");
 	}
+#endif
 }
 
 void IndexBuffer::Resize(unsigned int size)
@@ -129,7 +145,9 @@ void IndexBuffer::Resize(unsigned int size)
 		return;
 	}
 
+#ifndef ENGINE_NULL_RENDERER
 	DX_SAFE_RELEASE(m_buffer);
+#endif
 
 	m_size = size;
 
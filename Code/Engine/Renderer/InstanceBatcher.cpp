@@ -0,0 +1,202 @@
+#include "InstanceBatcher.h"
+
+#include "Engine/Core/MeshOptimizer.h"
+#include "Engine/Core/StaticMesh.h"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Job/JobSystem.h"
+#include "Engine/Renderer/Renderer.hpp"
+
+#include <algorithm>
+
+void InstanceBatcher::Build(std::vector<RenderItem> const& items)
+{
+    double buildStart = GetCurrentTimeSeconds();
+    m_stats = InstanceBatchStats();
+    m_batches.clear();
+
+    uint32_t itemCount = (uint32_t)items.size();
+    m_itemKeys.resize(itemCount);
+
+    double keyStart = GetCurrentTimeSeconds();
+    ParallelFor(itemCount, INSTANCE_BATCH_ITEMS_PER_JOB, [this, &items](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            RenderItem const& item = items[i];
+            ItemKey& key = m_itemKeys[i];
+            key.m_mesh = item.m_visible ? item.m_mesh : nullptr;
+            key.m_materialID = item.m_materialID;
+            uint64_t bits = (uint64_t)(uintptr_t)key.m_mesh;
+            uint64_t hash = MixHash(MixHash(MixHash(0x9E3779B97F4A7C15ull, key.m_materialID), (uint32_t)bits), (uint32_t)(bits >> 32));
+            key.m_hash = (uint32_t)FinalizeHash(hash);
+        }
+    });
+    m_stats.m_keyMilliseconds = (GetCurrentTimeSeconds() - keyStart) * 1000.0;
+
+    // 分组：open addressing 表 (material, mesh) -> batch，O(n)，不对 item 排序
+    double groupStart = GetCurrentTimeSeconds();
+    uint32_t tableSize = 64;
+    while (tableSize < itemCount * 2)
+        tableSize *= 2;
+    m_batchTable.assign(tableSize, INSTANCE_BATCH_EMPTY_SLOT);
+    m_itemBatch.resize(itemCount);
+    for (uint32_t i = 0; i < itemCount; i++)
+    {
+        ItemKey const& key = m_itemKeys[i];
+        if (!key.m_mesh)
+        {
+            m_itemBatch[i] = INSTANCE_BATCH_EMPTY_SLOT;
+            continue;
+        }
+        uint32_t slot = key.m_hash & (tableSize - 1);
+        while (m_batchTable[slot] != INSTANCE_BATCH_EMPTY_SLOT)
+        {
+            InstanceBatch const& batch = m_batches[m_batchTable[slot]];
+            if (batch.m_mesh == key.m_mesh && batch.m_materialID == key.m_materialID)
+                break;
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        if (m_batchTable[slot] == INSTANCE_BATCH_EMPTY_SLOT)
+        {
+            m_batchTable[slot] = (uint32_t)m_batches.size();
+            InstanceBatch batch;
+            batch.m_mesh = key.m_mesh;
+            batch.m_materialID = key.m_materialID;
+            m_batches.push_back(batch);
+        }
+        m_itemBatch[i] = m_batchTable[slot];
+        m_batches[m_itemBatch[i]].m_instanceCount++;
+    }
+
+    // batch 很少，只排 batch：material 优先（少切纹理），再按 mesh；先出现的在前，结果确定
+    uint32_t batchCount = (uint32_t)m_batches.size();
+    m_batchOrder.resize(batchCount);
+    for (uint32_t b = 0; b < batchCount; b++)
+    {
+        m_batchOrder[b] = b;
+    }
+    std::sort(m_batchOrder.begin(), m_batchOrder.end(), [this](uint32_t a, uint32_t b)
+    {
+        InstanceBatch const& batchA = m_batches[a];
+        InstanceBatch const& batchB = m_batches[b];
+        if (batchA.m_materialID != batchB.m_materialID)
+            return batchA.m_materialID < batchB.m_materialID;
+        if (batchA.m_mesh != batchB.m_mesh)
+            return std::less<StaticMesh*>()(batchA.m_mesh, batchB.m_mesh);
+        return a < b;
+    });
+    m_batchCursor.resize(batchCount);
+    uint32_t instanceCount = 0;
+    for (uint32_t b : m_batchOrder)
+    {
+        m_batches[b].m_firstInstance = instanceCount;
+        m_batchCursor[b] = instanceCount;
+        instanceCount += m_batches[b].m_instanceCount;
+    }
+    // m_itemBatch 改存 instance slot；按 item 顺序走，batch 内保持 item 顺序
+    for (uint32_t i = 0; i < itemCount; i++)
+    {
+        if (m_itemBatch[i] != INSTANCE_BATCH_EMPTY_SLOT)
+            m_itemBatch[i] = m_batchCursor[m_itemBatch[i]]++;
+    }
+    m_sortedBatches.resize(batchCount);
+    for (uint32_t b = 0; b < batchCount; b++)
+    {
+        m_sortedBatches[b] = m_batches[m_batchOrder[b]];
+    }
+    m_batches.swap(m_sortedBatches);
+    m_stats.m_groupMilliseconds = (GetCurrentTimeSeconds() - groupStart) * 1000.0;
+
+    double packStart = GetCurrentTimeSeconds();
+    m_instances.resize(instanceCount);
+    // 顺序读 item、散写 instance，比按 slot 去 gather item 省 cache miss
+    ParallelFor(itemCount, INSTANCE_BATCH_ITEMS_PER_JOB, [this, &items](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            uint32_t slot = m_itemBatch[i];
+            if (slot != INSTANCE_BATCH_EMPTY_SLOT)
+                m_instances[slot].Set(items[i].m_worldMatrix, items[i].m_color);
+        }
+    });
+    m_stats.m_packMilliseconds = (GetCurrentTimeSeconds() - packStart) * 1000.0;
+
+    // Draw() 里遇到不能 instancing 的 batch 会再修正
+    m_stats.m_itemCount = instanceCount;
+    m_stats.m_batchCount = (uint32_t)m_batches.size();
+    for (InstanceBatch const& batch : m_batches)
+    {
+        if (batch.m_instanceCount >= m_minInstanceCount)
+        {
+            m_stats.m_instancedBatches++;
+            m_stats.m_instancedObjects += batch.m_instanceCount;
+        }
+        else
+        {
+            m_stats.m_singleObjects += batch.m_instanceCount;
+        }
+    }
+    m_stats.m_drawCalls = m_stats.m_instancedBatches + m_stats.m_singleObjects;
+    m_stats.m_instanceBytes = (uint64_t)instanceCount * sizeof(InstanceData);
+    m_stats.m_buildMilliseconds = (GetCurrentTimeSeconds() - buildStart) * 1000.0;
+}
+
+void InstanceBatcher::Draw(Renderer& renderer, Shader* instancedShader)
+{
+    if (m_batches.empty())
+        return;
+
+    // instanced layout 只认 Vertex_PCUTBN：packed mesh 走单个 draw（要 prepend 反量化矩阵）
+    auto canInstance = [this, instancedShader](InstanceBatch const& batch)
+    {
+        return instancedShader && batch.m_instanceCount >= m_minInstanceCount && !batch.m_mesh->m_usesPackedVertices;
+    };
+
+    m_stats.m_instancedBatches = 0;
+    m_stats.m_instancedObjects = 0;
+    m_stats.m_singleObjects = 0;
+    for (InstanceBatch const& batch : m_batches)
+    {
+        if (canInstance(batch))
+        {
+            m_stats.m_instancedBatches++;
+            m_stats.m_instancedObjects += batch.m_instanceCount;
+        }
+        else
+        {
+            m_stats.m_singleObjects += batch.m_instanceCount;
+        }
+    }
+    m_stats.m_drawCalls = m_stats.m_instancedBatches + m_stats.m_singleObjects;
+
+    if (m_stats.m_instancedBatches > 0)
+    {
+        renderer.UploadInstanceData(m_instances.data(), (unsigned int)m_instances.size());
+    }
+
+    for (InstanceBatch const& batch : m_batches)
+    {
+        StaticMesh* mesh = batch.m_mesh;
+        unsigned int indexCount = (unsigned int)mesh->m_indices.size();
+        renderer.SetMaterialConstants(mesh->m_diffuseTexture, mesh->m_normalTexture, mesh->m_specularTexture);
+
+        if (canInstance(batch))
+        {
+            renderer.BindShader(instancedShader);
+            renderer.SetModelConstants();
+            renderer.DrawIndexBufferInstanced(mesh->m_vertexBuffer, mesh->m_indexBuffer, indexCount, batch.m_firstInstance, batch.m_instanceCount);
+            continue;
+        }
+
+        renderer.BindShader(mesh->m_shader);
+        Mat44 dequantization = mesh->GetVertexDequantizationTransform();
+        for (uint32_t i = 0; i < batch.m_instanceCount; i++)
+        {
+            InstanceData const& instance = m_instances[batch.m_firstInstance + i];
+            Mat44 modelToWorld = instance.GetModelToWorld();
+            modelToWorld.Append(dequantization);
+            renderer.SetModelConstants(modelToWorld, instance.m_color);
+            renderer.DrawIndexBuffer(mesh->m_vertexBuffer, mesh->m_indexBuffer, indexCount);
+        }
+    }
+}
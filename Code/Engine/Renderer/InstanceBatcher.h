@@ -0,0 +1,94 @@
+#pragma once
+#include "Engine/Renderer/RenderCommon.h"
+
+#include <cstdint>
+#include <vector>
+
+class Renderer;
+class Shader;
+class StaticMesh;
+
+//==============================================================================
+// InstanceBatcher - 共享同一个 StaticMesh 的 RenderItem 自动合成 instanced draw
+//==============================================================================
+// MeshManager already shares one StaticMesh between every MeshObject that loads the
+// same file; without this each object still costs SetModelConstants + a draw.
+//
+// Build(items), once per frame:
+//   1. key pass (ParallelFor)    (materialID, mesh) + its hash per visible item
+//   2. group                     open-addressing table (material, mesh) -> batch, O(n);
+//                                only the batches are sorted, material first (fewer
+//                                texture switches), then mesh. Objects keep item order
+//                                inside a batch, so the result is deterministic
+//   3. pack pass (ParallelFor)   Mat44 + color -> 52-byte InstanceData, written to the
+//                                item's slot in batch order
+// Draw(renderer): one UploadInstanceData for the whole frame, then per batch either one
+// DrawIndexBufferInstanced (>= m_minInstanceCount objects) or the usual per-object
+// SetModelConstants + DrawIndexBuffer. Packed-vertex meshes and a missing instanced
+// shader also take the per-object path.
+// Scene::RenderOpaque owns one and runs Build + Draw on the visible meshes every frame.
+//==============================================================================
+
+static constexpr uint32_t INSTANCE_BATCH_MIN_INSTANCES = 2;
+static constexpr uint32_t INSTANCE_BATCH_ITEMS_PER_JOB = 1024;
+static constexpr uint32_t INSTANCE_BATCH_EMPTY_SLOT = 0xFFFFFFFFu;
+
+struct InstanceBatch
+{
+    StaticMesh* m_mesh = nullptr;
+    uint32_t m_materialID = 0;
+    uint32_t m_firstInstance = 0;        // into GetInstances()
+    uint32_t m_instanceCount = 0;
+};
+
+struct InstanceBatchStats
+{
+    uint32_t m_itemCount = 0;            // visible items with a mesh
+    uint32_t m_batchCount = 0;
+    uint32_t m_instancedBatches = 0;
+    uint32_t m_instancedObjects = 0;     // objects drawn through instanced batches
+    uint32_t m_singleObjects = 0;        // objects drawn one by one
+    uint32_t m_drawCalls = 0;            // what Draw() submits: instancedBatches + singleObjects
+    uint64_t m_instanceBytes = 0;
+
+    double m_keyMilliseconds = 0.0;
+    double m_groupMilliseconds = 0.0;    // hash grouping + batch sort + scatter
+    double m_packMilliseconds = 0.0;
+    double m_buildMilliseconds = 0.0;    // whole Build()
+
+    uint32_t GetDrawsSaved() const { return m_itemCount - m_drawCalls; }
+};
+
+class InstanceBatcher
+{
+public:
+    void Build(std::vector<RenderItem> const& items);
+    void Draw(Renderer& renderer, Shader* instancedShader);
+
+    std::vector<InstanceBatch> const& GetBatches() const { return m_batches; }
+    std::vector<InstanceData> const& GetInstances() const { return m_instances; }
+    InstanceBatchStats const& GetStats() const { return m_stats; }
+
+public:
+    uint32_t m_minInstanceCount = INSTANCE_BATCH_MIN_INSTANCES;
+
+private:
+    struct ItemKey
+    {
+        StaticMesh* m_mesh;              // nullptr: invisible / no mesh, skipped
+        uint32_t m_materialID;
+        uint32_t m_hash;
+    };
+
+    // scratch, kept between frames so Build() does not allocate once warmed up
+    std::vector<ItemKey> m_itemKeys;
+    std::vector<uint32_t> m_itemBatch;       // batch index, then instance slot
+    std::vector<uint32_t> m_batchTable;
+    std::vector<uint32_t> m_batchOrder;
+    std::vector<uint32_t> m_batchCursor;
+    std::vector<InstanceBatch> m_sortedBatches;
+
+    std::vector<InstanceBatch> m_batches;
+    std::vector<InstanceData> m_instances;
+    InstanceBatchStats m_stats;
+};
@@ -0,0 +1,624 @@
+#include "Engine/Renderer/NullRenderer.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
+#include "Engine/Renderer/Shader.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/VertexBuffer.hpp"
+#include "Engine/Renderer/IndexBuffer.hpp"
+#include "Engine/Renderer/ConstantBuffer.hpp"
+#include "Engine/Renderer/SpriteDefinition.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Image.hpp"
+#include "Engine/Core/ImageMipChain.h"
+#include "Engine/Core/BlockCompression.h"
+
+#include "ThirdParty/stb/stb_image.h"
+
+#ifdef ENGINE_NULL_RENDERER
+
+void NullRendererStats::Accumulate(NullRendererStats const& other)
+{
+	m_drawCalls += other.m_drawCalls;
+	m_verticesDrawn += other.m_verticesDrawn;
+	m_indicesDrawn += other.m_indicesDrawn;
+	m_instancedDrawCalls += other.m_instancedDrawCalls;
+	m_instancesDrawn += other.m_instancesDrawn;
+
+	m_vertexBuffersCreated += other.m_vertexBuffersCreated;
+	m_indexBuffersCreated += other.m_indexBuffersCreated;
+	m_constantBuffersCreated += other.m_constantBuffersCreated;
+	m_texturesCreated += other.m_texturesCreated;
+	m_shadersCreated += other.m_shadersCreated;
+
+	m_vertexUploads += other.m_vertexUploads;
+	m_indexUploads += other.m_indexUploads;
+	m_constantUploads += other.m_constantUploads;
+	m_vertexBytesUploaded += other.m_vertexBytesUploaded;
+	m_indexBytesUploaded += other.m_indexBytesUploaded;
+	m_constantBytesUploaded += other.m_constantBytesUploaded;
+	m_textureBytesUploaded += other.m_textureBytesUploaded;
+
+	m_textureBinds += other.m_textureBinds;
+	m_shaderBinds += other.m_shaderBinds;
+	m_bufferBinds += other.m_bufferBinds;
+	m_constantBufferBinds += other.m_constantBufferBinds;
+	m_stateChanges += other.m_stateChanges;
+	m_cameraBegins += other.m_cameraBegins;
+	m_clears += other.m_clears;
+}
+
+uint64_t NullRendererStats::GetTotalBytesUploaded() const
+{
+	return m_vertexBytesUploaded + m_indexBytesUploaded + m_constantBytesUploaded + m_textureBytesUploaded;
+}
+
+//------------------------------------------------------------------------------------------------
+NullRenderer::NullRenderer(RendererConfig config)
+	:m_config(config)
+{
+}
+
+void NullRenderer::Startup()
+{
+	// 和 DX11 一样准备默认 shader，BindShader(nullptr) 才有东西可绑
+	m_defaultShader = CreateShader("Default");
+	m_currentShader = m_defaultShader;
+}
+
+void NullRenderer::ShutDown()
+{
+	if (m_frameCount > 0)
+	{
+		double frames = (double)m_frameCount;
+		DebuggerPrintf("[NullRenderer] %u frames: %.1f draws, %.1f verts, %.1f KB uploaded, %.1f state changes per frame\n",
+			m_frameCount,
+			(double)m_totalStats.m_drawCalls / frames,
+			(double)m_totalStats.m_verticesDrawn / frames,
+			(double)m_totalStats.GetTotalBytesUploaded() / 1024.0 / frames,
+			(double)m_totalStats.m_stateChanges / frames);
+	}
+
+	for (Shader* shader : m_loadedShaders)
+	{
+		delete shader;
+	}
+	m_loadedShaders.clear();
+	m_defaultShader = nullptr;
+	m_currentShader = nullptr;
+
+	for (Texture* texture : m_loadedTextures)
+	{
+		delete texture;
+	}
+	m_loadedTextures.clear();
+	m_textureLookup.Clear();
+	m_boundTexture = nullptr;
+
+	for (BitmapFont* bitmapFont : m_loadedFonts)
+	{
+		delete bitmapFont;
+	}
+	m_loadedFonts.clear();
+}
+
+void NullRenderer::BeginFrame()
+{
+}
+
+// Work done between frames (loading, startup) is counted in the next frame
+void NullRenderer::EndFrame()
+{
+	m_lastFrameStats = m_frameStats;
+	m_totalStats.Accumulate(m_frameStats);
+	m_frameStats = NullRendererStats();
+	m_frameCount++;
+}
+
+void NullRenderer::ResetStats()
+{
+	m_frameStats = NullRendererStats();
+	m_lastFrameStats = NullRendererStats();
+	m_totalStats = NullRendererStats();
+	m_frameCount = 0;
+}
+
+void NullRenderer::RecordDraw(uint64_t vertexCount, uint64_t indexCount)
+{
+	m_frameStats.m_drawCalls++;
+	m_frameStats.m_verticesDrawn += vertexCount;
+	m_frameStats.m_indicesDrawn += indexCount;
+}
+
+//------------------------------------------------------------------------------------------------
+void NullRenderer::ClearScreen(const Rgba8& clearColor)
+{
+	UNUSED(clearColor);
+	m_frameStats.m_clears++;
+}
+
+void NullRenderer::BeginCamera(const Camera& camera)
+{
+	UNUSED(camera);
+	m_frameStats.m_cameraBegins++;
+	// camera constants
+	m_frameStats.m_constantUploads++;
+	m_frameStats.m_constantBytesUploaded += sizeof(CameraConstants);
+}
+
+void NullRenderer::EndCamera(const Camera& camera)
+{
+	UNUSED(camera);
+}
+
+void NullRenderer::SetViewport(const AABB2& normalizedViewport)
+{
+	UNUSED(normalizedViewport);
+	m_frameStats.m_stateChanges++;
+}
+
+// Immediate-mode draws upload into the renderer's own dynamic buffer first, same as DX11
+void NullRenderer::DrawVertexArray(const std::vector<Vertex_PCU>& verts)
+{
+	DrawVertexArray((int)verts.size(), verts.data());
+}
+
+void NullRenderer::DrawVertexArray(int numVerts, const Vertex_PCU* verts)
+{
+	UNUSED(verts);
+	m_frameStats.m_vertexUploads++;
+	m_frameStats.m_vertexBytesUploaded += (uint64_t)numVerts * sizeof(Vertex_PCU);
+	RecordDraw((uint64_t)numVerts, 0);
+}
+
+void NullRenderer::DrawVertexArray(const std::vector<Vertex_PCUTBN>& verts)
+{
+	DrawVertexArray((int)verts.size(), verts.data());
+}
+
+void NullRenderer::DrawVertexArray(int numVerts, const Vertex_PCUTBN* verts)
+{
+	UNUSED(verts);
+	m_frameStats.m_vertexUploads++;
+	m_frameStats.m_vertexBytesUploaded += (uint64_t)numVerts * sizeof(Vertex_PCUTBN);
+	RecordDraw((uint64_t)numVerts, 0);
+}
+
+void NullRenderer::DrawVertexIndexArray(const std::vector<Vertex_PCUTBN>& verts, const std::vector<unsigned int>& indices)
+{
+	DrawVertexIndexArray((int)verts.size(), verts.data(), (int)indices.size(), indices.data());
+}
+
+void NullRenderer::DrawVertexIndexArray(const std::vector<Vertex_PCUTBN>& verts, const std::vector<unsigned int>& indices, VertexBuffer* vbo, IndexBuffer* ibo)
+{
+	DrawVertexIndexArray((int)verts.size(), verts.data(), (int)indices.size(), indices.data(), vbo, ibo);
+}
+
+void NullRenderer::DrawVertexIndexArray(int numVerts, const Vertex_PCUTBN* verts, int numIndices, const unsigned int* indices)
+{
+	UNUSED(verts);
+	UNUSED(indices);
+	m_frameStats.m_vertexUploads++;
+	m_frameStats.m_indexUploads++;
+	m_frameStats.m_vertexBytesUploaded += (uint64_t)numVerts * sizeof(Vertex_PCUTBN);
+	m_frameStats.m_indexBytesUploaded += (uint64_t)numIndices * sizeof(unsigned int);
+	RecordDraw((uint64_t)numVerts, (uint64_t)numIndices);
+}
+
+void NullRenderer::DrawVertexIndexArray(int numVerts, const Vertex_PCUTBN* verts, int numIndices, const unsigned int* indices, VertexBuffer* vbo, IndexBuffer* ibo)
+{
+	CopyCPUToGPU(verts, (unsigned int)(numVerts * sizeof(Vertex_PCUTBN)), vbo);
+	CopyCPUToGPU(indices, (unsigned int)(numIndices * sizeof(unsigned int)), ibo);
+	DrawIndexBuffer(vbo, ibo, (unsigned int)numIndices);
+}
+
+//------------------------------------------------------------------------------------------------
+Image* NullRenderer::CreateImageFromFile(char const* imageFilePath)
+{
+	return new Image(imageFilePath);
+}
+
+Texture* NullRenderer::CreateTextureFromImage(const Image& image)
+{
+	Texture* newTexture = new Texture();
+	newTexture->m_name = image.GetImageFilePath();
+	newTexture->m_dimensions = image.GetDimensions();
+
+	m_frameStats.m_texturesCreated++;
+	m_frameStats.m_textureBytesUploaded += (uint64_t)image.GetDimensions().x * (uint64_t)image.GetDimensions().y * sizeof(Rgba8);
+
+	m_loadedTextures.push_back(newTexture);
+	m_textureLookup.Add(newTexture);
+	return newTexture;
+}
+
+Texture* NullRenderer::CreateTextureFromMipChain(ImageMipChain const& mipChain, int residentMip)
+{
+	GUARANTEE_OR_DIE(mipChain.IsValid(), Stringf("CreateTextureFromMipChain failed for \"%s\" - empty mip chain", mipChain.m_name.c_str()));
+
+	Texture* newTexture = new Texture();
+	newTexture->m_name = mipChain.m_name;
+	newTexture->m_dimensions = mipChain.GetDimensions(0);
+	newTexture->m_mipLevelCount = mipChain.GetLevelCount();
+
+	m_frameStats.m_texturesCreated++;
+	UpdateTextureMips(newTexture, mipChain, residentMip);
+
+	m_loadedTextures.push_back(newTexture);
+	m_textureLookup.Add(newTexture);
+	return newTexture;
+}
+
+Texture* NullRenderer::CreateTextureFromCompressedMipChain(CompressedMipChain const& mipChain, int residentMip)
+{
+	GUARANTEE_OR_DIE(mipChain.IsValid(), Stringf("CreateTextureFromCompressedMipChain failed for \"%s\" - empty mip chain", mipChain.m_name.c_str()));
+
+	Texture* newTexture = new Texture();
+	newTexture->m_name = mipChain.m_name;
+	newTexture->m_dimensions = mipChain.GetDimensions(0);
+	newTexture->m_mipLevelCount = mipChain.GetLevelCount();
+
+	m_frameStats.m_texturesCreated++;
+	UpdateTextureMips(newTexture, mipChain, residentMip);
+
+	m_loadedTextures.push_back(newTexture);
+	m_textureLookup.Add(newTexture);
+	return newTexture;
+}
+
+void NullRenderer::UpdateTextureMips(Texture* texture, ImageMipChain const& mipChain, int residentMip)
+{
+	GUARANTEE_OR_DIE(residentMip >= 0 && residentMip < mipChain.GetLevelCount(), Stringf("UpdateTextureMips failed for \"%s\" - no level %d", texture->m_name.c_str(), residentMip));
+
+	m_frameStats.m_textureBytesUploaded += mipChain.GetTotalBytes() - mipChain.m_levels[residentMip].m_firstTexel * sizeof(Rgba8);
+	texture->m_residentMip = residentMip;
+}
+
+void NullRenderer::UpdateTextureMips(Texture* texture, CompressedMipChain const& mipChain, int residentMip)
+{
+	GUARANTEE_OR_DIE(residentMip >= 0 && residentMip < mipChain.GetLevelCount(), Stringf("UpdateTextureMips failed for \"%s\" - no level %d", texture->m_name.c_str(), residentMip));
+
+	m_frameStats.m_textureBytesUploaded += mipChain.GetTotalBytes() - mipChain.m_levels[residentMip].m_firstByte;
+	texture->m_residentMip = residentMip;
+}
+
+void NullRenderer::DropTextureMips(Texture* texture, int residentMip)
+{
+	if (residentMip > texture->m_residentMip && residentMip < texture->m_mipLevelCount)
+	{
+		texture->m_residentMip = residentMip;
+	}
+}
+
+Texture* NullRenderer::CreateOrGetTextureFromFile(char const* imageFilePath)
+{
+	Texture* existingTexture = GetTextureForFileName(imageFilePath);
+	if (existingTexture)
+	{
+		return existingTexture;
+	}
+
+	return CreateTextureFromFile(imageFilePath);
+}
+
+Texture* NullRenderer::CreateTextureFromFile(char const* imageFilePath)
+{
+	// 只读文件头拿尺寸，不解码像素；UV / 字体布局只关心尺寸
+	IntVec2 dimensions = IntVec2::ZERO;
+	int bytesPerTexel = 0;
+	int result = stbi_info(imageFilePath, &dimensions.x, &dimensions.y, &bytesPerTexel);
+	GUARANTEE_OR_DIE(result != 0, Stringf("Failed to load image \"%s\"", imageFilePath));
+
+	Texture* newTexture = new Texture();
+	newTexture->m_name = imageFilePath;
+	newTexture->m_dimensions = dimensions;
+
+	m_frameStats.m_texturesCreated++;
+	m_frameStats.m_textureBytesUploaded += (uint64_t)dimensions.x * (uint64_t)dimensions.y * sizeof(Rgba8);
+
+	m_loadedTextures.push_back(newTexture);
+	m_textureLookup.Add(newTexture);
+	return newTexture;
+}
+
+Texture* NullRenderer::GetTextureForFileName(const char* imageFilePath)
+{
+	return m_textureLookup.Find(imageFilePath);
+}
+
+Texture* NullRenderer::CreateTextureFromData(char const* name, IntVec2 dimensions, int bytesPerTexel, uint8_t* texelData)
+{
+	GUARANTEE_OR_DIE(texelData, Stringf("CreateTextureFromData failed for \"%s\" - texelData was null!", name));
+	GUARANTEE_OR_DIE(bytesPerTexel >= 3 && bytesPerTexel <= 4, Stringf("CreateTextureFromData failed for \"%s\" - unsupported BPP=%i (must be 3 or 4)", name, bytesPerTexel));
+	GUARANTEE_OR_DIE(dimensions.x > 0 && dimensions.y > 0, Stringf("CreateTextureFromData failed for \"%s\" - illegal texture dimensions (%i x %i)", name, dimensions.x, dimensions.y));
+
+	Texture* newTexture = new Texture();
+	newTexture->m_name = name;
+	newTexture->m_dimensions = dimensions;
+
+	m_frameStats.m_texturesCreated++;
+	m_frameStats.m_textureBytesUploaded += (uint64_t)dimensions.x * (uint64_t)dimensions.y * sizeof(Rgba8);
+
+	m_loadedTextures.push_back(newTexture);
+	m_textureLookup.Add(newTexture);
+	return newTexture;
+}
+
+void NullRenderer::BindTexture(const Texture* texture, int slot)
+{
+	UNUSED(slot);
+	m_boundTexture = texture;
+	m_frameStats.m_textureBinds++;
+}
+
+BitmapFont* NullRenderer::CreateOrGetBitmapFont(const char* bitmapFontFilePathWithNoExtension)
+{
+	std::string fontTextureFilePath = std::string(bitmapFontFilePathWithNoExtension) + ".png";
+
+	Texture* bitmapTexture = CreateOrGetTextureFromFile(fontTextureFilePath.c_str());
+	if (!bitmapTexture)
+	{
+		return nullptr;
+	}
+
+	BitmapFont* bitmapFont = new BitmapFont(bitmapFontFilePathWithNoExtension, *bitmapTexture);
+	m_loadedFonts.push_back(bitmapFont);
+
+	return bitmapFont;
+}
+
+//------------------------------------------------------------------------------------------------
+Shader* NullRenderer::CreateShader(char const* shaderName, char const* shaderSource, VertexType vertexType)
+{
+	UNUSED(shaderSource);
+	UNUSED(vertexType);
+
+	ShaderConfig usedShaderConfig;
+	usedShaderConfig.m_name = shaderName;
+
+	Shader* newShader = new Shader(usedShaderConfig);
+	m_loadedShaders.push_back(newShader);
+	m_frameStats.m_shadersCreated++;
+	return newShader;
+}
+
+Shader* NullRenderer::CreateShader(char const* shaderName, VertexType vertexType)
+{
+	return CreateShader(shaderName, "", vertexType);
+}
+
+Shader* NullRenderer::CreateOrGetShader(char const* shaderName, VertexType vertexType)
+{
+	for (Shader* shader : m_loadedShaders)
+	{
+		if (shader->GetName() == shaderName)
+		{
+			return shader;
+		}
+	}
+
+	return CreateShader(shaderName, vertexType);
+}
+
+bool NullRenderer::CompileShaderToByteCode(std::vector<unsigned char>& outByteCode, char const* name, char const* source, char const* entryPoint, char const* target)
+{
+	UNUSED(name);
+	UNUSED(source);
+	UNUSED(entryPoint);
+	UNUSED(target);
+	outByteCode.clear();
+	return true;
+}
+
+void NullRenderer::BindShader(Shader* shader)
+{
+	m_currentShader = shader ? shader : m_defaultShader;
+	m_frameStats.m_shaderBinds++;
+}
+
+//------------------------------------------------------------------------------------------------
+VertexBuffer* NullRenderer::CreateVertexBuffer(const unsigned int size, unsigned int stride)
+{
+	if (size == 0 || stride == 0)
+	{
+		ERROR_AND_DIE("Invalid vertex buffer size or stride.");
+	}
+
+	m_frameStats.m_vertexBuffersCreated++;
+	return new VertexBuffer(size, stride);
+}
+
+void NullRenderer::CopyCPUToGPU(const void* data, unsigned int size, VertexBuffer* vbo)
+{
+	UNUSED(data);
+	if (vbo->m_size < size)
+	{
+		vbo->m_size = size;
+	}
+
+	m_frameStats.m_vertexUploads++;
+	m_frameStats.m_vertexBytesUploaded += size;
+}
+
+void NullRenderer::BindVertexBuffer(VertexBuffer* vbo)
+{
+	UNUSED(vbo);
+	m_frameStats.m_bufferBinds++;
+}
+
+void NullRenderer::DrawVertexBuffer(VertexBuffer* vbo, unsigned int vertexCount)
+{
+	BindVertexBuffer(vbo);
+	RecordDraw(vertexCount, 0);
+}
+
+IndexBuffer* NullRenderer::CreateIndexBuffer(const unsigned int size, unsigned int stride)
+{
+	if (size == 0 || stride == 0)
+	{
+		ERROR_AND_DIE("Invalid index buffer size or stride.");
+	}
+
+	m_frameStats.m_indexBuffersCreated++;
+	return new IndexBuffer(size, stride);
+}
+
+void NullRenderer::BindIndexBuffer(IndexBuffer* ibo)
+{
+	UNUSED(ibo);
+	m_frameStats.m_bufferBinds++;
+}
+
+void NullRenderer::DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, unsigned int startIndex)
+{
+	UNUSED(startIndex);
+	BindVertexBuffer(vbo);
+	BindIndexBuffer(ibo);
+	RecordDraw(vbo->m_stride > 0 ? vbo->m_size / vbo->m_stride : 0, indexCount);
+}
+
+void NullRenderer::UploadInstanceData(const InstanceData* instances, unsigned int instanceCount)
+{
+	UNUSED(instances);
+	if (instanceCount == 0)
+		return;
+	m_uploadedInstanceCount = instanceCount;
+	m_frameStats.m_vertexUploads++;
+	m_frameStats.m_vertexBytesUploaded += (uint64_t)instanceCount * sizeof(InstanceData);
+}
+
+void NullRenderer::DrawIndexBufferInstanced(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, unsigned int firstInstance, unsigned int instanceCount, unsigned int startIndex)
+{
+	UNUSED(startIndex);
+	GUARANTEE_OR_DIE(firstInstance + instanceCount <= m_uploadedInstanceCount, "Instanced draw reads past the uploaded InstanceData");
+	BindVertexBuffer(vbo);
+	BindIndexBuffer(ibo);
+	uint64_t vertexCount = vbo->m_stride > 0 ? vbo->m_size / vbo->m_stride : 0;
+	RecordDraw(vertexCount * instanceCount, (uint64_t)indexCount * instanceCount);
+	m_frameStats.m_instancedDrawCalls++;
+	m_frameStats.m_instancesDrawn += instanceCount;
+}
+
+void NullRenderer::CopyCPUToGPU(const void* data, unsigned int size, IndexBuffer*& ibo)
+{
+	UNUSED(data);
+	if (ibo->m_size < size)
+	{
+		ibo->m_size = size;
+	}
+
+	m_frameStats.m_indexUploads++;
+	m_frameStats.m_indexBytesUploaded += size;
+}
+
+ConstantBuffer* NullRenderer::CreateConstantBuffer(const unsigned int size)
+{
+	if (size == 0)
+	{
+		ERROR_AND_DIE("Invalid constant buffer size.");
+	}
+
+	m_frameStats.m_constantBuffersCreated++;
+	return new ConstantBuffer((size_t)size);
+}
+
+void NullRenderer::CopyCPUToGPU(const void* data, unsigned int size, ConstantBuffer* cbo)
+{
+	UNUSED(data);
+	UNUSED(cbo);
+	m_frameStats.m_constantUploads++;
+	m_frameStats.m_constantBytesUploaded += size;
+}
+
+void NullRenderer::BindConstantBuffer(int slot, ConstantBuffer* cbo)
+{
+	UNUSED(slot);
+	UNUSED(cbo);
+	m_frameStats.m_constantBufferBinds++;
+}
+
+//------------------------------------------------------------------------------------------------
+void NullRenderer::SetBlendMode(BlendMode blendMode)
+{
+	if (blendMode != m_blendMode)
+	{
+		m_blendMode = blendMode;
+		m_frameStats.m_stateChanges++;
+	}
+}
+
+void NullRenderer::SetRasterizerMode(RasterizerMode rasterizerMode)
+{
+	if (rasterizerMode != m_rasterizerMode)
+	{
+		m_rasterizerMode = rasterizerMode;
+		m_frameStats.m_stateChanges++;
+	}
+}
+
+void NullRenderer::SetSamplerMode(SamplerMode samplerMode, int slot)
+{
+	UNUSED(slot);
+	if (samplerMode != m_samplerMode)
+	{
+		m_samplerMode = samplerMode;
+		m_frameStats.m_stateChanges++;
+	}
+}
+
+void NullRenderer::SetDepthMode(DepthMode depthMode)
+{
+	if (depthMode != m_depthMode)
+	{
+		m_depthMode = depthMode;
+		m_frameStats.m_stateChanges++;
+	}
+}
+
+void NullRenderer::SetGeneralLightConstants(Rgba8 sunColor, const Vec3& sunNormal, int numLights, std::vector<Rgba8> colors,
+	std::vector<Vec3> worldPositions, std::vector<Vec3> spotForwards, std::vector<float> ambiences,
+	std::vector<float> innerRadii, std::vector<float> outerRadii,
+	std::vector<float> innerDotThresholds, std::vector<float> outerDotThresholds)
+{
+	// 参数按值传递，拷贝本身就是 CPU 侧的真实开销，这里照常付
+	UNUSED(sunColor);
+	UNUSED(sunNormal);
+	UNUSED(numLights);
+	UNUSED(colors);
+	UNUSED(worldPositions);
+	UNUSED(spotForwards);
+	UNUSED(ambiences);
+	UNUSED(innerRadii);
+	UNUSED(outerRadii);
+	UNUSED(innerDotThresholds);
+	UNUSED(outerDotThresholds);
+	m_frameStats.m_constantUploads++;
+	m_frameStats.m_constantBytesUploaded += sizeof(GeneralLightConstants);
+}
+
+void NullRenderer::SetModelConstants(const Mat44& modelToWorldTransform, const Rgba8& modelColor)
+{
+	UNUSED(modelToWorldTransform);
+	UNUSED(modelColor);
+	m_frameStats.m_constantUploads++;
+	m_frameStats.m_constantBytesUploaded += sizeof(ModelConstants);
+}
+
+void NullRenderer::SetShadowConstants(const Mat44& lightViewProjectionMatrix)
+{
+	UNUSED(lightViewProjectionMatrix);
+	m_frameStats.m_constantUploads++;
+	m_frameStats.m_constantBytesUploaded += sizeof(ShadowConstants);
+}
+
+void NullRenderer::SetPerFrameConstants(const float time, const int debugInt, const float debugFloat)
+{
+	UNUSED(time);
+	UNUSED(debugInt);
+	UNUSED(debugFloat);
+	m_frameStats.m_constantUploads++;
+	m_frameStats.m_constantBytesUploaded += sizeof(PerFrameConstants);
+}
+
+#endif
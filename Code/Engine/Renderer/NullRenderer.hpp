@@ -0,0 +1,179 @@
+#pragma once
+
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/Camera.hpp"
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Core/TextureResidency.h"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include <cstdint>
+#include <vector>
+
+#ifdef ENGINE_NULL_RENDERER
+
+#if defined(ENGINE_DX11_RENDERER) || defined(ENGINE_DX12_RENDERER)
+#error "ENGINE_NULL_RENDERER cannot be combined with ENGINE_DX11_RENDERER or ENGINE_DX12_RENDERER"
+#endif
+
+class Window;
+class BitmapFont;
+class Image;
+class Texture;
+class Shader;
+class VertexBuffer;
+class ConstantBuffer;
+class IndexBuffer;
+
+//------------------------------------------------------------------------------------------------
+// Headless backend: 不碰任何设备，只记录调用次数和上传字节数
+// Lets Scene / UI / debug render / culling run a full frame loop on machines without a GPU,
+// so CPU frame cost can be profiled and regression-tested on its own.
+struct NullRendererStats
+{
+	uint32_t m_drawCalls = 0;
+	uint64_t m_verticesDrawn = 0;
+	uint64_t m_indicesDrawn = 0;
+	uint32_t m_instancedDrawCalls = 0;	// also counted in m_drawCalls
+	uint64_t m_instancesDrawn = 0;
+
+	uint32_t m_vertexBuffersCreated = 0;
+	uint32_t m_indexBuffersCreated = 0;
+	uint32_t m_constantBuffersCreated = 0;
+	uint32_t m_texturesCreated = 0;
+	uint32_t m_shadersCreated = 0;
+
+	uint32_t m_vertexUploads = 0;
+	uint32_t m_indexUploads = 0;
+	uint32_t m_constantUploads = 0;
+	uint64_t m_vertexBytesUploaded = 0;
+	uint64_t m_indexBytesUploaded = 0;
+	uint64_t m_constantBytesUploaded = 0;
+	uint64_t m_textureBytesUploaded = 0;
+
+	uint32_t m_textureBinds = 0;
+	uint32_t m_shaderBinds = 0;
+	uint32_t m_bufferBinds = 0;
+	uint32_t m_constantBufferBinds = 0;
+	uint32_t m_stateChanges = 0;		// blend / rasterizer / sampler / depth / viewport
+	uint32_t m_cameraBegins = 0;
+	uint32_t m_clears = 0;
+
+	void Accumulate(NullRendererStats const& other);
+	uint64_t GetTotalBytesUploaded() const;
+};
+
+class NullRenderer
+{
+public:
+
+	NullRenderer(RendererConfig config);
+
+	void Startup();
+	void ShutDown();
+
+	void BeginFrame();
+	void EndFrame();
+
+	void ClearScreen(const Rgba8& clearColor);
+	void BeginCamera(const Camera& camera);
+	void EndCamera(const Camera& camera);
+	void SetViewport(const AABB2& normalizedViewport);
+	void DrawVertexArray(const std::vector<Vertex_PCU>& verts);
+	void DrawVertexArray(int numVerts, const Vertex_PCU* verts);
+	void DrawVertexArray(const std::vector<Vertex_PCUTBN>& verts);
+	void DrawVertexArray(int numVerts, const Vertex_PCUTBN* verts);
+	void DrawVertexIndexArray(const std::vector<Vertex_PCUTBN>& verts, const std::vector<unsigned int>& indices);
+	void DrawVertexIndexArray(const std::vector<Vertex_PCUTBN>& verts, const std::vector<unsigned int>& indices, VertexBuffer* vbo, IndexBuffer* ibo);
+	void DrawVertexIndexArray(int numVerts, const Vertex_PCUTBN* verts, int numIndices, const unsigned int* indices);
+	void DrawVertexIndexArray(int numVerts, const Vertex_PCUTBN* verts, int numIndices, const unsigned int* indices, VertexBuffer* vbo, IndexBuffer* ibo);
+
+	Image* CreateImageFromFile(char const* imageFilePath);
+	Texture* CreateTextureFromImage(const Image& image);
+	Texture* CreateTextureFromMipChain(ImageMipChain const& mipChain, int residentMip = 0);
+	Texture* CreateTextureFromCompressedMipChain(CompressedMipChain const& mipChain, int residentMip = 0);
+	void UpdateTextureMips(Texture* texture, ImageMipChain const& mipChain, int residentMip);
+	void UpdateTextureMips(Texture* texture, CompressedMipChain const& mipChain, int residentMip);
+	void DropTextureMips(Texture* texture, int residentMip);
+	Texture* CreateOrGetTextureFromFile(char const* imageFilePath);
+	Texture* CreateTextureFromData(char const* name, IntVec2 dimensions, int bytesPerTexel, uint8_t* texelData);
+	Texture* CreateTextureFromFile(char const* imageFilePath);
+	Texture* GetTextureForFileName(const char* imageFilePath);
+	void BindTexture(const Texture* texture, int slot = 0);
+
+	BitmapFont* CreateOrGetBitmapFont(const char* bitmapFontFilePathWithNoExtension);
+
+	// No compiler: shaders are named handles only, so headless runs don't need the HLSL on disk
+	Shader* CreateShader(char const* shaderName, char const* shaderSource, VertexType vertexType = VertexType::VERTEX_PCU);
+	Shader* CreateShader(char const* shaderName, VertexType vertexType = VertexType::VERTEX_PCU);
+	Shader* CreateOrGetShader(char const* shaderName, VertexType vertexType = VertexType::VERTEX_PCU);
+	bool CompileShaderToByteCode(std::vector<unsigned char>& outByteCode,
+		char const* name, char const* source, char const* entryPoint, char const* target);
+	void BindShader(Shader* shader);
+
+	VertexBuffer* CreateVertexBuffer(const unsigned int size, unsigned int stride);
+	void BindVertexBuffer(VertexBuffer* vbo);
+	void DrawVertexBuffer(VertexBuffer* vbo, unsigned int vertexCount);
+	void CopyCPUToGPU(const void* data, unsigned int size, VertexBuffer* vbo);
+
+	IndexBuffer* CreateIndexBuffer(const unsigned int size, unsigned int stride);
+	void BindIndexBuffer(IndexBuffer* ibo);
+	void DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, unsigned int startIndex = 0);
+	void UploadInstanceData(const InstanceData* instances, unsigned int instanceCount);
+	void DrawIndexBufferInstanced(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, unsigned int firstInstance, unsigned int instanceCount, unsigned int startIndex = 0);
+	void CopyCPUToGPU(const void* data, unsigned int size, IndexBuffer*& ibo);
+
+	ConstantBuffer* CreateConstantBuffer(const unsigned int size);
+	void CopyCPUToGPU(const void* data, unsigned int size, ConstantBuffer* cbo);
+	void BindConstantBuffer(int slot, ConstantBuffer* cbo);
+
+	void SetBlendMode(BlendMode blendMode);
+	void SetRasterizerMode(RasterizerMode rasterizerMode);
+	void SetSamplerMode(SamplerMode samplerMode, int slot = 0);
+	void SetDepthMode(DepthMode depthMode);
+
+	void SetGeneralLightConstants(Rgba8 sunColor, const Vec3& sunNormal, int numLights, std::vector<Rgba8>colors,
+		std::vector<Vec3>worldPositions, std::vector<Vec3>spotForwards, std::vector<float>ambiences,
+		std::vector<float>innerRadii, std::vector<float>outerRadii,
+		std::vector<float>innerDotThresholds, std::vector<float>outerDotThresholds);
+	void SetModelConstants(const Mat44& modelToWorldTransform = Mat44(), const Rgba8& modelColor = Rgba8::WHITE);
+	void SetShadowConstants(const Mat44& lightViewProjectionMatrix = Mat44());
+	void SetPerFrameConstants(const float time, const int debugInt, const float debugFloat);
+
+	// Stats
+	NullRendererStats const& GetFrameStats() const { return m_frameStats; }			// frame in progress
+	NullRendererStats const& GetLastFrameStats() const { return m_lastFrameStats; }
+	NullRendererStats const& GetTotalStats() const { return m_totalStats; }
+	uint32_t GetFrameCount() const { return m_frameCount; }
+	void ResetStats();
+
+protected:
+	RendererConfig m_config;
+
+private:
+	void RecordDraw(uint64_t vertexCount, uint64_t indexCount);
+
+	std::vector<Texture*> m_loadedTextures;
+	TextureLookupTable m_textureLookup;		// GetTextureForFileName
+	std::vector<BitmapFont*> m_loadedFonts;
+	std::vector<Shader*> m_loadedShaders;
+
+	Shader* m_currentShader = nullptr;
+	Shader* m_defaultShader = nullptr;
+	const Texture* m_boundTexture = nullptr;
+
+	// 状态只在真正变化时计数，和 DX11 的 *IfChanged 路径保持一致
+	BlendMode m_blendMode = BlendMode::ALPHA;
+	RasterizerMode m_rasterizerMode = RasterizerMode::SOLID_CULL_BACK;
+	SamplerMode m_samplerMode = SamplerMode::POINT_CLAMP;
+	DepthMode m_depthMode = DepthMode::READ_WRITE_LESS_EQUAL;
+
+	NullRendererStats m_frameStats;
+	NullRendererStats m_lastFrameStats;
+	NullRendererStats m_totalStats;
+	uint32_t m_frameCount = 0;
+	unsigned int m_uploadedInstanceCount = 0;
+};
+
+#endif
\ No newline at end of file
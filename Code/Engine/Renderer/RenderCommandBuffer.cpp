@@ -0,0 +1,705 @@
+#include "RenderCommandBuffer.h"
+
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/Shader.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Job/JobSystem.h"
+
+#include <algorithm>
+#include <cstring>
+
+static constexpr uint32_t RENDER_CAPTURE_MAGIC = 0x444D4352; // 'RCMD'
+static constexpr uint32_t RENDER_CAPTURE_VERSION = 1;
+static constexpr int REPLAY_TRACKED_SLOTS = 8;
+
+// 回放时的实际状态，只在一次 Execute 内有效（起始视为未知）
+struct RenderCommandReplayState
+{
+    int m_blendMode = -1;
+    int m_rasterizerMode = -1;
+    int m_depthMode = -1;
+    int m_samplerModes[REPLAY_TRACKED_SLOTS] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+    void const* m_shader = nullptr;
+    bool m_shaderKnown = false;
+    void const* m_textures[REPLAY_TRACKED_SLOTS] = {};
+    bool m_texturesKnown[REPLAY_TRACKED_SLOTS] = {};
+
+    std::vector<Vertex_PCUTBN> m_scratchVerts;
+    std::vector<unsigned int> m_scratchIndices;
+
+    RenderCommandReplayStats m_stats;
+};
+
+uint64_t MakeRenderSortKey(uint8_t layer, uint32_t material, uint32_t depth)
+{
+    return ((uint64_t)layer << 56) | ((uint64_t)(material & 0xFFFFFF) << 32) | (uint64_t)depth;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RenderCommandBuffer::Reset()
+{
+    // clear() 保留容量，worker 每帧复用同一个 buffer 不再分配
+    m_commands.clear();
+    m_groups.clear();
+    m_resources.clear();
+    m_resourceLookup.clear();
+    m_pcuVerts.clear();
+    m_pcutbnVerts.clear();
+    m_indices.clear();
+    m_commandCount = 0;
+    m_drawCount = 0;
+}
+
+void RenderCommandBuffer::Reserve(size_t commandBytes, size_t numVerts)
+{
+    m_commands.reserve(commandBytes);
+    m_pcuVerts.reserve(numVerts);
+}
+
+void RenderCommandBuffer::BeginGroup(uint64_t sortKey)
+{
+    uint32_t offset = (uint32_t)m_commands.size();
+    if (!m_groups.empty() && m_groups.back().m_begin == offset)
+    {
+        // 空 group 直接改 key
+        m_groups.back().m_sortKey = sortKey;
+        return;
+    }
+
+    RenderCommandGroup group;
+    group.m_sortKey = sortKey;
+    group.m_begin = offset;
+    group.m_end = offset;
+    m_groups.push_back(group);
+}
+
+void RenderCommandBuffer::AppendCommand(RenderCommandType type, void const* payload, uint16_t payloadSize)
+{
+    if (m_groups.empty())
+    {
+        BeginGroup(0);
+    }
+
+    RenderCommandHeader header;
+    header.m_type = type;
+    header.m_size = payloadSize;
+
+    size_t offset = m_commands.size();
+    m_commands.resize(offset + sizeof(RenderCommandHeader) + payloadSize);
+    memcpy(m_commands.data() + offset, &header, sizeof(RenderCommandHeader));
+    memcpy(m_commands.data() + offset + sizeof(RenderCommandHeader), payload, payloadSize);
+
+    m_groups.back().m_end = (uint32_t)m_commands.size();
+    m_commandCount++;
+}
+
+uint32_t RenderCommandBuffer::GetResourceIndex(void const* pointer, RenderCommandResourceType type)
+{
+    if (!pointer)
+        return RENDER_COMMAND_NO_RESOURCE;
+
+    auto it = m_resourceLookup.find(pointer);
+    if (it != m_resourceLookup.end())
+        return it->second;
+
+    uint32_t index = (uint32_t)m_resources.size();
+    RenderCommandResource resource;
+    resource.m_pointer = pointer;
+    resource.m_type = type;
+    m_resources.push_back(resource);
+    m_resourceLookup.emplace(pointer, index);
+    return index;
+}
+
+size_t RenderCommandBuffer::GetTotalBytes() const
+{
+    return m_commands.size() + m_groups.size() * sizeof(RenderCommandGroup) +
+        m_pcuVerts.size() * sizeof(Vertex_PCU) + m_pcutbnVerts.size() * sizeof(Vertex_PCUTBN) +
+        m_indices.size() * sizeof(unsigned int);
+}
+
+//-----------------------------------------------------------------------------------------------
+void RenderCommandBuffer::SetBlendMode(BlendMode blendMode)
+{
+    RenderCommandSetState cmd;
+    cmd.m_mode = (uint8_t)blendMode;
+    AppendCommand(RenderCommandType::SET_BLEND_MODE, &cmd, sizeof(cmd));
+}
+
+void RenderCommandBuffer::SetRasterizerMode(RasterizerMode rasterizerMode)
+{
+    RenderCommandSetState cmd;
+    cmd.m_mode = (uint8_t)rasterizerMode;
+    AppendCommand(RenderCommandType::SET_RASTERIZER_MODE, &cmd, sizeof(cmd));
+}
+
+void RenderCommandBuffer::SetSamplerMode(SamplerMode samplerMode, int slot)
+{
+    RenderCommandSetState cmd;
+    cmd.m_mode = (uint8_t)samplerMode;
+    cmd.m_slot = (uint8_t)slot;
+    AppendCommand(RenderCommandType::SET_SAMPLER_MODE, &cmd, sizeof(cmd));
+}
+
+void RenderCommandBuffer::SetDepthMode(DepthMode depthMode)
+{
+    RenderCommandSetState cmd;
+    cmd.m_mode = (uint8_t)depthMode;
+    AppendCommand(RenderCommandType::SET_DEPTH_MODE, &cmd, sizeof(cmd));
+}
+
+void RenderCommandBuffer::BindShader(Shader* shader)
+{
+    RenderCommandBind cmd;
+    cmd.m_resource = GetResourceIndex(shader, RenderCommandResourceType::SHADER);
+    AppendCommand(RenderCommandType::BIND_SHADER, &cmd, sizeof(cmd));
+}
+
+void RenderCommandBuffer::BindTexture(Texture const* texture, int slot)
+{
+    RenderCommandBind cmd;
+    cmd.m_resource = GetResourceIndex(texture, RenderCommandResourceType::TEXTURE);
+    cmd.m_slot = slot;
+    AppendCommand(RenderCommandType::BIND_TEXTURE, &cmd, sizeof(cmd));
+}
+
+void RenderCommandBuffer::SetModelConstants(Mat44 const& modelToWorldTransform, Rgba8 const& modelColor)
+{
+    RenderCommandModelConstants cmd;
+    memcpy(cmd.m_modelToWorld, modelToWorldTransform.m_values, sizeof(cmd.m_modelToWorld));
+    cmd.m_modelColor = modelColor;
+    AppendCommand(RenderCommandType::SET_MODEL_CONSTANTS, &cmd, sizeof(cmd));
+}
+
+void RenderCommandBuffer::SetMaterialConstants(Texture const* diffuseTex, Texture const* normalTex, Texture const* specularTex)
+{
+    RenderCommandMaterialConstants cmd;
+    cmd.m_diffuse = GetResourceIndex(diffuseTex, RenderCommandResourceType::TEXTURE);
+    cmd.m_normal = GetResourceIndex(normalTex, RenderCommandResourceType::TEXTURE);
+    cmd.m_specular = GetResourceIndex(specularTex, RenderCommandResourceType::TEXTURE);
+    AppendCommand(RenderCommandType::SET_MATERIAL_CONSTANTS, &cmd, sizeof(cmd));
+}
+
+void RenderCommandBuffer::DrawVertexArray(std::vector<Vertex_PCU> const& verts)
+{
+    DrawVertexArray((int)verts.size(), verts.data());
+}
+
+void RenderCommandBuffer::DrawVertexArray(int numVerts, Vertex_PCU const* verts)
+{
+    if (numVerts <= 0)
+        return;
+
+    RenderCommandDrawInline cmd;
+    cmd.m_firstVertex = (uint32_t)m_pcuVerts.size();
+    cmd.m_vertexCount = (uint32_t)numVerts;
+    m_pcuVerts.insert(m_pcuVerts.end(), verts, verts + numVerts);
+    AppendCommand(RenderCommandType::DRAW_PCU, &cmd, sizeof(cmd));
+    m_drawCount++;
+}
+
+void RenderCommandBuffer::DrawVertexArray(std::vector<Vertex_PCUTBN> const& verts)
+{
+    DrawVertexArray((int)verts.size(), verts.data());
+}
+
+void RenderCommandBuffer::DrawVertexArray(int numVerts, Vertex_PCUTBN const* verts)
+{
+    if (numVerts <= 0)
+        return;
+
+    RenderCommandDrawInline cmd;
+    cmd.m_firstVertex = (uint32_t)m_pcutbnVerts.size();
+    cmd.m_vertexCount = (uint32_t)numVerts;
+    m_pcutbnVerts.insert(m_pcutbnVerts.end(), verts, verts + numVerts);
+    AppendCommand(RenderCommandType::DRAW_PCUTBN, &cmd, sizeof(cmd));
+    m_drawCount++;
+}
+
+void RenderCommandBuffer::DrawVertexIndexArray(std::vector<Vertex_PCUTBN> const& verts, std::vector<unsigned int> const& indices)
+{
+    DrawVertexIndexArray((int)verts.size(), verts.data(), (int)indices.size(), indices.data());
+}
+
+void RenderCommandBuffer::DrawVertexIndexArray(int numVerts, Vertex_PCUTBN const* verts, int numIndices, unsigned int const* indices)
+{
+    if (numVerts <= 0 || numIndices <= 0)
+        return;
+
+    // 索引保持相对本次 draw 的顶点，回放时原样交给 DrawVertexIndexArray
+    RenderCommandDrawInline cmd;
+    cmd.m_firstVertex = (uint32_t)m_pcutbnVerts.size();
+    cmd.m_vertexCount = (uint32_t)numVerts;
+    cmd.m_firstIndex = (uint32_t)m_indices.size();
+    cmd.m_indexCount = (uint32_t)numIndices;
+    m_pcutbnVerts.insert(m_pcutbnVerts.end(), verts, verts + numVerts);
+    m_indices.insert(m_indices.end(), indices, indices + numIndices);
+    AppendCommand(RenderCommandType::DRAW_PCUTBN_INDEXED, &cmd, sizeof(cmd));
+    m_drawCount++;
+}
+
+void RenderCommandBuffer::DrawVertexBuffer(VertexBuffer* vbo, unsigned int vertexCount)
+{
+    RenderCommandDrawBuffer cmd;
+    cmd.m_vertexBuffer = GetResourceIndex(vbo, RenderCommandResourceType::VERTEX_BUFFER);
+    cmd.m_count = vertexCount;
+    AppendCommand(RenderCommandType::DRAW_VERTEX_BUFFER, &cmd, sizeof(cmd));
+    m_drawCount++;
+}
+
+void RenderCommandBuffer::DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, PrimitiveTopology topology, unsigned int startIndex)
+{
+    RenderCommandDrawBuffer cmd;
+    cmd.m_vertexBuffer = GetResourceIndex(vbo, RenderCommandResourceType::VERTEX_BUFFER);
+    cmd.m_indexBuffer = GetResourceIndex(ibo, RenderCommandResourceType::INDEX_BUFFER);
+    cmd.m_count = indexCount;
+    cmd.m_topology = (uint32_t)topology;
+    cmd.m_firstIndex = startIndex;
+    AppendCommand(RenderCommandType::DRAW_INDEX_BUFFER, &cmd, sizeof(cmd));
+    m_drawCount++;
+}
+
+//-----------------------------------------------------------------------------------------------
+namespace
+{
+    template<typename T>
+    T ReadPayload(uint8_t const* data)
+    {
+        T payload;
+        memcpy(&payload, data, sizeof(T));
+        return payload;
+    }
+
+    bool IsStateRedundant(int& current, int desired)
+    {
+        if (current == desired)
+            return true;
+        current = desired;
+        return false;
+    }
+}
+
+void RenderCommandBuffer::ExecuteRange(Renderer& renderer, uint32_t begin, uint32_t end, RenderCommandReplayState& state) const
+{
+    auto resolve = [this](uint32_t index) -> void const*
+    {
+        return (index < (uint32_t)m_resources.size()) ? m_resources[index].m_pointer : nullptr;
+    };
+
+    uint32_t offset = begin;
+    while (offset + sizeof(RenderCommandHeader) <= end)
+    {
+        RenderCommandHeader header = ReadPayload<RenderCommandHeader>(m_commands.data() + offset);
+        uint8_t const* payload = m_commands.data() + offset + sizeof(RenderCommandHeader);
+        offset += (uint32_t)sizeof(RenderCommandHeader) + header.m_size;
+        GUARANTEE_OR_DIE(offset <= end, "RenderCommandBuffer: command runs past the end of its group");
+
+        RenderCommandReplayStats& stats = state.m_stats;
+        stats.m_commandsExecuted++;
+
+        switch (header.m_type)
+        {
+        case RenderCommandType::SET_BLEND_MODE:
+        {
+            RenderCommandSetState cmd = ReadPayload<RenderCommandSetState>(payload);
+            if (IsStateRedundant(state.m_blendMode, cmd.m_mode))
+            {
+                stats.m_redundantCommandsSkipped++;
+                break;
+            }
+            renderer.SetBlendMode((BlendMode)cmd.m_mode);
+            break;
+        }
+        case RenderCommandType::SET_RASTERIZER_MODE:
+        {
+            RenderCommandSetState cmd = ReadPayload<RenderCommandSetState>(payload);
+            if (IsStateRedundant(state.m_rasterizerMode, cmd.m_mode))
+            {
+                stats.m_redundantCommandsSkipped++;
+                break;
+            }
+            renderer.SetRasterizerMode((RasterizerMode)cmd.m_mode);
+            break;
+        }
+        case RenderCommandType::SET_SAMPLER_MODE:
+        {
+            RenderCommandSetState cmd = ReadPayload<RenderCommandSetState>(payload);
+            if (cmd.m_slot < REPLAY_TRACKED_SLOTS && IsStateRedundant(state.m_samplerModes[cmd.m_slot], cmd.m_mode))
+            {
+                stats.m_redundantCommandsSkipped++;
+                break;
+            }
+            renderer.SetSamplerMode((SamplerMode)cmd.m_mode, cmd.m_slot);
+            break;
+        }
+        case RenderCommandType::SET_DEPTH_MODE:
+        {
+            RenderCommandSetState cmd = ReadPayload<RenderCommandSetState>(payload);
+            if (IsStateRedundant(state.m_depthMode, cmd.m_mode))
+            {
+                stats.m_redundantCommandsSkipped++;
+                break;
+            }
+            renderer.SetDepthMode((DepthMode)cmd.m_mode);
+            break;
+        }
+        case RenderCommandType::BIND_SHADER:
+        {
+            RenderCommandBind cmd = ReadPayload<RenderCommandBind>(payload);
+            void const* shader = resolve(cmd.m_resource);
+            if (state.m_shaderKnown && state.m_shader == shader)
+            {
+                stats.m_redundantCommandsSkipped++;
+                break;
+            }
+            state.m_shader = shader;
+            state.m_shaderKnown = true;
+            renderer.BindShader((Shader*)shader);
+            break;
+        }
+        case RenderCommandType::BIND_TEXTURE:
+        {
+            RenderCommandBind cmd = ReadPayload<RenderCommandBind>(payload);
+            void const* texture = resolve(cmd.m_resource);
+            if (cmd.m_slot >= 0 && cmd.m_slot < REPLAY_TRACKED_SLOTS)
+            {
+                if (state.m_texturesKnown[cmd.m_slot] && state.m_textures[cmd.m_slot] == texture)
+                {
+                    stats.m_redundantCommandsSkipped++;
+                    break;
+                }
+                state.m_textures[cmd.m_slot] = texture;
+                state.m_texturesKnown[cmd.m_slot] = true;
+            }
+            renderer.BindTexture((Texture const*)texture, cmd.m_slot);
+            break;
+        }
+        case RenderCommandType::SET_MODEL_CONSTANTS:
+        {
+            RenderCommandModelConstants cmd = ReadPayload<RenderCommandModelConstants>(payload);
+            renderer.SetModelConstants(Mat44(cmd.m_modelToWorld), cmd.m_modelColor);
+            break;
+        }
+        case RenderCommandType::SET_MATERIAL_CONSTANTS:
+        {
+            RenderCommandMaterialConstants cmd = ReadPayload<RenderCommandMaterialConstants>(payload);
+            renderer.SetMaterialConstants((Texture const*)resolve(cmd.m_diffuse), (Texture const*)resolve(cmd.m_normal),
+                (Texture const*)resolve(cmd.m_specular));
+            // DX11 的 material 走 slot 0..2 绑定，之后的 BindTexture 不能再按缓存跳过
+            for (int slot = 0; slot < 3; slot++)
+            {
+                state.m_texturesKnown[slot] = false;
+            }
+            break;
+        }
+        case RenderCommandType::DRAW_PCU:
+        {
+            RenderCommandDrawInline cmd = ReadPayload<RenderCommandDrawInline>(payload);
+            renderer.DrawVertexArray((int)cmd.m_vertexCount, m_pcuVerts.data() + cmd.m_firstVertex);
+            stats.m_drawsExecuted++;
+            break;
+        }
+        case RenderCommandType::DRAW_PCUTBN:
+        {
+            RenderCommandDrawInline cmd = ReadPayload<RenderCommandDrawInline>(payload);
+            renderer.DrawVertexArray((int)cmd.m_vertexCount, m_pcutbnVerts.data() + cmd.m_firstVertex);
+            stats.m_drawsExecuted++;
+            break;
+        }
+        case RenderCommandType::DRAW_PCUTBN_INDEXED:
+        {
+            RenderCommandDrawInline cmd = ReadPayload<RenderCommandDrawInline>(payload);
+            Vertex_PCUTBN const* verts = m_pcutbnVerts.data() + cmd.m_firstVertex;
+            unsigned int const* indices = m_indices.data() + cmd.m_firstIndex;
+#ifdef ENGINE_DX12_RENDERER
+            // DX12 只有 vector 版本的 immediate indexed draw
+            state.m_scratchVerts.assign(verts, verts + cmd.m_vertexCount);
+            state.m_scratchIndices.assign(indices, indices + cmd.m_indexCount);
+            renderer.DrawVertexIndexArray(state.m_scratchVerts, state.m_scratchIndices);
+#else
+            renderer.DrawVertexIndexArray((int)cmd.m_vertexCount, verts, (int)cmd.m_indexCount, indices);
+#endif
+            stats.m_drawsExecuted++;
+            break;
+        }
+        case RenderCommandType::DRAW_VERTEX_BUFFER:
+        {
+            RenderCommandDrawBuffer cmd = ReadPayload<RenderCommandDrawBuffer>(payload);
+            VertexBuffer* vbo = (VertexBuffer*)resolve(cmd.m_vertexBuffer);
+            if (!vbo)
+            {
+                stats.m_unresolvedDrawsSkipped++;
+                break;
+            }
+            renderer.DrawVertexBuffer(vbo, cmd.m_count);
+            stats.m_drawsExecuted++;
+            break;
+        }
+        case RenderCommandType::DRAW_INDEX_BUFFER:
+        {
+            RenderCommandDrawBuffer cmd = ReadPayload<RenderCommandDrawBuffer>(payload);
+            VertexBuffer* vbo = (VertexBuffer*)resolve(cmd.m_vertexBuffer);
+            IndexBuffer* ibo = (IndexBuffer*)resolve(cmd.m_indexBuffer);
+            if (!vbo || !ibo)
+            {
+                stats.m_unresolvedDrawsSkipped++;
+                break;
+            }
+            renderer.DrawIndexBuffer(vbo, ibo, cmd.m_count, (PrimitiveTopology)cmd.m_topology, cmd.m_firstIndex);
+            stats.m_drawsExecuted++;
+            break;
+        }
+        default:
+            ERROR_AND_DIE(Stringf("RenderCommandBuffer: unknown command type %d", (int)header.m_type));
+        }
+    }
+}
+
+void RenderCommandBuffer::Execute(Renderer& renderer, RenderCommandReplayStats* outStats) const
+{
+    RenderCommandReplayState state;
+    ExecuteRange(renderer, 0, (uint32_t)m_commands.size(), state);
+    state.m_stats.m_groupsExecuted = (uint32_t)m_groups.size();
+
+    if (outStats)
+    {
+        *outStats = state.m_stats;
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+void ExecuteRenderCommandBuffers(Renderer& renderer, RenderCommandBuffer const* const* buffers, int numBuffers,
+    RenderCommandReplayStats* outStats)
+{
+    struct GroupRef
+    {
+        uint64_t m_sortKey;
+        RenderCommandBuffer const* m_buffer;
+        RenderCommandGroup const* m_group;
+    };
+
+    std::vector<GroupRef> groups;
+    for (int i = 0; i < numBuffers; i++)
+    {
+        if (!buffers[i])
+            continue;
+
+        for (RenderCommandGroup const& group : buffers[i]->m_groups)
+        {
+            if (group.m_end > group.m_begin)
+            {
+                groups.push_back({ group.m_sortKey, buffers[i], &group });
+            }
+        }
+    }
+
+    // stable: 相同 key 保持 buffer 顺序 + 录制顺序
+    std::stable_sort(groups.begin(), groups.end(),
+        [](GroupRef const& a, GroupRef const& b) { return a.m_sortKey < b.m_sortKey; });
+
+    RenderCommandReplayState state;
+    for (GroupRef const& ref : groups)
+    {
+        ref.m_buffer->ExecuteRange(renderer, ref.m_group->m_begin, ref.m_group->m_end, state);
+    }
+    state.m_stats.m_groupsExecuted = (uint32_t)groups.size();
+
+    if (outStats)
+    {
+        *outStats = state.m_stats;
+    }
+}
+
+void ExecuteRenderCommandBuffers(Renderer& renderer, std::vector<RenderCommandBuffer> const& buffers, RenderCommandReplayStats* outStats)
+{
+    std::vector<RenderCommandBuffer const*> pointers;
+    pointers.reserve(buffers.size());
+    for (RenderCommandBuffer const& buffer : buffers)
+    {
+        pointers.push_back(&buffer);
+    }
+    ExecuteRenderCommandBuffers(renderer, pointers.data(), (int)pointers.size(), outStats);
+}
+
+void RecordRenderCommandsParallel(uint32_t itemCount, uint32_t itemsPerBuffer, std::vector<RenderCommandBuffer>& buffers,
+    RenderCommandRecordFunction const& record)
+{
+    if (itemsPerBuffer == 0)
+        itemsPerBuffer = 1;
+
+    uint32_t bufferCount = (itemCount + itemsPerBuffer - 1) / itemsPerBuffer;
+    if (buffers.size() < bufferCount)
+    {
+        buffers.resize(bufferCount);
+    }
+    for (RenderCommandBuffer& buffer : buffers)
+    {
+        buffer.Reset();
+    }
+
+    // 没有 worker 时 ParallelFor 会一次性给出整个范围，全部录进 buffers[0]，回放结果不变
+    ParallelFor(itemCount, itemsPerBuffer, [&](uint32_t begin, uint32_t end)
+    {
+        record(buffers[begin / itemsPerBuffer], begin, end);
+    });
+}
+
+//-----------------------------------------------------------------------------------------------
+namespace
+{
+    void AppendBytes(std::vector<uint8_t>& buffer, void const* data, size_t size)
+    {
+        uint8_t const* bytes = (uint8_t const*)data;
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    bool ReadBytes(std::vector<uint8_t> const& buffer, size_t& offset, void* outData, size_t size)
+    {
+        if (offset + size > buffer.size())
+            return false;
+        memcpy(outData, buffer.data() + offset, size);
+        offset += size;
+        return true;
+    }
+
+    template<typename T>
+    void AppendArray(std::vector<uint8_t>& buffer, std::vector<T> const& items)
+    {
+        uint32_t count = (uint32_t)items.size();
+        AppendBytes(buffer, &count, sizeof(count));
+        AppendBytes(buffer, items.data(), count * sizeof(T));
+    }
+
+    template<typename T>
+    bool ReadArray(std::vector<uint8_t> const& buffer, size_t& offset, std::vector<T>& outItems)
+    {
+        uint32_t count = 0;
+        if (!ReadBytes(buffer, offset, &count, sizeof(count)) || offset + (size_t)count * sizeof(T) > buffer.size())
+            return false;
+        outItems.resize(count);
+        return count == 0 || ReadBytes(buffer, offset, outItems.data(), count * sizeof(T));
+    }
+}
+
+bool SaveRenderCommandCapture(std::string const& capturePath, RenderCommandBuffer const* const* buffers, int numBuffers)
+{
+    std::vector<uint8_t> data;
+    uint32_t header[5] = { RENDER_CAPTURE_MAGIC, RENDER_CAPTURE_VERSION,
+                           (uint32_t)sizeof(Vertex_PCU), (uint32_t)sizeof(Vertex_PCUTBN), (uint32_t)numBuffers };
+    AppendBytes(data, header, sizeof(header));
+
+    for (int i = 0; i < numBuffers; i++)
+    {
+        RenderCommandBuffer const& buffer = *buffers[i];
+
+        // 资源按名字存；vbo/ibo 没有名字，只记类型
+        uint32_t resourceCount = (uint32_t)buffer.m_resources.size();
+        AppendBytes(data, &resourceCount, sizeof(resourceCount));
+        for (RenderCommandResource const& resource : buffer.m_resources)
+        {
+            std::string name;
+            if (resource.m_type == RenderCommandResourceType::SHADER)
+            {
+                name = ((Shader const*)resource.m_pointer)->GetName();
+            }
+            else if (resource.m_type == RenderCommandResourceType::TEXTURE)
+            {
+                name = ((Texture const*)resource.m_pointer)->GetImageFilePath();
+            }
+
+            uint8_t type = (uint8_t)resource.m_type;
+            uint32_t nameLength = (uint32_t)name.size();
+            AppendBytes(data, &type, sizeof(type));
+            AppendBytes(data, &nameLength, sizeof(nameLength));
+            AppendBytes(data, name.data(), nameLength);
+        }
+
+        AppendArray(data, buffer.m_groups);
+        AppendArray(data, buffer.m_commands);
+        AppendArray(data, buffer.m_pcuVerts);
+        AppendArray(data, buffer.m_pcutbnVerts);
+        AppendArray(data, buffer.m_indices);
+        AppendBytes(data, &buffer.m_commandCount, sizeof(buffer.m_commandCount));
+        AppendBytes(data, &buffer.m_drawCount, sizeof(buffer.m_drawCount));
+    }
+
+    return FileWriteFromBuffer(data, capturePath) == (int)data.size();
+}
+
+bool SaveRenderCommandCapture(std::string const& capturePath, std::vector<RenderCommandBuffer> const& buffers)
+{
+    std::vector<RenderCommandBuffer const*> pointers;
+    pointers.reserve(buffers.size());
+    for (RenderCommandBuffer const& buffer : buffers)
+    {
+        pointers.push_back(&buffer);
+    }
+    return SaveRenderCommandCapture(capturePath, pointers.data(), (int)pointers.size());
+}
+
+bool LoadRenderCommandCapture(std::string const& capturePath, Renderer& renderer, std::vector<RenderCommandBuffer>& outBuffers)
+{
+    std::vector<uint8_t> data;
+    if (FileReadToBuffer(data, capturePath) <= 0)
+        return false;
+
+    size_t offset = 0;
+    uint32_t header[5] = {};
+    if (!ReadBytes(data, offset, header, sizeof(header)))
+        return false;
+
+    if (header[0] != RENDER_CAPTURE_MAGIC || header[1] != RENDER_CAPTURE_VERSION ||
+        header[2] != (uint32_t)sizeof(Vertex_PCU) || header[3] != (uint32_t)sizeof(Vertex_PCUTBN))
+        return false;
+
+    std::vector<RenderCommandBuffer> buffers(header[4]);
+    for (RenderCommandBuffer& buffer : buffers)
+    {
+        uint32_t resourceCount = 0;
+        if (!ReadBytes(data, offset, &resourceCount, sizeof(resourceCount)))
+            return false;
+
+        buffer.m_resources.resize(resourceCount);
+        for (RenderCommandResource& resource : buffer.m_resources)
+        {
+            uint8_t type = 0;
+            uint32_t nameLength = 0;
+            if (!ReadBytes(data, offset, &type, sizeof(type)) || !ReadBytes(data, offset, &nameLength, sizeof(nameLength)) ||
+                offset + nameLength > data.size())
+                return false;
+
+            std::string name((char const*)data.data() + offset, nameLength);
+            offset += nameLength;
+
+            resource.m_type = (RenderCommandResourceType)type;
+            resource.m_pointer = nullptr;
+            if (resource.m_type == RenderCommandResourceType::SHADER && !name.empty())
+            {
+                resource.m_pointer = renderer.CreateOrGetShader(name.c_str());
+            }
+            else if (resource.m_type == RenderCommandResourceType::TEXTURE && !name.empty())
+            {
+                resource.m_pointer = renderer.GetTextureForFileName(name.c_str());
+            }
+        }
+
+        if (!ReadArray(data, offset, buffer.m_groups) || !ReadArray(data, offset, buffer.m_commands) ||
+            !ReadArray(data, offset, buffer.m_pcuVerts) || !ReadArray(data, offset, buffer.m_pcutbnVerts) ||
+            !ReadArray(data, offset, buffer.m_indices) ||
+            !ReadBytes(data, offset, &buffer.m_commandCount, sizeof(buffer.m_commandCount)) ||
+            !ReadBytes(data, offset, &buffer.m_drawCount, sizeof(buffer.m_drawCount)))
+            return false;
+
+        for (RenderCommandGroup const& group : buffer.m_groups)
+        {
+            if (group.m_begin > group.m_end || group.m_end > (uint32_t)buffer.m_commands.size())
+                return false;
+        }
+    }
+
+    outBuffers.swap(buffers);
+    return true;
+}
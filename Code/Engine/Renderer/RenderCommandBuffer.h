@@ -0,0 +1,222 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Engine/Renderer/RenderCommon.h"
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/Mat44.hpp"
+
+class Renderer;
+class Shader;
+class Texture;
+class VertexBuffer;
+class IndexBuffer;
+struct RenderCommandReplayState;
+
+//==============================================================================
+// RenderCommandBuffer - 后端无关的录制式命令缓冲
+//==============================================================================
+// Worker threads record state changes, constant updates and draws into their own buffer
+// (one buffer per worker / per batch, no locks). The main thread then merges the buffers,
+// sorts the groups by key and replays them through the Renderer facade, so the same
+// buffer runs on DX11, DX12 or the null backend.
+//
+// 编码：
+//   m_commands   紧凑字节流: [RenderCommandHeader][payload] ...
+//   m_resources  命令里只存资源下标，指针放在表里（也是 capture 能按名字重建的原因）
+//   顶点/索引    DrawVertexArray 的数据拷贝到缓冲自己的 arena，录制后调用方的数据可以丢掉
+//
+// Groups: BeginGroup(sortKey) starts a run of commands that replays as a unit. Groups
+// from all buffers are stable-sorted by key, so equal keys keep buffer order and the
+// result does not depend on which worker finished first. A group should set the state
+// it relies on; nothing is inherited from the group before it.
+//==============================================================================
+
+enum class RenderCommandType : uint8_t
+{
+    SET_BLEND_MODE,
+    SET_RASTERIZER_MODE,
+    SET_SAMPLER_MODE,
+    SET_DEPTH_MODE,
+    BIND_SHADER,
+    BIND_TEXTURE,
+    SET_MODEL_CONSTANTS,
+    SET_MATERIAL_CONSTANTS,
+    DRAW_PCU,
+    DRAW_PCUTBN,
+    DRAW_PCUTBN_INDEXED,
+    DRAW_VERTEX_BUFFER,
+    DRAW_INDEX_BUFFER,
+    COUNT
+};
+
+enum class RenderCommandResourceType : uint8_t
+{
+    SHADER,
+    TEXTURE,
+    VERTEX_BUFFER,
+    INDEX_BUFFER
+};
+
+static constexpr uint32_t RENDER_COMMAND_NO_RESOURCE = 0xFFFFFFFFu;
+
+struct RenderCommandHeader
+{
+    RenderCommandType m_type = RenderCommandType::COUNT;
+    uint8_t m_padding = 0;
+    uint16_t m_size = 0;          // payload bytes, header not included
+};
+
+// ---- payloads (POD, memcpy'd in and out of the stream) ----
+struct RenderCommandSetState
+{
+    uint8_t m_mode = 0;           // BlendMode / RasterizerMode / SamplerMode / DepthMode
+    uint8_t m_slot = 0;           // sampler only
+    uint16_t m_padding = 0;
+};
+
+struct RenderCommandBind
+{
+    uint32_t m_resource = RENDER_COMMAND_NO_RESOURCE;
+    int32_t m_slot = 0;
+};
+
+struct RenderCommandModelConstants
+{
+    float m_modelToWorld[16] = {};
+    Rgba8 m_modelColor;
+};
+
+struct RenderCommandMaterialConstants
+{
+    uint32_t m_diffuse = RENDER_COMMAND_NO_RESOURCE;
+    uint32_t m_normal = RENDER_COMMAND_NO_RESOURCE;
+    uint32_t m_specular = RENDER_COMMAND_NO_RESOURCE;
+};
+
+struct RenderCommandDrawInline
+{
+    uint32_t m_firstVertex = 0;
+    uint32_t m_vertexCount = 0;
+    uint32_t m_firstIndex = 0;
+    uint32_t m_indexCount = 0;
+};
+
+struct RenderCommandDrawBuffer
+{
+    uint32_t m_vertexBuffer = RENDER_COMMAND_NO_RESOURCE;
+    uint32_t m_indexBuffer = RENDER_COMMAND_NO_RESOURCE;
+    uint32_t m_count = 0;
+    uint32_t m_topology = PRIMITIVE_TRIANGLES;
+    uint32_t m_firstIndex = 0;
+};
+
+struct RenderCommandGroup
+{
+    uint64_t m_sortKey = 0;
+    uint32_t m_begin = 0;         // byte range in m_commands
+    uint32_t m_end = 0;
+};
+
+struct RenderCommandResource
+{
+    void const* m_pointer = nullptr;
+    RenderCommandResourceType m_type = RenderCommandResourceType::SHADER;
+};
+
+struct RenderCommandReplayStats
+{
+    uint32_t m_groupsExecuted = 0;
+    uint32_t m_commandsExecuted = 0;
+    uint32_t m_drawsExecuted = 0;
+    uint32_t m_redundantCommandsSkipped = 0;  // same state / shader / texture as the previous command
+    uint32_t m_unresolvedDrawsSkipped = 0;    // vbo / ibo missing (e.g. capture loaded in another session)
+};
+
+// layer 在最高位，其次 material（shader/texture 排在一起减少切换），最后 depth
+uint64_t MakeRenderSortKey(uint8_t layer, uint32_t material, uint32_t depth);
+
+class RenderCommandBuffer
+{
+    friend bool SaveRenderCommandCapture(std::string const& capturePath, RenderCommandBuffer const* const* buffers, int numBuffers);
+    friend bool LoadRenderCommandCapture(std::string const& capturePath, Renderer& renderer, std::vector<RenderCommandBuffer>& outBuffers);
+
+public:
+    void Reset();
+    void Reserve(size_t commandBytes, size_t numVerts);
+
+    void BeginGroup(uint64_t sortKey);
+
+    // Same names as Renderer so recording code reads like immediate code
+    void SetBlendMode(BlendMode blendMode);
+    void SetRasterizerMode(RasterizerMode rasterizerMode);
+    void SetSamplerMode(SamplerMode samplerMode, int slot = 0);
+    void SetDepthMode(DepthMode depthMode);
+    void BindShader(Shader* shader);
+    void BindTexture(Texture const* texture, int slot = 0);
+    void SetModelConstants(Mat44 const& modelToWorldTransform = Mat44(), Rgba8 const& modelColor = Rgba8::WHITE);
+    void SetMaterialConstants(Texture const* diffuseTex = nullptr, Texture const* normalTex = nullptr, Texture const* specularTex = nullptr);
+
+    void DrawVertexArray(std::vector<Vertex_PCU> const& verts);
+    void DrawVertexArray(int numVerts, Vertex_PCU const* verts);
+    void DrawVertexArray(std::vector<Vertex_PCUTBN> const& verts);
+    void DrawVertexArray(int numVerts, Vertex_PCUTBN const* verts);
+    void DrawVertexIndexArray(std::vector<Vertex_PCUTBN> const& verts, std::vector<unsigned int> const& indices);
+    void DrawVertexIndexArray(int numVerts, Vertex_PCUTBN const* verts, int numIndices, unsigned int const* indices);
+    void DrawVertexBuffer(VertexBuffer* vbo, unsigned int vertexCount);
+    void DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, PrimitiveTopology topology = PRIMITIVE_TRIANGLES, unsigned int startIndex = 0);
+
+    // Replays this buffer alone, in record order (sort keys ignored)
+    void Execute(Renderer& renderer, RenderCommandReplayStats* outStats = nullptr) const;
+
+    bool IsEmpty() const { return m_commandCount == 0; }
+    uint32_t GetCommandCount() const { return m_commandCount; }
+    uint32_t GetDrawCount() const { return m_drawCount; }
+    size_t GetCommandBytes() const { return m_commands.size(); }
+    size_t GetTotalBytes() const;
+    std::vector<RenderCommandGroup> const& GetGroups() const { return m_groups; }
+
+private:
+    void AppendCommand(RenderCommandType type, void const* payload, uint16_t payloadSize);
+    uint32_t GetResourceIndex(void const* pointer, RenderCommandResourceType type);
+    void ExecuteRange(Renderer& renderer, uint32_t begin, uint32_t end, RenderCommandReplayState& state) const;
+
+    friend void ExecuteRenderCommandBuffers(Renderer& renderer, RenderCommandBuffer const* const* buffers, int numBuffers,
+        RenderCommandReplayStats* outStats);
+
+private:
+    std::vector<uint8_t> m_commands;
+    std::vector<RenderCommandGroup> m_groups;
+    std::vector<RenderCommandResource> m_resources;
+    std::unordered_map<void const*, uint32_t> m_resourceLookup;
+
+    std::vector<Vertex_PCU> m_pcuVerts;
+    std::vector<Vertex_PCUTBN> m_pcutbnVerts;
+    std::vector<unsigned int> m_indices;
+
+    uint32_t m_commandCount = 0;
+    uint32_t m_drawCount = 0;
+};
+
+// Main thread: merge the groups of every buffer, stable-sort by key, replay in that order
+void ExecuteRenderCommandBuffers(Renderer& renderer, RenderCommandBuffer const* const* buffers, int numBuffers,
+    RenderCommandReplayStats* outStats = nullptr);
+void ExecuteRenderCommandBuffers(Renderer& renderer, std::vector<RenderCommandBuffer> const& buffers,
+    RenderCommandReplayStats* outStats = nullptr);
+
+// 每个 batch 一个 buffer: buffers[begin / itemsPerBuffer]，批次划分只看 item 数，与线程调度无关
+typedef std::function<void(RenderCommandBuffer& buffer, uint32_t begin, uint32_t end)> RenderCommandRecordFunction;
+void RecordRenderCommandsParallel(uint32_t itemCount, uint32_t itemsPerBuffer, std::vector<RenderCommandBuffer>& buffers,
+    RenderCommandRecordFunction const& record);
+
+// Capture for profiling: commands and inline geometry are stored as-is, shaders and
+// textures by name and resolved through the renderer on load. VertexBuffer / IndexBuffer
+// contents are not captured, so those draws are skipped when replaying a loaded capture.
+bool SaveRenderCommandCapture(std::string const& capturePath, RenderCommandBuffer const* const* buffers, int numBuffers);
+bool SaveRenderCommandCapture(std::string const& capturePath, std::vector<RenderCommandBuffer> const& buffers);
+bool LoadRenderCommandCapture(std::string const& capturePath, Renderer& renderer, std::vector<RenderCommandBuffer>& outBuffers);
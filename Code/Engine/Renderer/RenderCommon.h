@@ -1,7 +1,10 @@
 ﻿#pragma once
 #include "Engine/Math/AABB3.hpp"
+#include "Engine/Core/Rgba8.hpp"
 #include "Engine/Renderer/Cache/SurfaceCacheCommon.h"
 
+class StaticMesh;
+
 extern const char* m_shaderSource;
 
 #define DX_SAFE_RELEASE(dxObject)\
@@ -64,10 +67,12 @@ enum class VertexType
 {
     VERTEX_PCU,
     VERTEX_PCUTBN,
+    VERTEX_PCUTBN_PACKED,   // Vertex_PCUTBNPacked (Core/VertexQuantization.h)
+    VERTEX_PCUTBN_INSTANCED,// Vertex_PCUTBN in slot 0 + InstanceData per instance in slot 1
     COUNT
 };
 
-#ifdef ENGINE_DX11_RENDERER
+#if defined(ENGINE_DX11_RENDERER) || defined(ENGINE_NULL_RENDERER)
 static const int k_perFrameConstantsSlot = 1;
 static const int k_cameraConstantsSlot = 2;
 static const int k_modelConstantsSlot = 3;
@@ -106,6 +111,41 @@ struct ModelConstants
     float ModelColor[4];
 };
 
+// VERTEX_PCUTBN_INSTANCED 的 slot 1：INSTANCE_TRANSFORM0..2 (float4 rows) + INSTANCE_COLOR (unorm)
+// shader: worldPos = float3(dot(row0, p), dot(row1, p), dot(row2, p)), p = float4(pos, 1)
+struct InstanceData
+{
+    float m_modelToWorldRows[3][4];     // affine ModelToWorld, row-major; the w row is always (0,0,0,1)
+    Rgba8 m_color;
+
+    void Set(Mat44 const& modelToWorld, Rgba8 const& color)
+    {
+        float const* m = modelToWorld.m_values;
+        for (int row = 0; row < 3; row++)
+        {
+            m_modelToWorldRows[row][0] = m[Mat44::Ix + row];
+            m_modelToWorldRows[row][1] = m[Mat44::Jx + row];
+            m_modelToWorldRows[row][2] = m[Mat44::Kx + row];
+            m_modelToWorldRows[row][3] = m[Mat44::Tx + row];
+        }
+        m_color = color;
+    }
+
+    Mat44 GetModelToWorld() const
+    {
+        Mat44 result;
+        for (int row = 0; row < 3; row++)
+        {
+            result.m_values[Mat44::Ix + row] = m_modelToWorldRows[row][0];
+            result.m_values[Mat44::Jx + row] = m_modelToWorldRows[row][1];
+            result.m_values[Mat44::Kx + row] = m_modelToWorldRows[row][2];
+            result.m_values[Mat44::Tx + row] = m_modelToWorldRows[row][3];
+        }
+        return result;
+    }
+};
+static_assert(sizeof(InstanceData) == 52, "InstanceData is uploaded as-is");
+
 #ifdef ENGINE_PAST_VERSION_LIGHTS
 struct LightConstants //DirectionalLight
 {
@@ -302,7 +342,12 @@ static constexpr int SDF_GEN_OUTPUT_UAV = SDF_GEN_BASE + 4;   // 258
 // --- Section 10: SDF Textures (Slot 259+) ---
 static constexpr int SDF_TEXTURE_SRV_BASE = SDF_GEN_OUTPUT_UAV + 1;  // 259
 
-static constexpr int TOTAL_NUM_DESCRIPTORS = SDF_TEXTURE_SRV_BASE + MAX_SDF_TEXTURE_COUNT; // 387
+// --- Section 11: Transient descriptor tables (Slot 387+) ---
+// 每个 frame in flight 一段，BeginFrame 时整段重置
+static constexpr int MAX_TRANSIENT_DESCRIPTORS_PER_FRAME = 64;
+static constexpr int TRANSIENT_DESCRIPTOR_BASE = SDF_TEXTURE_SRV_BASE + MAX_SDF_TEXTURE_COUNT;  // 387
+
+static constexpr int TOTAL_NUM_DESCRIPTORS = TRANSIENT_DESCRIPTOR_BASE + MAX_TRANSIENT_DESCRIPTORS_PER_FRAME * FRAME_BUFFER_COUNT; // 579
 
 // ========================================
 // Shader Register Bindings (for Root Signature)
@@ -488,6 +533,8 @@ struct RadianceCacheConstants
 struct RenderItem //TODO: 删掉~
 {
     Mat44 m_worldMatrix;
+    StaticMesh* m_mesh = nullptr;
+    Rgba8 m_color;
     uint32_t m_meshID;
     uint32_t m_materialID;
     uint32_t m_objectID;
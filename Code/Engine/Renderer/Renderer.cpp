@@ -1,9 +1,12 @@
 ﻿//#define WIN32_LEAN_AND_MEAN
 
+#include "Engine/Renderer/Renderer.hpp"
+#ifndef ENGINE_NULL_RENDERER
 #include "Engine/Renderer/DX11Renderer.hpp"
+#endif
+#include "Engine/Renderer/NullRenderer.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
-#include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Shader.hpp"
 #include "Engine/Renderer/VertexBuffer.hpp"
 #include "Engine/Renderer/IndexBuffer.hpp"
@@ -11,7 +14,9 @@
 #include "Engine/Renderer/SpriteDefinition.hpp"
 
 #include "Engine/Core/EngineCommon.hpp"
+#ifndef ENGINE_NULL_RENDERER
 #include <windows.h>
+#endif
 //#include <gl/gl.h>
 #include <string.h>
 
@@ -26,6 +31,7 @@
 
 //#pragma comment( lib, "opengl32" )
 
+#ifndef ENGINE_NULL_RENDERER
 //Add dx11
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -47,6 +53,7 @@
 
 //HDC g_displayDeviceContext = nullptr;				// ...becomes void* Window::m_displayContext
 HGLRC g_openGLRenderingContext = nullptr;			// ...becomes void* Renderer::m_apiRenderingContext
+#endif
 
 // extern Window* g_theWindow;
 //
@@ -113,12 +120,16 @@ void* m_dxgiDebugModule = nullptr;
 Renderer::Renderer(RendererConfig config)
     :m_config(config)
 {
+	m_immediateBatchingEnabled = config.m_enableImmediateBatching;
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer = new DX11Renderer(config);
 #endif
 	#ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer = new DX12Renderer(config);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer = new NullRenderer(config);
+#endif
 }
 
 void Renderer::Startup() 
@@ -129,16 +140,23 @@ void Renderer::Startup()
 	#ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->Startup();
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->Startup();
+#endif
 }
 
 void Renderer::ShutDown()
 {
+	m_immediateBatcher.Clear();
 	#ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->ShutDown();
 	#endif
 	#ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->ShutDown();
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->ShutDown();
+#endif
 }
 
 void Renderer::BeginFrame() 
@@ -149,46 +167,82 @@ void Renderer::BeginFrame()
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->BeginFrame();
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->BeginFrame();
+#endif
+	m_boundState = ImmediateBatchState();
 }
 
 void Renderer::EndFrame() 
 {
+	PrepareForDirectAccess();
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->EndFrame();
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->EndFrame();
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->EndFrame();
+#endif
+	m_immediateBatcher.EndFrame();
 }
 
 void Renderer::ClearScreen(const Rgba8 & clearColor)
 {
+	FlushImmediateBatch();
 	#ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->ClearScreen(clearColor);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->ClearScreen(clearColor);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->ClearScreen(clearColor);
+#endif
 }
 
 void Renderer::ClearScreen()
 {
+	FlushImmediateBatch();
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->ClearScreen(Rgba8::MAGENTA);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->ClearScreen(Rgba8::MAGENTA);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->ClearScreen(Rgba8::MAGENTA);
+#endif
 }
 
 void Renderer::BeginCamera(const Camera& camera)
 {
+	// 同一个相机重复 Begin（UI 每个 widget 都会）不打断合批；backend 照常转发
+	Mat44 worldToCamera = camera.GetWorldToCameraTransform();
+	Mat44 cameraToRender = camera.GetCameraToRenderTransform();
+	Mat44 renderToClip = camera.GetRenderToClipTransform();
+	Vec3 cameraPosition = camera.GetPosition();
+	if (!m_boundState.m_cameraKnown || !AreTransformsEqual(worldToCamera, m_boundState.m_worldToCamera) ||
+		!AreTransformsEqual(cameraToRender, m_boundState.m_cameraToRender) || !AreTransformsEqual(renderToClip, m_boundState.m_renderToClip) ||
+		cameraPosition != m_boundState.m_cameraPosition)
+	{
+		FlushImmediateBatchForStateChange();
+		m_boundState.m_cameraKnown = true;
+		m_boundState.m_worldToCamera = worldToCamera;
+		m_boundState.m_cameraToRender = cameraToRender;
+		m_boundState.m_renderToClip = renderToClip;
+		m_boundState.m_cameraPosition = cameraPosition;
+	}
 	#ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->BeginCamera(camera);
 	#endif
 	#ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->BeginCamera(camera);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->BeginCamera(camera);
+#endif
 }
 
 void Renderer::EndCamera(const Camera& camera)
@@ -199,19 +253,55 @@ void Renderer::EndCamera(const Camera& camera)
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->EndCamera(camera);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->EndCamera(camera);
+#endif
 }
 
 void Renderer::SetViewport(const AABB2& normalizedViewport)
 {
+	FlushImmediateBatch();
+	m_boundState.m_cameraKnown = false;     // BeginCamera resets the viewport
 	#ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->SetViewport(normalizedViewport);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->SetViewport(normalizedViewport);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->SetViewport(normalizedViewport);
+#endif
 }
 
 void Renderer::DrawVertexArray(int numVerts, const Vertex_PCU* verts)
+{
+	if (!m_immediateBatchingEnabled)
+	{
+		SubmitVertexArray(numVerts, verts);
+		return;
+	}
+
+	ImmediateBatchStats& stats = m_immediateBatcher.GetFrameStats();
+	stats.m_requestedDraws++;
+	if (!ImmediateBatcher::IsBatchable(numVerts))
+	{
+		if (numVerts <= 0)
+			return;
+		PrepareForDirectDraw();
+		SubmitVertexArray(numVerts, verts);
+		stats.m_directDraws++;
+		return;
+	}
+
+	if (!m_immediateBatcher.CanAppend(numVerts))
+	{
+		stats.m_overflowFlushes++;
+		FlushImmediateBatch();
+	}
+	m_immediateBatcher.Append(numVerts, verts, m_requestedModelTransform, m_requestedModelColor);
+}
+
+void Renderer::SubmitVertexArray(int numVerts, const Vertex_PCU* verts)
 {
 	#ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->DrawVertexArray(numVerts, verts);
@@ -219,30 +309,42 @@ void Renderer::DrawVertexArray(int numVerts, const Vertex_PCU* verts)
 	#ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->DrawVertexArray(numVerts, verts);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->DrawVertexArray(numVerts, verts);
+#endif
 }
 
 void Renderer::DrawVertexArray(const std::vector<Vertex_PCUTBN>& verts)
 {
+	PrepareForDirectDraw();
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->DrawVertexArray(verts);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->DrawVertexArray(verts);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->DrawVertexArray(verts);
+#endif
 }
 
 void Renderer::DrawVertexArray(int numVerts, const Vertex_PCUTBN* verts)
 {
+	PrepareForDirectDraw();
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->DrawVertexArray(numVerts, verts);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->DrawVertexArray(numVerts, verts);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->DrawVertexArray(numVerts, verts);
+#endif
 }
 
 void Renderer::DrawVertexIndexArray(int numVerts, const Vertex_PCUTBN* verts, int numIndices, const unsigned int* indices)
 {
+	PrepareForDirectDraw();
 	#ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->DrawVertexIndexArray(numVerts, verts, numIndices, indices);
 #endif
@@ -254,10 +356,14 @@ void Renderer::DrawVertexIndexArray(int numVerts, const Vertex_PCUTBN* verts, in
 	UNUSED(verts);
 	ERROR_AND_DIE("Cannot use DX12 in this way!")
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->DrawVertexIndexArray(numVerts, verts, numIndices, indices);
+#endif
 }
 
 void Renderer::DrawVertexIndexArray(int numVerts, const Vertex_PCUTBN* verts, int numIndices, const unsigned int* indices, VertexBuffer* vbo, IndexBuffer* ibo)
 {
+	PrepareForDirectDraw();
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->DrawVertexIndexArray(numVerts, verts, numIndices, indices, vbo, ibo);
 #endif
@@ -271,20 +377,28 @@ void Renderer::DrawVertexIndexArray(int numVerts, const Vertex_PCUTBN* verts, in
 	UNUSED(ibo);
 	ERROR_AND_DIE("Cannot use DX12 in this way!")
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->DrawVertexIndexArray(numVerts, verts, numIndices, indices, vbo, ibo);
+#endif
 }
 
 void Renderer::DrawVertexIndexArray(const std::vector<Vertex_PCUTBN>& verts, const std::vector<unsigned int>& indices)
 {
+	PrepareForDirectDraw();
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->DrawVertexIndexArray(verts, indices);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->DrawVertexIndexArray(verts, indices);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->DrawVertexIndexArray(verts, indices);
+#endif
 }
 
 void Renderer::DrawVertexIndexArray(const std::vector<Vertex_PCUTBN>& verts, const std::vector<unsigned int>& indices, VertexBuffer* vbo, IndexBuffer* ibo)
 {
+	PrepareForDirectDraw();
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->DrawVertexIndexArray(verts, indices, vbo, ibo);
 #endif
@@ -295,16 +409,27 @@ void Renderer::DrawVertexIndexArray(const std::vector<Vertex_PCUTBN>& verts, con
 	UNUSED(ibo);
 	ERROR_AND_DIE("Cannot use DX12 in this way!")
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->DrawVertexIndexArray(verts, indices, vbo, ibo);
+#endif
 }
 
 void Renderer::DrawVertexArray(const std::vector<Vertex_PCU>& verts)
 {
+	if (m_immediateBatchingEnabled)
+	{
+		DrawVertexArray((int)verts.size(), verts.data());
+		return;
+	}
 	#ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->DrawVertexArray(verts);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->DrawVertexArray(verts);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->DrawVertexArray(verts);
+#endif
 }
 
 void Renderer::DrawAABB2(const AABB2& bounds, const Rgba8& color)
@@ -327,6 +452,51 @@ void Renderer::DrawAABB2(const AABB2& bounds, const Rgba8& color)
 	DrawVertexArray(6, verts);
 }
 
+//-----------------------------------------------------------------------------------------------
+void Renderer::FlushImmediateBatch()
+{
+	if (m_immediateBatcher.IsEmpty())
+		return;
+
+	// 顶点已经在 CPU 上乘过 model transform / color，batch 本身用 identity / white 画
+	SubmitModelConstants(Mat44(), Rgba8::WHITE);
+	m_modelConstantsDirty = !(IsIdentityModelTransform(m_requestedModelTransform) && m_requestedModelColor == Rgba8::WHITE);
+
+	SubmitVertexArray(m_immediateBatcher.GetVertexCount(), m_immediateBatcher.GetVerts());
+	m_immediateBatcher.GetFrameStats().m_submittedBatches++;
+	m_immediateBatcher.Clear();
+}
+
+void Renderer::FlushImmediateBatchForStateChange()
+{
+	if (m_immediateBatcher.IsEmpty())
+		return;
+	m_immediateBatcher.GetFrameStats().m_stateChangeFlushes++;
+	FlushImmediateBatch();
+}
+
+void Renderer::PrepareForDirectDraw()
+{
+	FlushImmediateBatch();
+	if (m_modelConstantsDirty)
+	{
+		SubmitModelConstants(m_requestedModelTransform, m_requestedModelColor);
+		m_modelConstantsDirty = false;
+	}
+}
+
+void Renderer::PrepareForDirectAccess()
+{
+	PrepareForDirectDraw();
+	m_boundState = ImmediateBatchState();
+}
+
+void Renderer::SetImmediateBatchingEnabled(bool enabled)
+{
+	PrepareForDirectDraw();
+	m_immediateBatchingEnabled = enabled;
+}
+
 Image* Renderer::CreateImageFromFile(char const* imageFilePath)
 {
 #ifdef ENGINE_DX11_RENDERER
@@ -335,6 +505,9 @@ Image* Renderer::CreateImageFromFile(char const* imageFilePath)
 #ifdef ENGINE_DX12_RENDERER
 	return m_dx12Renderer->CreateImageFromFile(imageFilePath);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	return m_nullRenderer->CreateImageFromFile(imageFilePath);
+#endif
 }
 
 Texture* Renderer::CreateTextureFromImage(const Image& image, bool usingMipmaps)
@@ -346,6 +519,75 @@ Texture* Renderer::CreateTextureFromImage(const Image& image, bool usingMipmaps)
 	UNUSED(usingMipmaps);
 	return m_dx12Renderer->CreateTextureFromImage(image);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	UNUSED(usingMipmaps);
+	return m_nullRenderer->CreateTextureFromImage(image);
+#endif
+}
+
+Texture* Renderer::CreateTextureFromMipChain(ImageMipChain const& mipChain, int residentMip)
+{
+#ifdef ENGINE_DX11_RENDERER
+	return m_dx11Renderer->CreateTextureFromMipChain(mipChain, residentMip);
+#endif
+#ifdef ENGINE_DX12_RENDERER
+	return m_dx12Renderer->CreateTextureFromMipChain(mipChain, residentMip);
+#endif
+#ifdef ENGINE_NULL_RENDERER
+	return m_nullRenderer->CreateTextureFromMipChain(mipChain, residentMip);
+#endif
+}
+
+Texture* Renderer::CreateTextureFromCompressedMipChain(CompressedMipChain const& mipChain, int residentMip)
+{
+#ifdef ENGINE_DX11_RENDERER
+	return m_dx11Renderer->CreateTextureFromCompressedMipChain(mipChain, residentMip);
+#endif
+#ifdef ENGINE_DX12_RENDERER
+	return m_dx12Renderer->CreateTextureFromCompressedMipChain(mipChain, residentMip);
+#endif
+#ifdef ENGINE_NULL_RENDERER
+	return m_nullRenderer->CreateTextureFromCompressedMipChain(mipChain, residentMip);
+#endif
+}
+
+void Renderer::UpdateTextureMips(Texture* texture, ImageMipChain const& mipChain, int residentMip)
+{
+#ifdef ENGINE_DX11_RENDERER
+	m_dx11Renderer->UpdateTextureMips(texture, mipChain, residentMip);
+#endif
+#ifdef ENGINE_DX12_RENDERER
+	m_dx12Renderer->UpdateTextureMips(texture, mipChain, residentMip);
+#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->UpdateTextureMips(texture, mipChain, residentMip);
+#endif
+}
+
+void Renderer::UpdateTextureMips(Texture* texture, CompressedMipChain const& mipChain, int residentMip)
+{
+#ifdef ENGINE_DX11_RENDERER
+	m_dx11Renderer->UpdateTextureMips(texture, mipChain, residentMip);
+#endif
+#ifdef ENGINE_DX12_RENDERER
+	m_dx12Renderer->UpdateTextureMips(texture, mipChain, residentMip);
+#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->UpdateTextureMips(texture, mipChain, residentMip);
+#endif
+}
+
+void Renderer::DropTextureMips(Texture* texture, int residentMip)
+{
+#ifdef ENGINE_DX11_RENDERER
+	m_dx11Renderer->DropTextureMips(texture, residentMip);
+#endif
+#ifdef ENGINE_DX12_RENDERER
+	m_dx12Renderer->DropTextureMips(texture, residentMip);
+#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->DropTextureMips(texture, residentMip);
+#endif
 }
 
 Texture* Renderer::CreateOrGetTextureFromFile(char const* imageFilePath, bool usingMipmaps)
@@ -357,6 +599,10 @@ Texture* Renderer::CreateOrGetTextureFromFile(char const* imageFilePath, bool us
 	UNUSED(usingMipmaps);
 	return m_dx12Renderer->CreateOrGetTextureFromFile(imageFilePath);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	UNUSED(usingMipmaps);
+	return m_nullRenderer->CreateOrGetTextureFromFile(imageFilePath);
+#endif
 }
 
 Texture* Renderer::CreateTextureFromFile(char const* imageFilePath, bool usingMipmaps)
@@ -368,6 +614,10 @@ Texture* Renderer::CreateTextureFromFile(char const* imageFilePath, bool usingMi
 	UNUSED(usingMipmaps);
 	return m_dx12Renderer->CreateTextureFromFile(imageFilePath);
 #endif
+#ifdef ENGINE_NULL_RENDERER
+	UNUSED(usingMipmaps);
+	return m_nullRenderer->CreateTextureFromFile(imageFilePath);
+#endif
 }
 
 Texture* Renderer::GetTextureForFileName(const char* imageFilePath)
@@ -378,6 +628,9 @@ Texture* Renderer::GetTextureForFileName(const char* imageFilePath)
 #ifdef ENGINE_DX12_RENDERER
 	return m_dx12Renderer->GetTextureByFileName(imageFilePath);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	return m_nullRenderer->GetTextureForFileName(imageFilePath);
+#endif
 }
 
 //------------------------------------------------------------------------------------------------
@@ -394,17 +647,33 @@ Texture* Renderer::CreateTextureFromData(char const* name, IntVec2 dimensions, i
 	UNUSED(usingMipmaps);
  	ERROR_AND_DIE("Cannot use DX12 in this way!")
  	#endif
+#ifdef ENGINE_NULL_RENDERER
+	UNUSED(usingMipmaps);
+	return m_nullRenderer->CreateTextureFromData(name, dimensions, bytesPerTexel, texelData);
+#endif
 }
 
 //-----------------------------------------------------------------------------------------------
 void Renderer::BindTexture(const Texture* texture, int slot)
 {
+	if (slot != 0 || !m_boundState.m_textureKnown || m_boundState.m_texture != texture)
+	{
+		FlushImmediateBatchForStateChange();
+	}
+	if (slot == 0)
+	{
+		m_boundState.m_texture = texture;
+		m_boundState.m_textureKnown = true;
+	}
 	#ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->BindTexture(texture,slot);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->BindTexture(texture,slot);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->BindTexture(texture, slot);
+#endif
 }
 
 BitmapFont* Renderer::CreateOrGetBitmapFont(const char* bitmapFontFilePathWithNoExtension)
@@ -415,6 +684,9 @@ BitmapFont* Renderer::CreateOrGetBitmapFont(const char* bitmapFontFilePathWithNo
 	#ifdef ENGINE_DX12_RENDERER
 	return m_dx12Renderer->CreateOrGetBitmapFont(bitmapFontFilePathWithNoExtension);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	return m_nullRenderer->CreateOrGetBitmapFont(bitmapFontFilePathWithNoExtension);
+#endif
 }
 
 Shader* Renderer::CreateShader(char const* shaderName, char const* shaderSource, VertexType vertexType)
@@ -425,6 +697,9 @@ Shader* Renderer::CreateShader(char const* shaderName, char const* shaderSource,
 #ifdef ENGINE_DX12_RENDERER
 	return m_dx12Renderer->CreateShader(shaderName, shaderSource, vertexType);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	return m_nullRenderer->CreateShader(shaderName, shaderSource, vertexType);
+#endif
 }
 
 Shader* Renderer::CreateShader(char const* shaderName, VertexType vertexType)
@@ -435,6 +710,9 @@ Shader* Renderer::CreateShader(char const* shaderName, VertexType vertexType)
 #ifdef ENGINE_DX12_RENDERER
 	return m_dx12Renderer->CreateShader(shaderName, vertexType);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	return m_nullRenderer->CreateShader(shaderName, vertexType);
+#endif
 }
 
 Shader* Renderer::CreateOrGetShader(char const* shaderName, VertexType vertexType)
@@ -445,6 +723,9 @@ Shader* Renderer::CreateOrGetShader(char const* shaderName, VertexType vertexTyp
 #ifdef ENGINE_DX12_RENDERER
 	return m_dx12Renderer->CreateShader(shaderName, vertexType);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	return m_nullRenderer->CreateOrGetShader(shaderName, vertexType);
+#endif
 }
 
 bool Renderer::CompileShaderToByteCode(char const* name, char const* source, char const* entryPoint, char const* target, std::vector<unsigned char>& outByteCode, ID3DBlob** shaderByteCode)
@@ -457,16 +738,29 @@ bool Renderer::CompileShaderToByteCode(char const* name, char const* source, cha
 	UNUSED(outByteCode);
 	return m_dx12Renderer->CompileShaderToByteCode(shaderByteCode, name, source, entryPoint, target);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	UNUSED(shaderByteCode);
+	return m_nullRenderer->CompileShaderToByteCode(outByteCode, name, source, entryPoint, target);
+#endif
 }
 
 void Renderer::BindShader(Shader* shader)
 {
+	if (!m_boundState.m_shaderKnown || m_boundState.m_shader != shader)
+	{
+		FlushImmediateBatchForStateChange();
+		m_boundState.m_shader = shader;
+		m_boundState.m_shaderKnown = true;
+	}
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->BindShader(shader);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->BindShader(shader);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->BindShader(shader);
+#endif
 }
 
 VertexBuffer* Renderer::CreateVertexBuffer(const unsigned int size, unsigned int stride)
@@ -477,6 +771,9 @@ VertexBuffer* Renderer::CreateVertexBuffer(const unsigned int size, unsigned int
 #ifdef ENGINE_DX12_RENDERER
 	return m_dx12Renderer->CreateVertexBuffer(size, stride);
 #endif
+#ifdef ENGINE_NULL_RENDERER
+	return m_nullRenderer->CreateVertexBuffer(size, stride);
+#endif
 }
 
 void Renderer::CopyCPUToGPU(const void* data, unsigned int size, VertexBuffer* vbo)
@@ -488,6 +785,9 @@ void Renderer::CopyCPUToGPU(const void* data, unsigned int size, VertexBuffer* v
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->CopyCPUToGPU(data, size, vbo);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->CopyCPUToGPU(data, size, vbo);
+#endif
 }
 
 void Renderer::BindVertexBuffer(VertexBuffer* vbo)
@@ -498,6 +798,9 @@ void Renderer::BindVertexBuffer(VertexBuffer* vbo)
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->BindVertexBuffer(vbo);
 #endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->BindVertexBuffer(vbo);
+#endif
 }
 
 IndexBuffer* Renderer::CreateIndexBuffer(const unsigned int size, unsigned int stride)
@@ -508,6 +811,9 @@ IndexBuffer* Renderer::CreateIndexBuffer(const unsigned int size, unsigned int s
 #ifdef ENGINE_DX12_RENDERER
 	return m_dx12Renderer->CreateIndexBuffer(size, stride);
 #endif
+#ifdef ENGINE_NULL_RENDERER
+	return m_nullRenderer->CreateIndexBuffer(size, stride);
+#endif
 }
 
 void Renderer::BindIndexBuffer(IndexBuffer* ibo)
@@ -518,17 +824,52 @@ void Renderer::BindIndexBuffer(IndexBuffer* ibo)
 	#ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->BindIndexBuffer(ibo);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->BindIndexBuffer(ibo);
+#endif
 }
 
-void Renderer::DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, PrimitiveTopology topology)
+void Renderer::DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, PrimitiveTopology topology, unsigned int startIndex)
 {
+	PrepareForDirectDraw();
 #ifdef ENGINE_DX11_RENDERER
-	m_dx11Renderer->DrawIndexBuffer(vbo, ibo, indexCount, topology);
+	m_dx11Renderer->DrawIndexBuffer(vbo, ibo, indexCount, topology, startIndex);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	UNUSED(topology)
-	m_dx12Renderer->DrawIndexedVertexBuffer(vbo, ibo, indexCount);
+	m_dx12Renderer->DrawIndexedVertexBuffer(vbo, ibo, indexCount, startIndex);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	UNUSED(topology);
+	m_nullRenderer->DrawIndexBuffer(vbo, ibo, indexCount, startIndex);
+#endif
+}
+
+void Renderer::UploadInstanceData(const InstanceData* instances, unsigned int instanceCount)
+{
+#ifdef ENGINE_DX11_RENDERER
+	m_dx11Renderer->UploadInstanceData(instances, instanceCount);
+#endif
+#ifdef ENGINE_DX12_RENDERER
+	m_dx12Renderer->UploadInstanceData(instances, instanceCount);
+#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->UploadInstanceData(instances, instanceCount);
+#endif
+}
+
+void Renderer::DrawIndexBufferInstanced(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, unsigned int firstInstance, unsigned int instanceCount, unsigned int startIndex)
+{
+	PrepareForDirectDraw();
+#ifdef ENGINE_DX11_RENDERER
+	m_dx11Renderer->DrawIndexBufferInstanced(vbo, ibo, indexCount, firstInstance, instanceCount, startIndex);
+#endif
+#ifdef ENGINE_DX12_RENDERER
+	m_dx12Renderer->DrawIndexBufferInstanced(vbo, ibo, indexCount, firstInstance, instanceCount, startIndex);
+#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->DrawIndexBufferInstanced(vbo, ibo, indexCount, firstInstance, instanceCount, startIndex);
+#endif
 }
 
 void Renderer::CopyCPUToGPU(const void* data, unsigned int size, IndexBuffer*& ibo)
@@ -539,6 +880,9 @@ void Renderer::CopyCPUToGPU(const void* data, unsigned int size, IndexBuffer*& i
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->CopyCPUToGPU(data, size, ibo);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->CopyCPUToGPU(data, size, ibo);
+#endif
 }
 
 ConstantBuffer* Renderer::CreateConstantBuffer(const unsigned int size)
@@ -550,10 +894,14 @@ ConstantBuffer* Renderer::CreateConstantBuffer(const unsigned int size)
 	UNUSED(size);
 	ERROR_AND_DIE("Cannot create a ConstantBuffer in DX12 interface!");
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	return m_nullRenderer->CreateConstantBuffer(size);
+#endif
 }
 
 void Renderer::CopyCPUToGPU(const void* data, unsigned int size, ConstantBuffer* cbo)
 {
+	FlushImmediateBatch();
 	#ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->CopyCPUToGPU(data, size, cbo);
 #endif
@@ -563,36 +911,55 @@ void Renderer::CopyCPUToGPU(const void* data, unsigned int size, ConstantBuffer*
 	UNUSED(size);
 	UNUSED(cbo);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->CopyCPUToGPU(data, size, cbo);
+#endif
 }
 
 void Renderer::BindConstantBuffer(int slot, ConstantBuffer* cbo)
 {
+	FlushImmediateBatch();
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->BindConstantBuffer(slot, cbo);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->BindConstantBuffer(slot, cbo);
 #endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->BindConstantBuffer(slot, cbo);
+#endif
 }
 
 void Renderer::DrawVertexBuffer(VertexBuffer* vbo, unsigned int vertexCount)
 {
+	PrepareForDirectDraw();
 	#ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->DrawVertexBuffer(vbo, vertexCount);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->DrawVertexBuffer(vbo, vertexCount);
 #endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->DrawVertexBuffer(vbo, vertexCount);
+#endif
 }
 
 void Renderer::SetBlendMode(BlendMode blendMode)
 {
+	if (m_boundState.m_blendMode != (int)blendMode)
+	{
+		FlushImmediateBatchForStateChange();
+		m_boundState.m_blendMode = (int)blendMode;
+	}
 	#ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->SetBlendMode(blendMode);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->SetBlendMode(blendMode);
 #endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->SetBlendMode(blendMode);
+#endif
 }
 
 void Renderer::SetBlendModeIfChanged()
@@ -614,16 +981,32 @@ void Renderer::SetRasterizerModeIfChanged()
 
 void Renderer::SetRasterizerMode(RasterizerMode rasterizerMode)
 {
+	if (m_boundState.m_rasterizerMode != (int)rasterizerMode)
+	{
+		FlushImmediateBatchForStateChange();
+		m_boundState.m_rasterizerMode = (int)rasterizerMode;
+	}
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->SetRasterizerMode(rasterizerMode);
 #endif
 	#ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->SetRasterizerMode(rasterizerMode);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->SetRasterizerMode(rasterizerMode);
+#endif
 }
 
 void Renderer::SetSamplerMode(SamplerMode samplerMode, int slot)
 {
+	if (slot != 0 || m_boundState.m_samplerMode != (int)samplerMode)
+	{
+		FlushImmediateBatchForStateChange();
+	}
+	if (slot == 0)
+	{
+		m_boundState.m_samplerMode = (int)samplerMode;
+	}
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->SetSamplerMode(samplerMode, slot);
 #endif
@@ -631,6 +1014,9 @@ void Renderer::SetSamplerMode(SamplerMode samplerMode, int slot)
 	UNUSED(slot);
 	m_dx12Renderer->SetSamplerMode(samplerMode);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->SetSamplerMode(samplerMode, slot);
+#endif
 }
 
 void Renderer::SetSamplerModeIfChanged()
@@ -648,16 +1034,27 @@ void Renderer::SetSamplerModeIfChanged(int slot)
 #ifdef ENGINE_DX12_RENDERER
 	UNUSED(slot);
 #endif
+#ifdef ENGINE_NULL_RENDERER
+	UNUSED(slot);
+#endif
 }
 
 void Renderer::SetDepthMode(DepthMode depthMode)
 {
+	if (m_boundState.m_depthMode != (int)depthMode)
+	{
+		FlushImmediateBatchForStateChange();
+		m_boundState.m_depthMode = (int)depthMode;
+	}
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->SetDepthMode(depthMode);
 #endif
 	#ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->SetDepthMode(depthMode);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->SetDepthMode(depthMode);
+#endif
 }
 
 void Renderer::SetDepthModeIfChanged()
@@ -669,12 +1066,16 @@ void Renderer::SetDepthModeIfChanged()
 
 void Renderer::SetRenderMode(RenderMode renderMode)
 {
+	PrepareForDirectAccess();
 #ifdef ENGINE_DX11_RENDERER
 	UNUSED(renderMode);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->BeginRenderPass(renderMode);
 #endif
+#ifdef ENGINE_NULL_RENDERER
+	UNUSED(renderMode);
+#endif
 }
 
 void Renderer::SetGeneralLightConstants(const Rgba8 sunColor, const Vec3& sunNormal, int numLights,
@@ -682,6 +1083,7 @@ void Renderer::SetGeneralLightConstants(const Rgba8 sunColor, const Vec3& sunNor
                                         std::vector<float> ambiences, std::vector<float> innerRadii, std::vector<float> outerRadii,
                                         std::vector<float> innerDotThresholds, std::vector<float> outerDotThresholds)
 {
+	FlushImmediateBatch();
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->SetGeneralLightConstants(sunColor, sunNormal, numLights,
 										colors, worldPositions, spotForwards,
@@ -694,6 +1096,12 @@ void Renderer::SetGeneralLightConstants(const Rgba8 sunColor, const Vec3& sunNor
 		ambiences, innerRadii, outerRadii,
 		innerDotThresholds, outerDotThresholds);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->SetGeneralLightConstants(sunColor, sunNormal, numLights,
+		colors, worldPositions, spotForwards,
+		ambiences, innerRadii, outerRadii,
+		innerDotThresholds, outerDotThresholds);
+#endif
 }
 
 
@@ -775,6 +1183,20 @@ void Renderer::SetSpotLightConstants(const std::vector<Vec3>& pos, std::vector<f
 #endif
 
 void Renderer::SetModelConstants(const Mat44& modelToWorldTransform, const Rgba8& modelColor)
+{
+	m_requestedModelTransform = modelToWorldTransform;
+	m_requestedModelColor = modelColor;
+	if (m_immediateBatchingEnabled)
+	{
+		// 合批的顶点在 Append 时烘进去；直接 draw 之前再补交给 backend
+		m_modelConstantsDirty = true;
+		return;
+	}
+	SubmitModelConstants(modelToWorldTransform, modelColor);
+	m_modelConstantsDirty = false;
+}
+
+void Renderer::SubmitModelConstants(const Mat44& modelToWorldTransform, const Rgba8& modelColor)
 {
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->SetModelConstants(modelToWorldTransform, modelColor);
@@ -782,10 +1204,22 @@ void Renderer::SetModelConstants(const Mat44& modelToWorldTransform, const Rgba8
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->SetModelConstants(modelToWorldTransform, modelColor);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->SetModelConstants(modelToWorldTransform, modelColor);
+#endif
 }
 
 void Renderer::SetMaterialConstants(const Texture* diffuseTex, const Texture* normalTex, const Texture* specularTex)
 {
+	if (!m_boundState.m_materialKnown || m_boundState.m_material[0] != diffuseTex ||
+		m_boundState.m_material[1] != normalTex || m_boundState.m_material[2] != specularTex)
+	{
+		FlushImmediateBatchForStateChange();
+		m_boundState.m_materialKnown = true;
+		m_boundState.m_material[0] = diffuseTex;
+		m_boundState.m_material[1] = normalTex;
+		m_boundState.m_material[2] = specularTex;
+	}
 #ifdef ENGINE_DX11_RENDERER
 	UNUSED(diffuseTex);
 	UNUSED(normalTex);
@@ -794,26 +1228,39 @@ void Renderer::SetMaterialConstants(const Texture* diffuseTex, const Texture* no
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->SetMaterialConstants(diffuseTex, normalTex, specularTex);
 #endif
+#ifdef ENGINE_NULL_RENDERER
+	UNUSED(diffuseTex);
+	UNUSED(normalTex);
+	UNUSED(specularTex);
+#endif
 }
 
 void Renderer::SetShadowConstants(const Mat44& lightViewProjectionMatrix)
 {
+	FlushImmediateBatch();
 	#ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->SetShadowConstants(lightViewProjectionMatrix);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	UNUSED(lightViewProjectionMatrix);
 #endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->SetShadowConstants(lightViewProjectionMatrix);
+#endif
 }
 
 void Renderer::SetPerFrameConstants(const float time, const int debugInt, const float debugFloat)
 {
+	FlushImmediateBatch();
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->SetPerFrameConstants(time, debugInt, debugFloat);
 #endif
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12Renderer->SetPerFrameConstants(time, debugInt, debugFloat);
 	#endif
+#ifdef ENGINE_NULL_RENDERER
+	m_nullRenderer->SetPerFrameConstants(time, debugInt, debugFloat);
+#endif
 }
 
 //------------------------------------------------------
@@ -826,6 +1273,9 @@ void Renderer::CreateDeviceAndSwapChain(unsigned int deviceFlags)
 #ifdef ENGINE_DX12_RENDERER
 	UNUSED(deviceFlags);
 #endif
+#ifdef ENGINE_NULL_RENDERER
+	UNUSED(deviceFlags);
+#endif
 }
 
 void Renderer::GetBackBufferTexture()
@@ -893,6 +1343,7 @@ void Renderer::CreateShadowMapResources()
 
 void Renderer::BeginShadowPass()
 {
+	PrepareForDirectAccess();
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->BeginShadowPass();
 #endif
@@ -900,6 +1351,7 @@ void Renderer::BeginShadowPass()
 
 void Renderer::EndShadowPass()
 {
+	PrepareForDirectAccess();
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->EndShadowPass();
 #endif
@@ -914,6 +1366,7 @@ void Renderer::CreateShadowMapShader() //Only create
 
 void Renderer::BindShadowMapTextureAndSampler()
 {
+	PrepareForDirectAccess();
 #ifdef ENGINE_DX11_RENDERER
 	m_dx11Renderer->BindShadowMapTextureAndSampler();
 #endif
@@ -1,9 +1,12 @@
 ﻿#pragma once
+#include "Game/EngineBuildPreferences.hpp"
+#ifndef ENGINE_NULL_RENDERER
 #include <d3d11.h>
+#endif
 
-#include "Game/EngineBuildPreferences.hpp"
 #include "Engine/Renderer/RenderCommon.h"
 #include "Engine/Renderer/Camera.hpp"
+#include "Engine/Renderer/ImmediateBatcher.h"
 #include "Engine/Core/EngineConfig.h"
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Core/Vertex_PCU.hpp"
@@ -23,10 +26,13 @@
 
 class DX11Renderer;
 class DX12Renderer;
+class NullRenderer;
 
 class Window;
 class BitmapFont;
 class Image;
+struct ImageMipChain;
+struct CompressedMipChain;
 class Texture;
 class Shader;
 class VertexBuffer;
@@ -43,6 +49,10 @@ struct ID3D11SamplerState;
 struct ID3D11Texure2D;
 struct ID3D11DepthStencilView;
 struct ID3D11DepthStencilState;
+#ifdef ENGINE_NULL_RENDERER
+struct ID3D10Blob;
+typedef ID3D10Blob ID3DBlob;
+#endif
 
 // #if defined(OPAQUE)
 // #undef OPAQUE
@@ -97,6 +107,7 @@ struct RendererConfig
     Window* m_window = nullptr;
 	//RenderMode m_mode = RenderMode::FORWARD;
 	bool m_fullscreen = false;
+    bool m_enableImmediateBatching = true;     // merge consecutive DrawVertexArray(Vertex_PCU) calls
 #ifdef ENGINE_DX12_RENDERER
     bool m_enableGI = false;
     //GIConfig m_giConfig;
@@ -148,8 +159,24 @@ public:
 
     void DrawAABB2(const AABB2& bounds, const Rgba8& color);
 
+    //Immediate batching: Vertex_PCU draws with the same state are merged until a state change / EndFrame
+    void FlushImmediateBatch();
+    void SetImmediateBatchingEnabled(bool enabled);
+    bool IsImmediateBatchingEnabled() const { return m_immediateBatchingEnabled; }
+    ImmediateBatchStats const& GetImmediateBatchStats() const { return m_immediateBatcher.GetLastFrameStats(); }
+
     Image* CreateImageFromFile(char const* imageFilePath);
     Texture* CreateTextureFromImage(const Image& image, bool usingMipmaps = false);
+    // every level of the chain is uploaded as is (CPU-filtered, see ImageMipChain), no GPU GenerateMips.
+    // residentMip > 0 leaves the finer levels out (texture residency streams them in later)
+    Texture* CreateTextureFromMipChain(ImageMipChain const& mipChain, int residentMip = 0);
+    // BCn blocks go to the GPU as they are (see BlockCompression); top level must be a multiple of 4
+    Texture* CreateTextureFromCompressedMipChain(CompressedMipChain const& mipChain, int residentMip = 0);
+    // texture residency (see TextureResidency): upload the chain from residentMip down into an
+    // existing texture, or drop the levels finer than residentMip. The Texture* stays valid
+    void UpdateTextureMips(Texture* texture, ImageMipChain const& mipChain, int residentMip);
+    void UpdateTextureMips(Texture* texture, CompressedMipChain const& mipChain, int residentMip);
+    void DropTextureMips(Texture* texture, int residentMip);
     Texture* CreateOrGetTextureFromFile(char const* imageFilePath, bool usingMipmaps = false);
     Texture* CreateTextureFromData(char const* name, IntVec2 dimensions, int bytesPerTexel, uint8_t* texelData, bool usingMipmaps = false);
     Texture* CreateTextureFromFile(char const* imageFilePath, bool usingMipmaps = false);
@@ -177,7 +204,10 @@ public:
 
     IndexBuffer* CreateIndexBuffer(const unsigned int size, unsigned int stride);
     void BindIndexBuffer(IndexBuffer* ibo);
-	void DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, PrimitiveTopology topology = PRIMITIVE_TRIANGLES);
+	void DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, PrimitiveTopology topology = PRIMITIVE_TRIANGLES, unsigned int startIndex = 0);
+	// Instancing: upload the frame's InstanceData once, then draw ranges of it (shader needs VERTEX_PCUTBN_INSTANCED)
+	void UploadInstanceData(const InstanceData* instances, unsigned int instanceCount);
+	void DrawIndexBufferInstanced(VertexBuffer* vbo, IndexBuffer* ibo, unsigned int indexCount, unsigned int firstInstance, unsigned int instanceCount, unsigned int startIndex = 0);
     void CopyCPUToGPU(const void* data, unsigned int size, IndexBuffer*& ibo);
 	
     ConstantBuffer* CreateConstantBuffer(const unsigned int size);
@@ -231,15 +261,24 @@ public:
 #ifdef ENGINE_DX11_RENDERER
         DX11Renderer* GetSubRenderer() 
         {
+            PrepareForDirectAccess();
             return m_dx11Renderer;
         }
 #endif
 #ifdef ENGINE_DX12_RENDERER
 		DX12Renderer* GetSubRenderer()
 		{
+			PrepareForDirectAccess();
 			return m_dx12Renderer;
 		}
 #endif
+#ifdef ENGINE_NULL_RENDERER
+		NullRenderer* GetSubRenderer()
+		{
+			PrepareForDirectAccess();
+			return m_nullRenderer;
+		}
+#endif
 public:
 		RendererConfig m_config;
 
@@ -250,6 +289,24 @@ protected:
 #ifdef ENGINE_DX12_RENDERER
     DX12Renderer* m_dx12Renderer = nullptr;
 #endif
+#ifdef ENGINE_NULL_RENDERER
+    NullRenderer* m_nullRenderer = nullptr;     // headless: counts calls instead of touching a device
+#endif
+
+private:
+    // 真正转给 backend 的调用；合批路径和直接路径都走这里
+    void SubmitVertexArray(int numVerts, const Vertex_PCU* verts);
+    void SubmitModelConstants(const Mat44& modelToWorldTransform, const Rgba8& modelColor);
+    void FlushImmediateBatchForStateChange();
+    void PrepareForDirectDraw();         // flush + make the backend's model constants match what the caller asked for
+    void PrepareForDirectAccess();       // PrepareForDirectDraw + forget tracked state (caller may change it behind our back)
+
+    ImmediateBatcher m_immediateBatcher;
+    ImmediateBatchState m_boundState;
+    bool m_immediateBatchingEnabled = true;
+    Mat44 m_requestedModelTransform;
+    Rgba8 m_requestedModelColor = Rgba8::WHITE;
+    bool m_modelConstantsDirty = false;  // backend holds something other than the requested model constants
 
 private:
     //void* m_windowHandle = nullptr; 
@@ -1,6 +1,7 @@
 #include "Shader.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 
+#ifndef ENGINE_NULL_RENDERER
 //Add dx11 & dx12
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -13,8 +14,9 @@
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "d3dcompiler.lib")
+#endif
 
-#if defined(ENGINE_DEBUG_RENDER)
+#if defined(ENGINE_DEBUG_RENDER) && !defined(ENGINE_NULL_RENDERER)
 #include <dxgidebug.h>
 #pragma comment(lib, "dxguid.lib")
 #endif
@@ -29,9 +31,11 @@ Shader::~Shader()
 	/*m_vertexShader->Release();
 	m_pixelShader->Release();
 	m_inputLayout->Release();*/
+#ifndef ENGINE_NULL_RENDERER
 	DX_SAFE_RELEASE(m_vertexShader);
 	DX_SAFE_RELEASE(m_pixelShader);
 	DX_SAFE_RELEASE(m_inputLayout);
+#endif
 
 #ifdef ENGINE_DX12_RENDERER
 	DX_SAFE_RELEASE(m_dx12VertexShader);
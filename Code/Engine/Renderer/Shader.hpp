@@ -11,6 +11,7 @@ struct	ID3D11InputLayout;
 
 struct ID3D10Blob;
 struct D3D12_INPUT_LAYOUT_DESC;
+class RenderCommandBuffer;
 
 struct ShaderConfig
 {
@@ -24,6 +25,8 @@ class Shader
 	friend class Renderer;
 	friend class DX11Renderer;
 	friend class DX12Renderer;
+	friend class NullRenderer;
+	friend bool SaveRenderCommandCapture(std::string const& capturePath, RenderCommandBuffer const* const* buffers, int numBuffers); // 按名字存 shader
 
 private:
 	Shader(const ShaderConfig& config);
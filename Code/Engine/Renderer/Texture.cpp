@@ -2,6 +2,7 @@
 #include "Engine/Renderer/Renderer.hpp"
 //#include <d3d11.h>
 
+#ifndef ENGINE_NULL_RENDERER
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include <d3d11.h>
@@ -13,8 +14,9 @@
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "d3dcompiler.lib")
+#endif
 
-#if defined(ENGINE_DEBUG_RENDER)
+#if defined(ENGINE_DEBUG_RENDER) && !defined(ENGINE_NULL_RENDERER)
 #include <dxgidebug.h>
 #pragma comment(lib, "dxguid.lib")
 #endif
@@ -12,6 +12,7 @@ class Texture
 	friend class Renderer; // Only the Renderer can create new Texture objects!
 	friend class DX11Renderer;
 	friend class DX12Renderer;
+	friend class NullRenderer;
 
 private:
 	Texture(); // can't instantiate directly; must ask Renderer to do it for you
@@ -21,10 +22,14 @@ private:
 public:
 	IntVec2				GetDimensions() const { return m_dimensions; }
 	std::string const& GetImageFilePath() const { return m_name; }
+	int					GetMipLevelCount() const { return m_mipLevelCount; }
+	int					GetResidentMip() const { return m_residentMip; }	// finest level on the GPU (texture residency)
 
 protected:
 	std::string			m_name;
 	IntVec2				m_dimensions;
+	int					m_mipLevelCount = 1;	// full chain, even while the finer levels are not resident
+	int					m_residentMip = 0;
 
 	//unsigned int		m_openglTextureID = 0xFFFFFFFF;
 
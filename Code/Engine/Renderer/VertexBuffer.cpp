@@ -2,6 +2,7 @@
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 
+#ifndef ENGINE_NULL_RENDERER
 //Add dx11
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -17,6 +18,7 @@
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "d3dcompiler.lib")
+#endif
 
 VertexBuffer::VertexBuffer(ID3D11Device* device, unsigned int size, unsigned int stride)
 	: m_device(device)
@@ -75,6 +77,8 @@ unsigned int VertexBuffer::AppendData(const void* data, unsigned int size)
 	unsigned int startVertexOffset = (unsigned int)m_offset / m_stride;
 
 	m_offset += size;
+	if (m_offset > m_peakOffset)
+		m_peakOffset = m_offset;
 	return startVertexOffset;
 }
 
@@ -86,9 +90,19 @@ VertexBuffer::VertexBuffer(unsigned int size, unsigned int stride)
 }
 #endif
 
+#ifdef ENGINE_NULL_RENDERER
+VertexBuffer::VertexBuffer(unsigned int size, unsigned int stride)
+	: m_size(size)
+	, m_stride(stride)
+{
+}
+#endif
+
 VertexBuffer::~VertexBuffer()
 {
+#ifndef ENGINE_NULL_RENDERER
     DX_SAFE_RELEASE(m_buffer);
+#endif
 
 #ifdef ENGINE_DX12_RENDERER
 	m_dx12VertexBuffer->Unmap(0, nullptr); 
@@ -99,6 +113,7 @@ VertexBuffer::~VertexBuffer()
 
 void VertexBuffer::Create()
 {
+#ifndef ENGINE_NULL_RENDERER
 	//Create vertex buffer
 	UINT vertexBufferSize = m_size;
 	D3D11_BUFFER_DESC bufferDesc = {};
@@ -113,6 +128,7 @@ void VertexBuffer::Create()
 	{
 		ERROR_AND_DIE("Could not create vertex buffer.");
 	}
+#endif
 }
 
 void VertexBuffer::Resize(unsigned int size) //Resize should safe release m_buffer and create one of the new size.
@@ -122,7 +138,9 @@ void VertexBuffer::Resize(unsigned int size) //Resize should safe release m_buff
 		return; 
 	}
 
+#ifndef ENGINE_NULL_RENDERER
 	DX_SAFE_RELEASE(m_buffer);
+#endif
 
 	m_size = size;
 
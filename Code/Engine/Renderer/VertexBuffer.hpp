@@ -1,7 +1,10 @@
 #pragma once
+#include "Game/EngineBuildPreferences.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#ifndef ENGINE_NULL_RENDERER
 #include <d3d11.h>
 #include <d3d12.h>
+#endif
 
 struct ID3D11Device;
 struct ID3D11Buffer;
@@ -14,6 +17,7 @@ class VertexBuffer
 	friend class Renderer;
 	friend class DX11Renderer;
 	friend class DX12Renderer;
+	friend class NullRenderer;
 
 public:
 	VertexBuffer(ID3D11Device* device, unsigned int size, unsigned int stride);
@@ -21,9 +25,13 @@ public:
 	VertexBuffer(ID3D12Device* device, unsigned int size, unsigned int stride);
 	void ResetRing();
 	unsigned int AppendData(const void* data, unsigned int size);
+	size_t GetPeakRingUsage() const { return m_peakOffset; }
 	
 	VertexBuffer(unsigned int size, unsigned int stride);
 #endif
+#ifdef ENGINE_NULL_RENDERER
+	VertexBuffer(unsigned int size, unsigned int stride);
+#endif
 
 	VertexBuffer(const VertexBuffer& copy) = delete;
 	virtual ~VertexBuffer();
@@ -46,6 +54,7 @@ private:
 
 	D3D12_GPU_VIRTUAL_ADDRESS m_gpuBaseAddress = 0; // 分配起始地址（可选）
 	size_t m_offset = 0; // 当前分配偏移量（仅 ring 模式下使用）
+	size_t m_peakOffset = 0; // 历史最高水位，用来缩小 ring 预留
 	uint8_t* m_mappedPtr = nullptr; // 持久映射指针
 	
 	bool m_isRingBuffer = false; 
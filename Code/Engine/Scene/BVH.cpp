@@ -59,6 +59,12 @@ void BVH::QueryIntersectingTriangles(const AABB3& bounds, std::vector<int>& outT
 
 void BVH::FlattenForGPU(std::vector<GPUBVHNode>& outNodes, std::vector<uint32_t>& outTriIndices) const
 {
+	if (!m_root && !m_flatNodes.empty())
+	{
+		outNodes = m_flatNodes;
+		outTriIndices = m_flatTriIndices;
+		return;
+	}
 	if (!m_root)
 	{
 		DebuggerPrintf("[BVH] Cannot flatten: root is null\n");
@@ -79,6 +85,15 @@ void BVH::FlattenForGPU(std::vector<GPUBVHNode>& outNodes, std::vector<uint32_t>
 		outNodes.size(), outTriIndices.size());
 }
 
+void BVH::SetFlattened(std::vector<GPUBVHNode> nodes, std::vector<uint32_t> triIndices)
+{
+	m_root.reset();
+	m_vertices = nullptr;
+	m_indices = nullptr;
+	m_flatNodes = std::move(nodes);
+	m_flatTriIndices = std::move(triIndices);
+}
+
 std::unique_ptr<BVHNode> BVH::BuildRecursive(const std::vector<int>& triangleIndices,
     const std::vector<Vertex_PCUTBN>& vertices, const std::vector<uint32_t>& indices, int depth)
 {
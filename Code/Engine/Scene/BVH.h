@@ -53,6 +53,10 @@ public:
 	void FlattenForGPU(std::vector<GPUBVHNode>& outNodes,
 		std::vector<uint32_t>& outTriIndices) const;
 
+	// cooked mesh：直接用已经 flatten 的节点（没有树，Query* 返回空，FlattenForGPU 原样给出）
+	void SetFlattened(std::vector<GPUBVHNode> nodes, std::vector<uint32_t> triIndices);
+	bool IsEmpty() const { return !m_root && m_flatNodes.empty(); }
+
 private:
     std::unique_ptr<BVHNode> BuildRecursive(
         const std::vector<int>& triangleIndices,
@@ -87,6 +91,8 @@ private:
     std::unique_ptr<BVHNode> m_root;
     const std::vector<Vertex_PCUTBN>* m_vertices = nullptr;
     const std::vector<uint32_t>* m_indices = nullptr;
+	std::vector<GPUBVHNode> m_flatNodes;
+	std::vector<uint32_t> m_flatTriIndices;
     
     static constexpr int MAX_TRIANGLES_PER_LEAF = 8;  // 叶子节点最多三角形数
     static constexpr int MAX_DEPTH = 16;              // 最大深度
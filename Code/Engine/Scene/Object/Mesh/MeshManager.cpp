@@ -2,6 +2,8 @@
 
 #include "Engine/Scene/Scene.h"
 
+#include <algorithm>
+
 MeshManager::MeshManager(Scene* scene)
     : m_scene(scene)
 {
@@ -21,7 +23,51 @@ StaticMesh* MeshManager::GetOrLoadMesh(const std::string& name, const std::strin
 {
     if (m_loadedMeshes.find(name) == m_loadedMeshes.end())
     {
+        StaticMeshHandle* handle = m_scene->m_assetStreamer->FindMesh(name);
+        if (handle)
+        {
+            m_scene->m_assetStreamer->Finish(handle);
+            if (handle->IsReady())
+                return handle->GetLoadedMesh();
+        }
         m_loadedMeshes[name] = new StaticMesh((Renderer*)m_scene->m_config.m_renderer, path, true);
     }
     return m_loadedMeshes[name];
 }
+
+StaticMeshHandle* MeshManager::RequestMesh(const std::string& name, const std::string& path)
+{
+    auto found = m_loadedMeshes.find(name);
+    if (found != m_loadedMeshes.end())
+        return m_scene->m_assetStreamer->AdoptMesh(name, found->second);
+    return m_scene->m_assetStreamer->RequestMesh(name, path, true);
+}
+
+void MeshManager::PreloadMeshes(const std::vector<std::pair<std::string, std::string>>& namesAndPaths)
+{
+    std::vector<std::string> newNames;
+    std::vector<std::string> newPaths;
+    for (const auto& [name, path] : namesAndPaths)
+    {
+        if (m_loadedMeshes.find(name) != m_loadedMeshes.end() || m_scene->m_assetStreamer->FindMesh(name))
+            continue;
+        if (std::find(newNames.begin(), newNames.end(), name) != newNames.end())
+            continue;
+        newNames.push_back(name);
+        newPaths.push_back(path);
+    }
+
+    // 读文件 + 网格优化在 job 线程上并行，GPU buffer 还是按顺序建
+    std::vector<StaticMeshGeometry> geometries;
+    StaticMesh::ImportGeometryForMeshes(newPaths, geometries);
+
+    std::vector<StaticMesh*> newMeshes;
+    for (size_t i = 0; i < newNames.size(); i++)
+    {
+        StaticMesh* mesh = new StaticMesh((Renderer*)m_scene->m_config.m_renderer, newPaths[i], false, &geometries[i]);
+        m_loadedMeshes[newNames[i]] = mesh;
+        newMeshes.push_back(mesh);
+    }
+
+    StaticMesh::GenerateCardTemplatesForMeshes(newMeshes);
+}
@@ -1,11 +1,13 @@
 ﻿#pragma once
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "Engine/Core/StaticMesh.h"
 
 class Scene;
 class StaticMesh;
+class StaticMeshHandle;
 
 class MeshManager
 {
@@ -13,7 +15,12 @@ class MeshManager
 public:
     MeshManager(Scene* scene);
     ~MeshManager();
+    // 已经在异步加载的 mesh 会等它加载完（不会再同步读一遍）
     StaticMesh* GetOrLoadMesh(const std::string& name, const std::string& path);
+    // 异步：handle->Get() 在加载完之前返回 placeholder，Scene::Update 推进加载
+    StaticMeshHandle* RequestMesh(const std::string& name, const std::string& path);
+    // 批量加载：GPU 资源按顺序创建，import/优化和 card 生成在 job 线程上并行
+    void PreloadMeshes(const std::vector<std::pair<std::string, std::string>>& namesAndPaths);
     
 protected:
     Scene* m_scene;
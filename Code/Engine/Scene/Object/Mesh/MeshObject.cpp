@@ -78,6 +78,9 @@ RenderItem MeshObject::GetRenderItem() const
 {
     RenderItem item;
     item.m_worldMatrix = const_cast<MeshObject*>(this)->GetWorldMatrix();
+    item.m_mesh = m_mesh;
+    item.m_color = m_color;
+    item.m_materialID = m_mesh ? m_mesh->GetMaterialID() : 0;
     item.m_objectID = m_id;
     item.m_bounds = GetWorldBounds();
     item.m_visible = IsVisible();
@@ -124,9 +127,7 @@ void MeshObject::OnTransformChanged()
 			instance.m_worldAxisX = localAxisX.GetNormalized();
 			instance.m_worldAxisY = localAxisY.GetNormalized();
 	
-			Vec3 worldSize = localBounds.m_maxs - localBounds.m_mins;
-			instance.m_worldSize.x = DotProduct3D(worldSize, instance.m_worldAxisX);
-			instance.m_worldSize.y =  DotProduct3D(worldSize, instance.m_worldAxisY);
+			instance.m_worldSize = templ.GetLocalSize(localBounds);
 			
 			instance.m_isDirty = true;
 			
@@ -192,15 +193,13 @@ void MeshObject::InitializeCardInstances()
 		//instance.m_worldAxisY = worldAxisY_WithScale.GetNormalized();
 		instance.m_worldAxisY = localAxisY.GetNormalized();
 
-		Vec3 worldSize = localBounds.m_maxs - localBounds.m_mins;
 		//Vec3 worldAxisX_WithScale = worldMatrix.TransformVectorQuantity3D(localAxisX * localSize.x);
 		//Vec3 worldAxisX_WithScale = localAxisX * localSize.x;
 		//Vec3 worldAxisY_WithScale = worldMatrix.TransformVectorQuantity3D(localAxisY * localSize.y);
 		//Vec3 worldAxisY_WithScale = localAxisY * localSize.y;
 		
-		instance.m_worldSize.x = DotProduct3D(worldSize, instance.m_worldAxisX);
+		instance.m_worldSize = templ.GetLocalSize(localBounds);
 		//instance.m_worldSize.x = worldAxisX_WithScale.GetLength();
-		instance.m_worldSize.y =  DotProduct3D(worldSize, instance.m_worldAxisY);
 		//instance.m_worldSize.y = worldAxisY_WithScale.GetLength();
 		
 		// 初始化光照掩码和状态
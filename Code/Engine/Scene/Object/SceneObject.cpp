@@ -75,6 +75,12 @@ const Mat44& SceneObject::GetWorldMatrix()
     return m_worldMatrix;*/
 }
 
+const Mat44& SceneObject::GetWorldMatrixWithoutMeshTransform()
+{
+    GetWorldMatrix();
+    return m_cachedWorldMatrixWithoutMeshTransform;
+}
+
 AABB3 SceneObject::GetWorldBounds() const
 {
     //AABB3 local = GetLocalBounds();
@@ -44,6 +44,8 @@ public:
     const Vec3& GetPosition() const { return m_position; }
     const float GetScale() const { return m_scale; }
     virtual const Mat44& GetWorldMatrix();
+    // scale / rotation / translation only, without the mesh's own transform (refreshed like GetWorldMatrix)
+    const Mat44& GetWorldMatrixWithoutMeshTransform();
     
     void SetVisible(bool visible) { m_visible = visible; }
     bool IsVisible() const { return m_visible && m_active; }
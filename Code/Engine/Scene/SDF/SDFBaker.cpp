@@ -0,0 +1,289 @@
+#include "SDFBaker.h"
+
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Job/JobSystem.h"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+    constexpr uint32_t SDF_BAKE_LEAF_SIZE = 4;
+    constexpr int SDF_BAKE_STACK_SIZE = 64;
+    // 距离差在这个比例以内算一样近（共享边 / 顶点），由朝向决定符号
+    constexpr float SDF_BAKE_TIE_EPSILON = 1e-4f;
+
+    struct BakeTriangle
+    {
+        Vec3 m_a;
+        Vec3 m_b;
+        Vec3 m_c;
+        Vec3 m_normal;      // unit, oriented like the vertex normals
+    };
+
+    // m_count > 0: leaf, triangles [m_first, m_first + m_count); else children m_first and m_first + 1
+    struct BakeNode
+    {
+        Vec3 m_mins;
+        Vec3 m_maxs;
+        uint32_t m_first = 0;
+        uint32_t m_count = 0;
+    };
+
+    struct BakeBVH
+    {
+        std::vector<BakeNode> m_nodes;
+        std::vector<BakeTriangle> m_triangles;     // leaf order
+    };
+
+    Vec3 MinVec3(Vec3 const& a, Vec3 const& b) { return Vec3(MinF(a.x, b.x), MinF(a.y, b.y), MinF(a.z, b.z)); }
+    Vec3 MaxVec3(Vec3 const& a, Vec3 const& b) { return Vec3(MaxF(a.x, b.x), MaxF(a.y, b.y), MaxF(a.z, b.z)); }
+
+    void BuildBakeNode(BakeBVH& bvh, std::vector<BakeTriangle> const& triangles, std::vector<Vec3> const& centroids,
+        std::vector<uint32_t>& order, uint32_t nodeIndex, uint32_t begin, uint32_t end)
+    {
+        Vec3 mins = Vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+        Vec3 maxs = Vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        Vec3 centroidMins = mins;
+        Vec3 centroidMaxs = maxs;
+        for (uint32_t i = begin; i < end; i++)
+        {
+            BakeTriangle const& tri = triangles[order[i]];
+            mins = MinVec3(MinVec3(mins, tri.m_a), MinVec3(tri.m_b, tri.m_c));
+            maxs = MaxVec3(MaxVec3(maxs, tri.m_a), MaxVec3(tri.m_b, tri.m_c));
+            centroidMins = MinVec3(centroidMins, centroids[order[i]]);
+            centroidMaxs = MaxVec3(centroidMaxs, centroids[order[i]]);
+        }
+        bvh.m_nodes[nodeIndex].m_mins = mins;
+        bvh.m_nodes[nodeIndex].m_maxs = maxs;
+
+        Vec3 extent = centroidMaxs - centroidMins;
+        if (end - begin <= SDF_BAKE_LEAF_SIZE || (extent.x <= 0.f && extent.y <= 0.f && extent.z <= 0.f))
+        {
+            bvh.m_nodes[nodeIndex].m_first = (uint32_t)bvh.m_triangles.size();
+            bvh.m_nodes[nodeIndex].m_count = end - begin;
+            for (uint32_t i = begin; i < end; i++)
+            {
+                bvh.m_triangles.push_back(triangles[order[i]]);
+            }
+            return;
+        }
+
+        int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+        uint32_t mid = (begin + end) / 2;
+        std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end, [&centroids, axis](uint32_t a, uint32_t b)
+        {
+            float const* ca = &centroids[a].x;
+            float const* cb = &centroids[b].x;
+            return ca[axis] < cb[axis];
+        });
+
+        uint32_t left = (uint32_t)bvh.m_nodes.size();
+        bvh.m_nodes.resize(bvh.m_nodes.size() + 2);
+        bvh.m_nodes[nodeIndex].m_first = left;
+        bvh.m_nodes[nodeIndex].m_count = 0;
+        BuildBakeNode(bvh, triangles, centroids, order, left, begin, mid);
+        BuildBakeNode(bvh, triangles, centroids, order, left + 1, mid, end);
+    }
+
+    // 退化三角形（面积 0）没有法线，跳过
+    void BuildBakeBVH(std::vector<Vertex_PCUTBN> const& vertices, std::vector<uint32_t> const& indices, BakeBVH& out)
+    {
+        std::vector<BakeTriangle> triangles;
+        std::vector<Vec3> centroids;
+        triangles.reserve(indices.size() / 3);
+        centroids.reserve(indices.size() / 3);
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            Vertex_PCUTBN const& va = vertices[indices[i]];
+            Vertex_PCUTBN const& vb = vertices[indices[i + 1]];
+            Vertex_PCUTBN const& vc = vertices[indices[i + 2]];
+            Vec3 normal = CrossProduct3D(vb.m_position - va.m_position, vc.m_position - va.m_position);
+            float length = normal.GetLength();
+            if (length <= 0.f)
+                continue;
+            normal /= length;
+            // winding 不一定统一，以顶点法线为准
+            if (DotProduct3D(normal, va.m_normal + vb.m_normal + vc.m_normal) < 0.f)
+                normal = -normal;
+
+            BakeTriangle tri;
+            tri.m_a = va.m_position;
+            tri.m_b = vb.m_position;
+            tri.m_c = vc.m_position;
+            tri.m_normal = normal;
+            triangles.push_back(tri);
+            centroids.push_back((tri.m_a + tri.m_b + tri.m_c) / 3.f);
+        }
+        if (triangles.empty())
+            return;
+
+        std::vector<uint32_t> order(triangles.size());
+        for (uint32_t i = 0; i < (uint32_t)order.size(); i++)
+        {
+            order[i] = i;
+        }
+        out.m_triangles.reserve(triangles.size());
+        out.m_nodes.reserve(2 * triangles.size() / SDF_BAKE_LEAF_SIZE + 1);
+        out.m_nodes.resize(1);
+        BuildBakeNode(out, triangles, centroids, order, 0, 0, (uint32_t)triangles.size());
+    }
+
+    float GetBoxDistanceSquared(BakeNode const& node, Vec3 const& p)
+    {
+        float dx = MaxF(MaxF(node.m_mins.x - p.x, p.x - node.m_maxs.x), 0.f);
+        float dy = MaxF(MaxF(node.m_mins.y - p.y, p.y - node.m_maxs.y), 0.f);
+        float dz = MaxF(MaxF(node.m_mins.z - p.z, p.z - node.m_maxs.z), 0.f);
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    // Ericson, Real-Time Collision Detection 5.1.5
+    Vec3 GetClosestPointOnTriangle(Vec3 const& p, Vec3 const& a, Vec3 const& b, Vec3 const& c)
+    {
+        Vec3 ab = b - a;
+        Vec3 ac = c - a;
+        Vec3 ap = p - a;
+        float d1 = DotProduct3D(ab, ap);
+        float d2 = DotProduct3D(ac, ap);
+        if (d1 <= 0.f && d2 <= 0.f)
+            return a;
+
+        Vec3 bp = p - b;
+        float d3 = DotProduct3D(ab, bp);
+        float d4 = DotProduct3D(ac, bp);
+        if (d3 >= 0.f && d4 <= d3)
+            return b;
+
+        float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+            return a + ab * (d1 / (d1 - d3));
+
+        Vec3 cp = p - c;
+        float d5 = DotProduct3D(ab, cp);
+        float d6 = DotProduct3D(ac, cp);
+        if (d6 >= 0.f && d5 <= d6)
+            return c;
+
+        float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+            return a + ac * (d2 / (d2 - d6));
+
+        float va = d3 * d6 - d5 * d4;
+        if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f)
+            return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+        float denom = 1.f / (va + vb + vc);
+        return a + ab * (vb * denom) + ac * (vc * denom);
+    }
+
+    // upperBound: a distance known to be >= the answer (the neighbouring voxel's + the step), prunes from the start
+    float GetSignedDistance(BakeBVH const& bvh, Vec3 const& p, float upperBound)
+    {
+        float bestDistSq = upperBound < FLT_MAX ? upperBound * upperBound * (1.f + 2.f * SDF_BAKE_TIE_EPSILON) : FLT_MAX;
+        float bestFacing = -1.f;
+        float bestSign = 1.f;
+        bool found = false;
+
+        uint32_t stack[SDF_BAKE_STACK_SIZE];
+        int stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0)
+        {
+            BakeNode const& node = bvh.m_nodes[stack[--stackSize]];
+            if (GetBoxDistanceSquared(node, p) > bestDistSq * (1.f + SDF_BAKE_TIE_EPSILON))
+                continue;
+
+            if (node.m_count > 0)
+            {
+                for (uint32_t i = node.m_first; i < node.m_first + node.m_count; i++)
+                {
+                    BakeTriangle const& tri = bvh.m_triangles[i];
+                    Vec3 toPoint = p - GetClosestPointOnTriangle(p, tri.m_a, tri.m_b, tri.m_c);
+                    float distSq = toPoint.GetLengthSquared();
+                    if (distSq > bestDistSq * (1.f + SDF_BAKE_TIE_EPSILON))
+                        continue;
+
+                    float along = DotProduct3D(toPoint, tri.m_normal);
+                    float facing = distSq > 0.f ? fabsf(along) / sqrtf(distSq) : 1.f;
+                    bool isCloser = !found || distSq < bestDistSq * (1.f - SDF_BAKE_TIE_EPSILON);
+                    if (isCloser || facing > bestFacing)
+                    {
+                        if (isCloser || distSq < bestDistSq)
+                            bestDistSq = distSq;
+                        bestFacing = facing;
+                        bestSign = along < 0.f ? -1.f : 1.f;
+                        found = true;
+                    }
+                }
+                continue;
+            }
+
+            // 近的后压栈，先出栈
+            // 中位数划分，深度不超过 log2(三角形数)，栈不会满
+            uint32_t nearChild = node.m_first;
+            uint32_t farChild = node.m_first + 1;
+            if (GetBoxDistanceSquared(bvh.m_nodes[farChild], p) < GetBoxDistanceSquared(bvh.m_nodes[nearChild], p))
+                std::swap(nearChild, farChild);
+            stack[stackSize++] = farChild;
+            stack[stackSize++] = nearChild;
+        }
+
+        // upperBound 只会偏大，不会一个三角形都找不到；保险起见退回不剪枝再找一次
+        if (!found)
+            return upperBound < FLT_MAX ? GetSignedDistance(bvh, p, FLT_MAX) : FLT_MAX;
+        return bestSign * sqrtf(bestDistSq);
+    }
+}
+
+bool BakeMeshSDF(std::vector<Vertex_PCUTBN> const& vertices, std::vector<uint32_t> const& indices, AABB3 const& bounds,
+    int resolution, std::vector<float>& outDistances, SDFBakeStats* outStats)
+{
+    outDistances.clear();
+    if (resolution < 2)
+        return false;
+
+    double startTime = GetCurrentTimeSeconds();
+    BakeBVH bvh;
+    BuildBakeBVH(vertices, indices, bvh);
+    double bvhTime = GetCurrentTimeSeconds();
+    if (bvh.m_triangles.empty())
+        return false;
+
+    uint32_t res = (uint32_t)resolution;
+    outDistances.resize((size_t)res * res * res);
+    Vec3 step = (bounds.m_maxs - bounds.m_mins) / (float)(resolution - 1);
+    float stepLength = fabsf(step.x);
+
+    // 一个 z 切片一个 range；同一行里上一个体素的距离 + 步长是下一个的上界
+    ParallelFor(res, 1, [&bvh, &bounds, &step, stepLength, res, &outDistances](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t z = begin; z < end; z++)
+        {
+            for (uint32_t y = 0; y < res; y++)
+            {
+                float previous = FLT_MAX;
+                float* row = &outDistances[((size_t)z * res + y) * res];
+                for (uint32_t x = 0; x < res; x++)
+                {
+                    Vec3 p = bounds.m_mins + Vec3(step.x * (float)x, step.y * (float)y, step.z * (float)z);
+                    float upperBound = previous < FLT_MAX ? fabsf(previous) + stepLength : FLT_MAX;
+                    row[x] = GetSignedDistance(bvh, p, upperBound);
+                    previous = row[x];
+                }
+            }
+        }
+    });
+
+    if (outStats)
+    {
+        outStats->m_triangleCount = (uint32_t)bvh.m_triangles.size();
+        outStats->m_bvhNodeCount = (uint32_t)bvh.m_nodes.size();
+        outStats->m_voxelCount = outDistances.size();
+        outStats->m_bvhMilliseconds = (bvhTime - startTime) * 1000.0;
+        outStats->m_bakeMilliseconds = (GetCurrentTimeSeconds() - bvhTime) * 1000.0;
+    }
+    return true;
+}
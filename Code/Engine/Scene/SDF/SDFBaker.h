@@ -0,0 +1,32 @@
+#pragma once
+#include "Engine/Math/AABB3.hpp"
+
+#include <cstdint>
+#include <vector>
+
+struct Vertex_PCUTBN;
+
+//==============================================================================
+// SDFBaker - CPU 上烘 mesh 的 SDF（离线 cook 用，不需要 GPU）
+//==============================================================================
+// Same volume as DX12Renderer::GenerateSDFOnGPU and SDFInstance::Sample:
+//   voxel (x, y, z) sits at bounds.m_mins + (x, y, z) / (resolution - 1) * size
+//   distances[x + y * resolution + z * resolution^2], negative inside
+// Nearest triangle through a flat BVH over the triangles (median split), pruned by the
+// distance to each node's box. The sign comes from the normal of the closest triangle; when
+// several triangles are equally close (the closest point is on a shared edge or vertex) the
+// one facing the voxel most directly decides. Runs ParallelFor over z slices.
+//==============================================================================
+
+struct SDFBakeStats
+{
+    uint32_t m_triangleCount = 0;
+    uint32_t m_bvhNodeCount = 0;
+    uint64_t m_voxelCount = 0;
+    double m_bvhMilliseconds = 0.0;
+    double m_bakeMilliseconds = 0.0;
+};
+
+// false (and outDistances empty) if there are no triangles or resolution < 2
+bool BakeMeshSDF(std::vector<Vertex_PCUTBN> const& vertices, std::vector<uint32_t> const& indices, AABB3 const& bounds,
+    int resolution, std::vector<float>& outDistances, SDFBakeStats* outStats = nullptr);
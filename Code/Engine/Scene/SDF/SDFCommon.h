@@ -1,16 +1,18 @@
 ﻿#pragma once
+#include <cfloat>
 #include <cstdint>
-#include <d3d12.h>
+#include <vector>
 
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/MathUtils.hpp"
 
 class SDFGenerator;
 
 struct SDFInstance
 {
     //SDFGenerator* m_sdf;
-    const std::vector<float>* m_data = nullptr;
+    const float* m_data = nullptr;      // CPU distances (cooked SDF), resolution^3; nullptr for GPU-only SDFs
     int m_resolution = 0;
     AABB3 m_bounds;
     
@@ -49,7 +51,7 @@ struct SDFInstance
     
         auto GetVoxel = [this](int x, int y, int z) -> float {
             int index = x + y * m_resolution + z * m_resolution * m_resolution;
-            return (*m_data)[index];
+            return m_data[index];
         };
     
         float v000 = GetVoxel(x0, y0, z0);
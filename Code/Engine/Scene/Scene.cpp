@@ -9,13 +9,24 @@
 #include "Engine/Renderer/SDFTexture3D.h"
 #include "Engine/Renderer/Cache/SurfaceCard.h"
 #include "Engine/Renderer/GI/GISystem.h"
+#include "Engine/Window/Window.hpp"
 #include <algorithm>
 
 Scene::Scene(SceneConfig const config)
     : m_config(config)
 {
     m_meshManager = new MeshManager(this);
+    AssetStreamerConfig streamerConfig;
+    streamerConfig.m_renderer = m_config.m_renderer;
+    m_assetStreamer = new AssetStreamer(streamerConfig);
     InitializeRoughly();
+
+    if (m_config.m_giSystem)
+    {
+        CardLODConfig lodConfig;
+        lodConfig.m_tileSize = m_config.m_giSystem->m_config.m_primaryTileSize;
+        m_cardLOD.SetConfig(lodConfig);
+    }
     //m_octree = std::make_unique<Octree>(AABB3(Vec3(-1000), Vec3(1000)));
 }
 
@@ -39,6 +50,8 @@ Scene::~Scene()
     m_allObjects.clear();
     delete m_meshManager;
     m_meshManager = nullptr;
+    delete m_assetStreamer;
+    m_assetStreamer = nullptr;
 }
 
 void Scene::InitializeRoughly()
@@ -48,13 +61,42 @@ void Scene::InitializeRoughly()
     m_opaqueRenderItems.reserve(1000);
 }
 
-void Scene::RegisterObjectSDF(uint32_t objectID, const Mat44& worldTransform)
+void Scene::RegisterObjectSDF(uint32_t objectID, const Mat44& worldTransform, const float* distances, int resolution, const AABB3& bounds)
 {
     SDFInstance instance;
     //instance.m_sdf = sdf;
+    instance.m_data = distances;
+    instance.m_resolution = resolution;
+    instance.m_bounds = bounds;
     instance.m_worldTransform = worldTransform;
     instance.m_inverseTransform = worldTransform.GetOrthonormalInverse();
     m_sdfInstances[objectID] = instance;
+    m_sdfInstancesChanged = true;
+}
+
+void Scene::RegisterCookedObjectSDF(MeshObject* object)
+{
+    // CPU 光照查询 (GISystem::SampleOcclusion) 只能用 cooked SDF，GPU 生成的没有 CPU 副本
+    StaticMesh* mesh = object->GetMesh();
+    float objectScale = object->GetScale();
+    int resolution = 0;
+    float const* distances = mesh ? mesh->GetCookedSDFDistances(objectScale, resolution) : nullptr;
+    if (!distances || objectScale <= 0.f)
+    {
+        UnregisterObjectSDF(object->GetID());
+        return;
+    }
+
+    // volume 在 mesh transform 之后、已经带 scale 的空间里：world transform 只剩旋转和平移
+    Mat44 sdfTransform = object->GetWorldMatrixWithoutMeshTransform();
+    sdfTransform.AppendScaleUniform3D(1.f / objectScale);
+    RegisterObjectSDF(object->GetID(), sdfTransform, distances, resolution, mesh->GetScaledBounds(objectScale));
+}
+
+void Scene::UnregisterObjectSDF(uint32_t objectID)
+{
+    if (m_sdfInstances.erase(objectID) > 0)
+        m_sdfInstancesChanged = true;
 }
 
 float Scene::QuerySDF(const Vec3& worldPos)
@@ -116,7 +158,9 @@ RaycastResult3D Scene::RaycastWithSDF(const Vec3& origin, const Vec3& direction,
 
 void Scene::Update(float deltaTime)
 {
+    m_currentFrame++;
     bool anyLightMoved = false;
+    m_assetStreamer->Update();
 
     for (auto* object : m_allObjects)
     {
@@ -131,6 +175,8 @@ void Scene::Update(float deltaTime)
         if (object->GetType() == OBJECT_MESH)
         {
             OnMeshObjectTransformChanged(object->GetID());
+            if (m_staticBatchesBuilt)
+                m_staticMerger.OnObjectChanged(static_cast<MeshObject*>(object));
             object->ClearMoveFlag(); // 别忘了清标记
         }
         else if (object->GetType() == OBJECT_LIGHT)
@@ -154,9 +200,20 @@ void Scene::Update(float deltaTime)
     {
         ProduceLightVariables();
     }
+    if (m_staticBatchesBuilt && m_staticMerger.RebuildDirtyBatches() > 0)
+    {
+        m_renderDataDirty = true;   // 有物体进出合并 batch
+    }
 
+    UpdateCardResolutionLOD();
     ProcessGIUpdates();
 
+    if (m_sdfInstancesChanged && m_config.m_giSystem)
+    {
+        m_config.m_giSystem->UpdateLightingQueryInputs();
+        m_sdfInstancesChanged = false;
+    }
+
     // if (m_currentFrame % 60 == 0)
     // {
     //     CheckMemoryPressure();
@@ -202,6 +259,10 @@ MeshObject* Scene::CreateMeshEntity(const std::string& path, const std::string&
 	}
 
     OnMeshObjectTransformChanged(id);
+    if (m_staticBatchesBuilt)
+    {
+        m_staticMerger.AddObject(ptr);
+    }
     return ptr;
 }
 
@@ -253,6 +314,7 @@ void Scene::DestroyObject(uint32_t entityID)
         }
         
         meshObj->m_cardInstances.clear();
+        m_staticMerger.RemoveObject(entityID);
     }
     
     it->second->OnDestroy();
@@ -465,6 +527,8 @@ void Scene::OnMeshObjectTransformChanged(uint32_t objectID)
     if (!object)
         return;
 
+    RegisterCookedObjectSDF(object);
+
     for (size_t i = 0; i < it->second.m_cardIDs.size(); ++i)
     {
         uint32_t cardID = it->second.m_cardIDs[i];
@@ -520,16 +584,99 @@ void Scene::ProcessGIUpdates()
     ClearDirtyCards();
 }
 
+void Scene::UpdateCardResolutionLOD()
+{
+#ifdef ENGINE_DX12_RENDERER
+    GISystem* giSystem = m_config.m_giSystem;
+    if (!m_enableCardResolutionLOD || !giSystem || !m_config.m_renderer)
+        return;
+
+    const CameraConstants& cam = m_config.m_renderer->GetSubRenderer()->m_currentCam;
+    CardLODView view;
+    view.m_cameraPosition = cam.CameraWorldPosition;
+    view.m_projectionScale = cam.RenderToClipTransform.m_values[Mat44::Jy];
+    view.m_screenHeight = (float)giSystem->m_config.m_window->GetClientDimensions().y;
+    if (view.m_projectionScale <= 0.f || view.m_screenHeight <= 0.f)
+        return;
+
+    std::vector<TierChange>& changes = m_cardTierChanges;
+    changes.clear();
+
+    for (auto& [cardID, card] : m_cardIDToCardPtr)
+    {
+        // 上一次切换还没 capture 完（旧块未释放），先等它
+        if (card->m_pendingRealloc)
+            continue;
+        // 驱逐是为了腾 atlas，LOD 不能转头又把它分配回来（重新注册时才回来）
+        if (card->m_evicted)
+            continue;
+
+        MeshObject* obj = static_cast<MeshObject*>(GetSceneObject(card->m_meshObjectID));
+        if (!obj)
+            continue;
+
+        CardInstanceData* instance = obj->GetCardInstance(card->m_templateIndex);
+        if (!instance)
+            continue;
+
+        float projectedPixels = CardResolutionLOD::ComputeProjectedSize(view, instance->m_worldOrigin, instance->m_worldSize);
+        int currentTier = card->m_resident ? (int)card->m_resolutionTier : (int)CARD_LOD_TIER_NONE;
+        int tier = m_cardLOD.SelectTier(projectedPixels, currentTier, card->m_maxResolutionTier,
+                                        m_currentFrame - card->m_lastResolutionChangeFrame);
+        if (card->m_resident && tier == currentTier)
+            continue;
+
+        // 没有驻留的卡最急，其余按跨越的档位数排
+        int urgency = card->m_resident ? abs(tier - currentTier) : 100;
+        changes.push_back({ card, instance, tier, urgency });
+    }
+
+    // 每次切换都要重新 capture，限制每帧数量
+    size_t budget = std::min<size_t>(changes.size(), m_cardLOD.GetConfig().m_maxReallocsPerFrame);
+    std::partial_sort(changes.begin(), changes.begin() + budget, changes.end(),
+                      [](const TierChange& a, const TierChange& b) { return a.m_urgency > b.m_urgency; });
+
+    for (size_t i = 0; i < budget; i++)
+    {
+        SurfaceCard* card = changes[i].m_card;
+        int tier = changes[i].m_tier;
+
+        CardAllocation alloc = giSystem->AllocateCardSpace(m_cardLOD.GetTierResolution(tier));
+        if (!alloc.IsValid())
+            continue;   // atlas 满了就保持原分辨率
+
+        if (card->m_resident)
+        {
+            // 旧块在新分辨率 capture 完成后由 DX12Renderer::FinalizeCardCapture 释放
+            card->m_oldAtlasCoord = card->m_atlasCoord;
+            card->m_oldTileSpan = card->m_atlasTileSpan;
+            card->m_pendingRealloc = true;
+        }
+
+        card->m_atlasCoord = alloc.m_baseCoord;
+        card->m_atlasTileSpan = alloc.m_tileCount;
+        card->m_atlasPixelCoord = alloc.m_pixelCoord;
+        card->m_pixelResolution = alloc.m_pixelResolution;
+        card->m_resident = true;
+        card->m_resolutionTier = (uint8_t)tier;
+        card->m_lastResolutionChangeFrame = m_currentFrame;
+        card->m_pendingUpdate = true;
+
+        changes[i].m_instance->m_isDirty = true;
+        m_dirtyCardIDs.push_back(card->m_globalCardID);
+    }
+#endif
+}
+
 void Scene::PrepareRenderData(const Camera& camera)
 {
-    UNUSED(camera);
     if (!m_renderDataDirty)
         return;
     
     // 清空上一帧数据
     m_opaqueRenderItems.clear();
     m_transparentRenderItems.clear();
-    m_visibleMeshes.clear();
+    m_visibleMeshes = GetVisibleMeshes(camera);
     m_activeLights.clear();
     
     // // 视锥剔除
@@ -541,6 +688,9 @@ void Scene::PrepareRenderData(const Camera& camera)
     {
         if (!mesh->IsVisible())
             continue;
+        // 已经烘进静态合并 batch 的由 m_staticMerger.Draw 画
+        if (m_staticMerger.IsObjectMerged(mesh->GetID()))
+            continue;
             
         RenderItem item = mesh->GetRenderItem();
         
@@ -570,6 +720,71 @@ void Scene::PrepareRenderData(const Camera& camera)
     m_renderDataDirty = false;
 }
 
+void Scene::BuildInstanceBatches(const Camera& camera, InstanceBatcher& batcher)
+{
+    std::vector<MeshObject*> visibleMeshes = GetVisibleMeshes(camera);
+    m_instanceRenderItems.clear();
+    m_instanceRenderItems.reserve(visibleMeshes.size());
+    for (MeshObject* mesh : visibleMeshes)
+    {
+        // 已经烘进静态合并 batch 的由 m_staticMerger.Draw 画
+        if (mesh->IsVisible() && mesh->GetMesh() && !m_staticMerger.IsObjectMerged(mesh->GetID()))
+            m_instanceRenderItems.push_back(mesh->GetRenderItem());
+    }
+    batcher.Build(m_instanceRenderItems);
+    NoteTextureUse(camera, visibleMeshes);
+}
+
+void Scene::NoteTextureUse(const Camera& camera, const std::vector<MeshObject*>& visibleMeshes)
+{
+    // 贴图 residency：可见物体在屏幕上多大，下一帧 m_assetStreamer->Update 据此决定常驻哪些 mip
+    CardLODView view;
+    view.m_cameraPosition = camera.GetPosition();
+    view.m_projectionScale = camera.GetRenderToClipTransform().m_values[Mat44::Jy];
+    if (m_config.m_renderer && m_config.m_renderer->m_config.m_window)
+        view.m_screenHeight = (float)m_config.m_renderer->m_config.m_window->GetClientDimensions().y;
+    if (view.m_projectionScale <= 0.f || view.m_screenHeight <= 0.f)
+        return;
+
+    for (MeshObject* mesh : visibleMeshes)
+    {
+        if (!mesh->IsVisible() || !mesh->GetMesh())
+            continue;
+        Sphere bounds = mesh->GetWorldBoundsSphere();
+        float diameter = 2.f * bounds.m_radius;
+        m_assetStreamer->NoteMeshUse(mesh->GetMesh(), CardResolutionLOD::ComputeProjectedSize(view, bounds.m_center, Vec2(diameter, diameter)));
+    }
+}
+
+void Scene::RenderOpaque(const Camera& camera, Shader* instancedShader)
+{
+    if (!m_config.m_renderer)
+        return;
+
+    m_staticMergeDrawStats = StaticMergeDrawStats();
+    if (m_staticBatchesBuilt)
+    {
+        Frustum frustum = camera.GetFrustum();
+        m_staticMergeDrawStats = m_staticMerger.Draw(*m_config.m_renderer, &frustum);
+    }
+
+    BuildInstanceBatches(camera, m_instanceBatcher);
+    m_instanceBatcher.Draw(*m_config.m_renderer, instancedShader);
+}
+
+void Scene::BuildStaticBatches()
+{
+    m_staticMerger.Build(m_meshObjects);
+    m_staticBatchesBuilt = true;
+    m_renderDataDirty = true;
+
+    StaticMergeReport report = m_staticMerger.GetReport();
+    DebuggerPrintf("[Scene] Static merge: %u objects -> %u batches, draws %u -> %u, geometry %.2f MB (shared meshes %.2f MB, x%.2f), %.2f ms\n",
+        report.m_objectsMerged, report.m_batchCount, report.m_drawsBefore, report.m_drawsAfter,
+        (double)report.m_mergedGeometryBytes / (1024.0 * 1024.0), (double)report.m_sourceGeometryBytes / (1024.0 * 1024.0),
+        report.GetMemoryRatio(), report.m_lastRebuildMilliseconds);
+}
+
 void Scene::AddObjectToLists(SceneObject* object)
 {
     m_allObjects.push_back(object);
@@ -750,6 +965,7 @@ void Scene::EvictLowPriorityCards()
         
         // ✅ 标记card为非resident
         card->m_resident = false;
+        card->m_evicted = true;
         card->m_atlasCoord = IntVec2(-1, -1);
         card->m_atlasTileSpan = IntVec2(0, 0);
         
@@ -820,6 +1036,7 @@ void Scene::EvictCards(const std::vector<SurfaceCard*>& cards)
         
         // 标记
         card->m_resident = false;
+        card->m_evicted = true;
         card->m_atlasCoord = IntVec2(-1, -1);
         card->m_atlasTileSpan = IntVec2(0, 0);
         card->m_pendingUpdate = true;
@@ -994,6 +1211,7 @@ void Scene::EvictLowPriorityCards_Advanced(uint32_t targetTilesToFree)
         
         // 标记
         card->m_resident = false;
+        card->m_evicted = true;
         card->m_atlasCoord = IntVec2(-1, -1);
         card->m_atlasTileSpan = IntVec2(0, 0);
         card->m_pendingUpdate = true;
@@ -1006,7 +1224,7 @@ void Scene::EvictLowPriorityCards_Advanced(uint32_t targetTilesToFree)
                    evictedCount, freedTiles, targetTilesToFree);
     
 #endif
-#ifdef ENGINE_DX11_RENDERER
+#if defined(ENGINE_DX11_RENDERER) || defined(ENGINE_NULL_RENDERER)
     UNUSED(targetTilesToFree)
 #endif
 }
@@ -1037,7 +1255,7 @@ void Scene::RegisterMeshObjectForGI(MeshObject* object)
 
     StaticMesh* mesh = object->GetMesh();
     uint32_t objectID = object->GetID();
-    //float objectScale = object->GetScale();
+    float objectScale = object->GetScale();
 
     std::vector<uint32_t> surfaceCardIDs;
     for (size_t i = 0; i < mesh->m_cardTemplates.size(); i++)
@@ -1058,6 +1276,7 @@ void Scene::RegisterMeshObjectForGI(MeshObject* object)
                     //card->m_templateIndex = templateIndex;
                     
                     card->m_resident = true;
+                    card->m_evicted = false;
                 
                     DebuggerPrintf("[Scene] Card %u allocated: Tile(%d,%d) Pixel(%d,%d) Res(%dx%d)\n",
             card->m_globalCardID,
@@ -1080,6 +1299,19 @@ void Scene::RegisterMeshObjectForGI(MeshObject* object)
 #ifdef ENGINE_DX12_RENDERER
     SDFTexture3D* existingSDF = mesh->GetSDF(objectScale);
     
+    // IglooCook 烘过的直接上传
+    int cookedSDFResolution = 0;
+    float const* cookedSDF = mesh->GetCookedSDFDistances(objectScale, cookedSDFResolution);
+    if ((!existingSDF || existingSDF->GetSRVDescriptorIndex() == UINT32_MAX) && cookedSDF)
+    {
+        SDFTexture3D* sdfTex = m_config.m_renderer->GetSubRenderer()->CreateSDFTextureFromData(cookedSDF, cookedSDFResolution);
+        if (sdfTex)
+        {
+            mesh->SetSDF(objectScale, sdfTex);
+            existingSDF = sdfTex;
+        }
+    }
+
     if (!existingSDF || existingSDF->GetSRVDescriptorIndex() == UINT32_MAX)
     {
         DebuggerPrintf("[Scene] Generating SDF for scale=%.1f\n", objectScale);
@@ -1111,7 +1343,7 @@ void Scene::RegisterMeshObjectForGI(MeshObject* object)
             mesh->m_indices,
             *bvh,
             scaledBounds,
-            64  // SDF resolution TODO!!!!
+            MESH_SDF_RESOLUTION
         );
         
         if (!sdfTex)
@@ -1133,6 +1365,8 @@ void Scene::RegisterMeshObjectForGI(MeshObject* object)
     }
 #endif
     
+    RegisterCookedObjectSDF(object);
+
     GIObjectEntry entry;
     entry.m_objectID = objectID;
 #ifdef ENGINE_DX12_RENDERER
@@ -1175,6 +1409,7 @@ void Scene::UnregisterMeshObjectFromGI(uint32_t objectID)
 
     // ✅ 清理所有SurfaceCards
     CleanupSurfaceCardsForObject(objectID);
+    UnregisterObjectSDF(objectID);
 
     // 从registry移除
     m_giRegistry.erase(it);
@@ -1437,16 +1672,19 @@ SurfaceCard* Scene::GetOrCreateSurfaceCard(uint32_t objectID, uint32_t templateI
     card->m_meshObjectID = objectID;
     card->m_templateIndex = templateIndex;
     
-    // 从模板获取推荐分辨率
+    // 从模板获取推荐分辨率（LOD 的上限，之后由 UpdateCardResolutionLOD 按屏幕尺寸调整）
     const SurfaceCardTemplate& templ = mesh->m_cardTemplates[templateIndex];
     card->m_pixelResolution = templ.m_recommendedResolution;
+    card->m_maxResolutionTier = (uint8_t)m_cardLOD.GetMaxTierForResolution(templ.m_recommendedResolution);
+    card->m_resolutionTier = card->m_maxResolutionTier;
+    card->m_lastResolutionChangeFrame = m_currentFrame;
     
     // 初始状态：未分配atlas空间
     card->m_resident = false;
     card->m_atlasCoord = IntVec2(-1, -1);
     card->m_atlasTileSpan = IntVec2(0, 0);
     card->m_pendingUpdate = true;
-    card->m_lastTouchedFrame = 0;
+    card->m_lastTouchedFrame = m_currentFrame;
     card->m_priority = 1.0f;
     
     // 关联instance和card
@@ -13,6 +13,10 @@
 #include "Engine/Renderer/DX12Renderer.hpp"
 #include "Object/Light/LightObject.h"
 #include "Object/Mesh/MeshManager.h"
+#include "Engine/Core/AssetStreamer.h"
+#include "Engine/Renderer/Cache/CardResolutionLOD.h"
+#include "Engine/Renderer/InstanceBatcher.h"
+#include "StaticMeshMerger.h"
 
 struct CardInstanceData;
 class MeshObject;
@@ -36,7 +40,10 @@ public:
 
     void InitializeRoughly();
     
-    void RegisterObjectSDF(uint32_t objectID, const Mat44& worldTransform);
+    // distances: CPU copy of the volume (cooked SDF), must outlive the registration
+    void RegisterObjectSDF(uint32_t objectID, const Mat44& worldTransform, const float* distances, int resolution, const AABB3& bounds);
+    void RegisterCookedObjectSDF(MeshObject* object);   // its cooked SDF for the current scale, or unregisters
+    void UnregisterObjectSDF(uint32_t objectID);
     float QuerySDF(const Vec3& worldPos);
 	RaycastResult3D RaycastWithSDF(const Vec3& origin, const Vec3& direction, float maxDistance);
 
@@ -64,6 +71,7 @@ public:
     
     void OnMeshObjectTransformChanged(uint32_t objectID);
     void ProcessGIUpdates();
+    void UpdateCardResolutionLOD();
     
     uint32_t AllocateCardID();
     void MarkInstanceDirty(uint32_t objectID, uint32_t templateIndex);
@@ -94,11 +102,20 @@ public:
     std::vector<MeshObject*> GetVisibleObjects() const;
     const std::vector<RenderItem>& GetOpaqueRenderItems() const { return m_opaqueRenderItems; }
     const std::vector<RenderItem>& GetTransparentRenderItems() const { return m_transparentRenderItems; }
+    void BuildInstanceBatches(const Camera& camera, InstanceBatcher& batcher); // 每帧：可见物体按 mesh/material 合批，顺便 NoteTextureUse
+    void NoteTextureUse(const Camera& camera, const std::vector<MeshObject*>& visibleMeshes); // 屏幕尺寸报给 m_assetStreamer 的贴图 residency
+    // 场景 opaque 的绘制入口（app 在 BeginCamera 之后调）：先画静态合并 batch（BuildStaticBatches 之后），
+    // 其余可见物体经 InstanceBatcher 画，instancedShader（VERTEX_PCUTBN_INSTANCED）为空时同一套 batch 逐个画
+    void RenderOpaque(const Camera& camera, Shader* instancedShader = nullptr);
+    const InstanceBatchStats& GetInstanceBatchStats() const { return m_instanceBatcher.GetStats(); }
+    const StaticMergeDrawStats& GetStaticMergeDrawStats() const { return m_staticMergeDrawStats; }
+    void BuildStaticBatches(); // 一次：不动的物体按 cell/material 烘成合并 batch，之后 Update 里增量重烘
     
 #ifdef ENGINE_DX12_RENDERER
     DX12Renderer* GetRenderer() { return m_config.m_renderer->GetSubRenderer(); }
 #endif
     GISystem* GetGISystem() { return m_config.m_giSystem; }
+    uint32_t GetCurrentFrame() const { return m_currentFrame; }     // card 的 LOD / LRU 帧号都用它
     
 private:
     // 内部管理
@@ -145,6 +162,7 @@ private:
 public:
     SceneConfig m_config;
     MeshManager* m_meshManager;
+    AssetStreamer* m_assetStreamer;     // async meshes / textures, pumped at the start of Update
 
     std::unordered_map<uint32_t, std::unique_ptr<SceneObject>> m_objects;
     uint32_t m_nextEntityID = 1;
@@ -155,7 +173,8 @@ public:
     
     // TODO: Octree / BVH
     //std::unique_ptr<Octree> m_octree;
-    std::unordered_map<uint32_t, SDFInstance> m_sdfInstances;
+    std::unordered_map<uint32_t, SDFInstance> m_sdfInstances;     // 只有带 CPU 数据的（cooked）SDF
+    bool m_sdfInstancesChanged = false;                             // Update 时重新喂给 GISystem 的光照查询
     bool m_enableCPUSDFQueries = false;  
     
     uint32_t m_nextCardID = 0;
@@ -163,6 +182,16 @@ public:
     std::vector<uint32_t> m_dirtyCardIDs;  
     std::unordered_map<uint32_t, std::vector<uint32_t>> m_cardToLightObjects;
     std::unordered_map<uint32_t, SurfaceCard*> m_cardIDToCardPtr; 
+    CardResolutionLOD m_cardLOD;
+    bool m_enableCardResolutionLOD = true;
+    struct TierChange
+    {
+        SurfaceCard* m_card;
+        CardInstanceData* m_instance;
+        int m_tier;
+        int m_urgency;
+    };
+    std::vector<TierChange> m_cardTierChanges;     // UpdateCardResolutionLOD 每帧 clear 后重用
     //std::unordered_map<uint32_t, SurfaceCardTemplate*> m_cardIDToTemplatePtr; 
     
     uint32_t m_currentFrame = 0;
@@ -170,6 +199,11 @@ public:
     
     std::vector<RenderItem> m_opaqueRenderItems;
     std::vector<RenderItem> m_transparentRenderItems;
+    std::vector<RenderItem> m_instanceRenderItems;
+    InstanceBatcher m_instanceBatcher;
+    StaticMeshMerger m_staticMerger;
+    StaticMergeDrawStats m_staticMergeDrawStats;
+    bool m_staticBatchesBuilt = false;
 
     //Sun light应该不是一个物体。<-还是统一管理吧
     Vec3 m_sunDirection = Vec3(3.f, 1.f, -2.f);
@@ -0,0 +1,401 @@
+#include "StaticMeshMerger.h"
+
+#include "Engine/Core/StaticMesh.h"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Job/JobSystem.h"
+#include "Engine/Math/Frustum.h"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Renderer/IndexBuffer.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/VertexBuffer.hpp"
+#include "Engine/Scene/Object/Mesh/MeshObject.h"
+
+#include <unordered_set>
+
+uint64_t MergedStaticBatch::GetGeometryBytes() const
+{
+    uint64_t indexSize = m_uses16BitIndices ? sizeof(uint16_t) : sizeof(unsigned int);
+    return (uint64_t)m_verts.size() * sizeof(Vertex_PCUTBN) + (uint64_t)m_indices.size() * indexSize;
+}
+
+bool StaticMeshMerger::BatchKey::operator==(BatchKey const& other) const
+{
+    return m_cell == other.m_cell && m_materialID == other.m_materialID;
+}
+
+size_t StaticMeshMerger::BatchKeyHasher::operator()(BatchKey const& key) const
+{
+    size_t h = std::hash<IntVec3>{}(key.m_cell);
+    h ^= std::hash<uint32_t>{}(key.m_materialID) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    return h;
+}
+
+StaticMeshMerger::~StaticMeshMerger()
+{
+    Clear();
+}
+
+bool StaticMeshMerger::CanMerge(MeshObject* object) const
+{
+    if (!object || !object->IsActive() || !object->IsStaticForGI())
+        return false;
+    StaticMesh* mesh = object->GetMesh();
+    // batch 是 Vertex_PCUTBN，packed mesh 的 shader 是 VERTEX_PCUTBN_PACKED layout，画不了
+    return mesh && !mesh->m_usesPackedVertices && !mesh->m_indices.empty() && mesh->m_verts.size() <= m_config.m_maxObjectVertices;
+}
+
+void StaticMeshMerger::Build(std::vector<MeshObject*> const& objects)
+{
+    Clear();
+    for (MeshObject* object : objects)
+    {
+        AddObject(object);
+    }
+    RebuildDirtyBatches();
+}
+
+void StaticMeshMerger::Clear()
+{
+    for (MergedStaticBatch& batch : m_batches)
+    {
+        delete batch.m_vertexBuffer;
+        delete batch.m_indexBuffer;
+    }
+    m_batches.clear();
+    m_batchLookup.clear();
+    m_objectToBatch.clear();
+}
+
+StaticMeshMerger::BatchKey StaticMeshMerger::GetBatchKey(MeshObject* object) const
+{
+    AABB3 bounds = object->GetWorldBounds();
+    Vec3 center = (bounds.m_mins + bounds.m_maxs) * 0.5f;
+    float invCellSize = 1.f / m_config.m_cellSize;
+
+    BatchKey key;
+    key.m_cell = IntVec3(RoundDownToInt(center.x * invCellSize), RoundDownToInt(center.y * invCellSize), RoundDownToInt(center.z * invCellSize));
+    key.m_materialID = object->GetMesh()->GetMaterialID();
+    return key;
+}
+
+void StaticMeshMerger::AddObject(MeshObject* object)
+{
+    if (!CanMerge(object))
+        return;
+    if (m_objectToBatch.count(object->GetID()))
+    {
+        OnObjectChanged(object);
+        return;
+    }
+
+    BatchKey key = GetBatchKey(object);
+    auto it = m_batchLookup.find(key);
+    uint32_t batchIndex;
+    if (it == m_batchLookup.end())
+    {
+        batchIndex = (uint32_t)m_batches.size();
+        m_batchLookup[key] = batchIndex;
+        MergedStaticBatch batch;
+        batch.m_cell = key.m_cell;
+        batch.m_materialID = key.m_materialID;
+        m_batches.push_back(std::move(batch));
+    }
+    else
+    {
+        batchIndex = it->second;
+    }
+
+    MergedStaticBatch& batch = m_batches[batchIndex];
+    batch.m_objects.push_back(object);
+    batch.m_isDirty = true;
+    m_objectToBatch[object->GetID()] = batchIndex;
+}
+
+void StaticMeshMerger::RemoveObject(uint32_t objectID)
+{
+    auto it = m_objectToBatch.find(objectID);
+    if (it == m_objectToBatch.end())
+        return;
+    RemoveFromBatch(objectID, it->second);
+    m_objectToBatch.erase(it);
+}
+
+void StaticMeshMerger::RemoveFromBatch(uint32_t objectID, uint32_t batchIndex)
+{
+    MergedStaticBatch& batch = m_batches[batchIndex];
+    for (size_t i = 0; i < batch.m_objects.size(); i++)
+    {
+        if (batch.m_objects[i]->GetID() == objectID)
+        {
+            batch.m_objects.erase(batch.m_objects.begin() + i);
+            break;
+        }
+    }
+    batch.m_isDirty = true;
+}
+
+void StaticMeshMerger::OnObjectChanged(MeshObject* object)
+{
+    if (!object)
+        return;
+    auto it = m_objectToBatch.find(object->GetID());
+    if (it == m_objectToBatch.end())
+    {
+        AddObject(object);
+        return;
+    }
+    if (!CanMerge(object))
+    {
+        RemoveObject(object->GetID());
+        return;
+    }
+
+    // 同一个 cell 只重烘这一个 batch；跨 cell 时旧的、新的都标 dirty
+    uint32_t oldBatch = it->second;
+    auto newIt = m_batchLookup.find(GetBatchKey(object));
+    if (newIt != m_batchLookup.end() && newIt->second == oldBatch)
+    {
+        m_batches[oldBatch].m_isDirty = true;
+        return;
+    }
+    RemoveObject(object->GetID());
+    AddObject(object);
+}
+
+bool StaticMeshMerger::IsObjectMerged(uint32_t objectID) const
+{
+    auto it = m_objectToBatch.find(objectID);
+    return it != m_objectToBatch.end() && m_batches[it->second].IsMerged(m_config.m_minObjectsPerBatch);
+}
+
+uint32_t StaticMeshMerger::RebuildDirtyBatches()
+{
+    double rebuildStart = GetCurrentTimeSeconds();
+
+    std::vector<uint32_t> dirtyBatches;
+    for (uint32_t b = 0; b < (uint32_t)m_batches.size(); b++)
+    {
+        if (m_batches[b].m_isDirty)
+            dirtyBatches.push_back(b);
+    }
+
+    // GetWorldMatrix 会改 object 的 cache，先在主线程取好，job 里只读
+    std::vector<std::vector<Mat44>> worldMatrices(dirtyBatches.size());
+    for (size_t d = 0; d < dirtyBatches.size(); d++)
+    {
+        MergedStaticBatch const& batch = m_batches[dirtyBatches[d]];
+        worldMatrices[d].reserve(batch.m_objects.size());
+        for (MeshObject* object : batch.m_objects)
+        {
+            worldMatrices[d].push_back(object->GetWorldMatrix());
+        }
+    }
+
+    ParallelFor((uint32_t)dirtyBatches.size(), 1, [this, &dirtyBatches, &worldMatrices](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t d = begin; d < end; d++)
+        {
+            BakeBatch(m_batches[dirtyBatches[d]], worldMatrices[d]);
+        }
+    });
+
+    m_lastRebuiltBatches = (uint32_t)dirtyBatches.size();
+    m_totalRebuiltBatches += m_lastRebuiltBatches;
+    m_lastRebuildMilliseconds = (GetCurrentTimeSeconds() - rebuildStart) * 1000.0;
+    return m_lastRebuiltBatches;
+}
+
+void StaticMeshMerger::BakeBatch(MergedStaticBatch& batch, std::vector<Mat44> const& worldMatrices) const
+{
+    batch.m_verts.clear();
+    batch.m_indices.clear();
+    batch.m_ranges.clear();
+    batch.m_materialSource = batch.m_objects.empty() ? nullptr : batch.m_objects[0]->GetMesh();
+    batch.m_isDirty = false;
+    batch.m_isGPUDirty = true;
+    if (!batch.IsMerged(m_config.m_minObjectsPerBatch))
+        return;
+
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (MeshObject* object : batch.m_objects)
+    {
+        vertexCount += object->GetMesh()->m_verts.size();
+        indexCount += object->GetMesh()->m_indices.size();
+    }
+    batch.m_verts.reserve(vertexCount);
+    batch.m_indices.reserve(indexCount);
+    batch.m_ranges.reserve(batch.m_objects.size());
+
+    for (size_t i = 0; i < batch.m_objects.size(); i++)
+    {
+        MeshObject* object = batch.m_objects[i];
+        StaticMesh const* mesh = object->GetMesh();
+        Mat44 const& modelToWorld = worldMatrices[i];
+        Rgba8 color = object->m_color;
+
+        // 镜像 (det < 0) 会把 CCW 翻成 CW，烘进去时把每个三角形的 1、2 两个角换回来
+        Vec3 iBasis = modelToWorld.GetIBasis3D();
+        Vec3 jBasis = modelToWorld.GetJBasis3D();
+        Vec3 kBasis = modelToWorld.GetKBasis3D();
+        bool isMirrored = DotProduct3D(CrossProduct3D(iBasis, jBasis), kBasis) < 0.f;
+
+        uint32_t baseVertex = (uint32_t)batch.m_verts.size();
+        MergedObjectRange range;
+        range.m_objectID = object->GetID();
+        range.m_firstIndex = (uint32_t)batch.m_indices.size();
+        range.m_indexCount = (uint32_t)mesh->m_indices.size();
+
+        // 法线用逆转置（non-uniform scale 下按 model 矩阵变换会歪）；tangent / bitangent 在面内，直接按 model 矩阵
+        Mat44 normalToWorld = modelToWorld.GetInverse();
+        normalToWorld.Transpose();
+        for (size_t v = 0; v < mesh->m_verts.size(); v++)
+        {
+            Vertex_PCUTBN vert = mesh->m_verts[v];
+            vert.m_position = modelToWorld.TransformPosition3D(vert.m_position);
+            vert.m_normal = normalToWorld.TransformVectorQuantity3D(vert.m_normal).GetNormalized();
+            vert.m_tangent = modelToWorld.TransformVectorQuantity3D(vert.m_tangent).GetNormalized();
+            vert.m_bitangent = modelToWorld.TransformVectorQuantity3D(vert.m_bitangent).GetNormalized();
+            vert.m_color = Rgba8((unsigned char)((vert.m_color.r * color.r + 127) / 255), (unsigned char)((vert.m_color.g * color.g + 127) / 255),
+                (unsigned char)((vert.m_color.b * color.b + 127) / 255), (unsigned char)((vert.m_color.a * color.a + 127) / 255));
+            if (v == 0)
+                range.m_worldBounds = AABB3(vert.m_position, vert.m_position);
+            else
+                range.m_worldBounds.StretchToIncludePoint(vert.m_position);
+            batch.m_verts.push_back(vert);
+        }
+
+        std::vector<unsigned int> const& indices = mesh->m_indices;
+        for (size_t t = 0; t + 2 < indices.size(); t += 3)
+        {
+            batch.m_indices.push_back(baseVertex + indices[t]);
+            batch.m_indices.push_back(baseVertex + indices[isMirrored ? t + 2 : t + 1]);
+            batch.m_indices.push_back(baseVertex + indices[isMirrored ? t + 1 : t + 2]);
+        }
+
+        if (i == 0)
+            batch.m_worldBounds = range.m_worldBounds;
+        else
+            batch.m_worldBounds.StretchToIncludeAABB(range.m_worldBounds);
+        batch.m_ranges.push_back(range);
+    }
+}
+
+void StaticMeshMerger::UploadBatch(Renderer& renderer, MergedStaticBatch& batch)
+{
+    delete batch.m_vertexBuffer;
+    batch.m_vertexBuffer = nullptr;
+    delete batch.m_indexBuffer;
+    batch.m_indexBuffer = nullptr;
+    batch.m_isGPUDirty = false;
+    if (batch.m_indices.empty())
+        return;
+
+    std::vector<uint16_t> indices16;
+    batch.m_uses16BitIndices = NarrowIndicesTo16(batch.m_indices, indices16);
+    if (batch.m_uses16BitIndices)
+    {
+        batch.m_indexBuffer = renderer.CreateIndexBuffer((unsigned int)(indices16.size() * sizeof(uint16_t)), sizeof(uint16_t));
+        renderer.CopyCPUToGPU(indices16.data(), (unsigned int)(indices16.size() * sizeof(uint16_t)), batch.m_indexBuffer);
+    }
+    else
+    {
+        batch.m_indexBuffer = renderer.CreateIndexBuffer((unsigned int)(batch.m_indices.size() * sizeof(unsigned int)), sizeof(unsigned int));
+        renderer.CopyCPUToGPU(batch.m_indices.data(), (unsigned int)(batch.m_indices.size() * sizeof(unsigned int)), batch.m_indexBuffer);
+    }
+    batch.m_vertexBuffer = renderer.CreateVertexBuffer((unsigned int)(batch.m_verts.size() * sizeof(Vertex_PCUTBN)), sizeof(Vertex_PCUTBN));
+    renderer.CopyCPUToGPU(batch.m_verts.data(), (unsigned int)(batch.m_verts.size() * sizeof(Vertex_PCUTBN)), batch.m_vertexBuffer);
+}
+
+StaticMergeDrawStats StaticMeshMerger::Draw(Renderer& renderer, Frustum const* worldFrustum)
+{
+    StaticMergeDrawStats stats;
+    for (MergedStaticBatch& batch : m_batches)
+    {
+        if (batch.m_isGPUDirty)
+            UploadBatch(renderer, batch);
+        if (!batch.IsMerged(m_config.m_minObjectsPerBatch) || batch.m_indices.empty() || !batch.m_materialSource)
+            continue;
+
+        stats.m_batchesTested++;
+        ContainmentType containment = worldFrustum ? worldFrustum->DetectContainmentWithAABB(batch.m_worldBounds) : ContainmentType::INSIDE;
+        if (containment == ContainmentType::OUTSIDE)
+        {
+            stats.m_batchesCulled++;
+            continue;
+        }
+
+        StaticMesh const* material = batch.m_materialSource;
+        renderer.BindShader(material->m_shader);
+        renderer.SetMaterialConstants(material->m_diffuseTexture, material->m_normalTexture, material->m_specularTexture);
+        renderer.SetModelConstants();   // 顶点已在世界空间，颜色也烘进去了
+
+        if (containment == ContainmentType::INSIDE)
+        {
+            stats.m_objectsVisible += (uint32_t)batch.m_ranges.size();
+            stats.m_drawCalls++;
+            renderer.DrawIndexBuffer(batch.m_vertexBuffer, batch.m_indexBuffer, (unsigned int)batch.m_indices.size());
+            continue;
+        }
+
+        // 跨视锥边界：逐个 sub-range 测，相邻可见的合成一个 draw
+        uint32_t runFirst = 0;
+        uint32_t runCount = 0;
+        for (MergedObjectRange const& range : batch.m_ranges)
+        {
+            stats.m_rangesTested++;
+            if (worldFrustum->DetectContainmentWithAABB(range.m_worldBounds) == ContainmentType::OUTSIDE)
+                continue;
+
+            stats.m_objectsVisible++;
+            if (runCount > 0 && runFirst + runCount == range.m_firstIndex)
+            {
+                runCount += range.m_indexCount;
+                continue;
+            }
+            if (runCount > 0)
+            {
+                stats.m_drawCalls++;
+                renderer.DrawIndexBuffer(batch.m_vertexBuffer, batch.m_indexBuffer, runCount, PRIMITIVE_TRIANGLES, runFirst);
+            }
+            runFirst = range.m_firstIndex;
+            runCount = range.m_indexCount;
+        }
+        if (runCount > 0)
+        {
+            stats.m_drawCalls++;
+            renderer.DrawIndexBuffer(batch.m_vertexBuffer, batch.m_indexBuffer, runCount, PRIMITIVE_TRIANGLES, runFirst);
+        }
+    }
+    return stats;
+}
+
+StaticMergeReport StaticMeshMerger::GetReport() const
+{
+    StaticMergeReport report;
+    std::unordered_set<StaticMesh const*> sourceMeshes;
+    for (MergedStaticBatch const& batch : m_batches)
+    {
+        if (!batch.IsMerged(m_config.m_minObjectsPerBatch))
+            continue;
+
+        report.m_batchCount++;
+        report.m_objectsMerged += (uint32_t)batch.m_objects.size();
+        report.m_mergedGeometryBytes += batch.GetGeometryBytes();
+        for (MeshObject* object : batch.m_objects)
+        {
+            StaticMesh const* mesh = object->GetMesh();
+            if (!sourceMeshes.insert(mesh).second)
+                continue;
+            uint64_t vertexSize = mesh->m_usesPackedVertices ? sizeof(Vertex_PCUTBNPacked) : sizeof(Vertex_PCUTBN);
+            uint64_t indexSize = mesh->m_uses16BitIndices ? sizeof(uint16_t) : sizeof(unsigned int);
+            report.m_sourceGeometryBytes += (uint64_t)mesh->m_verts.size() * vertexSize + (uint64_t)mesh->m_indices.size() * indexSize;
+        }
+    }
+    report.m_drawsBefore = report.m_objectsMerged;
+    report.m_drawsAfter = report.m_batchCount;
+    report.m_lastRebuiltBatches = m_lastRebuiltBatches;
+    report.m_totalRebuiltBatches = m_totalRebuiltBatches;
+    report.m_lastRebuildMilliseconds = m_lastRebuildMilliseconds;
+    return report;
+}
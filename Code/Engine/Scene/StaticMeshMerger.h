@@ -0,0 +1,160 @@
+#pragma once
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/IntVec3.h"
+#include "Engine/Math/Mat44.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class IndexBuffer;
+class MeshObject;
+class Renderer;
+class StaticMesh;
+class VertexBuffer;
+struct Frustum;
+
+//==============================================================================
+// StaticMeshMerger - 不动的 MeshObject 按 (空间 cell, material) 烘成合并 batch (HLOD)
+//==============================================================================
+// Static props (IsStaticForGI, small enough, not packed-vertex) are grouped by the cell their world bounds
+// center falls in and by material. Each batch bakes the world-space vertices of all
+// its objects into one vertex/index buffer; the object color is baked into the vertex
+// color, so a batch draws with identity model constants.
+//
+// Every object keeps its own index sub-range + world bounds: Draw() tests the batch
+// bounds, and only batches that straddle the frustum test their sub-ranges (adjacent
+// visible ranges are drawn as one).
+//
+// Normals are baked with the inverse transpose, so non-uniform scale merges too.
+//
+// Scene::RenderOpaque draws the batches (once Scene::BuildStaticBatches ran) and leaves
+// merged objects out of the instanced / per-object items and GetOpaqueRenderItems.
+//
+// Incremental: OnObjectChanged / AddObject / RemoveObject only mark the affected batches
+// (the old and the new cell when an object moves); RebuildDirtyBatches re-bakes just
+// those (ParallelFor over batches), and Draw re-uploads their GPU buffers.
+//
+// Trade-off: baked verts are a copy per object, while instancing shares one mesh. The
+// report puts merged bytes next to the shared source bytes and draws before/after.
+//==============================================================================
+
+struct StaticMergeConfig
+{
+    float m_cellSize = 32.f;
+    uint32_t m_maxObjectVertices = 16 * 1024;   // bigger meshes stay on the per-object / instanced path
+    uint32_t m_minObjectsPerBatch = 2;          // a batch with fewer objects is not drawn merged
+};
+
+struct MergedObjectRange
+{
+    uint32_t m_objectID = 0;
+    uint32_t m_firstIndex = 0;
+    uint32_t m_indexCount = 0;
+    AABB3 m_worldBounds;
+};
+
+struct MergedStaticBatch
+{
+    IntVec3 m_cell;
+    uint32_t m_materialID = 0;
+    StaticMesh* m_materialSource = nullptr;     // shader / textures come from here
+    std::vector<MeshObject*> m_objects;
+    std::vector<MergedObjectRange> m_ranges;    // same order as m_objects after a rebuild
+    std::vector<Vertex_PCUTBN> m_verts;
+    std::vector<unsigned int> m_indices;
+    AABB3 m_worldBounds;
+
+    VertexBuffer* m_vertexBuffer = nullptr;
+    IndexBuffer* m_indexBuffer = nullptr;
+    bool m_uses16BitIndices = false;
+    bool m_isDirty = true;                      // CPU bake out of date
+    bool m_isGPUDirty = true;                   // buffers out of date
+
+    bool IsMerged(uint32_t minObjects) const { return m_objects.size() >= minObjects; }
+    uint64_t GetGeometryBytes() const;
+};
+
+struct StaticMergeReport
+{
+    uint32_t m_objectsMerged = 0;
+    uint32_t m_batchCount = 0;                  // batches drawn merged
+    uint32_t m_drawsBefore = 0;                 // one per merged object
+    uint32_t m_drawsAfter = 0;                  // one per batch, before culling
+    uint64_t m_sourceGeometryBytes = 0;         // each unique StaticMesh once (shared)
+    uint64_t m_mergedGeometryBytes = 0;
+    uint32_t m_lastRebuiltBatches = 0;
+    uint32_t m_totalRebuiltBatches = 0;
+    double m_lastRebuildMilliseconds = 0.0;
+
+    float GetMemoryRatio() const { return m_sourceGeometryBytes ? (float)m_mergedGeometryBytes / (float)m_sourceGeometryBytes : 0.f; }
+};
+
+struct StaticMergeDrawStats
+{
+    uint32_t m_batchesTested = 0;
+    uint32_t m_batchesCulled = 0;
+    uint32_t m_rangesTested = 0;
+    uint32_t m_objectsVisible = 0;
+    uint32_t m_drawCalls = 0;
+};
+
+class StaticMeshMerger
+{
+public:
+    StaticMeshMerger() = default;
+    ~StaticMeshMerger();
+
+    StaticMeshMerger(StaticMeshMerger const& copy) = delete;
+    StaticMeshMerger& operator=(StaticMeshMerger const& copy) = delete;
+
+    void SetConfig(StaticMergeConfig const& config) { m_config = config; }
+    StaticMergeConfig const& GetConfig() const { return m_config; }
+
+    bool CanMerge(MeshObject* object) const;
+
+    // Full build: drops every batch, then adds all mergeable objects and bakes them
+    void Build(std::vector<MeshObject*> const& objects);
+    void Clear();
+
+    void AddObject(MeshObject* object);
+    void RemoveObject(uint32_t objectID);
+    void OnObjectChanged(MeshObject* object);   // transform / color / static flag changed
+
+    uint32_t RebuildDirtyBatches();             // returns the number of batches re-baked
+    bool IsObjectMerged(uint32_t objectID) const;
+
+    // Uploads batches whose GPU buffers are stale, then culls and draws (worldFrustum may be nullptr: no culling)
+    StaticMergeDrawStats Draw(Renderer& renderer, Frustum const* worldFrustum);
+
+    std::vector<MergedStaticBatch> const& GetBatches() const { return m_batches; }
+    StaticMergeReport GetReport() const;
+
+private:
+    struct BatchKey
+    {
+        IntVec3 m_cell;
+        uint32_t m_materialID = 0;
+        bool operator==(BatchKey const& other) const;
+    };
+    struct BatchKeyHasher
+    {
+        size_t operator()(BatchKey const& key) const;
+    };
+
+    BatchKey GetBatchKey(MeshObject* object) const;
+    void RemoveFromBatch(uint32_t objectID, uint32_t batchIndex);
+    void BakeBatch(MergedStaticBatch& batch, std::vector<Mat44> const& worldMatrices) const;
+    void UploadBatch(Renderer& renderer, MergedStaticBatch& batch);
+
+private:
+    StaticMergeConfig m_config;
+    std::vector<MergedStaticBatch> m_batches;   // emptied batches stay (and get reused by their key)
+    std::unordered_map<BatchKey, uint32_t, BatchKeyHasher> m_batchLookup;
+    std::unordered_map<uint32_t, uint32_t> m_objectToBatch;
+
+    uint32_t m_lastRebuiltBatches = 0;
+    uint32_t m_totalRebuiltBatches = 0;
+    double m_lastRebuildMilliseconds = 0.0;
+};
@@ -56,7 +56,7 @@ void Button::Render() const
         g_theUISystem->GetRenderer()->SetRasterizerMode(RasterizerMode::SOLID_CULL_NONE);
         g_theUISystem->GetRenderer()->SetDepthMode(DepthMode::DISABLED);
         g_theUISystem->GetRenderer()->BindShader(nullptr);
-#ifdef ENGINE_DX11_RENDERER
+#if defined(ENGINE_DX11_RENDERER) || defined(ENGINE_NULL_RENDERER)
         g_theUISystem->GetRenderer()->BindTexture(m_texture); 
 #endif
 #ifdef ENGINE_DX12_RENDERER
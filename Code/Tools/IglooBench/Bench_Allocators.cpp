@@ -0,0 +1,346 @@
+#include "IglooBench.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Job/JobSystem.h"
+#include "Engine/Renderer/DescriptorAllocator.h"
+#include "Engine/Renderer/FrameUploadAllocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+namespace
+{
+    uint32_t NextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    //-------------------------------------------------------------------------------------------
+    // CPU stand-in for a GPU fence: the "GPU" finishes a frame m_latency frames after it is submitted
+    struct SimulatedUploadFence
+    {
+        uint64_t m_submittedValue = 0;
+        uint64_t m_completedValue = 0;
+        uint32_t m_latency = 2;
+
+        uint64_t Submit()
+        {
+            m_submittedValue++;
+            if (m_submittedValue > m_latency)
+            {
+                m_completedValue = std::max(m_completedValue, m_submittedValue - m_latency);
+            }
+            return m_submittedValue;
+        }
+
+        uint64_t Flush()
+        {
+            m_completedValue = m_submittedValue;
+            return m_completedValue;
+        }
+    };
+
+    //-------------------------------------------------------------------------------------------
+    struct FrameUploadSimulationReport
+    {
+        uint32_t m_frameCount = 0;
+        uint64_t m_allocationCount = 0;
+        uint64_t m_misalignedAllocations = 0;
+        uint64_t m_corruptedAllocations = 0;  // overwritten before the fence retired
+        FrameUploadStats m_stats;
+        uint64_t m_recommendedReservation = 0;
+        double m_nsPerAllocation = 0.0;
+    };
+
+    struct StampedAllocation
+    {
+        uint8_t* m_cpuAddress = nullptr;
+        uint64_t m_stamp = 0;
+    };
+
+    struct InFlightFrame
+    {
+        uint64_t m_fence = 0;
+        std::vector<StampedAllocation> m_allocations;
+    };
+
+    uint64_t CountCorruptedStamps(std::vector<StampedAllocation> const& allocations)
+    {
+        uint64_t corrupted = 0;
+        for (StampedAllocation const& stamped : allocations)
+        {
+            uint64_t stamp = 0;
+            memcpy(&stamp, stamped.m_cpuAddress, sizeof(stamp));
+            if (stamp != stamped.m_stamp)
+            {
+                corrupted++;
+            }
+        }
+        return corrupted;
+    }
+
+    // Allocates constants + transient vertices from several threads per frame (via ParallelFor),
+    // stamps every allocation and checks the stamps when the simulated fence retires
+    FrameUploadSimulationReport SimulateFrameUploadAllocator(FrameUploadAllocatorConfig const& config, uint32_t frameCount,
+        uint32_t allocationsPerFrame, uint32_t fenceLatency)
+    {
+        FrameUploadSimulationReport report;
+        report.m_frameCount = frameCount;
+
+        FrameUploadAllocator allocator(config);
+        SimulatedUploadFence fence;
+        fence.m_latency = fenceLatency;
+
+        // 每帧的分配按 fence 值保存，fence 完成时（页被回收之前）检查内容是否被提前覆盖
+        std::deque<InFlightFrame> inFlight;
+        std::atomic<uint64_t> misaligned{ 0 };
+        double allocSeconds = 0.0;
+
+        for (uint32_t frame = 0; frame < frameCount; frame++)
+        {
+            while (!inFlight.empty() && inFlight.front().m_fence <= fence.m_completedValue)
+            {
+                report.m_corruptedAllocations += CountCorruptedStamps(inFlight.front().m_allocations);
+                inFlight.pop_front();
+            }
+
+            allocator.BeginFrame(fence.m_completedValue);
+
+            uint64_t frameFence = fence.m_submittedValue + 1;
+            inFlight.emplace_back();
+            inFlight.back().m_fence = frameFence;
+            inFlight.back().m_allocations.resize(allocationsPerFrame);
+
+            double start = GetCurrentTimeSeconds();
+            std::vector<StampedAllocation>& stampedAllocations = inFlight.back().m_allocations;
+            ParallelFor(allocationsPerFrame, 256, [&](uint32_t begin, uint32_t end)
+            {
+                uint32_t rng = 0x9E3779B9u ^ (begin * 2654435761u) ^ (uint32_t)frameFence;
+                for (uint32_t i = begin; i < end; i++)
+                {
+                    // 3/4 是 256B 对齐的 constants，其余是 16B 对齐的 transient 顶点（偶尔很大，触发换页）
+                    bool isConstant = (NextRandom(rng) & 3) != 0;
+                    uint64_t size = isConstant ? 64 + (NextRandom(rng) % 4) * 64 : 48 * (1 + NextRandom(rng) % 64);
+                    if (!isConstant && (NextRandom(rng) % 4096) == 0)
+                    {
+                        size = config.m_pageSize + 4096;
+                    }
+                    uint64_t alignment = isConstant ? 256 : 16;
+
+                    FrameUploadAllocation allocation = allocator.Allocate(size, alignment);
+                    if ((allocation.m_offset & (alignment - 1)) != 0)
+                    {
+                        misaligned.fetch_add(1, std::memory_order_relaxed);
+                    }
+
+                    uint64_t stamp = (frameFence << 32) | i;
+                    memcpy(allocation.m_cpuAddress, &stamp, sizeof(stamp));
+                    stampedAllocations[i].m_cpuAddress = allocation.m_cpuAddress;
+                    stampedAllocations[i].m_stamp = stamp;
+                }
+            });
+            allocSeconds += GetCurrentTimeSeconds() - start;
+
+            allocator.EndFrame(fence.Submit());
+            report.m_allocationCount += allocationsPerFrame;
+        }
+
+        // 剩余帧: 页还没回收，内容必须完好
+        for (InFlightFrame const& inFlightFrame : inFlight)
+        {
+            report.m_corruptedAllocations += CountCorruptedStamps(inFlightFrame.m_allocations);
+        }
+
+        report.m_misalignedAllocations = misaligned.load();
+        report.m_stats = allocator.GetStats();
+        report.m_recommendedReservation = allocator.GetRecommendedReservation();
+        if (report.m_allocationCount > 0)
+        {
+            report.m_nsPerAllocation = allocSeconds * 1e9 / (double)report.m_allocationCount;
+        }
+
+        allocator.BeginFrame(fence.Flush());
+        return report;
+    }
+
+    //-------------------------------------------------------------------------------------------
+    struct DescriptorStreamingSimulationReport
+    {
+        uint32_t m_frameCount = 0;
+        uint32_t m_allocations = 0;
+        uint32_t m_frees = 0;
+        uint32_t m_failedAllocations = 0;
+        uint32_t m_overlaps = 0;             // handed out while still live or in flight
+        uint32_t m_reusedBeforeFence = 0;
+        uint32_t m_bumpAllocatorExhaustedFrame = 0;   // frame the old never-reuse counter would have run out (0 = never)
+        DescriptorAllocatorStats m_stats;
+        int m_peakTransientUsage = 0;
+    };
+
+    struct SimulatedResource
+    {
+        DescriptorRange m_range;
+        uint32_t m_lifetimeFrames = 0;
+    };
+
+    // 0 = free, 1 = live, 2 = waiting on fence
+    void MarkRange(std::vector<uint8_t>& occupancy, int baseIndex, DescriptorRange const& range, uint8_t state)
+    {
+        for (int i = 0; i < range.m_count; i++)
+        {
+            occupancy[range.m_index - baseIndex + i] = state;
+        }
+    }
+
+    // Streams textures / SDFs in and out (mixed range sizes) against a simulated fence and
+    // checks every allocation against an occupancy map
+    DescriptorStreamingSimulationReport SimulateDescriptorStreaming(int capacity, uint32_t frameCount, uint32_t fenceLatency)
+    {
+        DescriptorStreamingSimulationReport report;
+        report.m_frameCount = frameCount;
+
+        int const baseIndex = 100;
+        int const transientPerFrame = 32;
+        DescriptorRangeAllocator allocator(baseIndex, capacity);
+        DescriptorLinearAllocator transient(baseIndex + capacity, transientPerFrame, (int)fenceLatency + 1);
+        SimulatedUploadFence fence;
+        fence.m_latency = fenceLatency;
+
+        std::vector<uint8_t> occupancy((size_t)capacity, 0);
+        std::vector<std::pair<DescriptorRange, uint64_t>> inFlight;
+        std::vector<SimulatedResource> live;
+        uint32_t rng = 0x2545F491u;
+        int bumpCounter = 0;
+
+        for (uint32_t frame = 0; frame < frameCount; frame++)
+        {
+            // 顺序和 DX12Renderer 一致：先处理完成的 fence，再分配
+            allocator.ProcessDeferredFrees(fence.m_completedValue);
+            size_t kept = 0;
+            for (size_t i = 0; i < inFlight.size(); i++)
+            {
+                if (inFlight[i].second <= fence.m_completedValue)
+                    MarkRange(occupancy, baseIndex, inFlight[i].first, 0);
+                else
+                    inFlight[kept++] = inFlight[i];
+            }
+            inFlight.resize(kept);
+
+            transient.BeginFrame((int)(frame % (fenceLatency + 1)));
+            uint64_t frameFence = fence.m_submittedValue + 1;
+
+            // 流入：大多是单个 texture，偶尔是一组（mesh 的 material table / SDF 套件）
+            uint32_t spawnCount = (NextRandom(rng) % 3 == 0) ? 1 : 0;
+            for (uint32_t s = 0; s < spawnCount; s++)
+            {
+                int count = ((NextRandom(rng) % 8) == 0) ? 2 + (int)(NextRandom(rng) % 7) : 1;
+                bumpCounter += count;
+                if (bumpCounter > capacity && report.m_bumpAllocatorExhaustedFrame == 0)
+                {
+                    report.m_bumpAllocatorExhaustedFrame = frame;
+                }
+
+                DescriptorRange range = allocator.Allocate(count);
+                if (!range.IsValid())
+                {
+                    report.m_failedAllocations++;
+                    continue;
+                }
+                report.m_allocations++;
+
+                for (int i = 0; i < range.m_count; i++)
+                {
+                    uint8_t state = occupancy[range.m_index - baseIndex + i];
+                    if (state == 1)
+                        report.m_overlaps++;
+                    else if (state == 2)
+                        report.m_reusedBeforeFence++;
+                }
+                MarkRange(occupancy, baseIndex, range, 1);
+
+                SimulatedResource resource;
+                resource.m_range = range;
+                resource.m_lifetimeFrames = 30 + NextRandom(rng) % 300;
+                live.push_back(resource);
+            }
+
+            // 流出：寿命到了的资源本帧释放，GPU 本帧仍可能在读
+            kept = 0;
+            for (size_t i = 0; i < live.size(); i++)
+            {
+                if (live[i].m_lifetimeFrames-- > 0)
+                {
+                    live[kept++] = live[i];
+                    continue;
+                }
+                allocator.FreeDeferred(live[i].m_range, frameFence);
+                MarkRange(occupancy, baseIndex, live[i].m_range, 2);
+                inFlight.push_back(std::make_pair(live[i].m_range, frameFence));
+                report.m_frees++;
+            }
+            live.resize(kept);
+
+            uint32_t transientTables = 4 + NextRandom(rng) % 4;
+            for (uint32_t t = 0; t < transientTables; t++)
+            {
+                transient.Allocate(4);
+            }
+
+            fence.Submit();
+        }
+
+        report.m_stats = allocator.GetStats();
+        report.m_peakTransientUsage = transient.GetPeakFrameUsage();
+        report.m_failedAllocations += transient.GetFailedAllocations();
+        return report;
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+void RunFrameUploadBench(BenchContext& context)
+{
+    FrameUploadAllocatorConfig config;
+    config.m_pageSize = 256 * 1024;
+    uint32_t frameCount = context.m_quick ? 60 : 300;
+    uint32_t allocationsPerFrame = context.m_quick ? 4000 : 20000;
+    for (uint32_t fenceLatency : { 1u, 3u })
+    {
+        FrameUploadSimulationReport report = SimulateFrameUploadAllocator(config, frameCount, allocationsPerFrame, fenceLatency);
+        FrameUploadStats const& stats = report.m_stats;
+        DebuggerPrintf("  %u frames x %u, latency %u: %.1f ns/alloc, peak frame %.1f KB, peak %u pages (%u overflow, %u dedicated, %u created), reserve %.1f KB\n",
+            report.m_frameCount, allocationsPerFrame, fenceLatency, report.m_nsPerAllocation, (double)stats.m_peakFrameBytes / 1024.0,
+            stats.m_peakPagesInUse, stats.m_overflowPages, stats.m_dedicatedPages, stats.m_pagesCreated, (double)report.m_recommendedReservation / 1024.0);
+
+        context.Check(report.m_misalignedAllocations == 0, Stringf("latency %u: every allocation aligned (%llu misaligned)", fenceLatency, (unsigned long long)report.m_misalignedAllocations));
+        context.Check(report.m_corruptedAllocations == 0, Stringf("latency %u: no page reused before its fence (%llu stamps overwritten)", fenceLatency, (unsigned long long)report.m_corruptedAllocations));
+        context.Check(stats.m_overflowPages > 0 && stats.m_dedicatedPages > 0, Stringf("latency %u: the run exercised page overflow and dedicated pages", fenceLatency));
+    }
+}
+
+void RunDescriptorBench(BenchContext& context)
+{
+    int const capacity = 1024;
+    uint32_t frameCount = context.m_quick ? 5000 : 50000;
+    for (uint32_t fenceLatency : { 1u, 3u })
+    {
+        DescriptorStreamingSimulationReport report = SimulateDescriptorStreaming(capacity, frameCount, fenceLatency);
+        DescriptorAllocatorStats const& stats = report.m_stats;
+        DebuggerPrintf("  %d descriptors, %u frames, latency %u: %u allocations, %u frees, peak %d allocated, %d free ranges (%.0f%% fragmented), "
+            "peak transient %d, a bump counter would run out at frame %u\n",
+            capacity, report.m_frameCount, fenceLatency, report.m_allocations, report.m_frees, stats.m_peakAllocated, stats.m_freeRangeCount,
+            stats.m_fragmentation * 100.f, report.m_peakTransientUsage, report.m_bumpAllocatorExhaustedFrame);
+
+        context.Check(report.m_overlaps == 0, Stringf("latency %u: no range handed out while live (%u)", fenceLatency, report.m_overlaps));
+        context.Check(report.m_reusedBeforeFence == 0, Stringf("latency %u: no range reused before its fence (%u)", fenceLatency, report.m_reusedBeforeFence));
+        context.Check(report.m_failedAllocations == 0, Stringf("latency %u: no failed allocation (%u)", fenceLatency, report.m_failedAllocations));
+        context.Check(report.m_bumpAllocatorExhaustedFrame > 0, Stringf("latency %u: the run streams more than the heap holds", fenceLatency));
+    }
+}
@@ -0,0 +1,174 @@
+#include "IglooBench.h"
+
+#include "Engine/Core/BlockCompression.h"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Image.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    struct BlockCompressionReport
+    {
+        BlockFormat m_format = BlockFormat::NONE;
+        uint32_t m_runCount = 0;
+        uint64_t m_blockCount = 0;
+        double m_avgEncodeMilliseconds = 0.0;
+        double m_avgDecodeMilliseconds = 0.0;
+        float m_psnr = 0.f;
+        float m_compressionRatio = 0.f;          // RGBA8 bytes / compressed bytes
+        bool m_isDeterministic = true;           // every run wrote the same blocks
+        bool m_flipMatches = true;               // flipped encode + flipped decode == plain decode
+
+        double GetMegaTexelsPerSecond() const { return m_avgEncodeMilliseconds > 0.0 ? (double)m_blockCount * 16.0 / (m_avgEncodeMilliseconds * 1000.0) : 0.0; }
+    };
+
+    uint32_t HashTexel(int x, int y)
+    {
+        uint32_t h = (uint32_t)x * 0x8DA6B343u ^ (uint32_t)y * 0xD8163841u;
+        h ^= h >> 15;
+        h *= 0x2C1B3C6Du;
+        h ^= h >> 12;
+        return h;
+    }
+
+    // 像一张普通贴图：平滑的渐变 + 少量噪声 + 硬边（每 64 texel 一条色带）；a 是径向渐变
+    Image MakeBenchmarkImage(IntVec2 const& size)
+    {
+        Image image(size, Rgba8::WHITE);
+        for (int y = 0; y < size.y; y++)
+        {
+            for (int x = 0; x < size.x; x++)
+            {
+                float fx = (float)x / (float)size.x;
+                float fy = (float)y / (float)size.y;
+                int noise = (int)(HashTexel(x, y) & 15) - 8;
+                bool band = ((x / 64 + y / 64) & 3) == 0;
+                float r = 0.5f + 0.4f * sinf(fx * 12.f) * cosf(fy * 7.f);
+                float g = band ? 0.15f : 0.3f + 0.5f * fy;
+                float b = 0.5f + 0.45f * cosf((fx + fy) * 9.f);
+                float a = 1.f - MinF(1.f, sqrtf((fx - 0.5f) * (fx - 0.5f) + (fy - 0.5f) * (fy - 0.5f)) * 1.6f);
+                image.SetTexelColor(IntVec2(x, y), Rgba8(
+                    (unsigned char)GetClampedInt((int)(r * 255.f) + noise, 0, 255),
+                    (unsigned char)GetClampedInt((int)(g * 255.f) + noise, 0, 255),
+                    (unsigned char)GetClampedInt((int)(b * 255.f) + noise, 0, 255),
+                    (unsigned char)GetClampedInt((int)(a * 255.f), 0, 255)));
+            }
+        }
+        return image;
+    }
+
+    // every format on the image's top level
+    std::vector<BlockCompressionReport> BenchmarkBlockCompression(Image const& image, uint32_t runCount)
+    {
+        std::vector<BlockCompressionReport> reports;
+        IntVec2 dimensions = image.GetDimensions();
+        if (dimensions.x <= 0 || dimensions.y <= 0 || runCount == 0)
+            return reports;
+
+        Rgba8 const* texels = (Rgba8 const*)image.GetRawData();
+        BlockFormat const formats[] = { BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC4, BlockFormat::BC5, BlockFormat::BC7 };
+        std::vector<uint8_t> blocks;
+        std::vector<uint8_t> firstBlocks;
+        std::vector<Rgba8> decoded;
+        std::vector<Rgba8> flippedDecoded;
+        for (BlockFormat format : formats)
+        {
+            BlockCompressionReport report;
+            report.m_format = format;
+            report.m_runCount = runCount;
+            for (uint32_t run = 0; run < runCount; run++)
+            {
+                double encodeStart = GetCurrentTimeSeconds();
+                EncodeBlocks(texels, dimensions, format, blocks);
+                double decodeStart = GetCurrentTimeSeconds();
+                DecodeBlocks(blocks.data(), dimensions, format, decoded);
+                report.m_avgEncodeMilliseconds += (decodeStart - encodeStart) * 1000.0;
+                report.m_avgDecodeMilliseconds += (GetCurrentTimeSeconds() - decodeStart) * 1000.0;
+                if (run == 0)
+                    firstBlocks = blocks;
+                report.m_isDeterministic = report.m_isDeterministic && blocks == firstBlocks;
+            }
+            // worker 切分不同也要得到同样的 block：再编一次不计时
+            std::vector<uint8_t> again;
+            EncodeBlocks(texels, dimensions, format, again);
+            report.m_isDeterministic = report.m_isDeterministic && again == firstBlocks;
+
+            BlockCompressionSettings flipped;
+            flipped.m_flipVertically = true;
+            EncodeBlocks(texels, dimensions, format, again, flipped);
+            DecodeBlocks(again.data(), dimensions, format, flippedDecoded, true);
+            report.m_flipMatches = flippedDecoded.size() == decoded.size() && ComputeBlockPSNR(decoded.data(), flippedDecoded.data(), decoded.size(), format) > 40.f;
+
+            report.m_avgEncodeMilliseconds /= (double)runCount;
+            report.m_avgDecodeMilliseconds /= (double)runCount;
+            report.m_blockCount = blocks.size() / GetBlockBytes(format);
+            report.m_psnr = ComputeBlockPSNR(texels, decoded.data(), decoded.size(), format);
+            report.m_compressionRatio = (float)((double)dimensions.x * dimensions.y * sizeof(Rgba8) / (double)blocks.size());
+            reports.push_back(report);
+        }
+        return reports;
+    }
+
+    float GetExpectedRatio(BlockFormat format)
+    {
+        return (format == BlockFormat::BC1 || format == BlockFormat::BC4) ? 8.f : 4.f;
+    }
+
+    // 量到的值（512 / 2048）往下留 3 dB：encoder 改坏了会掉得比这多得多
+    float GetMinimumPSNR(BlockFormat format)
+    {
+        switch (format)
+        {
+        case BlockFormat::BC1: return 38.f;     // 41.4 / 43.0
+        case BlockFormat::BC3: return 39.f;     // 42.7 / 44.3
+        case BlockFormat::BC4: return 48.f;     // 51.3 / 51.7
+        case BlockFormat::BC5: return 48.f;     // 51.6 / 51.8
+        case BlockFormat::BC7: return 43.f;     // 46.5 / 53.0
+        default:               return 99.f;
+        }
+    }
+}
+
+void RunBlockCompressionBench(BenchContext& context)
+{
+    IntVec2 const size = context.m_quick ? IntVec2(512, 512) : IntVec2(2048, 2048);
+    Image image = MakeBenchmarkImage(size);
+    std::vector<BlockCompressionReport> reports = BenchmarkBlockCompression(image, context.m_runCount);
+    for (BlockCompressionReport const& report : reports)
+    {
+        char const* name = GetBlockFormatName(report.m_format);
+        DebuggerPrintf("  %s %dx%d x%u: encode %.2f ms (%.1f MTexel/s), decode %.2f ms, %.2f dB, %.1f:1\n",
+            name, size.x, size.y, report.m_runCount, report.m_avgEncodeMilliseconds,
+            report.GetMegaTexelsPerSecond(), report.m_avgDecodeMilliseconds, report.m_psnr, report.m_compressionRatio);
+
+        context.Check(report.m_psnr >= GetMinimumPSNR(report.m_format), Stringf("%s: PSNR at least %.0f dB (%.2f)", name, GetMinimumPSNR(report.m_format), report.m_psnr));
+        context.Check(report.m_compressionRatio == GetExpectedRatio(report.m_format), Stringf("%s: %.0f:1 (%.2f)", name, GetExpectedRatio(report.m_format), report.m_compressionRatio));
+        context.Check(report.m_isDeterministic, Stringf("%s: the same blocks on every encode", name));
+        context.Check(report.m_flipMatches, Stringf("%s: flipped encode decodes (flipped) to the same image", name));
+    }
+
+    // 不是 4 的倍数：边上的 block 重复最后一行 / 列，和手动补齐到 4 的倍数再编的结果一样
+    IntVec2 const oddSize(129, 67);
+    IntVec2 const paddedSize((oddSize.x + 3) & ~3, (oddSize.y + 3) & ~3);
+    Image oddImage = MakeBenchmarkImage(oddSize);
+    Image paddedImage(paddedSize, Rgba8::WHITE);
+    for (int y = 0; y < paddedSize.y; y++)
+    {
+        for (int x = 0; x < paddedSize.x; x++)
+            paddedImage.SetTexelColor(IntVec2(x, y), oddImage.GetTexelColor(IntVec2(MinI(x, oddSize.x - 1), MinI(y, oddSize.y - 1))));
+    }
+    std::vector<uint8_t> blocks;
+    std::vector<uint8_t> paddedBlocks;
+    std::vector<Rgba8> decoded;
+    EncodeBlocks((Rgba8 const*)oddImage.GetRawData(), oddSize, BlockFormat::BC7, blocks);
+    EncodeBlocks((Rgba8 const*)paddedImage.GetRawData(), paddedSize, BlockFormat::BC7, paddedBlocks);
+    DecodeBlocks(blocks.data(), oddSize, BlockFormat::BC7, decoded);
+    context.Check(blocks.size() == GetCompressedLevelBytes(BlockFormat::BC7, oddSize) && blocks == paddedBlocks,
+        Stringf("BC7 %dx%d: edge blocks repeat the last row / column", oddSize.x, oddSize.y));
+    context.Check(decoded.size() == (size_t)oddSize.x * oddSize.y, Stringf("BC7 %dx%d: decodes to the image's own size", oddSize.x, oddSize.y));
+}
@@ -0,0 +1,217 @@
+#include "IglooBench.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Renderer/Cache/CardResolutionLOD.h"
+
+#include <cmath>
+#include <vector>
+
+// ========================================
+// Camera-path simulation
+// ========================================
+// Scatters cards over a level-sized area, flies a camera through it and runs the LOD
+// selection every frame. Compares atlas tiles needed against the fixed mesh-size resolution.
+namespace
+{
+    struct CardLODSimulationReport
+    {
+        uint32_t m_cardCount = 0;
+        uint32_t m_frameCount = 0;
+        uint32_t m_atlasTileCount = 0;
+
+        uint32_t m_fixedTilesRequired = 0;      // every card at its template resolution
+        uint32_t m_fixedResidentCards = 0;      // cards that fit in the atlas at fixed resolution
+        uint32_t m_peakLODTiles = 0;
+        float m_averageLODTiles = 0.f;
+        uint32_t m_minLODResidentCards = 0;     // worst frame, cards that fit at LOD resolution
+
+        uint32_t m_totalTierChanges = 0;
+        uint32_t m_peakTierChangesPerFrame = 0;
+        uint32_t m_deferredChanges = 0;         // held back by m_maxReallocsPerFrame
+        uint32_t m_reversals = 0;               // change undone within 2x the minimum hold time
+
+        double m_nsPerCardUpdate = 0.0;
+    };
+
+    struct SimulatedCard
+    {
+        Vec3 m_center;
+        Vec2 m_worldSize;
+        uint8_t m_maxTier = 0;
+        uint8_t m_fixedTier = 0;
+        uint8_t m_tier = CARD_LOD_TIER_NONE;
+        int8_t m_lastDirection = 0;
+        uint32_t m_lastChangeFrame = 0;
+    };
+
+    uint32_t NextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    float NextRandomFloat(uint32_t& state)
+    {
+        return (float)(NextRandom(state) & 0xFFFFFF) / (float)0x1000000;
+    }
+
+    // 与 StaticMesh::GenerateCardTemplates 相同的按尺寸取分辨率规则
+    int GetMeshSizeResolution(float maxDim)
+    {
+        if (maxDim < 1.0f)  return 32;
+        if (maxDim < 3.0f)  return 64;
+        if (maxDim < 8.0f)  return 128;
+        if (maxDim < 16.0f) return 256;
+        return 512;
+    }
+
+    uint32_t GetTierTileCount(int tier)
+    {
+        uint32_t side = 1u << tier;
+        return side * side;
+    }
+
+    uint32_t CountCardsThatFit(std::vector<SimulatedCard> const& cards, bool useFixedTier, uint32_t atlasTiles)
+    {
+        uint32_t used = 0;
+        uint32_t count = 0;
+        for (SimulatedCard const& card : cards)
+        {
+            used += GetTierTileCount(useFixedTier ? card.m_fixedTier : card.m_tier);
+            if (used > atlasTiles)
+                break;
+            count++;
+        }
+        return count;
+    }
+
+    CardLODSimulationReport SimulateCardLODCameraPath(CardLODConfig const& config, uint32_t cardCount, uint32_t frameCount, uint32_t atlasSize)
+    {
+        CardResolutionLOD lod(config);
+        CardLODSimulationReport report;
+        report.m_cardCount = cardCount;
+        report.m_frameCount = frameCount;
+
+        uint32_t tilesPerSide = atlasSize / config.m_tileSize;
+        report.m_atlasTileCount = tilesPerSide * tilesPerSide;
+
+        // 400m x 400m 的场景，大部分是小物件，少量墙/地面级别的大卡片
+        float const halfExtent = 200.f;
+        uint32_t rng = 0x9E3779B9u;
+        std::vector<SimulatedCard> cards(cardCount);
+        for (SimulatedCard& card : cards)
+        {
+            card.m_center = Vec3(NextRandomFloat(rng) * 2.f * halfExtent - halfExtent,
+                                 NextRandomFloat(rng) * 2.f * halfExtent - halfExtent,
+                                 NextRandomFloat(rng) * 20.f);
+            float size = 0.5f + 24.f * powf(NextRandomFloat(rng), 3.f);
+            card.m_worldSize = Vec2(size, size * (0.5f + 0.5f * NextRandomFloat(rng)));
+
+            int recommended = GetMeshSizeResolution(MaxF(card.m_worldSize.x, card.m_worldSize.y));
+            card.m_maxTier = (uint8_t)lod.GetMaxTierForResolution(IntVec2(recommended, recommended));
+            card.m_fixedTier = card.m_maxTier;
+            report.m_fixedTilesRequired += GetTierTileCount(card.m_fixedTier);
+        }
+        report.m_fixedResidentCards = CountCardsThatFit(cards, true, report.m_atlasTileCount);
+        report.m_minLODResidentCards = cardCount;
+
+        CardLODView view;
+        view.m_projectionScale = 1.f / tanf(ConvertDegreesToRadians(30.f));
+        view.m_screenHeight = 1080.f;
+
+        std::vector<uint32_t> pendingCards;
+        pendingCards.reserve(cardCount);
+        double selectSeconds = 0.0;
+        double tileSum = 0.0;
+
+        for (uint32_t frame = 0; frame < frameCount; frame++)
+        {
+            // 8 字形飞行路径，约 10m/s @ 60fps，高度在 2m..12m 之间起伏
+            float t = (float)frame / 60.f * 0.05f;
+            view.m_cameraPosition = Vec3(150.f * sinf(t), 100.f * sinf(2.f * t), 7.f + 5.f * sinf(3.f * t));
+
+            double start = GetCurrentTimeSeconds();
+            pendingCards.clear();
+            for (uint32_t i = 0; i < cardCount; i++)
+            {
+                SimulatedCard& card = cards[i];
+                float pixels = CardResolutionLOD::ComputeProjectedSize(view, card.m_center, card.m_worldSize);
+                int tier = lod.SelectTier(pixels, card.m_tier, card.m_maxTier, frame - card.m_lastChangeFrame);
+
+                if (card.m_tier == CARD_LOD_TIER_NONE)
+                {
+                    // 首次分配不算重分配
+                    card.m_tier = (uint8_t)tier;
+                    card.m_lastChangeFrame = frame;
+                }
+                else if (tier != card.m_tier)
+                {
+                    pendingCards.push_back(i | ((uint32_t)tier << 24));
+                }
+            }
+            selectSeconds += GetCurrentTimeSeconds() - start;
+
+            uint32_t applied = MinI((int)pendingCards.size(), (int)config.m_maxReallocsPerFrame);
+            report.m_deferredChanges += (uint32_t)pendingCards.size() - applied;
+            for (uint32_t i = 0; i < applied; i++)
+            {
+                SimulatedCard& card = cards[pendingCards[i] & 0xFFFFFF];
+                int tier = (int)(pendingCards[i] >> 24);
+                int8_t direction = (tier > card.m_tier) ? 1 : -1;
+
+                if (card.m_lastDirection == -direction && frame - card.m_lastChangeFrame < 2 * config.m_minFramesBetweenChanges)
+                {
+                    report.m_reversals++;
+                }
+
+                card.m_tier = (uint8_t)tier;
+                card.m_lastDirection = direction;
+                card.m_lastChangeFrame = frame;
+            }
+            report.m_totalTierChanges += applied;
+            report.m_peakTierChangesPerFrame = (uint32_t)MaxI((int)report.m_peakTierChangesPerFrame, (int)applied);
+
+            uint32_t frameTiles = 0;
+            for (SimulatedCard const& card : cards)
+            {
+                frameTiles += GetTierTileCount(card.m_tier);
+            }
+            tileSum += (double)frameTiles;
+            report.m_peakLODTiles = (uint32_t)MaxI((int)report.m_peakLODTiles, (int)frameTiles);
+            report.m_minLODResidentCards = (uint32_t)MinI((int)report.m_minLODResidentCards,
+                (int)CountCardsThatFit(cards, false, report.m_atlasTileCount));
+        }
+
+        if (frameCount > 0 && cardCount > 0)
+        {
+            report.m_averageLODTiles = (float)(tileSum / (double)frameCount);
+            report.m_nsPerCardUpdate = selectSeconds * 1e9 / ((double)frameCount * (double)cardCount);
+        }
+
+        return report;
+    }
+}
+
+void RunCardResolutionLODBench(BenchContext& context)
+{
+    CardLODConfig config;
+    uint32_t cardCount = context.m_quick ? 5000 : 20000;
+    uint32_t frameCount = context.m_quick ? 300 : 600;
+    CardLODSimulationReport report = SimulateCardLODCameraPath(config, cardCount, frameCount, 4096);
+    DebuggerPrintf("  %u cards, %u frames, %u atlas tiles: fixed %u tiles (%u cards fit), LOD peak %u / avg %.0f tiles (%u cards fit), "
+        "%u changes (peak %u/frame, %u deferred, %u reversals), %.1f ns/card\n",
+        report.m_cardCount, report.m_frameCount, report.m_atlasTileCount, report.m_fixedTilesRequired, report.m_fixedResidentCards,
+        report.m_peakLODTiles, report.m_averageLODTiles, report.m_minLODResidentCards, report.m_totalTierChanges,
+        report.m_peakTierChangesPerFrame, report.m_deferredChanges, report.m_reversals, report.m_nsPerCardUpdate);
+
+    context.Check(report.m_peakLODTiles <= report.m_fixedTilesRequired, Stringf("LOD never needs more tiles than fixed resolution (%u > %u)", report.m_peakLODTiles, report.m_fixedTilesRequired));
+    context.Check(report.m_minLODResidentCards >= report.m_fixedResidentCards, Stringf("LOD fits at least as many cards as fixed resolution (%u < %u)", report.m_minLODResidentCards, report.m_fixedResidentCards));
+    context.Check(report.m_peakTierChangesPerFrame <= config.m_maxReallocsPerFrame, Stringf("tier changes per frame within m_maxReallocsPerFrame (%u)", report.m_peakTierChangesPerFrame));
+    // hysteresis + 最短停留时间：一张卡片不该刚升上去又降回来
+    context.Check(report.m_reversals == 0, Stringf("no tier change undone within 2x the hold time (%u)", report.m_reversals));
+}
@@ -0,0 +1,161 @@
+#include "IglooBench.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Renderer/InstanceBatcher.h"
+
+#include <cstring>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct InstanceBatchingBenchmarkReport
+    {
+        uint32_t m_objectCount = 0;
+        uint32_t m_meshCount = 0;
+        uint32_t m_frameCount = 0;
+        uint32_t m_drawsBefore = 0;          // one per object
+        uint32_t m_drawsAfter = 0;
+        uint32_t m_instancedBatches = 0;
+        double m_avgKeyMilliseconds = 0.0;
+        double m_avgGroupMilliseconds = 0.0;
+        double m_avgPackMilliseconds = 0.0;
+        double m_avgBuildMilliseconds = 0.0;
+        double m_avgSerialPackMilliseconds = 0.0;    // plain single-threaded pack in item order, for comparison
+    };
+
+    // objectCount items spread over meshCount meshes (a few meshes get most of the objects,
+    // like props in a level; every 8th object is unique). Meshes are fake pointers: Build()
+    // never dereferences them, only Draw() does.
+    std::vector<RenderItem> MakeBenchmarkItems(uint32_t objectCount, uint32_t meshCount)
+    {
+        // 假指针：只当 key 用，Build 不会解引用
+        auto fakeMesh = [](uint32_t index) { return reinterpret_cast<StaticMesh*>((uintptr_t)(index + 1) * 64); };
+
+        std::vector<RenderItem> items(objectCount);
+        uint32_t seed = 0x1234567u;
+        for (uint32_t i = 0; i < objectCount; i++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            float random = (float)(seed >> 8) / (float)(1u << 24);
+            uint32_t meshIndex = (i % 8 == 7) ? meshCount + i : (uint32_t)(random * random * (float)meshCount);
+
+            RenderItem& item = items[i];
+            item.m_mesh = fakeMesh(meshIndex);
+            item.m_materialID = meshIndex / 2;
+            item.m_meshID = meshIndex;
+            item.m_objectID = i;
+            item.m_visible = true;
+            item.m_color = Rgba8((unsigned char)(i * 37), (unsigned char)(i * 11), (unsigned char)(i * 5), 255);
+            item.m_worldMatrix = Mat44(Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f), Vec3(0.f, 0.f, 1.f),
+                Vec3((float)(i % 100) * 4.f, (float)((i / 100) % 100) * 4.f, (float)(i / 10000)));
+        }
+        return items;
+    }
+
+    InstanceBatchingBenchmarkReport BenchmarkInstanceBatching(InstanceBatcher& batcher, std::vector<RenderItem> const& items, uint32_t meshCount, uint32_t frameCount)
+    {
+        uint32_t objectCount = (uint32_t)items.size();
+        InstanceBatchingBenchmarkReport report;
+        report.m_objectCount = objectCount;
+        report.m_meshCount = meshCount;
+        report.m_frameCount = frameCount;
+        report.m_drawsBefore = objectCount;
+        if (objectCount == 0 || frameCount == 0)
+            return report;
+
+        std::vector<InstanceData> serialInstances(objectCount);
+        for (uint32_t frame = 0; frame < frameCount; frame++)
+        {
+            batcher.Build(items);
+            InstanceBatchStats const& stats = batcher.GetStats();
+            report.m_avgKeyMilliseconds += stats.m_keyMilliseconds;
+            report.m_avgGroupMilliseconds += stats.m_groupMilliseconds;
+            report.m_avgPackMilliseconds += stats.m_packMilliseconds;
+            report.m_avgBuildMilliseconds += stats.m_buildMilliseconds;
+
+            double serialStart = GetCurrentTimeSeconds();
+            for (uint32_t i = 0; i < objectCount; i++)
+            {
+                serialInstances[i].Set(items[i].m_worldMatrix, items[i].m_color);
+            }
+            report.m_avgSerialPackMilliseconds += (GetCurrentTimeSeconds() - serialStart) * 1000.0;
+        }
+
+        InstanceBatchStats const& stats = batcher.GetStats();
+        report.m_drawsAfter = stats.m_drawCalls;
+        report.m_instancedBatches = stats.m_instancedBatches;
+        double frames = (double)frameCount;
+        report.m_avgKeyMilliseconds /= frames;
+        report.m_avgGroupMilliseconds /= frames;
+        report.m_avgPackMilliseconds /= frames;
+        report.m_avgBuildMilliseconds /= frames;
+        report.m_avgSerialPackMilliseconds /= frames;
+        return report;
+    }
+}
+
+void RunInstanceBatchingBench(BenchContext& context)
+{
+    uint32_t objectCount = context.m_quick ? 20000 : 100000;
+    uint32_t meshCount = 200;
+    std::vector<RenderItem> items = MakeBenchmarkItems(objectCount, meshCount);
+    // 隐藏几个，验证它们不会进 batch
+    uint32_t hiddenCount = 0;
+    for (uint32_t i = 0; i < objectCount; i += 97)
+    {
+        items[i].m_visible = false;
+        hiddenCount++;
+    }
+
+    InstanceBatcher batcher;
+    InstanceBatchingBenchmarkReport report = BenchmarkInstanceBatching(batcher, items, meshCount, context.m_runCount * 10);
+    DebuggerPrintf("  %u objects, %u meshes, %u frames: %u draws -> %u (%u instanced batches), build %.3f ms (key %.3f, group %.3f, pack %.3f), serial pack %.3f ms\n",
+        report.m_objectCount, report.m_meshCount, report.m_frameCount, report.m_drawsBefore, report.m_drawsAfter, report.m_instancedBatches,
+        report.m_avgBuildMilliseconds, report.m_avgKeyMilliseconds, report.m_avgGroupMilliseconds, report.m_avgPackMilliseconds, report.m_avgSerialPackMilliseconds);
+
+    // 独立的参考分组：(material, mesh) -> 按 item 顺序的 object
+    std::map<std::pair<uint32_t, StaticMesh*>, std::vector<uint32_t>> expectedGroups;
+    for (uint32_t i = 0; i < objectCount; i++)
+    {
+        if (items[i].m_visible)
+            expectedGroups[{ items[i].m_materialID, items[i].m_mesh }].push_back(i);
+    }
+    uint32_t expectedDraws = 0;
+    for (auto const& group : expectedGroups)
+    {
+        uint32_t count = (uint32_t)group.second.size();
+        expectedDraws += (count >= batcher.m_minInstanceCount) ? 1 : count;
+    }
+
+    std::vector<InstanceBatch> const& batches = batcher.GetBatches();
+    std::vector<InstanceData> const& instances = batcher.GetInstances();
+    bool batchesMatch = batches.size() == expectedGroups.size();
+    bool sorted = true;
+    uint32_t nextInstance = 0;
+    uint32_t wrongInstances = 0;
+    for (size_t b = 0; b < batches.size() && batchesMatch; b++)
+    {
+        InstanceBatch const& batch = batches[b];
+        auto found = expectedGroups.find({ batch.m_materialID, batch.m_mesh });
+        batchesMatch = found != expectedGroups.end() && found->second.size() == batch.m_instanceCount && batch.m_firstInstance == nextInstance;
+        if (b > 0)
+            sorted = sorted && batches[b - 1].m_materialID <= batch.m_materialID;
+        for (uint32_t i = 0; batchesMatch && i < batch.m_instanceCount; i++)
+        {
+            RenderItem const& item = items[found->second[i]];
+            InstanceData expected;
+            expected.Set(item.m_worldMatrix, item.m_color);
+            wrongInstances += (memcmp(&expected, &instances[batch.m_firstInstance + i], sizeof(InstanceData)) != 0) ? 1 : 0;
+        }
+        nextInstance += batch.m_instanceCount;
+    }
+    context.Check(batchesMatch, "one batch per (material, mesh), instances contiguous in batch order");
+    context.Check(sorted, "batches sorted by material");
+    context.Check(wrongInstances == 0, Stringf("every instance is its item's transform and color, in item order (%u wrong)", wrongInstances));
+    context.Check(instances.size() == objectCount - hiddenCount, Stringf("instances cover every visible object and no hidden one (%zu of %u)", instances.size(), objectCount - hiddenCount));
+    context.Check(report.m_drawsAfter == expectedDraws, Stringf("draw count matches the reference grouping (%u, expected %u)", report.m_drawsAfter, expectedDraws));
+}
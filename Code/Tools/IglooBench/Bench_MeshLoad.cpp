@@ -0,0 +1,190 @@
+#include "IglooBench.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StaticMesh.h"
+#include "Engine/Core/StaticMeshUtils.h"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Job/JobSystem.h"
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+// ========================================
+// Fixture: an N x N quad grid OBJ (v/vt/vn on every corner) and its StaticMesh xml
+// ========================================
+// Every grid point is one v, one vt and one vn, so the loader must weld to (N+1)^2
+// verts; every quad fans into 2 triangles (0,1,2) (0,2,3).
+namespace
+{
+    struct GridFixture
+    {
+        int m_size = 0;
+        std::string m_objPath;
+        std::string m_xmlPathNoExtensions;
+    };
+
+    Vec3 GetGridPosition(int x, int y)
+    {
+        return Vec3((float)x, (float)y, (float)((x * 7 + y * 13) % 5));
+    }
+
+    Vec2 GetGridUV(int size, int x, int y)
+    {
+        return Vec2((float)x / (float)size, (float)y / (float)size);
+    }
+
+    bool WriteGridFixture(BenchContext const& context, int size, GridFixture& out)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(context.m_tempDir, error);
+        out.m_size = size;
+        out.m_objPath = context.m_tempDir + "/BenchGrid.obj";
+        out.m_xmlPathNoExtensions = context.m_tempDir + "/BenchGrid";
+
+        std::string obj;
+        obj.reserve((size_t)(size + 1) * (size + 1) * 80 + (size_t)size * size * 48);
+        obj += "# IglooBench grid\n";
+        for (int y = 0; y <= size; y++)
+        {
+            for (int x = 0; x <= size; x++)
+            {
+                Vec3 position = GetGridPosition(x, y);
+                Vec2 uv = GetGridUV(size, x, y);
+                obj += Stringf("v %g %g %g\nvt %.9g %.9g\nvn 0 0 1\n", position.x, position.y, position.z, uv.x, uv.y);
+            }
+        }
+        for (int y = 0; y < size; y++)
+        {
+            for (int x = 0; x < size; x++)
+            {
+                int a = y * (size + 1) + x + 1;     // OBJ 从 1 开始
+                int b = a + 1;
+                int c = b + size + 1;
+                int d = a + size + 1;
+                obj += Stringf("f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, c, c, c, d, d, d);
+            }
+        }
+        std::string xml = Stringf("<StaticMesh objFile=\"%s\" x=\"forward\" y=\"left\" z=\"up\" unitsPerMeter=\"1\"/>\n", out.m_objPath.c_str());
+        return FileWriteFromBuffer(std::vector<uint8_t>(obj.begin(), obj.end()), out.m_objPath) > 0
+            && FileWriteFromBuffer(std::vector<uint8_t>(xml.begin(), xml.end()), out.m_xmlPathNoExtensions + ".xml") > 0;
+    }
+
+    // output triangles in file order, positions / uvs / normals of the grid
+    uint32_t CountWrongGridCorners(GridFixture const& grid, std::vector<Vertex_PCUTBN> const& verts, std::vector<unsigned int> const& indices)
+    {
+        int const fan[6][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 0, 1 } };
+        uint32_t wrong = 0;
+        size_t corner = 0;
+        for (int y = 0; y < grid.m_size; y++)
+        {
+            for (int x = 0; x < grid.m_size; x++)
+            {
+                for (int i = 0; i < 6; i++, corner++)
+                {
+                    Vertex_PCUTBN const& vert = verts[indices[corner]];
+                    Vec3 position = GetGridPosition(x + fan[i][0], y + fan[i][1]);
+                    Vec2 uv = GetGridUV(grid.m_size, x + fan[i][0], y + fan[i][1]);
+                    bool matches = vert.m_position == position && fabsf(vert.m_uvTexCoords.x - uv.x) < 1e-6f
+                        && fabsf(vert.m_uvTexCoords.y - uv.y) < 1e-6f && vert.m_normal == Vec3(0.f, 0.f, 1.f);
+                    wrong += matches ? 0 : 1;
+                }
+            }
+        }
+        return wrong;
+    }
+}
+
+void RunOBJLoadBench(BenchContext& context)
+{
+    GridFixture grid;
+    int size = context.m_quick ? 200 : 800;
+    if (!context.Check(WriteGridFixture(context, size, grid), Stringf("write the grid fixture under %s", context.m_tempDir.c_str())))
+        return;
+
+    std::vector<Vertex_PCUTBN> verts;
+    std::vector<unsigned int> indices;
+    OBJParseStats stats;
+    double loadSeconds = 0.0;
+    double parseMilliseconds = 0.0;
+    double mergeMilliseconds = 0.0;
+    bool loaded = true;
+    for (uint32_t run = 0; run < context.m_runCount; run++)
+    {
+        stats = OBJParseStats();
+        double loadStart = GetCurrentTimeSeconds();
+        loaded = LoadOBJMeshFile(verts, indices, grid.m_objPath, stats) && loaded;
+        loadSeconds += GetCurrentTimeSeconds() - loadStart;
+        parseMilliseconds += stats.m_parseMilliseconds;
+        mergeMilliseconds += stats.m_mergeMilliseconds;
+    }
+    double runs = (double)context.m_runCount;
+    double loadMilliseconds = loadSeconds * 1000.0 / runs;
+    DebuggerPrintf("  %s: %.1f MB, %u chunks, %zu verts, %zu indices: load %.2f ms (parse %.2f, merge %.2f), %.0f MB/s\n",
+        grid.m_objPath.c_str(), (double)stats.m_fileBytes / (1024.0 * 1024.0), stats.m_chunkCount, verts.size(), indices.size(),
+        loadMilliseconds, parseMilliseconds / runs, mergeMilliseconds / runs,
+        loadMilliseconds > 0.0 ? ((double)stats.m_fileBytes / (1024.0 * 1024.0)) / (loadMilliseconds * 0.001) : 0.0);
+
+    size_t expectedVerts = (size_t)(size + 1) * (size + 1);
+    size_t expectedIndices = (size_t)size * size * 6;
+    if (!context.Check(loaded, "LoadOBJMeshFile succeeds"))
+        return;
+    if (g_theJobSystem->GetNumWorkerThreads() > 0)
+        context.Check(stats.m_chunkCount > 1, Stringf("the file is parsed in more than one chunk (%u)", stats.m_chunkCount));
+    context.Check(stats.m_polygonCount == (uint32_t)(size * size), Stringf("every quad counted as a polygon (%u)", stats.m_polygonCount));
+    context.Check(verts.size() == expectedVerts, Stringf("v/t/n corners welded to one vert per grid point (%zu, expected %zu)", verts.size(), expectedVerts));
+    if (!context.Check(indices.size() == expectedIndices, Stringf("two triangles per quad (%zu indices, expected %zu)", indices.size(), expectedIndices)))
+        return;
+    uint32_t wrongCorners = CountWrongGridCorners(grid, verts, indices);
+    context.Check(wrongCorners == 0, Stringf("triangles in file order with the grid's position / uv / normal (%u wrong corners)", wrongCorners));
+}
+
+// ========================================
+// Cooked load: import from source + cook (cold) vs key + read the cook (warm)
+// ========================================
+void RunCookedLoadBench(BenchContext& context)
+{
+    GridFixture grid;
+    int size = context.m_quick ? 100 : 400;
+    if (!context.Check(WriteGridFixture(context, size, grid), Stringf("write the grid fixture under %s", context.m_tempDir.c_str())))
+        return;
+
+    double coldMilliseconds = 0.0;
+    double warmMilliseconds = 0.0;
+    double keyMilliseconds = 0.0;
+    uint64_t cookedBytes = 0;
+    bool coldSkippedCook = true;
+    bool warmHitCook = true;
+    bool warmMatchesCold = true;
+    for (uint32_t run = 0; run < context.m_runCount; run++)
+    {
+        StaticMeshGeometry cold;
+        bool coldLoaded = StaticMesh::ImportGeometry(grid.m_xmlPathNoExtensions, cold, true);
+        coldMilliseconds += cold.m_importMilliseconds;
+        cookedBytes = cold.m_cookedBytes;
+        coldSkippedCook = coldSkippedCook && coldLoaded && !cold.m_isFromCooked;
+
+        StaticMeshGeometry warm;
+        bool warmLoaded = StaticMesh::ImportGeometry(grid.m_xmlPathNoExtensions, warm);
+        warmMilliseconds += warm.m_importMilliseconds;
+        keyMilliseconds += warm.m_keyMilliseconds;
+        warmHitCook = warmHitCook && warmLoaded && warm.m_isFromCooked;
+
+        warmMatchesCold = warmMatchesCold && warm.m_indices == cold.m_indices && warm.m_verts.size() == cold.m_verts.size()
+            && memcmp(warm.m_verts.data(), cold.m_verts.data(), cold.m_verts.size() * sizeof(Vertex_PCUTBN)) == 0
+            && warm.m_meshlets.m_meshlets.size() == cold.m_meshlets.m_meshlets.size()
+            && warm.m_bvhNodes.size() == cold.m_bvhNodes.size() && warm.m_bvhTriangles == cold.m_bvhTriangles;
+    }
+    double runs = (double)context.m_runCount;
+    DebuggerPrintf("  %s x%u: cold %.2f ms, warm %.2f ms (key %.2f ms), x%.2f, %.1f KB\n",
+        grid.m_xmlPathNoExtensions.c_str(), context.m_runCount, coldMilliseconds / runs, warmMilliseconds / runs, keyMilliseconds / runs,
+        warmMilliseconds > 0.0 ? coldMilliseconds / warmMilliseconds : 0.0, (double)cookedBytes / 1024.0);
+
+    context.Check(cookedBytes > 0, "the cold import writes the cook");
+    context.Check(coldSkippedCook, "forceRecook imports from source");
+    context.Check(warmHitCook, "the warm load reads the cook");
+    context.Check(warmMatchesCold, "the cook gives back the same verts, indices, meshlets and BVH");
+}
@@ -0,0 +1,203 @@
+#include "IglooBench.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Meshlet.h"
+#include "Engine/Core/MeshOptimizer.h"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Math/Frustum.h"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+    struct MeshletCullingBenchmarkReport
+    {
+        uint32_t m_meshletCount = 0;
+        float m_avgVerticesPerMeshlet = 0.f;
+        float m_avgTrianglesPerMeshlet = 0.f;
+        uint32_t m_viewCount = 0;
+        double m_buildMilliseconds = 0.0;
+        double m_cullMicrosecondsPerView = 0.0;
+        double m_meshletsPerMillisecond = 0.0;
+        float m_avgFrustumCulledTriangles = 0.f;   // fraction of the mesh, per view
+        float m_avgBackfaceCulledTriangles = 0.f;
+        float m_avgVisibleTriangles = 0.f;
+        float m_avgRangesPerView = 0.f;
+    };
+
+    Plane3 MakeInwardPlane(Vec3 const& inwardNormal, Vec3 const& pointOnPlane)
+    {
+        return Plane3(inwardNormal, -DotProduct3D(inwardNormal, pointOnPlane));
+    }
+
+    // 和 DetectContainmentWithSphere 一样的约定：n·p + d >= 0 在里面
+    Frustum MakeBenchmarkFrustum(Vec3 const& position, Vec3 const& forward, float fovYDegrees, float aspect, float nearDist, float farDist)
+    {
+        Vec3 worldUp = (fabsf(forward.z) < 0.99f) ? Vec3(0.f, 0.f, 1.f) : Vec3(0.f, 1.f, 0.f);
+        Vec3 left = CrossProduct3D(worldUp, forward).GetNormalized();
+        Vec3 up = CrossProduct3D(forward, left);
+
+        float halfV = tanf(ConvertDegreesToRadians(fovYDegrees) * 0.5f);
+        float halfH = halfV * aspect;
+
+        Frustum frustum;
+        frustum.m_planes[Frustum::Near] = MakeInwardPlane(forward, position + forward * nearDist);
+        frustum.m_planes[Frustum::Far] = MakeInwardPlane(forward * -1.f, position + forward * farDist);
+        frustum.m_planes[Frustum::Left] = MakeInwardPlane(CrossProduct3D(up, forward + left * halfH).GetNormalized() * -1.f, position);
+        frustum.m_planes[Frustum::Right] = MakeInwardPlane(CrossProduct3D(up, forward - left * halfH).GetNormalized(), position);
+        frustum.m_planes[Frustum::Top] = MakeInwardPlane(CrossProduct3D(left, forward + up * halfV).GetNormalized(), position);
+        frustum.m_planes[Frustum::Bottom] = MakeInwardPlane(CrossProduct3D(left, forward - up * halfV).GetNormalized() * -1.f, position);
+        return frustum;
+    }
+
+    // Orbits a camera around the meshlets' mesh (half the views close enough that the frustum
+    // clips part of it) and culls every view
+    MeshletCullingBenchmarkReport BenchmarkMeshletCulling(std::vector<Vertex_PCUTBN> const& verts, MeshletData const& meshlets, uint32_t viewCount)
+    {
+        MeshletCullingBenchmarkReport report;
+        report.m_viewCount = viewCount;
+        report.m_meshletCount = (uint32_t)meshlets.m_meshlets.size();
+        if (meshlets.IsEmpty() || viewCount == 0)
+            return report;
+        for (Meshlet const& meshlet : meshlets.m_meshlets)
+        {
+            report.m_avgVerticesPerMeshlet += (float)meshlet.m_vertexCount;
+            report.m_avgTrianglesPerMeshlet += (float)meshlet.m_triangleCount;
+        }
+        report.m_avgVerticesPerMeshlet /= (float)report.m_meshletCount;
+        report.m_avgTrianglesPerMeshlet /= (float)report.m_meshletCount;
+
+        Vec3 mins = Vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+        Vec3 maxs = Vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (Vertex_PCUTBN const& v : verts)
+        {
+            mins = Vec3(MinF(mins.x, v.m_position.x), MinF(mins.y, v.m_position.y), MinF(mins.z, v.m_position.z));
+            maxs = Vec3(MaxF(maxs.x, v.m_position.x), MaxF(maxs.y, v.m_position.y), MaxF(maxs.z, v.m_position.z));
+        }
+        Vec3 center = (mins + maxs) * 0.5f;
+        float meshRadius = (maxs - mins).GetLength() * 0.5f;
+
+        Mat44 identity;
+        std::vector<MeshletIndexRange> ranges;
+        MeshletCullStats total;
+        uint32_t frustumCulledTriangles = 0;
+        uint32_t backfaceCulledTriangles = 0;
+        double cullSeconds = 0.0;
+
+        for (uint32_t view = 0; view < viewCount; view++)
+        {
+            // 一半的视角在外面看全貌，一半贴近（只看到一部分）
+            float yaw = 360.f * (float)view / (float)viewCount;
+            float pitch = 30.f * SinDegrees(yaw * 3.f);
+            float distance = ((view & 1) == 0) ? meshRadius * 3.f : meshRadius * 1.1f;
+            Vec3 direction = Vec3(CosDegrees(pitch) * CosDegrees(yaw), CosDegrees(pitch) * SinDegrees(yaw), SinDegrees(pitch));
+            Vec3 cameraPosition = center + direction * distance;
+            Vec3 lookAt = ((view & 1) == 0) ? center : center + Vec3(-direction.y, direction.x, 0.f) * meshRadius * 2.f;
+            Vec3 forward = (lookAt - cameraPosition).GetNormalized();
+            Frustum frustum = MakeBenchmarkFrustum(cameraPosition, forward, 60.f, 16.f / 9.f, 0.01f, meshRadius * 10.f);
+
+            MeshletCullStats stats;
+            double cullStart = GetCurrentTimeSeconds();
+            CullMeshlets(meshlets, identity, frustum, cameraPosition, ranges, stats);
+            cullSeconds += GetCurrentTimeSeconds() - cullStart;
+
+            // 分别统计两种剔除掉的三角形（再走一遍，不计时）
+            for (Meshlet const& meshlet : meshlets.m_meshlets)
+            {
+                if (frustum.DetectContainmentWithSphere(meshlet.m_center, meshlet.m_radius) == ContainmentType::OUTSIDE)
+                {
+                    frustumCulledTriangles += meshlet.m_triangleCount;
+                    continue;
+                }
+                Vec3 toCenter = meshlet.m_center - cameraPosition;
+                if (meshlet.m_coneCutoff < 1.f && DotProduct3D(toCenter, meshlet.m_coneAxis) >= meshlet.m_coneCutoff * toCenter.GetLength() + meshlet.m_radius)
+                    backfaceCulledTriangles += meshlet.m_triangleCount;
+            }
+
+            total.m_meshletsTested += stats.m_meshletsTested;
+            total.m_trianglesTotal += stats.m_trianglesTotal;
+            total.m_trianglesVisible += stats.m_trianglesVisible;
+            total.m_rangeCount += stats.m_rangeCount;
+        }
+
+        report.m_cullMicrosecondsPerView = cullSeconds * 1e6 / (double)viewCount;
+        report.m_meshletsPerMillisecond = (cullSeconds > 0.0) ? (double)total.m_meshletsTested / (cullSeconds * 1000.0) : 0.0;
+        report.m_avgFrustumCulledTriangles = (float)frustumCulledTriangles / (float)total.m_trianglesTotal;
+        report.m_avgBackfaceCulledTriangles = (float)backfaceCulledTriangles / (float)total.m_trianglesTotal;
+        report.m_avgVisibleTriangles = (float)total.m_trianglesVisible / (float)total.m_trianglesTotal;
+        report.m_avgRangesPerView = (float)total.m_rangeCount / (float)viewCount;
+        return report;
+    }
+
+    // winding-preserving canonical form: rotate the smallest index to the front
+    std::array<unsigned int, 3> GetCanonicalTriangle(unsigned int const* tri)
+    {
+        int first = (tri[1] < tri[0] && tri[1] < tri[2]) ? 1 : ((tri[2] < tri[0] && tri[2] < tri[1]) ? 2 : 0);
+        return { tri[first], tri[(first + 1) % 3], tri[(first + 2) % 3] };
+    }
+
+    std::vector<std::array<unsigned int, 3>> GetSortedTriangles(std::vector<unsigned int> const& indices)
+    {
+        std::vector<std::array<unsigned int, 3>> triangles;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+            triangles.push_back(GetCanonicalTriangle(indices.data() + i));
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+}
+
+void RunMeshletBench(BenchContext& context)
+{
+    // 闭合的球：从外面看总有一半背对相机，cone test 才有东西可剔
+    int slices = context.m_quick ? 128 : 512;
+    int stacks = slices / 2;
+    std::vector<Vertex_PCUTBN> verts;
+    std::vector<unsigned int> indices;
+    AddVertsForIndexSphere3D(verts, indices, Vec3(), 10.f, slices, stacks);
+    OptimizeMesh(verts, indices);
+
+    std::vector<unsigned int> meshletIndices = indices;
+    MeshletData meshlets;
+    double buildStart = GetCurrentTimeSeconds();
+    BuildMeshlets(verts, meshletIndices, meshlets);
+    double buildMilliseconds = (GetCurrentTimeSeconds() - buildStart) * 1000.0;
+
+    uint32_t oversized = 0;
+    uint32_t nextTriangle = 0;
+    bool rangesMatch = true;
+    for (Meshlet const& meshlet : meshlets.m_meshlets)
+    {
+        oversized += (meshlet.m_vertexCount > MESHLET_MAX_VERTICES || meshlet.m_triangleCount > MESHLET_MAX_TRIANGLES) ? 1 : 0;
+        rangesMatch = rangesMatch && meshlet.m_triangleOffset == nextTriangle;
+        for (uint32_t t = 0; rangesMatch && t < meshlet.m_triangleCount * 3; t++)
+        {
+            uint8_t local = meshlets.m_localIndices[(size_t)meshlet.m_triangleOffset * 3 + t];
+            rangesMatch = local < meshlet.m_vertexCount &&
+                meshlets.m_vertices[meshlet.m_vertexOffset + local] == meshletIndices[(size_t)meshlet.m_triangleOffset * 3 + t];
+        }
+        nextTriangle += meshlet.m_triangleCount;
+    }
+    context.Check(oversized == 0, Stringf("meshlets within %u verts / %u triangles (%u over)", MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES, oversized));
+    context.Check(rangesMatch && nextTriangle * 3 == (uint32_t)meshletIndices.size(), "meshlet i is index range [offset * 3, + count * 3) and its local indices match it");
+    context.Check(GetSortedTriangles(meshletIndices) == GetSortedTriangles(indices), "meshlet order keeps the same triangles and winding");
+
+    uint32_t viewCount = context.m_quick ? 32 : 256;
+    MeshletCullingBenchmarkReport report = BenchmarkMeshletCulling(verts, meshlets, viewCount);
+    report.m_buildMilliseconds = buildMilliseconds;
+    DebuggerPrintf("  %zu tris, %u meshlets (%.1f verts, %.1f tris avg), build %.2f ms, ACMR %.3f -> %.3f; %u views: %.1f us/view (%.0f meshlets/ms), "
+        "frustum %.1f%%, backface %.1f%%, visible %.1f%%, %.1f ranges/view\n",
+        indices.size() / 3, report.m_meshletCount, report.m_avgVerticesPerMeshlet, report.m_avgTrianglesPerMeshlet, report.m_buildMilliseconds,
+        AnalyzeVertexCache(indices, (uint32_t)verts.size()).m_acmr, AnalyzeVertexCache(meshletIndices, (uint32_t)verts.size()).m_acmr, report.m_viewCount,
+        report.m_cullMicrosecondsPerView, report.m_meshletsPerMillisecond, report.m_avgFrustumCulledTriangles * 100.f,
+        report.m_avgBackfaceCulledTriangles * 100.f, report.m_avgVisibleTriangles * 100.f, report.m_avgRangesPerView);
+    context.Check(report.m_avgBackfaceCulledTriangles > 0.1f, Stringf("cone test culls part of a closed sphere (%.1f%%)", report.m_avgBackfaceCulledTriangles * 100.f));
+    context.Check(report.m_avgFrustumCulledTriangles > 0.f, Stringf("close views frustum-cull part of the mesh (%.1f%%)", report.m_avgFrustumCulledTriangles * 100.f));
+    context.Check(report.m_avgVisibleTriangles + report.m_avgFrustumCulledTriangles + report.m_avgBackfaceCulledTriangles < 1.0001f,
+        "visible + culled never exceeds the mesh");
+}
@@ -0,0 +1,278 @@
+#include "IglooBench.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/SphericalHarmonics.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    constexpr float SH_PI = 3.1415926535897932384626433832795f;
+
+    struct SH9ValidationReport
+    {
+        int m_normalCount = 0;
+        float m_maxIrradianceError = 0.f;         // SH irradiance vs brute-force integral of the same environment
+        float m_maxRelativeIrradianceError = 0.f;
+        float m_maxX4Error = 0.f;                 // SoA path vs scalar path
+        float m_maxRotationError = 0.f;           // rotated SH vs SH projected from the rotated environment
+        float m_maxBlendError = 0.f;              // SIMD blend vs scalar blend
+    };
+
+    struct SH9BenchmarkReport
+    {
+        int m_iterations = 0;
+        double m_nsPerEvaluate = 0.0;
+        double m_nsPerEvaluateIrradiance = 0.0;
+        double m_nsPerEvaluateIrradianceX4PerProbe = 0.0;
+        double m_nsPerBlend8 = 0.0;
+        double m_nsPerProjectedSample = 0.0;
+        double m_nsPerRotate = 0.0;
+    };
+
+    Vec3 GetFibonacciSphereDirection(int index, int count)
+    {
+        float z = 1.f - (2.f * (float)index + 1.f) / (float)count;
+        float r = sqrtf(MaxF(0.f, 1.f - z * z));
+        float phi = (float)index * 2.39996323f; // golden angle
+        return Vec3(r * cosf(phi), r * sinf(phi), z);
+    }
+
+    // Smooth test environment: sky gradient plus a broad sun lobe
+    Vec3 EvaluateTestEnvironment(Vec3 const& dir)
+    {
+        Vec3 sunDir = Vec3(0.3f, -0.5f, 0.81f).GetNormalized();
+        float sun = MaxF(0.f, DotProduct3D(dir, sunDir));
+        sun = sun * sun * sun * sun;
+        float sky = 0.5f + 0.5f * dir.z;
+        return Vec3(0.3f, 0.4f, 0.6f) * sky + Vec3(1.0f, 0.9f, 0.7f) * sun;
+    }
+
+    float GetMaxComponentDifference(Vec3 const& a, Vec3 const& b)
+    {
+        return MaxF(fabsf(a.x - b.x), MaxF(fabsf(a.y - b.y), fabsf(a.z - b.z)));
+    }
+
+    SH9ValidationReport ValidateSH9AgainstBruteForce(int sampleCount, int normalCount)
+    {
+        SH9ValidationReport report;
+        report.m_normalCount = normalCount;
+
+        std::vector<Vec3> directions((size_t)sampleCount);
+        std::vector<Vec3> radiance((size_t)sampleCount);
+        for (int i = 0; i < sampleCount; i++)
+        {
+            directions[i] = GetFibonacciSphereDirection(i, sampleCount);
+            radiance[i] = EvaluateTestEnvironment(directions[i]);
+        }
+        SH9Color sh = ProjectSH9(directions.data(), radiance.data(), sampleCount);
+
+        // Irradiance: SH vs direct quadrature of the clamped-cosine integral
+        float const sampleWeight = 4.f * SH_PI / (float)sampleCount;
+        for (int n = 0; n < normalCount; n++)
+        {
+            Vec3 normal = GetFibonacciSphereDirection(n, normalCount);
+            Vec3 bruteForce;
+            for (int i = 0; i < sampleCount; i++)
+            {
+                float cosTheta = DotProduct3D(directions[i], normal);
+                if (cosTheta > 0.f)
+                {
+                    bruteForce += radiance[i] * (cosTheta * sampleWeight);
+                }
+            }
+
+            Vec3 shIrradiance = EvaluateSH9Irradiance(sh, normal);
+            float error = GetMaxComponentDifference(shIrradiance, bruteForce);
+            float magnitude = MaxF(bruteForce.x, MaxF(bruteForce.y, bruteForce.z));
+            report.m_maxIrradianceError = MaxF(report.m_maxIrradianceError, error);
+            if (magnitude > 1e-3f)
+            {
+                report.m_maxRelativeIrradianceError = MaxF(report.m_maxRelativeIrradianceError, error / magnitude);
+            }
+        }
+
+        // X4 path must match the single-probe path
+        SH9Color shB = sh;
+        ConvolveSH9CosineLobe(shB);
+        SH9Color const* lanes[4] = { &sh, &shB, &sh, &shB };
+        SH9ColorX4 packet;
+        packet.Pack(lanes);
+        for (int n = 0; n + 4 <= normalCount; n += 4)
+        {
+            Vec3 normals[4];
+            Vec3 results[4];
+            for (int lane = 0; lane < 4; lane++)
+            {
+                normals[lane] = GetFibonacciSphereDirection(n + lane, normalCount);
+            }
+            EvaluateSH9IrradianceX4(packet, normals, results);
+            for (int lane = 0; lane < 4; lane++)
+            {
+                Vec3 expected = EvaluateSH9Irradiance(*lanes[lane], normals[lane]);
+                report.m_maxX4Error = MaxF(report.m_maxX4Error, GetMaxComponentDifference(results[lane], expected));
+            }
+        }
+
+        // Rotation: rotating the SH must match projecting the rotated environment
+        Mat44 rotation = Mat44::MakeZRotationDegrees(37.f);
+        rotation.AppendYRotation(-58.f);
+        rotation.AppendXRotation(21.f);
+        Vec3 i = rotation.GetIBasis3D();
+        Vec3 j = rotation.GetJBasis3D();
+        Vec3 k = rotation.GetKBasis3D();
+        std::vector<Vec3> rotatedRadiance((size_t)sampleCount);
+        for (int s = 0; s < sampleCount; s++)
+        {
+            Vec3 const& dir = directions[s];
+            Vec3 unrotated(DotProduct3D(i, dir), DotProduct3D(j, dir), DotProduct3D(k, dir));
+            rotatedRadiance[s] = EvaluateTestEnvironment(unrotated);
+        }
+        SH9Color projectedRotated = ProjectSH9(directions.data(), rotatedRadiance.data(), sampleCount);
+        SH9Color rotated = RotateSH9(sh, rotation);
+        for (int n = 0; n < normalCount; n++)
+        {
+            Vec3 dir = GetFibonacciSphereDirection(n, normalCount);
+            float error = GetMaxComponentDifference(EvaluateSH9(rotated, dir), EvaluateSH9(projectedRotated, dir));
+            report.m_maxRotationError = MaxF(report.m_maxRotationError, error);
+        }
+
+        // Blend vs scalar reference
+        SH9Color probes[3] = { sh, shB, rotated };
+        float weights[3] = { 0.2f, 0.5f, 1.3f };
+        SH9Color blended;
+        BlendSH9(probes, weights, 3, blended);
+        for (int c = 0; c < SH9_COEFFICIENT_COUNT; c++)
+        {
+            for (int channel = 0; channel < 3; channel++)
+            {
+                float expected = 0.f;
+                for (int p = 0; p < 3; p++)
+                {
+                    expected += probes[p].m_coeffs[c][channel] * weights[p] / 2.0f;
+                }
+                report.m_maxBlendError = MaxF(report.m_maxBlendError, fabsf(expected - blended.m_coeffs[c][channel]));
+            }
+        }
+
+        return report;
+    }
+
+    SH9BenchmarkReport BenchmarkSH9(int iterations)
+    {
+        SH9BenchmarkReport report;
+        report.m_iterations = iterations;
+        if (iterations <= 0)
+            return report;
+
+        int const directionCount = 1024;
+        std::vector<Vec3> directions(directionCount);
+        std::vector<Vec3> radiance(directionCount);
+        for (int i = 0; i < directionCount; i++)
+        {
+            directions[i] = GetFibonacciSphereDirection(i, directionCount);
+            radiance[i] = EvaluateTestEnvironment(directions[i]);
+        }
+        SH9Color sh = ProjectSH9(directions.data(), radiance.data(), directionCount);
+
+        Vec3 sink;
+        double const nsPerSecond = 1.0e9;
+
+        double start = GetCurrentTimeSeconds();
+        for (int i = 0; i < iterations; i++)
+        {
+            sink += EvaluateSH9(sh, directions[i & (directionCount - 1)]);
+        }
+        report.m_nsPerEvaluate = (GetCurrentTimeSeconds() - start) * nsPerSecond / (double)iterations;
+
+        start = GetCurrentTimeSeconds();
+        for (int i = 0; i < iterations; i++)
+        {
+            sink += EvaluateSH9Irradiance(sh, directions[i & (directionCount - 1)]);
+        }
+        report.m_nsPerEvaluateIrradiance = (GetCurrentTimeSeconds() - start) * nsPerSecond / (double)iterations;
+
+        SH9Color const* lanes[4] = { &sh, &sh, &sh, &sh };
+        SH9ColorX4 packet;
+        packet.Pack(lanes);
+        Vec3 results[4];
+        int const packetCount = (iterations + 3) / 4;
+        start = GetCurrentTimeSeconds();
+        for (int i = 0; i < packetCount; i++)
+        {
+            EvaluateSH9IrradianceX4(packet, &directions[(i * 4) & (directionCount - 1)], results);
+            sink += results[0];
+        }
+        report.m_nsPerEvaluateIrradianceX4PerProbe = (GetCurrentTimeSeconds() - start) * nsPerSecond / (double)(packetCount * 4);
+
+        SH9Color probes[8];
+        float weights[8];
+        for (int p = 0; p < 8; p++)
+        {
+            probes[p] = sh;
+            weights[p] = 1.f + (float)p;
+        }
+        SH9Color blended;
+        start = GetCurrentTimeSeconds();
+        for (int i = 0; i < iterations; i++)
+        {
+            weights[i & 7] += 1e-6f;
+            BlendSH9(probes, weights, 8, blended);
+            sink.x += blended.m_coeffs[0][0];
+        }
+        report.m_nsPerBlend8 = (GetCurrentTimeSeconds() - start) * nsPerSecond / (double)iterations;
+
+        SH9Color projected;
+        start = GetCurrentTimeSeconds();
+        for (int i = 0; i < iterations; i++)
+        {
+            int index = i & (directionCount - 1);
+            AddSH9Sample(projected, directions[index], radiance[index], 1.f);
+        }
+        report.m_nsPerProjectedSample = (GetCurrentTimeSeconds() - start) * nsPerSecond / (double)iterations;
+        sink.y += projected.m_coeffs[0][0];
+
+        Mat44 rotation = Mat44::MakeZRotationDegrees(30.f);
+        int const rotateCount = MaxI(1, iterations / 16);
+        start = GetCurrentTimeSeconds();
+        for (int i = 0; i < rotateCount; i++)
+        {
+            SH9Color rotated = RotateSH9(sh, rotation);
+            sink.z += rotated.m_coeffs[4][0];
+        }
+        report.m_nsPerRotate = (GetCurrentTimeSeconds() - start) * nsPerSecond / (double)rotateCount;
+
+        // Keep the optimizer from discarding the timed loops
+        if (sink.x == 12345.f)
+        {
+            report.m_iterations++;
+        }
+        return report;
+    }
+}
+
+void RunSphericalHarmonicsBench(BenchContext& context)
+{
+    int sampleCount = context.m_quick ? 4096 : 16384;
+    int normalCount = context.m_quick ? 64 : 256;
+    SH9ValidationReport validation = ValidateSH9AgainstBruteForce(sampleCount, normalCount);
+    DebuggerPrintf("  validate %d samples, %d normals: irradiance %.5f (%.2f%%), X4 %.2e, rotation %.2e, blend %.2e\n",
+        sampleCount, normalCount, validation.m_maxIrradianceError, validation.m_maxRelativeIrradianceError * 100.f,
+        validation.m_maxX4Error, validation.m_maxRotationError, validation.m_maxBlendError);
+    // 9 个系数截断了 sun lobe 的高频部分，irradiance 的误差就是那一截
+    // 9 个系数截断 cos^4 的太阳瓣本身就有 ~3% 的最大误差（量到 2.9% / 3.2%），不是实现的问题
+    context.Check(validation.m_maxRelativeIrradianceError < 0.05f, Stringf("SH9 irradiance within 5%% of the brute-force integral (%.2f%%)", validation.m_maxRelativeIrradianceError * 100.f));
+    context.Check(validation.m_maxX4Error < 1e-5f, Stringf("X4 irradiance matches the scalar path (%.2e)", validation.m_maxX4Error));
+    context.Check(validation.m_maxRotationError < 1e-3f, Stringf("rotated SH matches the projected rotated environment (%.2e)", validation.m_maxRotationError));
+    context.Check(validation.m_maxBlendError < 1e-6f, Stringf("blend matches the scalar weighted sum (%.2e)", validation.m_maxBlendError));
+
+    SH9BenchmarkReport benchmark = BenchmarkSH9(context.m_quick ? 100000 : 1000000);
+    DebuggerPrintf("  x%d: evaluate %.1f ns, irradiance %.1f ns, irradiance X4 %.1f ns/probe, blend8 %.1f ns, project %.1f ns/sample, rotate %.1f ns\n",
+        benchmark.m_iterations, benchmark.m_nsPerEvaluate, benchmark.m_nsPerEvaluateIrradiance, benchmark.m_nsPerEvaluateIrradianceX4PerProbe,
+        benchmark.m_nsPerBlend8, benchmark.m_nsPerProjectedSample, benchmark.m_nsPerRotate);
+}
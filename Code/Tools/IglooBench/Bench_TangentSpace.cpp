@@ -0,0 +1,139 @@
+#include "IglooBench.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/TangentSpace.h"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    struct TangentFrameBenchmarkReport
+    {
+        uint32_t m_triangleCount = 0;
+        uint32_t m_vertexCount = 0;
+        uint32_t m_runCount = 0;
+        uint32_t m_rangeCount = 0;
+        double m_avgReferenceMilliseconds = 0.0;     // GenerateTangentFramesReference
+        double m_avgGatherMilliseconds = 0.0;
+        double m_avgAccumulateMilliseconds = 0.0;
+        double m_avgResolveMilliseconds = 0.0;
+        double m_avgTotalMilliseconds = 0.0;         // GenerateTangentFrames
+        float m_maxTangentErrorDegrees = 0.f;        // against the reference; dominated by mirror seam vertices whose sums cancel
+        uint32_t m_handednessMismatches = 0;         // against the reference
+
+        double GetSpeedupOverReference() const { return m_avgTotalMilliseconds > 0.0 ? m_avgReferenceMilliseconds / m_avgTotalMilliseconds : 0.0; }
+    };
+
+    // wavy grid of about triangleCount triangles with normals and UVs (mirrored in u halfway
+    // across, so both handedness signs show up), in row order like an imported file
+    TangentFrameBenchmarkReport BenchmarkTangentFrames(uint32_t triangleCount, uint32_t runCount)
+    {
+        TangentFrameBenchmarkReport report;
+        report.m_runCount = runCount;
+        uint32_t gridSize = std::max(1u, (uint32_t)sqrtf((float)triangleCount * 0.5f));
+        uint32_t rowVerts = gridSize + 1;
+
+        // z = 起伏的高度场，法线解析求；u 过半后镜像
+        std::vector<Vertex_PCUTBN> source((size_t)rowVerts * rowVerts);
+        for (uint32_t y = 0; y < rowVerts; y++)
+        {
+            for (uint32_t x = 0; x < rowVerts; x++)
+            {
+                float fx = (float)x;
+                float fy = (float)y;
+                float z = 2.f * sinf(fx * 0.05f) * cosf(fy * 0.07f);
+                float dzdx = 0.1f * cosf(fx * 0.05f) * cosf(fy * 0.07f);
+                float dzdy = -0.14f * sinf(fx * 0.05f) * sinf(fy * 0.07f);
+                float u = (float)x / (float)gridSize;
+
+                Vertex_PCUTBN& vert = source[(size_t)y * rowVerts + x];
+                vert.m_position = Vec3(fx, fy, z);
+                vert.m_normal = Vec3(-dzdx, -dzdy, 1.f).GetNormalized();
+                vert.m_uvTexCoords = Vec2(u < 0.5f ? u : 1.f - u, (float)y / (float)gridSize);
+                vert.m_color = Rgba8::WHITE;
+            }
+        }
+        std::vector<unsigned int> indices;
+        indices.reserve((size_t)gridSize * gridSize * 6);
+        for (uint32_t y = 0; y < gridSize; y++)
+        {
+            for (uint32_t x = 0; x < gridSize; x++)
+            {
+                unsigned int i0 = y * rowVerts + x;
+                unsigned int i1 = i0 + 1;
+                unsigned int i2 = i0 + rowVerts + 1;
+                unsigned int i3 = i0 + rowVerts;
+                unsigned int quad[6] = { i0, i1, i2, i0, i2, i3 };
+                indices.insert(indices.end(), quad, quad + 6);
+            }
+        }
+        report.m_triangleCount = (uint32_t)(indices.size() / 3);
+        report.m_vertexCount = (uint32_t)source.size();
+        if (runCount == 0)
+            return report;
+
+        std::vector<Vertex_PCUTBN> reference = source;
+        std::vector<Vertex_PCUTBN> work;
+        for (uint32_t run = 0; run < runCount; run++)
+        {
+            reference = source;
+            double referenceStart = GetCurrentTimeSeconds();
+            GenerateTangentFramesReference(reference, indices);
+            report.m_avgReferenceMilliseconds += (GetCurrentTimeSeconds() - referenceStart) * 1000.0;
+
+            work = source;
+            TangentFrameStats stats;
+            GenerateTangentFrames(work, indices, &stats);
+            report.m_avgGatherMilliseconds += stats.m_gatherMilliseconds;
+            report.m_avgAccumulateMilliseconds += stats.m_accumulateMilliseconds;
+            report.m_avgResolveMilliseconds += stats.m_resolveMilliseconds;
+            report.m_avgTotalMilliseconds += stats.m_totalMilliseconds;
+            report.m_rangeCount = stats.m_rangeCount;
+        }
+        double runs = (double)runCount;
+        report.m_avgReferenceMilliseconds /= runs;
+        report.m_avgGatherMilliseconds /= runs;
+        report.m_avgAccumulateMilliseconds /= runs;
+        report.m_avgResolveMilliseconds /= runs;
+        report.m_avgTotalMilliseconds /= runs;
+
+        float minCosine = 1.f;
+        for (size_t i = 0; i < work.size(); i++)
+        {
+            minCosine = std::min(minCosine, DotProduct3D(work[i].m_tangent, reference[i].m_tangent));
+            if (DotProduct3D(work[i].m_bitangent, reference[i].m_bitangent) < 0.f)
+                report.m_handednessMismatches++;
+        }
+        report.m_maxTangentErrorDegrees = ConvertRadiansToDegrees(acosf(std::min(std::max(minCosine, -1.f), 1.f)));
+        return report;
+    }
+}
+
+void RunTangentFrameBench(BenchContext& context)
+{
+    // 100k 一个 range 装不下（TANGENT_MIN_TRIANGLES_PER_RANGE），够测多 range 的合并
+    std::vector<uint32_t> triangleCounts = { 100000 };
+    if (!context.m_quick)
+    {
+        triangleCounts.push_back(1000000);
+        triangleCounts.push_back(5000000);
+    }
+    for (uint32_t triangleCount : triangleCounts)
+    {
+        TangentFrameBenchmarkReport report = BenchmarkTangentFrames(triangleCount, context.m_runCount);
+        DebuggerPrintf("  %u tris / %u verts x%u: reference %.2f ms, SIMD %.2f ms (gather %.2f, accumulate %.2f, resolve %.2f, %u ranges), x%.2f over reference, max error %.4f deg, %u sign mismatches\n",
+            report.m_triangleCount, report.m_vertexCount, report.m_runCount, report.m_avgReferenceMilliseconds,
+            report.m_avgTotalMilliseconds, report.m_avgGatherMilliseconds, report.m_avgAccumulateMilliseconds, report.m_avgResolveMilliseconds,
+            report.m_rangeCount, report.GetSpeedupOverReference(), report.m_maxTangentErrorDegrees, report.m_handednessMismatches);
+
+        // polynomial acos（< 7e-5 rad）和求和顺序不同，量到的是 0.03 deg 左右
+        context.Check(report.m_maxTangentErrorDegrees < 0.1f, Stringf("%u tris: tangents within 0.1 deg of the reference (%.4f)", report.m_triangleCount, report.m_maxTangentErrorDegrees));
+        context.Check(report.m_handednessMismatches == 0, Stringf("%u tris: handedness matches the reference (%u mismatches)", report.m_triangleCount, report.m_handednessMismatches));
+        context.Check(report.m_rangeCount > 1, Stringf("%u tris: split into more than one range (%u)", report.m_triangleCount, report.m_rangeCount));
+    }
+}
@@ -0,0 +1,209 @@
+#include "IglooBench.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ImageMipChain.h"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/TextureResidency.h"
+#include "Engine/Core/Time.hpp"
+#include "ThirdParty/Noise/RawNoise.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <vector>
+
+// ========================================
+// Headless replay: what the manager does with a made-up access pattern
+// ========================================
+namespace
+{
+    struct TextureTraceTexture
+    {
+        std::string m_path;
+        IntVec2 m_dimensions;
+        int m_levelCount = 1;
+        BlockFormat m_format = BlockFormat::NONE;
+    };
+
+    struct TextureTraceAccess
+    {
+        uint32_t m_texture = 0;                     // into TextureAccessTrace::m_textures
+        float m_screenTexels = 0.f;
+    };
+
+    struct TextureAccessTrace
+    {
+        std::vector<TextureTraceTexture> m_textures;
+        std::vector<std::vector<TextureTraceAccess>> m_frames;
+    };
+
+    struct TextureResidencySimulationReport
+    {
+        uint32_t m_frameCount = 0;
+        uint32_t m_textureCount = 0;
+        uint64_t m_budgetBytes = 0;
+        uint64_t m_fullBytes = 0;                   // every texture at mip 0
+        uint64_t m_peakCommittedBytes = 0;
+        uint32_t m_framesOverBudget = 0;            // only possible when the mip tails alone don't fit
+        uint64_t m_streamInCount = 0;
+        uint64_t m_dropCount = 0;
+        uint64_t m_streamedInBytes = 0;
+        uint64_t m_droppedBytes = 0;
+        uint32_t m_tailViolations = 0;              // a drop or stream-in past the mip tail, or a no-op request
+        double m_avgStarvedFraction = 0.0;          // of the textures used in a frame
+        double m_avgUpdateMicroseconds = 0.0;
+    };
+
+    // stream-ins land streamLatencyFrames after they were requested
+    TextureResidencySimulationReport SimulateTextureResidency(TextureAccessTrace const& trace, TextureResidencyConfig const& config, uint32_t streamLatencyFrames)
+    {
+        struct PendingStreamIn
+        {
+            uint32_t m_landFrame = 0;
+            TexturePathId m_id = INVALID_TEXTURE_PATH_ID;
+            int m_mip = 0;
+        };
+
+        TextureResidencySimulationReport report;
+        report.m_frameCount = (uint32_t)trace.m_frames.size();
+        report.m_textureCount = (uint32_t)trace.m_textures.size();
+        report.m_budgetBytes = config.m_budgetBytes;
+
+        // 一开始只有 mip tail
+        TextureResidencyManager manager(config);
+        std::vector<TexturePathId> ids;
+        for (TextureTraceTexture const& texture : trace.m_textures)
+            ids.push_back(manager.Register(texture.m_path, texture.m_dimensions, texture.m_levelCount, texture.m_format, texture.m_levelCount - 1));
+        report.m_fullBytes = manager.GetStats().m_fullBytes;
+
+        std::deque<PendingStreamIn> pending;
+        std::vector<TextureResidencyRequest> requests;
+        double updateSeconds = 0.0;
+        double starvedFractionSum = 0.0;
+        for (uint32_t frame = 0; frame < report.m_frameCount; frame++)
+        {
+            while (!pending.empty() && pending.front().m_landFrame <= frame)
+            {
+                manager.OnStreamedIn(pending.front().m_id, pending.front().m_mip);
+                pending.pop_front();
+            }
+
+            for (TextureTraceAccess const& access : trace.m_frames[frame])
+                manager.NoteUse(ids[access.m_texture], access.m_screenTexels);
+
+            double updateStart = GetCurrentTimeSeconds();
+            manager.Update(requests);
+            updateSeconds += GetCurrentTimeSeconds() - updateStart;
+
+            for (TextureResidencyRequest const& request : requests)
+            {
+                uint64_t bytes = manager.GetBytesFromMip(request.m_id, std::min(request.m_fromMip, request.m_toMip)) -
+                    manager.GetBytesFromMip(request.m_id, std::max(request.m_fromMip, request.m_toMip));
+                int tailMip = manager.GetTailMip(request.m_id);
+                if (request.m_type == TextureResidencyRequestType::DROP)
+                {
+                    report.m_tailViolations += (request.m_toMip <= request.m_fromMip || request.m_toMip > tailMip) ? 1 : 0;
+                    report.m_dropCount++;
+                    report.m_droppedBytes += bytes;
+                    continue;
+                }
+                report.m_tailViolations += (request.m_toMip >= request.m_fromMip || request.m_toMip < 0) ? 1 : 0;
+                report.m_streamInCount++;
+                report.m_streamedInBytes += bytes;
+                if (streamLatencyFrames == 0)
+                    manager.OnStreamedIn(request.m_id, request.m_toMip);
+                else
+                    pending.push_back({ frame + streamLatencyFrames, request.m_id, request.m_toMip });
+            }
+
+            TextureResidencyStats const& stats = manager.GetStats();
+            uint64_t committedBytes = stats.m_residentBytes + stats.m_pendingBytes;
+            report.m_peakCommittedBytes = std::max(report.m_peakCommittedBytes, committedBytes);
+            report.m_framesOverBudget += committedBytes > config.m_budgetBytes ? 1 : 0;
+            if (stats.m_usedLastFrame > 0)
+                starvedFractionSum += (double)stats.m_starvedLastFrame / (double)stats.m_usedLastFrame;
+        }
+
+        if (report.m_frameCount > 0)
+        {
+            report.m_avgStarvedFraction = starvedFractionSum / (double)report.m_frameCount;
+            report.m_avgUpdateMicroseconds = updateSeconds * 1e6 / (double)report.m_frameCount;
+        }
+        return report;
+    }
+
+    // textureCount textures (256..4096, mixed formats) placed along a corridor, a camera flying
+    // through it and back; screen size falls off with distance
+    TextureAccessTrace MakeFlythroughTextureTrace(uint32_t textureCount, uint32_t frameCount, uint32_t seed)
+    {
+        constexpr float SPACING = 2.f;
+        constexpr float VIEW_DISTANCE = 40.f;
+        constexpr float SCREEN_TEXELS_AT_ONE_UNIT = 2048.f;
+
+        TextureAccessTrace trace;
+        std::vector<float> positions;
+        BlockFormat const formats[] = { BlockFormat::NONE, BlockFormat::BC1, BlockFormat::BC7 };
+        for (uint32_t i = 0; i < textureCount; i++)
+        {
+            TextureTraceTexture texture;
+            int size = 256 << (Get1dNoiseUint((int)i, seed) % 5);
+            texture.m_path = Stringf("trace/texture_%u.png", i);
+            texture.m_dimensions = IntVec2(size, size);
+            texture.m_levelCount = GetFullMipLevelCount(texture.m_dimensions);
+            texture.m_format = formats[Get1dNoiseUint((int)i, seed + 1) % 3];
+            trace.m_textures.push_back(texture);
+            positions.push_back((float)i * SPACING + Get1dNoiseZeroToOne((int)i, seed + 2) * SPACING);
+        }
+
+        // 走过去再走回来
+        float length = (float)textureCount * SPACING;
+        trace.m_frames.resize(frameCount);
+        for (uint32_t frame = 0; frame < frameCount; frame++)
+        {
+            float t = frameCount > 1 ? (float)frame / (float)(frameCount - 1) : 0.f;
+            float camera = (t < 0.5f ? t * 2.f : 2.f - t * 2.f) * length;
+            for (uint32_t i = 0; i < textureCount; i++)
+            {
+                float distance = fabsf(positions[i] - camera);
+                if (distance > VIEW_DISTANCE)
+                    continue;
+                trace.m_frames[frame].push_back({ i, SCREEN_TEXELS_AT_ONE_UNIT / std::max(distance, 0.25f) });
+            }
+        }
+        return trace;
+    }
+}
+
+void RunTextureResidencyBench(BenchContext& context)
+{
+    uint32_t textureCount = context.m_quick ? 200 : 1000;
+    uint32_t frameCount = context.m_quick ? 600 : 3000;
+    TextureAccessTrace trace = MakeFlythroughTextureTrace(textureCount, frameCount, 1234);
+
+    // 预算：全部 mip 0 的 1/8（一定要丢），和放得下全部（不该丢）
+    TextureResidencyConfig probe;
+    uint64_t fullBytes = SimulateTextureResidency(TextureAccessTrace{ trace.m_textures, {} }, probe, 0).m_fullBytes;
+    struct Scenario { uint64_t m_budgetBytes; uint32_t m_latency; };
+    Scenario const scenarios[] = { { fullBytes / 8, 0 }, { fullBytes / 8, 4 }, { fullBytes, 4 } };
+    for (Scenario const& scenario : scenarios)
+    {
+        TextureResidencyConfig config;
+        config.m_budgetBytes = scenario.m_budgetBytes;
+        TextureResidencySimulationReport report = SimulateTextureResidency(trace, config, scenario.m_latency);
+        DebuggerPrintf("  %u textures, %u frames, latency %u, budget %.1f of %.1f MB: peak %.1f MB, %u frames over, %llu stream-ins (%.1f MB), %llu drops (%.1f MB), %.1f%% starved, update %.1f us\n",
+            report.m_textureCount, report.m_frameCount, scenario.m_latency, (double)report.m_budgetBytes / (1024.0 * 1024.0), (double)report.m_fullBytes / (1024.0 * 1024.0),
+            (double)report.m_peakCommittedBytes / (1024.0 * 1024.0), report.m_framesOverBudget, (unsigned long long)report.m_streamInCount,
+            (double)report.m_streamedInBytes / (1024.0 * 1024.0), (unsigned long long)report.m_dropCount, (double)report.m_droppedBytes / (1024.0 * 1024.0),
+            report.m_avgStarvedFraction * 100.0, report.m_avgUpdateMicroseconds);
+
+        std::string name = Stringf("budget %.1f MB, latency %u", (double)report.m_budgetBytes / (1024.0 * 1024.0), scenario.m_latency);
+        context.Check(report.m_framesOverBudget == 0 && report.m_peakCommittedBytes <= report.m_budgetBytes,
+            Stringf("%s: resident + pending never over budget (%u frames, peak %.1f MB)", name.c_str(), report.m_framesOverBudget, (double)report.m_peakCommittedBytes / (1024.0 * 1024.0)));
+        context.Check(report.m_tailViolations == 0, Stringf("%s: requests move mips the right way and never past the tail (%u)", name.c_str(), report.m_tailViolations));
+        context.Check(report.m_streamInCount > 0, Stringf("%s: the flythrough streams textures in", name.c_str()));
+        if (report.m_budgetBytes >= report.m_fullBytes)
+            context.Check(report.m_dropCount == 0, Stringf("%s: nothing dropped when everything fits (%llu drops)", name.c_str(), (unsigned long long)report.m_dropCount));
+        else
+            context.Check(report.m_dropCount > 0, Stringf("%s: a budget below the full set drops levels", name.c_str()));
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+//==============================================================================
+// IglooBench - 引擎模块的 benchmark / simulation，每个都检查自己量到的结果
+//==============================================================================
+// A bench runs its module on generated data (or fixtures it writes under m_tempDir),
+// prints one line per measurement and Check()s what the module promises: error bounds
+// against a reference path, no overlapping or corrupted allocations, budgets held, the
+// same output every time. Timings are printed and never checked, so a run passes or fails
+// the same way on any machine.
+//==============================================================================
+
+struct BenchContext
+{
+    bool m_quick = false;                       // smaller inputs and one run (ctest)
+    uint32_t m_runCount = 3;                    // timed repetitions where a bench averages
+    std::string m_tempDir = "IglooBench.tmp";   // fixtures (OBJ / xml / cook); created on demand
+    uint32_t m_checkCount = 0;
+    uint32_t m_failedChecks = 0;
+
+    // counts the check; prints "FAILED <description>" when the condition does not hold
+    bool Check(bool condition, std::string const& description);
+};
+
+void RunSphericalHarmonicsBench(BenchContext& context);
+void RunCardResolutionLODBench(BenchContext& context);
+void RunFrameUploadBench(BenchContext& context);
+void RunDescriptorBench(BenchContext& context);
+void RunMeshletBench(BenchContext& context);
+void RunInstanceBatchingBench(BenchContext& context);
+void RunOBJLoadBench(BenchContext& context);
+void RunCookedLoadBench(BenchContext& context);
+void RunTangentFrameBench(BenchContext& context);
+void RunBlockCompressionBench(BenchContext& context);
+void RunTextureResidencyBench(BenchContext& context);
@@ -0,0 +1,142 @@
+//-----------------------------------------------------------------------------------------------
+// Main_IglooBench.cpp
+//
+// IglooBench [options] [bench...]    every bench when none is named
+//   --quick                  smaller inputs, one run (what ctest runs)
+//   --runs <n>               timed repetitions (3)
+//   --workers <n>            job system workers (hardware threads - 1, at least 2 so the
+//                            chunked / ranged paths run on one core too)
+//   --temp <dir>             fixtures the mesh benches write (IglooBench.tmp)
+//   --list                   print the bench names
+// Exit code: 0 every check held, 1 some check failed, 2 bad arguments
+// Build: IglooBench.vcxproj, or ../IglooCook/CMakeLists.txt (the IglooBench target, ctest)
+//-----------------------------------------------------------------------------------------------
+#include "IglooBench.h"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Job/JobSystem.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+class Window;
+Window* g_theWindow = nullptr;      // 引擎里的全局由 app 定义；bench 不开窗口
+
+namespace
+{
+    struct BenchEntry
+    {
+        char const* m_name;
+        void (*m_run)(BenchContext& context);
+    };
+
+    BenchEntry const BENCHES[] =
+    {
+        { "sh9",            RunSphericalHarmonicsBench },
+        { "cardlod",        RunCardResolutionLODBench },
+        { "upload",         RunFrameUploadBench },
+        { "descriptors",    RunDescriptorBench },
+        { "meshlets",       RunMeshletBench },
+        { "instancing",     RunInstanceBatchingBench },
+        { "objload",        RunOBJLoadBench },
+        { "cookedload",     RunCookedLoadBench },
+        { "tangents",       RunTangentFrameBench },
+        { "blocks",         RunBlockCompressionBench },
+        { "residency",      RunTextureResidencyBench },
+    };
+
+    BenchEntry const* FindBench(std::string const& name)
+    {
+        for (BenchEntry const& bench : BENCHES)
+        {
+            if (name == bench.m_name)
+                return &bench;
+        }
+        return nullptr;
+    }
+
+    void PrintUsage()
+    {
+        DebuggerPrintf("usage: IglooBench [--quick] [--runs <n>] [--workers <n>] [--temp <dir>] [--list] [bench...]\n");
+    }
+}
+
+bool BenchContext::Check(bool condition, std::string const& description)
+{
+    m_checkCount++;
+    if (!condition)
+    {
+        m_failedChecks++;
+        DebuggerPrintf("    FAILED %s\n", description.c_str());
+    }
+    return condition;
+}
+
+int main(int argc, char** argv)
+{
+    BenchContext context;
+    int workerCount = std::max((int)std::thread::hardware_concurrency() - 1, 2);
+    int runCount = 0;
+    std::vector<BenchEntry const*> selected;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--quick")
+            context.m_quick = true;
+        else if (arg == "--runs" && hasValue)
+            runCount = atoi(argv[++i]);
+        else if (arg == "--workers" && hasValue)
+            workerCount = atoi(argv[++i]);
+        else if (arg == "--temp" && hasValue)
+            context.m_tempDir = argv[++i];
+        else if (arg == "--list")
+        {
+            for (BenchEntry const& bench : BENCHES)
+                DebuggerPrintf("%s\n", bench.m_name);
+            return 0;
+        }
+        else if (BenchEntry const* bench = FindBench(arg))
+            selected.push_back(bench);
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+    context.m_runCount = runCount > 0 ? (uint32_t)runCount : (context.m_quick ? 1u : 3u);
+    if (selected.empty())
+    {
+        for (BenchEntry const& bench : BENCHES)
+            selected.push_back(&bench);
+    }
+
+    JobSystemConfig jobConfig;
+    jobConfig.m_numWorkerThreads = workerCount > 0 ? workerCount : 0;
+    jobConfig.m_numIOThreads = 0;
+    g_theJobSystem = new JobSystem(jobConfig);
+    g_theJobSystem->Startup();
+
+    DebuggerPrintf("[IglooBench] %d workers, %u runs%s\n", jobConfig.m_numWorkerThreads, context.m_runCount, context.m_quick ? ", quick" : "");
+    uint32_t failedBenches = 0;
+    for (BenchEntry const* bench : selected)
+    {
+        uint32_t failedBefore = context.m_failedChecks;
+        double start = GetCurrentTimeSeconds();
+        DebuggerPrintf("[%s]\n", bench->m_name);
+        bench->m_run(context);
+        bool passed = context.m_failedChecks == failedBefore;
+        failedBenches += passed ? 0 : 1;
+        DebuggerPrintf("[%s] %s, %.0f ms\n", bench->m_name, passed ? "ok" : "FAILED", (GetCurrentTimeSeconds() - start) * 1000.0);
+    }
+    DebuggerPrintf("[IglooBench] %zu benches, %u checks: %u failed checks in %u benches\n",
+        selected.size(), context.m_checkCount, context.m_failedChecks, failedBenches);
+
+    g_theJobSystem->Shutdown();
+    delete g_theJobSystem;
+    g_theJobSystem = nullptr;
+    return context.m_failedChecks > 0 ? 1 : 0;
+}
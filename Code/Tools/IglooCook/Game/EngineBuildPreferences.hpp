@@ -0,0 +1,4 @@
+#pragma once
+
+// IglooCook 是命令行工具：不开窗口、不建 device，Linux 上也能跑
+#define ENGINE_NULL_RENDERER
@@ -0,0 +1,118 @@
+//-----------------------------------------------------------------------------------------------
+// Main_IglooCook.cpp
+//
+// IglooCook [options]        run from the directory the game runs in (the parent of Data/)
+//   --data <dir>             data root (Data)
+//   --manifest <file>        change tracking (<data>/IglooCook.manifest)
+//   --target <name>          dx11 / dx12 / headless: texture orientation of the backend the data is for
+//   --format <bcN>           block compression for images no mesh uses (none)
+//   --sdf <resolution>       mesh SDF resolution, 0 = none (64)
+//   --workers <n>            job system workers (hardware threads - 1)
+//   --pack <file>            also pack the data root into one asset pack (e.g. Data.pack) for MountAssetPack
+//   --no-compress            store every pack entry uncompressed
+//   --bench-pack <runs>      then time reading every packed file loose vs from the pack
+//   --force                  ignore the manifest and every cook
+//   --no-meshes / --no-textures / --no-definitions / --no-cards
+//   --verbose                report every asset, not just the ones cooked or failed
+// Exit code: 0 ok, 1 some asset or the pack failed, 2 bad arguments
+// Build: IglooCook.vcxproj, or CMakeLists.txt in this directory (Windows / Linux)
+//-----------------------------------------------------------------------------------------------
+#include "Engine/Core/AssetCooker.h"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Job/JobSystem.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+class Window;
+Window* g_theWindow = nullptr;      // 引擎里的全局由 app 定义；cook 不开窗口
+
+namespace
+{
+    void PrintUsage()
+    {
+        DebuggerPrintf("usage: IglooCook [--data <dir>] [--manifest <file>] [--target dx11|dx12|headless] [--format bc1..bc7]\n"
+            "                 [--sdf <resolution>] [--workers <n>] [--force] [--no-meshes] [--no-textures]\n"
+            "                 [--no-definitions] [--no-cards] [--pack <file>] [--no-compress] [--bench-pack <runs>] [--verbose]\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    AssetCookConfig config;
+    int workerCount = (int)std::thread::hardware_concurrency() - 1;
+    bool verbose = false;
+    int packBenchmarkRuns = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--data" && hasValue)
+            config.m_dataRoot = argv[++i];
+        else if (arg == "--manifest" && hasValue)
+            config.m_manifestPath = argv[++i];
+        else if (arg == "--target" && hasValue)
+        {
+            if (!ParseTextureCookTarget(argv[++i], config.m_textureTarget))
+            {
+                DebuggerPrintf("IglooCook: unknown target '%s'\n", argv[i]);
+                return 2;
+            }
+        }
+        else if (arg == "--format" && hasValue)
+        {
+            config.m_textureFormat = ParseBlockFormat(argv[++i]);
+            if (config.m_textureFormat == BlockFormat::NONE && strcmp(argv[i], "none") != 0)
+            {
+                DebuggerPrintf("IglooCook: unknown block format '%s'\n", argv[i]);
+                return 2;
+            }
+        }
+        else if (arg == "--sdf" && hasValue)
+            config.m_meshOptions.m_sdfResolution = atoi(argv[++i]);
+        else if (arg == "--workers" && hasValue)
+            workerCount = atoi(argv[++i]);
+        else if (arg == "--force")
+            config.m_force = true;
+        else if (arg == "--no-meshes")
+            config.m_cookMeshes = false;
+        else if (arg == "--no-textures")
+            config.m_cookTextures = false;
+        else if (arg == "--no-definitions")
+            config.m_checkDefinitions = false;
+        else if (arg == "--no-cards")
+            config.m_meshOptions.m_cardTemplates = false;
+        else if (arg == "--pack" && hasValue)
+            config.m_packPath = argv[++i];
+        else if (arg == "--no-compress")
+            config.m_packSettings.m_compress = false;
+        else if (arg == "--bench-pack" && hasValue)
+            packBenchmarkRuns = atoi(argv[++i]);
+        else if (arg == "--verbose")
+            verbose = true;
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    JobSystemConfig jobConfig;
+    jobConfig.m_numWorkerThreads = workerCount > 0 ? workerCount : 0;
+    jobConfig.m_numIOThreads = 0;
+    g_theJobSystem = new JobSystem(jobConfig);
+    g_theJobSystem->Startup();
+
+    DebuggerPrintf("[IglooCook] %s, textures for %s, %d workers%s\n", config.m_dataRoot.c_str(),
+        GetTextureCookTargetName(config.m_textureTarget), jobConfig.m_numWorkerThreads, config.m_force ? ", forced" : "");
+    AssetCookReport report = CookAssets(config);
+    PrintAssetCookReport(report, verbose);
+    if (packBenchmarkRuns > 0 && report.m_packResult != AssetCookResult::SKIPPED && report.m_packResult != AssetCookResult::FAILED)
+        BenchmarkAssetPack(config.m_packPath, (uint32_t)packBenchmarkRuns);
+
+    g_theJobSystem->Shutdown();
+    delete g_theJobSystem;
+    g_theJobSystem = nullptr;
+    return report.GetCount(AssetCookResult::FAILED) > 0 || report.m_packResult == AssetCookResult::FAILED ? 1 : 0;
+}